@@ -43,6 +43,10 @@ cmake_dependent_option(ROR_USE_ANGELSCRIPT "use angelscript" ON "TARGET Angelscr
 find_package(CURL)
 cmake_dependent_option(ROR_USE_CURL "use curl" ON "CURL_FOUND" OFF)
 
+# --- zlib -- compression of telemetry recordings ---
+find_package(ZLIB)
+cmake_dependent_option(ROR_USE_ZLIB "use zlib" ON "ZLIB_FOUND" OFF)
+
 # --- Caelum -- Ogre addon for realistic sky rendering ---
 find_package(Caelum)
 cmake_dependent_option(ROR_USE_CAELUM "use caelum" ON "TARGET Caelum::Caelum" OFF)
@@ -24,10 +24,10 @@ class RoR(ConanFile):
         self.requires("openssl/3.1.2", force=True)
         self.requires("rapidjson/cci.20211112", force=True)
         self.requires("socketw/3.11.0@anotherfoxguy/stable")
+        self.requires("zlib/1.2.13", force=True)
 
         self.requires("libpng/1.6.39", override=True)
         self.requires("libwebp/1.3.2", override=True)
-        self.requires("zlib/1.2.13", override=True)
 
     def generate(self):
         tc = CMakeToolchain(self)
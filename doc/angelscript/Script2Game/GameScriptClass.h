@@ -386,6 +386,15 @@ public:
 	 */
 	float getGroundHeight(vector3 position);
 
+	/**
+	 * finds the nearest terrain, collision mesh or collision box surface on the line between two points
+	 * @param start Start of the line
+	 * @param end End of the line
+	 * @param hitPos Receives the position of the hit, unchanged if nothing was hit
+	 * @return true if anything was hit
+	 */
+	bool castRay(vector3 start, vector3 end, vector3 &out hitPos);
+
 	/**
 	 * sets the base water height
 	 * @param value base height in meters
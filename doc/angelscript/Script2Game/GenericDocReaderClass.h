@@ -37,12 +37,15 @@ class GenericDocReaderClass
 
     string getTokString(int offset = 0);
     float getTokFloat(int offset = 0);
+    double getTokDouble(int offset = 0); //!< Full precision of the number as written.
+    int64 getTokInt(int offset = 0); //!< Exact if `isTokInt()`, otherwise truncated.
     bool gettokBool(int offset = 0);
     string getTokKeyword(int offset = 0);
     string getTokComment(int offset = 0);
 
     bool isTokString(int offset = 0);
     bool isTokFloat(int offset = 0);
+    bool isTokInt(int offset = 0); //!< Number written without decimal point or exponent; also passes `isTokFloat()`.
     bool isTokBool(int offset = 0);
     bool isTokKeyword(int offset = 0);
     bool isTokComment(int offset = 0);
@@ -105,6 +105,7 @@ CVar* sim_realistic_commands;
 CVar* sim_races_enabled;
 CVar* sim_no_collisions;
 CVar* sim_no_self_collisions;
+CVar* sim_self_collision_hops;
 CVar* sim_gearbox_mode;
 CVar* sim_soft_reset_mode;
 CVar* sim_quickload_dialog;
@@ -181,6 +182,7 @@ CVar* cli_preset_veh_enter;
 CVar* cli_force_cache_update;
 CVar* cli_resume_autosave;
 CVar* cli_custom_scripts;
+CVar* cli_input_playback;
 
 // Input - Output
 CVar* io_analog_smoothing;
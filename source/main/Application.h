@@ -308,6 +308,7 @@ extern CVar* sim_realistic_commands;
 extern CVar* sim_races_enabled;
 extern CVar* sim_no_collisions;
 extern CVar* sim_no_self_collisions;
+extern CVar* sim_self_collision_hops;  //!< Self-collision ignores nodes within this many beams of a collision triangle; 0 = only the triangle's own nodes.
 extern CVar* sim_gearbox_mode;
 extern CVar* sim_soft_reset_mode;
 extern CVar* sim_quickload_dialog;
@@ -385,6 +386,7 @@ extern CVar* cli_preset_veh_enter;
 extern CVar* cli_force_cache_update;
 extern CVar* cli_resume_autosave;
 extern CVar* cli_custom_scripts;
+extern CVar* cli_input_playback;
 
 // Input - Output
 extern CVar* io_analog_smoothing;
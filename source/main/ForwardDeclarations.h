@@ -48,6 +48,7 @@ namespace RoR
 
     class  Actor;
     class  ActorManager;
+    class  ActorQueries;
     class  ActorSpawner;
     class  AeroEngine;
     class  Airbrake;
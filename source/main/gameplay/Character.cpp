@@ -116,14 +116,14 @@ void Character::SetAnimState(std::string mode, float time)
 
 float calculate_collision_depth(Vector3 pos)
 {
-    Vector3 query = pos + 0.3f * Vector3::UNIT_Y;
-    while (query.y > pos.y)
+    // Find the top of the collision surface within 0.3m above the feet
+    const float probe_height = 0.3f;
+    collision_ray_hit_t hit;
+    if (App::GetGameContext()->GetTerrain()->GetCollisions()->castRay(Ray(pos + probe_height * Vector3::UNIT_Y, -probe_height * Vector3::UNIT_Y), hit, /*with_terrain=*/false))
     {
-        if (App::GetGameContext()->GetTerrain()->GetCollisions()->collisionCorrect(&query, false))
-            break;
-        query.y -= 0.001f;
+        return probe_height * (1.0f - hit.distance);
     }
-    return query.y - pos.y;
+    return 0.0f;
 }
 
 void Character::update(float dt)
@@ -156,26 +156,13 @@ void Character::update(float dt)
             position.y += std::min(depth, 2.0f * dt);
         }
 
-        // Submesh "collision"
+        // Submesh "collision" - climb onto the highest collcab within the character's height
         {
             float depth = 0.0f;
-            for (ActorPtr& actor : App::GetGameContext()->GetActorManager()->GetActors())
+            ActorCabQueryResult hit;
+            if (App::GetGameContext()->GetActorManager()->GetActorQueries().CastRayFarthest(Ray(position, Vector3::UNIT_Y), 1.8f, hit))
             {
-                if (actor->ar_bounding_box.contains(position))
-                {
-                    for (int i = 0; i < actor->ar_num_collcabs; i++)
-                    {
-                        int tmpv = actor->ar_collcabs[i] * 3;
-                        Vector3 a = actor->ar_nodes[actor->ar_cabs[tmpv + 0]].AbsPosition;
-                        Vector3 b = actor->ar_nodes[actor->ar_cabs[tmpv + 1]].AbsPosition;
-                        Vector3 c = actor->ar_nodes[actor->ar_cabs[tmpv + 2]].AbsPosition;
-                        auto result = Math::intersects(Ray(position, Vector3::UNIT_Y), a, b, c);
-                        if (result.first && result.second < 1.8f)
-                        {
-                            depth = std::max(depth, result.second);
-                        }
-                    }
-                }
+                depth = hit.distance;
             }
             if (depth > 0.0f)
             {
@@ -188,19 +175,16 @@ void Character::update(float dt)
         // Obstacle detection
         if (position != m_prev_position)
         {
-            const int numstep = 100;
             Vector3 diff = position - m_prev_position;
             Vector3 base = m_prev_position + Vector3::UNIT_Y * 0.25f;
-            for (int i = 1; i < numstep; i++)
+            collision_ray_hit_t hit;
+            if (App::GetGameContext()->GetTerrain()->GetCollisions()->castRay(Ray(base, diff), hit, /*with_terrain=*/false))
             {
-                Vector3 query = base + diff * ((float)i / numstep);
-                if (App::GetGameContext()->GetTerrain()->GetCollisions()->collisionCorrect(&query, false))
-                {
-                    m_character_v_speed = std::max(0.0f, m_character_v_speed);
-                    position = m_prev_position + diff * ((float)(i - 1) / numstep);
-                    position.y += 0.025f;
-                    break;
-                }
+                // Stop 1cm short of the obstacle
+                const float stop = std::max(0.0f, hit.distance - 0.01f / diff.length());
+                m_character_v_speed = std::max(0.0f, m_character_v_speed);
+                position = m_prev_position + diff * stop;
+                position.y += 0.025f;
             }
         }
 
@@ -46,6 +46,7 @@ EngineSim::EngineSim(float _min_rpm, float _max_rpm, float torque, std::vector<f
     , m_cur_acc(0.0f)
     , m_cur_clutch(0.0f)
     , m_cur_clutch_torque(0.0f)
+    , m_clutch_solved(false)
     , m_cur_engine_rpm(0.0f)
     , m_cur_engine_torque(0.0f) 
     , m_cur_gear(0)
@@ -481,8 +482,8 @@ void EngineSim::UpdateEngineSim(float dt, int doUpdate)
         }
     }
 
-    // clutch
-    if (m_cur_gear)
+    // clutch, unless the drivetrain solver already applied it this step
+    if (m_cur_gear && !m_clutch_solved)
     {
         totaltorque -= m_cur_clutch_torque / m_gear_ratios[m_cur_gear + 1];
     }
@@ -491,7 +492,11 @@ void EngineSim::UpdateEngineSim(float dt, int doUpdate)
     m_cur_engine_rpm += dt * totaltorque / m_engine_inertia;
 
     // update clutch torque
-    if (m_cur_gear)
+    if (m_clutch_solved)
+    {
+        m_clutch_solved = false;
+    }
+    else if (m_cur_gear)
     {
         float force_threshold = 1.5f * std::max(m_engine_torque, getEnginePower()) * std::abs(m_gear_ratios[2]);
         float gearboxspinner = m_cur_engine_rpm / m_gear_ratios[m_cur_gear + 1];
@@ -935,6 +940,33 @@ void EngineSim::SetWheelSpin(float rpm)
     m_cur_wheel_revolutions = rpm;
 }
 
+void EngineSim::GetClutchCoupling(float& out_gear_ratio, float& out_damp, float& out_limit)
+{
+    out_gear_ratio = 0.0f;
+    out_damp = 0.0f;
+    out_limit = 0.0f;
+    if (!m_cur_gear)
+        return;
+
+    // Same clutch as in `UpdateEngineSim()`; the slip factor is taken at the current slip
+    float gearboxspinner = m_cur_engine_rpm / m_gear_ratios[m_cur_gear + 1];
+    float slip_factor = 1.0f - approx_exp(-std::abs(gearboxspinner - m_cur_wheel_revolutions));
+    out_gear_ratio = m_gear_ratios[m_cur_gear + 1];
+    out_damp = m_cur_clutch * m_clutch_force * slip_factor;
+    out_limit = 1.5f * std::max(m_engine_torque, getEnginePower()) * std::abs(m_gear_ratios[2]) * slip_factor;
+}
+
+void EngineSim::ApplyClutchTorque(float torque, float dt)
+{
+    if (m_cur_gear)
+    {
+        m_cur_engine_rpm -= dt * torque / m_gear_ratios[m_cur_gear + 1] / m_engine_inertia;
+        m_cur_engine_rpm = std::max(0.0f, m_cur_engine_rpm);
+    }
+    m_cur_clutch_torque = torque;
+    m_clutch_solved = true;
+}
+
 void EngineSim::SetTCaseRatio(float ratio)
 {
     if (ratio < 1.0f)
@@ -80,6 +80,10 @@ public:
     void           SetEnginePriming(bool p);     //!< Set current engine prime.
     void           SetHydroPumpWork(float work); //!< Set current hydro pump work.
     void           SetWheelSpin(float rpm);      //!< Set current wheel spinning speed.
+    /// Clutch for the drivetrain solver, see `DrivetrainEngine`; the gear ratio is 0 in neutral.
+    void           GetClutchCoupling(float& out_gear_ratio, float& out_damp, float& out_limit);
+    /// Applies the clutch torque found by the drivetrain solver; `UpdateEngineSim()` then skips its own clutch for this step.
+    void           ApplyClutchTorque(float torque, float dt);
     void           SetTCaseRatio(float ratio);   //!< Set current transfer case gear (reduction) ratio
     void           ToggleAutoShiftMode();
     void           OffStart();                   //!< Quick start of vehicle engine.
@@ -170,6 +174,7 @@ private:
     float          m_clutch_time;           //!< Clutch attribute
     float          m_cur_clutch;
     float          m_cur_clutch_torque;
+    bool           m_clutch_solved;         //!< Clutch; set by `ApplyClutchTorque()` for the current step
 
     // Engine
     bool           m_engine_is_electric;    //!< Engine attribute
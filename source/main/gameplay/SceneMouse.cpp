@@ -123,37 +123,16 @@ bool SceneMouse::mouseMoved(const OIS::MouseEvent& _arg)
 
         Ray mouseRay = getMouseRay();
 
-        // walk all trucks
+        // find the nearest grabbable node of all simulated trucks
         minnode = NODENUM_INVALID;
         grab_truck = NULL;
-        for (ActorPtr& actor : App::GetGameContext()->GetActorManager()->GetActors())
+        ActorNodeQueryResult result;
+        if (App::GetGameContext()->GetActorManager()->GetActorQueries().FindNodeOnRay(mouseRay, 0.1f, mindist, result,
+                ActorQueries::QUERY_SIMULATED_ONLY | ActorQueries::QUERY_GRABBABLE_NODES))
         {
-            if (actor->ar_state == ActorState::LOCAL_SIMULATED)
-            {
-                // check if our ray intersects with the bounding box of the truck
-                std::pair<bool, Real> pair = mouseRay.intersects(actor->ar_bounding_box);
-                if (!pair.first)
-                    continue;
-
-                for (int j = 0; j < actor->ar_num_nodes; j++)
-                {
-                    if (actor->ar_nodes[j].nd_no_mouse_grab)
-                        continue;
-
-                    // check if our ray intersects with the node
-                    std::pair<bool, Real> pair = mouseRay.intersects(Sphere(actor->ar_nodes[j].AbsPosition, 0.1f));
-                    if (pair.first)
-                    {
-                        // we hit it, check if its the nearest node
-                        if (pair.second < mindist)
-                        {
-                            mindist = pair.second;
-                            minnode = (NodeNum_t)j;
-                            grab_truck = actor;
-                        }
-                    }
-                }
-            }
+            mindist = result.distance;
+            minnode = result.node;
+            grab_truck = result.actor;
         }
 
         // check if we hit a node
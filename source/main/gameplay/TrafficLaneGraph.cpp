@@ -0,0 +1,374 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TrafficLaneGraph.h"
+
+#include "GridRayWalk.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+using namespace Ogre;
+using namespace RoR;
+
+const float TrafficLaneGraph::MERGE_DISTANCE = 0.1f;
+const float TrafficLaneGraph::CELL_SIZE = 16.f;
+const float TrafficActorGrid::CELL_SIZE = 32.f;
+
+static int GetCellCoord(float pos, float cell_size)
+{
+    return static_cast<int>(std::floor(pos / cell_size));
+}
+
+static uint64_t GetCellKey(long cell_x, long cell_z)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cell_x)) << 32) | static_cast<uint32_t>(cell_z);
+}
+
+static float GetHorizontalDistSq(Vector3 const& a, Vector3 const& b)
+{
+    const float dx = a.x - b.x;
+    const float dz = a.z - b.z;
+    return dx * dx + dz * dz;
+}
+
+/// Horizontal distance from `pos` to segment `a`-`b`; `out_along` receives the parameter of the nearest point.
+static float GetHorizontalSegmentDistSq(Vector3 const& pos, Vector3 const& a, Vector3 const& b, float& out_along)
+{
+    const float dx = b.x - a.x;
+    const float dz = b.z - a.z;
+    const float len_sq = dx * dx + dz * dz;
+    out_along = (len_sq > 0.f) ? ((pos.x - a.x) * dx + (pos.z - a.z) * dz) / len_sq : 0.f;
+    out_along = std::min(std::max(out_along, 0.f), 1.f);
+    return GetHorizontalDistSq(pos, Vector3(a.x + dx * out_along, 0.f, a.z + dz * out_along));
+}
+
+/// Calls `func` with the key of every cell the segment `a`-`b` crosses, horizontally; the same cells every time.
+static void ForEachSegmentCell(Vector3 const& a, Vector3 const& b, float cell_size, std::function<void(uint64_t)> const& func)
+{
+    GridRayWalk walk(a.x / cell_size, a.z / cell_size, (b.x - a.x) / cell_size, (b.z - a.z) / cell_size, 0.f, 1.f);
+    for (;;)
+    {
+        func(GetCellKey(walk.GetCellU(), walk.GetCellV()));
+        if (walk.IsLastCell())
+            break;
+        walk.Step();
+    }
+}
+
+// --------------------------------
+// TrafficLaneGraph
+
+int TrafficLaneGraph::AddWaypoint(Vector3 const& pos)
+{
+    const int existing = this->FindNearestWaypoint(pos, MERGE_DISTANCE);
+    if (existing != -1 && std::abs(m_waypoints[existing].twp_position.y - pos.y) < MERGE_DISTANCE)
+    {
+        m_waypoints[existing].twp_refs++;
+        return existing;
+    }
+
+    int id;
+    if (!m_free_waypoints.empty())
+    {
+        id = m_free_waypoints.back();
+        m_free_waypoints.pop_back();
+    }
+    else
+    {
+        id = static_cast<int>(m_waypoints.size());
+        m_waypoints.emplace_back();
+    }
+    m_waypoints[id].twp_position = pos;
+    m_waypoints[id].twp_refs = 1;
+    m_cells[GetCellKey(GetCellCoord(pos.x, CELL_SIZE), GetCellCoord(pos.z, CELL_SIZE))].tc_waypoints.push_back(id);
+    return id;
+}
+
+void TrafficLaneGraph::ReleaseWaypoint(int id)
+{
+    Waypoint& waypoint = m_waypoints[id];
+    assert(waypoint.twp_refs > 0);
+    if (--waypoint.twp_refs > 0)
+        return;
+
+    assert(waypoint.twp_out_lanes.empty()); // Lanes reference their waypoints
+    const Vector3& pos = waypoint.twp_position;
+    auto itor = m_cells.find(GetCellKey(GetCellCoord(pos.x, CELL_SIZE), GetCellCoord(pos.z, CELL_SIZE)));
+    this->EraseFromCell(itor, itor->second.tc_waypoints, id);
+    m_free_waypoints.push_back(id);
+}
+
+int TrafficLaneGraph::FindNearestWaypoint(Vector3 const& pos, float max_distance) const
+{
+    const int min_x = GetCellCoord(pos.x - max_distance, CELL_SIZE);
+    const int max_x = GetCellCoord(pos.x + max_distance, CELL_SIZE);
+    const int min_z = GetCellCoord(pos.z - max_distance, CELL_SIZE);
+    const int max_z = GetCellCoord(pos.z + max_distance, CELL_SIZE);
+
+    int nearest = -1;
+    float nearest_dist_sq = max_distance * max_distance;
+    for (int cell_x = min_x; cell_x <= max_x; cell_x++)
+    {
+        for (int cell_z = min_z; cell_z <= max_z; cell_z++)
+        {
+            auto itor = m_cells.find(GetCellKey(cell_x, cell_z));
+            if (itor == m_cells.end())
+                continue;
+
+            for (int id : itor->second.tc_waypoints)
+            {
+                const float dist_sq = GetHorizontalDistSq(m_waypoints[id].twp_position, pos);
+                if (dist_sq <= nearest_dist_sq)
+                {
+                    nearest_dist_sq = dist_sq;
+                    nearest = id;
+                }
+            }
+        }
+    }
+    return nearest;
+}
+
+int TrafficLaneGraph::AddLane(int from, int to)
+{
+    if (from == to)
+        return -1;
+
+    const int existing = this->FindLane(from, to);
+    if (existing != -1)
+    {
+        m_lanes[existing].tl_refs++;
+        return existing;
+    }
+
+    int id;
+    if (!m_free_lanes.empty())
+    {
+        id = m_free_lanes.back();
+        m_free_lanes.pop_back();
+    }
+    else
+    {
+        id = static_cast<int>(m_lanes.size());
+        m_lanes.emplace_back();
+    }
+    Lane& lane = m_lanes[id];
+    lane.tl_from = from;
+    lane.tl_to = to;
+    lane.tl_length = m_waypoints[from].twp_position.distance(m_waypoints[to].twp_position);
+    lane.tl_refs = 1;
+
+    m_waypoints[from].twp_refs++;
+    m_waypoints[to].twp_refs++;
+    m_waypoints[from].twp_out_lanes.push_back(id);
+    ForEachSegmentCell(m_waypoints[from].twp_position, m_waypoints[to].twp_position, CELL_SIZE, [this, id](uint64_t key)
+    {
+        m_cells[key].tc_lanes.push_back(id);
+    });
+    return id;
+}
+
+void TrafficLaneGraph::ReleaseLane(int id)
+{
+    Lane& lane = m_lanes[id];
+    assert(lane.tl_refs > 0);
+    if (--lane.tl_refs > 0)
+        return;
+
+    ForEachSegmentCell(m_waypoints[lane.tl_from].twp_position, m_waypoints[lane.tl_to].twp_position, CELL_SIZE, [this, id](uint64_t key)
+    {
+        auto itor = m_cells.find(key);
+        this->EraseFromCell(itor, itor->second.tc_lanes, id);
+    });
+
+    std::vector<int>& out_lanes = m_waypoints[lane.tl_from].twp_out_lanes;
+    out_lanes.erase(std::find(out_lanes.begin(), out_lanes.end(), id));
+    this->ReleaseWaypoint(lane.tl_from);
+    this->ReleaseWaypoint(lane.tl_to);
+    lane = Lane();
+    m_free_lanes.push_back(id);
+}
+
+int TrafficLaneGraph::FindLane(int from, int to) const
+{
+    for (int id : m_waypoints[from].twp_out_lanes)
+    {
+        if (m_lanes[id].tl_to == to)
+            return id;
+    }
+    return -1;
+}
+
+int TrafficLaneGraph::FindNearestLane(Vector3 const& pos, float max_distance, float* out_along) const
+{
+    const int min_x = GetCellCoord(pos.x - max_distance, CELL_SIZE);
+    const int max_x = GetCellCoord(pos.x + max_distance, CELL_SIZE);
+    const int min_z = GetCellCoord(pos.z - max_distance, CELL_SIZE);
+    const int max_z = GetCellCoord(pos.z + max_distance, CELL_SIZE);
+
+    int nearest = -1;
+    float nearest_dist_sq = max_distance * max_distance;
+    for (int cell_x = min_x; cell_x <= max_x; cell_x++)
+    {
+        for (int cell_z = min_z; cell_z <= max_z; cell_z++)
+        {
+            auto itor = m_cells.find(GetCellKey(cell_x, cell_z));
+            if (itor == m_cells.end())
+                continue;
+
+            for (int id : itor->second.tc_lanes) // A lane crossing several cells is tested more than once, which is harmless
+            {
+                float along = 0.f;
+                const float dist_sq = GetHorizontalSegmentDistSq(
+                    pos, m_waypoints[m_lanes[id].tl_from].twp_position, m_waypoints[m_lanes[id].tl_to].twp_position, along);
+                if (dist_sq <= nearest_dist_sq)
+                {
+                    nearest_dist_sq = dist_sq;
+                    nearest = id;
+                    if (out_along)
+                        *out_along = along;
+                }
+            }
+        }
+    }
+    return nearest;
+}
+
+bool TrafficLaneGraph::FindRoute(int from, int to, std::vector<int>& out_waypoints) const
+{
+    typedef std::pair<float, int> QueueEntry; // Estimated total length, waypoint
+
+    const float INF = std::numeric_limits<float>::infinity();
+    const Vector3& goal = m_waypoints[to].twp_position;
+    std::vector<float> length(m_waypoints.size(), INF);
+    std::vector<int> came_from(m_waypoints.size(), -1);
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> open;
+
+    length[from] = 0.f;
+    open.push(QueueEntry(m_waypoints[from].twp_position.distance(goal), from));
+    while (!open.empty())
+    {
+        const int current = open.top().second;
+        const float estimate = open.top().first;
+        open.pop();
+        if (current == to)
+            break;
+        if (estimate > length[current] + m_waypoints[current].twp_position.distance(goal))
+            continue; // Stale entry, the waypoint was reached by a shorter path meanwhile
+
+        for (int id : m_waypoints[current].twp_out_lanes)
+        {
+            const Lane& lane = m_lanes[id];
+            const float new_length = length[current] + lane.tl_length;
+            if (new_length < length[lane.tl_to])
+            {
+                length[lane.tl_to] = new_length;
+                came_from[lane.tl_to] = current;
+                open.push(QueueEntry(new_length + m_waypoints[lane.tl_to].twp_position.distance(goal), lane.tl_to));
+            }
+        }
+    }
+
+    if (length[to] == INF)
+        return false;
+
+    const size_t first = out_waypoints.size();
+    for (int waypoint = to; waypoint != -1; waypoint = came_from[waypoint])
+    {
+        out_waypoints.push_back(waypoint);
+    }
+    std::reverse(out_waypoints.begin() + first, out_waypoints.end());
+    return true;
+}
+
+void TrafficLaneGraph::Clear()
+{
+    m_waypoints.clear();
+    m_free_waypoints.clear();
+    m_lanes.clear();
+    m_free_lanes.clear();
+    m_cells.clear();
+}
+
+void TrafficLaneGraph::EraseFromCell(CellMap::iterator cell, std::vector<int>& list, int id)
+{
+    assert(cell != m_cells.end());
+    list.erase(std::find(list.begin(), list.end(), id));
+    if (cell->second.tc_waypoints.empty() && cell->second.tc_lanes.empty())
+    {
+        m_cells.erase(cell);
+    }
+}
+
+// --------------------------------
+// TrafficActorGrid
+
+void TrafficActorGrid::Clear()
+{
+    for (auto itor = m_cells.begin(); itor != m_cells.end(); )
+    {
+        if (itor->second.empty())
+        {
+            itor = m_cells.erase(itor); // Nobody came back, don't let the map grow with every cell ever visited
+        }
+        else
+        {
+            itor->second.clear(); // Keep the bucket allocated, actors mostly stay in their cells
+            ++itor;
+        }
+    }
+    m_max_radius = 0.f;
+}
+
+void TrafficActorGrid::Insert(int actor, Vector3 const& pos, float radius)
+{
+    m_cells[GetCellKey(GetCellCoord(pos.x, CELL_SIZE), GetCellCoord(pos.z, CELL_SIZE))].push_back(Entry{ actor, pos });
+    m_max_radius = std::max(m_max_radius, radius);
+}
+
+void TrafficActorGrid::Query(Vector3 const& pos, float radius, std::vector<int>& out_actors) const
+{
+    const int min_x = GetCellCoord(pos.x - radius, CELL_SIZE);
+    const int max_x = GetCellCoord(pos.x + radius, CELL_SIZE);
+    const int min_z = GetCellCoord(pos.z - radius, CELL_SIZE);
+    const int max_z = GetCellCoord(pos.z + radius, CELL_SIZE);
+    const float radius_sq = radius * radius;
+
+    for (int cell_x = min_x; cell_x <= max_x; cell_x++)
+    {
+        for (int cell_z = min_z; cell_z <= max_z; cell_z++)
+        {
+            auto itor = m_cells.find(GetCellKey(cell_x, cell_z));
+            if (itor == m_cells.end())
+                continue;
+
+            for (Entry const& entry : itor->second)
+            {
+                if (GetHorizontalDistSq(entry.tge_position, pos) <= radius_sq)
+                    out_actors.push_back(entry.tge_actor);
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief Spatial structures of `TrafficManager`: the lane graph of all AI routes and the neighbour grid of actors.
+
+#pragma once
+
+#include <OgreVector3.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Gameplay
+/// @{
+
+/// Road network of all AI routes: waypoints joined by directed lanes, indexed by a horizontal grid.
+/// Routes passing the same spot share the waypoint and the lane, so hundreds of agents spawned on one preset
+/// don't keep hundreds of copies. Agents hold references and drop them when they go away; unreferenced
+/// waypoints and lanes are removed, their cells erased once empty and their IDs reused.
+class TrafficLaneGraph
+{
+public:
+    static const float MERGE_DISTANCE;  //!< Waypoints closer than this are merged
+    static const float CELL_SIZE;
+
+    struct Lane
+    {
+        int       tl_from = -1;         //!< Waypoint ID
+        int       tl_to = -1;           //!< Waypoint ID
+        float     tl_length = 0.f;
+        int       tl_refs = 0;          //!< Zero = free slot
+    };
+
+    /// Finds a waypoint within `MERGE_DISTANCE` or creates one, and adds a reference to it.
+    int                   AddWaypoint(Ogre::Vector3 const& pos);
+    void                  ReleaseWaypoint(int id);
+    Ogre::Vector3 const&  GetWaypoint(int id) const { return m_waypoints[id].twp_position; }
+    int                   FindNearestWaypoint(Ogre::Vector3 const& pos, float max_distance) const; //!< @return -1 if none
+
+    /// Finds the lane `from` -> `to` or creates one, and adds a reference to it; the lane references both waypoints.
+    /// @return -1 if `from` and `to` are the same waypoint.
+    int                   AddLane(int from, int to);
+    void                  ReleaseLane(int id);
+    Lane const&           GetLane(int id) const { return m_lanes[id]; }
+    int                   FindLane(int from, int to) const;  //!< @return -1 if none
+    std::vector<int> const& GetOutgoingLanes(int waypoint) const { return m_waypoints[waypoint].twp_out_lanes; }
+    /// Nearest lane by horizontal distance; `out_along` receives the position along it, 0 at `tl_from` to 1 at `tl_to`.
+    /// @return -1 if none within `max_distance`
+    int                   FindNearestLane(Ogre::Vector3 const& pos, float max_distance, float* out_along = nullptr) const;
+    /// Shortest path along the lanes (A*); `out_waypoints` receives the waypoints from `from` to `to` inclusive.
+    /// @return False if `to` can't be reached.
+    bool                  FindRoute(int from, int to, std::vector<int>& out_waypoints) const;
+
+    size_t                GetNumWaypoints() const { return m_waypoints.size() - m_free_waypoints.size(); }
+    size_t                GetNumLanes() const { return m_lanes.size() - m_free_lanes.size(); }
+    size_t                GetNumCells() const { return m_cells.size(); }
+    void                  Clear();
+
+private:
+    struct Waypoint
+    {
+        Ogre::Vector3     twp_position = Ogre::Vector3::ZERO;
+        int               twp_refs = 0; //!< Agents and lanes; zero = free slot
+        std::vector<int>  twp_out_lanes;
+    };
+
+    struct Cell
+    {
+        std::vector<int>  tc_waypoints;
+        std::vector<int>  tc_lanes;     //!< Every lane crossing the cell
+    };
+
+    typedef std::unordered_map<uint64_t, Cell> CellMap;
+
+    void                  EraseFromCell(CellMap::iterator cell, std::vector<int>& list, int id);
+
+    std::vector<Waypoint>                   m_waypoints;
+    std::vector<int>                        m_free_waypoints;
+    std::vector<Lane>                       m_lanes;
+    std::vector<int>                        m_free_lanes;
+    CellMap                                 m_cells;
+};
+
+/// Uniform horizontal grid of actors, refilled every frame, for neighbour queries.
+class TrafficActorGrid
+{
+public:
+    static const float CELL_SIZE;
+
+    /// Empties the grid; cells which stayed empty since the previous call are erased, the rest keep their buckets.
+    void           Clear();
+    void           Insert(int actor, Ogre::Vector3 const& pos, float radius);
+    /// Appends indices of actors whose center is within `radius` of `pos`, horizontally.
+    void           Query(Ogre::Vector3 const& pos, float radius, std::vector<int>& out_actors) const;
+    float          GetMaxActorRadius() const { return m_max_radius; }
+    size_t         GetNumCells() const { return m_cells.size(); }
+
+private:
+    struct Entry
+    {
+        int            tge_actor;
+        Ogre::Vector3  tge_position;
+    };
+
+    std::unordered_map<uint64_t, std::vector<Entry>>  m_cells;
+    float                                              m_max_radius = 0.f;
+};
+
+/// @} // addtogroup Gameplay
+
+} // namespace RoR
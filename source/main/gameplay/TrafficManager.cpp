@@ -0,0 +1,81 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef USE_ANGELSCRIPT
+
+#include "TrafficManager.h"
+
+#include "ThreadPool.h"
+#include "VehicleAI.h"
+
+#include <algorithm>
+#include <functional>
+
+using namespace Ogre;
+using namespace RoR;
+
+// --------------------------------
+// TrafficManager
+
+void TrafficManager::Update(std::vector<TrafficActorState> const& actors, TrafficWorldState const& world, TrafficQueries const& queries, float dt)
+{
+    m_agents.clear();
+    for (size_t i = 0; i < actors.size(); i++)
+    {
+        if (actors[i].tas_agent)
+            m_agents.push_back(static_cast<int>(i));
+    }
+    if (m_agents.empty())
+        return;
+
+    m_grid.Clear();
+    for (size_t i = 0; i < actors.size(); i++)
+    {
+        m_grid.Insert(static_cast<int>(i), actors[i].tas_position, actors[i].tas_radius);
+    }
+
+    const TrafficUpdateContext ctx{ actors, m_grid, world, queries, dt };
+
+    if (m_agents.size() <= static_cast<size_t>(AGENTS_PER_TASK))
+    {
+        for (int i : m_agents)
+        {
+            actors[i].tas_agent->computeUpdate(ctx, i);
+        }
+    }
+    else
+    {
+        std::vector<std::function<void()>> tasks;
+        for (size_t begin = 0; begin < m_agents.size(); begin += AGENTS_PER_TASK)
+        {
+            const size_t end = std::min(begin + AGENTS_PER_TASK, m_agents.size());
+            tasks.push_back([this, &ctx, begin, end]()
+            {
+                for (size_t k = begin; k < end; k++)
+                {
+                    const int i = m_agents[k];
+                    ctx.actors[i].tas_agent->computeUpdate(ctx, i);
+                }
+            });
+        }
+        App::GetThreadPool()->Parallelize(tasks);
+    }
+}
+
+#endif // USE_ANGELSCRIPT
@@ -0,0 +1,134 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Central update of all AI-driven actors (`VehicleAI`), owned by `ActorManager`.
+
+#pragma once
+
+#ifdef USE_ANGELSCRIPT
+
+#include "Application.h"
+#include "TrafficLaneGraph.h"
+
+#include <OgreVector3.h>
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Gameplay
+/// @{
+
+enum class TrafficMode
+{
+    NORMAL,    //!< Follow waypoints, slow down for turns, keep distance
+    RACE,
+    DRAG_RACE,
+    CRASH,
+    CHASE      //!< Drive at the player
+};
+
+/// Per-agent settings, copied from the top menubar when the AI starts (`VehicleAI::setActive()`)
+struct TrafficAgentParams
+{
+    TrafficMode    tap_mode = TrafficMode::NORMAL;
+    float          tap_speed = 50.f;            //!< Km/h; knots for boats
+    float          tap_altitude = 1000.f;       //!< Feet; airplanes
+    int            tap_position_scheme = 0;     //!< 0 = behind each other, 1 = parallel, 2 = opposite; see `VehicleAI::getTranslation()`
+};
+
+/// Actor data the AI needs, gathered on main thread once per frame (`ActorManager::UpdateTraffic()`)
+struct TrafficActorState
+{
+    VehicleAI*            tas_agent = nullptr;  //!< Null if the actor isn't AI-driven
+    Ogre::Vector3         tas_position = Ogre::Vector3::ZERO;
+    Ogre::Vector3         tas_direction = Ogre::Vector3::UNIT_Z;
+    Ogre::Vector3         tas_camera_dir = Ogre::Vector3::UNIT_Z;
+    Ogre::Vector3         tas_camera_roll = Ogre::Vector3::UNIT_X;
+    Ogre::Vector3         tas_camera_velocity = Ogre::Vector3::ZERO;
+    Ogre::Vector3         tas_box_min = Ogre::Vector3::ZERO;  //!< Bounding box of all nodes
+    Ogre::Vector3         tas_box_max = Ogre::Vector3::ZERO;
+    float                 tas_rotation = 0.f;
+    float                 tas_radius = 0.f;     //!< Horizontal, around `tas_position`
+    float                 tas_wheel_speed = 0.f;
+    bool                  tas_driveable = false;
+    bool                  tas_has_engine = false;
+    int                   tas_num_screwprops = 0;
+    int                   tas_num_aeroengines = 0;
+};
+
+/// Player data the AI needs, gathered on main thread once per frame
+struct TrafficWorldState
+{
+    bool           tws_player_in_vehicle = false;
+    Ogre::Vector3  tws_player_actor_pos = Ogre::Vector3::ZERO;
+    float          tws_player_actor_speed = 0.f;
+    Ogre::Vector3  tws_character_pos = Ogre::Vector3::ZERO;
+    bool           tws_character_on_foot = false;  //!< Not coupled to any actor
+};
+
+/// Node queries the AI needs, by index to `TrafficUpdateContext::actors`; called from the thread pool.
+/// The game answers them with `ActorQueries`.
+class TrafficQueries
+{
+public:
+    virtual ~TrafficQueries() {}
+
+    /// Is any node of actor `a` within `distance` of any node of actor `b`?
+    virtual bool           AreActorsWithin(int a, int b, float distance) const = 0;
+    /// Is any node of `actor` within `distance` of `point`?
+    virtual bool           IsActorNodeWithin(int actor, Ogre::Vector3 const& point, float distance) const = 0;
+};
+
+/// Input of `VehicleAI::computeUpdate()`: read-only, shared by all agents during the parallel step
+struct TrafficUpdateContext
+{
+    std::vector<TrafficActorState> const&  actors;
+    TrafficActorGrid const&                grid;
+    TrafficWorldState const&               world;
+    TrafficQueries const&                  queries;
+    float                                  dt;
+};
+
+/// Drives all active `VehicleAI` agents, in 3 steps every frame:
+///  1. Gather: main thread snapshots the actors into `TrafficActorState`.
+///  2. Compute: agents decide steering/speed on the thread pool, from the snapshots only (`Update()`).
+///  3. Apply: main thread writes the decisions to the actors.
+/// Steps 1 and 3 need the actors and are done by `ActorManager::UpdateTraffic()`.
+class TrafficManager
+{
+public:
+    static const int AGENTS_PER_TASK = 16;
+
+    /// Runs `VehicleAI::computeUpdate()` of every actor with `TrafficActorState::tas_agent` set.
+    void                   Update(std::vector<TrafficActorState> const& actors, TrafficWorldState const& world, TrafficQueries const& queries, float dt);
+    TrafficLaneGraph&      GetLaneGraph() { return m_lane_graph; }
+    size_t                 GetNumActiveAgents() const { return m_agents.size(); }
+
+private:
+    TrafficLaneGraph                 m_lane_graph;
+    TrafficActorGrid                 m_grid;
+    std::vector<int>                 m_agents;      //!< Indices to the actors passed to `Update()`
+};
+
+/// @} // addtogroup Gameplay
+
+} // namespace RoR
+
+#endif // USE_ANGELSCRIPT
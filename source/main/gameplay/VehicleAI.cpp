@@ -38,37 +38,20 @@
 using namespace Ogre;
 using namespace RoR;
 
-VehicleAI::VehicleAI(ActorPtr b) :
-    is_waiting(false),
-    wait_time(0.0f)
-{
-    beam = b;
-}
-
-VehicleAI::~VehicleAI()
-{
-}
-
 void VehicleAI::setActive(bool value)
 {
     is_enabled = value;
-    init_y = beam->getPosition().y;
-}
+    ActorPtr beam = this->getActor();
+    if (beam)
+        init_y = beam->getPosition().y;
 
-bool VehicleAI::isActive()
-{
-    return is_enabled;
-}
-
-void VehicleAI::addWaypoint(std::string const& id, Ogre::Vector3 const& point)
-{
-    if (current_waypoint == Vector3::ZERO)
-        current_waypoint = point;
-
-    free_waypoints++;
-    waypoints.emplace(free_waypoints, point);
-    waypoint_ids.emplace(id, free_waypoints);
-    waypoint_names.emplace(free_waypoints, id);
+    if (value)
+    {
+        params.tap_mode = static_cast<TrafficMode>(App::GetGuiManager()->TopMenubar.ai_mode);
+        params.tap_speed = static_cast<float>(App::GetGuiManager()->TopMenubar.ai_speed);
+        params.tap_altitude = static_cast<float>(App::GetGuiManager()->TopMenubar.ai_altitude);
+        params.tap_position_scheme = App::GetGuiManager()->TopMenubar.ai_position_scheme;
+    }
 }
 
 void VehicleAI::addWaypoints(AngelScript::CScriptDictionary& d)
@@ -85,6 +68,9 @@ void VehicleAI::addWaypoints(AngelScript::CScriptDictionary& d)
 Ogre::Vector3 VehicleAI::getTranslation(int offset, unsigned int wp)
 {
     Ogre::Vector3 translation = Ogre::Vector3::ZERO;
+    ActorPtr beam = this->getActor();
+    if (!beam)
+        return translation;
 
     if (int(wp) == 0) // First waypoint we have nothing to compare, return translation based on initial vehicle rotation
     {
@@ -124,33 +110,7 @@ Ogre::Vector3 VehicleAI::getTranslation(int offset, unsigned int wp)
     return translation;
 }
 
-void VehicleAI::addEvent(std::string const& id, int ev)
-{
-    int waypointid = waypoint_ids[id];
-    if (waypointid)
-        waypoint_events.emplace(waypointid, ev);
-}
-
-void VehicleAI::setValueAtWaypoint(std::string const& id, int value_id, float value)
-{
-    int waypointid = waypoint_ids[id];
-    if (waypointid)
-    {
-        switch (value_id)
-        {
-        case AI_SPEED:
-            waypoint_speed.emplace(id, value);
-            break;
-        case AI_POWER:
-            waypoint_power.emplace(waypointid, value);
-            break;
-        default:
-            break;
-        }
-    }
-}
-
-void VehicleAI::updateWaypoint()
+void VehicleAI::updateWaypoint(ActorPtr const& beam)
 {
     if (waypoint_names[current_waypoint_id] != "")
     {
@@ -173,20 +133,8 @@ void VehicleAI::updateWaypoint()
         }
     }
 
-    float speed = waypoint_speed[waypoint_names[current_waypoint_id]];
-    if (speed)
-        maxspeed = speed;
-
-    float power = waypoint_power[current_waypoint_id];
-    if (power)
-        acc_power = power;
-
-    current_waypoint_id++;
-    if (current_waypoint_id > free_waypoints)
+    if (this->advanceWaypoint())
     {
-        current_waypoint_id = 0;
-        last_waypoint = true;
-
         if (beam->ar_engine || beam->ar_num_screwprops > 0) // Keep airplanes going
         {
             is_enabled = false;
@@ -204,338 +152,51 @@ void VehicleAI::updateWaypoint()
             }
         }
     }
-    current_waypoint = waypoints[current_waypoint_id];
-
-    if (beam->ar_engine)
-    {
-        prev_waypoint = waypoints[current_waypoint_id - 1];
-        next_waypoint = waypoints[current_waypoint_id + 1];
-    }
 }
 
-void VehicleAI::update(float dt, int doUpdate)
+void VehicleAI::applyUpdate(ActorPtr const& beam)
 {
-    if (is_waiting)
+    if (command.reached_waypoint)
     {
-        wait_time -= dt;
-        if (wait_time < 0)
-        {
-            is_waiting = false;
-        }
+        this->updateWaypoint(beam);
         return;
     }
 
-    Vector3 mAgentPosition = beam->getPosition();
-    // Vector3 > Vector2
-    mAgentPosition.y = 0;
-    current_waypoint.y = 0;
-    prev_waypoint.y = 0;
-    next_waypoint.y = 0;
-
-    int dist = 5;
-    if (beam->ar_num_screwprops > 0)
-    {
-        dist = 50; // More tolerance for boats
-    }
-    else if (beam->ar_num_aeroengines > 0)
-    {
-        dist = 100; // Even more tolerance for airplanes
-    }
-
-    // Find the angle (Radian) of the upcoming turn
-    Ogre:;Vector3 dir1 = current_waypoint - prev_waypoint;
-    Ogre::Vector3 dir2 = next_waypoint - current_waypoint;
-    float angle_rad = 0;
-    float angle_deg = 0;
-    if (App::GetGuiManager()->TopMenubar.ai_mode == 0) // Normal driving mode
+    if (command.steer_wheels)
     {
-        angle_rad = dir1.angleBetween(dir2.normalisedCopy()).valueRadians(); // PI
-        angle_deg = dir1.angleBetween(dir2.normalisedCopy()).valueDegrees(); // Degrees 0 - 180
+        beam->ar_hydro_dir_command = command.wheels;
     }
 
-    if (App::GetGuiManager()->TopMenubar.ai_mode == 4) // Chase driving mode
-    {
-        if (App::GetGameContext()->GetPlayerActor()) // We are in vehicle
-        {
-            current_waypoint = App::GetGameContext()->GetPlayerActor()->getPosition();
-        }
-        else // We are in feet
-        {
-            current_waypoint = App::GetGameContext()->GetPlayerCharacter()->getPosition();
-        }
-    }
-    else
-    {
-        for (int i = 0; i < beam->ar_num_nodes; i++)
-        {
-            Ogre::Vector3 pos = beam->getNodePosition(i);
-            pos.y = 0;
-            if (current_waypoint.distance(pos) < dist)
-            {
-                updateWaypoint();
-                return;
-            }
-        }
-    }
-
-    Vector3 TargetPosition = current_waypoint;
-    TargetPosition.y = 0; // Vector3 > Vector2
-    Quaternion TargetOrientation = Quaternion::ZERO;
-
-    Quaternion mAgentOrientation = Quaternion(Radian(beam->getRotation()), Vector3::NEGATIVE_UNIT_Y);
-    mAgentOrientation.normalise();
-
-    Vector3 mVectorToTarget = TargetPosition - mAgentPosition; // A-B = B->A
-    mAgentPosition.normalise();
-
-    Vector3 mAgentHeading = mAgentOrientation * mAgentPosition;
-    Vector3 mTargetHeading = TargetOrientation * TargetPosition;
-    mAgentHeading.normalise();
-    mTargetHeading.normalise();
-
-    // Compute new torque scalar (-1.0 to 1.0) based on heading vector to target.
-    Vector3 mSteeringForce = mAgentOrientation.Inverse() * mVectorToTarget;
-    mSteeringForce.normalise();
-
-    float mYaw = mSteeringForce.x;
-    float mPitch = mSteeringForce.z;
-    //float mRoll   = mTargetVO.getRotationTo( mAgentVO ).getRoll().valueRadians();
-
-    if (mPitch > 0)
-    {
-        if (mYaw > 0)
-            mYaw = 1;
-        else
-            mYaw = -1;
-    }
-
-    // Steer truck
-    if (beam->ar_engine)
-    {
-        beam->ar_hydro_dir_command = mYaw; // mYaw
-    }
-
-    // Steer boat
-    if (beam->ar_num_screwprops > 0)
+    if (command.steer_rudders)
     {
         for (int i = 0; i < beam->ar_num_screwprops; i++)
         {
-            beam->ar_screwprops[i]->setRudder(-mYaw);
+            beam->ar_screwprops[i]->setRudder(command.rudders);
         }
     }
 
-    // Steer airplane
-    if (beam->ar_num_aeroengines > 0)
+    if (command.set_aileron)
     {
-        if (!last_waypoint) // Not last waypoint yet, follow waypoints
-        {
-            beam->ar_hydro_dir_command = mYaw; // Wheels
-            beam->ar_aileron = mYaw / 2; // Wings
-
-            if (abs(beam->GetCameraRoll().y) > 0.5f) // Oversteer, avoid flip
-            {
-                beam->ar_aileron = 0;
-            }
-        }
-
-        if (abs(mYaw) < 0.1f || last_waypoint) // Too little steering or last waypoint, stabilize
-        {
-            beam->ar_aileron = beam->GetCameraRoll().y;
-        }
+        beam->ar_aileron = command.aileron;
     }
 
-    if (beam->ar_engine) // Truck
+    if (command.drive && beam->ar_engine)
     {
         // Start engine if not running
         if (!beam->ar_engine->isRunning())
             beam->ar_engine->StartEngine();
 
-        beam->ar_parking_brake = false;
-        float kmh_wheel_speed = beam->getWheelSpeed() * 3.6;
-
-        if (abs(mYaw) < 0.5f)
-        {
-            if (kmh_wheel_speed < maxspeed - 1)
-            {
-                beam->ar_brake = 0;
-                beam->ar_engine->autoSetAcc(acc_power - (angle_rad * 0.1f)); // Start easy after turn
-            }
-            else if (kmh_wheel_speed > maxspeed + 1)
-            {
-                beam->ar_brake = 1.0f / 3.0f;
-                beam->ar_engine->autoSetAcc(0);
-            }
-            else
-            {
-                beam->ar_brake = 0;
-                beam->ar_engine->autoSetAcc(0);
-            }
-        }
-        else
-        {
-            if (kmh_wheel_speed < maxspeed - 1)
-            {
-                beam->ar_brake = 0;
-                beam->ar_engine->autoSetAcc(acc_power / 3);
-            }
-            else if (kmh_wheel_speed > maxspeed + 1)
-            {
-                beam->ar_brake = 1.0f / 2.0f;
-                beam->ar_engine->autoSetAcc(0);
-            }
-            else
-            {
-                beam->ar_brake = 0;
-                beam->ar_engine->autoSetAcc(0);
-            }
-        }
-
-        if (App::GetGuiManager()->TopMenubar.ai_mode == 0) // Normal driving mode
-        {
-            Ogre::Vector3 pos = beam->getPosition();
-            pos.y = 0;
-
-            if (waypoint_speed[waypoint_names[current_waypoint_id-1]] == -1)
-            {
-                // Turn ahead, reduce speed relative to the angle and the current speed
-                if (angle_deg > 0 && current_waypoint.distance(pos) < kmh_wheel_speed)
-                {
-                    // Speed limit: 10 - 180 degree angle -> 50 - 5 km/h
-                    float t = ((angle_deg - 10) / (180 - 10))*1.4f; // Reduce a bit to achive ~20 km/h for a 90 degree angle
-                    maxspeed = (1 - t)*50 + t*5;
-                    if (maxspeed > 50) // Limit to 50 km/h
-                    {
-                        maxspeed = 50;
-                    }
-                    if (maxspeed > App::GetGuiManager()->TopMenubar.ai_speed) // Respect user defined lower speed
-                    {
-                        maxspeed = App::GetGuiManager()->TopMenubar.ai_speed;
-                    }
-                }
-                else // Reset
-                {
-                    maxspeed = App::GetGuiManager()->TopMenubar.ai_speed;
-                }
-            }
-
-            // Collision avoidance with other actors
-            for (ActorPtr& actor : App::GetGameContext()->GetActorManager()->GetActors())
-            {
-                if (actor->ar_driveable == NOT_DRIVEABLE) // Ignore objects that may be actors
-                    continue;
-                if (actor == beam) // Ignore ourselves
-                    continue;
-
-                Ogre::Vector3 a = actor->getPosition() - beam->getPosition();
-
-                if (beam->getDirection().angleBetween(a).valueDegrees() < 30) // Is in front
-                {
-                    // Actor ahead, slow down - distance relative to current speed so the faster we go the earlier we slow down
-                    if (beam->getPosition().distance(actor->getPosition()) < kmh_wheel_speed)
-                    {
-                        beam->ar_brake = 1;
-                        beam->ar_engine->autoSetAcc(0);
-                    }
-
-                    for (int i = 0; i < beam->ar_num_nodes; i++)
-                    {
-                        for (int k = 0; k < actor->ar_num_nodes; k++)
-                        {
-                            // Too close, stop
-                            if (beam->getNodePosition(i).distance(actor->getNodePosition(k)) < 5)
-                            {
-                                beam->ar_parking_brake = true;
-                                beam->toggleHeadlights();
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
-
-            // Collision avoidance with character
-            Ogre::Vector3 b = App::GetGameContext()->GetPlayerCharacter()->getPosition() - beam->getPosition();
-
-            if (beam->getDirection().angleBetween(b).valueDegrees() < 30 && // Is in front
-                App::GetGameContext()->GetPlayerCharacter()->GetActorCoupling() == nullptr)
-            {
-                // Character ahead, slow down - distance relative to current speed so the faster we go the earlier we slow down
-                if (beam->getPosition().distance(App::GetGameContext()->GetPlayerCharacter()->getPosition()) < kmh_wheel_speed)
-                {
-                    beam->ar_brake = 1;
-                    beam->ar_engine->autoSetAcc(0);
-                }
-
-                for (int i = 0; i < beam->ar_num_nodes; i++)
-                {
-                    // Too close, steer
-                    if (beam->getNodePosition(i).distance(App::GetGameContext()->GetPlayerCharacter()->getPosition()) < 5)
-                    {
-                        beam->ar_hydro_dir_command = -1;
-                        beam->toggleHeadlights();
-                        break;
-                    }
-                }
-            }
-        }
-        else if (App::GetGuiManager()->TopMenubar.ai_mode == 1 || // Race driving mode
-                 App::GetGuiManager()->TopMenubar.ai_mode == 2 || // Drag race mode
-                 App::GetGuiManager()->TopMenubar.ai_mode == 3) // Crash driving mode
-        {
-            if (waypoint_speed[waypoint_names[current_waypoint_id-1]] == -1)
-            {
-                maxspeed = App::GetGuiManager()->TopMenubar.ai_speed;
-            }
-        }
-        else if (App::GetGuiManager()->TopMenubar.ai_mode == 4) // Chase driving mode
-        {
-            if (App::GetGameContext()->GetPlayerActor())
-            {
-                maxspeed += App::GetGameContext()->GetPlayerActor()->getSpeed(); // Get him!!
-            }
-            else // Reset
-            {
-                maxspeed = App::GetGuiManager()->TopMenubar.ai_speed;
-            }
-
-            // Collision avoidance with other actors
-            for (ActorPtr& actor : App::GetGameContext()->GetActorManager()->GetActors())
-            {
-                if (actor->ar_driveable == NOT_DRIVEABLE) // Ignore objects that may be actors
-                    continue;
-                if (actor == beam) // Ignore ourselves
-                    continue;
-
-                Ogre::Vector3 a = actor->getPosition() - beam->getPosition();
-
-                if (beam->getDirection().angleBetween(a).valueDegrees() < 30) // Is in front
-                {
-                    // Too close, stop
-                    if (beam->getPosition().distance(actor->getPosition()) < 10)
-                    {
-                        maxspeed = App::GetGuiManager()->TopMenubar.ai_speed;
-                        beam->ar_parking_brake = true;
-                        beam->toggleHeadlights();
-                    }
-                }
-            }
-
-            // Collision avoidance with character
-            Ogre::Vector3 b = App::GetGameContext()->GetPlayerCharacter()->getPosition() - beam->getPosition();
+        beam->ar_parking_brake = command.parking_brake;
+        beam->ar_brake = command.brake;
+        beam->ar_engine->autoSetAcc(command.acc);
+    }
 
-            if (beam->getDirection().angleBetween(b).valueDegrees() < 30 && // Is in front
-                App::GetGameContext()->GetPlayerCharacter()->GetActorCoupling() == nullptr)
-            {
-                // Too close, stop
-                if (beam->getPosition().distance(App::GetGameContext()->GetPlayerCharacter()->getPosition()) < 20)
-                {
-                    beam->ar_parking_brake = true;
-                    beam->toggleHeadlights();
-                }
-            }
-        }
+    for (int i = 0; i < command.headlight_toggles; i++)
+    {
+        beam->toggleHeadlights();
     }
-    else if (beam->ar_num_aeroengines > 0) // Airplane
+
+    if (command.fly)
     {
         if (beam->getParkingBrake())
         {
@@ -549,103 +210,30 @@ void VehicleAI::update(float dt, int doUpdate)
                 beam->ar_aeroengines[i]->flipStart();
                 beam->ar_aeroengines[i]->setThrottle(1);
             }
-        }
-
-        float target_alt = App::GetGuiManager()->TopMenubar.ai_altitude / 3.28083f; // Feet
-
-        if (beam->getPosition().y - init_y < target_alt * 0.8f)
-        {
-            hold = false;
-        }
-
-        if (beam->getPosition().y - init_y < target_alt && !hold) // Reach defined altitude
-        {
-            beam->ar_elevator = 0.5f - abs(beam->GetCameraDir().y);
-            beam->ar_aerial_flap = 4*beam->ar_elevator;
-
-            if (beam->GetCameraDir().y > 0.5f) // Avoid over-elevate flip
-            {
-                beam->ar_elevator = -0.05f;
-            }
-        }
-        else if (beam->getPosition().y - init_y > target_alt) // We reached defined altitude, hold
-        {
-            for (int i = 0; i < beam->ar_num_aeroengines; i++)
+            if (command.aero_throttle >= 0.f)
             {
-                beam->ar_aeroengines[i]->setThrottle(0.9f);
+                beam->ar_aeroengines[i]->setThrottle(command.aero_throttle);
             }
-            hold = true;
         }
 
-        if (hold)
-        {
-            beam->ar_elevator = -beam->GetCameraDir().y;
-
-            if (beam->GetCameraDir().y < 0)
-            {
-                beam->ar_aerial_flap = 1;
-            }
-            else if (beam->GetCameraDir().y > 0)
-            {
-                beam->ar_aerial_flap = 0;
-            }
-        }
+        if (command.set_elevator)
+            beam->ar_elevator = command.elevator;
+        if (command.set_flap)
+            beam->ar_aerial_flap = command.flap;
     }
-    else if (beam->ar_num_screwprops > 0) // Boat
-    {
-        Vector3 hdir = beam->GetCameraDir();
-        float knots = hdir.dotProduct(beam->ar_nodes[beam->ar_main_camera_node_pos].Velocity) * 1.9438f; // 1.943 = m/s in knots/s
-        maxspeed = App::GetGuiManager()->TopMenubar.ai_speed;
 
-        if (abs(mYaw) < 0.5f)
-        {
-            if (knots < maxspeed - 1)
-            {
-                for (int i = 0; i < beam->ar_num_screwprops; i++)
-                {
-                    beam->ar_screwprops[i]->setThrottle(acc_power);
-                }
-            }
-            else if (knots > maxspeed + 1)
-            {
-                for (int i = 0; i < beam->ar_num_screwprops; i++)
-                {
-                    beam->ar_screwprops[i]->setThrottle(0);
-                }
-            }
-            else
-            {
-                for (int i = 0; i < beam->ar_num_screwprops; i++)
-                {
-                    beam->ar_screwprops[i]->setThrottle(0);
-                }
-            }
-        }
-        else
+    if (command.sail)
+    {
+        for (int i = 0; i < beam->ar_num_screwprops; i++)
         {
-            if (knots < maxspeed - 1)
-            {
-                for (int i = 0; i < beam->ar_num_screwprops; i++)
-                {
-                    beam->ar_screwprops[i]->setThrottle(acc_power / 3);
-                }
-            }
-            else if (knots > maxspeed + 1)
-            {
-                for (int i = 0; i < beam->ar_num_screwprops; i++)
-                {
-                    beam->ar_screwprops[i]->setThrottle(0);
-                }
-            }
-            else
-            {
-                for (int i = 0; i < beam->ar_num_screwprops; i++)
-                {
-                    beam->ar_screwprops[i]->setThrottle(0);
-                }
-            }
+            beam->ar_screwprops[i]->setThrottle(command.screw_throttle);
         }
     }
 }
 
+ActorPtr VehicleAI::getActor() const
+{
+    return App::GetGameContext()->GetActorManager()->GetActorById(actor_id);
+}
+
 #endif // USE_ANGELSCRIPT
@@ -31,6 +31,7 @@
 
 #include "Application.h"
 #include "RefCountingObject.h"
+#include "TrafficManager.h"
 
 #include "scriptdictionary/scriptdictionary.h"
 
@@ -63,7 +64,7 @@ class VehicleAI : public RefCountingObject<VehicleAI>
     // PLEASE maintain the same order as in 'bindings/VehicleAiAngelscript.cpp' and 'doc/../VehicleAIClass.h'
 
 public:
-    VehicleAI(ActorPtr b);
+    VehicleAI(ActorInstanceID_t actor_id, TrafficLaneGraph& lane_graph);
     virtual ~VehicleAI() override;
 
     /**
@@ -123,28 +124,90 @@ public:
 
     // Not exported to script:
 
+    /// Result of `computeUpdate()`, applied by `applyUpdate()`
+    struct Command
+    {
+        bool  reached_waypoint = false;
+        bool  steer_wheels = false;      //!< Trucks and airplanes
+        float wheels = 0.f;
+        bool  steer_rudders = false;     //!< Boats
+        float rudders = 0.f;
+        bool  set_aileron = false;
+        float aileron = 0.f;
+        bool  drive = false;             //!< Trucks: `acc`, `brake`, `parking_brake`
+        float acc = 0.f;
+        float brake = 0.f;
+        bool  parking_brake = false;
+        int   headlight_toggles = 0;
+        bool  fly = false;               //!< Airplanes: `elevator`, `flap`, `aero_throttle`
+        bool  set_elevator = false;
+        float elevator = 0.f;
+        bool  set_flap = false;
+        int   flap = 0;
+        float aero_throttle = -1.f;      //!< Negative = keep
+        bool  sail = false;              //!< Boats: `screw_throttle`
+        float screw_throttle = 0.f;
+    };
+
+    TrafficAgentParams const& getParams() const { return params; }
+    void setParams(TrafficAgentParams const& p) { params = p; }
+    Command const& getCommand() const { return command; }
+
+    /**
+     *  Decides steering and speed; runs on the thread pool, must only touch `ctx` and own driving state.
+     *  @param self_index Index of the own actor to `ctx.actors`.
+     *  @see TrafficManager
+     */
+    void computeUpdate(TrafficUpdateContext const& ctx, int self_index);
+
+    /**
+     *  Writes the decisions of `computeUpdate()` to the vehicle; main thread.
+     */
+    void applyUpdate(ActorPtr const& beam);
+
+    /**
+     *  Moves on to the next waypoint, picking up the speed and power set at the reached one.
+     *  @return True if the reached waypoint was the last one.
+     */
+    bool advanceWaypoint();
+
     /**
-     *  Updates the AI.
+     *  Drops the references of the route to the shared `TrafficLaneGraph`; called when the actor is disposed.
      */
-    void update(float dt, int doUpdate);
+    void releaseRoute();
 
 private:
     /**
-     *   Updates the AI waypoint.
+     *   Updates the AI waypoint and fires its events.
+     */
+    void updateWaypoint(ActorPtr const& beam);
+
+    /**
+     *   Position of waypoint by ID; ID 0 (before the first waypoint) and IDs past the end are the origin.
+     */
+    Ogre::Vector3 getWaypointPosition(int id) const;
+
+    /**
+     *   The driven actor; null once it's gone, while a script still holds the AI.
      */
-    void updateWaypoint();
+    ActorPtr getActor() const;
 
     bool is_waiting=false;//!<
     float wait_time=0.f;//!<(seconds) The amount of time the AI has to wait.
 
     float maxspeed = 50;//!<(KM/H) The max speed the AI is allowed to drive.
-    ActorPtr beam;//!< The verhicle the AI is driving.
+    ActorInstanceID_t actor_id;//!< The verhicle the AI is driving.
+    TrafficLaneGraph* lane_graph;//!< Shared by all agents, see `TrafficManager`.
     bool is_enabled = false;//!< True if the AI is driving.
+    TrafficAgentParams params;//!< Copied from top menubar on activation.
+    Command command;//!< Written by `computeUpdate()` (thread pool), read by `applyUpdate()` (main thread).
     Ogre::Vector3 current_waypoint = Ogre::Vector3::ZERO;//!< The coordinates of the waypoint that the AI is driving to.
     Ogre::Vector3 prev_waypoint = Ogre::Vector3::ZERO;;//!< The coordinates of the previous waypoint.
     Ogre::Vector3 next_waypoint = Ogre::Vector3::ZERO;;//!< The coordinates of the next waypoint.
     int current_waypoint_id = 0;//!< The curent waypoint ID.
-    std::map<int, Ogre::Vector3> waypoints;//!< Map with all waypoints.
+    float current_speed_preset = 0.f;//!< Speed set at the previous waypoint (-1 = adapt to turns), looked up by `advanceWaypoint()`.
+    std::vector<int> waypoints;//!< Waypoint IDs (index) to `TrafficLaneGraph` waypoints; index 0 is unused.
+    std::vector<int> lanes;//!< `TrafficLaneGraph` lanes between consecutive waypoints.
     std::map<std::string, int> waypoint_ids;//!< Map with all waypoint IDs.
     std::map<int, std::string> waypoint_names;//!< Map with all waypoint names.
     std::map<int, int> waypoint_events;//!< Map with all waypoint events.
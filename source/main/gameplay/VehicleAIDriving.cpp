@@ -0,0 +1,534 @@
+/*
+    This source file is part of Rigs of Rods
+
+    Copyright 2005-2012 Pierre-Michel Ricordel
+    Copyright 2007-2012 Thomas Fischer
+    Copyright 2013-2016 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief  VehicleAI's route and driving decisions; free of `Actor` and the game globals, the traffic test runs them as they are.
+
+#ifdef USE_ANGELSCRIPT
+
+#include "VehicleAI.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Ogre;
+using namespace RoR;
+
+VehicleAI::VehicleAI(ActorInstanceID_t id, TrafficLaneGraph& graph) :
+    is_waiting(false),
+    wait_time(0.0f),
+    actor_id(id),
+    lane_graph(&graph)
+{
+    waypoints.push_back(-1); // ID 0 is unused
+}
+
+VehicleAI::~VehicleAI()
+{
+}
+
+bool VehicleAI::isActive()
+{
+    return is_enabled;
+}
+
+void VehicleAI::addWaypoint(std::string const& id, Ogre::Vector3 const& point)
+{
+    if (current_waypoint == Vector3::ZERO)
+        current_waypoint = point;
+
+    TrafficLaneGraph& graph = *lane_graph;
+    const int waypoint = graph.AddWaypoint(point);
+    if (waypoints.size() > 1)
+    {
+        const int lane = graph.AddLane(waypoints.back(), waypoint);
+        if (lane != -1) // Consecutive waypoints may have merged
+            lanes.push_back(lane);
+    }
+
+    free_waypoints++;
+    waypoints.push_back(waypoint);
+    waypoint_ids.emplace(id, free_waypoints);
+    waypoint_names.emplace(free_waypoints, id);
+}
+
+void VehicleAI::addEvent(std::string const& id, int ev)
+{
+    int waypointid = waypoint_ids[id];
+    if (waypointid)
+        waypoint_events.emplace(waypointid, ev);
+}
+
+void VehicleAI::setValueAtWaypoint(std::string const& id, int value_id, float value)
+{
+    int waypointid = waypoint_ids[id];
+    if (waypointid)
+    {
+        switch (value_id)
+        {
+        case AI_SPEED:
+            waypoint_speed.emplace(id, value);
+            break;
+        case AI_POWER:
+            waypoint_power.emplace(waypointid, value);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+Ogre::Vector3 VehicleAI::getWaypointPosition(int id) const
+{
+    if (id <= 0 || id >= static_cast<int>(waypoints.size()))
+        return Ogre::Vector3::ZERO;
+
+    return lane_graph->GetWaypoint(waypoints[id]);
+}
+
+bool VehicleAI::advanceWaypoint()
+{
+    float speed = waypoint_speed[waypoint_names[current_waypoint_id]];
+    if (speed)
+        maxspeed = speed;
+
+    float power = waypoint_power[current_waypoint_id];
+    if (power)
+        acc_power = power;
+
+    bool passed_last = false;
+    current_waypoint_id++;
+    if (current_waypoint_id > free_waypoints)
+    {
+        current_waypoint_id = 0;
+        last_waypoint = true;
+        passed_last = true;
+    }
+    current_waypoint = this->getWaypointPosition(current_waypoint_id);
+
+    // The maps must not be touched by `computeUpdate()`
+    current_speed_preset = 0.f;
+    auto prev_name = waypoint_names.find(current_waypoint_id - 1);
+    if (prev_name != waypoint_names.end())
+    {
+        auto prev_speed = waypoint_speed.find(prev_name->second);
+        if (prev_speed != waypoint_speed.end())
+            current_speed_preset = prev_speed->second;
+    }
+
+    // The angle of the upcoming turn; only trucks slow down for it
+    prev_waypoint = this->getWaypointPosition(current_waypoint_id - 1);
+    next_waypoint = this->getWaypointPosition(current_waypoint_id + 1);
+
+    return passed_last;
+}
+
+void VehicleAI::computeUpdate(TrafficUpdateContext const& ctx, int self_index)
+{
+    TrafficActorState const& self = ctx.actors[self_index];
+    command = Command();
+
+    if (is_waiting)
+    {
+        wait_time -= ctx.dt;
+        if (wait_time < 0)
+        {
+            is_waiting = false;
+        }
+        return;
+    }
+
+    Vector3 mAgentPosition = self.tas_position;
+    // Vector3 > Vector2
+    mAgentPosition.y = 0;
+    current_waypoint.y = 0;
+    prev_waypoint.y = 0;
+    next_waypoint.y = 0;
+
+    int dist = 5;
+    if (self.tas_num_screwprops > 0)
+    {
+        dist = 50; // More tolerance for boats
+    }
+    else if (self.tas_num_aeroengines > 0)
+    {
+        dist = 100; // Even more tolerance for airplanes
+    }
+
+    // Find the angle (Radian) of the upcoming turn
+    Ogre::Vector3 dir1 = current_waypoint - prev_waypoint;
+    Ogre::Vector3 dir2 = next_waypoint - current_waypoint;
+    float angle_rad = 0;
+    float angle_deg = 0;
+    if (params.tap_mode == TrafficMode::NORMAL)
+    {
+        angle_rad = dir1.angleBetween(dir2.normalisedCopy()).valueRadians(); // PI
+        angle_deg = dir1.angleBetween(dir2.normalisedCopy()).valueDegrees(); // Degrees 0 - 180
+    }
+
+    if (params.tap_mode == TrafficMode::CHASE)
+    {
+        if (ctx.world.tws_player_in_vehicle) // We are in vehicle
+        {
+            current_waypoint = ctx.world.tws_player_actor_pos;
+        }
+        else // We are in feet
+        {
+            current_waypoint = ctx.world.tws_character_pos;
+        }
+    }
+    else
+    {
+        // Is any node within `dist`? The bounding box surrounds all nodes.
+        const float dx = std::max(std::max(self.tas_box_min.x - current_waypoint.x, current_waypoint.x - self.tas_box_max.x), 0.f);
+        const float dz = std::max(std::max(self.tas_box_min.z - current_waypoint.z, current_waypoint.z - self.tas_box_max.z), 0.f);
+        if (dx * dx + dz * dz < dist * dist)
+        {
+            command.reached_waypoint = true;
+            return;
+        }
+    }
+
+    Vector3 TargetPosition = current_waypoint;
+    TargetPosition.y = 0; // Vector3 > Vector2
+
+    Quaternion mAgentOrientation = Quaternion(Radian(self.tas_rotation), Vector3::NEGATIVE_UNIT_Y);
+    mAgentOrientation.normalise();
+
+    Vector3 mVectorToTarget = TargetPosition - mAgentPosition; // A-B = B->A
+
+    // Compute new torque scalar (-1.0 to 1.0) based on heading vector to target.
+    Vector3 mSteeringForce = mAgentOrientation.Inverse() * mVectorToTarget;
+    mSteeringForce.normalise();
+
+    float mYaw = mSteeringForce.x;
+    float mPitch = mSteeringForce.z;
+
+    if (mPitch > 0)
+    {
+        if (mYaw > 0)
+            mYaw = 1;
+        else
+            mYaw = -1;
+    }
+
+    // Steer truck
+    if (self.tas_has_engine)
+    {
+        command.steer_wheels = true;
+        command.wheels = mYaw;
+    }
+
+    // Steer boat
+    if (self.tas_num_screwprops > 0)
+    {
+        command.steer_rudders = true;
+        command.rudders = -mYaw;
+    }
+
+    // Steer airplane
+    if (self.tas_num_aeroengines > 0)
+    {
+        if (!last_waypoint) // Not last waypoint yet, follow waypoints
+        {
+            command.steer_wheels = true;
+            command.wheels = mYaw; // Wheels
+            command.set_aileron = true;
+            command.aileron = mYaw / 2; // Wings
+
+            if (abs(self.tas_camera_roll.y) > 0.5f) // Oversteer, avoid flip
+            {
+                command.aileron = 0;
+            }
+        }
+
+        if (abs(mYaw) < 0.1f || last_waypoint) // Too little steering or last waypoint, stabilize
+        {
+            command.set_aileron = true;
+            command.aileron = self.tas_camera_roll.y;
+        }
+    }
+
+    if (self.tas_has_engine) // Truck
+    {
+        command.drive = true;
+        command.parking_brake = false;
+        float kmh_wheel_speed = self.tas_wheel_speed * 3.6;
+
+        if (abs(mYaw) < 0.5f)
+        {
+            if (kmh_wheel_speed < maxspeed - 1)
+            {
+                command.brake = 0;
+                command.acc = acc_power - (angle_rad * 0.1f); // Start easy after turn
+            }
+            else if (kmh_wheel_speed > maxspeed + 1)
+            {
+                command.brake = 1.0f / 3.0f;
+                command.acc = 0;
+            }
+            else
+            {
+                command.brake = 0;
+                command.acc = 0;
+            }
+        }
+        else
+        {
+            if (kmh_wheel_speed < maxspeed - 1)
+            {
+                command.brake = 0;
+                command.acc = acc_power / 3;
+            }
+            else if (kmh_wheel_speed > maxspeed + 1)
+            {
+                command.brake = 1.0f / 2.0f;
+                command.acc = 0;
+            }
+            else
+            {
+                command.brake = 0;
+                command.acc = 0;
+            }
+        }
+
+        std::vector<int> neighbours;
+
+        if (params.tap_mode == TrafficMode::NORMAL) // Normal driving mode
+        {
+            Ogre::Vector3 pos = self.tas_position;
+            pos.y = 0;
+
+            if (current_speed_preset == -1)
+            {
+                // Turn ahead, reduce speed relative to the angle and the current speed
+                if (angle_deg > 0 && current_waypoint.distance(pos) < kmh_wheel_speed)
+                {
+                    // Speed limit: 10 - 180 degree angle -> 50 - 5 km/h
+                    float t = ((angle_deg - 10) / (180 - 10))*1.4f; // Reduce a bit to achive ~20 km/h for a 90 degree angle
+                    maxspeed = (1 - t)*50 + t*5;
+                    if (maxspeed > 50) // Limit to 50 km/h
+                    {
+                        maxspeed = 50;
+                    }
+                    if (maxspeed > params.tap_speed) // Respect user defined lower speed
+                    {
+                        maxspeed = params.tap_speed;
+                    }
+                }
+                else // Reset
+                {
+                    maxspeed = params.tap_speed;
+                }
+            }
+
+            // Collision avoidance with other actors; nodes 5m apart can't be farther than that plus both radii.
+            const float reach = std::max(kmh_wheel_speed, 5.f + self.tas_radius + ctx.grid.GetMaxActorRadius());
+            ctx.grid.Query(self.tas_position, reach, neighbours);
+            for (int i : neighbours)
+            {
+                TrafficActorState const& other = ctx.actors[i];
+                if (!other.tas_driveable) // Ignore objects that may be actors
+                    continue;
+                if (i == self_index) // Ignore ourselves
+                    continue;
+
+                Ogre::Vector3 a = other.tas_position - self.tas_position;
+
+                if (self.tas_direction.angleBetween(a).valueDegrees() < 30) // Is in front
+                {
+                    // Actor ahead, slow down - distance relative to current speed so the faster we go the earlier we slow down
+                    if (self.tas_position.distance(other.tas_position) < kmh_wheel_speed)
+                    {
+                        command.brake = 1;
+                        command.acc = 0;
+                    }
+
+                    // Too close, stop
+                    if (ctx.queries.AreActorsWithin(self_index, i, 5.f))
+                    {
+                        command.parking_brake = true;
+                        command.headlight_toggles++;
+                    }
+                }
+            }
+
+            // Collision avoidance with character
+            Ogre::Vector3 b = ctx.world.tws_character_pos - self.tas_position;
+
+            if (self.tas_direction.angleBetween(b).valueDegrees() < 30 && // Is in front
+                ctx.world.tws_character_on_foot)
+            {
+                // Character ahead, slow down - distance relative to current speed so the faster we go the earlier we slow down
+                if (self.tas_position.distance(ctx.world.tws_character_pos) < kmh_wheel_speed)
+                {
+                    command.brake = 1;
+                    command.acc = 0;
+                }
+
+                // Too close, steer
+                if (ctx.queries.IsActorNodeWithin(self_index, ctx.world.tws_character_pos, 5.f))
+                {
+                    command.steer_wheels = true;
+                    command.wheels = -1;
+                    command.headlight_toggles++;
+                }
+            }
+        }
+        else if (params.tap_mode == TrafficMode::RACE ||
+                 params.tap_mode == TrafficMode::DRAG_RACE ||
+                 params.tap_mode == TrafficMode::CRASH)
+        {
+            if (current_speed_preset == -1)
+            {
+                maxspeed = params.tap_speed;
+            }
+        }
+        else if (params.tap_mode == TrafficMode::CHASE)
+        {
+            if (ctx.world.tws_player_in_vehicle)
+            {
+                maxspeed += ctx.world.tws_player_actor_speed; // Get him!!
+            }
+            else // Reset
+            {
+                maxspeed = params.tap_speed;
+            }
+
+            // Collision avoidance with other actors
+            ctx.grid.Query(self.tas_position, 10.f, neighbours);
+            for (int i : neighbours)
+            {
+                TrafficActorState const& other = ctx.actors[i];
+                if (!other.tas_driveable) // Ignore objects that may be actors
+                    continue;
+                if (i == self_index) // Ignore ourselves
+                    continue;
+
+                Ogre::Vector3 a = other.tas_position - self.tas_position;
+
+                if (self.tas_direction.angleBetween(a).valueDegrees() < 30) // Is in front
+                {
+                    // Too close, stop
+                    if (self.tas_position.distance(other.tas_position) < 10)
+                    {
+                        maxspeed = params.tap_speed;
+                        command.parking_brake = true;
+                        command.headlight_toggles++;
+                    }
+                }
+            }
+
+            // Collision avoidance with character
+            Ogre::Vector3 b = ctx.world.tws_character_pos - self.tas_position;
+
+            if (self.tas_direction.angleBetween(b).valueDegrees() < 30 && // Is in front
+                ctx.world.tws_character_on_foot)
+            {
+                // Too close, stop
+                if (self.tas_position.distance(ctx.world.tws_character_pos) < 20)
+                {
+                    command.parking_brake = true;
+                    command.headlight_toggles++;
+                }
+            }
+        }
+    }
+    else if (self.tas_num_aeroengines > 0) // Airplane
+    {
+        command.fly = true;
+
+        float target_alt = params.tap_altitude / 3.28083f; // Feet
+        float altitude = self.tas_position.y - init_y;
+
+        if (altitude < target_alt * 0.8f)
+        {
+            hold = false;
+        }
+
+        if (altitude < target_alt && !hold) // Reach defined altitude
+        {
+            command.set_elevator = true;
+            command.elevator = 0.5f - abs(self.tas_camera_dir.y);
+            command.set_flap = true;
+            command.flap = static_cast<int>(4*command.elevator);
+
+            if (self.tas_camera_dir.y > 0.5f) // Avoid over-elevate flip
+            {
+                command.elevator = -0.05f;
+            }
+        }
+        else if (altitude > target_alt) // We reached defined altitude, hold
+        {
+            command.aero_throttle = 0.9f;
+            hold = true;
+        }
+
+        if (hold)
+        {
+            command.set_elevator = true;
+            command.elevator = -self.tas_camera_dir.y;
+
+            if (self.tas_camera_dir.y < 0)
+            {
+                command.set_flap = true;
+                command.flap = 1;
+            }
+            else if (self.tas_camera_dir.y > 0)
+            {
+                command.set_flap = true;
+                command.flap = 0;
+            }
+        }
+    }
+    else if (self.tas_num_screwprops > 0) // Boat
+    {
+        float knots = self.tas_camera_dir.dotProduct(self.tas_camera_velocity) * 1.9438f; // 1.943 = m/s in knots/s
+        maxspeed = params.tap_speed;
+
+        command.sail = true;
+        if (abs(mYaw) < 0.5f)
+        {
+            command.screw_throttle = (knots < maxspeed - 1) ? acc_power : 0.f;
+        }
+        else
+        {
+            command.screw_throttle = (knots < maxspeed - 1) ? (acc_power / 3) : 0.f;
+        }
+    }
+}
+
+void VehicleAI::releaseRoute()
+{
+    for (int lane : lanes)
+    {
+        lane_graph->ReleaseLane(lane);
+    }
+    for (size_t i = 1; i < waypoints.size(); i++)
+    {
+        lane_graph->ReleaseWaypoint(waypoints[i]);
+    }
+    lanes.clear();
+    waypoints.resize(1);
+}
+
+#endif // USE_ANGELSCRIPT
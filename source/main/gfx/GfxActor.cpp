@@ -1749,7 +1749,7 @@ void RoR::GfxActor::UpdateSimDataBuffer()
         m_simbuf.simbuf_num_gears       = m_actor->ar_engine->getNumGears();
         m_simbuf.simbuf_engine_max_rpm  = m_actor->ar_engine->getMaxRPM();
     }
-    if (m_actor->m_num_wheel_diffs > 0)
+    if (!m_actor->m_wheel_diffs.empty())
     {
         m_simbuf.simbuf_diff_type = m_actor->m_wheel_diffs[0]->GetActiveDiffType();
     }
@@ -1806,7 +1806,23 @@ void RoR::GfxActor::UpdateCabMesh()
 {
     if ((m_cab_entity != nullptr) && (m_cab_mesh != nullptr))
     {
-        m_cab_scene_node->setPosition(m_cab_mesh->UpdateFlexObj());
+        m_cab_mesh->MapFlexObjBuffer(); // Buffer must be locked on main thread
+        FlexObj* cab_mesh = m_cab_mesh;
+        auto func = std::function<void()>([cab_mesh]()
+            {
+                cab_mesh->ComputeFlexObj();
+            });
+        m_cab_mesh_task = App::GetThreadPool()->RunTask(func);
+    }
+}
+
+void RoR::GfxActor::FinishCabMeshTask()
+{
+    if (m_cab_mesh_task)
+    {
+        m_cab_mesh_task->join();
+        m_cab_mesh_task = nullptr;
+        m_cab_scene_node->setPosition(m_cab_mesh->UnmapFlexObjBuffer());
     }
 }
 
@@ -2341,96 +2357,189 @@ float UpdateSmoothShift(PropAnim& anim, float dt, float new_target_cstate)
     return anim.shifterSmooth;
 }
 
-void RoR::GfxActor::CalcPropAnimation(PropAnim& anim, float& cstate, int& div, float dt)
+void RoR::GfxActor::UpdatePropAnimSources()
 {
     // Note: This is not the same as 'animators' - those run on physics thread!
     // ------------------------------------------------------------------------
 
-    //boat rudder
-    if (anim.animFlags & PROP_ANIM_FLAG_BRUDDER)
+    AnimationTable& table = m_prop_anim_table;
+    if (table.IsEmpty())
+        return;
+
+    //boat rudder + throttle
+    if (table.IsSourceUsed(ANIM_SOURCE_BRUDDER) || table.IsSourceUsed(ANIM_SOURCE_BTHROTTLE))
     {
-        size_t spi;
-        float ctmp = 0.0f;
-        for (spi = 0; spi < m_simbuf.simbuf_screwprops.size(); spi++)
+        float rudder = 0.0f;
+        float throttle = 0.0f;
+        for (ScrewpropSB& screwprop: m_simbuf.simbuf_screwprops)
         {
-            ctmp += m_simbuf.simbuf_screwprops[spi].simbuf_sp_rudder;
+            rudder += screwprop.simbuf_sp_rudder;
+            throttle += screwprop.simbuf_sp_throttle;
         }
 
-        if (spi > 0)
-            ctmp = ctmp / spi;
-        cstate = ctmp;
-        div++;
-    }
-
-    //boat throttle
-    if (anim.animFlags & PROP_ANIM_FLAG_BTHROTTLE)
-    {
-        size_t spi;
-        float ctmp = 0.0f;
-        for (spi = 0; spi < m_simbuf.simbuf_screwprops.size(); spi++)
+        const size_t num_screwprops = m_simbuf.simbuf_screwprops.size();
+        if (num_screwprops > 0)
         {
-            ctmp += m_simbuf.simbuf_screwprops[spi].simbuf_sp_throttle;
+            rudder = rudder / num_screwprops;
+            throttle = throttle / num_screwprops;
         }
-
-        if (spi > 0)
-            ctmp = ctmp / spi;
-        cstate = ctmp;
-        div++;
+        table.SetValue(ANIM_SOURCE_BRUDDER, rudder);
+        table.SetValue(ANIM_SOURCE_BTHROTTLE, throttle);
     }
 
     //differential lock status
-    if (anim.animFlags & PROP_ANIM_FLAG_DIFFLOCK)
+    if (table.IsSourceUsed(ANIM_SOURCE_DIFFLOCK))
     {
-        if (m_actor->m_num_wheel_diffs > 0) // read-only attribute - safe to read from here
+        float difflock = 0.5f; // no axles/diffs avail, mode is split by default
+        if (!m_actor->m_wheel_diffs.empty()) // read-only attribute - safe to read from here
         {
             switch (m_simbuf.simbuf_diff_type)
             {
-            case DiffType::OPEN_DIFF:
-                cstate = 0.0f;
-                break;
-            case DiffType::SPLIT_DIFF:
-                cstate = 0.5f;
-                break;
-            case DiffType::LOCKED_DIFF:
-                cstate = 1.0f;
-                break;
-            default:;
+            case DiffType::OPEN_DIFF:   difflock = 0.0f; break;
+            case DiffType::SPLIT_DIFF:  difflock = 0.5f; break;
+            case DiffType::LOCKED_DIFF: difflock = 1.0f; break;
+            default:                    difflock = -1.0f; // keep cstate
             }
         }
-        else // no axles/diffs avail, mode is split by default
-            cstate = 0.5f;
+        table.SetValue(ANIM_SOURCE_DIFFLOCK, difflock);
+    }
+
+    // rad2deg limitedrange  -1 to +1
+    table.SetValue(ANIM_SOURCE_HEADING, (m_simbuf.simbuf_rotation * 57.29578f) / 360.0f);
+    table.SetValue(ANIM_SOURCE_TORQUE, std::max(m_simbuf.simbuf_engine_crankfactor, 0.0f));
+    table.SetValue(ANIM_SOURCE_PBRAKE, static_cast<float>(m_simbuf.simbuf_parking_brake)); // Bool --> float
+    // speedo ( scales with speedomax )
+    table.SetValue(ANIM_SOURCE_SPEEDO, (m_simbuf.simbuf_wheel_speed / m_simbuf.simbuf_speedo_highest_kph) * 3.0f);
+    // engine tacho ( scales with maxrpm, default is 3500 )
+    table.SetValue(ANIM_SOURCE_TACHO, m_simbuf.simbuf_engine_rpm / m_simbuf.simbuf_engine_max_rpm);
+    const float turbo = m_simbuf.simbuf_engine_turbo_psi * 3.34;
+    table.SetValue(ANIM_SOURCE_TURBO, turbo / 67.0f);
+    table.SetValue(ANIM_SOURCE_BRAKE, m_simbuf.simbuf_brake);
+    // small correction, get acc is nver smaller then 0.06.
+    table.SetValue(ANIM_SOURCE_ACCEL, m_simbuf.simbuf_engine_accel + 0.06f);
+    table.SetValue(ANIM_SOURCE_CLUTCH, fabs(1.0f - m_simbuf.simbuf_clutch));
+
+    //aeroengines rpm + throttle + torque ( turboprop ) + pitch ( turboprop ) + status +  fire
+    const int num_aeroengines = std::min(table.GetNumAeroengines(), static_cast<int>(m_simbuf.simbuf_aeroengines.size()));
+    for (int aenum = 0; aenum < num_aeroengines; aenum++)
+    {
+        AeroEngineSB& aeroengine = m_simbuf.simbuf_aeroengines[aenum];
+
+        float angle;
+        float pcent = aeroengine.simbuf_ae_rpmpc;
+        if (pcent < 60.0)
+            angle = -5.0 + pcent * 1.9167;
+        else if (pcent < 110.0)
+            angle = 110.0 + (pcent - 60.0) * 4.075;
+        else
+            angle = 314.0;
+        table.SetValue(table.GetAeroengineSlot(aenum, ANIM_SOURCE_AE_RPM), angle / 314.0f);
+        table.SetValue(table.GetAeroengineSlot(aenum, ANIM_SOURCE_AE_THROTTLE), aeroengine.simbuf_ae_throttle);
 
-        div++;
+        if (aeroengine.simbuf_ae_type == AeroEngineType::AE_XPROP)
+        {
+            table.SetValue(table.GetAeroengineSlot(aenum, ANIM_SOURCE_AE_TORQUE), aeroengine.simbuf_tp_aetorque / 120.0f);
+            table.SetValue(table.GetAeroengineSlot(aenum, ANIM_SOURCE_AE_PITCH), aeroengine.simbuf_tp_aepitch / 120.0f);
+        }
+
+        float status = (aeroengine.simbuf_ae_ignition) ? 0.5f : 0.0f;
+        if (aeroengine.simbuf_ae_failed)
+            status = 1.0f;
+        table.SetValue(table.GetAeroengineSlot(aenum, ANIM_SOURCE_AE_STATUS), status);
     }
 
-    //heading
-    if (anim.animFlags & PROP_ANIM_FLAG_HEADING)
+    const Ogre::Vector3 node0_pos = this->GetSimNodeBuffer()[0].AbsPosition;
+    const Ogre::Vector3 node0_velo = m_simbuf.simbuf_node0_velo;
+
+    //airspeed indicator
+    if (table.IsSourceUsed(ANIM_SOURCE_AIRSPEED))
     {
-        // rad2deg limitedrange  -1 to +1
-        cstate = (m_simbuf.simbuf_rotation * 57.29578f) / 360.0f;
-        div++;
+        float ground_speed_kt = node0_velo.length() * 1.9438;
+        float altitude = node0_pos.y;
+
+        float sea_level_pressure = 101325; //in Pa
+
+        float airpressure = sea_level_pressure * pow(1.0 - 0.0065 * altitude / 288.15, 5.24947); //in Pa
+        float airdensity = airpressure * 0.0000120896;//1.225 at sea level
+        float kt = ground_speed_kt * sqrt(airdensity / 1.225);
+        table.SetValue(ANIM_SOURCE_AIRSPEED, kt / 100.0f);
     }
 
-    //torque - WRITES 
-    const bool has_engine = (m_actor->ar_engine!= nullptr);
-    if (has_engine && anim.animFlags & PROP_ANIM_FLAG_TORQUE)
+    //vvi indicator
+    float vvi = node0_velo.y * 196.85;
+    // limit vvi scale to +/- 6m/s
+    table.SetValue(ANIM_SOURCE_VVI, vvi / 6000.0f);
+
+    //altimeter indicator 1k oscillating
+    float altimeter = (node0_pos.y * 1.1811) / 360.0f;
+    table.SetValue(ANIM_SOURCE_ALTIMETER_1K, altimeter - int(altimeter));
+
+    //altimeter indicator 10k oscillating
+    float alti_10k = node0_pos.y * 1.1811 / 3600.0f;
+    table.SetValue(ANIM_SOURCE_ALTIMETER_10K, alti_10k - int(alti_10k));
+
+    //altimeter indicator 100k limited
+    float alti_100k = node0_pos.y * 1.1811 / 36000.0f;
+    table.SetValue(ANIM_SOURCE_ALTIMETER_100K, alti_100k);
+
+    //AOA
+    float aoa = m_simbuf.simbuf_wing4_aoa / 25.f;
+    if ((node0_velo.length() * 1.9438) < 10.0f)
+        aoa = 0;
+    table.SetValue(ANIM_SOURCE_AOA, aoa);
+
+    if (table.IsSourceUsed(ANIM_SOURCE_ROLL) || table.IsSourceUsed(ANIM_SOURCE_PITCH))
     {
-        float torque = m_simbuf.simbuf_engine_crankfactor;
-        if (torque <= 0.0f)
-            torque = 0.0f;
-        if (torque >= m_prop_anim_crankfactor_prev)
-            cstate -= torque / 10.0f;
-        else
-            cstate = 0.0f;
+        Ogre::Vector3 cam_pos  = this->GetSimNodeBuffer()[m_actor->ar_main_camera_node_pos ].AbsPosition;
+        Ogre::Vector3 cam_roll = this->GetSimNodeBuffer()[m_actor->ar_main_camera_node_roll].AbsPosition;
+        Ogre::Vector3 cam_dir  = this->GetSimNodeBuffer()[m_actor->ar_main_camera_node_dir ].AbsPosition;
 
-        if (cstate <= -1.0f)
-            cstate = -1.0f;
-        m_prop_anim_crankfactor_prev = torque;
-        div++;
+        // roll
+        Ogre::Vector3 rollv = (cam_pos - cam_roll).normalisedCopy();
+        Ogre::Vector3 dirv = (cam_pos - cam_dir).normalisedCopy();
+        Ogre::Vector3 upv = dirv.crossProduct(-rollv);
+        float rollangle = asin(rollv.dotProduct(Ogre::Vector3::UNIT_Y));
+        // rad to deg
+        rollangle = Ogre::Math::RadiansToDegrees(rollangle);
+        // flip to other side when upside down
+        if (upv.y < 0)
+            rollangle = 180.0f - rollangle;
+        float roll = rollangle / 180.0f;
+        // data output is -0.5 to 1.5, normalize to -1 to +1 without changing the zero position.
+        // this is vital for the animator beams and does not effect the animated props
+        if (roll >= 1.0f)
+            roll = roll - 2.0f;
+        table.SetValue(ANIM_SOURCE_ROLL, roll);
+
+        // pitch
+        float pitchangle = asin(dirv.dotProduct(Ogre::Vector3::UNIT_Y));
+        // radian to degrees with a max cstate of +/- 1.0
+        table.SetValue(ANIM_SOURCE_PITCH, Ogre::Math::RadiansToDegrees(pitchangle) / 90.0f);
     }
 
+    // airbrake
+    table.SetValue(ANIM_SOURCE_AIRBRAKE, static_cast<float>(m_simbuf.simbuf_airbrake_state) / 5.0f);
+    //flaps
+    table.SetValue(ANIM_SOURCE_FLAP, FLAP_ANGLES[m_simbuf.simbuf_aero_flap_state]);
+
+    //land vehicle steering, aileron, elevator, rudder
+    table.SetValue(ANIM_SOURCE_STEERING, m_simbuf.simbuf_hydro_dir_state);
+    table.SetValue(ANIM_SOURCE_AILERONS, m_simbuf.simbuf_hydro_aileron_state);
+    table.SetValue(ANIM_SOURCE_ELEVATORS, m_simbuf.simbuf_hydro_elevator_state);
+    table.SetValue(ANIM_SOURCE_ARUDDER, m_simbuf.simbuf_hydro_aero_rudder_state);
+
+    // key triggered animations - state determined in simulation
+    ROR_ASSERT(table.GetNumKeys() <= (int)m_simbuf.simbuf_prop_anim_keys.size());
+    for (int i = 0; i < table.GetNumKeys(); i++)
+    {
+        table.SetValue(table.GetKeySlot(i), (float)m_simbuf.simbuf_prop_anim_keys[i].simbuf_anim_active);
+    }
+}
+
+float RoR::GfxActor::CalcPropAnimShifter(PropAnim& anim, AnimOpType type, float dt)
+{
     //shifterseq, to amimate sequentiell shifting
-    if (has_engine && (anim.animFlags & PROP_ANIM_FLAG_SHIFTER) && anim.animOpt3 == ShifterPropAnim::SHIFTERSEQ)
+    if (type == AnimOpType::SHIFTER_SEQ)
     {
         float shifterseq_cstate = 0;
         // opt1 &opt2 = 0   this is a shifter
@@ -2475,14 +2584,11 @@ void RoR::GfxActor::CalcPropAnimation(PropAnim& anim, float& cstate, int& div, f
                 if (m_simbuf.simbuf_commandkey[int(anim.upper_limit)].simbuf_cmd_value > 0)
                     shifterseq_cstate = -1.0f;
         }
-
-
-        cstate += UpdateSmoothShift(anim, dt, shifterseq_cstate);
-        div++;
+        return shifterseq_cstate;
     }
 
     //shifterman1, left/right
-    if (has_engine && (anim.animFlags & PROP_ANIM_FLAG_SHIFTER) && anim.animOpt3 == ShifterPropAnim::SHIFTERMAN1)
+    if (type == AnimOpType::SHIFTER_MAN1)
     {
         float shifterman1_cstate = 0.f;
         int shifter = m_simbuf.simbuf_gear;
@@ -2498,13 +2604,11 @@ void RoR::GfxActor::CalcPropAnimation(PropAnim& anim, float& cstate, int& div, f
         {
             shifterman1_cstate = -int((shifter - 1.0) / 2.0);
         }
-
-        cstate += UpdateSmoothShift(anim, dt, shifterman1_cstate);
-        div++;
+        return shifterman1_cstate;
     }
 
     //shifterman2, up/down
-    if (has_engine && (anim.animFlags & PROP_ANIM_FLAG_SHIFTER) && anim.animOpt3 == ShifterPropAnim::SHIFTERMAN2)
+    if (type == AnimOpType::SHIFTER_MAN2)
     {
         float shifterman2_cstate = 0.f;
         int shifter = m_simbuf.simbuf_gear;
@@ -2517,267 +2621,41 @@ void RoR::GfxActor::CalcPropAnimation(PropAnim& anim, float& cstate, int& div, f
         {
             shifterman2_cstate = shifter % 2;
         }
-
-        cstate += UpdateSmoothShift(anim, dt, shifterman2_cstate);
-        div++;
+        return shifterman2_cstate;
     }
 
     //shifterlinear, to amimate cockpit gearselect gauge and autotransmission stick
-    if (has_engine && (anim.animFlags & PROP_ANIM_FLAG_SHIFTER) && anim.animOpt3 == ShifterPropAnim::SHIFTERLIN)
-    {
-        float shifterlin_cstate = 0.f;
-        int shifter = m_simbuf.simbuf_gear;
-        int numgears = m_simbuf.simbuf_num_gears;
-        shifterlin_cstate -= (shifter + 2.0) / (numgears + 2.0);
-
-        cstate += UpdateSmoothShift(anim, dt, shifterlin_cstate);
-        div++;
-    }
-
-    //parking brake
-    if (anim.animFlags & PROP_ANIM_FLAG_PBRAKE)
-    {
-        float pbrake = static_cast<float>(m_simbuf.simbuf_parking_brake); // Bool --> float
-        cstate -= pbrake;
-        div++;
-    }
-
-    //speedo ( scales with speedomax )
-    if (anim.animFlags & PROP_ANIM_FLAG_SPEEDO)
-    {
-        float speedo = m_simbuf.simbuf_wheel_speed / m_simbuf.simbuf_speedo_highest_kph;
-        cstate -= speedo * 3.0f;
-        div++;
-    }
-
-    //engine tacho ( scales with maxrpm, default is 3500 )
-    if (has_engine && anim.animFlags & PROP_ANIM_FLAG_TACHO)
-    {
-        float tacho = m_simbuf.simbuf_engine_rpm / m_simbuf.simbuf_engine_max_rpm;
-        cstate -= tacho;
-        div++;
-    }
-
-    //turbo
-    if (has_engine && anim.animFlags & PROP_ANIM_FLAG_TURBO)
-    {
-        float turbo = m_simbuf.simbuf_engine_turbo_psi * 3.34;
-        cstate -= turbo / 67.0f;
-        div++;
-    }
-
-    //brake
-    if (anim.animFlags & PROP_ANIM_FLAG_BRAKE)
-    {
-        float brakes = m_simbuf.simbuf_brake;
-        cstate -= brakes;
-        div++;
-    }
-
-    //accelerator
-    if (has_engine && anim.animFlags & PROP_ANIM_FLAG_ACCEL)
-    {
-        float accel = m_simbuf.simbuf_engine_accel;
-        cstate -= accel + 0.06f;
-        //( small correction, get acc is nver smaller then 0.06.
-        div++;
-    }
-
-    //clutch
-    if (has_engine && anim.animFlags & PROP_ANIM_FLAG_CLUTCH)
-    {
-        float clutch = m_simbuf.simbuf_clutch;
-        cstate -= fabs(1.0f - clutch);
-        div++;
-    }
-
-    //aeroengines rpm + throttle + torque ( turboprop ) + pitch ( turboprop ) + status +  fire
-    // `anim.animOpt3` is aeroengine number (starting from 1)
-    if (anim.animOpt3 > 0.f && anim.animOpt3 <= float(m_simbuf.simbuf_aeroengines.size()))
-    {
-        const int aenum = int(anim.animOpt3 - 1.f);
-        if (anim.animFlags & PROP_ANIM_FLAG_RPM)
-        {
-            float angle;
-            float pcent = m_simbuf.simbuf_aeroengines[aenum].simbuf_ae_rpmpc;
-            if (pcent < 60.0)
-                angle = -5.0 + pcent * 1.9167;
-            else if (pcent < 110.0)
-                angle = 110.0 + (pcent - 60.0) * 4.075;
-            else
-                angle = 314.0;
-            cstate -= angle / 314.0f;
-            div++;
-        }
-        if (anim.animFlags & PROP_ANIM_FLAG_THROTTLE)
-        {
-            float throttle = m_simbuf.simbuf_aeroengines[aenum].simbuf_ae_throttle;
-            cstate -= throttle;
-            div++;
-        }
-
-        if (m_simbuf.simbuf_aeroengines[aenum].simbuf_ae_type == AeroEngineType::AE_XPROP)
-        {
-            if (anim.animFlags & PROP_ANIM_FLAG_AETORQUE)
-            {
-                cstate = m_simbuf.simbuf_aeroengines[aenum].simbuf_tp_aetorque / 120.0f;
-                div++;
-            }
-
-            if (anim.animFlags & PROP_ANIM_FLAG_AEPITCH)
-            {
-                cstate = m_simbuf.simbuf_aeroengines[aenum].simbuf_tp_aepitch / 120.0f;
-                div++;
-            }
-        }
-
-        if (anim.animFlags & PROP_ANIM_FLAG_AESTATUS)
-        {
-            if (!m_simbuf.simbuf_aeroengines[aenum].simbuf_ae_ignition)
-                cstate = 0.0f;
-            else
-                cstate = 0.5f;
-            if (m_simbuf.simbuf_aeroengines[aenum].simbuf_ae_failed)
-                cstate = 1.0f;
-            div++;
-        }
-    }
-
-    const Ogre::Vector3 node0_pos = this->GetSimNodeBuffer()[0].AbsPosition;
-    const Ogre::Vector3 node0_velo = m_simbuf.simbuf_node0_velo;
-
-    //airspeed indicator
-    if (anim.animFlags & PROP_ANIM_FLAG_AIRSPEED)
-    {
-        float ground_speed_kt = node0_velo.length() * 1.9438;
-        float altitude = node0_pos.y;
-
-        float sea_level_pressure = 101325; //in Pa
-
-        float airpressure = sea_level_pressure * pow(1.0 - 0.0065 * altitude / 288.15, 5.24947); //in Pa
-        float airdensity = airpressure * 0.0000120896;//1.225 at sea level
-        float kt = ground_speed_kt * sqrt(airdensity / 1.225);
-        cstate -= kt / 100.0f;
-        div++;
-    }
-
-    //vvi indicator
-    if (anim.animFlags & PROP_ANIM_FLAG_VVI)
-    {
-        float vvi = node0_velo.y * 196.85;
-        // limit vvi scale to +/- 6m/s
-        cstate -= vvi / 6000.0f;
-        if (cstate >= 1.0f)
-            cstate = 1.0f;
-        if (cstate <= -1.0f)
-            cstate = -1.0f;
-        div++;
-    }
+    float shifterlin_cstate = 0.f;
+    int shifter = m_simbuf.simbuf_gear;
+    int numgears = m_simbuf.simbuf_num_gears;
+    shifterlin_cstate -= (shifter + 2.0) / (numgears + 2.0);
+    return shifterlin_cstate;
+}
 
-    //altimeter
-    if (anim.animFlags & PROP_ANIM_FLAG_ALTIMETER)
+void RoR::GfxActor::CalcPropAnimation(PropAnim& anim, float& cstate, float dt)
+{
+    const int op_end = anim.animProgram.apr_op_begin + anim.animProgram.apr_op_count;
+    for (int i = anim.animProgram.apr_op_begin; i < op_end; i++)
     {
-        //altimeter indicator 1k oscillating
-        if (anim.animOpt3 == 3.0f)
-        {
-            float altimeter = (node0_pos.y * 1.1811) / 360.0f;
-            int alti_int = int(altimeter);
-            float alti_mod = (altimeter - alti_int);
-            cstate -= alti_mod;
-        }
-
-        //altimeter indicator 10k oscillating
-        if (anim.animOpt3 == 2.0f)
+        AnimOp const& op = m_prop_anim_table.GetOp(i);
+        switch (op.aop_type)
         {
-            float alti = node0_pos.y * 1.1811 / 3600.0f;
-            int alti_int = int(alti);
-            float alti_mod = (alti - alti_int);
-            cstate -= alti_mod;
-            if (cstate <= -1.0f)
-                cstate = -1.0f;
-        }
+        case AnimOpType::SHIFTER_SEQ:
+        case AnimOpType::SHIFTER_MAN1:
+        case AnimOpType::SHIFTER_MAN2:
+        case AnimOpType::SHIFTER_LIN:
+            cstate += UpdateSmoothShift(anim, dt, this->CalcPropAnimShifter(anim, op.aop_type, dt));
+            break;
 
-        //altimeter indicator 100k limited
-        if (anim.animOpt3 == 1.0f)
-        {
-            float alti = node0_pos.y * 1.1811 / 36000.0f;
-            cstate -= alti;
-            if (cstate <= -1.0f)
-                cstate = -1.0f;
+        default:
+            m_prop_anim_table.ApplyOp(op, cstate, m_prop_anim_crankfactor_prev);
         }
-        div++;
-    }
-
-    //AOA
-    if (anim.animFlags & PROP_ANIM_FLAG_AOA)
-    {
-        float aoa = m_simbuf.simbuf_wing4_aoa / 25.f;
-        if ((node0_velo.length() * 1.9438) < 10.0f)
-            aoa = 0;
-        cstate -= aoa;
-        if (cstate <= -1.0f)
-            cstate = -1.0f;
-        if (cstate >= 1.0f)
-            cstate = 1.0f;
-        div++;
-    }
-
-    Ogre::Vector3 cam_pos  = this->GetSimNodeBuffer()[m_actor->ar_main_camera_node_pos ].AbsPosition;
-    Ogre::Vector3 cam_roll = this->GetSimNodeBuffer()[m_actor->ar_main_camera_node_roll].AbsPosition;
-    Ogre::Vector3 cam_dir  = this->GetSimNodeBuffer()[m_actor->ar_main_camera_node_dir ].AbsPosition;
-
-    // roll
-    if (anim.animFlags & PROP_ANIM_FLAG_ROLL)
-    {
-        Ogre::Vector3 rollv = (cam_pos - cam_roll).normalisedCopy();
-        Ogre::Vector3 dirv = (cam_pos - cam_dir).normalisedCopy();
-        Ogre::Vector3 upv = dirv.crossProduct(-rollv);
-        float rollangle = asin(rollv.dotProduct(Ogre::Vector3::UNIT_Y));
-        // rad to deg
-        rollangle = Ogre::Math::RadiansToDegrees(rollangle);
-        // flip to other side when upside down
-        if (upv.y < 0)
-            rollangle = 180.0f - rollangle;
-        cstate = rollangle / 180.0f;
-        // data output is -0.5 to 1.5, normalize to -1 to +1 without changing the zero position.
-        // this is vital for the animator beams and does not effect the animated props
-        if (cstate >= 1.0f)
-            cstate = cstate - 2.0f;
-        div++;
-    }
-
-    // pitch
-    if (anim.animFlags & PROP_ANIM_FLAG_PITCH)
-    {
-        Ogre::Vector3 dirv = (cam_pos - cam_dir).normalisedCopy();
-        float pitchangle = asin(dirv.dotProduct(Ogre::Vector3::UNIT_Y));
-        // radian to degrees with a max cstate of +/- 1.0
-        cstate = (Ogre::Math::RadiansToDegrees(pitchangle) / 90.0f);
-        div++;
-    }
-
-    // airbrake
-    if (anim.animFlags & PROP_ANIM_FLAG_AIRBRAKE)
-    {
-        float airbrake = static_cast<float>(m_simbuf.simbuf_airbrake_state);
-        // cstate limited to -1.0f
-        cstate -= airbrake / 5.0f;
-        div++;
-    }
-
-    //flaps
-    if (anim.animFlags & PROP_ANIM_FLAG_FLAP)
-    {
-        float flaps = FLAP_ANGLES[m_simbuf.simbuf_aero_flap_state];
-        // cstate limited to -1.0f
-        cstate = flaps;
-        div++;
     }
 }
 
 void RoR::GfxActor::UpdatePropAnimations(float dt)
 {
-    int prop_anim_key_index = 0;
+    this->UpdatePropAnimSources();
 
     for (Prop& prop: m_props)
     {
@@ -2789,34 +2667,8 @@ void RoR::GfxActor::UpdatePropAnimations(float dt)
         for (PropAnim& anim: prop.pp_animations)
         {
             float cstate = 0.0f;
-            int div = 0.0f;
-
-            this->CalcPropAnimation(anim, cstate, div, dt);
-
-            // key triggered animations - state determined in simulation
-            if (anim.animFlags & ANIM_FLAG_EVENT)
-            {
-                ROR_ASSERT(prop_anim_key_index < (int)m_simbuf.simbuf_prop_anim_keys.size());
-                const bool anim_active = m_simbuf.simbuf_prop_anim_keys[prop_anim_key_index++].simbuf_anim_active;
-                cstate += (float)anim_active;
-            }
 
-            //propanimation placed here to avoid interference with existing hydros(cstate) and permanent prop animation
-            //land vehicle steering
-            if (anim.animFlags & PROP_ANIM_FLAG_STEERING)
-                cstate += m_simbuf.simbuf_hydro_dir_state;
-            //aileron
-            if (anim.animFlags & PROP_ANIM_FLAG_AILERONS)
-                cstate += m_simbuf.simbuf_hydro_aileron_state;
-            //elevator
-            if (anim.animFlags & PROP_ANIM_FLAG_ELEVATORS)
-                cstate += m_simbuf.simbuf_hydro_elevator_state;
-            //rudder
-            if (anim.animFlags & PROP_ANIM_FLAG_ARUDDER)
-                cstate += m_simbuf.simbuf_hydro_aero_rudder_state;
-            //permanent
-            if (anim.animFlags & PROP_ANIM_FLAG_PERMANENT)
-                cstate += 1.0f;
+            this->CalcPropAnimation(anim, cstate, dt);
 
             cstate *= anim.animratio;
 
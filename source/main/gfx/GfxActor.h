@@ -27,6 +27,7 @@
 #pragma once
 
 #include "Actor.h"
+#include "AnimationTable.h"
 #include "AutoPilot.h"
 #include "Differentials.h"
 #include "ForwardDeclarations.h"
@@ -124,6 +125,7 @@ public:
 
     void                 FinishWheelUpdates();
     void                 FinishFlexbodyTasks();
+    void                 FinishCabMeshTask();
 
     // Helpers
 
@@ -145,7 +147,9 @@ public:
     int                  FetchNumNodes() const ;
     int                  FetchNumWheelNodes() const ;
     bool                 HasDriverSeatProp() const { return m_driverseat_prop_index != -1; }
-    void                 CalcPropAnimation(PropAnim& anim, float& cstate, int& div, float dt);
+    void                 UpdatePropAnimSources(); //!< Fills `m_prop_anim_table` from the sim buffers
+    void                 CalcPropAnimation(PropAnim& anim, float& cstate, float dt);
+    float                CalcPropAnimShifter(PropAnim& anim, AnimOpType type, float dt);
     std::vector<Prop>&   getProps() { return m_props; }
     bool                 hasCamera() { return m_videocameras.size() > 0; }
     SurveyMapEntity&     getSurveyMapEntity() { return m_surveymap_entity; }
@@ -169,10 +173,12 @@ private:
     float                       m_prop_anim_crankfactor_prev = 0.f;
     float                       m_prop_anim_shift_timer = 0.f;
     int                         m_prop_anim_prev_gear = 0;
+    AnimationTable              m_prop_anim_table;  //!< Sources of all `PropAnim`s, compiled at spawn
 
     // Threaded tasks
     std::vector<std::shared_ptr<Task>> m_flexwheel_tasks;
     std::vector<std::shared_ptr<Task>> m_flexbody_tasks;
+    std::shared_ptr<Task>              m_cab_mesh_task;
 
     // Elements
     std::vector<NodeGfx>        m_gfx_nodes;
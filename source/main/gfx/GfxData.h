@@ -140,6 +140,7 @@ struct PropAnim
     float        animOpt5     = 0;
     float        lower_limit  = 0;  //!< The lower limit for the animation
     float        upper_limit  = 0;  //!< The upper limit for the animation
+    AnimProgram  animProgram;       //!< Compiled sources, see `GfxActor::m_prop_anim_table`
 
     // Only for SHIFTER
     float        shifterSmooth = 0.f;
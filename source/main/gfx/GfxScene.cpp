@@ -94,6 +94,7 @@ void GfxScene::UpdateScene(float dt_sec)
     {
         gfx_actor->UpdateFlexbodies(); // Push flexbody tasks to threadpool
         gfx_actor->UpdateWheelVisuals(); // Push flexwheel tasks to threadpool
+        gfx_actor->UpdateCabMesh(); // Push cab mesh task to threadpool
     }
 
     // Var
@@ -212,7 +213,6 @@ void GfxScene::UpdateScene(float dt_sec)
         if (gfx_actor->IsActorLive())
         {
             gfx_actor->UpdateRods();
-            gfx_actor->UpdateCabMesh();
             gfx_actor->UpdateWingMeshes();
             gfx_actor->UpdateAirbrakes();
             gfx_actor->UpdateCParticles();
@@ -249,6 +249,7 @@ void GfxScene::UpdateScene(float dt_sec)
     {
         gfx_actor->FinishWheelUpdates();
         gfx_actor->FinishFlexbodyTasks();
+        gfx_actor->FinishCabMeshTask();
     }
 }
 
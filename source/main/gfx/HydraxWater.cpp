@@ -40,7 +40,6 @@ HydraxWater::HydraxWater(float water_height, Ogre::String conf_file):
     waternoise(0)
     , mHydrax(0)
     , waterHeight(water_height)
-    , waveHeight(water_height)
     , CurrentConfigFile(conf_file)
 {
     App::GetCameraManager()->GetCamera()->setNearClipDistance(0.1f);
@@ -127,17 +126,25 @@ void HydraxWater::SetWaterVisible(bool value)
 
 float HydraxWater::CalcWavesHeight(Vector3 pos)
 {
-    if (!RoR::App::gfx_water_waves->getBool())
+    float height = 0.f;
+    this->CalcWavesHeights(&pos, &height, 1);
+    return height;
+}
+
+void HydraxWater::CalcWavesHeights(const Ogre::Vector3* positions, float* heights, size_t count)
+{
+    if (!App::GetGameContext()->GetActorManager()->GetSimSettings().gfx_water_waves)
     {
-        return waterHeight;
+        std::fill(heights, heights + count, waterHeight);
+        return;
     }
-    waveHeight = mHydrax->getHeigth(pos);
-    return waveHeight;
+    // Reads the noise snapshot published by `FrameStepWater()`, so it's safe to call from physics threads.
+    mHydrax->getHeigths(positions, heights, static_cast<int>(count));
 }
 
 Vector3 HydraxWater::CalcWavesVelocity(Vector3 pos)
 {
-    if (!RoR::App::gfx_water_waves->getBool())
+    if (!App::GetGameContext()->GetActorManager()->GetSimSettings().gfx_water_waves)
         return Vector3(0, 0, 0);
 
     return Vector3(0, 0, 0); //TODO
@@ -42,6 +42,7 @@ public:
     float          GetStaticWaterHeight() override;
     void           SetStaticWaterHeight(float value) override;
     float          CalcWavesHeight(Ogre::Vector3 pos) override;
+    void           CalcWavesHeights(const Ogre::Vector3* positions, float* heights, size_t count) override;
     Ogre::Vector3  CalcWavesVelocity(Ogre::Vector3 pos) override;
     void           SetWaterVisible(bool value) override;
     void           WaterSetSunPosition(Ogre::Vector3) override;
@@ -55,7 +56,6 @@ protected:
 
     void InitHydrax();
     Hydrax::Hydrax* mHydrax;
-    float waveHeight;
     float waterHeight;
     Hydrax::Noise::Perlin* waternoise;
     Hydrax::Module::ProjectedGrid* mModule;
@@ -45,6 +45,13 @@ public:
     virtual void           SetWaterBottomHeight(float value) {};
     virtual void           SetWavesHeight(float value) {};
     virtual float          CalcWavesHeight(Ogre::Vector3 pos) = 0;
+    virtual void           CalcWavesHeights(const Ogre::Vector3* positions, float* heights, size_t count) //!< Batched `CalcWavesHeight()`, invoked from physics threads.
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            heights[i] = this->CalcWavesHeight(positions[i]);
+        }
+    }
     virtual Ogre::Vector3  CalcWavesVelocity(Ogre::Vector3 pos) = 0;
     virtual void           SetWaterVisible(bool value) = 0;
     virtual void           WaterSetSunPosition(Ogre::Vector3) {}
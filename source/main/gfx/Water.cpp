@@ -24,6 +24,7 @@
 #include "Actor.h"
 #include "AppContext.h"
 #include "CameraManager.h"
+#include "GameContext.h"
 #include "GfxScene.h"
 #include "PlatformUtils.h" // PathCombine
 #include "Terrain.h"
@@ -518,8 +519,10 @@ void Water::SetWaterBottomHeight(float value)
 
 float Water::CalcWavesHeight(Vector3 pos)
 {
+    SimSettings const& settings = App::GetGameContext()->GetActorManager()->GetSimSettings();
+
     // no waves?
-    if (!RoR::App::gfx_water_waves->getBool() || RoR::App::mp_state->getEnum<MpState>() == RoR::MpState::CONNECTED)
+    if (!settings.gfx_water_waves || settings.mp_state == RoR::MpState::CONNECTED)
     {
         // constant height, sea is flat as pancake
         return m_water_height;
@@ -551,8 +554,9 @@ float Water::CalcWavesHeight(Vector3 pos)
 bool Water::IsUnderWater(Vector3 pos)
 {
     float waterheight = m_water_height;
+    SimSettings const& settings = App::GetGameContext()->GetActorManager()->GetSimSettings();
 
-    if (RoR::App::gfx_water_waves->getBool() && RoR::App::mp_state->getEnum<MpState>() == RoR::MpState::DISABLED)
+    if (settings.gfx_water_waves && settings.mp_state == RoR::MpState::DISABLED)
     {
         float waveheight = GetWaveHeight(pos);
 
@@ -567,7 +571,8 @@ bool Water::IsUnderWater(Vector3 pos)
 
 Vector3 Water::CalcWavesVelocity(Vector3 pos)
 {
-    if (!RoR::App::gfx_water_waves->getBool() || RoR::App::mp_state->getEnum<MpState>() == RoR::MpState::CONNECTED)
+    SimSettings const& settings = App::GetGameContext()->GetActorManager()->GetSimSettings();
+    if (!settings.gfx_water_waves || settings.mp_state == RoR::MpState::CONNECTED)
         return Vector3::ZERO;
 
     float waveheight = GetWaveHeight(pos);
@@ -49,35 +49,22 @@ static const int           DEFAULT_INTERNAL_CAM_PITCH = -15;
 static const float         TRANS_SPEED = 50.f;
 static const float         ROTATE_SPEED = 100.f;
 
-bool intersectsTerrain(Vector3 a, Vector3 b) // internal helper
-{
-    b.y = std::max(b.y, App::GetGameContext()->GetTerrain()->GetHeightAt(b.x, b.z) + 1.0f);
-
-    int steps = std::max(3.0f, a.distance(b) * 2.0f);
-    for (int i = 1; i < steps; i++)
-    {
-        Vector3 pos = a + (b - a) * (float)i / steps;
-        float h = App::GetGameContext()->GetTerrain()->GetHeightAt(pos.x, pos.z);
-        if (h > pos.y)
-        {
-            return true;
-        }
-    }
-    return App::GetGameContext()->GetTerrain()->GetCollisions()->intersectsTris(Ray(a, b - a)).first;
-}
-
 bool intersectsTerrain(Vector3 a, Vector3 start, Vector3 end, float interval) // internal helper
 {
+    // Cast lines of sight from `a` to points between `start` and `end`, all in one batch
     int steps = std::max(3.0f, start.distance(end) * (6.0f / interval));
+    std::vector<Ray> rays;
+    rays.reserve(steps + 1);
     for (int i = 0; i <= steps; i++)
     {
         Vector3 b = start + (end - start) * (float)i / steps;
-        if (intersectsTerrain(a, b))
-        {
-            return true;
-        }
+        b.y = std::max(b.y, App::GetGameContext()->GetTerrain()->GetHeightAt(b.x, b.z) + 1.0f);
+        rays.push_back(Ray(a, b - a));
     }
-    return false;
+
+    std::vector<collision_ray_hit_t> hits(rays.size());
+    App::GetGameContext()->GetTerrain()->GetCollisions()->castRays(rays.data(), hits.data(), rays.size());
+    return std::any_of(hits.begin(), hits.end(), [](const collision_ray_hit_t& hit) { return hit.hit; });
 }
 
 CameraManager::CameraManager() :
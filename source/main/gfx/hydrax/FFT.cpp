@@ -27,8 +27,22 @@ http://www.gnu.org/copyleft/lesser.txt.
 
 #include <Hydrax.h>
 
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <limits>
+
 namespace Hydrax{namespace Noise
 {
+	/// Animation time the dispersion phases are rotated by per step
+	const double FFT_PHASE_STEP = 1.0 / 240.0;
+	/// Larger time steps re-evaluate the phases directly
+	const int FFT_MAX_PHASE_ROTATIONS = 16;
+	/// Rotations before the phases are re-evaluated to get rid of accumulated rounding errors
+	const int FFT_PHASE_RESYNC_ROTATIONS = 4096;
+	/// Rows (or columns) of the transform per thread pool task
+	const int FFT_ROWS_PER_TASK = 32;
+
 	inline float uniform_deviate()
 	{
 		return rand() * ( 1.0f / ( RAND_MAX + 1.0f ) );
@@ -41,9 +55,11 @@ namespace Hydrax{namespace Noise
 		, img(0)
 		, maximalValue(2)
 		, initialWaves(0)
-		, currentWaves(0)
-		, angularFrequencies(0)
 		, time(10)
+		, mPhaseTime(0)
+		, mPhaseRotations(0)
+		, mMinValue(0)
+		, mMaxValue(0)
 		, mGPUNormalMapManager(0)
 	{
 	}
@@ -56,9 +72,11 @@ namespace Hydrax{namespace Noise
 		, img(0)
 		, maximalValue(2)
 		, initialWaves(0)
-		, currentWaves(0)
-		, angularFrequencies(0)
 		, time(10)
+		, mPhaseTime(0)
+		, mPhaseRotations(0)
+		, mMinValue(0)
+		, mMaxValue(0)
 		, mGPUNormalMapManager(0)
 	{
 	}
@@ -94,10 +112,6 @@ namespace Hydrax{namespace Noise
 			return;
 		}
 
-        if (currentWaves)
-		{
-			delete [] currentWaves;
-		}
 		if (re)
 		{
 			delete [] re;
@@ -111,13 +125,16 @@ namespace Hydrax{namespace Noise
 			delete [] initialWaves;
 		}
 
-	    if (angularFrequencies)
-		{
-			delete [] angularFrequencies;
-		}
+		mBitReverse.clear();
+		mTwiddles.clear();
+		mFrequencyIndex.clear();
+		mAngularFrequencies.clear();
+		mPhases.clear();
+		mPhaseSteps.clear();
 
 		maximalValue = 2;
 		time = 10;
+		mSnapshot.clear();
 
 		Noise::remove();
 	}
@@ -432,20 +449,58 @@ namespace Hydrax{namespace Noise
 
 	void FFT::_initNoise()
 	{
+		// The transform only works on power of two sizes
+		int log2Resolution = 0;
+		while ((1 << log2Resolution) < resolution)
+		{
+			log2Resolution++;
+		}
+		if ((1 << log2Resolution) != resolution)
+		{
+			HydraxLOG("FFT resolution " + Ogre::StringConverter::toString(resolution) + " is not a power of two, using " +
+				Ogre::StringConverter::toString(1 << log2Resolution) + ".");
+			resolution = 1 << log2Resolution;
+		}
+
 		initialWaves = new std::complex<float>[resolution*resolution];
-		currentWaves = new std::complex<float>[resolution*resolution];
-		angularFrequencies = new float[resolution*resolution];
 
 		re  = new float[resolution*resolution];
 		img = new float[resolution*resolution];
 
+		// Transform plan: bit reversal permutation and twiddle factors exp(2*pi*i*k/resolution)
+		mBitReverse.resize(resolution);
+		for (int i = 0; i < resolution; i++)
+		{
+			int reversed = 0;
+			for (int b = 0; b < log2Resolution; b++)
+			{
+				if (i & (1 << b))
+				{
+					reversed |= 1 << (log2Resolution - 1 - b);
+				}
+			}
+			mBitReverse[i] = reversed;
+		}
+
+		mTwiddles.resize(resolution/2);
+		for (int k = 0; k < resolution/2; k++)
+		{
+			const double angle = 2.0 * Ogre::Math::PI * k / resolution;
+			mTwiddles[k] = std::complex<float>(static_cast<float>(cos(angle)), static_cast<float>(sin(angle)));
+		}
+
+		// The angular frequency only depends on the length of the wave vector, so bins with the
+		// same squared length share one entry of the dispersion tables.
+		std::vector<int> frequencyOfLength(resolution*resolution/2 + 1, -1);
+		mFrequencyIndex.resize(resolution*resolution);
+		mAngularFrequencies.clear();
+
 		Ogre::Vector2 wave = Ogre::Vector2(0,0);
 
 		std::complex<float>* pInitialWavesData = initialWaves;
-		float* pAngularFrequenciesData = angularFrequencies;
 
-		float u, v,
-		      temp;
+		int u, v;
+		float temp;
 
 		for (u = 0; u < resolution; u++)
 		{
@@ -458,49 +513,88 @@ namespace Hydrax{namespace Noise
 				temp = Ogre::Math::Sqrt(0.5f * _getPhillipsSpectrum(wave, mOptions.WindDirection, mOptions.KwPower));
 				*pInitialWavesData++ = std::complex<float>(_getGaussianRandomFloat() * temp, _getGaussianRandomFloat() * temp);
 
-				temp=9.81f * wave.length();
-				*pAngularFrequenciesData++ = Ogre::Math::Sqrt(temp);
+				const int a = u - resolution/2,
+				          b = v - resolution/2;
+				int &frequency = frequencyOfLength[a*a + b*b];
+				if (frequency < 0)
+				{
+					frequency = static_cast<int>(mAngularFrequencies.size());
+					temp = 9.81f * wave.length();
+					mAngularFrequencies.push_back(Ogre::Math::Sqrt(temp));
+				}
+				mFrequencyIndex[u*resolution + v] = frequency;
 			}
 		}
 
+		mPhaseSteps.resize(mAngularFrequencies.size());
+		for (size_t i = 0; i < mAngularFrequencies.size(); i++)
+		{
+			const double angle = mAngularFrequencies[i] * FFT_PHASE_STEP;
+			mPhaseSteps[i] = std::complex<float>(static_cast<float>(cos(angle)), static_cast<float>(sin(angle)));
+		}
+		_resetPhases();
+
 		_calculeNoise(0);
 	}
 
-	void FFT::_calculeNoise(const float &delta)
+	void FFT::_resetPhases()
 	{
-		time += delta*mOptions.AnimationSpeed;
+		mPhases.resize(mAngularFrequencies.size());
+		for (size_t i = 0; i < mAngularFrequencies.size(); i++)
+		{
+			const double angle = fmod(mAngularFrequencies[i] * time, 2.0 * Ogre::Math::PI);
+			mPhases[i] = std::complex<float>(static_cast<float>(cos(angle)), static_cast<float>(sin(angle)));
+		}
 
-		std::complex<float>* pData = currentWaves;
+		mPhaseTime = time;
+		mPhaseRotations = 0;
+	}
 
-		int u, v;
+	void FFT::_advancePhases()
+	{
+		const int steps = static_cast<int>((time - mPhaseTime) / FFT_PHASE_STEP);
 
-		float wt,
-			  coswt, sinwt,
-			  realVal, imagVal;
+		// Big jumps (or going back in time) are cheaper to evaluate directly, and the rotated
+		// phases are periodically re-synchronized so float rounding doesn't accumulate
+		if (steps < 0 || steps > FFT_MAX_PHASE_ROTATIONS || mPhaseRotations + steps > FFT_PHASE_RESYNC_ROTATIONS)
+		{
+			_resetPhases();
+			return;
+		}
 
-		for (u = 0; u < resolution; u++)
+		for (size_t i = 0; i < mPhases.size(); i++)
 		{
-			for (v = 0; v< resolution ; v++)
-			{
-				const std::complex<float>& positive_h0 = initialWaves[u * (resolution)+v];
-				const std::complex<float>& negative_h0 = initialWaves[(resolution-1 - u) * (resolution) + (resolution-1- v)];
+			float pr = mPhases[i].real(), pi = mPhases[i].imag();
+			const float sr = mPhaseSteps[i].real(), si = mPhaseSteps[i].imag();
 
-				wt = angularFrequencies[u * (resolution) + v] * time;
+			for (int n = 0; n < steps; n++)
+			{
+				const float r = pr * sr - pi * si;
+				pi = pr * si + pi * sr;
+				pr = r;
+			}
 
-				coswt = Ogre::Math::Cos(wt);
-				sinwt = Ogre::Math::Sin(wt);
+			mPhases[i] = std::complex<float>(pr, pi);
+		}
 
-				realVal =
-					positive_h0.real() * coswt - positive_h0.imag() * sinwt + negative_h0.real() * coswt - (-negative_h0.imag()) * (-sinwt),
-				imagVal =
-					positive_h0.real() * sinwt + positive_h0.imag() * coswt + negative_h0.real() * (-sinwt) + (-negative_h0.imag()) * coswt;
+		mPhaseTime += steps * FFT_PHASE_STEP;
+		mPhaseRotations += steps;
+	}
 
-				*pData++ = std::complex<float>(realVal, imagVal);
-			}
-		}
+	void FFT::_calculeNoise(const float &delta)
+	{
+		time += delta*mOptions.AnimationSpeed;
 
+		_advancePhases();
 		_executeInverseFFT();
 		_normalizeFFTData(0);
+
+		// Publish the height snapshot
+		HeigthSnapshot &Data = mSnapshot.getBackBuffer();
+		Data.Values.assign(re, re + resolution*resolution);
+		Data.Resolution = resolution;
+		Data.Scale = mOptions.Scale;
+		mSnapshot.publish();
 	}
 
 	const float FFT::_getGaussianRandomFloat() const
@@ -546,167 +640,130 @@ namespace Hydrax{namespace Noise
 
 	void FFT::_executeInverseFFT()
 	{
-		int l2n = 0, p = 1;
-		while (p < resolution)
-		{
-			p *= 2; l2n++;
-		}
-		int l2m = 0; p = 1;
-		while (p < resolution)
+		std::vector<std::function<void()>> tasks;
+
+		for (int begin = 0; begin < resolution; begin += FFT_ROWS_PER_TASK)
 		{
-			p *= 2; l2m++;
+			const int end = std::min(begin + FFT_ROWS_PER_TASK, resolution);
+			tasks.push_back([this, begin, end]() { _transformRows(begin, end); });
 		}
+		RoR::App::GetThreadPool()->Parallelize(tasks);
 
-		resolution = 1<<l2m;
-		resolution = 1<<l2n;
-
-		int x, y, i;
+		// Columns are split into blocks, each task reports the value range of its block
+		tasks.clear();
+		std::vector<float> minValues, maxValues;
+		minValues.resize((resolution + FFT_ROWS_PER_TASK - 1) / FFT_ROWS_PER_TASK);
+		maxValues.resize(minValues.size());
 
-		for(x = 0; x <resolution; x++)
+		for (int begin = 0; begin < resolution; begin += FFT_ROWS_PER_TASK)
 		{
-			for(y = 0; y <resolution; y++)
-			{
-				re[resolution * x + y] = currentWaves[resolution * x + y].real();
-				img[resolution * x + y] = currentWaves[resolution * x + y].imag();
-			}
+			const int end = std::min(begin + FFT_ROWS_PER_TASK, resolution);
+			float *minValue = &minValues[begin / FFT_ROWS_PER_TASK],
+			      *maxValue = &maxValues[begin / FFT_ROWS_PER_TASK];
+			tasks.push_back([this, begin, end, minValue, maxValue]() { _transformColumns(begin, end, *minValue, *maxValue); });
 		}
+		RoR::App::GetThreadPool()->Parallelize(tasks);
 
-		//Bit reversal of each row
-		int j, k;
-		for(y = 0; y < resolution; y++) //for each row
-		{
-			j = 0;
-			for(i = 0; i < resolution - 1; i++)
-			{
-				re[resolution * i + y] = currentWaves[resolution * j + y].real();
-				img[resolution * i + y] = currentWaves[resolution * j + y].imag();
+		mMinValue = *std::min_element(minValues.begin(), minValues.end());
+		mMaxValue = *std::max_element(maxValues.begin(), maxValues.end());
+	}
 
-				k = resolution / 2;
-				while (k <= j)
-				{
-					j -= k;
-					k/= 2;
-				}
+	void FFT::_transformRows(const int &begin, const int &end)
+	{
+		for (int x = begin; x < end; x++)
+		{
+			float *rowRe  = re  + x*resolution,
+			      *rowImg = img + x*resolution;
 
-				j += k;
-			}
-		}
+			// Evaluate the spectrum at the current time, h0(k)*exp(iwt) + conj(h0(-k))*exp(-iwt),
+			// reading the bins in bit reversed order
+			const int u = mBitReverse[x];
 
-		//Bit reversal of each column
-		float tx = 0, ty = 0;
-		for(x = 0; x < resolution; x++) //for each column
-		{
-			j = 0;
-			for(i = 0; i < resolution - 1; i++)
+			for (int y = 0; y < resolution; y++)
 			{
-				if(i < j)
-				{
-					tx = re[resolution * x + i];
-					ty = img[resolution * x + i];
-					re[resolution * x + i] = re[resolution * x + j];
-					img[resolution * x + i] = img[resolution * x + j];
-					re[resolution * x + j] = tx;
-					img[resolution * x + j] = ty;
-				}
-				k = resolution / 2;
-				while (k <= j)
-				{
-					j -= k;
-					k/= 2;
-				}
-				j += k;
-			}
-		}
+				const int v = mBitReverse[y];
 
-		//Calculate the FFT of the columns
-		float ca, sa,
-			  u1, u2,
-			  t1, t2,
-			  z;
+				const std::complex<float>& positive_h0 = initialWaves[u * resolution + v];
+				const std::complex<float>& negative_h0 = initialWaves[(resolution-1 - u) * resolution + (resolution-1 - v)];
+				const std::complex<float>& phase = mPhases[mFrequencyIndex[u * resolution + v]];
 
-		int l1, l2,
-			l,  i1;
-
-		for(x = 0; x < resolution; x++) //for each column
-		{
-			//This is the 1D FFT:
-			ca = -1.0;
-			sa = 0.0;
-			l1 = 1, l2 = 1;
+				rowRe[y]  = (positive_h0.real() + negative_h0.real()) * phase.real() - (positive_h0.imag() + negative_h0.imag()) * phase.imag();
+				rowImg[y] = (positive_h0.real() - negative_h0.real()) * phase.imag() + (positive_h0.imag() - negative_h0.imag()) * phase.real();
+			}
 
-			for(l=0;l<l2n;l++)
+			// 1D inverse FFT of the row
+			for (int half = 1; half < resolution; half *= 2)
 			{
-				l1 = l2;
-				l2 *= 2;
-				u1 = 1.0;
-				u2 = 0.0;
-				for(j = 0; j < l1; j++)
+				const int twiddleStride = resolution / (2*half);
+
+				for (int j = 0; j < half; j++)
 				{
-					for(i = j; i < resolution; i += l2)
+					const float wr = mTwiddles[j * twiddleStride].real(),
+					            wi = mTwiddles[j * twiddleStride].imag();
+
+					for (int i = j; i < resolution; i += 2*half)
 					{
-						i1 = i + l1;
-						t1 = u1 * re[resolution * x + i1] - u2 * img[resolution * x + i1];
-						t2 = u1 * img[resolution * x + i1] + u2 * re[resolution * x + i1];
-						re[resolution * x + i1] = re[resolution * x + i] - t1;
-						img[resolution * x + i1] = img[resolution * x + i] - t2;
-						re[resolution * x + i] += t1;
-						img[resolution * x + i] += t2;
+						const int i1 = i + half;
+						const float t1 = wr * rowRe[i1] - wi * rowImg[i1],
+						            t2 = wr * rowImg[i1] + wi * rowRe[i1];
+						rowRe[i1]  = rowRe[i] - t1;
+						rowImg[i1] = rowImg[i] - t2;
+						rowRe[i]  += t1;
+						rowImg[i] += t2;
 					}
-					z =  u1 * ca - u2 * sa;
-					u2 = u1 * sa + u2 * ca;
-					u1 = z;
 				}
-				sa = Ogre::Math::Sqrt((1.0f - ca) / 2.0f);
-				ca = Ogre::Math::Sqrt((1.0f+ca) / 2.0f);
 			}
 		}
-		//Calculate the FFT of the rows
-		for(y = 0; y < resolution; y++) //for each row
+	}
+
+	void FFT::_transformColumns(const int &begin, const int &end, float &minValue, float &maxValue)
+	{
+		// 1D inverse FFT of the columns [begin, end), the butterflies run along the rows so the
+		// inner loop walks contiguous memory
+		for (int half = 1; half < resolution; half *= 2)
 		{
-			//This is the 1D FFT:
-			ca = -1.0;
-			sa = 0.0;
-			l1= 1, l2 = 1;
+			const int twiddleStride = resolution / (2*half);
 
-			for(l = 0; l < l2m; l++)
+			for (int j = 0; j < half; j++)
 			{
-				l1 = l2;
-				l2 *= 2;
-				u1 = 1.0;
-				u2 = 0.0;
-				for(j = 0; j < l1; j++)
+				const float wr = mTwiddles[j * twiddleStride].real(),
+				            wi = mTwiddles[j * twiddleStride].imag();
+
+				for (int i = j; i < resolution; i += 2*half)
 				{
-					for(i = j; i < resolution; i += l2)
+					float *re0  = re  + i*resolution,          *img0 = img + i*resolution,
+					      *re1  = re  + (i + half)*resolution, *img1 = img + (i + half)*resolution;
+
+					for (int y = begin; y < end; y++)
 					{
-						i1 = i + l1;
-					    t1 = u1 * re[resolution * i1 + y] - u2 * img[resolution * i1 + y];
-						t2 = u1 * img[resolution * i1 + y] + u2 * re[resolution* i1 + y];
-						re[resolution * i1 + y] = re[resolution * i + y] - t1;
-						img[resolution * i1 + y] = img[resolution * i + y] - t2;
-						re[resolution * i + y] += t1;
-						img[resolution * i + y] += t2;
+						const float t1 = wr * re1[y] - wi * img1[y],
+						            t2 = wr * img1[y] + wi * re1[y];
+						re1[y]  = re0[y] - t1;
+						img1[y] = img0[y] - t2;
+						re0[y]  += t1;
+						img0[y] += t2;
 					}
-					z =  u1 * ca - u2 * sa;
-					u2 = u1 * sa + u2 * ca;
-					u1 = z;
 				}
-				sa = Ogre::Math::Sqrt((1.0f - ca) / 2.0f);
-				ca = Ogre::Math::Sqrt((1.0f+ca) / 2.0f);
 			}
 		}
 
-		for(x=0;x<resolution;x++)
+		// Undo the shift of the spectrum origin to the center and gather the data range
+		minValue = std::numeric_limits<float>::max();
+		maxValue = -std::numeric_limits<float>::max();
+
+		for (int x = 0; x < resolution; x++)
 		{
-			for(y=0;y<resolution;y++)
+			float *rowRe = re + x*resolution;
+
+			for (int y = begin; y < end; y++)
 			{
-				if (((x+y) & 0x1)==1)
-				{
-					re[x*resolution+y]*=1;
-				}
-				else
+				if (((x+y) & 0x1) == 0)
 				{
-					re[x*resolution+y]*=-1;
+					rowRe[y] = -rowRe[y];
 				}
+
+				minValue = std::min(minValue, rowRe[y]);
+				maxValue = std::max(maxValue, rowRe[y]);
 			}
 		}
 	}
@@ -714,24 +771,11 @@ namespace Hydrax{namespace Noise
 	void FFT::_normalizeFFTData(const float& scale)
 	{
 		float scaleCoef = 0.000001f;
-		int i;
 
-		// Perform automatic detection of maximum value
+		// Perform automatic detection of maximum value, the range was gathered by _executeInverseFFT()
 		if (scale == 0.0f)
 		{
-			float min=re[0], max=re[0],
-				  currentMax=maximalValue;;
-
-			for(i=1;i<resolution*resolution;i++)
-			{
-				if (min>re[i]) min=re[i];
-				if (max<re[i]) max=re[i];
-			}
-
-			min=Ogre::Math::Abs(min);
-			max=Ogre::Math::Abs(max);
-
-			currentMax = (min>max) ? min : max;
+			const float currentMax = std::max(Ogre::Math::Abs(mMinValue), Ogre::Math::Abs(mMaxValue));
 
 			if (currentMax>maximalValue) maximalValue=currentMax;
 
@@ -743,22 +787,48 @@ namespace Hydrax{namespace Noise
 		}
 
 		// Scale all the value, and clamp to [0,1] range
-		int x, y;
-		for(x=0;x<resolution;x++)
+		std::vector<std::function<void()>> tasks;
+
+		for (int begin = 0; begin < resolution; begin += FFT_ROWS_PER_TASK)
 		{
-			for(y=0;y<resolution;y++)
+			const int end = std::min(begin + FFT_ROWS_PER_TASK, resolution);
+			tasks.push_back([this, begin, end, scaleCoef]()
 			{
-				i=x*resolution+y;
-				re[i]=(re[i]+scaleCoef)/(scaleCoef*2);
-			}
+				for (int i = begin*resolution; i < end*resolution; i++)
+				{
+					re[i]=(re[i]+scaleCoef)/(scaleCoef*2);
+				}
+			});
 		}
+		RoR::App::GetThreadPool()->Parallelize(tasks);
 	}
 
 	float FFT::getValue(const float &x, const float &y)
+	{
+		return _getValue(re, resolution, mOptions.Scale, x, y);
+	}
+
+	void FFT::getValues(const Ogre::Vector2 *Positions, float *Values, const int &Count)
+	{
+		const std::shared_ptr<const HeigthSnapshot> Data = mSnapshot.acquire();
+
+		if (!Data)
+		{
+			std::fill(Values, Values + Count, 0.0f);
+			return;
+		}
+
+		for (int i = 0; i < Count; i++)
+		{
+			Values[i] = _getValue(&Data->Values[0], Data->Resolution, Data->Scale, Positions[i].x, Positions[i].y);
+		}
+	}
+
+	float FFT::_getValue(const float *re, const int &resolution, const float &Scale, const float &x, const float &y)
 	{
 		// Scale world coords
-		float xScale = x*mOptions.Scale,
-		      yScale = y*mOptions.Scale;
+		float xScale = x*Scale,
+		      yScale = y*Scale;
 
 		// Convert coords from world-space to data-space
         int xs = static_cast<int>(xScale)%resolution,
@@ -30,6 +30,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "Noise.h"
 
 #include <complex>
+#include <vector>
 
 /// @addtogroup Gfx
 /// @{
@@ -202,6 +203,13 @@ namespace Hydrax{ namespace Noise
 		 */
 		float getValue(const float &x, const float &y);
 
+		/** Get the especified x/y noise values from the state of the last update(), thread safe
+		    @param Positions X/Y Coords
+			@param Values Noise values (output)
+			@param Count Number of values
+		 */
+		void getValues(const Ogre::Vector2 *Positions, float *Values, const int &Count);
+
 		/** Set/Update fft noise options
 		    @param Options FFT noise options
 		 */
@@ -225,10 +233,32 @@ namespace Hydrax{ namespace Noise
 		 */
 		void _calculeNoise(const float &delta);
 
-		/** Execute inverse fast fourier transform
+		/** Re-evaluate the dispersion phases at the current time
+		 */
+		void _resetPhases();
+
+		/** Advance the dispersion phases to the current time by rotation
+		 */
+		void _advancePhases();
+
+		/** Execute inverse fast fourier transform, rows and columns are split across the thread pool
 		 */
 		void _executeInverseFFT();
 
+		/** Evaluate the spectrum at the current time and transform rows [begin, end)
+		    @param begin First row
+			@param end End row (exclusive)
+		 */
+		void _transformRows(const int &begin, const int &end);
+
+		/** Transform columns [begin, end) and gather their value range
+		    @param begin First column
+			@param end End column (exclusive)
+			@param minValue Minimal value of the columns
+			@param maxValue Maximal value of the columns
+		 */
+		void _transformColumns(const int &begin, const int &end, float &minValue, float &maxValue);
+
 		/** Normalize fft data
 		    @param scale User defined scale
 		 */
@@ -251,6 +281,16 @@ namespace Hydrax{ namespace Noise
 		 */
 		void _updateGPUNormalMapResources();
 
+		/** Interpolate the noise value at the especified x/y coords
+		    @param re Normalized fft data
+			@param resolution FFT resolution
+			@param Scale Noise scale
+		    @param x X Coord
+			@param y Y Coord
+			@return Noise value
+		 */
+		static float _getValue(const float *re, const int &resolution, const float &Scale, const float &x, const float &y);
+
 		/// FFT resolution
 		int resolution;
 		/// Pointers to resolution*resolution float size arrays
@@ -260,12 +300,42 @@ namespace Hydrax{ namespace Noise
 
 		/// the data which is referred as h0{x,t), that is, the data of the simulation at the time 0.
 	    std::complex<float> *initialWaves;
-	    /// the data of the simulation at time t, which is formed using the data at time 0 and the angular frequencies at time t
-	    std::complex<float> *currentWaves;
-	    /// the angular frequencies
-	    float  *angularFrequencies;
 		/// Current time
-		float time;
+		double time;
+
+		/// Bit reversal permutation of [0, resolution)
+		std::vector<int> mBitReverse;
+		/// Twiddle factors exp(2*pi*i*k/resolution), k in [0, resolution/2)
+		std::vector<std::complex<float> > mTwiddles;
+		/// Index of each bin in the dispersion tables (bins with the same wave vector length share an entry)
+		std::vector<int> mFrequencyIndex;
+		/// The angular frequencies
+		std::vector<float> mAngularFrequencies;
+		/// exp(i*w*t) of each angular frequency, at mPhaseTime
+		std::vector<std::complex<float> > mPhases;
+		/// exp(i*w*step) of each angular frequency, the rotation applied per phase step
+		std::vector<std::complex<float> > mPhaseSteps;
+		/// Time the phases were advanced to, lags the current time by less than one step
+		double mPhaseTime;
+		/// Rotations since the phases were last re-evaluated
+		int mPhaseRotations;
+		/// Value range of the last transform
+		float mMinValue, mMaxValue;
+
+		/** Immutable copy of the normalized fft data, read by getValues()
+		 */
+		struct HeigthSnapshot
+		{
+			/// resolution*resolution values
+			std::vector<float> Values;
+			/// FFT resolution
+			int Resolution;
+			/// Noise scale
+			float Scale;
+		};
+
+		/// Height snapshot, published each update()
+		Snapshot<HeigthSnapshot> mSnapshot;
 
 		/// GPUNormalMapManager pointer
 		GPUNormalMapManager *mGPUNormalMapManager;
@@ -446,6 +446,23 @@ namespace Hydrax
 			return getHeigth(Ogre::Vector2(Position.x, Position.z));
 		}
 
+		/** Get the current heigths at the especified world-space points
+		    @param Positions X/(Y)/Z World positions
+			@param Heigths Heigths at the given positions in y-World coordinates, -1 if outside of the water (output)
+			@param Count Number of positions
+			@remarks Reads the noise state of the last update(), safe to call from any thread (see Module::getHeigths())
+		 */
+		inline void getHeigths(const Ogre::Vector3 *Positions, float *Heigths, const int &Count)
+		{
+			if (mModule)
+			{
+				mModule->getHeigths(Positions, Heigths, Count);
+				return;
+			}
+
+			std::fill(Heigths, Heigths + Count, -1.0f);
+		}
+
         /** Get full reflection distance
             @return Hydrax water full reflection distance
          */
@@ -297,12 +297,16 @@ namespace Hydrax
 		return true;
 	}
 
-	bool Mesh::isPointInGrid(const Ogre::Vector2 &Position)
+	Mesh::GridCorners Mesh::getGridCorners()
 	{
+		GridCorners Grid;
+
+		Grid.Unbounded = (mOptions.MeshSize.Width == 0 && mOptions.MeshSize.Height == 0);
+
 		Ogre::AxisAlignedBox WordMeshBox = mEntity->getWorldBoundingBox();
 
 		// Get our mesh grid rectangle:
-		// c-----------d
+		// d-----------c
 		// |           |
 		// |           |
 		// |           |
@@ -313,12 +317,23 @@ namespace Hydrax
 			c = WordMeshBox.getCorner(Ogre::AxisAlignedBox::NEAR_RIGHT_BOTTOM),
 			d = WordMeshBox.getCorner(Ogre::AxisAlignedBox::NEAR_LEFT_BOTTOM);
 
-		// Transform all corners to Ogre::Vector2 array
-		Ogre::Vector2 Corners2D[4] =
-		   {Ogre::Vector2(a.x, a.z),
-		    Ogre::Vector2(b.x, b.z),
-		    Ogre::Vector2(c.x, c.z),
-		    Ogre::Vector2(d.x, d.z)};
+		// Transform all corners to Ogre::Vector2
+		Grid.Corners[0] = Ogre::Vector2(a.x, a.z);
+		Grid.Corners[1] = Ogre::Vector2(b.x, b.z);
+		Grid.Corners[2] = Ogre::Vector2(c.x, c.z);
+		Grid.Corners[3] = Ogre::Vector2(d.x, d.z);
+
+		return Grid;
+	}
+
+	bool Mesh::isPointInGrid(const Ogre::Vector2 &Position)
+	{
+		return isPointInGrid(Position, getGridCorners());
+	}
+
+	bool Mesh::isPointInGrid(const Ogre::Vector2 &Position, const GridCorners &Grid)
+	{
+		const Ogre::Vector2 *Corners2D = Grid.Corners;
 
 		// Determinate if Position is into our rectangle, we use a line intersection detection
 		// because our mesh rectangle can be rotated, if the number of collisions with the four
@@ -357,51 +372,52 @@ namespace Hydrax
 			return Position;
 		}
 
-		if (!isPointInGrid(Position))
+		return getGridPosition(Position, getGridCorners());
+	}
+
+	Ogre::Vector2 Mesh::getGridPosition(const Ogre::Vector2 &Position, const GridCorners &Grid)
+	{
+		if (Grid.Unbounded)
+		{
+			return Position;
+		}
+
+		if (!isPointInGrid(Position, Grid))
 		{
 			return Ogre::Vector2(-1,-1);
 		}
 
-		Ogre::AxisAlignedBox WordMeshBox = mEntity->getWorldBoundingBox();
-
-		// Get our mesh grid rectangle: (Only a,b,c corners)
-		// c
+		// Only a, b and d corners are needed
+		// d
 		// |
 		// |
 		// |
 		// a-----------b
-		Ogre::Vector3
-			a = WordMeshBox.getCorner(Ogre::AxisAlignedBox::FAR_LEFT_BOTTOM),
-			b = WordMeshBox.getCorner(Ogre::AxisAlignedBox::FAR_RIGHT_BOTTOM),
-			c = WordMeshBox.getCorner(Ogre::AxisAlignedBox::NEAR_LEFT_BOTTOM);
-
-		// Transform all corners to Ogre::Vector2 array
-		Ogre::Vector2 Corners2D[3] =
-		   {Ogre::Vector2(a.x, a.z),
-		    Ogre::Vector2(b.x, b.z),
-		    Ogre::Vector2(c.x, c.z)};
+		const Ogre::Vector2 &a = Grid.Corners[0],
+			                &b = Grid.Corners[1],
+			                &d = Grid.Corners[3];
 
-		// Get segments AB and AC
-		Ogre::Vector2 AB = Corners2D[1]-Corners2D[0],
-			          AC = Corners2D[2]-Corners2D[0];
+		// Get segments AB and AD
+		Ogre::Vector2 AB = b-a,
+			          AD = d-a;
 
-		// Find the X/Y position projecting the Position point to AB and AC segments.
-		Ogre::Vector2 XProjectedPoint = Position-AC,
+		// Find the X/Y position projecting the Position point to AB and AD segments.
+		Ogre::Vector2 XProjectedPoint = Position-AD,
 			          YProjectedPoint = Position-AB;
 
 		// Fint the intersections points
-		Ogre::Vector2 XPoint = Math::intersectionOfTwoLines(Corners2D[0],Corners2D[1],Position,XProjectedPoint),
-			          YPoint = Math::intersectionOfTwoLines(Corners2D[0],Corners2D[2],Position,YProjectedPoint);
+		Ogre::Vector2 XPoint = Math::intersectionOfTwoLines(a,b,Position,XProjectedPoint),
+			          YPoint = Math::intersectionOfTwoLines(a,d,Position,YProjectedPoint);
 
 		// Find lengths
 		Ogre::Real ABLength = AB.length(),
-			       ACLength = AC.length(),
-				   XLength  = (XPoint-Corners2D[0]).length(),
-				   YLength  = (YPoint-Corners2D[0]).length();
+			       ADLength = AD.length(),
+				   XLength  = (XPoint-a).length(),
+				   YLength  = (YPoint-a).length();
 
 		// Find final x/y grid positions in [0,1] range
 		Ogre::Real XFinal = XLength / ABLength,
-			       YFinal = YLength / ACLength;
+			       YFinal = YLength / ADLength;
 
 		return Ogre::Vector2(XFinal,YFinal);
 	}
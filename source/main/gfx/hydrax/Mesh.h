@@ -78,6 +78,16 @@ namespace Hydrax
 			float x,y,z;
 		};
 
+		/** World-space grid rectangle, as used by isPointInGrid() and getGridPosition()
+		 */
+		struct GridCorners
+		{
+			/// a, b, c, d x/z corners, a-b is the far edge and d-c the near one
+			Ogre::Vector2 Corners[4];
+			/// Mesh size is zero, grid positions are the world positions
+			bool Unbounded;
+		};
+
 		/** Mesh vertex type enum
 		 */
 		enum VertexType
@@ -187,6 +197,25 @@ namespace Hydrax
 		 */
 		Ogre::Vector2 getGridPosition(const Ogre::Vector2 &Position);
 
+		/** Get the current world-space grid rectangle, main thread only
+		    @return Grid corners, to be used with the static isPointInGrid()/getGridPosition() from any thread
+		 */
+		GridCorners getGridCorners();
+
+		/** Get if a Position point is inside of the given grid
+		    @param Position World-space point
+			@param Grid Grid corners
+			@return true if Position point is inside of the grid, else false.
+		 */
+		static bool isPointInGrid(const Ogre::Vector2 &Position, const GridCorners &Grid);
+
+		/** Get the [0,1] range x/y position in the given grid from a 2D world space x/z point
+		    @param Position World-space point
+			@param Grid Grid corners
+			@return (-1,-1) if the point isn't in the grid.
+		 */
+		static Ogre::Vector2 getGridPosition(const Ogre::Vector2 &Position, const GridCorners &Grid);
+
 	    /** Get the object-space position from world-space position
 		    @param WorldSpacePosition Position in world coords
 			@return Position in object-space
@@ -118,4 +118,36 @@ namespace Hydrax{namespace Module
 	{
 		return -1;
 	}
+
+	void Module::getHeigths(const Ogre::Vector3 *Positions, float *Heigths, const int &Count)
+	{
+		for (int i = 0; i < Count; i++)
+		{
+			Heigths[i] = getHeigth(Ogre::Vector2(Positions[i].x, Positions[i].z));
+		}
+	}
+
+	void Module::_getWorldSpaceHeigths(const Ogre::Vector3 *Positions, float *Heigths, const int &Count,
+		                               const float &BaseHeigth, const float &Strength)
+	{
+		const int BatchSize = 64;
+		Ogre::Vector2 NoisePositions[BatchSize];
+
+		for (int Begin = 0; Begin < Count; Begin += BatchSize)
+		{
+			const int Size = std::min(BatchSize, Count - Begin);
+
+			for (int i = 0; i < Size; i++)
+			{
+				NoisePositions[i] = Ogre::Vector2(Positions[Begin + i].x, Positions[Begin + i].z);
+			}
+
+			mNoise->getValues(NoisePositions, Heigths + Begin, Size);
+
+			for (int i = 0; i < Size; i++)
+			{
+				Heigths[Begin + i] = BaseHeigth + Heigths[Begin + i]*Strength;
+			}
+		}
+	}
 }}
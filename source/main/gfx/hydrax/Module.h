@@ -149,7 +149,26 @@ namespace Hydrax{ namespace Module
 		 */
 		virtual float getHeigth(const Ogre::Vector2 &Position);
 
+		/** Get the current heigths at the especified world-space points
+		    @param Positions X/(Y)/Z World positions
+			@param Heigths Heigths at the given positions in y-World coordinates (output)
+			@param Count Number of positions
+			@remarks Modules reading the noise through Noise::getValues() make it safe to call from any thread,
+			         the default implementation calls getHeigth() and is not thread safe.
+		 */
+		virtual void getHeigths(const Ogre::Vector3 *Positions, float *Heigths, const int &Count);
+
 	protected:
+		/** Get heigths of a module which samples the noise in world-space coords, see getHeigths()
+		    @param Positions X/(Y)/Z World positions
+			@param Heigths Heigths at the given positions in y-World coordinates (output)
+			@param Count Number of positions
+			@param BaseHeigth Water plane heigth
+			@param Strength Noise strength
+		 */
+		void _getWorldSpaceHeigths(const Ogre::Vector3 *Positions, float *Heigths, const int &Count,
+			                       const float &BaseHeigth, const float &Strength);
+
 		/// Module name
 		Ogre::String mName;
 		/// Noise generator pointer
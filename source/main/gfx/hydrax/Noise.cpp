@@ -95,4 +95,12 @@ namespace Hydrax{namespace Noise
         HydraxLOG("Error (Noise::loadCfg):\t" + mName + " options entry can not be found.");
 		return false;
 	}
+
+	void Noise::getValues(const Ogre::Vector2 *Positions, float *Values, const int &Count)
+	{
+		for (int i = 0; i < Count; i++)
+		{
+			Values[i] = getValue(Positions[i].x, Positions[i].y);
+		}
+	}
 }}
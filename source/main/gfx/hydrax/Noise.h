@@ -28,6 +28,8 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "Prerequisites.h"
 #include "GPUNormalMapManager.h"
 
+#include <memory>
+
 /// @addtogroup Gfx
 /// @{
 
@@ -36,6 +38,67 @@ http://www.gnu.org/copyleft/lesser.txt.
 
 namespace Hydrax{ namespace Noise
 {
+	/** Double buffered, immutable copy of noise data.
+	    The main thread fills the back buffer and publishes it once per frame, any thread
+		can acquire the published copy and keep reading it while the next one is written.
+	 */
+	template <class T>
+	class Snapshot
+	{
+	public:
+		/** Constructor
+		 */
+		Snapshot()
+			: mBack(0)
+		{
+		}
+
+		/** Get the buffer to fill before publish(), main thread only
+		    @remarks If a reader still holds the buffer, it's replaced by a new (empty) one
+			@return Back buffer
+		 */
+		T& getBackBuffer()
+		{
+			if (!mBuffers[mBack] || mBuffers[mBack].use_count() > 1)
+			{
+				mBuffers[mBack] = std::make_shared<T>();
+			}
+
+			return *mBuffers[mBack];
+		}
+
+		/** Make the back buffer visible to readers, main thread only
+		 */
+		void publish()
+		{
+			std::atomic_store(&mPublished, std::shared_ptr<const T>(mBuffers[mBack]));
+			mBack = 1 - mBack;
+		}
+
+		/** Drop the published buffer, main thread only
+		 */
+		void clear()
+		{
+			std::atomic_store(&mPublished, std::shared_ptr<const T>());
+		}
+
+		/** Get the last published buffer, thread safe
+		    @return Published buffer, null if nothing has been published yet
+		 */
+		std::shared_ptr<const T> acquire() const
+		{
+			return std::atomic_load(&mPublished);
+		}
+
+	private:
+		/// Front and back buffers
+		std::shared_ptr<T> mBuffers[2];
+		/// Index of the back buffer
+		int mBack;
+		/// Buffer visible to readers
+		std::shared_ptr<const T> mPublished;
+	};
+
 	/** Base noise class,
 	    Override it for create different ways of create water noise.
 	 */
@@ -125,6 +188,15 @@ namespace Hydrax{ namespace Noise
 		 */
 		virtual float getValue(const float &x, const float &y) = 0;
 
+		/** Get the especified x/y noise values from the state of the last update()
+		    @param Positions X/Y Coords
+			@param Values Noise values (output)
+			@param Count Number of values
+			@remarks Noises which publish a Snapshot in update() make it safe to call from any thread,
+			         the default implementation calls getValue() and is not thread safe.
+		 */
+		virtual void getValues(const Ogre::Vector2 *Positions, float *Values, const int &Count);
+
 	protected:
 		/// Module name
 		Ogre::String mName;
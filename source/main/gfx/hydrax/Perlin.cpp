@@ -30,6 +30,8 @@ http://graphics.cs.lth.se/theses/projects/projgrid/
 
 #include <Hydrax.h>
 
+#include <algorithm>
+
 #define _def_PackedNoise true
 
 namespace Hydrax{namespace Noise
@@ -37,7 +39,6 @@ namespace Hydrax{namespace Noise
 	Perlin::Perlin()
 		: Noise("Perlin", true)
 		, time(0)
-		, r_noise(0)
 		, magnitude(n_dec_magn * 0.085f)
 		, mGPUNormalMapManager(0)
 	{
@@ -47,7 +48,6 @@ namespace Hydrax{namespace Noise
 		: Noise("Perlin", true)
 		, mOptions(Options)
 		, time(0)
-		, r_noise(0)
 		, magnitude(n_dec_magn * Options.Scale)
 		, mGPUNormalMapManager(0)
 	{
@@ -84,6 +84,7 @@ namespace Hydrax{namespace Noise
 		}
 
 		time = 0;
+		mSnapshot.clear();
 
 		Noise::remove();
 	}
@@ -368,6 +369,7 @@ namespace Hydrax{namespace Noise
 	{
 		time += timeSinceLastFrame*mOptions.Animspeed;
 		_calculeNoise();
+		_publishSnapshot();
 
 		if (areGPUNormalMapResourcesCreated())
 		{
@@ -405,6 +407,47 @@ namespace Hydrax{namespace Noise
 		return _getHeigthDual(x, y);
 	}
 
+	void Perlin::getValues(const Ogre::Vector2 *Positions, float *Values, const int &Count)
+	{
+		const std::shared_ptr<const HeigthSnapshot> Data = mSnapshot.acquire();
+
+		if (!Data)
+		{
+			std::fill(Values, Values + Count, 0.0f);
+			return;
+		}
+
+		for (int k = 0; k < Count; k++)
+		{
+			const int *Octave = &Data->PackedNoise[0];
+
+			int ui = Positions[k].x*Data->Magnitude,
+			    vi = Positions[k].y*Data->Magnitude,
+				value = 0;
+
+			for (int i = 0; i < Data->Packs; i++)
+			{
+				value += _readTexelLinearDual(Octave, ui, vi);
+				ui = ui << n_packsize;
+				vi = vi << n_packsize;
+				Octave += np_size_sq;
+			}
+
+			Values[k] = static_cast<float>(value)/noise_magnitude;
+		}
+	}
+
+	void Perlin::_publishSnapshot()
+	{
+		HeigthSnapshot &Data = mSnapshot.getBackBuffer();
+
+		Data.Packs = mOptions.Octaves / n_packsize;
+		Data.Magnitude = magnitude;
+		Data.PackedNoise.assign(p_noise, p_noise + np_size_sq*std::max(Data.Packs, 1));
+
+		mSnapshot.publish();
+	}
+
 	void Perlin::_initNoise()
 	{
 		// Create noise (uniform)
@@ -523,7 +566,7 @@ namespace Hydrax{namespace Noise
 		}
 	}
 
-	int Perlin::_readTexelLinearDual(const int &u, const int &v,const int &o)
+	int Perlin::_readTexelLinearDual(const int *Data, const int &u, const int &v)
 	{
 		int iu, iup, iv, ivp, fu, fv,
 			ut01, ut23, ut;
@@ -537,8 +580,8 @@ namespace Hydrax{namespace Noise
 		fu = u & n_dec_magn_m1;
 		fv = v & n_dec_magn_m1;
 
-		ut01 = ((n_dec_magn-fu)*r_noise[iv + iu] + fu*r_noise[iv + iup])>>n_dec_bits;
-		ut23 = ((n_dec_magn-fu)*r_noise[ivp + iu] + fu*r_noise[ivp + iup])>>n_dec_bits;
+		ut01 = ((n_dec_magn-fu)*Data[iv + iu] + fu*Data[iv + iup])>>n_dec_bits;
+		ut23 = ((n_dec_magn-fu)*Data[ivp + iu] + fu*Data[ivp + iup])>>n_dec_bits;
 		ut = ((n_dec_magn-fv)*ut01 + fv*ut23) >> n_dec_bits;
 
 		return ut;
@@ -547,7 +590,7 @@ namespace Hydrax{namespace Noise
 	float Perlin::_getHeigthDual(float u, float v)
 	{
 		// Pointer to the current noise source octave
-		r_noise = p_noise;
+		const int *r_noise = p_noise;
 
 		int ui = u*magnitude,
 		    vi = v*magnitude,
@@ -557,7 +600,7 @@ namespace Hydrax{namespace Noise
 
 		for(i=0; i<hoct; i++)
 		{
-			value += _readTexelLinearDual(ui,vi,0);
+			value += _readTexelLinearDual(r_noise,ui,vi);
 			ui = ui << n_packsize;
 			vi = vi << n_packsize;
 			r_noise += np_size_sq;
@@ -31,6 +31,8 @@ http://graphics.cs.lth.se/theses/projects/projgrid/
 
 #include "Noise.h"
 
+#include <vector>
+
 /// @addtogroup Gfx
 /// @{
 
@@ -214,6 +216,13 @@ namespace Hydrax{ namespace Noise
 		 */
 		float getValue(const float &x, const float &y);
 
+		/** Get the especified x/y noise values from the state of the last update(), thread safe
+		    @param Positions X/Y Coords
+			@param Values Noise values (output)
+			@param Count Number of values
+		 */
+		void getValues(const Ogre::Vector2 *Positions, float *Values, const int &Count);
+
 		/** Set/Update perlin noise options
 		    @param Options Perlin noise options
 			@remarks If create() have been already called, Octaves option doesn't be updated.
@@ -241,13 +250,17 @@ namespace Hydrax{ namespace Noise
 		 */
 		void _updateGPUNormalMapResources();
 
+		/** Copy the packed noise to the height snapshot and publish it
+		 */
+		void _publishSnapshot();
+
 		/** Read texel linear dual
+		    @param Data Packed octave data
 		    @param u u
 			@param v v
-			@param o Octave
 			@return int
 		 */
-	    int _readTexelLinearDual(const int &u, const int &v, const int &o);
+	    static int _readTexelLinearDual(const int *Data, const int &u, const int &v);
 
 		/** Read texel linear
 		    @param u u
@@ -269,9 +282,23 @@ namespace Hydrax{ namespace Noise
 		int noise[n_size_sq*noise_frames];
 		int o_noise[n_size_sq*max_octaves];
 		int p_noise[np_size_sq*(max_octaves>>(n_packsize-1))];
-		int *r_noise;
 		float magnitude;
 
+		/** Immutable copy of the packed noise, read by getValues()
+		 */
+		struct HeigthSnapshot
+		{
+			/// Packed octaves, np_size_sq values each
+			std::vector<int> PackedNoise;
+			/// Number of packed octaves
+			int Packs;
+			/// Position scale
+			float Magnitude;
+		};
+
+		/// Height snapshot, published each update()
+		Snapshot<HeigthSnapshot> mSnapshot;
+
 		/// Elapsed time
 		double time;
 
@@ -198,6 +198,13 @@ namespace Hydrax{ namespace Module
 		 */
 		float getHeigth(const Ogre::Vector2 &Position);
 
+		/** Get the current heigths at the especified world-space points, thread safe
+		    @param Positions X/(Y)/Z World positions
+			@param Heigths Heigths at the given positions in y-World coordinates (output)
+			@param Count Number of positions
+		 */
+		void getHeigths(const Ogre::Vector3 *Positions, float *Heigths, const int &Count);
+
 		/** Get current options
 		    @return Current options
 		 */
@@ -666,4 +666,9 @@ namespace Hydrax{namespace Module
 	{
 		return mHydrax->getPosition().y + mNoise->getValue(Position.x, Position.y)*mOptions.Strength;
 	}
+
+	void RadialGrid::getHeigths(const Ogre::Vector3 *Positions, float *Heigths, const int &Count)
+	{
+		_getWorldSpaceHeigths(Positions, Heigths, Count, mHydrax->getPosition().y, mOptions.Strength);
+	}
 }}
@@ -232,6 +232,8 @@ namespace Hydrax{namespace Module
 		{
 			delete [] mVerticesChoppyBuffer;
 		}
+
+		mGridSnapshot.clear();
 	}
 
 	void SimpleGrid::saveCfg(Ogre::String &Data)
@@ -366,6 +368,13 @@ namespace Hydrax{namespace Module
 
 		// Upload geometry changes
 		mHydrax->getMesh()->updateGeometry(mOptions.Complexity*mOptions.Complexity, mVertices);
+
+		// Publish the grid rectangle for getHeigths()
+		if (getNormalMode() != MaterialManager::NM_RTT)
+		{
+			mGridSnapshot.getBackBuffer() = mHydrax->getMesh()->getGridCorners();
+			mGridSnapshot.publish();
+		}
 	}
 
 	void SimpleGrid::_calculeNormals()
@@ -446,4 +455,49 @@ namespace Hydrax{namespace Module
 			return mHydrax->getPosition().y + mNoise->getValue(Position.x, Position.y)*mOptions.Strength;
 		}
 	}
+
+	void SimpleGrid::getHeigths(const Ogre::Vector3 *Positions, float *Heigths, const int &Count)
+	{
+		if (getNormalMode() != MaterialManager::NM_RTT)
+		{
+			// Grid space coords depend on the mesh bounds, use the copy made by the last update()
+			const std::shared_ptr<const Mesh::GridCorners> Grid = mGridSnapshot.acquire();
+			const float BaseHeigth = mHydrax->getPosition().y;
+
+			if (!Grid)
+			{
+				std::fill(Heigths, Heigths + Count, BaseHeigth);
+				return;
+			}
+
+			const int BatchSize = 64;
+			Ogre::Vector2 NoisePositions[BatchSize];
+
+			for (int Begin = 0; Begin < Count; Begin += BatchSize)
+			{
+				const int Size = std::min(BatchSize, Count - Begin);
+
+				for (int i = 0; i < Size; i++)
+				{
+					Ogre::Vector2 RelativePos = Mesh::getGridPosition(Ogre::Vector2(Positions[Begin + i].x, Positions[Begin + i].z), *Grid);
+
+					RelativePos.x *= mOptions.MeshSize.Width;
+					RelativePos.y *= mOptions.MeshSize.Height;
+
+					NoisePositions[i] = RelativePos;
+				}
+
+				mNoise->getValues(NoisePositions, Heigths + Begin, Size);
+
+				for (int i = 0; i < Size; i++)
+				{
+					Heigths[Begin + i] = BaseHeigth + Heigths[Begin + i]*mOptions.Strength;
+				}
+			}
+		}
+		else
+		{
+			_getWorldSpaceHeigths(Positions, Heigths, Count, mHydrax->getPosition().y, mOptions.Strength);
+		}
+	}
 }}
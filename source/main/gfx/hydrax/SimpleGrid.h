@@ -165,6 +165,13 @@ namespace Hydrax{ namespace Module
 		 */
 		float getHeigth(const Ogre::Vector2 &Position);
 
+		/** Get the current heigths at the especified world-space points, thread safe
+		    @param Positions X/(Y)/Z World positions
+			@param Heigths Heigths at the given positions in y-World coordinates (output)
+			@param Count Number of positions
+		 */
+		void getHeigths(const Ogre::Vector3 *Positions, float *Heigths, const int &Count);
+
 		/** Get current options
 		    @return Current options
 		 */
@@ -188,6 +195,9 @@ namespace Hydrax{ namespace Module
 		/// Use it to store vertex positions when choppy displacement is enabled
 		Mesh::POS_NORM_VERTEX* mVerticesChoppyBuffer;
 
+		/// Grid rectangle of the last update(), read by getHeigths()
+		Noise::Snapshot<Mesh::GridCorners> mGridSnapshot;
+
 		/// Our projected grid options
 		Options mOptions;
 
@@ -39,6 +39,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 #include "VClouds/GeometryManager.h"
 #include "VClouds/GeometryBlock.h"
 #include "VClouds/FastFakeRandom.h"
+#include "VClouds/CloudCells.h"
 #include "VClouds/Ellipsoid.h"
 #include "VClouds/DataManager.h"
 #include "SCfgFileManager.h"
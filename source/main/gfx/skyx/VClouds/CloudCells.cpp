@@ -0,0 +1,306 @@
+/*
+--------------------------------------------------------------------------------
+This source file is part of SkyX.
+Visit http://www.paradise-studios.net/products/skyx/
+
+Copyright (C) 2009-2012 Xavier Vergu�n Gonz�lez <xavyiy@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+--------------------------------------------------------------------------------
+*/
+
+#include "CloudCells.h"
+
+#include <algorithm>
+
+namespace SkyX { namespace VClouds
+{
+	CloudCells::CloudCells()
+		: mSunDirection(Ogre::Vector3::ZERO)
+		, mFFRandom(0)
+	{
+		mCells.nx = mCells.ny = mCells.nz = mCells.words = 0;
+	}
+
+	CloudCells::~CloudCells()
+	{
+		remove();
+	}
+
+	void CloudCells::create(const int& nx, const int& ny, const int& nz)
+	{
+		remove();
+
+		mFFRandom = new FastFakeRandom(1024, 0, 1);
+
+		mCells.nx = nx; mCells.ny = ny; mCells.nz = nz;
+		mCells.words = (nz + 31) / 32;
+
+		const int numCells = nx*ny*nz,
+			      numWords = nx*ny*mCells.words;
+
+		mCells.hum.assign(numWords, 0);
+		mCells.act.assign(numWords, 0);
+		mCells.cld.assign(numWords, 0);
+
+		mCells.pact.assign(numCells, 0);
+		mCells.pext.assign(numCells, 1);
+		mCells.phum.assign(numCells, 0);
+
+		mCells.dens.assign(numCells, 0.0f);
+		mCells.light.assign(numCells, 1.0f);
+
+		mActTmp.assign(numWords, 0);
+		mVolTextureData.assign(numCells, 0);
+	}
+
+	void CloudCells::remove()
+	{
+		mCells = Cells();
+		mCells.nx = mCells.ny = mCells.nz = mCells.words = 0;
+		mActTmp.clear();
+		mVolTextureData.clear();
+
+		delete mFFRandom;
+		mFFRandom = 0;
+	}
+
+	void CloudCells::clearProbabilities(const bool& clearData)
+	{
+		std::fill(mCells.pact.begin(), mCells.pact.end(), 0.0f);
+		std::fill(mCells.pext.begin(), mCells.pext.end(), 1.0f);
+		std::fill(mCells.phum.begin(), mCells.phum.end(), 0.0f);
+
+		if (clearData)
+		{
+			std::fill(mCells.act.begin(), mCells.act.end(), 0);
+			std::fill(mCells.cld.begin(), mCells.cld.end(), 0);
+			std::fill(mCells.hum.begin(), mCells.hum.end(), 0);
+
+			std::fill(mCells.dens.begin(), mCells.dens.end(), 0.0f);
+			std::fill(mCells.light.begin(), mCells.light.end(), 0.0f);
+		}
+	}
+
+	const Ogre::Real CloudCells::_getLightAbsorcionAt(const int& x, const int& y, const int& z, const Ogre::Vector3& d, const float& att) const
+	{
+		const int nx = mCells.nx, ny = mCells.ny, nz = mCells.nz;
+
+		Ogre::Real step = 1, factor = 1;
+		Ogre::Vector3 pos = Ogre::Vector3(x, y, z);
+		bool outOfBounds = false;
+		int u, v, uu, vv,
+		    current_iteration = 0, max_iterations = 8;
+
+		while(!outOfBounds)
+		{
+			if ( (int)pos.z >= nz || (int)pos.z < 0 || factor <= 0 || current_iteration >= max_iterations)
+			{
+				outOfBounds = true;
+			}
+			else
+			{
+				u = (int)pos.x; v = (int)pos.y;
+
+				uu = (u<0) ? (u + nx) : u; if (u>=nx) { uu-= nx; }
+				vv = (v<0) ? (v + ny) : v; if (v>=ny) { vv-= ny; }
+
+				factor -= mCells.dens[mCells.index(uu, vv, (int)pos.z)]*att*(1-static_cast<float>(current_iteration)/max_iterations);
+				pos += step*(-d);
+
+				current_iteration++;
+			}
+		}
+
+		return Ogre::Math::Clamp<Ogre::Real>(factor,0,1);
+	}
+
+	void CloudCells::performCalculations(const int& step, const int& xStart, const int& xEnd)
+	{
+		const int nx = mCells.nx, ny = mCells.ny, nz = mCells.nz, words = mCells.words;
+
+		int u, v, w, k;
+
+		switch (step)
+		{
+			case 0:
+			{
+				for (u = xStart; u < xEnd; u++)
+				{
+					for (v = 0; v < ny; v++)
+					{
+						const int c = mCells.column(u, v);
+
+						for (w = 0; w < nz; w++)
+						{
+							const int i = mCells.index(u, v, w);
+							const Ogre::uint32 bit = 1u << (w & 31);
+							Ogre::uint32 &hum = mCells.hum[c + (w >> 5)],
+							             &cld = mCells.cld[c + (w >> 5)],
+										 &act = mCells.act[c + (w >> 5)];
+
+							// ti+1                       ti
+							if (!(hum & bit) && mFFRandom->get() < mCells.phum[i]) { hum |= bit; }
+							if ( (cld & bit) && !(mFFRandom->get() > mCells.pext[i])) { cld &= ~bit; }
+							if (!(act & bit) && mFFRandom->get() < mCells.pact[i]) { act |= bit; }
+						}
+
+						// Copy act in the temporal buffer, for _fact(...)
+						for (k = 0; k < words; k++)
+						{
+							mActTmp[c + k] = mCells.act[c + k];
+						}
+					}
+				}
+			}
+			break;
+			case 1:
+			{
+				// 32 cells at once
+				for (u = xStart; u < xEnd; u++)
+				{
+					for (v = 0; v < ny; v++)
+					{
+						const int c = mCells.column(u, v);
+
+						for (k = 0; k < words; k++)
+						{
+							const Ogre::uint32 act = mCells.act[c + k];
+
+							// ti+1                       ti
+							mCells.hum[c + k] &= ~act;
+							mCells.cld[c + k] |=  act;
+							mCells.act[c + k]  = ~act & mCells.hum[c + k] & _fact(u, v, k);
+						}
+					}
+				}
+			}
+			break;
+			case 2:
+			{
+				// Continous density
+				std::vector<int> layers(nz);
+
+				for (u = xStart; u < xEnd; u++)
+				{
+					for (v = 0; v < ny; v++)
+					{
+						std::fill(layers.begin(), layers.end(), 0);
+
+						for (int x = u-1; x <= u+1; x++)
+						{
+							for (int y = v-1; y <= v+1; y++)
+							{
+								// x/y Seamless!
+								const int uu = (x<0) ? (x + nx) : ((x>=nx) ? (x - nx) : x),
+								          vv = (y<0) ? (y + ny) : ((y>=ny) ? (y - ny) : y),
+										  c = mCells.column(uu, vv);
+
+								for (w = 0; w < nz; w++)
+								{
+									layers[w] += (mCells.cld[c + (w >> 5)] >> (w & 31)) & 1;
+								}
+							}
+						}
+
+						for (w = 0; w < nz; w++)
+						{
+							mCells.dens[mCells.index(u, v, w)] = _getDensityAt(w, 1.15f, &layers[0]);
+						}
+					}
+				}
+			}
+			break;
+			case 3:
+			{
+				// Light scattering
+				for (u = xStart; u < xEnd; u++)
+				{
+					for (v = 0; v < ny; v++)
+					{
+						for (w = 0; w < nz; w++)
+						{
+							mCells.light[mCells.index(u, v, w)] = _getLightAbsorcionAt(u,v,w, mSunDirection, 0.15f/*TODO!!!!*/);
+						}
+					}
+				}
+
+				packVolTextureData(xStart, xEnd);
+			}
+			break;
+		}
+	}
+
+	const Ogre::uint32 CloudCells::_fact(const int& x, const int& y, const int& k) const
+	{
+		const int nx = mCells.nx, ny = mCells.ny, words = mCells.words;
+		const Ogre::uint32 *act = &mActTmp[0];
+
+		// x/y seamless, x-2 and x+2 (y-2 and y+2) wrap to nx-2 and 1
+		const int i1m = ((x+1)>=nx) ? 0 : x+1,
+			      i1r = ((x-1)<0) ? nx-1 : x-1,
+				  i2r = ((x-2)<0) ? nx-2 : x-2,
+				  i2m = ((x+2)>=nx) ? 1 : x+2,
+				  j1m = ((y+1)>=ny) ? 0 : y+1,
+				  j1r = ((y-1)<0) ? ny-1 : y-1,
+				  j2r = ((y-2)<0) ? ny-2 : y-2,
+				  j2m = ((y+2)>=ny) ? 1 : y+2;
+
+		// z isn't seamless, out of range neighbours are false
+		const int c = mCells.column(x, y) + k;
+		const Ogre::uint32 k1m = (act[c] >> 1) | ((k+1 < words) ? (act[c+1] << 31) : 0),
+			               k1r = (act[c] << 1) | ((k > 0) ? (act[c-1] >> 31) : 0),
+						   k2r = (act[c] << 2) | ((k > 0) ? (act[c-1] >> 30) : 0);
+
+		return act[mCells.column(i1m, y) + k] | act[mCells.column(x, j1m) + k] | k1m |
+			   act[mCells.column(i1r, y) + k] | act[mCells.column(x, j1r) + k] | k1r |
+			   act[mCells.column(i2r, y) + k] | act[mCells.column(i2m, y) + k] |
+			   act[mCells.column(x, j2r) + k] | act[mCells.column(x, j2m) + k] | k2r;
+	}
+
+	const float CloudCells::_getDensityAt(const int& z, const float& strength, const int *layers) const
+	{
+		const int r = 1;
+
+		int zr = ((z-r)<0) ? 0 : z-r,
+			zm = ((z+r)>=mCells.nz) ? mCells.nz : z+r,
+			w, clouds = 0, div = 0;
+
+		for (w = zr; w < zm; w++)
+		{
+			clouds += layers[w];
+			div += (2*r+1)*(2*r+1);
+		}
+
+		return Ogre::Math::Clamp<float>(strength*((float)clouds)/div, 0, 1);
+	}
+
+	void CloudCells::packVolTextureData(const int& xStart, const int& xEnd)
+	{
+		const int nx = mCells.nx, ny = mCells.ny, nz = mCells.nz;
+
+		for (int u = xStart; u < xEnd; u++)
+		{
+			for (int v = 0; v < ny; v++)
+			{
+				for (int w = 0; w < nz; w++)
+				{
+					const int i = mCells.index(u, v, w);
+					Ogre::PixelUtil::packColour(mCells.dens[i]/* TODO!!!! */, mCells.light[i], 0, 0, Ogre::PF_BYTE_RGBA, &mVolTextureData[(w*ny + v)*nx + u]);
+				}
+			}
+		}
+	}
+}}
@@ -0,0 +1,225 @@
+/*
+--------------------------------------------------------------------------------
+This source file is part of SkyX.
+Visit http://www.paradise-studios.net/products/skyx/
+
+Copyright (C) 2009-2012 Xavier Vergun Gonzlez <xavyiy@gmail.com>
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+--------------------------------------------------------------------------------
+*/
+
+#ifndef _SkyX_VClouds_CloudCells_H_
+#define _SkyX_VClouds_CloudCells_H_
+
+#include "Prerequisites.h"
+
+#include "FastFakeRandom.h"
+
+#include <vector>
+
+namespace SkyX { namespace VClouds{
+
+	/** Cellular automaton of the clouds field: simulation cells, calculation steps and
+	    the volumetric texture data they produce. Owned by DataManager, which schedules the
+		steps and uploads the texture data; this class has no rendering resources.
+	 */
+	class CloudCells
+	{
+	public:
+		/** Simulation cells, stored as one plane per cell attribute.
+		    Cell (x,y,z) is at index (x*ny + y)*nz + z of the float planes, the
+			boolean planes are packed by z columns: bit z%32 of word (x*ny + y)*words + z/32.
+			Bits past nz are always zero.
+		 */
+		struct Cells
+		{
+			/// Size
+			int nx, ny, nz;
+			/// Words per z column in the boolean planes
+			int words;
+
+			/// Humidity, phase and cloud
+			std::vector<Ogre::uint32> hum, act, cld;
+
+			/// Probabilities
+			std::vector<float> phum, pext, pact;
+
+			/// Continous density
+			std::vector<float> dens;
+
+			/// Light absorcion
+			std::vector<float> light;
+
+			/** Get float planes index
+			    @param x x Coord
+				@param y y Coord
+				@param z z Coord
+			 */
+			inline int index(const int& x, const int& y, const int& z) const
+			{
+				return (x*ny + y)*nz + z;
+			}
+
+			/** Get index of the first word of a column in the boolean planes
+			    @param x x Coord
+				@param y y Coord
+			 */
+			inline int column(const int& x, const int& y) const
+			{
+				return (x*ny + y)*words;
+			}
+
+			/** Get a cell from a boolean plane
+			    @param plane hum, act or cld
+			    @param x x Coord
+				@param y y Coord
+				@param z z Coord
+			 */
+			inline bool get(const std::vector<Ogre::uint32>& plane, const int& x, const int& y, const int& z) const
+			{
+				return (plane[column(x, y) + (z >> 5)] >> (z & 31)) & 1;
+			}
+
+			/** Set a cell of a boolean plane
+			    @param plane hum, act or cld
+			    @param x x Coord
+				@param y y Coord
+				@param z z Coord
+				@param value Value
+			 */
+			inline void set(std::vector<Ogre::uint32>& plane, const int& x, const int& y, const int& z, const bool& value)
+			{
+				Ogre::uint32 &word = plane[column(x, y) + (z >> 5)];
+				word = value ? (word | (1u << (z & 31))) : (word & ~(1u << (z & 31)));
+			}
+		};
+
+		/** Constructor
+		 */
+		CloudCells();
+
+		/** Destructor
+		 */
+		~CloudCells();
+
+		/** Create
+		    @param nx X complexity
+			@param ny Y complexity
+			@param nz Z complexity
+			@remarks Fills the random numbers table of step 0 from Ogre::Math::RangeRandom(...)
+		 */
+		void create(const int& nx, const int& ny, const int& nz);
+
+		/** Remove
+		 */
+		void remove();
+
+		/** Get simulation cells
+		    @return Cells
+		 */
+		inline Cells& getCells()
+		{
+			return mCells;
+		}
+
+		/** Get simulation cells
+		    @return Cells
+		 */
+		inline const Cells& getCells() const
+		{
+			return mCells;
+		}
+
+		/** Get volumetric texture data
+		    @return PF_BYTE_RGBA texels, x-major: texel (x,y,z) is at (z*ny + y)*nx + x. Written by step 3.
+		 */
+		inline const std::vector<Ogre::uint32>& getVolTextureData() const
+		{
+			return mVolTextureData;
+		}
+
+		/** Set sun direction used by step 3
+		    @param SunDirection Sun direction, in cells space
+		 */
+		inline void setSunDirection(const Ogre::Vector3& SunDirection)
+		{
+			mSunDirection = SunDirection;
+		}
+
+		/** Clear probabilities
+			@param clearData Clear data?
+		 */
+		void clearProbabilities(const bool& clearData);
+
+		/** Perform celullar automata simulation
+			@param step Calculation step. Valid steps are 0,1,2,3.
+			@param xStart x start cell (included)
+			@param xEnd x end cell (not included, until xEnd-1)
+			@remarks Steps 1, 2 and 3 only write to the given x slices, so they can run in parallel over
+			         separate ranges. Step 0 consumes random numbers cell by cell and must run over all slices at once.
+		 */
+		void performCalculations(const int& step, const int& xStart, const int& xEnd);
+
+		/** Pack cells density and light into the volumetric texture data
+			@param xStart x start cell (included)
+			@param xEnd x end cell (not included, until xEnd-1)
+		 */
+		void packVolTextureData(const int& xStart, const int& xEnd);
+
+	private:
+		/** Get continous density at a point
+			@param z z Coord 
+			@param strength Strength
+			@param layers Clouds count of each z layer in the 3x3 x/y neighbourhood of the point
+			@remarks Radius 1
+		 */	
+		const float _getDensityAt(const int& z, const float& strength, const int *layers) const;
+
+		/** Fact funtion, for 32 cells of a z column at once
+			@param x x Coord
+			@param y y Coord
+			@param k Word of the column
+			@return act neighbours mask
+		 */
+		const Ogre::uint32 _fact(const int& x, const int& y, const int& k) const;
+
+		/** Get light absorcion factor at a point
+			@param x x Coord
+			@param y y Coord
+			@param z z Coord 
+			@param d Light direction
+			@param att Attenuation factor
+		 */
+		const Ogre::Real _getLightAbsorcionAt(const int& x, const int& y, const int& z, const Ogre::Vector3& d, const float& att) const;
+
+		/// Simulation data
+		Cells mCells;
+		/// Copy of the act plane taken by step 0, for _fact(...)
+		std::vector<Ogre::uint32> mActTmp;
+
+		/// Volumetric texture data (PF_BYTE_RGBA)
+		std::vector<Ogre::uint32> mVolTextureData;
+
+		/// Sun direction used by step 3, in cells space
+		Ogre::Vector3 mSunDirection;
+
+		/// Fast fake random
+		FastFakeRandom *mFFRandom;
+	};
+
+}}
+
+#endif
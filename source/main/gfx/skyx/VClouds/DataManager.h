@@ -26,7 +26,14 @@ http://www.gnu.org/copyleft/lesser.txt.
 
 #include "Prerequisites.h"
 
-#include "FastFakeRandom.h"
+#include "CloudCells.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace RoR { class Task; }
 
 namespace SkyX { namespace VClouds{
 
@@ -36,23 +43,6 @@ namespace SkyX { namespace VClouds{
 	class DataManager 
 	{
 	public:
-		/** Cell struct
-		 */
-		struct Cell
-		{
-			/// Humidity, phase and cloud
-			bool hum, act, cld;
-
-			/// Probabilities
-			float phum, pext, pact;
-
-			/// Continous density
-			float dens;
-
-			/// Light absorcion
-			float light;
-		};
-
 		/** Volumetric textures enumeration
 		 */
 		enum VolTextureId
@@ -61,6 +51,9 @@ namespace SkyX { namespace VClouds{
 			VOL_TEX1 = 1
 		};
 
+		/// Number of x slices per thread pool task, in the parallel calculation steps
+		static const int SLICES_PER_TASK = 16;
+
 		/** Constructor
 		    @param vc VClouds parent pointer
 		 */
@@ -79,6 +72,9 @@ namespace SkyX { namespace VClouds{
 
 		/** Update
 			@param timeSinceLastFrame Time elapsed since last frame
+			@remarks The next step is calculated on the thread pool while the volumetric
+			         textures are interpolated, each call launches the following calculation step
+					 once the previous one has finished, and uploads the result when the transition ends.
 		 */
 		void update(const Ogre::Real &timeSinceLastFrame);
 
@@ -95,7 +91,7 @@ namespace SkyX { namespace VClouds{
 		}
 
 		/** Set update time
-		    @param UpdateTime Time elapsed between data calculations, a little freeze could be experimented during these calculations on old CPU's
+		    @param UpdateTime Time elapsed between data calculations
 		 */
 		inline void setUpdateTime(const float& UpdateTime)
 		{
@@ -119,6 +115,15 @@ namespace SkyX { namespace VClouds{
 			return mCurrentTransition/mUpdateTime;
 		}
 
+		/** Get simulation cells
+		    @return Cells, only safe to read while no calculation step is running (see forceToUpdateData())
+			@remarks Only for internal use
+		 */
+		inline const CloudCells::Cells& _getCells() const
+		{
+			return mCloudCells.getCells();
+		}
+
 		/** Set wheater parameters
 		    Use this funtion to update the cloud field parameters, you'll get a smart and smooth transition from your old 
 			setting to your new ones.
@@ -142,119 +147,33 @@ namespace SkyX { namespace VClouds{
 
 	private:
 
-		/** Initialize data
-		    @param nx X complexity
-			@param ny Y complexity
-			@param nz Z complexity
+		/** Get the jobs of a calculation step, to be run by the thread pool
+			@param step Calculation step. Valid steps are 0,1,2,3.
+			@param jobs Output jobs
 		 */
-		void _initData(const int& nx, const int& ny, const int& nz);
+		void _getCalculationJobs(const int& step, std::vector<std::function<void()>>& jobs);
 
-		/** Create tridimensional cell array
-			@param nx X size
-			@param ny Y size
-			@param nz Z size
-			@param init Initialize values
-			@return Cell 3d pointer
+		/** Launch the next calculation step on the thread pool, if the previous one has finished
 		 */
-		Cell *** _create3DCellArray(const int& nx, const int& ny, const int& nz, const bool& init = true);
+		void _updateCalculations();
 
-		/** Delete tridimensional cell array
-			@param c Cell pointer to be deleted
-			@param nx X size
-			@param ny Y size
+		/** Wait for the running calculation step, then calculate the remaining steps right now
 		 */
-		void _delete3DCellArray(Cell ***c, const int& nx, const int& ny);
-
-		/** Copy 3d cells arrays data
-			@param src Source
-			@param dest Dest
-			@param nx X size
-			@param ny Y size
-			@param nz Z size
-		*/
-		void _copy3DCellArraysData(Cell ***src, Cell ***dest, const int& nx, const int& ny, const int& nz);
+		void _finishCalculations();
 
-		/** Perform celullar automata simulation
-		    @param nx X size
-			@param ny Y size
-			@param nz Z size
-			@param step Calculation step. Valid steps are 0,1,2,3.
-			@param xStart x start cell (included)
-			@param xEnd x end cell (not included, until xEnd-1)
+		/** Wait for the running calculation step, if any
 		 */
-		void _performCalculations(const int& nx, const int& ny, const int& nz, const int& step, const int& xStart, const int& xEnd);
+		void _waitForCalculations();
 
-		/** Update volumetric texture data
-		    @param c Cells data
+		/** Upload volumetric texture data
 			@param TexId Texture Id
-		    @param nx X size
-			@param ny Y size
-			@param nz Z size
-		 */
-		void _updateVolTextureData(Cell ***c, const VolTextureId& TexId, const int& nx, const int& ny, const int& nz);
-
-		/** Get continous density at a point
-		    @param c Cells data
-			@param nx X size
-			@param ny Y size
-			@param nz Z size
-			@param x x Coord
-			@param y y Coord
-			@param z z Coord 
-			@param r Radius
-			@param sgtrength Strength
-		 */	
-		const float _getDensityAt(Cell ***c, const int& nx, const int& ny, const int& nz, const int& x, const int& y, const int& z, const int& r, const float& strength) const;
-
-		/** Get discrete density at a point
-		    @param c Cells data
-			@param x x Coord
-			@param y y Coord
-			@param z z Coord 
-		 */	
-		const float _getDensityAt(Cell ***c, const int& x, const int& y, const int& z) const;
-
-		/** Fact funtion
-		    @param c Cells data
-			@param nx X size
-			@param ny Y size
-			@param nz Z size
-			@param x x Coord
-			@param y y Coord
-			@param z z Coord 
-		 */
-		const bool _fact(Cell ***c, const int& nx, const int& ny, const int& nz, const int& x, const int& y, const int& z) const;
-
-		/** Clear probabilities
-		    @param c Cells data
-			@param nx X size
-			@param ny Y size
-			@param nz Z size
-			@param clearData Clear data?
 		 */
-		void _clearProbabilities(Cell*** c, const int& nx, const int& ny, const int& nz, const bool& clearData);
+		void _updateVolTextureData(const VolTextureId& TexId);
 
 		/** Update probabilities based from the Ellipsoid vector
-		    @param c Cells data
-			@param nx X size
-			@param ny Y size
-			@param nz Z size
 			@param delayedResponse false to change wheather conditions over several updates, true to change it at the moment
 		 */
-		void _updateProbabilities(Cell*** c, const int& nx, const int& ny, const int& nz, const bool& delayedResponse);
-
-		/** Get light absorcion factor at a point
-			@param c Cells data
-			@param nx X size
-			@param ny Y size
-			@param nz Z size
-			@param x x Coord
-			@param y y Coord
-			@param z z Coord 
-			@param d Light direction
-			@param att Attenuation factor
-		 */
-		const Ogre::Real _getLightAbsorcionAt(Cell*** c, const int& nx, const int& ny, const int& nz, const int& x, const int& y, const int& z, const Ogre::Vector3& d, const float& att) const;
+		void _updateProbabilities(const bool& delayedResponse);
 
 		/** Create volumetric texture
 			@param TexId Texture Id
@@ -264,16 +183,20 @@ namespace SkyX { namespace VClouds{
 		 */
 		void _createVolTexture(const VolTextureId& TexId, const int& nx, const int& ny, const int& nz);
 
-		/// Simulation data
-		Cell ***mCellsCurrent,
-			 ***mCellsTmp;
+		/// Simulation cells; step 3 writes the volumetric texture data, uploaded at the end of the transition
+		CloudCells mCloudCells;
 
 		/// Current transition
 		float mCurrentTransition;
 		/// Update time
 		float mUpdateTime;
-		/// Current calculation state
-		int mStep, mXStart, mXEnd;
+		/// Next calculation step to be launched, 4 when the data is ready to be uploaded
+		int mStep;
+
+		/// Thread pool tasks of the running calculation step
+		std::vector<std::shared_ptr<RoR::Task>> mTasks;
+		/// Number of them which haven't finished yet
+		std::atomic<int> mRunningTasks;
 
 		/// Complexities
 		int mNx, mNy, mNz;
@@ -286,9 +209,6 @@ namespace SkyX { namespace VClouds{
 		/// Has been create(...) already called?
 		bool mCreated;
 
-		/// Fast fake random
-		FastFakeRandom *mFFRandom;
-
 		/// Max number of clouds(Ellipsoids)
 		int mMaxNumberOfClouds;
 		/// Ellipsoids
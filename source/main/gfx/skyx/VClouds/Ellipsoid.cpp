@@ -79,9 +79,10 @@ namespace SkyX { namespace VClouds
 		return Ogre::Vector3(density, 1-density, density);
 	}
 
-    void Ellipsoid::updateProbabilities(DataManager::Cell ***c, const int &nx, const int &ny, const int &nz, const bool& delayedResponse)
+    void Ellipsoid::updateProbabilities(CloudCells::Cells &c, const bool& delayedResponse)
 	{
-		int u, v, w, uu, vv;
+		const int nx = c.nx, ny = c.ny;
+		int u, v, w, uu, vv, i;
 
 		float length;
 
@@ -99,13 +100,15 @@ namespace SkyX { namespace VClouds
 
 					if (length < 1)
 					{
-						c[uu][vv][w].phum = 0.005f;
-						c[uu][vv][w].pext = 0.05f;
-						c[uu][vv][w].pact = 0.01f;
+						i = c.index(uu, vv, w);
+
+						c.phum[i] = 0.005f;
+						c.pext[i] = 0.05f;
+						c.pact[i] = 0.01f;
 
 						if (!delayedResponse)
 						{
-							c[uu][vv][w].cld = Ogre::Math::RangeRandom(0,1) > length ? true : false;
+							c.set(c.cld, uu, vv, w, Ogre::Math::RangeRandom(0,1) > length ? true : false);
 						}
 					}
 				}
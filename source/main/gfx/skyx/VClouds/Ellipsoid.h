@@ -26,7 +26,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 
 #include "Prerequisites.h"
 
-#include "DataManager.h"
+#include "CloudCells.h"
 
 namespace SkyX { namespace VClouds{
 
@@ -76,12 +76,9 @@ namespace SkyX { namespace VClouds{
 
 		/** Update probabilities
 			@param c Cells
-			@param nx X complexity
-			@param ny Y complexity
-			@param nz Z complexity
 			@param delayedResponse true to get a delayed response, updating only probabilities, false to also set clouds
 		 */
-		void updateProbabilities(DataManager::Cell ***c, const int &nx, const int &ny, const int &nz, const bool& delayedResponse = true);
+		void updateProbabilities(CloudCells::Cells &c, const bool& delayedResponse = true);
 
 		/** Determines if the ellipsoid is out of the cells domain and needs to be removed
 		 */
@@ -261,6 +261,7 @@ void GameSettings::DrawGameplaySettings()
     DrawGCheckbox(App::sim_races_enabled, _LC("GameSettings", "Enable races"));
 
     DrawGCheckbox(App::sim_no_self_collisions, _LC("GameSettings", "No intra truck collisions"));
+    DrawGIntSlider(App::sim_self_collision_hops, _LC("GameSettings", "Intra truck collision exclusion (beam hops)"), 0, 4);
     DrawGCheckbox(App::sim_no_collisions, _LC("GameSettings", "No inter truck collisions"));
 
     DrawGCheckbox(App::io_discord_rpc, _LC("GameSettings", "Discord Rich Presence"));
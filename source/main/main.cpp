@@ -251,6 +251,11 @@ int main(int argc, char *argv[])
             }
         }
 
+        if (App::cli_input_playback->getStr() != "")
+        {
+            App::GetInputEngine()->StartPlayback(App::cli_input_playback->getStr());
+        }
+
         // Handle game state presets
         if (App::cli_server_host->getStr() != "" && App::cli_server_port->getInt() != 0) // Multiplayer, commandline
         {
@@ -994,8 +999,12 @@ int main(int argc, char *argv[])
 
             // Calculate delta time
             const auto now = std::chrono::high_resolution_clock::now();
-            const float dt = std::chrono::duration<float>(now - start_time).count();
+            float dt = std::chrono::duration<float>(now - start_time).count();
             start_time = now;
+            if (App::GetInputEngine()->IsPlayingBack())
+            {
+                dt = App::GetInputEngine()->GetPlaybackFrameTime(); // Replay with the frame times it was recorded with
+            }
 
 #ifdef USE_SOCKETW
             // Process incoming network traffic
@@ -1017,7 +1026,7 @@ int main(int argc, char *argv[])
             // Process input events
             if (dt != 0.f)
             {
-                App::GetInputEngine()->Capture();
+                App::GetInputEngine()->Capture(dt);
                 App::GetInputEngine()->updateKeyBounces(dt);
 
                 if (!App::GetGuiManager()->GameControls.IsInteractiveKeyBindingActive())
@@ -1137,10 +1146,12 @@ int main(int argc, char *argv[])
             }
 
             // Create snapshot of simulation state for Gfx/GUI updates
+            // While paused, the snapshot (and the actor queries read from it) keeps showing the paused state
             if (App::sim_state->getEnum<SimState>() == SimState::RUNNING ||   // Obviously
                 App::sim_state->getEnum<SimState>() == SimState::EDITOR_MODE) // Needed for character movement
             {
                 App::GetGfxScene()->BufferSimulationData();
+                App::GetGameContext()->GetActorManager()->UpdateActorQueries();
             }
 
             // Advance simulation
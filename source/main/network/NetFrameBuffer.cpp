@@ -0,0 +1,221 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "NetFrameBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Ogre;
+using namespace RoR;
+
+void NetFrameBuffer::Init(int num_nodes, int num_wheels, float node_compression)
+{
+    m_num_nodes = std::max(0, num_nodes);
+    m_num_wheels = std::max(0, num_wheels);
+    m_node_compression = node_compression;
+    m_frames.resize(CAPACITY);
+    for (NetFrame& frame : m_frames)
+    {
+        memset(&frame.nf_state, 0, sizeof(RoRnet::VehicleState));
+        frame.nf_node_pos.assign(m_num_nodes, Vector3::ZERO);
+        frame.nf_node_vel.assign(m_num_nodes, Vector3::ZERO);
+        frame.nf_wheel_rp.assign(m_num_wheels, 0.f);
+        frame.nf_wheel_vel.assign(m_num_wheels, 0.f);
+        frame.nf_vel_dt = 0.f;
+    }
+    this->Clear();
+}
+
+bool NetFrameBuffer::Push(RoRnet::VehicleState const& state, const char* node_data, const char* wheel_data)
+{
+    if (m_frames.empty())
+        return false;
+
+    if (m_count > 0)
+    {
+        const int newest_time = this->GetFrame(m_count - 1).nf_state.time;
+        if (state.time <= newest_time)
+            return false;
+        if (state.time - newest_time > MAX_FRAME_GAP_MS)
+            this->Clear();
+    }
+
+    if (m_count == CAPACITY)
+        this->PopFront(1);
+
+    NetFrame& frame = this->GetFrameMutable(m_count);
+    m_count++;
+    frame.nf_state = state;
+
+    // Layout matches `Actor::sendStreamData()`: first node uncompressed, others as
+    // 3 short ints relative to the first. The packet buffer may be unaligned, hence memcpy.
+    if (m_num_nodes > 0)
+    {
+        float ref[3];
+        memcpy(ref, node_data, sizeof(ref));
+        const Vector3 refpos(ref[0], ref[1], ref[2]);
+        frame.nf_node_pos[0] = refpos;
+
+        const char* ptr = node_data + sizeof(ref);
+        for (int i = 1; i < m_num_nodes; i++)
+        {
+            short int rel[3];
+            memcpy(rel, ptr, sizeof(rel));
+            ptr += sizeof(rel);
+            frame.nf_node_pos[i] = refpos + Vector3((float)rel[0], (float)rel[1], (float)rel[2]) / m_node_compression;
+        }
+    }
+    if (m_num_wheels > 0)
+    {
+        memcpy(frame.nf_wheel_rp.data(), wheel_data, m_num_wheels * sizeof(float));
+    }
+
+    if (m_count > 1)
+    {
+        NetFrame const& prev = this->GetFrame(m_count - 2);
+        frame.nf_vel_dt = (float)(state.time - prev.nf_state.time) / 1000.f;
+        const float inv_dt = 1.f / frame.nf_vel_dt;
+        for (int i = 0; i < m_num_nodes; i++)
+        {
+            frame.nf_node_vel[i] = (frame.nf_node_pos[i] - prev.nf_node_pos[i]) * inv_dt;
+        }
+        for (int i = 0; i < m_num_wheels; i++)
+        {
+            frame.nf_wheel_vel[i] = (frame.nf_wheel_rp[i] - prev.nf_wheel_rp[i]) * inv_dt;
+        }
+    }
+    else
+    {
+        std::fill(frame.nf_node_vel.begin(), frame.nf_node_vel.end(), Vector3::ZERO);
+        std::fill(frame.nf_wheel_vel.begin(), frame.nf_wheel_vel.end(), 0.f);
+        frame.nf_vel_dt = 0.f;
+    }
+
+    return true;
+}
+
+NetSample NetFrameBuffer::Sample(int time, Vector3* out_node_pos, Vector3* out_node_vel, float* out_wheel_rp) const
+{
+    NetSample result;
+    if (m_count < 2)
+        return result;
+
+    // Find the newest frame not later than `time`; the caller pops older frames, so this rarely iterates.
+    int index = 0;
+    while (index < m_count - 2 && this->GetFrame(index + 1).nf_state.time <= time)
+    {
+        index++;
+    }
+
+    NetFrame const& f1 = this->GetFrame(index);
+    NetFrame const& f2 = this->GetFrame(index + 1);
+    const int t1 = f1.nf_state.time;
+    const int t2 = f2.nf_state.time;
+
+    result.ns_state1 = &f1.nf_state;
+    result.ns_state2 = &f2.nf_state;
+    result.ns_tratio = (float)(time - t1) / (float)(t2 - t1);
+    result.ns_frames_before = index;
+    result.ns_frames_after = m_count - index - 2;
+
+    if (result.ns_tratio > 1.f)
+    {
+        float dt = (float)(time - t2) / 1000.f;
+        result.ns_mode = NetSample::EXTRAPOLATED;
+        if (time - t2 > MAX_EXTRAPOLATION_MS)
+        {
+            dt = (float)MAX_EXTRAPOLATION_MS / 1000.f;
+            result.ns_mode = NetSample::HELD;
+        }
+
+        // Along the end tangent of the spline, so the motion stays smooth.
+        for (int i = 0; i < m_num_nodes; i++)
+        {
+            const Vector3 tangent = GetTangent(&f1, f2, nullptr, i);
+            out_node_pos[i] = f2.nf_node_pos[i] + tangent * dt;
+            out_node_vel[i] = (result.ns_mode == NetSample::HELD) ? Vector3::ZERO : tangent;
+        }
+        for (int i = 0; i < m_num_wheels; i++)
+        {
+            out_wheel_rp[i] = f2.nf_wheel_rp[i] + f2.nf_wheel_vel[i] * dt;
+        }
+        return result;
+    }
+
+    result.ns_mode = NetSample::INTERPOLATED;
+
+    // Cubic Hermite basis and its derivative
+    const float s = std::max(0.f, result.ns_tratio);
+    const float s2 = s * s;
+    const float s3 = s2 * s;
+    const float h = (float)(t2 - t1) / 1000.f;
+    const float h00 = 2.f * s3 - 3.f * s2 + 1.f;
+    const float h10 = (s3 - 2.f * s2 + s) * h;
+    const float h01 = -2.f * s3 + 3.f * s2;
+    const float h11 = (s3 - s2) * h;
+    const float d00 = (6.f * s2 - 6.f * s) / h;
+    const float d10 = 3.f * s2 - 4.f * s + 1.f;
+    const float d01 = (-6.f * s2 + 6.f * s) / h;
+    const float d11 = 3.f * s2 - 2.f * s;
+
+    // `f2` is always relative to `f1`; the frame after the window may be missing.
+    NetFrame const* f3 = (index + 2 < m_count) ? &this->GetFrame(index + 2) : nullptr;
+    for (int i = 0; i < m_num_nodes; i++)
+    {
+        const Vector3& p1 = f1.nf_node_pos[i];
+        const Vector3& p2 = f2.nf_node_pos[i];
+        const Vector3 m1 = GetTangent(nullptr, f1, &f2, i);
+        const Vector3 m2 = GetTangent(&f1, f2, f3, i);
+
+        out_node_pos[i] = p1 * h00 + m1 * h10 + p2 * h01 + m2 * h11;
+        out_node_vel[i] = p1 * d00 + m1 * d10 + p2 * d01 + m2 * d11;
+    }
+    for (int i = 0; i < m_num_wheels; i++)
+    {
+        out_wheel_rp[i] = f1.nf_wheel_rp[i] + s * (f2.nf_wheel_rp[i] - f1.nf_wheel_rp[i]);
+    }
+    return result;
+}
+
+Vector3 NetFrameBuffer::GetTangent(NetFrame const* prev, NetFrame const& frame, NetFrame const* next, int node)
+{
+    // The velocity of a segment is the derivative of the parabola through 3 frames at the middle
+    // of the segment. Its derivative at the frame follows from both segment velocities and durations.
+    if (next)
+    {
+        if (frame.nf_vel_dt == 0.f)
+            return next->nf_node_vel[node];
+        return (frame.nf_node_vel[node] * next->nf_vel_dt + next->nf_node_vel[node] * frame.nf_vel_dt)
+            / (frame.nf_vel_dt + next->nf_vel_dt);
+    }
+
+    // Newest frame: at the end of the parabola through the 2 segments before
+    if (!prev || prev->nf_vel_dt == 0.f || frame.nf_vel_dt == 0.f)
+        return frame.nf_node_vel[node];
+    const Vector3& v_after = frame.nf_node_vel[node];
+    return v_after + (v_after - prev->nf_node_vel[node]) * frame.nf_vel_dt / (prev->nf_vel_dt + frame.nf_vel_dt);
+}
+
+void NetFrameBuffer::PopFront(int count)
+{
+    count = std::min(std::max(0, count), m_count);
+    m_first = (m_first + count) % CAPACITY;
+    m_count -= count;
+}
@@ -0,0 +1,106 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Jitter buffer of decoded actor stream frames (`RoRnet::MSG2_STREAM_DATA`), one per remote actor.
+
+#pragma once
+
+#include "RoRnet.h"
+
+#include <OgreVector3.h>
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Network
+/// @{
+
+/// One received actor state, decoded to absolute node positions.
+struct NetFrame
+{
+    RoRnet::VehicleState        nf_state;
+    std::vector<Ogre::Vector3>  nf_node_pos;    //!< Nodes up to `Actor::m_net_first_wheel_node`
+    std::vector<Ogre::Vector3>  nf_node_vel;    //!< Average velocity since the previous frame (m/s); ZERO for the first one
+    std::vector<float>          nf_wheel_rp;    //!< Wheel rotations (`wheel_t::wh_net_rp`)
+    std::vector<float>          nf_wheel_vel;   //!< Wheel rotation speed since the previous frame (rad/s)
+    float                       nf_vel_dt = 0.f; //!< Time since the previous frame (s); 0 for the first one, which has no velocity
+};
+
+/// Result of `NetFrameBuffer::Sample()`
+struct NetSample
+{
+    enum Mode
+    {
+        NO_DATA,       //!< Less than 2 frames received, outputs untouched
+        INTERPOLATED,  //!< Sample time is between 2 frames
+        EXTRAPOLATED,  //!< Sample time is past the newest frame, dead-reckoned from its velocity
+        HELD           //!< Sample time is past the extrapolation limit, newest frame extrapolated to the limit
+    };
+
+    Mode                         ns_mode = NO_DATA;
+    RoRnet::VehicleState const*  ns_state1 = nullptr;  //!< Older frame of the window
+    RoRnet::VehicleState const*  ns_state2 = nullptr;  //!< Newer frame of the window
+    float                        ns_tratio = 0.f;      //!< Position of the sample time within the window; >1 when extrapolating
+    int                          ns_frames_before = 0; //!< Frames received before the window; the caller drops them with `PopFront()`
+    int                          ns_frames_after = 0;  //!< Frames received after the window
+};
+
+/// Fixed-capacity ring of preallocated `NetFrame`s; receiving and sampling don't allocate.
+/// Positions are interpolated along a cubic Hermite spline, with tangents estimated from the
+/// neighbour frames (the protocol doesn't transmit velocities): the derivative of the parabola
+/// through 3 frames, so uneven gaps left by lost packets don't skew them. When the stream stalls,
+/// the newest frame is dead-reckoned along its tangent for at most `MAX_EXTRAPOLATION_MS` and then held.
+class NetFrameBuffer
+{
+public:
+    static const int CAPACITY = 32;                 //!< When full, the oldest frame is overwritten
+    static const int MAX_EXTRAPOLATION_MS = 500;
+    static const int MAX_FRAME_GAP_MS = 2000;       //!< Longer gap means the stream restarted; older frames are discarded
+
+    /// Allocates all frames; call once the network buffer layout is known.
+    void             Init(int num_nodes, int num_wheels, float node_compression);
+    /// Decodes a packet laid out by `Actor::sendStreamData()`: node buffer then wheel buffer.
+    /// @return False if the frame isn't newer than the newest one (duplicate or out of order) and was dropped.
+    bool             Push(RoRnet::VehicleState const& state, const char* node_data, const char* wheel_data);
+    /// Evaluates the stream at `time` (remote clock, milliseconds); output arrays are sized by `Init()`.
+    /// Velocities are derivatives of the interpolated positions.
+    NetSample        Sample(int time, Ogre::Vector3* out_node_pos, Ogre::Vector3* out_node_vel, float* out_wheel_rp) const;
+    void             PopFront(int count);
+    void             Clear() { m_first = 0; m_count = 0; }
+
+    int              GetNumFrames() const { return m_count; }
+    NetFrame const&  GetFrame(int i) const { return m_frames[(m_first + i) % CAPACITY]; } //!< 0 is the oldest
+
+private:
+    NetFrame&        GetFrameMutable(int i) { return m_frames[(m_first + i) % CAPACITY]; }
+    /// Velocity of `node` at `frame`; from the segments before and after it, or the 2 before it if `next` is null.
+    static Ogre::Vector3 GetTangent(NetFrame const* prev, NetFrame const& frame, NetFrame const* next, int node);
+
+    std::vector<NetFrame>  m_frames;
+    int                    m_first = 0;
+    int                    m_count = 0;
+    int                    m_num_nodes = 0;
+    int                    m_num_wheels = 0;
+    float                  m_node_compression = 1.f;
+};
+
+/// @}   //addtogroup Network
+
+} // namespace RoR
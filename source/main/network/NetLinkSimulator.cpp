@@ -0,0 +1,165 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "NetLinkSimulator.h"
+
+#include <algorithm>
+
+using namespace RoR;
+
+NetLinkSimulator::NetLinkSimulator(std::unique_ptr<NetTransport> inner, NetLinkParams const& params)
+    : m_inner(std::move(inner))
+    , m_params(params)
+    , m_random(params.nlp_seed)
+{
+}
+
+NetLinkSimulator::~NetLinkSimulator()
+{
+    this->StopDelivery(/*flush=*/false);
+}
+
+bool NetLinkSimulator::Connect(std::string const& host, int port, std::string& out_error)
+{
+    if (!m_inner->Connect(host, port, out_error))
+        return false;
+
+    this->StopDelivery(/*flush=*/false); // In case of reconnect
+    m_stop = false;
+    m_flush = false;
+    m_error.clear();
+    m_link_free_time = Clock::now();
+    m_thread = std::thread(&NetLinkSimulator::DeliveryThread, this);
+    return true;
+}
+
+bool NetLinkSimulator::Send(const char* buffer, int len, std::string& out_error)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_error.empty())
+    {
+        out_error = m_error;
+        return false;
+    }
+    if (!m_thread.joinable() || m_stop)
+    {
+        out_error = "link simulator not connected";
+        return false;
+    }
+
+    // Bandwidth: messages queue up behind each other on the wire
+    const Clock::time_point now = Clock::now();
+    m_link_free_time = std::max(m_link_free_time, now);
+    if (m_params.nlp_bandwidth > 0)
+    {
+        m_link_free_time += std::chrono::microseconds(int64_t(len) * 1000000 / m_params.nlp_bandwidth);
+    }
+
+    int delay_ms = m_params.nlp_latency_ms;
+    if (m_params.nlp_jitter_ms > 0)
+    {
+        delay_ms += std::uniform_int_distribution<int>(0, m_params.nlp_jitter_ms)(m_random);
+    }
+    if (m_params.nlp_reorder_chance > 0.f && std::uniform_real_distribution<float>(0.f, 1.f)(m_random) < m_params.nlp_reorder_chance)
+    {
+        delay_ms += m_params.nlp_reorder_delay_ms;
+    }
+
+    PendingMessage msg;
+    msg.pm_deliver_time = m_link_free_time + std::chrono::milliseconds(delay_ms);
+    msg.pm_seq = m_next_seq++;
+    msg.pm_data.assign(buffer, buffer + len);
+    m_pending.push(std::move(msg));
+
+    lock.unlock();
+    m_cv.notify_one();
+    return true;
+}
+
+void NetLinkSimulator::Disconnect()
+{
+    this->StopDelivery(/*flush=*/true);
+    m_inner->Disconnect();
+}
+
+void NetLinkSimulator::Close()
+{
+    this->StopDelivery(/*flush=*/false);
+    m_inner->Close();
+}
+
+size_t NetLinkSimulator::GetNumPending()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.size();
+}
+
+void NetLinkSimulator::StopDelivery(bool flush)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_flush = flush;
+    }
+    m_cv.notify_one();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending = decltype(m_pending)();
+}
+
+void NetLinkSimulator::DeliveryThread()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        if (m_stop && (!m_flush || m_pending.empty()))
+            break;
+
+        if (m_pending.empty())
+        {
+            m_cv.wait(lock);
+            continue;
+        }
+
+        if (!m_stop && Clock::now() < m_pending.top().pm_deliver_time)
+        {
+            m_cv.wait_until(lock, m_pending.top().pm_deliver_time);
+            continue; // Re-check, an earlier message may have been added meanwhile
+        }
+
+        PendingMessage msg = m_pending.top();
+        m_pending.pop();
+
+        lock.unlock();
+        std::string error;
+        const bool ok = m_inner->Send(msg.pm_data.data(), (int)msg.pm_data.size(), error);
+        lock.lock();
+
+        if (!ok)
+        {
+            m_error = error;
+            m_stop = true;
+            m_flush = false;
+        }
+    }
+}
@@ -0,0 +1,110 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Transport decorator which delays, throttles and reorders outgoing messages, to reproduce bad connections.
+
+#pragma once
+
+#include "NetTransport.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Network
+/// @{
+
+struct NetLinkParams
+{
+    int            nlp_latency_ms = 0;        //!< One way
+    int            nlp_jitter_ms = 0;         //!< Random extra delay, uniform in [0, jitter]
+    int            nlp_bandwidth = 0;         //!< Bytes per second; 0 = unlimited
+    float          nlp_reorder_chance = 0.f;  //!< Probability that a message is held back by `nlp_reorder_delay_ms`, letting later ones overtake it
+    int            nlp_reorder_delay_ms = 50;
+    uint32_t       nlp_seed = 0;              //!< Same seed, same sequence of delays
+};
+
+/// Wraps another transport; `Send()` only schedules the message and a worker thread
+/// passes it on once its delivery time comes. Only outgoing traffic is affected;
+/// to simulate both directions over a loopback, wrap both ends.
+class NetLinkSimulator: public NetTransport
+{
+public:
+    NetLinkSimulator(std::unique_ptr<NetTransport> inner, NetLinkParams const& params);
+    ~NetLinkSimulator();
+
+    bool           Connect(std::string const& host, int port, std::string& out_error) override;
+    /// Errors of the wrapped transport are reported by the next call.
+    bool           Send(const char* buffer, int len, std::string& out_error) override;
+    bool           Receive(char* buffer, int len, std::string& out_error) override { return m_inner->Receive(buffer, len, out_error); }
+    void           SetTimeout(int seconds, int microseconds) override { m_inner->SetTimeout(seconds, microseconds); }
+    /// Delivers the pending messages first.
+    void           Disconnect() override;
+    /// Drops the pending messages.
+    void           Close() override;
+
+    size_t         GetNumPending();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct PendingMessage
+    {
+        Clock::time_point   pm_deliver_time;
+        uint64_t            pm_seq;         //!< Keeps the order of messages with equal delivery time
+        std::vector<char>   pm_data;
+
+        bool operator>(PendingMessage const& other) const
+        {
+            return (pm_deliver_time != other.pm_deliver_time) ? (pm_deliver_time > other.pm_deliver_time) : (pm_seq > other.pm_seq);
+        }
+    };
+
+    void           DeliveryThread();
+    void           StopDelivery(bool flush);
+
+    std::unique_ptr<NetTransport>  m_inner;
+    NetLinkParams                  m_params;
+    std::mt19937                   m_random;
+    Clock::time_point              m_link_free_time;  //!< When the previous message is fully transmitted, for the bandwidth limit
+    uint64_t                       m_next_seq = 0;
+
+    std::priority_queue<PendingMessage, std::vector<PendingMessage>, std::greater<PendingMessage>> m_pending;
+    std::mutex                     m_mutex;
+    std::condition_variable        m_cv;
+    std::thread                    m_thread;
+    bool                           m_stop = false;
+    bool                           m_flush = false;
+    std::string                    m_error;           //!< From the wrapped transport, reported by the next `Send()`
+};
+
+/// @}   //addtogroup Network
+
+} // namespace RoR
@@ -0,0 +1,194 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "NetTransport.h"
+
+#include <chrono>
+#include <cstring>
+
+using namespace RoR;
+
+#ifdef USE_SOCKETW
+
+// --------------------------------
+// TcpTransport
+
+bool TcpTransport::Connect(std::string const& host, int port, std::string& out_error)
+{
+    SWBaseSocket::SWBaseError error;
+    m_socket = SWInetSocket();
+    m_socket.set_timeout(m_timeout_sec, m_timeout_usec);
+    m_socket.connect(port, host, &error);
+    if (error != SWBaseSocket::ok)
+    {
+        out_error = error.get_error();
+        return false;
+    }
+    return true;
+}
+
+bool TcpTransport::Send(const char* buffer, int len, std::string& out_error)
+{
+    SWBaseSocket::SWBaseError error;
+    if (m_socket.fsend(buffer, len, &error) < len)
+    {
+        out_error = error.get_error();
+        return false;
+    }
+    return true;
+}
+
+bool TcpTransport::Receive(char* buffer, int len, std::string& out_error)
+{
+    SWBaseSocket::SWBaseError error;
+    if (m_socket.frecv(buffer, len, &error) < len)
+    {
+        out_error = error.get_error();
+        return false;
+    }
+    return true;
+}
+
+void TcpTransport::SetTimeout(int seconds, int microseconds)
+{
+    m_timeout_sec = seconds;
+    m_timeout_usec = microseconds;
+    m_socket.set_timeout(seconds, microseconds);
+}
+
+void TcpTransport::Disconnect()
+{
+    m_socket.disconnect();
+}
+
+void TcpTransport::Close()
+{
+    m_socket.close_fd();
+}
+
+#endif // USE_SOCKETW
+
+// --------------------------------
+// LoopbackTransport
+
+void LoopbackTransport::CreatePair(std::unique_ptr<LoopbackTransport>& out_a, std::unique_ptr<LoopbackTransport>& out_b)
+{
+    std::shared_ptr<Pipe> a_to_b = std::make_shared<Pipe>();
+    std::shared_ptr<Pipe> b_to_a = std::make_shared<Pipe>();
+
+    out_a.reset(new LoopbackTransport());
+    out_a->m_out = a_to_b;
+    out_a->m_in = b_to_a;
+
+    out_b.reset(new LoopbackTransport());
+    out_b->m_out = b_to_a;
+    out_b->m_in = a_to_b;
+}
+
+bool LoopbackTransport::Connect(std::string const& host, int port, std::string& out_error)
+{
+    std::lock_guard<std::mutex> lock(m_out->lp_mutex);
+    if (m_out->lp_closed)
+    {
+        out_error = "loopback closed";
+        return false;
+    }
+    return true;
+}
+
+bool LoopbackTransport::Send(const char* buffer, int len, std::string& out_error)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_out->lp_mutex);
+        if (m_out->lp_closed)
+        {
+            out_error = "loopback closed";
+            return false;
+        }
+        m_out->lp_data.insert(m_out->lp_data.end(), buffer, buffer + len);
+    }
+    m_out->lp_cv.notify_all();
+    return true;
+}
+
+bool LoopbackTransport::Receive(char* buffer, int len, std::string& out_error)
+{
+    std::unique_lock<std::mutex> lock(m_in->lp_mutex);
+    auto is_ready = [this, len]() { return m_in->lp_closed || (m_in->lp_data.size() - m_in->lp_read_pos) >= size_t(len); };
+
+    // `SetTimeout()` wakes us up, so a timeout set while waiting takes effect right away (like `Network::Disconnect()` does)
+    std::chrono::steady_clock::time_point deadline;
+    bool has_deadline = false;
+    while (!is_ready())
+    {
+        if (!has_deadline && m_timeout_ms > 0)
+        {
+            deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_timeout_ms);
+            has_deadline = true;
+        }
+
+        if (!has_deadline)
+        {
+            m_in->lp_cv.wait(lock);
+        }
+        else if (m_in->lp_cv.wait_until(lock, deadline) == std::cv_status::timeout && !is_ready())
+        {
+            out_error = "loopback timeout";
+            return false;
+        }
+    }
+
+    if ((m_in->lp_data.size() - m_in->lp_read_pos) < size_t(len))
+    {
+        out_error = "loopback closed";
+        return false;
+    }
+
+    std::memcpy(buffer, m_in->lp_data.data() + m_in->lp_read_pos, len);
+    m_in->lp_read_pos += len;
+
+    // Compact once the consumed part dominates, so the buffer doesn't grow forever
+    if (m_in->lp_read_pos > m_in->lp_data.size() / 2)
+    {
+        m_in->lp_data.erase(m_in->lp_data.begin(), m_in->lp_data.begin() + m_in->lp_read_pos);
+        m_in->lp_read_pos = 0;
+    }
+    return true;
+}
+
+void LoopbackTransport::SetTimeout(int seconds, int microseconds)
+{
+    m_timeout_ms = seconds * 1000 + microseconds / 1000;
+    {
+        std::lock_guard<std::mutex> lock(m_in->lp_mutex); // Don't notify between the waiter's check and wait
+    }
+    m_in->lp_cv.notify_all();
+}
+
+void LoopbackTransport::Disconnect()
+{
+    for (Pipe* pipe: { m_in.get(), m_out.get() })
+    {
+        {
+            std::lock_guard<std::mutex> lock(pipe->lp_mutex);
+            pipe->lp_closed = true;
+        }
+        pipe->lp_cv.notify_all();
+    }
+}
@@ -0,0 +1,113 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Byte stream between `Network` and a RoRnet server: TCP for real games, in-memory loopback for tests and benchmarks.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef USE_SOCKETW
+#include <SocketW.h>
+#endif
+
+namespace RoR {
+
+/// @addtogroup Network
+/// @{
+
+/// Interface used by `Network`'s connect/send/receive threads. One `Send()` call always carries
+/// one whole RoRnet message (header + payload), so implementations may treat it as a unit.
+class NetTransport
+{
+public:
+    virtual ~NetTransport() {}
+
+    virtual bool   Connect(std::string const& host, int port, std::string& out_error) = 0;
+    /// Sends all of `len` bytes. @return False on error.
+    virtual bool   Send(const char* buffer, int len, std::string& out_error) = 0;
+    /// Blocks until exactly `len` bytes were received, the timeout expired or the connection closed.
+    virtual bool   Receive(char* buffer, int len, std::string& out_error) = 0;
+    /// Applies to blocking calls, including one already waiting; 0 means wait forever.
+    virtual void   SetTimeout(int seconds, int microseconds) = 0;
+    /// Graceful shutdown.
+    virtual void   Disconnect() = 0;
+    /// Immediate shutdown, for when the connection is already broken.
+    virtual void   Close() = 0;
+};
+
+#ifdef USE_SOCKETW
+
+/// The real thing, via SocketW.
+class TcpTransport: public NetTransport
+{
+public:
+    bool           Connect(std::string const& host, int port, std::string& out_error) override;
+    bool           Send(const char* buffer, int len, std::string& out_error) override;
+    bool           Receive(char* buffer, int len, std::string& out_error) override;
+    void           SetTimeout(int seconds, int microseconds) override;
+    void           Disconnect() override;
+    void           Close() override;
+
+private:
+    SWInetSocket   m_socket;
+    int            m_timeout_sec = 0;  //!< Reapplied to the new socket in `Connect()`
+    int            m_timeout_usec = 0;
+};
+
+#endif // USE_SOCKETW
+
+/// In-process pipe; bytes sent on one end are received on the other.
+/// `Connect()` succeeds for any host/port as long as the other end is open.
+class LoopbackTransport: public NetTransport
+{
+public:
+    static void    CreatePair(std::unique_ptr<LoopbackTransport>& out_a, std::unique_ptr<LoopbackTransport>& out_b);
+
+    bool           Connect(std::string const& host, int port, std::string& out_error) override;
+    bool           Send(const char* buffer, int len, std::string& out_error) override;
+    bool           Receive(char* buffer, int len, std::string& out_error) override;
+    void           SetTimeout(int seconds, int microseconds) override;
+    void           Disconnect() override;
+    void           Close() override { this->Disconnect(); }
+
+private:
+    struct Pipe
+    {
+        std::mutex               lp_mutex;
+        std::condition_variable  lp_cv;
+        std::vector<char>        lp_data;
+        size_t                   lp_read_pos = 0;  //!< Bytes before it were received already
+        bool                     lp_closed = false;
+    };
+
+    std::shared_ptr<Pipe>  m_in;
+    std::shared_ptr<Pipe>  m_out;
+    std::atomic<int>       m_timeout_ms{0};
+};
+
+/// @}   //addtogroup Network
+
+} // namespace RoR
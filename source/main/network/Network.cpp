@@ -31,12 +31,12 @@
 #include "GUIManager.h"
 #include "GUI_TopMenubar.h"
 #include "Language.h"
+#include "NetTransport.h"
 #include "RoRVersion.h"
 #include "ScriptEngine.h"
 #include "Utils.h"
 
 #include <Ogre.h>
-#include <SocketW.h>
 
 #include <algorithm>
 #include <chrono>
@@ -126,11 +126,11 @@ int Network::GetUID()
 
 bool Network::SendMessageRaw(char *buffer, int msgsize)
 {
-    SWBaseSocket::SWBaseError error;
+    std::string error;
 
-    if (m_socket.fsend(buffer, msgsize, &error) < msgsize)
+    if (!m_transport->Send(buffer, msgsize, error))
     {
-        LOG("NET send error: " + error.get_error());
+        LOG("NET send error: " + error);
         return false;
     }
 
@@ -172,15 +172,15 @@ void Network::QueueStreamData(RoRnet::Header &header, char *buffer, size_t buffe
 
 int Network::ReceiveMessage(RoRnet::Header *head, char* content, int bufferlen)
 {
-    SWBaseSocket::SWBaseError error;
+    std::string error;
 
 #ifdef DEBUG
 	LOG_THREAD("[RoR|Networking] ReceiveMessage() waiting...");
 #endif //DEBUG
 
-    if (m_socket.frecv((char*)head, sizeof(RoRnet::Header), &error) < sizeof(RoRnet::Header))
+    if (!m_transport->Receive((char*)head, sizeof(RoRnet::Header), error))
     {
-        LOG("NET receive error 1: " + error.get_error());
+        LOG("NET receive error 1: " + error);
         return -1;
     }
 
@@ -197,9 +197,9 @@ int Network::ReceiveMessage(RoRnet::Header *head, char* content, int bufferlen)
     {
         // Read the packet content
         std::memset(content, 0, bufferlen);
-        if (m_socket.frecv(content, head->size, &error) < static_cast<int>(head->size))
+        if (!m_transport->Receive(content, head->size, error))
         {
-            LOG_THREAD("NET receive error 2: "+ error.get_error());
+            LOG_THREAD("NET receive error 2: "+ error);
             return -1;
         }
     }
@@ -380,8 +380,8 @@ void Network::CouldNotConnect(std::string const & msg, bool close_socket /*= tru
 
     if (close_socket)
     {
-        m_socket.set_timeout(1, 0);
-        m_socket.disconnect();
+        m_transport->SetTimeout(1, 0);
+        m_transport->Disconnect();
     }
 }
 
@@ -394,6 +394,11 @@ bool Network::StartConnecting()
     m_net_port = App::mp_server_port->getInt();
     m_password = App::mp_server_password->getStr();
 
+    if (m_next_transport)
+        m_transport = std::move(m_next_transport);
+    else
+        m_transport.reset(new TcpTransport());
+
     try
     {
         m_connect_thread = std::thread(&Network::ConnectThread, this);
@@ -420,14 +425,13 @@ bool Network::ConnectThread()
 {
     RoR::LogFormat("[RoR|Networking] Trying to join server '%s' on port '%d' ...", m_net_host.c_str(), m_net_port);
 
-    SWBaseSocket::SWBaseError error;
+    std::string error;
 
     PushNetMessage(MSG_NET_CONNECT_PROGRESS, _LC("Network", "Estabilishing connection..."));
-    m_socket = SWInetSocket();
-    m_socket.set_timeout(10, 0);
-    m_socket.connect(m_net_port, m_net_host, &error);
-    if (error != SWBaseSocket::ok)
+    m_transport->SetTimeout(10, 0);
+    if (!m_transport->Connect(m_net_host, m_net_port, error))
     {
+        RoR::LogFormat("[RoR|Networking] Connect error: %s", error.c_str());
         CouldNotConnect(_L("Could not create connection"), false);
         return false;
     }
@@ -485,7 +489,7 @@ bool Network::ConnectThread()
     PushNetMessage(MSG_NET_CONNECT_PROGRESS, _LC("Network", "Authorizing..."));
 
     // First handshake done, increase the timeout, important!
-    m_socket.set_timeout(0, 0);
+    m_transport->SetTimeout(0, 0);
 
     // Construct user credentials
     // Beware of the wchar_t converted to UTF8 for networking
@@ -521,7 +525,7 @@ bool Network::ConnectThread()
     }
     else if (header.command==MSG2_BANNED)
     {
-        // Do NOT `disconnect()` the m_socket in this case - causes SocketW to terminate RoR.
+        // Do NOT `Disconnect()` the m_transport in this case - causes SocketW to terminate RoR.
         CouldNotConnect(_L("Establishing network session: sorry, you are banned!"), /*close_socket=*/false);
         return false;
     }
@@ -571,7 +575,7 @@ void Network::Disconnect()
     m_send_thread.join();
     LOG("[RoR|Networking] Disconnect() sender thread cleaned up");
 
-    m_socket.set_timeout(1, 0);
+    m_transport->SetTimeout(1, 0);
 
     if (is_clean_disconnect)
     {
@@ -583,11 +587,11 @@ void Network::Disconnect()
 
     if (is_clean_disconnect)
     {
-        m_socket.disconnect();
+        m_transport->Disconnect();
     }
     else
     {
-        m_socket.close_fd();
+        m_transport->Close();
     }
 
     SetNetQuality(0);
@@ -24,14 +24,14 @@
 #ifdef USE_SOCKETW
 
 #include "Application.h"
+#include "NetTransport.h"
 #include "RoRnet.h"
 
-#include <SocketW.h>
-
 #include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
@@ -107,6 +107,8 @@ public:
     bool                 StartConnecting();    //!< Launches connecting on background.
     void                 StopConnecting();
     void                 Disconnect();
+    /// Used by the next `StartConnecting()` instead of TCP; for loopback tests and benchmarks, see `LoopbackTransport`, `NetLinkSimulator`.
+    void                 SetNextTransport(std::unique_ptr<NetTransport> transport) { m_next_transport = std::move(transport); }
 
     void                 AddPacket(int streamid, int type, int len, const char *content);
     void                 AddLocalStream(RoRnet::StreamRegister *reg, int size);
@@ -149,7 +151,8 @@ private:
 
     // Variables
 
-    SWInetSocket         m_socket;
+    std::unique_ptr<NetTransport> m_transport;
+    std::unique_ptr<NetTransport> m_next_transport;
 
     RoRnet::ServerInfo   m_server_settings;
     RoRnet::UserInfo     m_userdata;
@@ -27,6 +27,7 @@
 #include "AutoPilot.h"
 #include "SimData.h"
 #include "ActorManager.h"
+#include "ActorPlacement.h"
 #include "Buoyance.h"
 #include "CacheSystem.h"
 #include "ChatSystem.h"
@@ -139,6 +140,10 @@ void Actor::dispose()
         delete m_replay_handler;
     m_replay_handler = nullptr;
 
+#ifdef USE_ANGELSCRIPT
+    if (ar_vehicle_ai)
+        ar_vehicle_ai->releaseRoute(); // The lane graph is shared; a script may keep the agent alive
+#endif // USE_ANGELSCRIPT
     ar_vehicle_ai = nullptr; // RefCountingObjectPtr<> will handle the cleanup.
 
     // remove all scene nodes
@@ -281,31 +286,42 @@ void Actor::dispose()
     if (m_transfer_case)
         delete m_transfer_case;
 
-    for (int i = 0; i < m_num_axle_diffs; ++i)
-    {
-        if (m_axle_diffs[i] != nullptr)
-            delete m_axle_diffs[i];
-    }
-    m_num_axle_diffs = 0;
+    m_drivetrain_solver.Clear();
 
-    for (int i = 0; i < m_num_wheel_diffs; ++i)
-    {
-        if (m_wheel_diffs[i] != nullptr)
-            delete m_wheel_diffs[i];
-    }
-    m_num_wheel_diffs = 0;
+    for (Differential* diff: m_axle_diffs)
+        delete diff;
+    m_axle_diffs.clear();
+
+    for (Differential* diff: m_wheel_diffs)
+        delete diff;
+    m_wheel_diffs.clear();
 
-    delete[] ar_nodes;
+    // All fixed-size simulation arrays go with the arena in one free.
+    m_arena.Release();
+    ar_nodes = nullptr;
+    ar_nodes_id = nullptr;
+    ar_nodes_name = nullptr;
     ar_num_nodes = 0;
     m_wheel_node_count = 0;
-    delete[] ar_beams;
+    ar_beams = nullptr;
     ar_num_beams = 0;
-    delete[] ar_shocks;
+    ar_shocks = nullptr;
     ar_num_shocks = 0;
-    delete[] ar_rotators;
+    ar_hydros = nullptr;
+    ar_num_hydros = 0;
+    ar_rotators = nullptr;
     ar_num_rotators = 0;
-    delete[] ar_wings;
+    ar_wings = nullptr;
     ar_num_wings = 0;
+    ar_cabs = nullptr;
+    ar_num_cabs = 0;
+    ar_collcabs = nullptr;
+    ar_inter_collcabrate = nullptr;
+    ar_intra_collcabrate = nullptr;
+    ar_num_collcabs = 0;
+    ar_buoycabs = nullptr;
+    ar_buoycab_types = nullptr;
+    ar_num_buoycabs = 0;
 
     ar_state = ActorState::DISPOSED;
 }
@@ -329,10 +345,10 @@ void Actor::scaleTruck(float value)
         ar_beams[i].refL *= value;
     }
     // scale hydros
-    for (hydrobeam_t& hbeam: ar_hydros)
+    for (int i = 0; i < ar_num_hydros; i++)
     {
-        hbeam.hb_ref_length *= value;
-        hbeam.hb_speed *= value;
+        ar_hydros[i].hb_ref_length *= value;
+        ar_hydros[i].hb_speed *= value;
     }
     // scale nodes
     Vector3 refpos = ar_nodes[0].AbsPosition;
@@ -383,11 +399,9 @@ Ogre::Quaternion  Actor::getOrientation()
 void Actor::pushNetwork(char* data, int size)
 {
 #if USE_SOCKETW
-    NetUpdate update;
-
-    update.veh_state.resize(sizeof(RoRnet::VehicleState));
-    update.node_data.resize(m_net_node_buf_size);
-    update.wheel_data.resize(ar_num_wheels * sizeof(float));
+    RoRnet::VehicleState state;
+    const char* node_data = nullptr;
+    const char* wheel_data = nullptr;
 
     // check if the size of the data matches to what we expected
     if ((unsigned int)size == (m_net_total_buffer_size + sizeof(RoRnet::VehicleState)))
@@ -396,20 +410,14 @@ void Actor::pushNetwork(char* data, int size)
         char* ptr = data;
 
         // put the RoRnet::VehicleState in front, describes actor basics, engine state, flares, etc
-        memcpy(update.veh_state.data(), ptr, sizeof(RoRnet::VehicleState));
+        memcpy(&state, ptr, sizeof(RoRnet::VehicleState));
         ptr += sizeof(RoRnet::VehicleState);
 
-        // then copy the node data
-        memcpy(update.node_data.data(), ptr, m_net_node_buf_size);
+        // then the node data and wheel speeds, decoded by the frame buffer
+        node_data = ptr;
         ptr += m_net_node_buf_size;
-
-        // then take care of the wheel speeds
-        for (int i = 0; i < ar_num_wheels; i++)
-        {
-            float wspeed = *(float*)(ptr);
-            update.wheel_data[i] = wspeed;
-            ptr += sizeof(float);
-        }
+        wheel_data = ptr;
+        ptr += m_net_wheel_buf_size;
 
         // then process the prop animation keys
         for (size_t i = 0; i < m_prop_anim_key_states.size(); i++)
@@ -455,16 +463,15 @@ void Actor::pushNetwork(char* data, int size)
     // Required to catch up when joining late (since the StreamRegister time stamp is received delayed)
     if (!m_net_initialized)
     {
-        RoRnet::VehicleState* oob = (RoRnet::VehicleState*)update.veh_state.data();
         int tnow = App::GetGameContext()->GetActorManager()->GetNetTime();
         int rnow = std::max(0, tnow + App::GetGameContext()->GetActorManager()->GetNetTimeOffset(ar_net_source_id));
-        if (oob->time > rnow + 100)
+        if (state.time > rnow + 100)
         {
-            App::GetGameContext()->GetActorManager()->UpdateNetTimeOffset(ar_net_source_id, oob->time - rnow);
+            App::GetGameContext()->GetActorManager()->UpdateNetTimeOffset(ar_net_source_id, state.time - rnow);
         }
     }
 
-    m_net_updates.push_back(update);
+    m_net_frames.Push(state, node_data, wheel_data);
 #endif // USE_SOCKETW
 }
 
@@ -472,126 +479,79 @@ void Actor::calcNetwork()
 {
     using namespace RoRnet;
 
-    if (m_net_updates.size() < 2)
-        return;
-
     int tnow = App::GetGameContext()->GetActorManager()->GetNetTime();
     int rnow = std::max(0, tnow + App::GetGameContext()->GetActorManager()->GetNetTimeOffset(ar_net_source_id));
 
-    // Find index offset into the stream data for the current time
-    int index_offset = 0;
-    for (int i = 0; i < m_net_updates.size() - 1; i++)
-    {
-        VehicleState* oob = (VehicleState*)m_net_updates[i].veh_state.data();
-        if (oob->time > rnow)
-            break;
-        index_offset = i;
-    }
-
-    VehicleState* oob1 = (VehicleState*)m_net_updates[index_offset    ].veh_state.data();
-    VehicleState* oob2 = (VehicleState*)m_net_updates[index_offset + 1].veh_state.data();
-    char*        netb1 = (char*)        m_net_updates[index_offset    ].node_data.data();
-    char*        netb2 = (char*)        m_net_updates[index_offset + 1].node_data.data();
-    float*     net_rp1 = (float*)       m_net_updates[index_offset    ].wheel_data.data();
-    float*     net_rp2 = (float*)       m_net_updates[index_offset + 1].wheel_data.data();
-
-    float tratio = (float)(rnow - oob1->time) / (float)(oob2->time - oob1->time);
+    const NetSample sample = m_net_frames.Sample(rnow, m_net_node_pos.data(), m_net_node_vel.data(), m_net_wheel_rp.data());
+    if (sample.ns_mode == NetSample::NO_DATA)
+        return;
 
-    if (tratio > 4.0f)
-    {
-        m_net_updates.clear();
-        return; // Wait for new data
-    }
-    else if (tratio > 1.0f)
+    if (sample.ns_mode == NetSample::EXTRAPOLATED)
     {
-        App::GetGameContext()->GetActorManager()->UpdateNetTimeOffset(ar_net_source_id, -std::pow(2, tratio));
+        App::GetGameContext()->GetActorManager()->UpdateNetTimeOffset(ar_net_source_id, -std::pow(2, std::min(sample.ns_tratio, 4.0f)));
     }
-    else if (index_offset == 0 && (m_net_updates.size() > 5 || (tratio < 0.125f && m_net_updates.size() > 2)))
+    else if (sample.ns_mode == NetSample::INTERPOLATED && sample.ns_frames_before == 0 &&
+             (m_net_frames.GetNumFrames() > 5 || (sample.ns_tratio < 0.125f && m_net_frames.GetNumFrames() > 2)))
     {
         App::GetGameContext()->GetActorManager()->UpdateNetTimeOffset(ar_net_source_id, +1);
     }
 
-    short* sp1 = (short*)(netb1 + sizeof(float) * 3);
-    short* sp2 = (short*)(netb2 + sizeof(float) * 3);
-    Vector3 p1ref = Vector3::ZERO;
-    Vector3 p2ref = Vector3::ZERO;
-    Vector3 p1 = Vector3::ZERO;
-    Vector3 p2 = Vector3::ZERO;
-
     for (int i = 0; i < m_net_first_wheel_node; i++)
     {
-        if (i == 0)
-        {
-            // first node is uncompressed
-            p1.x = ((float*)netb1)[0];
-            p1.y = ((float*)netb1)[1];
-            p1.z = ((float*)netb1)[2];
-            p1ref = p1;
-
-            p2.x = ((float*)netb2)[0];
-            p2.y = ((float*)netb2)[1];
-            p2.z = ((float*)netb2)[2];
-            p2ref = p2;
-        }
-        else
-        {
-            // all other nodes are compressed:
-            // short int compared to previous node
-            p1.x = (float)(sp1[(i - 1) * 3 + 0]) / m_net_node_compression;
-            p1.y = (float)(sp1[(i - 1) * 3 + 1]) / m_net_node_compression;
-            p1.z = (float)(sp1[(i - 1) * 3 + 2]) / m_net_node_compression;
-            p1 = p1 + p1ref;
-
-            p2.x = (float)(sp2[(i - 1) * 3 + 0]) / m_net_node_compression;
-            p2.y = (float)(sp2[(i - 1) * 3 + 1]) / m_net_node_compression;
-            p2.z = (float)(sp2[(i - 1) * 3 + 2]) / m_net_node_compression;
-            p2 = p2 + p2ref;
-        }
-
-        // linear interpolation
-        ar_nodes[i].AbsPosition = p1 + tratio * (p2 - p1);
+        ar_nodes[i].AbsPosition = m_net_node_pos[i];
         ar_nodes[i].RelPosition = ar_nodes[i].AbsPosition - ar_origin;
-        ar_nodes[i].Velocity    = (p2 - p1) * 1000.0f / (float)(oob2->time - oob1->time);
+        ar_nodes[i].Velocity    = m_net_node_vel[i];
     }
 
     for (int i = 0; i < ar_num_wheels; i++)
     {
-        float rp = net_rp1[i] + tratio * (net_rp2[i] - net_rp1[i]);
+        wheel_t& wheel = ar_wheels[i];
         //compute ideal positions
-        Vector3 axis = ar_wheels[i].wh_axis_node_1->RelPosition - ar_wheels[i].wh_axis_node_0->RelPosition;
+        Vector3 axis = wheel.wh_axis_node_1->RelPosition - wheel.wh_axis_node_0->RelPosition;
         axis.normalise();
-        Plane pplan = Plane(axis, ar_wheels[i].wh_axis_node_0->AbsPosition);
-        Vector3 ortho = -pplan.projectVector(ar_wheels[i].wh_near_attach_node->AbsPosition) - ar_wheels[i].wh_axis_node_0->AbsPosition;
+        Plane pplan = Plane(axis, wheel.wh_axis_node_0->AbsPosition);
+        Vector3 ortho = -pplan.projectVector(wheel.wh_near_attach_node->AbsPosition) - wheel.wh_axis_node_0->AbsPosition;
         Vector3 ray = ortho.crossProduct(axis);
         ray.normalise();
-        ray *= ar_wheels[i].wh_radius;
-        float drp = Math::TWO_PI / (ar_wheels[i].wh_num_nodes / 2);
-        for (int j = 0; j < ar_wheels[i].wh_num_nodes / 2; j++)
+
+        // Tyre and rim nodes share the angles; rotate one direction step by step
+        const float drp = Math::TWO_PI / (wheel.wh_num_nodes / 2);
+        const Quaternion step(Radian(-drp), axis);
+        Vector3 dir = Quaternion(Radian(m_net_wheel_rp[i]), axis) * ray;
+        const int num_steps = std::max(wheel.wh_num_nodes, wheel.wh_num_rim_nodes) / 2;
+        for (int j = 0; j < num_steps; j++)
         {
-            Vector3 uray = Quaternion(Radian(rp - drp * j), axis) * ray;
+            if (j < wheel.wh_num_nodes / 2)
+            {
+                Vector3 uray = dir * wheel.wh_radius;
 
-            ar_wheels[i].wh_nodes[j * 2 + 0]->AbsPosition = ar_wheels[i].wh_axis_node_0->AbsPosition + uray;
-            ar_wheels[i].wh_nodes[j * 2 + 0]->RelPosition = ar_wheels[i].wh_nodes[j * 2]->AbsPosition - ar_origin;
+                wheel.wh_nodes[j * 2 + 0]->AbsPosition = wheel.wh_axis_node_0->AbsPosition + uray;
+                wheel.wh_nodes[j * 2 + 0]->RelPosition = wheel.wh_nodes[j * 2]->AbsPosition - ar_origin;
 
-            ar_wheels[i].wh_nodes[j * 2 + 1]->AbsPosition = ar_wheels[i].wh_axis_node_1->AbsPosition + uray;
-            ar_wheels[i].wh_nodes[j * 2 + 1]->RelPosition = ar_wheels[i].wh_nodes[j * 2 + 1]->AbsPosition - ar_origin;
-        }
-        ray.normalise();
-        ray *= ar_wheels[i].wh_rim_radius;
-        for (int j = 0; j < ar_wheels[i].wh_num_rim_nodes / 2; j++)
-        {
-            Vector3 uray = Quaternion(Radian(rp - drp * j), axis) * ray;
+                wheel.wh_nodes[j * 2 + 1]->AbsPosition = wheel.wh_axis_node_1->AbsPosition + uray;
+                wheel.wh_nodes[j * 2 + 1]->RelPosition = wheel.wh_nodes[j * 2 + 1]->AbsPosition - ar_origin;
+            }
+            if (j < wheel.wh_num_rim_nodes / 2)
+            {
+                Vector3 uray = dir * wheel.wh_rim_radius;
 
-            ar_wheels[i].wh_rim_nodes[j * 2 + 0]->AbsPosition = ar_wheels[i].wh_axis_node_0->AbsPosition + uray;
-            ar_wheels[i].wh_rim_nodes[j * 2 + 0]->RelPosition = ar_wheels[i].wh_rim_nodes[j * 2]->AbsPosition - ar_origin;
+                wheel.wh_rim_nodes[j * 2 + 0]->AbsPosition = wheel.wh_axis_node_0->AbsPosition + uray;
+                wheel.wh_rim_nodes[j * 2 + 0]->RelPosition = wheel.wh_rim_nodes[j * 2]->AbsPosition - ar_origin;
 
-            ar_wheels[i].wh_rim_nodes[j * 2 + 1]->AbsPosition = ar_wheels[i].wh_axis_node_1->AbsPosition + uray;
-            ar_wheels[i].wh_rim_nodes[j * 2 + 1]->RelPosition = ar_wheels[i].wh_rim_nodes[j * 2 + 1]->AbsPosition - ar_origin;
+                wheel.wh_rim_nodes[j * 2 + 1]->AbsPosition = wheel.wh_axis_node_1->AbsPosition + uray;
+                wheel.wh_rim_nodes[j * 2 + 1]->RelPosition = wheel.wh_rim_nodes[j * 2 + 1]->AbsPosition - ar_origin;
+            }
+            dir = step * dir;
         }
     }
     this->UpdateBoundingBoxes();
     this->calculateAveragePosition();
 
+    // Scalar states are not extrapolated
+    const VehicleState* oob1 = sample.ns_state1;
+    const VehicleState* oob2 = sample.ns_state2;
+    const float tratio = std::max(0.f, std::min(sample.ns_tratio, 1.f));
+
     float engspeed = oob1->engine_speed + tratio * (oob2->engine_speed - oob1->engine_speed);
     float engforce = oob1->engine_force + tratio * (oob2->engine_force - oob1->engine_force);
     float engclutch = oob1->engine_clutch + tratio * (oob2->engine_clutch - oob1->engine_clutch);
@@ -654,10 +614,7 @@ void Actor::calcNetwork()
     else
         SOUND_STOP(ar_instance_id, SS_TRIG_REVERSE_GEAR);
 
-    for (int i = 0; i < index_offset; i++)
-    {
-        m_net_updates.pop_front();
-    }
+    m_net_frames.PopFront(sample.ns_frames_before);
 
     m_net_initialized = true;
 }
@@ -836,197 +793,70 @@ void Actor::calcNodeConnectivityGraph()
     }
 }
 
-bool Actor::Intersects(ActorPtr actor, Vector3 offset)
+/// Snapshot of `actor` for `ActorPlacement`
+static ActorPlacement::Shape GetPlacementShape(ActorPtr const& actor)
 {
-    Vector3 bb_min = ar_bounding_box.getMinimum() + offset;
-    Vector3 bb_max = ar_bounding_box.getMaximum() + offset;
-    AxisAlignedBox bb = AxisAlignedBox(bb_min, bb_max);
+    ActorPlacement::Shape shape;
+    shape.sh_box_min = actor->ar_bounding_box.getMinimum();
+    shape.sh_box_max = actor->ar_bounding_box.getMaximum();
+    shape.sh_collision_range = actor->ar_collision_range;
+    shape.sh_min_camera_radius = actor->getMinCameraRadius();
 
-    if (!bb.intersects(actor->ar_bounding_box))
-        return false;
-
-    // Test own (contactable) beams against others cabs
-    for (int i = 0; i < ar_num_beams; i++)
+    for (int i = 0; i < actor->ar_num_nodes; i++)
     {
-        if (!(ar_beams[i].p1->nd_contacter || ar_beams[i].p1->nd_contactable) ||
-            !(ar_beams[i].p2->nd_contacter || ar_beams[i].p2->nd_contactable))
-            continue;
-
-        Vector3 origin = ar_beams[i].p1->AbsPosition + offset;
-        Vector3 target = ar_beams[i].p2->AbsPosition + offset;
-
-        Ray ray(origin, target - origin);
-
-        for (int j = 0; j < actor->ar_num_collcabs; j++)
+        if (actor->ar_nodes[i].nd_contacter || actor->ar_nodes[i].nd_contactable)
         {
-            int index = actor->ar_collcabs[j] * 3;
-            Vector3 a = actor->ar_nodes[actor->ar_cabs[index + 0]].AbsPosition;
-            Vector3 b = actor->ar_nodes[actor->ar_cabs[index + 1]].AbsPosition;
-            Vector3 c = actor->ar_nodes[actor->ar_cabs[index + 2]].AbsPosition;
+            shape.sh_nodes.push_back(actor->ar_nodes[i].AbsPosition);
+            shape.sh_node_contacter.push_back(actor->ar_nodes[i].nd_contacter);
+        }
+    }
 
-            auto result = Ogre::Math::intersects(ray, a, b, c);
-            if (result.first && result.second < 1.0f)
-            {
-                return true;
-            }
+    shape.sh_cabs.reserve(actor->ar_num_collcabs * 3);
+    for (int i = 0; i < actor->ar_num_collcabs; i++)
+    {
+        const int tmpv = actor->ar_collcabs[i] * 3;
+        for (int k = 0; k < 3; k++)
+        {
+            shape.sh_cabs.push_back(actor->ar_nodes[actor->ar_cabs[tmpv + k]].AbsPosition);
         }
     }
 
-    // Test own cabs against others (contactable) beams
     for (int i = 0; i < actor->ar_num_beams; i++)
     {
-        if (!(actor->ar_beams[i].p1->nd_contacter || actor->ar_beams[i].p1->nd_contactable) ||
-            !(actor->ar_beams[i].p2->nd_contacter || actor->ar_beams[i].p2->nd_contactable))
-            continue;
-
-        Vector3 origin = actor->ar_beams[i].p1->AbsPosition;
-        Vector3 target = actor->ar_beams[i].p2->AbsPosition;
-
-        Ray ray(origin, target - origin);
-
-        for (int j = 0; j < ar_num_collcabs; j++)
+        const beam_t& beam = actor->ar_beams[i];
+        if ((beam.p1->nd_contacter || beam.p1->nd_contactable) &&
+            (beam.p2->nd_contacter || beam.p2->nd_contactable))
         {
-            int index = ar_collcabs[j] * 3;
-            Vector3 a = ar_nodes[ar_cabs[index + 0]].AbsPosition + offset;
-            Vector3 b = ar_nodes[ar_cabs[index + 1]].AbsPosition + offset;
-            Vector3 c = ar_nodes[ar_cabs[index + 2]].AbsPosition + offset;
-
-            auto result = Ogre::Math::intersects(ray, a, b, c);
-            if (result.first && result.second < 1.0f)
-            {
-                return true;
-            }
+            shape.sh_beams.push_back(beam.p1->AbsPosition);
+            shape.sh_beams.push_back(beam.p2->AbsPosition);
         }
     }
 
-    return false;
+    return shape;
 }
 
-Vector3 Actor::calculateCollisionOffset(Vector3 direction)
+/// Adds every actor which `actor` can touch while moving by up to `max_distance`
+static void AddPlacementObstacles(ActorPlacement& placement, ActorPtr const& actor)
 {
-    if (direction == Vector3::ZERO)
-        return Vector3::ZERO;
-
-    Real max_distance = direction.normalise();
-
-    // collision displacement
-    Vector3 collision_offset = Vector3::ZERO;
-
-    while (collision_offset.length() < max_distance)
+    for (ActorPtr const& other : App::GetGameContext()->GetActorManager()->GetActors())
     {
-        Vector3 bb_min = ar_bounding_box.getMinimum() + collision_offset;
-        Vector3 bb_max = ar_bounding_box.getMaximum() + collision_offset;
-        AxisAlignedBox bb = AxisAlignedBox(bb_min, bb_max);
-
-        bool collision = false;
-
-        for (ActorPtr& actor : App::GetGameContext()->GetActorManager()->GetActors())
-        {
-            if (actor == this)
-                continue;
-            if (!bb.intersects(actor->ar_bounding_box))
-                continue;
-
-            // Test own contactables against others cabs
-            if (m_intra_point_col_detector)
-            {
-                for (int i = 0; i < actor->ar_num_collcabs; i++)
-                {
-                    int tmpv = actor->ar_collcabs[i] * 3;
-                    node_t* no = &actor->ar_nodes[actor->ar_cabs[tmpv]];
-                    node_t* na = &actor->ar_nodes[actor->ar_cabs[tmpv + 1]];
-                    node_t* nb = &actor->ar_nodes[actor->ar_cabs[tmpv + 2]];
-
-                    m_intra_point_col_detector->query(no->AbsPosition - collision_offset,
-                        na->AbsPosition - collision_offset,
-                        nb->AbsPosition - collision_offset,
-                        actor->ar_collision_range * 3.0f);
-
-                    if (collision = !m_intra_point_col_detector->hit_list.empty())
-                        break;
-                }
-
-                if (collision)
-                    break;
-            }
-
-            float proximity = std::max(.05f, std::sqrt(std::max(m_min_camera_radius, actor->m_min_camera_radius)) / 50.f);
-
-            // Test proximity of own nodes against others nodes
-            for (int i = 0; i < ar_num_nodes; i++)
-            {
-                if (!ar_nodes[i].nd_contacter && !ar_nodes[i].nd_contactable)
-                    continue;
-
-                Vector3 query_position = ar_nodes[i].AbsPosition + collision_offset;
-
-                for (int j = 0; j < actor->ar_num_nodes; j++)
-                {
-                    if (!actor->ar_nodes[j].nd_contacter && !actor->ar_nodes[j].nd_contactable)
-                        continue;
-
-                    if (collision = query_position.squaredDistance(actor->ar_nodes[j].AbsPosition) < proximity)
-                        break;
-                }
-
-                if (collision)
-                    break;
-            }
-
-            if (collision)
-                break;
-        }
-
-        // Test own cabs against others contacters
-        if (!collision && m_inter_point_col_detector)
-        {
-            for (int i = 0; i < ar_num_collcabs; i++)
-            {
-                int tmpv = ar_collcabs[i] * 3;
-                node_t* no = &ar_nodes[ar_cabs[tmpv]];
-                node_t* na = &ar_nodes[ar_cabs[tmpv + 1]];
-                node_t* nb = &ar_nodes[ar_cabs[tmpv + 2]];
-
-                m_inter_point_col_detector->query(no->AbsPosition + collision_offset,
-                    na->AbsPosition + collision_offset,
-                    nb->AbsPosition + collision_offset,
-                    ar_collision_range * 3.0f);
-
-                if (collision = !m_inter_point_col_detector->hit_list.empty())
-                    break;
-            }
-        }
-
-        // Test beams (between contactable nodes) against cabs
-        if (!collision)
-        {
-            for (ActorPtr& actor : App::GetGameContext()->GetActorManager()->GetActors())
-            {
-                if (actor == this)
-                    continue;
-                if (collision = this->Intersects(actor, collision_offset))
-                    break;
-            }
-        }
-
-        if (!collision)
-            break;
+        if (other == actor || !placement.CanReach(other->ar_bounding_box.getMinimum(), other->ar_bounding_box.getMaximum()))
+            continue;
 
-        collision_offset += direction * 0.05f;
+        ActorPlacement::Shape obstacle = GetPlacementShape(other);
+        obstacle.sh_linked = std::find(actor->ar_linked_actors.begin(), actor->ar_linked_actors.end(), other) != actor->ar_linked_actors.end();
+        placement.AddObstacle(std::move(obstacle));
     }
-
-    return collision_offset;
 }
 
 void Actor::resolveCollisions(Ogre::Vector3 direction)
 {
-    if (m_intra_point_col_detector)
-        m_intra_point_col_detector->UpdateIntraPoint(true);
+    const BitMask_t flags = (m_intra_point_col_detector ? ActorPlacement::TEST_NODES_VS_CABS : 0)
+                          | (m_inter_point_col_detector ? ActorPlacement::TEST_CABS_VS_NODES : 0);
+    ActorPlacement placement(GetPlacementShape(this), direction.length(), flags);
+    AddPlacementObstacles(placement, this);
 
-    if (m_inter_point_col_detector)
-        m_inter_point_col_detector->UpdateInterPoint(true);
-
-    Vector3 offset = calculateCollisionOffset(direction);
+    Vector3 offset = placement.FindFreeOffset(direction);
 
     if (offset == Vector3::ZERO)
         return;
@@ -1039,30 +869,29 @@ void Actor::resolveCollisions(Ogre::Vector3 direction)
 
 void Actor::resolveCollisions(float max_distance, bool consider_up)
 {
-    if (m_intra_point_col_detector)
-        m_intra_point_col_detector->UpdateIntraPoint(true);
-
-    if (m_inter_point_col_detector)
-        m_inter_point_col_detector->UpdateInterPoint(true);
+    const BitMask_t flags = (m_intra_point_col_detector ? ActorPlacement::TEST_NODES_VS_CABS : 0)
+                          | (m_inter_point_col_detector ? ActorPlacement::TEST_CABS_VS_NODES : 0);
+    ActorPlacement placement(GetPlacementShape(this), max_distance, flags);
+    AddPlacementObstacles(placement, this);
 
     Vector3 u = Vector3::UNIT_Y;
     Vector3 f = Vector3(getDirection().x, 0.0f, getDirection().z).normalisedCopy();
     Vector3 l = u.crossProduct(f);
 
     // Calculate an ideal collision avoidance direction (prefer left over right over [front / back / up])
-    Vector3 left  = calculateCollisionOffset(+l * max_distance);
-    Vector3 right = calculateCollisionOffset(-l * left.length());
+    Vector3 left  = placement.FindFreeOffset(+l * max_distance);
+    Vector3 right = placement.FindFreeOffset(-l * left.length());
     Vector3 lateral = left.length() < right.length() * 1.1f ? left : right;
 
-    Vector3 front = calculateCollisionOffset(+f * lateral.length());
-    Vector3 back  = calculateCollisionOffset(-f * front.length());
+    Vector3 front = placement.FindFreeOffset(+f * lateral.length());
+    Vector3 back  = placement.FindFreeOffset(-f * front.length());
     Vector3 sagittal = front.length() < back.length() * 1.1f ? front : back;
 
     Vector3 offset = lateral.length() < sagittal.length() * 1.2f ? lateral : sagittal;
 
     if (consider_up)
     {
-        Vector3 up = calculateCollisionOffset(+u * offset.length());
+        Vector3 up = placement.FindFreeOffset(+u * offset.length());
         if (up.length() * 1.2f < offset.length())
             offset = up;
     }
@@ -1296,23 +1125,23 @@ void Actor::mouseMove(NodeNum_t node, Vector3 pos, float force)
 
 void Actor::toggleWheelDiffMode()
 {
-    for (int i = 0; i < m_num_wheel_diffs; ++i)
+    for (Differential* diff: m_wheel_diffs)
     {
-        m_wheel_diffs[i]->ToggleDifferentialMode();
+        diff->ToggleDifferentialMode();
     }
 }
 
 void Actor::toggleAxleDiffMode()
 {
-    for (int i = 0; i < m_num_axle_diffs; ++i)
+    for (Differential* diff: m_axle_diffs)
     {
-        m_axle_diffs[i]->ToggleDifferentialMode();
+        diff->ToggleDifferentialMode();
     }
 }
 
 void Actor::displayAxleDiffMode()
 {
-    if (m_num_axle_diffs == 0)
+    if (m_axle_diffs.empty())
     {
         App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, Console::CONSOLE_SYSTEM_NOTICE,
                 _L("No inter-axle differential installed on current vehicle!"), "error.png");
@@ -1320,7 +1149,7 @@ void Actor::displayAxleDiffMode()
     else
     {
         String message = "";
-        for (int i = 0; i < m_num_axle_diffs; ++i)
+        for (size_t i = 0; i < m_axle_diffs.size(); ++i)
         {
             if (m_axle_diffs[i])
             {
@@ -1340,7 +1169,7 @@ void Actor::displayAxleDiffMode()
 
 void Actor::displayWheelDiffMode()
 {
-    if (m_num_wheel_diffs == 0)
+    if (m_wheel_diffs.empty())
     {
         App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, Console::CONSOLE_SYSTEM_NOTICE,
                 _L("No inter-wheel differential installed on current vehicle!"), "error.png");
@@ -1348,7 +1177,7 @@ void Actor::displayWheelDiffMode()
     else
     {
         String message = "";
-        for (int i = 0; i < m_num_wheel_diffs; ++i)
+        for (size_t i = 0; i < m_wheel_diffs.size(); ++i)
         {
             if (m_wheel_diffs[i])
             {
@@ -1394,6 +1223,7 @@ void Actor::toggleTransferCaseMode()
     }
 
     m_transfer_case->tr_4wd_mode = !m_transfer_case->tr_4wd_mode;
+    m_drivetrain_solver.SetDiffEnabled(m_transfer_case->tr_drivetrain_node, m_transfer_case->tr_4wd_mode);
 
     if (m_transfer_case->tr_4wd_mode)
     {
@@ -1651,11 +1481,12 @@ void Actor::SyncReset(bool reset_position)
         ar_engine->SetWheelSpin(0.0f);
     }
 
-    int num_axle_diffs = (m_transfer_case && m_transfer_case->tr_4wd_mode) ? m_num_axle_diffs + 1 : m_num_axle_diffs;
-    for (int i = 0; i < num_axle_diffs; i++)
-        m_axle_diffs[i]->di_delta_rotation = 0.0f;
-    for (int i = 0; i < m_num_wheel_diffs; i++)
-        m_wheel_diffs[i]->di_delta_rotation = 0.0f;
+    for (Differential* diff: m_axle_diffs)
+        diff->di_delta_rotation = 0.0f;
+    for (Differential* diff: m_wheel_diffs)
+        diff->di_delta_rotation = 0.0f;
+    if (m_transfer_case)
+        m_transfer_case->tr_diff.di_delta_rotation = 0.0f;
     for (int i = 0; i < ar_num_aeroengines; i++)
         ar_aeroengines[i]->reset();
     for (int i = 0; i < ar_num_screwprops; i++)
@@ -1669,9 +1500,9 @@ void Actor::SyncReset(bool reset_position)
     if (m_buoyance)
         m_buoyance->sink = false;
 
-    for (hydrobeam_t& hydrobeam: ar_hydros)
+    for (int i = 0; i < ar_num_hydros; i++)
     {
-        hydrobeam.hb_inertia.ResetCmdKeyDelay();
+        ar_hydros[i].hb_inertia.ResetCmdKeyDelay();
     }
 
     this->GetGfxActor()->ResetFlexbodies();
@@ -1751,9 +1582,9 @@ void Actor::applyNodeBeamScales()
 void Actor::ForceFeedbackStep(int steps)
 {
     m_force_sensors.out_body_forces = m_force_sensors.accu_body_forces / steps;
-    if (!ar_hydros.empty()) // Vehicle has hydros?
+    if (ar_num_hydros > 0) // Vehicle has hydros?
     {
-        m_force_sensors.out_hydros_forces = (m_force_sensors.accu_hydros_forces / steps) / ar_hydros.size();    
+        m_force_sensors.out_hydros_forces = (m_force_sensors.accu_hydros_forces / steps) / ar_num_hydros;    
     }
 }
 
@@ -2067,272 +1898,104 @@ void Actor::sendStreamData()
 #endif //SOCKETW
 }
 
-void Actor::CalcAnimators(hydrobeam_t const& hydrobeam, float &cstate, int &div)
+void Actor::UpdateAnimatorSources()
 {
-    // boat rudder
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_BRUDDER)
-    {
-        int spi;
-        float ctmp = 0.0f;
-        for (spi = 0; spi < ar_num_screwprops; spi++)
-            if (ar_screwprops[spi])
-                ctmp += ar_screwprops[spi]->getRudder();
+    AnimationTable& table = m_animator_table;
 
-        if (spi > 0)
-            ctmp = ctmp / spi;
-        cstate = ctmp;
-        div++;
-    }
-
-    // boat throttle
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_BTHROTTLE)
+    // boat rudder + throttle
+    if (table.IsSourceUsed(ANIM_SOURCE_BRUDDER) || table.IsSourceUsed(ANIM_SOURCE_BTHROTTLE))
     {
-        int spi;
-        float ctmp = 0.0f;
-        for (spi = 0; spi < ar_num_screwprops; spi++)
-            if (ar_screwprops[spi])
-                ctmp += ar_screwprops[spi]->getThrottle();
-
-        if (spi > 0)
-            ctmp = ctmp / spi;
-        cstate = ctmp;
-        div++;
-    }
-
-    // differential lock status
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_DIFFLOCK)
-    {
-        if (m_num_wheel_diffs && m_wheel_diffs[0])
+        float rudder = 0.0f;
+        float throttle = 0.0f;
+        for (int spi = 0; spi < ar_num_screwprops; spi++)
         {
-            String name = m_wheel_diffs[0]->GetDifferentialTypeName();
-            if (name == "Open")
-                cstate = 0.0f;
-            if (name == "Split")
-                cstate = 0.5f;
-            if (name == "Locked")
-                cstate = 1.0f;
-        }
-        else // no axles/diffs avail, mode is split by default
-            cstate = 0.5f;
-
-        div++;
-    }
-
-    // heading
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_HEADING)
-    {
-        float heading = getRotation();
-        // rad2deg limitedrange  -1 to +1
-        cstate = (heading * 57.29578f) / 360.0f;
-        div++;
-    }
-
-    // torque
-    if (ar_engine && hydrobeam.hb_anim_flags & ANIM_FLAG_TORQUE)
-    {
-        float torque = ar_engine->GetCrankFactor();
-        if (torque <= 0.0f)
-            torque = 0.0f;
-        if (torque >= ar_anim_previous_crank)
-            cstate -= torque / 10.0f;
-        else
-            cstate = 0.0f;
-
-        if (cstate <= -1.0f)
-            cstate = -1.0f;
-        ar_anim_previous_crank = torque;
-        div++;
-    }
-
-    // shifterseq, to amimate sequentiell shifting
-    if (ar_engine && (hydrobeam.hb_anim_flags & ANIM_FLAG_SHIFTER) && hydrobeam.hb_anim_param == 3.0f)
-    {
-
-        int shifter = ar_engine->GetGear();
-        if (shifter > m_previous_gear)
-        {
-            cstate = 1.0f;
-            ar_anim_shift_timer = 0.2f;
-        }
-        if (shifter < m_previous_gear)
-        {
-            cstate = -1.0f;
-            ar_anim_shift_timer = -0.2f;
+            if (ar_screwprops[spi])
+            {
+                rudder += ar_screwprops[spi]->getRudder();
+                throttle += ar_screwprops[spi]->getThrottle();
+            }
         }
-        m_previous_gear = shifter;
 
-        if (ar_anim_shift_timer > 0.0f)
-        {
-            cstate = 1.0f;
-            ar_anim_shift_timer -= PHYSICS_DT;
-            if (ar_anim_shift_timer < 0.0f)
-                ar_anim_shift_timer = 0.0f;
-        }
-        if (ar_anim_shift_timer < 0.0f)
+        if (ar_num_screwprops > 0)
         {
-            cstate = -1.0f;
-            ar_anim_shift_timer += PHYSICS_DT;
-            if (ar_anim_shift_timer > 0.0f)
-                ar_anim_shift_timer = 0.0f;
+            rudder = rudder / ar_num_screwprops;
+            throttle = throttle / ar_num_screwprops;
         }
-
-        div++;
+        table.SetValue(ANIM_SOURCE_BRUDDER, rudder);
+        table.SetValue(ANIM_SOURCE_BTHROTTLE, throttle);
     }
 
-    // shifterman1, left/right
-    if (ar_engine && (hydrobeam.hb_anim_flags & ANIM_FLAG_SHIFTER) && hydrobeam.hb_anim_param == 1.0f)
-    {
-        int shifter = ar_engine->GetGear();
-        if (!shifter)
-        {
-            cstate = -0.5f;
-        }
-        else if (shifter < 0)
-        {
-            cstate = 1.0f;
-        }
-        else
-        {
-            cstate -= int((shifter - 1.0) / 2.0);
-        }
-        div++;
-    }
-
-    // shifterman2, up/down
-    if (ar_engine && (hydrobeam.hb_anim_flags & ANIM_FLAG_SHIFTER) && hydrobeam.hb_anim_param == 2.0f)
+    // differential lock status
+    if (table.IsSourceUsed(ANIM_SOURCE_DIFFLOCK))
     {
-        int shifter = ar_engine->GetGear();
-        cstate = 0.5f;
-        if (shifter < 0)
+        float difflock = 0.5f; // no axles/diffs avail, mode is split by default
+        if (!m_wheel_diffs.empty() && m_wheel_diffs[0])
         {
-            cstate = 1.0f;
-        }
-        if (shifter > 0)
-        {
-            cstate = shifter % 2;
+            difflock = -1.0f; // keep cstate
+            if (m_wheel_diffs[0]->GetNumDiffTypes() > 0)
+            {
+                switch (m_wheel_diffs[0]->GetActiveDiffType())
+                {
+                case OPEN_DIFF:   difflock = 0.0f; break;
+                case SPLIT_DIFF:  difflock = 0.5f; break;
+                case LOCKED_DIFF: difflock = 1.0f; break;
+                default:;
+                }
+            }
         }
-        div++;
+        table.SetValue(ANIM_SOURCE_DIFFLOCK, difflock);
     }
 
-    // shifterlinear, to amimate cockpit gearselect gauge and autotransmission stick
-    if (ar_engine && (hydrobeam.hb_anim_flags & ANIM_FLAG_SHIFTER) && hydrobeam.hb_anim_param == 4.0f)
-    {
-        int shifter = ar_engine->GetGear();
-        int numgears = ar_engine->getNumGears();
-        cstate -= (shifter + 2.0) / (numgears + 2.0);
-        div++;
-    }
+    // heading; rad2deg limitedrange  -1 to +1
+    if (table.IsSourceUsed(ANIM_SOURCE_HEADING))
+        table.SetValue(ANIM_SOURCE_HEADING, (getRotation() * 57.29578f) / 360.0f);
 
-    // parking brake
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_PBRAKE)
+    if (ar_engine)
     {
-        float pbrake = ar_parking_brake;
-        cstate -= pbrake;
-        div++;
+        table.SetValue(ANIM_SOURCE_TORQUE, std::max(ar_engine->GetCrankFactor(), 0.0f));
+        // engine tacho ( scales with maxrpm, default is 3500 )
+        table.SetValue(ANIM_SOURCE_TACHO, ar_engine->GetEngineRpm() / ar_engine->getMaxRPM());
+        const float turbo = ar_engine->GetTurboPsi() * 3.34;
+        table.SetValue(ANIM_SOURCE_TURBO, turbo / 67.0f);
+        // small correction, get acc is nver smaller then 0.06.
+        table.SetValue(ANIM_SOURCE_ACCEL, ar_engine->GetAcceleration() + 0.06f);
+        table.SetValue(ANIM_SOURCE_CLUTCH, fabs(1.0f - ar_engine->GetClutch()));
     }
 
+    table.SetValue(ANIM_SOURCE_PBRAKE, static_cast<float>(ar_parking_brake));
     // speedo ( scales with speedomax )
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_SPEEDO)
-    {
-        float speedo = ar_wheel_speed / ar_speedo_max_kph;
-        cstate -= speedo * 3.0f;
-        div++;
-    }
-
-    // engine tacho ( scales with maxrpm, default is 3500 )
-    if (ar_engine && hydrobeam.hb_anim_flags & ANIM_FLAG_TACHO)
-    {
-        float tacho = ar_engine->GetEngineRpm() / ar_engine->getMaxRPM();
-        cstate -= tacho;
-        div++;
-    }
-
-    // turbo
-    if (ar_engine && hydrobeam.hb_anim_flags & ANIM_FLAG_TURBO)
-    {
-        float turbo = ar_engine->GetTurboPsi() * 3.34;
-        cstate -= turbo / 67.0f;
-        div++;
-    }
-
-    // brake
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_BRAKE)
-    {
-        cstate -= ar_brake;
-        div++;
-    }
-
-    // accelerator
-    if (ar_engine && hydrobeam.hb_anim_flags & ANIM_FLAG_ACCEL)
-    {
-        float accel = ar_engine->GetAcceleration();
-        cstate -= accel + 0.06f;
-        //( small correction, get acc is nver smaller then 0.06.
-        div++;
-    }
-
-    // clutch
-    if (ar_engine && hydrobeam.hb_anim_flags & ANIM_FLAG_CLUTCH)
-    {
-        float clutch = ar_engine->GetClutch();
-        cstate -= fabs(1.0f - clutch);
-        div++;
-    }
+    table.SetValue(ANIM_SOURCE_SPEEDO, (ar_wheel_speed / ar_speedo_max_kph) * 3.0f);
+    table.SetValue(ANIM_SOURCE_BRAKE, ar_brake);
+
+    // aeroengines
+    for (int aenum = 0; aenum < table.GetNumAeroengines(); aenum++)
+    {
+        float angle;
+        float pcent = ar_aeroengines[aenum]->getRPMpc();
+        if (pcent < 60.0)
+            angle = -5.0 + pcent * 1.9167;
+        else if (pcent < 110.0)
+            angle = 110.0 + (pcent - 60.0) * 4.075;
+        else
+            angle = 314.0;
+        table.SetValue(table.GetAeroengineSlot(aenum, ANIM_SOURCE_AE_RPM), angle / 314.0f);
+        table.SetValue(table.GetAeroengineSlot(aenum, ANIM_SOURCE_AE_THROTTLE), ar_aeroengines[aenum]->getThrottle());
 
-    // aeroengines (hb_anim_param is the engine index)
-    if ((int)hydrobeam.hb_anim_param < ar_num_aeroengines)
-    {
-        int aenum = (int)hydrobeam.hb_anim_param;
-        if (hydrobeam.hb_anim_flags & ANIM_FLAG_RPM)
+        if (ar_aeroengines[aenum]->getType() == AeroEngineType::AE_XPROP)
         {
-            float angle;
-            float pcent = ar_aeroengines[aenum]->getRPMpc();
-            if (pcent < 60.0)
-                angle = -5.0 + pcent * 1.9167;
-            else if (pcent < 110.0)
-                angle = 110.0 + (pcent - 60.0) * 4.075;
-            else
-                angle = 314.0;
-            cstate -= angle / 314.0f;
-            div++;
-        }
-        if (hydrobeam.hb_anim_flags & ANIM_FLAG_THROTTLE)
-        {
-            float throttle = ar_aeroengines[aenum]->getThrottle();
-            cstate -= throttle;
-            div++;
+            Turboprop* tp = (Turboprop*)ar_aeroengines[aenum];
+            table.SetValue(table.GetAeroengineSlot(aenum, ANIM_SOURCE_AE_TORQUE), (100.0 * tp->indicated_torque / tp->max_torque) / 120.0f);
+            table.SetValue(table.GetAeroengineSlot(aenum, ANIM_SOURCE_AE_PITCH), tp->pitch / 120.0f);
         }
 
-        if (hydrobeam.hb_anim_flags & ANIM_FLAG_AETORQUE)
-            if (ar_aeroengines[aenum]->getType() == AeroEngineType::AE_XPROP)
-            {
-                Turboprop* tp = (Turboprop*)ar_aeroengines[aenum];
-                cstate = (100.0 * tp->indicated_torque / tp->max_torque) / 120.0f;
-                div++;
-            }
-
-        if (hydrobeam.hb_anim_flags & ANIM_FLAG_AEPITCH)
-            if (ar_aeroengines[aenum]->getType() == AeroEngineType::AE_XPROP)
-            {
-                Turboprop* tp = (Turboprop*)ar_aeroengines[aenum];
-                cstate = tp->pitch / 120.0f;
-                div++;
-            }
-
-        if (hydrobeam.hb_anim_flags & ANIM_FLAG_AESTATUS)
-        {
-            if (!ar_aeroengines[aenum]->getIgnition())
-                cstate = 0.0f;
-            else
-                cstate = 0.5f;
-            if (ar_aeroengines[aenum]->isFailed())
-                cstate = 1.0f;
-            div++;
-        }
+        float status = (ar_aeroengines[aenum]->getIgnition()) ? 0.5f : 0.0f;
+        if (ar_aeroengines[aenum]->isFailed())
+            status = 1.0f;
+        table.SetValue(table.GetAeroengineSlot(aenum, ANIM_SOURCE_AE_STATUS), status);
     }
 
     // airspeed indicator
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_AIRSPEED)
+    if (table.IsSourceUsed(ANIM_SOURCE_AIRSPEED))
     {
         float ground_speed_kt = ar_nodes[0].Velocity.length() * 1.9438;
         float altitude = ar_nodes[0].AbsPosition.y;
@@ -2340,76 +2003,39 @@ void Actor::CalcAnimators(hydrobeam_t const& hydrobeam, float &cstate, int &div)
         float airpressure = sea_level_pressure * pow(1.0 - 0.0065 * altitude / 288.15, 5.24947); //in Pa
         float airdensity = airpressure * 0.0000120896;//1.225 at sea level
         float kt = ground_speed_kt * sqrt(airdensity / 1.225);
-        cstate -= kt / 100.0f;
-        div++;
+        table.SetValue(ANIM_SOURCE_AIRSPEED, kt / 100.0f);
     }
 
-    // vvi indicator
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_VVI)
-    {
-        float vvi = ar_nodes[0].Velocity.y * 196.85;
-        // limit vvi scale to +/- 6m/s
-        cstate -= vvi / 6000.0f;
-        if (cstate >= 1.0f)
-            cstate = 1.0f;
-        if (cstate <= -1.0f)
-            cstate = -1.0f;
-        div++;
-    }
+    // vvi indicator; limit vvi scale to +/- 6m/s
+    float vvi = ar_nodes[0].Velocity.y * 196.85;
+    table.SetValue(ANIM_SOURCE_VVI, vvi / 6000.0f);
 
-    // altimeter
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_ALTIMETER)
-    {
-        //altimeter indicator 1k oscillating
-        if (hydrobeam.hb_anim_param == 3.0f)
-        {
-            float altimeter = (ar_nodes[0].AbsPosition.y * 1.1811) / 360.0f;
-            int alti_int = int(altimeter);
-            float alti_mod = (altimeter - alti_int);
-            cstate -= alti_mod;
-        }
+    // altimeter indicator 1k oscillating
+    float altimeter = (ar_nodes[0].AbsPosition.y * 1.1811) / 360.0f;
+    table.SetValue(ANIM_SOURCE_ALTIMETER_1K, altimeter - int(altimeter));
 
-        //altimeter indicator 10k oscillating
-        if (hydrobeam.hb_anim_param == 2.0f)
-        {
-            float alti = ar_nodes[0].AbsPosition.y * 1.1811 / 3600.0f;
-            int alti_int = int(alti);
-            float alti_mod = (alti - alti_int);
-            cstate -= alti_mod;
-            if (cstate <= -1.0f)
-                cstate = -1.0f;
-        }
+    // altimeter indicator 10k oscillating
+    float alti_10k = ar_nodes[0].AbsPosition.y * 1.1811 / 3600.0f;
+    table.SetValue(ANIM_SOURCE_ALTIMETER_10K, alti_10k - int(alti_10k));
 
-        //altimeter indicator 100k limited
-        if (hydrobeam.hb_anim_param == 1.0f)
-        {
-            float alti = ar_nodes[0].AbsPosition.y * 1.1811 / 36000.0f;
-            cstate -= alti;
-            if (cstate <= -1.0f)
-                cstate = -1.0f;
-        }
-        div++;
-    }
+    // altimeter indicator 100k limited
+    float alti_100k = ar_nodes[0].AbsPosition.y * 1.1811 / 36000.0f;
+    table.SetValue(ANIM_SOURCE_ALTIMETER_100K, alti_100k);
 
     // AOA
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_AOA)
+    if (table.IsSourceUsed(ANIM_SOURCE_AOA))
     {
         float aoa = 0;
         if (ar_num_wings > 4)
             aoa = (ar_wings[4].fa->aoa) / 25.0f;
         if ((ar_nodes[0].Velocity.length() * 1.9438) < 10.0f)
             aoa = 0;
-        cstate -= aoa;
-        if (cstate <= -1.0f)
-            cstate = -1.0f;
-        if (cstate >= 1.0f)
-            cstate = 1.0f;
-        div++;
+        table.SetValue(ANIM_SOURCE_AOA, aoa);
     }
 
-    // roll
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_ROLL)
+    if (table.IsSourceUsed(ANIM_SOURCE_ROLL) || table.IsSourceUsed(ANIM_SOURCE_PITCH))
     {
+        // roll
         Vector3 rollv = this->GetCameraRoll();
         Vector3 dirv = this->GetCameraDir();
         Vector3 upv = dirv.crossProduct(-rollv);
@@ -2419,41 +2045,116 @@ void Actor::CalcAnimators(hydrobeam_t const& hydrobeam, float &cstate, int &div)
         // flip to other side when upside down
         if (upv.y < 0)
             rollangle = 180.0f - rollangle;
-        cstate = rollangle / 180.0f;
+        float roll = rollangle / 180.0f;
         // data output is -0.5 to 1.5, normalize to -1 to +1 without changing the zero position.
         // this is vital for the animator beams and does not effect the animated props
-        if (cstate >= 1.0f)
-            cstate = cstate - 2.0f;
-        div++;
-    }
+        if (roll >= 1.0f)
+            roll = roll - 2.0f;
+        table.SetValue(ANIM_SOURCE_ROLL, roll);
 
-    // pitch
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_PITCH)
-    {
-        Vector3 dirv = this->GetCameraDir();
+        // pitch; radian to degrees with a max cstate of +/- 1.0
         float pitchangle = asin(dirv.dotProduct(Vector3::UNIT_Y));
-        // radian to degrees with a max cstate of +/- 1.0
-        cstate = (Math::RadiansToDegrees(pitchangle) / 90.0f);
-        div++;
+        table.SetValue(ANIM_SOURCE_PITCH, Math::RadiansToDegrees(pitchangle) / 90.0f);
     }
 
     // airbrake
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_AIRBRAKE)
-    {
-        float airbrake = ar_airbrake_intensity;
-        // cstate limited to -1.0f
-        cstate -= airbrake / 5.0f;
-        div++;
-    }
-
+    float airbrake = ar_airbrake_intensity;
+    table.SetValue(ANIM_SOURCE_AIRBRAKE, airbrake / 5.0f);
     // flaps
-    if (hydrobeam.hb_anim_flags & ANIM_FLAG_FLAP)
+    table.SetValue(ANIM_SOURCE_FLAP, FLAP_ANGLES[ar_aerial_flap]);
+}
+
+void Actor::CalcAnimators(hydrobeam_t const& hydrobeam, float &cstate, int &div)
+{
+    AnimProgram const& program = hydrobeam.hb_anim_program;
+    const int op_end = program.apr_op_begin + program.apr_op_count;
+    for (int i = program.apr_op_begin; i < op_end; i++)
     {
-        float flaps = FLAP_ANGLES[ar_aerial_flap];
-        // cstate limited to -1.0f
-        cstate = flaps;
-        div++;
+        AnimOp const& op = m_animator_table.GetOp(i);
+        switch (op.aop_type)
+        {
+        // shifterseq, to amimate sequentiell shifting
+        case AnimOpType::SHIFTER_SEQ:
+        {
+            int shifter = ar_engine->GetGear();
+            if (shifter > m_previous_gear)
+            {
+                cstate = 1.0f;
+                ar_anim_shift_timer = 0.2f;
+            }
+            if (shifter < m_previous_gear)
+            {
+                cstate = -1.0f;
+                ar_anim_shift_timer = -0.2f;
+            }
+            m_previous_gear = shifter;
+
+            if (ar_anim_shift_timer > 0.0f)
+            {
+                cstate = 1.0f;
+                ar_anim_shift_timer -= PHYSICS_DT;
+                if (ar_anim_shift_timer < 0.0f)
+                    ar_anim_shift_timer = 0.0f;
+            }
+            if (ar_anim_shift_timer < 0.0f)
+            {
+                cstate = -1.0f;
+                ar_anim_shift_timer += PHYSICS_DT;
+                if (ar_anim_shift_timer > 0.0f)
+                    ar_anim_shift_timer = 0.0f;
+            }
+            break;
+        }
+
+        // shifterman1, left/right
+        case AnimOpType::SHIFTER_MAN1:
+        {
+            int shifter = ar_engine->GetGear();
+            if (!shifter)
+            {
+                cstate = -0.5f;
+            }
+            else if (shifter < 0)
+            {
+                cstate = 1.0f;
+            }
+            else
+            {
+                cstate -= int((shifter - 1.0) / 2.0);
+            }
+            break;
+        }
+
+        // shifterman2, up/down
+        case AnimOpType::SHIFTER_MAN2:
+        {
+            int shifter = ar_engine->GetGear();
+            cstate = 0.5f;
+            if (shifter < 0)
+            {
+                cstate = 1.0f;
+            }
+            if (shifter > 0)
+            {
+                cstate = shifter % 2;
+            }
+            break;
+        }
+
+        // shifterlinear, to amimate cockpit gearselect gauge and autotransmission stick
+        case AnimOpType::SHIFTER_LIN:
+        {
+            int shifter = ar_engine->GetGear();
+            int numgears = ar_engine->getNumGears();
+            cstate -= (shifter + 2.0) / (numgears + 2.0);
+            break;
+        }
+
+        default:
+            m_animator_table.ApplyOp(op, cstate, ar_anim_previous_crank);
+        }
     }
+    div += program.apr_num_sources;
 }
 
 void Actor::CalcCabCollisions()
@@ -2464,16 +2165,13 @@ void Actor::CalcCabCollisions()
     }
     if (m_intra_point_col_detector != nullptr)
     {
+        const int exclusion_hops = App::GetGameContext()->GetActorManager()->GetSimSettings().sim_self_collision_hops;
+        if (!m_intra_collider.IsBuiltFor(exclusion_hops))
+        {
+            m_intra_collider.Build(this, exclusion_hops);
+        }
         m_intra_point_col_detector->UpdateIntraPoint();
-        ResolveIntraActorCollisions(PHYSICS_DT,
-            *m_intra_point_col_detector,
-            ar_num_collcabs,
-            ar_collcabs,
-            ar_cabs,
-            ar_intra_collcabrate,
-            ar_nodes,
-            ar_collision_range,
-            *ar_submesh_ground_model);
+        m_intra_collider.Resolve(PHYSICS_DT, *m_intra_point_col_detector, this);
     }
 }
 
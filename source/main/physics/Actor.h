@@ -21,10 +21,16 @@
 
 #pragma once
 
+#include "ActorArena.h"
+#include "AnimationTable.h"
+#include "Airfoil.h"
 #include "Application.h"
 #include "CmdKeyInertia.h"
 #include "Differentials.h"
+#include "DrivetrainSolver.h"
+#include "DynamicCollisions.h"
 #include "GfxActor.h"
+#include "NetFrameBuffer.h"
 #include "PerVehicleCameraContext.h"
 #include "RigDef_Prerequisites.h"
 #include "RoRnet.h"
@@ -107,6 +113,7 @@ public:
     bool              hasSlidenodes() { return !m_slidenodes.empty(); };
     void              updateSlideNodePositions();          //!< incrementally update the position of all SlideNodes
     void              updateSlideNodeForces(const Ogre::Real delta_time_sec); //!< calculate and apply Corrective forces
+    void              UpdateRailBvhs();                                       //!< refit rail segment bounding volumes to current node positions; needed before looking for a rail
     void              resetSlideNodePositions();           //!< Recalculate SlideNode positions
     void              resetSlideNodes();                   //!< Reset all the SlideNodes
     /// @}
@@ -143,10 +150,10 @@ public:
     void              cruisecontrolToggle();               //!< Defined in 'gameplay/CruiseControl.cpp'
     void              toggleAxleDiffMode();                //! Cycles through the available inter axle diff modes
     void              displayAxleDiffMode();               //! Writes info to console/notify box
-    int               getAxleDiffMode() { return m_num_axle_diffs; }
+    int               getAxleDiffMode() { return static_cast<int>(m_axle_diffs.size()); }
     void              toggleWheelDiffMode();               //! Cycles through the available inter wheel diff modes
     void              displayWheelDiffMode();              //! Writes info to console/notify box
-    int               getWheelDiffMode() { return m_num_wheel_diffs; }
+    int               getWheelDiffMode() { return static_cast<int>(m_wheel_diffs.size()); }
     void              toggleTransferCaseMode();            //! Toggles between 2WD and 4WD mode
     TransferCase*     getTransferCaseMode() { return m_transfer_case; }
     void              toggleTransferCaseGearRatio();       //! Toggles between Hi and Lo mode
@@ -230,7 +237,6 @@ public:
     void              HandleInputEvents(float dt);
     void              HandleAngelScriptEvents(float dt);
     void              UpdateCruiseControl(float dt);       //!< Defined in 'gameplay/CruiseControl.cpp'
-    bool              Intersects(ActorPtr actor, Ogre::Vector3 offset = Ogre::Vector3::ZERO);  //!< Slow intersection test
     /// Moves the actor at most 'direction.length()' meters towards 'direction' to resolve any collisions
     void              resolveCollisions(Ogre::Vector3 direction);
     /// Auto detects an ideal collision avoidance direction (front, back, left, right, up)
@@ -314,15 +320,16 @@ ActorPtrVec                        ar_linked_actors;              //!< Sim state
     int               ar_num_aeroengines = 0;
     Screwprop*        ar_screwprops[MAX_SCREWPROPS] = {};
     int               ar_num_screwprops = 0;
-    int               ar_cabs[MAX_CABS * 3] = {};
+    int*              ar_cabs = nullptr;              //!< Node triplets; sized at spawn, lives in `m_arena`
     int               ar_num_cabs = 0;
-    std::vector<hydrobeam_t> ar_hydros;
-    int               ar_collcabs[MAX_CABS] = {};
-    collcab_rate_t    ar_inter_collcabrate[MAX_CABS] = {};
-    collcab_rate_t    ar_intra_collcabrate[MAX_CABS] = {};
+    hydrobeam_t*      ar_hydros = nullptr;            //!< Hydros and animators; sized at spawn, lives in `m_arena`
+    int               ar_num_hydros = 0;
+    int*              ar_collcabs = nullptr;          //!< Sized at spawn, lives in `m_arena`
+    collcab_rate_t*   ar_inter_collcabrate = nullptr; //!< Sized at spawn, lives in `m_arena`
+    collcab_rate_t*   ar_intra_collcabrate = nullptr; //!< Sized at spawn, lives in `m_arena`
     int               ar_num_collcabs = 0;
-    int               ar_buoycabs[MAX_CABS] = {};
-    int               ar_buoycab_types[MAX_CABS] = {};
+    int*              ar_buoycabs = nullptr;          //!< Sized at spawn, lives in `m_arena`
+    int*              ar_buoycab_types = nullptr;     //!< Sized at spawn, lives in `m_arena`
     int               ar_num_buoycabs = 0;
     NodeNum_t         ar_camera_rail[MAX_CAMERARAIL] = {}; //!< Nodes defining camera-movement spline
     int               ar_num_camera_rails = 0;
@@ -420,6 +427,8 @@ ActorPtrVec                        ar_linked_actors;              //!< Sim state
     ground_model_t*   ar_last_fuzzy_ground_model = nullptr;     //!< GUI state
     CollisionBoxPtrVec m_potential_eventboxes;
     std::vector<std::pair<collision_box_t*, NodeNum_t>> m_active_eventboxes;
+    std::vector<Ogre::Vector3> m_water_query_pos;      //!< Physics scratch buffer; node positions for `IWater::CalcWavesHeights()`
+    std::vector<float>         m_water_query_heights;  //!< Physics scratch buffer
 
     // Gameplay state
     ActorState        ar_state = ActorState::LOCAL_SIMULATED;
@@ -467,6 +476,7 @@ private:
     bool              CalcForcesEulerPrepare(bool doUpdate); 
     void              CalcAircraftForces(bool doUpdate);   
     void              CalcForcesEulerCompute(bool doUpdate, int num_steps); 
+    void              UpdateAnimatorSources();     //!< Fills `m_animator_table` once per physics step
     void              CalcAnimators(hydrobeam_t const& hydrobeam, float &cstate, int &div);
     void              CalcBeams(bool trigger_hooks);       
     void              CalcBeamsInterActor();               
@@ -500,10 +510,6 @@ private:
     void              autoBlinkReset();                    //!< Resets the turn signal when the steering wheel is turned back.
     void              ResetAngle(float rot);
     void              calculateLocalGForces();             //!< Derive the truck local g-forces from the global ones
-    /// Virtually moves the actor at most 'direction.length()' meters towards 'direction' trying to resolve any collisions
-    /// Returns a minimal offset by which the actor needs to be moved to resolve any collisions
-    //  Both PointColDetectors need to be updated accordingly before calling this
-    Ogre::Vector3     calculateCollisionOffset(Ogre::Vector3 direction);
     /// @param actor which actor to retrieve the closest Rail from
     /// @param node which SlideNode is being checked against
     /// @return a pair containing the rail, and the distant to the SlideNode
@@ -526,6 +532,7 @@ private:
     float             m_avionic_chatter_timer = 11.f;      //!< Sound fx state (some pseudo random number,  doesn't matter)
     PointColDetector* m_inter_point_col_detector = nullptr;   //!< Physics
     PointColDetector* m_intra_point_col_detector = nullptr;   //!< Physics
+    IntraActorCollider m_intra_collider;                       //!< Physics; only used with `m_intra_point_col_detector`
     
     Ogre::Vector3     m_avg_node_position = Ogre::Vector3::ZERO;          //!< average node position
     Ogre::Real        m_min_camera_radius = 0.f;
@@ -545,18 +552,22 @@ private:
     Ogre::Vector3     m_camera_local_gforces_max = Ogre::Vector3::ZERO; //!< Physics state (camera local)
     float             m_stabilizer_shock_ratio = 0.f;   //!< Physics state
     int               m_stabilizer_shock_request = 0; //!< Physics state; values: { -1, 0, 1 }
-    Differential*     m_axle_diffs[1+MAX_WHEELS/2] = {};//!< Physics
-    int               m_num_axle_diffs = 0;           //!< Physics attr
-    Differential*     m_wheel_diffs[MAX_WHEELS/2] = {};//!< Physics
-    int               m_num_wheel_diffs = 0;          //!< Physics attr
+    std::vector<Differential*> m_axle_diffs;                //!< Physics attr; the transfer case has its own
+    std::vector<Differential*> m_wheel_diffs;               //!< Physics attr; one per axle
     TransferCase*     m_transfer_case = nullptr;            //!< Physics
+    DrivetrainSolver  m_drivetrain_solver;                  //!< Physics; graph of the diffs, built at spawn
+    DrivetrainEngine  m_drivetrain_engine = {};             //!< Physics; scratch for `m_drivetrain_solver`
+    std::vector<DrivetrainWheel> m_drivetrain_wheels;       //!< Physics; scratch for `m_drivetrain_solver`
     int               m_wheel_node_count = 0;      //!< Static attr; filled at spawn
     int               m_previous_gear = 0;         //!< Sim state; land vehicle shifting
+    AnimationTable    m_animator_table;            //!< Static attr (ops) + sim state (sources); see `hydrobeam_t::hb_anim_program`
     float             m_handbrake_force = 0.f;       //!< Physics attr; defined in truckfile
     Airfoil*          m_fusealge_airfoil = nullptr;      //!< Physics attr; defined in truckfile
     node_t*           m_fusealge_front = nullptr;        //!< Physics attr; defined in truckfile
     node_t*           m_fusealge_back = nullptr;         //!< Physics attr; defined in truckfile
     float             m_fusealge_width = 0.f;        //!< Physics attr; defined in truckfile
+    ActorArena        m_arena;                       //!< Owns nodes, beams, shocks, hydros, rotators, wings and cab arrays; see `ActorSpawner::InitializeRig()`
+    AirfoilQueryBatch m_wing_batch;                  //!< Physics scratch; all wings' polar lookups in one pass
     float             m_odometer_total = 0.f;        //!< GUI state
     float             m_odometer_user = 0.f;         //!< GUI state
     int               m_num_command_beams = 0;     //!< TODO: Remove! Spawner context only; likely unused feature
@@ -582,6 +593,10 @@ private:
     size_t            m_net_total_buffer_size = 0;    //!< For incoming/outgoing traffic; calculated on spawn
     float             m_net_node_compression = 0.f;     //!< For incoming/outgoing traffic; calculated on spawn
     int               m_net_first_wheel_node = 0;     //!< Network attr; Determines data buffer layout; calculated on spawn
+    NetFrameBuffer    m_net_frames;                   //!< Incoming stream; allocated on spawn
+    std::vector<Ogre::Vector3> m_net_node_pos;        //!< Sampled from `m_net_frames`, one per node up to `m_net_first_wheel_node`
+    std::vector<Ogre::Vector3> m_net_node_vel;
+    std::vector<float> m_net_wheel_rp;                //!< Sampled from `m_net_frames`, one per wheel
 
     Ogre::UTFString   m_net_username;
     int               m_net_color_num = 0;
@@ -625,15 +640,6 @@ private:
         Ogre::Vector3 out_body_forces;
         float         out_hydros_forces;
     } m_force_sensors; //!< Data for ForceFeedback devices
-
-    struct NetUpdate
-    {
-        std::vector<char> veh_state;   //!< Actor properties (engine, brakes, lights, ...)
-        std::vector<char> node_data;   //!< Compressed node positions
-        std::vector<float> wheel_data; //!< Wheel rotations
-    };
-
-    std::deque<NetUpdate> m_net_updates; //!< Incoming stream of NetUpdates
 };
 
 /// @} // addtogroup Physics
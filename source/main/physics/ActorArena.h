@@ -0,0 +1,135 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Application.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Physics
+/// @{
+
+/// Single contiguous block of memory owning an actor's fixed-size simulation arrays.
+/// Usage: `Reserve<T>()` every array (sizing pass, see `ActorSpawner::ActorMemoryRequirements`),
+/// `Allocate()` once, then `Carve<T>()` the arrays in the same order. `Release()` frees everything at once.
+class ActorArena
+{
+public:
+    static const size_t ALIGNMENT = 64; //!< Cache line; every array starts on its own line.
+
+    ActorArena() {}
+    ~ActorArena() { this->Release(); }
+
+    ActorArena(ActorArena const&) = delete;
+    ActorArena& operator=(ActorArena const&) = delete;
+
+    template <typename T> void Reserve(size_t count)
+    {
+        ROR_ASSERT(m_block == nullptr);
+        m_capacity += AlignUp(sizeof(T) * count);
+    }
+
+    /// Allocates the reserved size in one go; memory is zero-filled.
+    void Allocate()
+    {
+        ROR_ASSERT(m_block == nullptr);
+        if (m_capacity == 0)
+            return;
+        m_raw = std::calloc(m_capacity + ALIGNMENT, 1);
+        if (m_raw == nullptr)
+            throw std::bad_alloc();
+        m_block = reinterpret_cast<char*>(AlignUp(reinterpret_cast<size_t>(m_raw)));
+        m_used = 0;
+    }
+
+    /// Hands out the next `count` elements, default-constructed; returns nullptr for zero count.
+    template <typename T> T* Carve(size_t count)
+    {
+        if (count == 0)
+            return nullptr;
+        const size_t size = AlignUp(sizeof(T) * count);
+        ROR_ASSERT(m_block != nullptr && m_used + size <= m_capacity);
+        T* array = reinterpret_cast<T*>(m_block + m_used);
+        m_used += size;
+        for (size_t i = 0; i < count; i++)
+        {
+            new (&array[i]) T();
+        }
+        if (!std::is_trivially_destructible<T>::value)
+        {
+            m_dtors.push_back(Dtor(array, count, &DestroyArray<T>));
+        }
+        return array;
+    }
+
+    /// Runs destructors of non-trivial arrays (reverse order) and frees the block.
+    void Release()
+    {
+        for (auto itor = m_dtors.rbegin(); itor != m_dtors.rend(); ++itor)
+        {
+            itor->fn(itor->ptr, itor->count);
+        }
+        m_dtors.clear();
+        std::free(m_raw);
+        m_raw = nullptr;
+        m_block = nullptr;
+        m_capacity = 0;
+        m_used = 0;
+    }
+
+    size_t GetCapacity() const { return m_capacity; }
+    size_t GetUsed() const     { return m_used; }
+
+private:
+    struct Dtor
+    {
+        Dtor(void* p, size_t c, void (*f)(void*, size_t)): ptr(p), count(c), fn(f) {}
+        void*  ptr;
+        size_t count;
+        void   (*fn)(void*, size_t);
+    };
+
+    template <typename T> static void DestroyArray(void* ptr, size_t count)
+    {
+        T* array = static_cast<T*>(ptr);
+        for (size_t i = 0; i < count; i++)
+        {
+            array[i].~T();
+        }
+    }
+
+    static size_t AlignUp(size_t value) { return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+    void*             m_raw = nullptr;
+    char*             m_block = nullptr;
+    size_t            m_capacity = 0;
+    size_t            m_used = 0;
+    std::vector<Dtor> m_dtors;
+};
+
+/// @} // addtogroup Physics
+
+} // namespace RoR
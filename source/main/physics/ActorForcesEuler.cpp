@@ -80,8 +80,9 @@ void Actor::CalcForceFeedback(bool doUpdate)
             m_force_sensors.accu_body_forces += ar_nodes[ar_camera_node_pos[ar_current_cinecam]].Forces;
         }
 
-        for (hydrobeam_t& hydrobeam: ar_hydros)
+        for (int i = 0; i < ar_num_hydros; i++)
         {
+            hydrobeam_t& hydrobeam = ar_hydros[i];
             beam_t* beam = &ar_beams[hydrobeam.hb_beam_index];
             if ((hydrobeam.hb_flags & (HYDRO_FLAG_DIR | HYDRO_FLAG_SPEED)) && !beam->bm_broken)
             {
@@ -116,10 +117,27 @@ void Actor::CalcAircraftForces(bool doUpdate)
         if (ar_screwprops[i])
             ar_screwprops[i]->updateForces(doUpdate);
 
-    //wing forces
-    for (int i = 0; i < ar_num_wings; i++)
-        if (ar_wings[i].fa)
-            ar_wings[i].fa->updateForces();
+    //wing forces - gather all segments, evaluate the polars in one batch, then scatter forces
+    if (ar_num_wings > 0)
+    {
+        m_wing_batch.resize(ar_num_wings);
+        bool any_active = false;
+        for (int i = 0; i < ar_num_wings; i++)
+        {
+            if (ar_wings[i].fa)
+                any_active |= ar_wings[i].fa->prepareForces(m_wing_batch, i);
+            else
+                m_wing_batch.polar[i] = nullptr;
+        }
+
+        if (any_active)
+        {
+            Airfoil::getparamsBatch(m_wing_batch);
+            for (int i = 0; i < ar_num_wings; i++)
+                if (m_wing_batch.polar[i])
+                    ar_wings[i].fa->applyForces(m_wing_batch, i);
+        }
+    }
 }
 
 void Actor::CalcFuseDrag()
@@ -162,100 +180,38 @@ void Actor::CalcBuoyance(bool doUpdate)
 
 void Actor::CalcDifferentials()
 {
+    if (m_drivetrain_solver.GetNumDiffs() == 0 && !(ar_engine && m_num_proped_wheels > 0))
+        return;
+
+    DrivetrainEngine* engine = nullptr;
     if (ar_engine && m_num_proped_wheels > 0)
     {
-        float torque = ar_engine->GetTorque() / m_num_proped_wheels;
-        if (m_has_axles_section)
-        {
-            torque *= 2.0f; // Required to stay backwards compatible
-        }
-        for (int i = 0; i < ar_num_wheels; i++)
-        {
-            if (ar_wheels[i].wh_propulsed && !ar_wheels[i].wh_is_detached)
-                ar_wheels[i].wh_torque += torque;
-        }
+        engine = &m_drivetrain_engine;
+        engine->de_rpm = ar_engine->GetEngineRpm();
+        engine->de_inertia = ar_engine->GetEngineInertia();
+        ar_engine->GetClutchCoupling(engine->de_gear_ratio, engine->de_clutch_damp, engine->de_clutch_limit);
+        engine->de_torque_scale = (m_has_axles_section) ? 2.0f : 1.0f; // Required to stay backwards compatible
     }
 
-    int num_axle_diffs = (m_transfer_case && m_transfer_case->tr_4wd_mode) ? m_num_axle_diffs + 1 : m_num_axle_diffs;
-
-    // Handle detached wheels
-    for (int i = 0; i < num_axle_diffs; i++)
-    {
-        int a_1 = m_axle_diffs[i]->di_idx_1;
-        int a_2 = m_axle_diffs[i]->di_idx_2;
-        wheel_t* axle_1_wheels[2] = {&ar_wheels[m_wheel_diffs[a_1]->di_idx_1], &ar_wheels[m_wheel_diffs[a_1]->di_idx_2]};
-        wheel_t* axle_2_wheels[2] = {&ar_wheels[m_wheel_diffs[a_2]->di_idx_1], &ar_wheels[m_wheel_diffs[a_2]->di_idx_2]};
-        if (axle_1_wheels[0]->wh_is_detached && axle_1_wheels[1]->wh_is_detached)
-        {
-            axle_1_wheels[0]->wh_speed = axle_2_wheels[0]->wh_speed;
-            axle_1_wheels[1]->wh_speed = axle_2_wheels[1]->wh_speed;
-        }
-        if (axle_2_wheels[0]->wh_is_detached && axle_2_wheels[1]->wh_is_detached)
-        {
-            axle_2_wheels[0]->wh_speed = axle_1_wheels[0]->wh_speed;
-            axle_2_wheels[1]->wh_speed = axle_1_wheels[1]->wh_speed;
-        }
-    }
-    for (int i = 0; i < m_num_wheel_diffs; i++)
+    m_drivetrain_wheels.resize(ar_num_wheels);
+    for (int i = 0; i < ar_num_wheels; i++)
     {
-        wheel_t* axle_wheels[2] = {&ar_wheels[m_wheel_diffs[i]->di_idx_1], &ar_wheels[m_wheel_diffs[i]->di_idx_2]};
-        if (axle_wheels[0]->wh_is_detached) axle_wheels[0]->wh_speed = axle_wheels[1]->wh_speed;
-        if (axle_wheels[1]->wh_is_detached) axle_wheels[1]->wh_speed = axle_wheels[0]->wh_speed;
+        const wheel_t& wheel = ar_wheels[i];
+        m_drivetrain_wheels[i] = {wheel.wh_speed, wheel.wh_torque, wheel.wh_radius * wheel.wh_mass, wheel.wh_mass,
+                                  wheel.wh_radius, wheel.wh_last_retorque, wheel.wh_propulsed, wheel.wh_is_detached};
     }
 
-    // loop through all interaxle differentials, this is the torsion to keep
-    // the axles aligned with each other as if they connected by a shaft
-    for (int i = 0; i < num_axle_diffs; i++)
-    {
-        int a_1 = m_axle_diffs[i]->di_idx_1;
-        int a_2 = m_axle_diffs[i]->di_idx_2;
+    // engine -> clutch -> gearbox -> transfer case -> differentials -> wheels, all solved at once
+    m_drivetrain_solver.Solve(m_drivetrain_wheels.data(), ar_num_wheels, engine, PHYSICS_DT);
 
-        Ogre::Real axle_torques[2] = {0.0f, 0.0f};
-        DifferentialData diff_data =
-        {
-            {
-                (ar_wheels[m_wheel_diffs[a_1]->di_idx_1].wh_speed + ar_wheels[m_wheel_diffs[a_1]->di_idx_2].wh_speed) * 0.5f,
-                (ar_wheels[m_wheel_diffs[a_2]->di_idx_1].wh_speed + ar_wheels[m_wheel_diffs[a_2]->di_idx_2].wh_speed) * 0.5f
-            },
-            m_axle_diffs[i]->di_delta_rotation,
-            {axle_torques[0], axle_torques[1]},
-            ar_wheels[m_wheel_diffs[a_1]->di_idx_1].wh_torque + ar_wheels[m_wheel_diffs[a_1]->di_idx_2].wh_torque +
-            ar_wheels[m_wheel_diffs[a_2]->di_idx_1].wh_torque + ar_wheels[m_wheel_diffs[a_2]->di_idx_2].wh_torque,
-            PHYSICS_DT
-        };
-
-        m_axle_diffs[i]->CalcAxleTorque(diff_data);
-
-        m_axle_diffs[i]->di_delta_rotation = diff_data.delta_rotation;
-
-        ar_wheels[m_wheel_diffs[a_1]->di_idx_1].wh_torque = diff_data.out_torque[0] * 0.5f;
-        ar_wheels[m_wheel_diffs[a_1]->di_idx_2].wh_torque = diff_data.out_torque[0] * 0.5f;
-        ar_wheels[m_wheel_diffs[a_2]->di_idx_1].wh_torque = diff_data.out_torque[1] * 0.5f;
-        ar_wheels[m_wheel_diffs[a_2]->di_idx_2].wh_torque = diff_data.out_torque[1] * 0.5f;
+    for (int i = 0; i < ar_num_wheels; i++)
+    {
+        ar_wheels[i].wh_speed = m_drivetrain_wheels[i].dw_speed;
+        ar_wheels[i].wh_torque = m_drivetrain_wheels[i].dw_torque;
     }
-
-    // loop through all interwheel differentials, this is the torsion to keep
-    // the wheels aligned with each other as if they connected by a shaft
-    for (int i = 0; i < m_num_wheel_diffs; i++)
+    if (engine)
     {
-        Ogre::Real axle_torques[2] = {0.0f, 0.0f};
-        wheel_t* axle_wheels[2] = {&ar_wheels[m_wheel_diffs[i]->di_idx_1], &ar_wheels[m_wheel_diffs[i]->di_idx_2]};
-
-        DifferentialData diff_data =
-        {
-            {axle_wheels[0]->wh_speed, axle_wheels[1]->wh_speed},
-            m_wheel_diffs[i]->di_delta_rotation,
-            {axle_torques[0], axle_torques[1]},
-            axle_wheels[0]->wh_torque + axle_wheels[1]->wh_torque,
-            PHYSICS_DT
-        };
-
-        m_wheel_diffs[i]->CalcAxleTorque(diff_data);
-
-        m_wheel_diffs[i]->di_delta_rotation = diff_data.delta_rotation;
-
-        ar_wheels[m_wheel_diffs[i]->di_idx_1].wh_torque = diff_data.out_torque[0];
-        ar_wheels[m_wheel_diffs[i]->di_idx_2].wh_torque = diff_data.out_torque[1];
+        ar_engine->ApplyClutchTorque(engine->de_clutch_torque, PHYSICS_DT);
     }
 }
 
@@ -545,14 +501,16 @@ void Actor::CalcShocks(bool doUpdate, int num_steps)
 
 void Actor::CalcHydros()
 {
+    SimSettings const& settings = App::GetGameContext()->GetActorManager()->GetSimSettings();
+
     //direction
     if (ar_hydro_dir_state != 0 || ar_hydro_dir_command != 0)
     {
         if (!ar_hydro_speed_coupling)
         {
             // need a maximum rate for analog devices, otherwise hydro beams break
-            float smoothing   = Math::Clamp(App::io_analog_smoothing->getFloat(),   0.5f, 2.0f);
-            float sensitivity = Math::Clamp(App::io_analog_sensitivity->getFloat(), 0.5f, 2.0f);
+            const float smoothing   = settings.io_analog_smoothing;
+            const float sensitivity = settings.io_analog_sensitivity;
             float diff = ar_hydro_dir_command - ar_hydro_dir_state;
             float rate = std::exp(-std::min(std::abs(diff), 1.0f) / sensitivity) * diff;
             ar_hydro_dir_state += (10.0f / smoothing) * PHYSICS_DT * rate;
@@ -561,7 +519,7 @@ void Actor::CalcHydros()
         {
             if (ar_hydro_dir_command != 0)
             {
-                if (!App::io_hydro_coupling->getBool())
+                if (!settings.io_hydro_coupling)
                 {
                     float rate = std::max(1.2f, 30.0f / (10.0f));
                     if (ar_hydro_dir_state > ar_hydro_dir_command)
@@ -643,8 +601,14 @@ void Actor::CalcHydros()
         else
             ar_hydro_elevator_state = 0;
     }
+    // Animator sources, shared by all hydros
+    if (!m_animator_table.IsEmpty())
+    {
+        this->UpdateAnimatorSources();
+    }
+
     //update length, dirstate between -1.0 and 1.0
-    const int num_hydros = static_cast<int>(ar_hydros.size());
+    const int num_hydros = ar_num_hydros;
     for (int i = 0; i < num_hydros; ++i)
     {
         hydrobeam_t& hydrobeam = ar_hydros[i];
@@ -1602,16 +1566,29 @@ void Actor::CalcNodes()
             drag += maxtur * Vector3(frand_11(), frand_11(), frand_11());
             ar_nodes[i].Forces += drag;
         }
+    }
+
+    if (water)
+    {
+        // Query the wave heights for all nodes at once
+        m_water_query_pos.resize(ar_num_nodes);
+        m_water_query_heights.resize(ar_num_nodes);
+        for (NodeNum_t i = 0; i < ar_num_nodes; i++)
+        {
+            m_water_query_pos[i] = ar_nodes[i].AbsPosition;
+        }
+        water->CalcWavesHeights(m_water_query_pos.data(), m_water_query_heights.data(), ar_num_nodes);
 
-        if (water)
+        for (NodeNum_t i = 0; i < ar_num_nodes; i++)
         {
-            const bool is_under_water = water->IsUnderWater(ar_nodes[i].AbsPosition);
+            const bool is_under_water = ar_nodes[i].AbsPosition.y < m_water_query_heights[i];
             if (is_under_water)
             {
                 m_water_contact = true;
                 if (ar_num_buoycabs == 0)
                 {
                     // water drag (turbulent)
+                    Real approx_speed = approx_sqrt(ar_nodes[i].Velocity.squaredLength());
                     ar_nodes[i].Forces -= (DEFAULT_WATERDRAG * approx_speed) * ar_nodes[i].Velocity;
                     // basic buoyance
                     ar_nodes[i].Forces += ar_nodes[i].buoyancy * Vector3::UNIT_Y;
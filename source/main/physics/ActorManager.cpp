@@ -29,6 +29,7 @@
 #include "Actor.h"
 #include "CacheSystem.h"
 #include "ContentManager.h"
+#include "Character.h"
 #include "ChatSystem.h"
 #include "Collisions.h"
 #include "DashBoardManager.h"
@@ -45,6 +46,7 @@
 #include "Network.h"
 #include "PointColDetector.h"
 #include "Replay.h"
+#include "RigDef_BinaryCache.h"
 #include "RigDef_Validator.h"
 #include "ActorSpawner.h"
 #include "ScriptEngine.h"
@@ -303,6 +305,11 @@ ActorPtr ActorManager::CreateNewActor(ActorSpawnRequest rq, RigDef::DocumentPtr
 
         if (rq.asr_origin == ActorSpawnRequest::Origin::NETWORK)
         {
+            actor->m_net_frames.Init(actor->m_net_first_wheel_node, actor->ar_num_wheels, actor->m_net_node_compression);
+            actor->m_net_node_pos.resize(actor->m_net_first_wheel_node, Ogre::Vector3::ZERO);
+            actor->m_net_node_vel.resize(actor->m_net_first_wheel_node, Ogre::Vector3::ZERO);
+            actor->m_net_wheel_rp.resize(actor->ar_num_wheels, 0.f);
+
             actor->ar_state = ActorState::NETWORKED_OK;
             if (actor->ar_engine)
             {
@@ -909,11 +916,18 @@ std::pair<ActorPtr, float> ActorManager::GetNearestActor(Vector3 position)
 
 void ActorManager::CleanUpSimulation() // Called after simulation finishes
 {
+    this->SyncWithSimThread();
+    m_physics_recorder.Stop();
+
     while (m_actors.size() > 0)
     {
         this->DeleteActorInternal(m_actors.back());
     }
 
+#ifdef USE_ANGELSCRIPT
+    m_traffic_manager.GetLaneGraph().Clear();
+#endif // USE_ANGELSCRIPT
+
     m_total_sim_time = 0.f;
     m_last_simulation_speed = 0.1f;
     m_simulation_paused = false;
@@ -947,6 +961,7 @@ void ActorManager::DeleteActorInternal(ActorPtr actor)
     actor->dispose();
 
     EraseIf(m_actors, [actor](ActorPtr& curActor) { return actor == curActor; });
+    m_actor_queries.RemoveActor(actor);
 
     // Upate actor indices
     for (unsigned int i = 0; i < m_actors.size(); i++)
@@ -1045,6 +1060,117 @@ const ActorPtr& ActorManager::FetchRescueVehicle()
     return ACTORPTR_NULL;
 }
 
+void ActorManager::UpdateActorQueries()
+{
+    m_actor_queries.Refit(m_actors);
+}
+
+#ifdef USE_ANGELSCRIPT
+
+namespace {
+
+/// Answers the traffic queries for the actors gathered by `ActorManager::UpdateTraffic()`.
+class ActorTrafficQueries: public TrafficQueries
+{
+public:
+    ActorTrafficQueries(ActorQueries const& queries, std::vector<ActorPtr> const& actors)
+        : m_queries(queries), m_actors(actors) {}
+
+    bool AreActorsWithin(int a, int b, float distance) const override
+    {
+        return m_queries.AreActorsWithin(m_actors[a], m_actors[b], distance);
+    }
+
+    bool IsActorNodeWithin(int actor, Ogre::Vector3 const& point, float distance) const override
+    {
+        ActorNodeQueryResult closest;
+        return m_queries.FindClosestNode(point, distance, closest, 0, m_actors[actor]);
+    }
+
+private:
+    ActorQueries const&          m_queries;
+    std::vector<ActorPtr> const& m_actors;
+};
+
+} // namespace
+
+void ActorManager::UpdateTraffic(float dt)
+{
+    // Gather
+    m_traffic_actors.clear();
+    m_traffic_states.clear();
+    for (ActorPtr const& actor : m_actors)
+    {
+        if (actor->ar_state == ActorState::DISPOSED)
+            continue;
+
+        TrafficActorState state;
+        state.tas_position = actor->getPosition();
+        state.tas_driveable = (actor->ar_driveable != NOT_DRIVEABLE);
+        if (!actor->ar_bounding_box.isNull())
+        {
+            state.tas_box_min = actor->ar_bounding_box.getMinimum();
+            state.tas_box_max = actor->ar_bounding_box.getMaximum();
+        }
+        else
+        {
+            state.tas_box_min = state.tas_position;
+            state.tas_box_max = state.tas_position;
+        }
+        const Vector3 far_corner(
+            std::max(state.tas_box_max.x - state.tas_position.x, state.tas_position.x - state.tas_box_min.x), 0.f,
+            std::max(state.tas_box_max.z - state.tas_position.z, state.tas_position.z - state.tas_box_min.z));
+        state.tas_radius = far_corner.length();
+
+        if (actor->ar_vehicle_ai && actor->ar_vehicle_ai->isActive())
+        {
+            state.tas_agent = actor->ar_vehicle_ai.GetRef();
+            state.tas_direction = actor->getDirection();
+            state.tas_rotation = actor->getRotation();
+            state.tas_wheel_speed = actor->getWheelSpeed();
+            state.tas_camera_dir = actor->GetCameraDir();
+            state.tas_camera_roll = actor->GetCameraRoll();
+            state.tas_camera_velocity = actor->ar_nodes[actor->ar_main_camera_node_pos].Velocity;
+            state.tas_has_engine = (actor->ar_engine != nullptr);
+            state.tas_num_screwprops = actor->ar_num_screwprops;
+            state.tas_num_aeroengines = actor->ar_num_aeroengines;
+        }
+
+        m_traffic_actors.push_back(actor);
+        m_traffic_states.push_back(state);
+    }
+
+    TrafficWorldState world;
+    ActorPtr player_actor = App::GetGameContext()->GetPlayerActor();
+    if (player_actor)
+    {
+        world.tws_player_in_vehicle = true;
+        world.tws_player_actor_pos = player_actor->getPosition();
+        world.tws_player_actor_speed = player_actor->getSpeed();
+    }
+    Character* character = App::GetGameContext()->GetPlayerCharacter();
+    if (character)
+    {
+        world.tws_character_pos = character->getPosition();
+        world.tws_character_on_foot = (character->GetActorCoupling() == nullptr);
+    }
+
+    // Compute
+    const ActorTrafficQueries queries(m_actor_queries, m_traffic_actors);
+    m_traffic_manager.Update(m_traffic_states, world, queries, dt);
+
+    // Apply
+    for (size_t i = 0; i < m_traffic_states.size(); i++)
+    {
+        if (m_traffic_states[i].tas_agent)
+        {
+            m_traffic_states[i].tas_agent->applyUpdate(m_traffic_actors[i]);
+        }
+    }
+}
+
+#endif // USE_ANGELSCRIPT
+
 void ActorManager::UpdateActors(ActorPtr player_actor)
 {
     float dt = m_simulation_time;
@@ -1066,18 +1192,18 @@ void ActorManager::UpdateActors(ActorPtr player_actor)
 
     this->SyncWithSimThread();
 
+    this->UpdateSimSettings();
     this->UpdateSleepingState(player_actor, dt);
 
+#ifdef USE_ANGELSCRIPT
+    this->UpdateTraffic(dt);
+#endif // USE_ANGELSCRIPT
+
     for (ActorPtr& actor: m_actors)
     {
         actor->HandleInputEvents(dt);
         actor->HandleAngelScriptEvents(dt);
 
-#ifdef USE_ANGELSCRIPT
-        if (actor->ar_vehicle_ai && actor->ar_vehicle_ai->isActive())
-            actor->ar_vehicle_ai->update(dt, 0);
-#endif // USE_ANGELSCRIPT
-
         if (actor->ar_engine)
         {
             if (actor->ar_driveable == TRUCK)
@@ -1208,7 +1334,7 @@ void ActorManager::UpdatePhysicsSimulation()
             for (ActorPtr& actor: m_actors)
             {
                 if (actor->m_inter_point_col_detector != nullptr && (actor->ar_update_physics ||
-                        (App::mp_pseudo_collisions->getBool() && actor->ar_state == ActorState::NETWORKED_OK)))
+                        (m_sim_settings.mp_pseudo_collisions && actor->ar_state == ActorState::NETWORKED_OK)))
                 {
                     auto func = std::function<void()>([this, &actor]()
                         {
@@ -1231,6 +1357,7 @@ void ActorManager::UpdatePhysicsSimulation()
             }
             App::GetThreadPool()->Parallelize(tasks);
         }
+        m_physics_recorder.OnPhysicsStep();
     }
     for (ActorPtr& actor: m_actors)
     {
@@ -1256,6 +1383,21 @@ void ActorManager::SyncWithSimThread()
         m_sim_task->join();
 }
 
+void ActorManager::UpdateSimSettings()
+{
+    if (m_sim_settings_revision == CVar::getRevision())
+        return;
+
+    m_sim_settings.io_analog_smoothing   = Math::Clamp(App::io_analog_smoothing->getFloat(),   0.5f, 2.0f);
+    m_sim_settings.io_analog_sensitivity = Math::Clamp(App::io_analog_sensitivity->getFloat(), 0.5f, 2.0f);
+    m_sim_settings.io_hydro_coupling     = App::io_hydro_coupling->getBool();
+    m_sim_settings.sim_self_collision_hops = std::max(0, App::sim_self_collision_hops->getInt());
+    m_sim_settings.gfx_water_waves       = App::gfx_water_waves->getBool();
+    m_sim_settings.mp_pseudo_collisions  = App::mp_pseudo_collisions->getBool();
+    m_sim_settings.mp_state              = App::mp_state->getEnum<MpState>();
+    m_sim_settings_revision = CVar::getRevision();
+}
+
 void HandleErrorLoadingFile(std::string type, std::string filename, std::string exception_msg)
 {
     RoR::Str<200> msg;
@@ -1303,15 +1445,33 @@ RigDef::DocumentPtr ActorManager::FetchActorDef(std::string filename, bool prede
             return nullptr;
         }
 
-        RoR::LogFormat("[RoR] Parsing truckfile '%s'", resource_filename.c_str());
-        RigDef::Parser parser;
-        parser.Prepare();
-        parser.ProcessOgreStream(stream.getPointer(), resource_groupname);
-        parser.Finalize();
+        // Use the compiled truckfile if available, otherwise parse it and save it compiled
+        const std::string hash = Sha1Hash(stream->getAsString());
+        RigDef::DocumentPtr def = RigDef::BinaryCache::Load(hash);
+        if (def)
+        {
+            RoR::LogFormat("[RoR] Loaded compiled truckfile '%s' from cache", resource_filename.c_str());
+            for (RigDef::Document::Message const& msg: def->messages)
+            {
+                App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_ACTOR, msg.type, msg.text);
+            }
+        }
+        else
+        {
+            stream->seek(0);
+
+            RoR::LogFormat("[RoR] Parsing truckfile '%s'", resource_filename.c_str());
+            RigDef::Parser parser;
+            parser.Prepare();
+            parser.ProcessOgreStream(stream.getPointer(), resource_groupname);
+            parser.Finalize();
 
-        auto def = parser.GetFile();
+            def = parser.GetFile();
+            def->hash = hash;
+            RigDef::BinaryCache::Save(def); // Before validating, which edits the document
+        }
 
-        // VALIDATING
+        // VALIDATING - also the compiled truckfile, the validator's messages aren't cached
         LOG(" == Validating vehicle: " + def->name);
 
         RigDef::Validator validator;
@@ -1333,8 +1493,6 @@ RigDef::DocumentPtr ActorManager::FetchActorDef(std::string filename, bool prede
 
         validator.Validate(); // Sends messages to console
 
-        def->hash = Sha1Hash(stream->getAsString());
-
         cache_entry->actor_def = def;
         return def;
     }
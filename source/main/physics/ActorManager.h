@@ -25,12 +25,15 @@
 #pragma once
 
 #include "Actor.h"
+#include "ActorQueries.h"
 #include "Application.h"
 #include "SimData.h"
 #include "CmdKeyInertia.h"
 #include "Network.h"
+#include "PhysicsRecorder.h"
 #include "RigDef_Prerequisites.h"
 #include "ThreadPool.h"
+#include "TrafficManager.h"
 
 #include <string>
 #include <vector>
@@ -42,6 +45,19 @@ namespace RoR {
 /// @addtogroup Physics
 /// @{
 
+/// CVars read by the simulation, copied once per frame (only when any CVar changed) before the sim thread is started.
+/// Physics code reads this instead of the CVars: the values stay constant for the whole step even if the console changes them.
+struct SimSettings
+{
+    float          io_analog_smoothing   = 1.f;   //!< Clamped to 0.5 - 2.0
+    float          io_analog_sensitivity = 1.f;   //!< Clamped to 0.5 - 2.0
+    bool           io_hydro_coupling     = true;
+    int            sim_self_collision_hops = 0;   //!< Self-collision ignores nodes within this many beams of a triangle
+    bool           gfx_water_waves       = false;
+    bool           mp_pseudo_collisions  = false;
+    MpState        mp_state              = MpState::DISABLED;
+};
+
 /// Builds and manages softbody actors (physics on background thread, networking)
 class ActorManager
 {
@@ -67,6 +83,7 @@ public:
     /// @}
 
     void           UpdateActors(ActorPtr player_actor);
+    void           UpdateActorQueries();                   //!< Refits `GetActorQueries()` from the simulation buffers; call right after they're refilled.
     void           SyncWithSimThread();
     void           UpdatePhysicsSimulation();
     void           WakeUpAllActors();
@@ -87,6 +104,13 @@ public:
     void           SetSimulationPaused(bool v)             { m_simulation_paused = v; }
     float          GetTotalTime() const                    { return m_total_sim_time; }
     RoR::CmdKeyInertiaConfig& GetInertiaConfig()           { return m_inertia_config; }
+    SimSettings const& GetSimSettings() const              { return m_sim_settings; }
+    void           UpdateSimSettings();                    //!< Rebuilds the snapshot if any CVar changed; Do not call while the sim thread runs.
+    PhysicsRecorder& GetPhysicsRecorder()                  { return m_physics_recorder; }
+    ActorQueries const& GetActorQueries() const            { return m_actor_queries; } //!< Node/collcab proximity and ray queries, as of the last simulation buffers; frozen with them while paused.
+#ifdef USE_ANGELSCRIPT
+    TrafficManager& GetTrafficManager()                    { return m_traffic_manager; }
+#endif // USE_ANGELSCRIPT
 
     void           CleanUpSimulation(); //!< Call this after simulation loop finishes.
 
@@ -129,6 +153,9 @@ private:
     void           RecursiveActivation(int j, std::vector<bool>& visited);
     void           ForwardCommands(ActorPtr source_actor); //!< Fowards things to trailers
     void           UpdateTruckFeatures(ActorPtr vehicle, float dt);
+#ifdef USE_ANGELSCRIPT
+    void           UpdateTraffic(float dt);                //!< Snapshots the actors for `TrafficManager::Update()` and applies the `VehicleAI` decisions
+#endif // USE_ANGELSCRIPT
 
     // Networking
     std::map<int, std::set<int>> m_stream_mismatches; //!< Networking: A set of streams without a corresponding actor in the actor-array for each stream source
@@ -145,6 +172,15 @@ private:
     float               m_simulation_time        = 0.f;   //!< Amount of time the physics simulation is going to be advanced
     bool                m_simulation_paused      = false;
     float               m_total_sim_time         = 0.f;
+    SimSettings         m_sim_settings;
+    unsigned int        m_sim_settings_revision  = ~0u;      //!< `CVar::getRevision()` at the time of the snapshot
+    PhysicsRecorder     m_physics_recorder;               //!< Telemetry stream; sampled after every substep
+    ActorQueries        m_actor_queries;                  //!< Refitted from simulation buffers whenever they are refilled, see `UpdateActorQueries()`
+#ifdef USE_ANGELSCRIPT
+    TrafficManager      m_traffic_manager;                //!< Updates all `VehicleAI` agents together
+    std::vector<TrafficActorState> m_traffic_states;      //!< Scratch of `UpdateTraffic()`
+    ActorPtrVec         m_traffic_actors;                 //!< Scratch of `UpdateTraffic()`, same order as `m_traffic_states`
+#endif // USE_ANGELSCRIPT
 
     // Utils
     std::unique_ptr<ThreadPool> m_sim_thread_pool;
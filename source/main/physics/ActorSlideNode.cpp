@@ -28,11 +28,15 @@
 #include "Actor.h"
 #include "GameContext.h"
 
+#include <unordered_set>
+
 using namespace RoR;
 
 // ug... BAD PERFORMNCE, BAD!!
 void Actor::toggleSlideNodeLock()
 {
+    std::unordered_set<Actor*> refitted;
+
     // for every slide node on this truck
     for (std::vector<SlideNode>::iterator itNode = m_slidenodes.begin(); itNode != m_slidenodes.end(); itNode++)
     {
@@ -59,6 +63,10 @@ void Actor::toggleSlideNodeLock()
             if ((this != actor.GetRef() && !itNode->sn_attach_foreign) || (this == actor.GetRef() && !itNode->sn_attach_self))
                 continue;
 
+            // the rail boxes are only refit on demand; networked, sleeping and teleported actors move too
+            if (refitted.insert(actor.GetRef()).second)
+                actor->UpdateRailBvhs();
+
             current = GetClosestRailOnActor(actor, (*itNode));
             if (current.second < closest.second)
                 closest = current;
@@ -82,10 +90,16 @@ std::pair<RailGroup*, Ogre::Real> Actor::GetClosestRailOnActor(ActorPtr actor, c
          itGroup++)
     {
         // find the rail closest to the Node
-        if (*itGroup == nullptr)
+        if (*itGroup == nullptr || (*itGroup)->rg_bvh.IsEmpty())
+            continue;
+
+        // the root box is a lower bound for every segment in the group
+        const Ogre::Vector3 pos = node.GetSlideNodePosition();
+        BvhNode const& root = (*itGroup)->rg_bvh.bvh_nodes[0];
+        if (Bvh::GetDistToBox(pos, root.bvh_min, root.bvh_max) >= std::min(node.GetAttachmentDistance(), closest.second))
             continue;
 
-        curRail = (*itGroup)->FindClosestSegment(node.GetSlideNodePosition());
+        curRail = (*itGroup)->FindClosestSegment(pos);
         lenToCurRail = node.getLenTo(curRail);
 
         if (lenToCurRail < node.GetAttachmentDistance() && lenToCurRail < closest.second)
@@ -109,6 +123,14 @@ void Actor::updateSlideNodeForces(const Ogre::Real dt)
     }
 }
 
+void Actor::UpdateRailBvhs()
+{
+    for (RailGroup* railgroup : m_railgroups)
+    {
+        railgroup->RefitBvh();
+    }
+}
+
 void Actor::resetSlideNodePositions()
 {
     if (m_slidenodes.empty())
@@ -127,14 +127,16 @@ void ActorSpawner::CalcMemoryRequirements(ActorMemoryRequirements& req, RigDef::
     req.num_beams += module_def->ropes.size();
 
     // 'hydros'
-    req.num_beams += module_def->hydros.size();
+    req.num_beams  += module_def->hydros.size();
+    req.num_hydros += module_def->hydros.size();
 
     // 'triggers'
     req.num_beams  += module_def->triggers.size();
     req.num_shocks += module_def->triggers.size();
 
     // 'animators'
-    req.num_beams += module_def->animators.size();
+    req.num_beams  += module_def->animators.size();
+    req.num_hydros += module_def->animators.size();
 
     // 'cinecam'
     req.num_nodes += module_def->cinecam.size();
@@ -201,6 +203,32 @@ void ActorSpawner::CalcMemoryRequirements(ActorMemoryRequirements& req, RigDef::
 
     // 'fixes'
     req.num_fixes += module_def->fixes.size();
+
+    // 'slidenodes'
+    req.num_slidenodes += module_def->slidenodes.size();
+
+    // 'submesh' - mirrors the option checks in `ProcessSubmesh()`
+    for (RigDef::Submesh& submesh: module_def->submeshes)
+    {
+        req.num_cabs += submesh.cab_triangles.size() * ((submesh.backmesh) ? 3 : 1);
+        for (RigDef::Cab& cab: submesh.cab_triangles)
+        {
+            const bool contact =
+                BITMASK_IS_1(cab.options, RigDef::Cab::OPTION_c_CONTACT) ||
+                BITMASK_IS_1(cab.options, RigDef::Cab::OPTION_p_10xTOUGHER) ||
+                BITMASK_IS_1(cab.options, RigDef::Cab::OPTION_u_INVULNERABLE);
+            const bool contact_buoyant =
+                BITMASK_IS_1(cab.options, RigDef::Cab::OPTION_D_CONTACT_BUOYANT) ||
+                BITMASK_IS_1(cab.options, RigDef::Cab::OPTION_F_10xTOUGHER_BUOYANT) ||
+                BITMASK_IS_1(cab.options, RigDef::Cab::OPTION_S_INVULNERABLE_BUOYANT);
+
+            req.num_collcabs += (contact ? 1 : 0) + (contact_buoyant ? 1 : 0);
+            req.num_buoycabs += (BITMASK_IS_1(cab.options, RigDef::Cab::OPTION_b_BUOYANT) ? 1 : 0)
+                              + (BITMASK_IS_1(cab.options, RigDef::Cab::OPTION_r_BUOYANT_ONLY_DRAG) ? 1 : 0)
+                              + (BITMASK_IS_1(cab.options, RigDef::Cab::OPTION_s_BUOYANT_NO_DRAG) ? 1 : 0)
+                              + (contact_buoyant ? 1 : 0);
+        }
+    }
 }
 
 void ActorSpawner::InitializeRig()
@@ -211,39 +239,56 @@ void ActorSpawner::InitializeRig()
         this->CalcMemoryRequirements(req, module.get());
     }
 
-    // Allocate memory as needed
-    m_actor->ar_beams = new beam_t[req.num_beams];
-    m_actor->ar_nodes = new node_t[req.num_nodes];
-    m_actor->ar_nodes_id = new int[req.num_nodes];
+    // Allocate memory as needed - all fixed-size simulation arrays live in one block (see `ActorArena`),
+    // laid out in the order `Actor::CalcForcesEulerCompute()` touches them; cold spawn-time data goes last.
+    ActorArena& arena = m_actor->m_arena;
+    arena.Release();
+    arena.Reserve<node_t>(req.num_nodes);
+    arena.Reserve<wing_t>(req.num_wings);
+    arena.Reserve<shock_t>(req.num_shocks);
+    arena.Reserve<hydrobeam_t>(req.num_hydros);
+    arena.Reserve<rotator_t>(req.num_rotators);
+    arena.Reserve<beam_t>(req.num_beams);
+    arena.Reserve<int>(req.num_collcabs);
+    arena.Reserve<collcab_rate_t>(req.num_collcabs);
+    arena.Reserve<collcab_rate_t>(req.num_collcabs);
+    arena.Reserve<int>(req.num_cabs * 3);
+    arena.Reserve<int>(req.num_buoycabs);
+    arena.Reserve<int>(req.num_buoycabs);
+    arena.Reserve<int>(req.num_nodes);
+    arena.Reserve<std::string>(req.num_nodes);
+    arena.Allocate();
+
+    m_actor->ar_nodes             = arena.Carve<node_t>(req.num_nodes);
+    m_actor->ar_wings             = arena.Carve<wing_t>(req.num_wings);
+    m_actor->ar_shocks            = arena.Carve<shock_t>(req.num_shocks);
+    m_actor->ar_hydros            = arena.Carve<hydrobeam_t>(req.num_hydros);
+    m_actor->ar_rotators          = arena.Carve<rotator_t>(req.num_rotators);
+    m_actor->ar_beams             = arena.Carve<beam_t>(req.num_beams);
+    m_actor->ar_collcabs          = arena.Carve<int>(req.num_collcabs);
+    m_actor->ar_inter_collcabrate = arena.Carve<collcab_rate_t>(req.num_collcabs);
+    m_actor->ar_intra_collcabrate = arena.Carve<collcab_rate_t>(req.num_collcabs);
+    m_actor->ar_cabs              = arena.Carve<int>(req.num_cabs * 3);
+    m_actor->ar_buoycabs          = arena.Carve<int>(req.num_buoycabs);
+    m_actor->ar_buoycab_types     = arena.Carve<int>(req.num_buoycabs);
+    m_actor->ar_nodes_id          = arena.Carve<int>(req.num_nodes);
+    m_actor->ar_nodes_name        = arena.Carve<std::string>(req.num_nodes);
     for (size_t i = 0; i < req.num_nodes; ++i)
     {
         m_actor->ar_nodes_id[i] = -1;
     }
-    m_actor->ar_nodes_name = new std::string[req.num_nodes];
-
-    if (req.num_shocks > 0)
-        m_actor->ar_shocks = new shock_t[req.num_shocks];
-
-    if (req.num_rotators > 0)
-        m_actor->ar_rotators = new rotator_t[req.num_rotators];
-
-    if (req.num_wings > 0)
-        m_actor->ar_wings = new wing_t[req.num_wings];
+    m_actor->ar_num_hydros = 0;
 
     m_actor->ar_minimass.resize(req.num_nodes);
+    m_actor->m_slidenodes.reserve(req.num_slidenodes);
 
     m_actor->exhausts.clear();
     memset(m_actor->ar_custom_particles, 0, sizeof(cparticle_t) * MAX_CPARTICLES);
     m_actor->ar_num_custom_particles = 0;
     memset(m_actor->ar_soundsources, 0, sizeof(soundsource_t) * MAX_SOUNDSCRIPTS_PER_TRUCK);
     m_actor->ar_num_soundsources = 0;
-    memset(m_actor->ar_collcabs, 0, sizeof(int) * MAX_CABS);
-    memset(m_actor->ar_inter_collcabrate, 0, sizeof(collcab_rate_t) * MAX_CABS);
     m_actor->ar_num_collcabs = 0;
-    memset(m_actor->ar_intra_collcabrate, 0, sizeof(collcab_rate_t) * MAX_CABS);
-    memset(m_actor->ar_buoycabs, 0, sizeof(int) * MAX_CABS);
     m_actor->ar_num_buoycabs = 0;
-    memset(m_actor->ar_buoycab_types, 0, sizeof(int) * MAX_CABS);
     memset(m_actor->m_skid_trails, 0, sizeof(Skidmark *) * (MAX_WHEELS*2));
 
     m_actor->authors.clear();
@@ -281,7 +326,7 @@ void ActorSpawner::InitializeRig()
     }
 
 #ifdef USE_ANGELSCRIPT
-    m_actor->ar_vehicle_ai = new VehicleAI(m_actor);
+    m_actor->ar_vehicle_ai = new VehicleAI(m_actor->ar_instance_id, App::GetGameContext()->GetActorManager()->GetTrafficManager().GetLaneGraph());
 #endif // USE_ANGELSCRIPT
 
     m_actor->ar_airbrake_intensity = 0;
@@ -408,7 +453,7 @@ void ActorSpawner::FinalizeRig()
     m_actor->ar_main_camera_node_dir  = (m_actor->ar_camera_node_dir[0] != NODENUM_INVALID) ? m_actor->ar_camera_node_dir[0]  : (NodeNum_t)0;
     m_actor->ar_main_camera_node_roll = (m_actor->ar_camera_node_roll[0]!= NODENUM_INVALID) ? m_actor->ar_camera_node_roll[0] : (NodeNum_t)0;
     
-    m_actor->m_has_axles_section = m_actor->m_num_wheel_diffs > 0;
+    m_actor->m_has_axles_section = !m_actor->m_wheel_diffs.empty();
 
     // Calculate mass of each wheel (without rim)
     for (int i = 0; i < m_actor->ar_num_wheels; i++)
@@ -434,7 +479,7 @@ void ActorSpawner::FinalizeRig()
     }
 
     // Automatically build interwheel differentials from proped wheel pairs
-    if (m_actor->m_num_wheel_diffs == 0)
+    if (m_actor->m_wheel_diffs.empty())
     {
         for (int i = 1; i < m_actor->m_num_proped_wheels; i++)
         {
@@ -447,16 +492,15 @@ void ActorSpawner::FinalizeRig()
 
                 diff->AddDifferentialType(VISCOUS_DIFF);
 
-                m_actor->m_wheel_diffs[m_actor->m_num_wheel_diffs] = diff;
-                m_actor->m_num_wheel_diffs++;
+                m_actor->m_wheel_diffs.push_back(diff);
             }
         }
     }
 
     // Automatically build interaxle differentials from interwheel differentials pairs
-    if (m_actor->m_num_axle_diffs == 0)
+    if (m_actor->m_axle_diffs.empty())
     {
-        for (int i = 1; i < m_actor->m_num_wheel_diffs; i++)
+        for (int i = 1; i < static_cast<int>(m_actor->m_wheel_diffs.size()); i++)
         {
             if (m_actor->m_transfer_case)
             {
@@ -476,19 +520,30 @@ void ActorSpawner::FinalizeRig()
             else
                 diff->AddDifferentialType(VISCOUS_DIFF);
 
-            m_actor->m_axle_diffs[m_actor->m_num_axle_diffs] = diff;
-            m_actor->m_num_axle_diffs++;
+            m_actor->m_axle_diffs.push_back(diff);
         }
     }
 
-    // Automatically build an additional interaxle differential for the transfer case
+    // Drivetrain graph: interaxle differentials and the transfer case split between axles, then
+    // the interwheel differentials split between the wheels of each axle
+    auto axle_wheels = [this](int axle) -> std::vector<int>
+    {
+        return {m_actor->m_wheel_diffs[axle]->di_idx_1, m_actor->m_wheel_diffs[axle]->di_idx_2};
+    };
+    m_actor->m_drivetrain_solver.Clear();
+    for (Differential* diff: m_actor->m_axle_diffs)
+    {
+        m_actor->m_drivetrain_solver.AddDiff(diff, axle_wheels(diff->di_idx_1), axle_wheels(diff->di_idx_2));
+    }
     if (m_actor->m_transfer_case && m_actor->m_transfer_case->tr_ax_2 >= 0)
     {
-        Differential *diff = new Differential();
-        diff->di_idx_1 = m_actor->m_transfer_case->tr_ax_1;
-        diff->di_idx_2 = m_actor->m_transfer_case->tr_ax_2;
-        diff->AddDifferentialType(LOCKED_DIFF);
-        m_actor->m_axle_diffs[m_actor->m_num_axle_diffs] = diff;
+        TransferCase* tc = m_actor->m_transfer_case;
+        tc->tr_drivetrain_node = m_actor->m_drivetrain_solver.AddDiff(&tc->tr_diff, axle_wheels(tc->tr_ax_1), axle_wheels(tc->tr_ax_2));
+        m_actor->m_drivetrain_solver.SetDiffEnabled(tc->tr_drivetrain_node, tc->tr_4wd_mode);
+    }
+    for (Differential* diff: m_actor->m_wheel_diffs)
+    {
+        m_actor->m_drivetrain_solver.AddDiff(diff, {diff->di_idx_1}, {diff->di_idx_2});
     }
 
     if (m_actor->ar_main_camera_node_dir == 0 || m_actor->ar_main_camera_node_dir == NODENUM_INVALID)
@@ -561,11 +616,61 @@ void ActorSpawner::FinalizeRig()
 
     this->UpdateCollcabContacterNodes();
 
+    this->CompileAnimations();
+
     m_flex_factory.SaveFlexbodiesToCache();
 
     m_actor->GetGfxActor()->SortFlexbodies();
 }
 
+// Prop animations and animators share the flag bits, so both compile into an `AnimationTable`.
+static_assert(static_cast<BitMask_t>(PROP_ANIM_FLAG_AIRSPEED) == static_cast<BitMask_t>(ANIM_FLAG_AIRSPEED), "PropAnimFlag must match AnimFlags");
+static_assert(static_cast<BitMask_t>(PROP_ANIM_FLAG_SHIFTER) == static_cast<BitMask_t>(ANIM_FLAG_SHIFTER), "PropAnimFlag must match AnimFlags");
+static_assert(static_cast<BitMask_t>(PROP_ANIM_FLAG_TORQUE) == static_cast<BitMask_t>(ANIM_FLAG_TORQUE), "PropAnimFlag must match AnimFlags");
+static_assert(static_cast<BitMask_t>(PROP_ANIM_FLAG_EVENT) == static_cast<BitMask_t>(ANIM_FLAG_EVENT), "PropAnimFlag must match AnimFlags");
+static_assert(static_cast<BitMask_t>(PROP_ANIM_FLAG_ELEVATORS) == static_cast<BitMask_t>(ANIM_FLAG_ELEVATORS), "PropAnimFlag must match AnimFlags");
+
+void ActorSpawner::CompileAnimations()
+{
+    const bool has_engine = (m_actor->ar_engine != nullptr);
+    const int num_aeroengines = m_actor->ar_num_aeroengines;
+
+    // Prop animations; `animOpt3` is the aeroengine number, starting from 1
+    AnimationTable& prop_table = m_actor->m_gfx_actor->m_prop_anim_table;
+    prop_table.Reset(num_aeroengines, static_cast<int>(m_actor->m_prop_anim_key_states.size()));
+    int prop_anim_key_index = 0;
+    for (Prop& prop: m_actor->m_gfx_actor->m_props)
+    {
+        for (PropAnim& anim: prop.pp_animations)
+        {
+            int aeroengine = -1;
+            if (anim.animOpt3 > 0.f && anim.animOpt3 <= float(num_aeroengines))
+                aeroengine = int(anim.animOpt3 - 1.f);
+            const bool turboprop = (aeroengine != -1 && m_actor->ar_aeroengines[aeroengine]->getType() == AeroEngineType::AE_XPROP);
+            const int key = (anim.animFlags & PROP_ANIM_FLAG_EVENT) ? prop_anim_key_index++ : -1;
+
+            anim.animProgram = prop_table.AddAnimation(anim.animFlags, anim.animOpt3, has_engine, aeroengine, turboprop, key);
+        }
+    }
+
+    // Animators; `hb_anim_param` is the aeroengine index
+    AnimationTable& animator_table = m_actor->m_animator_table;
+    animator_table.Reset(num_aeroengines, 0);
+    for (int i = 0; i < m_actor->ar_num_hydros; i++)
+    {
+        hydrobeam_t& hydrobeam = m_actor->ar_hydros[i];
+        if (!hydrobeam.hb_anim_flags)
+            continue;
+
+        int aeroengine = -1;
+        if ((int)hydrobeam.hb_anim_param >= 0 && (int)hydrobeam.hb_anim_param < num_aeroengines)
+            aeroengine = (int)hydrobeam.hb_anim_param;
+        const bool turboprop = (aeroengine != -1 && m_actor->ar_aeroengines[aeroengine]->getType() == AeroEngineType::AE_XPROP);
+
+        hydrobeam.hb_anim_program = animator_table.AddAnimation(hydrobeam.hb_anim_flags, hydrobeam.hb_anim_param, has_engine, aeroengine, turboprop, -1);
+    }
+}
+
 /* -------------------------------------------------------------------------- */
 // Processing functions and utilities.
 /* -------------------------------------------------------------------------- */
@@ -1301,13 +1406,6 @@ void ActorSpawner::ProcessSubmesh(RigDef::Submesh & def)
         {
             return;
         }
-        else if (m_actor->ar_num_collcabs >= MAX_CABS)
-        {
-            std::stringstream msg;
-            msg << "Collcab limit (" << MAX_CABS << ") exceeded";
-            AddMessage(Message::TYPE_ERROR, msg.str());
-            return;
-        }
 
         bool mk_buoyance = false;
 
@@ -1315,29 +1413,33 @@ void ActorSpawner::ProcessSubmesh(RigDef::Submesh & def)
         m_actor->ar_cabs[m_actor->ar_num_cabs*3+1]=GetNodeIndexOrThrow(cab_itor->nodes[1]);
         m_actor->ar_cabs[m_actor->ar_num_cabs*3+2]=GetNodeIndexOrThrow(cab_itor->nodes[2]);
 
+        // Collcab/buoycab capacity comes from `CalcMemoryRequirements()`; a failed check
+        // only drops the collision/buoyancy of this cab, the visual cab is kept.
+
         // TODO: Clean this up properly ~ ulteq 10/2018
-        if (BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_c_CONTACT) ||
-            BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_p_10xTOUGHER) ||
-            BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_u_INVULNERABLE))
+        if ((BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_c_CONTACT) ||
+             BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_p_10xTOUGHER) ||
+             BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_u_INVULNERABLE)) &&
+            CheckCollcabLimit(1))
         {
             m_actor->ar_collcabs[m_actor->ar_num_collcabs]=m_actor->ar_num_cabs;
             m_actor->ar_num_collcabs++;
         }
-        if (BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_b_BUOYANT))
+        if (BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_b_BUOYANT) && CheckBuoycabLimit(1))
         {
             m_actor->ar_buoycabs[m_actor->ar_num_buoycabs]=m_actor->ar_num_cabs; 
             m_actor->ar_buoycab_types[m_actor->ar_num_buoycabs]=Buoyance::BUOY_NORMAL; 
             m_actor->ar_num_buoycabs++;   
             mk_buoyance = true;
         }
-        if (BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_r_BUOYANT_ONLY_DRAG))
+        if (BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_r_BUOYANT_ONLY_DRAG) && CheckBuoycabLimit(1))
         {
             m_actor->ar_buoycabs[m_actor->ar_num_buoycabs]=m_actor->ar_num_cabs; 
             m_actor->ar_buoycab_types[m_actor->ar_num_buoycabs]=Buoyance::BUOY_DRAGONLY; 
             m_actor->ar_num_buoycabs++; 
             mk_buoyance = true;
         }
-        if (BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_s_BUOYANT_NO_DRAG))
+        if (BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_s_BUOYANT_NO_DRAG) && CheckBuoycabLimit(1))
         {
             m_actor->ar_buoycabs[m_actor->ar_num_buoycabs]=m_actor->ar_num_cabs; 
             m_actor->ar_buoycab_types[m_actor->ar_num_buoycabs]=Buoyance::BUOY_DRAGLESS; 
@@ -1349,28 +1451,18 @@ void ActorSpawner::ProcessSubmesh(RigDef::Submesh & def)
             BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_F_10xTOUGHER_BUOYANT) ||
             BITMASK_IS_1(cab_itor->options, RigDef::Cab::OPTION_S_INVULNERABLE_BUOYANT))
         {
-
-            if (m_actor->ar_num_collcabs >= MAX_CABS)
+            if (CheckCollcabLimit(1))
             {
-                std::stringstream msg;
-                msg << "Collcab limit (" << MAX_CABS << ") exceeded";
-                AddMessage(Message::TYPE_ERROR, msg.str());
-                return;
+                m_actor->ar_collcabs[m_actor->ar_num_collcabs]=m_actor->ar_num_cabs;
+                m_actor->ar_num_collcabs++;
             }
-            else if (m_actor->ar_num_buoycabs >= MAX_CABS)
+            if (CheckBuoycabLimit(1))
             {
-                std::stringstream msg;
-                msg << "Buoycab limit (" << MAX_CABS << ") exceeded";
-                AddMessage(Message::TYPE_ERROR, msg.str());
-                return;
+                m_actor->ar_buoycabs[m_actor->ar_num_buoycabs]=m_actor->ar_num_cabs; 
+                m_actor->ar_buoycab_types[m_actor->ar_num_buoycabs]=Buoyance::BUOY_NORMAL; 
+                m_actor->ar_num_buoycabs++; 
+                mk_buoyance = true;
             }
-
-            m_actor->ar_collcabs[m_actor->ar_num_collcabs]=m_actor->ar_num_cabs;
-            m_actor->ar_num_collcabs++;
-            m_actor->ar_buoycabs[m_actor->ar_num_buoycabs]=m_actor->ar_num_cabs; 
-            m_actor->ar_buoycab_types[m_actor->ar_num_buoycabs]=Buoyance::BUOY_NORMAL; 
-            m_actor->ar_num_buoycabs++; 
-            mk_buoyance = true;
         }
 
         if (mk_buoyance && (m_actor->m_buoyance == nullptr))
@@ -2560,13 +2652,12 @@ void ActorSpawner::ProcessAxle(RigDef::Axle & def)
         }
     }
 
-    m_actor->m_wheel_diffs[m_actor->m_num_wheel_diffs] = diff;
-    m_actor->m_num_wheel_diffs++;
+    m_actor->m_wheel_diffs.push_back(diff);
 }
 
 void ActorSpawner::ProcessInterAxle(RigDef::InterAxle & def)
 {
-    if (def.a1 == def.a2 || std::min(def.a1, def.a2) < 0 || std::max(def.a1 , def.a2) >= m_actor->m_num_wheel_diffs)
+    if (def.a1 == def.a2 || std::min(def.a1, def.a2) < 0 || std::max(def.a1 , def.a2) >= static_cast<int>(m_actor->m_wheel_diffs.size()))
     {
         AddMessage(Message::TYPE_ERROR, "Invalid 'interaxle' axle ids, skipping...");
         return;
@@ -2617,13 +2708,12 @@ void ActorSpawner::ProcessInterAxle(RigDef::InterAxle & def)
         }
     }
 
-    m_actor->m_axle_diffs[m_actor->m_num_axle_diffs] = diff;
-    m_actor->m_num_axle_diffs++;
+    m_actor->m_axle_diffs.push_back(diff);
 }
 
 void ActorSpawner::ProcessTransferCase(RigDef::TransferCase & def)
 {
-    if (def.a1 == def.a2 || def.a1 < 0 || std::max(def.a1 , def.a2) >= m_actor->m_num_wheel_diffs)
+    if (def.a1 == def.a2 || def.a1 < 0 || std::max(def.a1 , def.a2) >= static_cast<int>(m_actor->m_wheel_diffs.size()))
     {
         AddMessage(Message::TYPE_ERROR, "Invalid 'transfercase' axle ids, skipping...");
         return;
@@ -3011,6 +3101,8 @@ RailGroup *ActorSpawner::CreateRail(std::vector<RigDef::Node::Range> & node_rang
         }
     }
 
+    rg->BuildBvh();
+
     return rg; // Transfers memory ownership
 }
 
@@ -3689,7 +3781,8 @@ void ActorSpawner::ProcessAnimator(RigDef::Animator & def)
         );
     }
 
-    m_actor->ar_hydros.push_back(hb);
+    ROR_ASSERT(m_actor->ar_num_hydros < (int)m_memory_requirements.num_hydros);
+    m_actor->ar_hydros[m_actor->ar_num_hydros++] = hb;
 }
 
 beam_t & ActorSpawner::AddBeam(
@@ -3801,7 +3894,8 @@ void ActorSpawner::ProcessHydro(RigDef::Hydro & def)
     hb.hb_anim_param = 0.f;
     this->_ProcessKeyInertia(def.inertia, *def.inertia_defaults, hb.hb_inertia, hb.hb_inertia);
 
-    m_actor->ar_hydros.push_back(hb);
+    ROR_ASSERT(m_actor->ar_num_hydros < (int)m_memory_requirements.num_hydros);
+    m_actor->ar_hydros[m_actor->ar_num_hydros++] = hb;
 }
 
 void ActorSpawner::ProcessShock3(RigDef::Shock3 & def)
@@ -5981,7 +6075,7 @@ bool ActorSpawner::CheckParticleLimit(unsigned int count)
 
 bool ActorSpawner::CheckAxleLimit(unsigned int count)
 {
-    if ((m_actor->m_num_wheel_diffs + count) > MAX_WHEELS/2)
+    if ((m_actor->m_wheel_diffs.size() + count) > MAX_WHEELS/2)
     {
         std::stringstream msg;
         msg << "Axle limit (" << MAX_WHEELS/2 << ") exceeded";
@@ -6030,10 +6124,35 @@ bool ActorSpawner::CheckSoundScriptLimit(ActorPtr const& vehicle, unsigned int c
 
 bool ActorSpawner::CheckCabLimit(unsigned int count)
 {
-    if ((m_actor->ar_num_cabs + count) > MAX_CABS)
+    // Capacity comes from `CalcMemoryRequirements()`; hitting it means the sizing pass is out of sync.
+    if ((m_actor->ar_num_cabs + count) > m_memory_requirements.num_cabs)
+    {
+        std::stringstream msg;
+        msg << "Cab limit (" << m_memory_requirements.num_cabs << ") exceeded";
+        AddMessage(Message::TYPE_ERROR, msg.str());
+        return false;
+    }
+    return true;
+}
+
+bool ActorSpawner::CheckCollcabLimit(unsigned int count)
+{
+    if ((m_actor->ar_num_collcabs + count) > m_memory_requirements.num_collcabs)
+    {
+        std::stringstream msg;
+        msg << "Collcab limit (" << m_memory_requirements.num_collcabs << ") exceeded";
+        AddMessage(Message::TYPE_ERROR, msg.str());
+        return false;
+    }
+    return true;
+}
+
+bool ActorSpawner::CheckBuoycabLimit(unsigned int count)
+{
+    if ((m_actor->ar_num_buoycabs + count) > m_memory_requirements.num_buoycabs)
     {
         std::stringstream msg;
-        msg << "Cab limit (" << MAX_CABS << ") exceeded";
+        msg << "Buoycab limit (" << m_memory_requirements.num_buoycabs << ") exceeded";
         AddMessage(Message::TYPE_ERROR, msg.str());
         return false;
     }
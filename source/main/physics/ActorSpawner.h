@@ -80,9 +80,14 @@ public:
         size_t num_beams     = 0;
         size_t num_shocks    = 0;
         size_t num_rotators  = 0;
+        size_t num_hydros    = 0; //!< Including animators
         size_t num_wings     = 0;
         size_t num_airbrakes = 0;
         size_t num_fixes     = 0;
+        size_t num_cabs      = 0; //!< Including backmesh duplicates
+        size_t num_collcabs  = 0;
+        size_t num_buoycabs  = 0;
+        size_t num_slidenodes = 0;
         // ... more to come ...
     };
 
@@ -304,6 +309,7 @@ private:
     /// @{
     void                          CalcMemoryRequirements(ActorMemoryRequirements& req, RigDef::Document::Module* module_def);    
     void                          UpdateCollcabContacterNodes();
+    void                          CompileAnimations(); //!< Fills `GfxActor::m_prop_anim_table` and `Actor::m_animator_table`
     wheel_t::BrakeCombo           TranslateBrakingDef(RigDef::WheelBraking def);
     void                          WashCalculator();
     void                          AdjustNodeBuoyancy(node_t & node, RigDef::Node & node_def, std::shared_ptr<RigDef::NodeDefaults> defaults); //!< For user-defined nodes
@@ -363,6 +369,8 @@ private:
     bool                          CheckSubmeshLimit(unsigned int count);
     bool                          CheckTexcoordLimit(unsigned int count);
     bool                          CheckCabLimit(unsigned int count);
+    bool                          CheckCollcabLimit(unsigned int count);
+    bool                          CheckBuoycabLimit(unsigned int count);
     bool                          CheckCameraRailLimit(unsigned int count);
     static bool                   CheckSoundScriptLimit(ActorPtr const& vehicle, unsigned int count);
     bool                          CheckAeroEngineLimit(unsigned int count);
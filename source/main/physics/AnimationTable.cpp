@@ -0,0 +1,194 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "AnimationTable.h"
+
+using namespace RoR;
+
+static_assert(ANIM_SOURCE_AEROENGINES < 32, "Fixed sources must fit `AnimationTable::m_used_sources`");
+
+void AnimationTable::Reset(int num_aeroengines, int num_keys)
+{
+    m_ops.clear();
+    m_used_sources = 0;
+    m_num_aeroengines = num_aeroengines;
+    m_num_keys = num_keys;
+    m_values.assign(this->GetKeySlot(num_keys), 0.f);
+    m_values[ANIM_SOURCE_ONE] = 1.f;
+}
+
+void AnimationTable::AddOp(AnimProgram& program, AnimOpType type, int slot, bool clamp_min, bool clamp_max)
+{
+    AnimOp op;
+    op.aop_type = type;
+    op.aop_source = slot;
+    op.aop_clamp_min = clamp_min;
+    op.aop_clamp_max = clamp_max;
+    m_ops.push_back(op);
+
+    if (slot >= 0 && slot < ANIM_SOURCE_AEROENGINES)
+        m_used_sources |= BITMASK(slot + 1);
+    program.apr_op_count++;
+    program.apr_num_sources++;
+}
+
+AnimProgram AnimationTable::AddAnimation(BitMask_t flags, float option, bool has_engine, int aeroengine, bool turboprop, int key)
+{
+    AnimProgram program;
+    program.apr_op_begin = static_cast<int>(m_ops.size());
+
+    // Same order as the sources were composed before compiling; ops which set `cstate` discard the preceding ones.
+    if (flags & ANIM_FLAG_BRUDDER)
+        this->AddOp(program, AnimOpType::SET, ANIM_SOURCE_BRUDDER);
+    if (flags & ANIM_FLAG_BTHROTTLE)
+        this->AddOp(program, AnimOpType::SET, ANIM_SOURCE_BTHROTTLE);
+    if (flags & ANIM_FLAG_DIFFLOCK)
+        this->AddOp(program, AnimOpType::DIFFLOCK, ANIM_SOURCE_DIFFLOCK);
+    if (flags & ANIM_FLAG_HEADING)
+        this->AddOp(program, AnimOpType::SET, ANIM_SOURCE_HEADING);
+    if (has_engine && (flags & ANIM_FLAG_TORQUE))
+        this->AddOp(program, AnimOpType::TORQUE, ANIM_SOURCE_TORQUE, /*clamp_min:*/true);
+
+    if (has_engine && (flags & ANIM_FLAG_SHIFTER))
+    {
+        if (option == 3.0f)
+            this->AddOp(program, AnimOpType::SHIFTER_SEQ, -1);
+        if (option == 1.0f)
+            this->AddOp(program, AnimOpType::SHIFTER_MAN1, -1);
+        if (option == 2.0f)
+            this->AddOp(program, AnimOpType::SHIFTER_MAN2, -1);
+        if (option == 4.0f)
+            this->AddOp(program, AnimOpType::SHIFTER_LIN, -1);
+    }
+
+    if (flags & ANIM_FLAG_PBRAKE)
+        this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_PBRAKE);
+    if (flags & ANIM_FLAG_SPEEDO)
+        this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_SPEEDO);
+    if (has_engine && (flags & ANIM_FLAG_TACHO))
+        this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_TACHO);
+    if (has_engine && (flags & ANIM_FLAG_TURBO))
+        this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_TURBO);
+    if (flags & ANIM_FLAG_BRAKE)
+        this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_BRAKE);
+    if (has_engine && (flags & ANIM_FLAG_ACCEL))
+        this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_ACCEL);
+    if (has_engine && (flags & ANIM_FLAG_CLUTCH))
+        this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_CLUTCH);
+
+    if (aeroengine >= 0 && aeroengine < m_num_aeroengines)
+    {
+        if (flags & ANIM_FLAG_RPM)
+            this->AddOp(program, AnimOpType::SUBTRACT, this->GetAeroengineSlot(aeroengine, ANIM_SOURCE_AE_RPM));
+        if (flags & ANIM_FLAG_THROTTLE)
+            this->AddOp(program, AnimOpType::SUBTRACT, this->GetAeroengineSlot(aeroengine, ANIM_SOURCE_AE_THROTTLE));
+        if (turboprop && (flags & ANIM_FLAG_AETORQUE))
+            this->AddOp(program, AnimOpType::SET, this->GetAeroengineSlot(aeroengine, ANIM_SOURCE_AE_TORQUE));
+        if (turboprop && (flags & ANIM_FLAG_AEPITCH))
+            this->AddOp(program, AnimOpType::SET, this->GetAeroengineSlot(aeroengine, ANIM_SOURCE_AE_PITCH));
+        if (flags & ANIM_FLAG_AESTATUS)
+            this->AddOp(program, AnimOpType::SET, this->GetAeroengineSlot(aeroengine, ANIM_SOURCE_AE_STATUS));
+    }
+
+    if (flags & ANIM_FLAG_AIRSPEED)
+        this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_AIRSPEED);
+    if (flags & ANIM_FLAG_VVI)
+        this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_VVI, /*clamp_min:*/true, /*clamp_max:*/true);
+
+    if (flags & ANIM_FLAG_ALTIMETER)
+    {
+        if (option == 3.0f)
+            this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_ALTIMETER_1K);
+        else if (option == 2.0f)
+            this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_ALTIMETER_10K, /*clamp_min:*/true);
+        else if (option == 1.0f)
+            this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_ALTIMETER_100K, /*clamp_min:*/true);
+        else
+            program.apr_num_sources++; // Counted even without a valid option
+    }
+
+    if (flags & ANIM_FLAG_AOA)
+        this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_AOA, /*clamp_min:*/true, /*clamp_max:*/true);
+    if (flags & ANIM_FLAG_ROLL)
+        this->AddOp(program, AnimOpType::SET, ANIM_SOURCE_ROLL);
+    if (flags & ANIM_FLAG_PITCH)
+        this->AddOp(program, AnimOpType::SET, ANIM_SOURCE_PITCH);
+    if (flags & ANIM_FLAG_AIRBRAKE)
+        this->AddOp(program, AnimOpType::SUBTRACT, ANIM_SOURCE_AIRBRAKE);
+    if (flags & ANIM_FLAG_FLAP)
+        this->AddOp(program, AnimOpType::SET, ANIM_SOURCE_FLAP);
+
+    // Prop animations only; added last so they don't interfere with the above
+    if ((flags & ANIM_FLAG_EVENT) && key >= 0 && key < m_num_keys)
+        this->AddOp(program, AnimOpType::ADD, this->GetKeySlot(key));
+    if (flags & ANIM_FLAG_STEERING)
+        this->AddOp(program, AnimOpType::ADD, ANIM_SOURCE_STEERING);
+    if (flags & ANIM_FLAG_AILERONS)
+        this->AddOp(program, AnimOpType::ADD, ANIM_SOURCE_AILERONS);
+    if (flags & ANIM_FLAG_ELEVATORS)
+        this->AddOp(program, AnimOpType::ADD, ANIM_SOURCE_ELEVATORS);
+    if (flags & ANIM_FLAG_ARUDDER)
+        this->AddOp(program, AnimOpType::ADD, ANIM_SOURCE_ARUDDER);
+    if (flags & ANIM_FLAG_PERMANENT)
+        this->AddOp(program, AnimOpType::ADD, ANIM_SOURCE_ONE);
+
+    return program;
+}
+
+void AnimationTable::ApplyOp(AnimOp const& op, float& cstate, float& prev_crankfactor) const
+{
+    if (op.aop_source < 0)
+        return; // Shifters are up to the owner
+
+    const float value = m_values[op.aop_source];
+    switch (op.aop_type)
+    {
+    case AnimOpType::SET:
+        cstate = value;
+        break;
+
+    case AnimOpType::SUBTRACT:
+        cstate -= value;
+        break;
+
+    case AnimOpType::ADD:
+        cstate += value;
+        break;
+
+    case AnimOpType::DIFFLOCK:
+        if (value >= 0.f)
+            cstate = value;
+        break;
+
+    case AnimOpType::TORQUE:
+        if (value >= prev_crankfactor)
+            cstate -= value / 10.0f;
+        else
+            cstate = 0.0f;
+        prev_crankfactor = value;
+        break;
+
+    default:;
+    }
+
+    if (op.aop_clamp_max && cstate >= 1.0f)
+        cstate = 1.0f;
+    if (op.aop_clamp_min && cstate <= -1.0f)
+        cstate = -1.0f;
+}
@@ -0,0 +1,187 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Animation sources of props and animators, compiled to flat lists of ops at spawn.
+
+#pragma once
+
+#include "BitFlags.h"
+
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Physics
+/// @{
+
+enum AnimFlags
+{
+    ANIM_FLAG_AIRSPEED      = BITMASK(1),
+    ANIM_FLAG_VVI           = BITMASK(2),
+    ANIM_FLAG_ALTIMETER     = BITMASK(3),
+    ANIM_FLAG_AOA           = BITMASK(4),
+    ANIM_FLAG_FLAP          = BITMASK(5),
+    ANIM_FLAG_AIRBRAKE      = BITMASK(6),
+    ANIM_FLAG_ROLL          = BITMASK(7),
+    ANIM_FLAG_PITCH         = BITMASK(8),
+    ANIM_FLAG_THROTTLE      = BITMASK(9),
+    ANIM_FLAG_RPM           = BITMASK(10),
+    ANIM_FLAG_ACCEL         = BITMASK(11),
+    ANIM_FLAG_BRAKE         = BITMASK(12),
+    ANIM_FLAG_CLUTCH        = BITMASK(13),
+    ANIM_FLAG_TACHO         = BITMASK(14),
+    ANIM_FLAG_SPEEDO        = BITMASK(15),
+    ANIM_FLAG_PBRAKE        = BITMASK(16),
+    ANIM_FLAG_TURBO         = BITMASK(17),
+    ANIM_FLAG_SHIFTER       = BITMASK(18),
+    ANIM_FLAG_AETORQUE      = BITMASK(19),
+    ANIM_FLAG_AEPITCH       = BITMASK(20),
+    ANIM_FLAG_AESTATUS      = BITMASK(21),
+    ANIM_FLAG_TORQUE        = BITMASK(22),
+    ANIM_FLAG_HEADING       = BITMASK(23),
+    ANIM_FLAG_DIFFLOCK      = BITMASK(24),
+    ANIM_FLAG_STEERING      = BITMASK(25),
+    ANIM_FLAG_EVENT         = BITMASK(26),
+    ANIM_FLAG_AILERONS      = BITMASK(27),
+    ANIM_FLAG_ARUDDER       = BITMASK(28),
+    ANIM_FLAG_BRUDDER       = BITMASK(29),
+    ANIM_FLAG_BTHROTTLE     = BITMASK(30),
+    ANIM_FLAG_PERMANENT     = BITMASK(31),
+    ANIM_FLAG_ELEVATORS     = BITMASK(32),
+};
+
+/// Slots of `AnimationTable` values, read once per update (frame for props, physics step for animators).
+/// Values are pre-scaled so that the `AnimOp` reading them only sets, adds or subtracts.
+enum AnimSource
+{
+    ANIM_SOURCE_BRUDDER,          //!< Average rudder of screwprops
+    ANIM_SOURCE_BTHROTTLE,        //!< Average throttle of screwprops
+    ANIM_SOURCE_DIFFLOCK,         //!< 0 = open, 0.5 = split, 1 = locked, -1 = other
+    ANIM_SOURCE_HEADING,
+    ANIM_SOURCE_TORQUE,           //!< Engine crank factor, not negative
+    ANIM_SOURCE_PBRAKE,
+    ANIM_SOURCE_SPEEDO,
+    ANIM_SOURCE_TACHO,
+    ANIM_SOURCE_TURBO,
+    ANIM_SOURCE_BRAKE,
+    ANIM_SOURCE_ACCEL,
+    ANIM_SOURCE_CLUTCH,
+    ANIM_SOURCE_AIRSPEED,
+    ANIM_SOURCE_VVI,
+    ANIM_SOURCE_ALTIMETER_100K,
+    ANIM_SOURCE_ALTIMETER_10K,
+    ANIM_SOURCE_ALTIMETER_1K,
+    ANIM_SOURCE_AOA,
+    ANIM_SOURCE_ROLL,
+    ANIM_SOURCE_PITCH,
+    ANIM_SOURCE_AIRBRAKE,
+    ANIM_SOURCE_FLAP,
+    ANIM_SOURCE_STEERING,         //!< Props only
+    ANIM_SOURCE_AILERONS,         //!< Props only
+    ANIM_SOURCE_ELEVATORS,        //!< Props only
+    ANIM_SOURCE_ARUDDER,          //!< Props only
+    ANIM_SOURCE_ONE,              //!< Constant 1, for 'permanent'
+    ANIM_SOURCE_AEROENGINES,      //!< First of `ANIM_SOURCE_AE_COUNT` slots per aeroengine; prop animation keys follow.
+};
+
+/// Slots of one aeroengine, see `ANIM_SOURCE_AEROENGINES`
+enum AnimSourceAeroengine
+{
+    ANIM_SOURCE_AE_RPM,
+    ANIM_SOURCE_AE_THROTTLE,
+    ANIM_SOURCE_AE_TORQUE,        //!< Turboprops only
+    ANIM_SOURCE_AE_PITCH,         //!< Turboprops only
+    ANIM_SOURCE_AE_STATUS,
+    ANIM_SOURCE_AE_COUNT
+};
+
+enum class AnimOpType
+{
+    SET,                          //!< cstate = value
+    SUBTRACT,                     //!< cstate -= value
+    ADD,                          //!< cstate += value
+    DIFFLOCK,                     //!< cstate = value, unless it's negative
+    TORQUE,                       //!< cstate -= value/10 while the crank factor rises, 0 when it drops
+    SHIFTER_SEQ,                  //!< Shifters are evaluated by the owner of the table
+    SHIFTER_MAN1,
+    SHIFTER_MAN2,
+    SHIFTER_LIN,
+};
+
+/// One step of a compiled animation, see `AnimationTable`
+struct AnimOp
+{
+    AnimOpType  aop_type         = AnimOpType::SET;
+    int         aop_source       = 0;      //!< `AnimSource` or aeroengine/key slot; -1 for shifters
+    bool        aop_clamp_min    = false;  //!< Clamp cstate to -1 after the op
+    bool        aop_clamp_max    = false;  //!< Clamp cstate to +1 after the op
+};
+
+/// Range of `AnimationTable` ops evaluated for one prop animation or animator
+struct AnimProgram
+{
+    int         apr_op_begin     = 0;
+    int         apr_op_count     = 0;
+    int         apr_num_sources  = 0;      //!< Sources which apply, the `div` of animators
+};
+
+/// Animations of one actor (prop animations or animators) compiled to a flat list of `AnimOp`,
+/// by `ActorSpawner::CompileAnimations()`. The owner fills in the used source values once per update,
+/// then evaluates each animation by running its `AnimProgram`.
+/// Ops keep the order in which sources are composed (some set, some add, some clamp), so results don't change.
+class AnimationTable
+{
+public:
+    /// Clears the ops and sizes the values for the given aeroengines and prop animation keys.
+    void           Reset(int num_aeroengines, int num_keys);
+
+    /// @param flags `AnimFlags`; `PropAnimFlag` uses the same bits.
+    /// @param option Shifter or altimeter type; `PropAnim::animOpt3` or `hydrobeam_t::hb_anim_param`.
+    /// @param aeroengine Index of the aeroengine read by the animation, -1 if none.
+    /// @param turboprop Is the aeroengine a turboprop?
+    /// @param key Index of the prop animation key state (`ANIM_FLAG_EVENT`), -1 if none.
+    AnimProgram    AddAnimation(BitMask_t flags, float option, bool has_engine, int aeroengine, bool turboprop, int key);
+
+    /// Applies any op except shifters, which need data of the table owner.
+    void           ApplyOp(AnimOp const& op, float& cstate, float& prev_crankfactor) const;
+
+    bool           IsEmpty() const { return m_ops.empty(); }
+    bool           IsSourceUsed(AnimSource source) const { return (m_used_sources & BITMASK(source + 1)) != 0; }
+    int            GetNumAeroengines() const { return m_num_aeroengines; }
+    int            GetNumKeys() const { return m_num_keys; }
+    int            GetAeroengineSlot(int aeroengine, AnimSourceAeroengine source) const { return ANIM_SOURCE_AEROENGINES + aeroengine * ANIM_SOURCE_AE_COUNT + source; }
+    int            GetKeySlot(int key) const { return ANIM_SOURCE_AEROENGINES + m_num_aeroengines * ANIM_SOURCE_AE_COUNT + key; }
+    AnimOp const&  GetOp(int index) const { return m_ops[index]; }
+    float          GetValue(int slot) const { return m_values[slot]; }
+    void           SetValue(int slot, float value) { m_values[slot] = value; }
+
+private:
+    void           AddOp(AnimProgram& program, AnimOpType type, int slot, bool clamp_min = false, bool clamp_max = false);
+
+    std::vector<AnimOp>  m_ops;
+    std::vector<float>   m_values;
+    BitMask_t            m_used_sources = 0;    //!< Fixed sources (below `ANIM_SOURCE_AEROENGINES`) read by any op
+    int                  m_num_aeroengines = 0;
+    int                  m_num_keys = 0;
+};
+
+/// @} // addtogroup Physics
+
+} // namespace RoR
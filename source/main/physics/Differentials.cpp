@@ -24,6 +24,12 @@
 
 using namespace RoR;
 
+// Torsion spring rate that holds axles together when locked
+// keep as constants for now since these values will be user configurable
+static const float LOCKED_TORSION_RATE  = 1000000.0f;
+static const float LOCKED_TORSION_DAMP  = LOCKED_TORSION_RATE / 100.0f;
+static const float VISCOUS_TORSION_DAMP = 10000.0f;
+
 void Differential::ToggleDifferentialMode()
 {
     if (m_available_diffs.size() > 1)
@@ -46,6 +52,28 @@ void Differential::CalcAxleTorque(DifferentialData& diff_data)
     }
 }
 
+void Differential::GetCouplingRates(float& out_torsion_rate, float& out_torsion_damp) const
+{
+    out_torsion_rate = 0.0f;
+    out_torsion_damp = 0.0f;
+    if (m_available_diffs.empty())
+        return;
+
+    switch (m_available_diffs[0])
+    {
+    case VISCOUS_DIFF: out_torsion_damp = VISCOUS_TORSION_DAMP; return;
+    case LOCKED_DIFF:  out_torsion_rate = LOCKED_TORSION_RATE;
+                       out_torsion_damp = LOCKED_TORSION_DAMP;  return;
+    default:           return;
+    }
+}
+
+bool Differential::IsCoupling() const
+{
+    return !m_available_diffs.empty() &&
+        (m_available_diffs[0] == VISCOUS_DIFF || m_available_diffs[0] == LOCKED_DIFF);
+}
+
 Ogre::UTFString Differential::GetDifferentialTypeName()
 {
     if (m_available_diffs.empty())
@@ -103,7 +131,7 @@ void Differential::CalcViscousDiff(DifferentialData& diff_data)
      * coupling.
      */
 
-    const Ogre::Real m_torsion_damp = 10000.0f;
+    const Ogre::Real m_torsion_damp = VISCOUS_TORSION_DAMP;
     const Ogre::Real delta_speed = diff_data.speed[0] - diff_data.speed[1];
 
     diff_data.out_torque[0] = diff_data.out_torque[1] = diff_data.in_torque / 2.0f;
@@ -124,10 +152,8 @@ void Differential::CalcLockedDiff(DifferentialData& diff_data)
      * locked.
      */
 
-    // Torsion spring rate that holds axles together when locked
-    // keep as variable for now since this value will be user configurable
-    const Ogre::Real m_torsion_rate = 1000000.0f;
-    const Ogre::Real m_torsion_damp = m_torsion_rate / 100.0f;
+    const Ogre::Real m_torsion_rate = LOCKED_TORSION_RATE;
+    const Ogre::Real m_torsion_damp = LOCKED_TORSION_DAMP;
     const Ogre::Real delta_speed = diff_data.speed[0] - diff_data.speed[1];
 
     diff_data.out_torque[0] = diff_data.out_torque[1] = diff_data.in_torque / 2.0f;
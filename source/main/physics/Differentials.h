@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "ForwardDeclarations.h"
+
 #include <vector>
 #include <OgreUTFString.h>
 
@@ -40,20 +42,6 @@ struct DifferentialData
     float dt;
 };
 
-class TransferCase
-{
-public:
-    TransferCase(int a1, int a2, bool has_2wd, bool has_2wd_lo, std::vector<float> grs):
-        tr_ax_1(a1), tr_ax_2(a2), tr_2wd(has_2wd), tr_2wd_lo(has_2wd_lo), tr_4wd_mode(false), tr_gear_ratios(grs) {};
-
-    int   tr_ax_1;                      //!< This axle is always driven
-    int   tr_ax_2;                      //!< This axle is only driven in 4WD mode
-    bool  tr_2wd;                       //!< Does it support 2WD mode?
-    bool  tr_2wd_lo;                    //!< Does it support 2WD Lo mode?
-    bool  tr_4wd_mode;                  //!< Enables 4WD mode
-    std::vector<float> tr_gear_ratios;  //!< Gear reduction ratios
-};
-
 enum DiffType
 {
     SPLIT_DIFF = 0,
@@ -77,6 +65,9 @@ public:
     void             CalcAxleTorque(DifferentialData& diff_data);
     Ogre::UTFString  GetDifferentialTypeName();
     DiffType         GetActiveDiffType() const { return m_available_diffs[0]; }
+    /// Torsion coupling of the active type (locked/viscous); zero for types which only split torque.
+    void             GetCouplingRates(float& out_torsion_rate, float& out_torsion_damp) const;
+    bool             IsCoupling() const;
     int              GetNumDiffTypes() { return static_cast<int>(m_available_diffs.size()); }
     
     static void      CalcSeparateDiff(DifferentialData& diff_data);  //!< a differential that always splits the torque evenly, this is the original method
@@ -88,6 +79,27 @@ private:
     std::vector<DiffType> m_available_diffs;
 };
 
+class TransferCase
+{
+public:
+    TransferCase(int a1, int a2, bool has_2wd, bool has_2wd_lo, std::vector<float> grs):
+        tr_ax_1(a1), tr_ax_2(a2), tr_2wd(has_2wd), tr_2wd_lo(has_2wd_lo), tr_4wd_mode(false), tr_gear_ratios(grs)
+    {
+        tr_diff.di_idx_1 = a1;
+        tr_diff.di_idx_2 = a2;
+        tr_diff.AddDifferentialType(LOCKED_DIFF);
+    };
+
+    int   tr_ax_1;                      //!< This axle is always driven
+    int   tr_ax_2;                      //!< This axle is only driven in 4WD mode
+    bool  tr_2wd;                       //!< Does it support 2WD mode?
+    bool  tr_2wd_lo;                    //!< Does it support 2WD Lo mode?
+    bool  tr_4wd_mode;                  //!< Enables 4WD mode
+    std::vector<float> tr_gear_ratios;  //!< Gear reduction ratios
+    Differential tr_diff;               //!< Locks the two axles together in 4WD mode
+    int   tr_drivetrain_node = -1;      //!< `tr_diff` in the actor's `DrivetrainSolver`
+};
+
 /// @} // addtogroup Trucks
 /// @} // addtogroup Gameplay
 
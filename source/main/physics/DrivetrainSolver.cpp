@@ -0,0 +1,351 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DrivetrainSolver.h"
+
+#include "Differentials.h"
+#include "SimConstants.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace RoR;
+
+void DrivetrainSolver::Clear()
+{
+    m_diffs.clear();
+}
+
+int DrivetrainSolver::AddDiff(Differential* diff, std::vector<int> side1, std::vector<int> side2)
+{
+    DiffNode node;
+    node.dn_diff = diff;
+    node.dn_sides[0] = std::move(side1);
+    node.dn_sides[1] = std::move(side2);
+    node.dn_enabled = true;
+    m_diffs.push_back(std::move(node));
+    return static_cast<int>(m_diffs.size()) - 1;
+}
+
+void DrivetrainSolver::SetDiffEnabled(int node, bool enabled)
+{
+    m_diffs[node].dn_enabled = enabled;
+}
+
+void DrivetrainSolver::Solve(DrivetrainWheel* wheels, int num_wheels, DrivetrainEngine* engine, float dt)
+{
+    // A fully detached side follows the other side of its diff, wheel by wheel
+    for (const DiffNode& node: m_diffs)
+    {
+        if (!node.dn_enabled)
+            continue;
+        for (int s = 0; s < 2; s++)
+        {
+            const std::vector<int>& side = node.dn_sides[s];
+            const std::vector<int>& other = node.dn_sides[1 - s];
+            if (side.empty() || other.empty())
+                continue;
+            if (std::all_of(side.begin(), side.end(), [wheels](int w) { return wheels[w].dw_detached; }))
+            {
+                for (size_t k = 0; k < side.size(); k++)
+                    wheels[side[k]].dw_speed = wheels[other[std::min(k, other.size() - 1)]].dw_speed;
+            }
+        }
+    }
+
+    // Nodes: the wheels, then the crankshaft
+    const int crank = num_wheels;
+    m_speed.resize(num_wheels + 1);
+    m_inv_inertia.resize(num_wheels + 1);
+    for (int i = 0; i < num_wheels; i++)
+    {
+        const DrivetrainWheel& wheel = wheels[i];
+        m_inv_inertia[i] = 1.0f / std::max(wheel.dw_inertia, 1e-3f);
+        m_speed[i] = wheel.dw_speed + (wheel.dw_torque * m_inv_inertia[i] + wheel.dw_retorque / std::max(wheel.dw_mass, 1e-3f)) * dt;
+    }
+    m_speed[crank] = (engine) ? engine->de_rpm : 0.0f;
+    m_inv_inertia[crank] = (engine) ? 1.0f / std::max(engine->de_inertia, 1e-3f) : 0.0f;
+
+    m_couplings.clear();
+    m_terms.clear();
+
+    // Clutch: slip is `crank_rpm / gear_ratio - driveshaft_rpm`, the driveshaft being the average spin of the propelled wheels.
+    // Its torque goes to the wheels by the diffs' split; the crankshaft gets `-torque / gear_ratio`.
+    int num_propelled = 0;
+    for (int i = 0; i < num_wheels; i++)
+    {
+        if (wheels[i].dw_propulsed)
+            num_propelled++;
+    }
+    int clutch = -1;
+    if (engine && engine->de_gear_ratio != 0.0f && engine->de_clutch_damp > 0.0f && num_propelled > 0)
+    {
+        this->SplitTorque(wheels, num_wheels, engine->de_torque_scale / num_propelled);
+
+        Coupling coupling;
+        coupling.cp_delta_rotation = nullptr;
+        coupling.cp_torsion_rate = 0.0f;
+        coupling.cp_torsion_damp = engine->de_clutch_damp;
+        coupling.cp_torque_limit = engine->de_clutch_limit;
+        coupling.cp_term_begin = static_cast<int>(m_terms.size());
+        m_terms.push_back({crank, 1.0f / engine->de_gear_ratio, 1.0f / engine->de_gear_ratio});
+        for (int i = 0; i < num_wheels; i++)
+        {
+            const float spin = (wheels[i].dw_propulsed == 1 && !wheels[i].dw_detached)
+                ? RAD_PER_SEC_TO_RPM / (std::max(wheels[i].dw_radius, 1e-3f) * num_propelled) : 0.0f;
+            if (spin != 0.0f || m_torque_share[i] != 0.0f)
+                m_terms.push_back({i, -spin, -m_torque_share[i]});
+        }
+        coupling.cp_term_count = static_cast<int>(m_terms.size()) - coupling.cp_term_begin;
+        clutch = static_cast<int>(m_couplings.size());
+        m_couplings.push_back(coupling);
+    }
+
+    this->AddDiffCouplings(wheels);
+
+    if (engine)
+        engine->de_clutch_torque = 0.0f;
+    if (m_couplings.empty())
+        return;
+
+    this->SolveCouplings(dt);
+
+    // Apply the coupling torques and advance the torsion springs with the resulting speed
+    for (const Coupling& coupling: m_couplings)
+    {
+        for (int t = coupling.cp_term_begin; t < coupling.cp_term_begin + coupling.cp_term_count; t++)
+        {
+            if (m_terms[t].tm_node != crank)
+                wheels[m_terms[t].tm_node].dw_torque -= coupling.cp_torque * m_terms[t].tm_torque_weight;
+        }
+
+        if (coupling.cp_delta_rotation && coupling.cp_torsion_rate > 0.0f)
+        {
+            const float stiffness = coupling.cp_torsion_rate * dt + coupling.cp_torsion_damp;
+            const float new_speed = (coupling.cp_torque - coupling.cp_torsion_rate * *coupling.cp_delta_rotation) / stiffness;
+            *coupling.cp_delta_rotation += new_speed * dt;
+        }
+    }
+    if (clutch != -1)
+        engine->de_clutch_torque = m_couplings[clutch].cp_torque;
+}
+
+void DrivetrainSolver::SplitTorque(const DrivetrainWheel* wheels, int num_wheels, float wheel_share)
+{
+    // The driveshaft torque is spread evenly over the propelled wheels, then each diff in turn re-splits
+    // what its wheels got between its two sides. All diff types split linearly, so this is done for a unit torque.
+    m_torque_share.assign(num_wheels, 0.0f);
+    for (int i = 0; i < num_wheels; i++)
+    {
+        if (wheels[i].dw_propulsed && !wheels[i].dw_detached)
+            m_torque_share[i] = wheel_share;
+    }
+
+    for (const DiffNode& node: m_diffs)
+    {
+        if (!node.dn_enabled || node.dn_sides[0].empty() || node.dn_sides[1].empty())
+            continue;
+
+        float in_torque = 0.0f;
+        float side_speed[2] = {0.0f, 0.0f};
+        for (int s = 0; s < 2; s++)
+        {
+            for (int w: node.dn_sides[s])
+            {
+                in_torque += m_torque_share[w];
+                side_speed[s] += wheels[w].dw_speed;
+            }
+            side_speed[s] /= node.dn_sides[s].size();
+        }
+
+        // Locked and viscous diffs split evenly, their torsion is a coupling of its own
+        DifferentialData diff_data = {{side_speed[0], side_speed[1]}, node.dn_diff->di_delta_rotation, {0.0f, 0.0f}, 1.0f, 0.0f};
+        if (node.dn_diff->IsCoupling())
+            Differential::CalcSeparateDiff(diff_data);
+        else
+            node.dn_diff->CalcAxleTorque(diff_data);
+
+        for (int s = 0; s < 2; s++)
+        {
+            for (int w: node.dn_sides[s])
+                m_torque_share[w] = in_torque * diff_data.out_torque[s] / node.dn_sides[s].size();
+        }
+    }
+}
+
+void DrivetrainSolver::AddDiffCouplings(const DrivetrainWheel* wheels)
+{
+    for (DiffNode& node: m_diffs)
+    {
+        if (!node.dn_enabled || !node.dn_diff->IsCoupling())
+            continue;
+
+        Coupling coupling;
+        node.dn_diff->GetCouplingRates(coupling.cp_torsion_rate, coupling.cp_torsion_damp);
+        if (coupling.cp_torsion_rate <= 0.0f && coupling.cp_torsion_damp <= 0.0f)
+            continue;
+
+        // Side speed is the average of its attached wheels
+        int num_attached[2] = {0, 0};
+        for (int s = 0; s < 2; s++)
+        {
+            for (int w: node.dn_sides[s])
+            {
+                if (!wheels[w].dw_detached)
+                    num_attached[s]++;
+            }
+        }
+        if (num_attached[0] == 0 || num_attached[1] == 0)
+            continue;
+
+        coupling.cp_delta_rotation = &node.dn_diff->di_delta_rotation;
+        coupling.cp_torque_limit = 0.0f;
+        coupling.cp_term_begin = static_cast<int>(m_terms.size());
+        for (int s = 0; s < 2; s++)
+        {
+            const float weight = (s == 0) ? (1.0f / num_attached[0]) : (-1.0f / num_attached[1]);
+            for (int w: node.dn_sides[s])
+            {
+                if (!wheels[w].dw_detached)
+                    m_terms.push_back({w, weight, weight});
+            }
+        }
+        coupling.cp_term_count = static_cast<int>(m_terms.size()) - coupling.cp_term_begin;
+        m_couplings.push_back(coupling);
+    }
+}
+
+void DrivetrainSolver::SolveCouplings(float dt)
+{
+    // Implicit Euler on `torque = rate * delta_rotation' + damp * speed'` with `delta_rotation' = delta_rotation + dt * speed'`
+    // and `speed' = J * (predicted_speed - dt * M^-1 * G^T * torque)` gives
+    //   (C + dt * J * M^-1 * G^T) * torque = rate * delta_rotation / (rate * dt + damp) + J * predicted_speed
+    // with C = diag(1 / (rate * dt + damp)). Couplings interact through the nodes they share.
+    const size_t n = m_couplings.size();
+    m_matrix.assign(n * n, 0.0f);
+    m_rhs.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        Coupling& ci = m_couplings[i];
+        ci.cp_clamped = false;
+        ci.cp_torque = 0.0f;
+        const float stiffness = ci.cp_torsion_rate * dt + ci.cp_torsion_damp;
+
+        float speed = 0.0f;
+        for (int t = ci.cp_term_begin; t < ci.cp_term_begin + ci.cp_term_count; t++)
+            speed += m_terms[t].tm_speed_weight * m_speed[m_terms[t].tm_node];
+        m_rhs[i] = speed;
+        if (ci.cp_delta_rotation && ci.cp_torsion_rate > 0.0f)
+            m_rhs[i] += ci.cp_torsion_rate * *ci.cp_delta_rotation / stiffness;
+
+        m_matrix[i * n + i] = 1.0f / stiffness;
+        for (size_t j = 0; j < n; j++)
+        {
+            const Coupling& cj = m_couplings[j];
+            float sum = 0.0f;
+            for (int ti = ci.cp_term_begin; ti < ci.cp_term_begin + ci.cp_term_count; ti++)
+            {
+                for (int tj = cj.cp_term_begin; tj < cj.cp_term_begin + cj.cp_term_count; tj++)
+                {
+                    if (m_terms[ti].tm_node == m_terms[tj].tm_node)
+                        sum += m_terms[ti].tm_speed_weight * m_terms[tj].tm_torque_weight * m_inv_inertia[m_terms[ti].tm_node];
+                }
+            }
+            m_matrix[i * n + j] += dt * sum;
+        }
+    }
+
+    // Solve the unclamped rows; clamp the ones over their torque limit and solve the rest again
+    for (size_t iteration = 0; iteration <= n; iteration++)
+    {
+        m_free.clear();
+        for (size_t i = 0; i < n; i++)
+        {
+            if (!m_couplings[i].cp_clamped)
+                m_free.push_back(static_cast<int>(i));
+        }
+        const size_t k = m_free.size();
+        if (k == 0)
+            break;
+
+        // Augmented system of the free rows, the clamped torques moved to the right hand side
+        const size_t stride = k + 1;
+        m_work.resize(k * stride);
+        for (size_t a = 0; a < k; a++)
+        {
+            const size_t row = m_free[a];
+            for (size_t b = 0; b < k; b++)
+                m_work[a * stride + b] = m_matrix[row * n + m_free[b]];
+            float rhs = m_rhs[row];
+            for (size_t j = 0; j < n; j++)
+            {
+                if (m_couplings[j].cp_clamped)
+                    rhs -= m_matrix[row * n + j] * m_couplings[j].cp_torque;
+            }
+            m_work[a * stride + k] = rhs;
+        }
+
+        // Gaussian elimination with partial pivoting, then back substitution
+        for (size_t col = 0; col < k; col++)
+        {
+            size_t pivot = col;
+            for (size_t r = col + 1; r < k; r++)
+            {
+                if (std::abs(m_work[r * stride + col]) > std::abs(m_work[pivot * stride + col]))
+                    pivot = r;
+            }
+            if (pivot != col)
+            {
+                for (size_t c = col; c < stride; c++)
+                    std::swap(m_work[col * stride + c], m_work[pivot * stride + c]);
+            }
+            const float diag = (std::abs(m_work[col * stride + col]) > 1e-12f) ? m_work[col * stride + col] : 1e-12f;
+            m_work[col * stride + col] = diag;
+            for (size_t r = col + 1; r < k; r++)
+            {
+                const float factor = m_work[r * stride + col] / diag;
+                if (factor == 0.0f)
+                    continue;
+                for (size_t c = col; c < stride; c++)
+                    m_work[r * stride + c] -= factor * m_work[col * stride + c];
+            }
+        }
+        for (size_t a = k; a-- > 0; )
+        {
+            float sum = m_work[a * stride + k];
+            for (size_t b = a + 1; b < k; b++)
+                sum -= m_work[a * stride + b] * m_couplings[m_free[b]].cp_torque;
+            m_couplings[m_free[a]].cp_torque = sum / m_work[a * stride + a];
+        }
+
+        bool clamped = false;
+        for (int i: m_free)
+        {
+            Coupling& coupling = m_couplings[i];
+            if (coupling.cp_torque_limit > 0.0f && std::abs(coupling.cp_torque) > coupling.cp_torque_limit)
+            {
+                coupling.cp_torque = std::copysign(coupling.cp_torque_limit, coupling.cp_torque);
+                coupling.cp_clamped = true;
+                clamped = true;
+            }
+        }
+        if (!clamped)
+            break;
+    }
+}
@@ -0,0 +1,148 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief Drivetrain graph (engine -> clutch -> gearbox -> transfer case -> diffs -> wheels), solved implicitly.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Gameplay
+/// @{
+
+/// @addtogroup Trucks
+/// @{
+
+class Differential;
+
+/// Rotational state of one wheel as the solver sees it; filled from `wheel_t` each step.
+struct DrivetrainWheel
+{
+    float        dw_speed;          //!< Rim speed; the solver gives detached wheels the speed of the other side of their diff
+    float        dw_torque;         //!< Torque from outside the drivetrain; the solver adds the drivetrain torques to it
+    float        dw_inertia;        //!< Turns torque into rim acceleration; `wh_radius * wh_mass`
+    float        dw_mass;
+    float        dw_radius;
+    float        dw_retorque;       //!< Ground reaction from the previous step, see `wheel_t::wh_last_retorque`
+    int          dw_propulsed;      //!< See `wheel_t::wh_propulsed`: 0 = free, 1 = driven, 2 = driven, reversed
+    bool         dw_detached;
+};
+
+/// Engine side of the graph: the crankshaft and the clutch coupling it to the gearbox.
+/// Filled from `EngineSim` each step, see `EngineSim::GetClutchCoupling()`.
+struct DrivetrainEngine
+{
+    float        de_rpm;            //!< Crankshaft speed; the engine's own torque is already integrated into it
+    float        de_inertia;        //!< Turns torque into crankshaft RPM change
+    float        de_gear_ratio;     //!< Crankshaft RPM per driveshaft RPM, transfer case included; 0 in neutral
+    float        de_clutch_damp;    //!< Clutch torque per RPM of slip; 0 when disengaged
+    float        de_clutch_limit;   //!< The clutch slips at this torque
+    float        de_torque_scale;   //!< Scales the torque the propelled wheels receive; 2 with an 'axles' section, for compatibility
+    float        de_clutch_torque;  //!< Out: torque passed through the clutch, at the driveshaft
+};
+
+/// Solves the drivetrain of one actor implicitly, all at once, every physics step.
+///
+/// The graph is built at spawn: a list of diff nodes, each splitting the torque it receives between two
+/// groups of wheels (2 wheels for a wheel diff, 2 axles for an axle diff, any grouping works). Diffs are
+/// evaluated in the order they were added, so a diff feeding other diffs must come before them.
+/// The transfer case is a diff node which is only enabled in 4WD mode.
+///
+/// Each step the crankshaft and the wheels are the nodes. The clutch couples the crankshaft with the
+/// driveshaft (the average speed of the propelled wheels) through the gearbox ratio; the torque it passes
+/// reaches the wheels through the diffs' torque split. Locked and viscous diffs add a torsion spring and damper
+/// between their two sides. Each coupling gets a row in one small system, integrated with implicit Euler
+/// against the inertia of the crankshaft and the wheels: `(C + dt * J * M^-1 * G^T) * torque = b`, where `J`
+/// reads the coupling speed from the nodes and `G` distributes the coupling torque onto them. For the diffs
+/// `G = J`; the clutch keeps the speed and torque conventions of `EngineSim`, so `G != J` there and the system
+/// is solved with Gaussian elimination. A clutch torque over its limit is clamped and the rest is solved again.
+/// Unlike the explicit springs this replaced, the couplings stay stable for any torsion rate, wheel mass,
+/// clutch force and timestep, and chained diffs don't fight each other.
+class DrivetrainSolver
+{
+public:
+    // Graph, built at spawn
+
+    void             Clear();
+    /// Adds a diff node; `side1`/`side2` are indices to the wheel array passed to `Solve()`. Returns the node index.
+    int              AddDiff(Differential* diff, std::vector<int> side1, std::vector<int> side2);
+    void             SetDiffEnabled(int node, bool enabled);
+    size_t           GetNumDiffs() const { return m_diffs.size(); }
+
+    // Simulation
+
+    /// Splits the engine torque over the wheels through the diffs and solves the clutch and the diff couplings.
+    /// Adds the drivetrain torques to `DrivetrainWheel::dw_torque`, fills `DrivetrainEngine::de_clutch_torque`
+    /// and advances the torsion springs (`Differential::di_delta_rotation`). `engine` may be null.
+    /// Detached wheels are left out of their side; a diff with a fully detached side doesn't couple.
+    void             Solve(DrivetrainWheel* wheels, int num_wheels, DrivetrainEngine* engine, float dt);
+
+private:
+    struct DiffNode
+    {
+        Differential*    dn_diff;
+        std::vector<int> dn_sides[2];
+        bool             dn_enabled;
+    };
+
+    struct Term
+    {
+        int          tm_node;           //!< Wheel index; the crankshaft is `num_wheels`
+        float        tm_speed_weight;   //!< Row of `J`
+        float        tm_torque_weight;  //!< Row of `G`
+    };
+
+    struct Coupling
+    {
+        float*       cp_delta_rotation; //!< Torsion spring state; null without a spring
+        int          cp_term_begin;
+        int          cp_term_count;
+        float        cp_torsion_rate;
+        float        cp_torsion_damp;
+        float        cp_torque_limit;   //!< 0 = unlimited
+        bool         cp_clamped;
+        float        cp_torque;
+    };
+
+    void             SplitTorque(const DrivetrainWheel* wheels, int num_wheels, float torque_scale);
+    void             AddDiffCouplings(const DrivetrainWheel* wheels);
+    void             SolveCouplings(float dt);
+
+    std::vector<DiffNode> m_diffs;
+
+    // Scratch, kept between steps to avoid allocations
+    std::vector<float>    m_torque_share;   //!< Per wheel, of the driveshaft torque
+    std::vector<float>    m_speed;          //!< Per node, predicted without the couplings
+    std::vector<float>    m_inv_inertia;    //!< Per node
+    std::vector<Coupling> m_couplings;
+    std::vector<Term>     m_terms;
+    std::vector<float>    m_matrix;         //!< Row-major, `m_couplings.size()` squared
+    std::vector<float>    m_rhs;
+    std::vector<float>    m_work;           //!< The system reduced to the unclamped rows, augmented with its rhs
+    std::vector<int>      m_free;
+};
+
+/// @} // addtogroup Trucks
+/// @} // addtogroup Gameplay
+
+} // namespace RoR
@@ -0,0 +1,370 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PhysicsRecorder.h"
+
+#include "Actor.h"
+#include "ActorManager.h"
+#include "EngineSim.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#ifdef USE_ZLIB
+#   include <zlib.h>
+#endif
+
+using namespace RoR;
+
+namespace {
+
+template <typename T> void WritePod(std::ofstream& file, T value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void WriteString(std::ofstream& file, std::string const& str)
+{
+    const uint16_t len = static_cast<uint16_t>(std::min(str.size(), size_t(UINT16_MAX)));
+    WritePod(file, len);
+    file.write(str.data(), len);
+}
+
+} // namespace
+
+bool PhysicsRecorder::IsCompressionAvailable()
+{
+#ifdef USE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+BitMask_t PhysicsRecorder::ParseChannels(std::string const& list)
+{
+    BitMask_t channels = 0;
+    for (std::string const& token: Ogre::StringUtil::split(list, ","))
+    {
+        if (token == "nodes")         { channels |= CHANNEL_NODE_POS; }
+        else if (token == "contacts") { channels |= CHANNEL_NODE_CONTACT; }
+        else if (token == "beams")    { channels |= CHANNEL_BEAM_STRESS; }
+        else if (token == "wheels")   { channels |= CHANNEL_WHEEL_SPEED; }
+        else if (token == "engine")   { channels |= CHANNEL_ENGINE_RPM; }
+        else if (token == "all")      { channels |= CHANNEL_NODE_POS | CHANNEL_NODE_CONTACT | CHANNEL_BEAM_STRESS | CHANNEL_WHEEL_SPEED | CHANNEL_ENGINE_RPM; }
+    }
+    return channels;
+}
+
+bool PhysicsRecorder::Start(std::string const& filename, std::vector<ActorPtr> const& actors, BitMask_t channels, int every_nth_step, std::string& out_error)
+{
+    ROR_ASSERT(!m_recording);
+
+    // Lay out the columns
+    std::vector<std::string> column_names;
+    std::string notes;
+    m_actors.clear();
+    for (ActorPtr const& actor: actors)
+    {
+        const std::string prefix = fmt::format("actor{}.", m_actors.size());
+        notes += fmt::format("actor{} = {} (instance {})\n", m_actors.size(), actor->ar_filename, actor->ar_instance_id);
+
+        RecordedActor rec;
+        rec.actor = actor;
+        rec.channels = channels;
+        rec.num_nodes = actor->ar_num_nodes;
+        rec.num_beams = actor->ar_num_beams;
+        rec.num_wheels = actor->ar_num_wheels;
+        rec.has_engine = actor->ar_engine != nullptr;
+        if (BITMASK_IS_1(channels, CHANNEL_NODE_POS))
+        {
+            for (int i = 0; i < rec.num_nodes; i++)
+            {
+                column_names.push_back(fmt::format("{}node{}.pos_x", prefix, i));
+                column_names.push_back(fmt::format("{}node{}.pos_y", prefix, i));
+                column_names.push_back(fmt::format("{}node{}.pos_z", prefix, i));
+            }
+        }
+        if (BITMASK_IS_1(channels, CHANNEL_NODE_CONTACT))
+        {
+            for (int i = 0; i < rec.num_nodes; i++)
+            {
+                column_names.push_back(fmt::format("{}node{}.contact_x", prefix, i));
+                column_names.push_back(fmt::format("{}node{}.contact_y", prefix, i));
+                column_names.push_back(fmt::format("{}node{}.contact_z", prefix, i));
+            }
+        }
+        if (BITMASK_IS_1(channels, CHANNEL_BEAM_STRESS))
+        {
+            for (int i = 0; i < rec.num_beams; i++)
+            {
+                column_names.push_back(fmt::format("{}beam{}.stress", prefix, i));
+            }
+        }
+        if (BITMASK_IS_1(channels, CHANNEL_WHEEL_SPEED))
+        {
+            for (int i = 0; i < rec.num_wheels; i++)
+            {
+                column_names.push_back(fmt::format("{}wheel{}.speed", prefix, i));
+            }
+        }
+        if (BITMASK_IS_1(channels, CHANNEL_ENGINE_RPM) && rec.has_engine)
+        {
+            column_names.push_back(fmt::format("{}engine.rpm", prefix));
+        }
+        m_actors.push_back(rec);
+    }
+
+    if (column_names.empty())
+    {
+        out_error = "nothing to record";
+        m_actors.clear();
+        return false;
+    }
+
+    m_file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open())
+    {
+        out_error = fmt::format("could not open '{}' for writing", filename);
+        m_actors.clear();
+        return false;
+    }
+
+    m_file.write("RORTELEM", 8);
+    WritePod(m_file, FORMAT_VERSION);
+    WritePod(m_file, PHYSICS_DT * every_nth_step);
+    WritePod(m_file, CHUNK_CAPACITY);
+    WritePod(m_file, static_cast<uint32_t>(column_names.size()));
+    for (std::string const& name: column_names)
+    {
+        WriteString(m_file, name);
+    }
+    WriteString(m_file, notes);
+
+    m_filename = filename;
+    m_num_columns = column_names.size();
+    m_every_nth_step = std::max(1, every_nth_step);
+    m_step_counter = 0;
+    m_next_sample = 0;
+    m_num_dropped_chunks = 0;
+    m_max_queued_chunks = std::max(size_t(1), MAX_QUEUED_BYTES / this->GetChunkBytes());
+    m_writer_quit = false;
+    m_free_chunks.clear();
+    m_chunk.reset(new Chunk());
+    m_chunk->columns.resize(m_num_columns * CHUNK_CAPACITY);
+    m_writer_thread = std::thread(&PhysicsRecorder::WriterThreadMain, this);
+    m_recording = true;
+    return true;
+}
+
+void PhysicsRecorder::Stop()
+{
+    if (!m_recording)
+        return;
+
+    if (m_chunk && m_chunk->num_samples > 0)
+    {
+        this->SubmitChunk();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        m_writer_quit = true;
+    }
+    m_queue_cv.notify_one();
+    m_writer_thread.join();
+
+    m_file.close();
+    m_chunk.reset();
+    m_free_chunks.clear();
+    m_actors.clear();
+    m_recording = false;
+}
+
+void PhysicsRecorder::OnPhysicsStep()
+{
+    if (!m_recording)
+        return;
+
+    if (++m_step_counter < m_every_nth_step)
+        return;
+    m_step_counter = 0;
+
+    this->CaptureSample(m_chunk->columns.data() + m_chunk->num_samples, CHUNK_CAPACITY);
+    m_chunk->num_samples++;
+    m_next_sample++;
+
+    if (m_chunk->num_samples == CHUNK_CAPACITY)
+    {
+        this->SubmitChunk();
+    }
+}
+
+void PhysicsRecorder::CaptureSample(float* column_base, size_t stride)
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    float* out = column_base;
+    for (RecordedActor& rec: m_actors)
+    {
+        Actor* actor = rec.actor.GetRef();
+        // A deleted actor keeps its columns, filled with NaN
+        const bool valid = actor->ar_state != ActorState::DISPOSED;
+
+        if (BITMASK_IS_1(rec.channels, CHANNEL_NODE_POS))
+        {
+            for (int i = 0; i < rec.num_nodes; i++)
+            {
+                const Ogre::Vector3 pos = valid ? actor->ar_nodes[i].AbsPosition : Ogre::Vector3(nan, nan, nan);
+                *out = pos.x; out += stride;
+                *out = pos.y; out += stride;
+                *out = pos.z; out += stride;
+            }
+        }
+        if (BITMASK_IS_1(rec.channels, CHANNEL_NODE_CONTACT))
+        {
+            for (int i = 0; i < rec.num_nodes; i++)
+            {
+                const Ogre::Vector3 force = valid ? actor->ar_nodes[i].nd_last_collision_force : Ogre::Vector3(nan, nan, nan);
+                *out = force.x; out += stride;
+                *out = force.y; out += stride;
+                *out = force.z; out += stride;
+            }
+        }
+        if (BITMASK_IS_1(rec.channels, CHANNEL_BEAM_STRESS))
+        {
+            for (int i = 0; i < rec.num_beams; i++)
+            {
+                *out = valid ? actor->ar_beams[i].stress : nan; out += stride;
+            }
+        }
+        if (BITMASK_IS_1(rec.channels, CHANNEL_WHEEL_SPEED))
+        {
+            for (int i = 0; i < rec.num_wheels; i++)
+            {
+                *out = valid ? actor->ar_wheels[i].wh_speed : nan; out += stride;
+            }
+        }
+        if (BITMASK_IS_1(rec.channels, CHANNEL_ENGINE_RPM) && rec.has_engine)
+        {
+            *out = valid ? actor->ar_engine->GetEngineRpm() : nan; out += stride;
+        }
+    }
+    ROR_ASSERT(out == column_base + m_num_columns * stride);
+}
+
+void PhysicsRecorder::SubmitChunk()
+{
+    std::unique_ptr<Chunk> next;
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        if (m_queue.size() < m_max_queued_chunks)
+        {
+            m_queue.push_back(std::move(m_chunk));
+            if (!m_free_chunks.empty())
+            {
+                next = std::move(m_free_chunks.back());
+                m_free_chunks.pop_back();
+            }
+        }
+        else
+        {
+            // Writer can't keep up; drop the samples rather than stalling the simulation.
+            m_num_dropped_chunks++;
+            next = std::move(m_chunk);
+        }
+    }
+    m_queue_cv.notify_one();
+
+    if (!next)
+    {
+        next.reset(new Chunk());
+        next->columns.resize(m_num_columns * CHUNK_CAPACITY);
+    }
+    next->first_sample = m_next_sample;
+    next->num_samples = 0;
+    m_chunk = std::move(next);
+}
+
+void PhysicsRecorder::WriterThreadMain()
+{
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+    while (true)
+    {
+        m_queue_cv.wait(lock, [this]{ return m_writer_quit || !m_queue.empty(); });
+        if (m_queue.empty())
+            return; // quit, and everything is written
+
+        std::unique_ptr<Chunk> chunk = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+        this->WriteChunk(*chunk);
+        lock.lock();
+        m_free_chunks.push_back(std::move(chunk));
+    }
+}
+
+void PhysicsRecorder::WriteChunk(Chunk const& chunk)
+{
+    // Transpose to byte planes, XOR-ing each value with its predecessor in the column.
+    // Slowly changing channels then produce long runs of zero bytes in the high planes.
+    const size_t n = chunk.num_samples;
+    const size_t num_values = m_num_columns * n;
+    m_encode_buf.resize(num_values * sizeof(uint32_t));
+    uint8_t* planes[4] = { &m_encode_buf[0], &m_encode_buf[num_values], &m_encode_buf[2 * num_values], &m_encode_buf[3 * num_values] };
+    size_t dst = 0;
+    for (size_t c = 0; c < m_num_columns; c++)
+    {
+        const float* column = chunk.columns.data() + c * CHUNK_CAPACITY;
+        uint32_t prev = 0;
+        for (size_t s = 0; s < n; s++)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &column[s], sizeof(bits));
+            const uint32_t delta = bits ^ prev;
+            prev = bits;
+            planes[0][dst] = static_cast<uint8_t>(delta);
+            planes[1][dst] = static_cast<uint8_t>(delta >> 8);
+            planes[2][dst] = static_cast<uint8_t>(delta >> 16);
+            planes[3][dst] = static_cast<uint8_t>(delta >> 24);
+            dst++;
+        }
+    }
+
+    Codec codec = CODEC_RAW;
+    const uint8_t* payload = m_encode_buf.data();
+    uint32_t payload_size = static_cast<uint32_t>(m_encode_buf.size());
+#ifdef USE_ZLIB
+    uLongf compressed_size = compressBound(static_cast<uLong>(m_encode_buf.size()));
+    m_compress_buf.resize(compressed_size);
+    if (compress2(m_compress_buf.data(), &compressed_size, m_encode_buf.data(), static_cast<uLong>(m_encode_buf.size()), Z_BEST_SPEED) == Z_OK)
+    {
+        codec = CODEC_DEFLATE;
+        payload = m_compress_buf.data();
+        payload_size = static_cast<uint32_t>(compressed_size);
+    }
+#endif
+
+    m_file.write("CHNK", 4);
+    WritePod(m_file, static_cast<uint64_t>(chunk.first_sample));
+    WritePod(m_file, static_cast<uint32_t>(chunk.num_samples));
+    WritePod(m_file, static_cast<uint8_t>(codec));
+    WritePod(m_file, payload_size);
+    m_file.write(reinterpret_cast<const char*>(payload), payload_size);
+}
@@ -0,0 +1,151 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Streaming recorder of per-substep physics channels, for offline analysis (telemetry).
+/// See 'tools/telemetry/ror_telemetry.py' for the reader.
+
+#pragma once
+
+#include "Application.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Physics
+/// @{
+
+/// Records selected channels of selected actors at a constant rate (every Nth physics substep)
+/// into a chunked, columnar, compressed file. Sampling happens on the simulation thread and only
+/// copies values into the current chunk; encoding and disk I/O run on a dedicated writer thread.
+///
+/// File layout (little endian):
+///   header: "RORTELEM", u32 version, f32 sample interval [s], u32 chunk capacity,
+///           u32 num columns, { u16 length, char[] name } per column, u16 length, char[] notes
+///   chunks: "CHNK", u64 first sample, u32 num samples, u8 codec, u32 payload size, payload
+/// Payload is column-major float32; each column is XOR-ed with its previous sample (first sample
+/// of a chunk is stored as-is) and the matrix is split into 4 byte planes, then optionally deflated.
+class PhysicsRecorder
+{
+public:
+    static const uint32_t FORMAT_VERSION   = 1;
+    static const uint32_t CHUNK_CAPACITY   = 512;  //!< Samples per chunk.
+    static const size_t   MAX_QUEUED_BYTES = 256u << 20; //!< If the writer falls this much behind, chunks are dropped (gap in sample numbers).
+
+    enum Codec: uint8_t
+    {
+        CODEC_RAW     = 0,
+        CODEC_DEFLATE = 1,
+    };
+
+    // Channel selection
+    static const BitMask_t CHANNEL_NODE_POS       = BITMASK(1);
+    static const BitMask_t CHANNEL_NODE_CONTACT   = BITMASK(2); //!< Last collision force
+    static const BitMask_t CHANNEL_BEAM_STRESS    = BITMASK(3);
+    static const BitMask_t CHANNEL_WHEEL_SPEED    = BITMASK(4);
+    static const BitMask_t CHANNEL_ENGINE_RPM     = BITMASK(5);
+
+    PhysicsRecorder() {}
+    ~PhysicsRecorder() { this->Stop(); }
+
+    PhysicsRecorder(PhysicsRecorder const&) = delete;
+    PhysicsRecorder& operator=(PhysicsRecorder const&) = delete;
+
+    /// Writes the header and launches the writer thread. Must not run concurrently with the simulation.
+    /// @param every_nth_step Sample interval in physics substeps (1 = every substep).
+    /// @return False and fills `out_error` if the file can't be opened or nothing is selected.
+    bool           Start(std::string const& filename, std::vector<ActorPtr> const& actors, BitMask_t channels, int every_nth_step, std::string& out_error);
+    /// Flushes the partial chunk and joins the writer thread. Must not run concurrently with the simulation.
+    void           Stop();
+    /// Invoked by `ActorManager` after each physics substep.
+    void           OnPhysicsStep();
+
+    bool           IsRecording() const         { return m_recording; }
+    std::string    GetFilename() const         { return m_filename; }
+    uint64_t       GetNumSamples() const       { return m_next_sample; }
+    size_t         GetNumColumns() const       { return m_num_columns; }
+    size_t         GetNumDroppedChunks() const { return m_num_dropped_chunks; }
+    size_t         GetMaxQueuedChunks() const  { return m_max_queued_chunks; } //!< `MAX_QUEUED_BYTES` in chunks of the current recording, at least 1.
+    size_t         GetChunkBytes() const       { return m_num_columns * CHUNK_CAPACITY * sizeof(float); }
+
+    static BitMask_t ParseChannels(std::string const& list); //!< Comma separated: nodes, contacts, beams, wheels, engine, all
+    static bool      IsCompressionAvailable();
+
+private:
+    struct Chunk
+    {
+        uint64_t           first_sample = 0;
+        uint32_t           num_samples = 0;
+        std::vector<float> columns; //!< column-major, CHUNK_CAPACITY values per column
+    };
+
+    struct RecordedActor
+    {
+        ActorPtr   actor;
+        BitMask_t  channels = 0;
+        int        num_nodes = 0;   //!< Counts are captured at start; a disposed actor may not report them anymore.
+        int        num_beams = 0;
+        int        num_wheels = 0;
+        bool       has_engine = false;
+    };
+
+    void           CaptureSample(float* column_base, size_t stride);
+    void           SubmitChunk();
+    void           WriterThreadMain();
+    void           WriteChunk(Chunk const& chunk); //!< Writer thread only.
+
+    // Simulation thread; the atomics are also read by `IsRecording()`/`GetNumSamples()` from the main thread.
+    std::vector<RecordedActor> m_actors;
+    std::unique_ptr<Chunk>     m_chunk;
+    size_t                     m_num_columns = 0;
+    int                        m_every_nth_step = 1;
+    int                        m_step_counter = 0;
+    std::atomic<uint64_t>      m_next_sample{0};
+    std::atomic<bool>          m_recording{false};
+    std::string                m_filename;
+
+    // Shared with writer thread
+    std::mutex                          m_queue_mutex;
+    std::condition_variable             m_queue_cv;
+    std::deque<std::unique_ptr<Chunk>>  m_queue;
+    size_t                              m_max_queued_chunks = 1;
+    std::vector<std::unique_ptr<Chunk>> m_free_chunks;  //!< Recycled buffers, to avoid allocating while recording.
+    bool                                m_writer_quit = false;
+    std::atomic<size_t>                 m_num_dropped_chunks{0};
+
+    // Writer thread
+    std::thread                m_writer_thread;
+    std::ofstream              m_file;
+    std::vector<uint8_t>       m_encode_buf;
+    std::vector<uint8_t>       m_compress_buf;
+};
+
+/// @} // addtogroup Physics
+
+} // namespace RoR
@@ -586,7 +586,7 @@ bool ActorManager::SaveScene(Ogre::String filename)
 
         // Wheel differentials
         rapidjson::Value j_wheel_diffs(rapidjson::kArrayType);
-        for (int i = 0; i < actor->m_num_wheel_diffs; i++)
+        for (int i = 0; i < static_cast<int>(actor->m_wheel_diffs.size()); i++)
         {
             j_wheel_diffs.PushBack(actor->m_wheel_diffs[i]->GetActiveDiffType(), j_doc.GetAllocator());
         }
@@ -594,7 +594,7 @@ bool ActorManager::SaveScene(Ogre::String filename)
 
         // Axle differentials
         rapidjson::Value j_axle_diffs(rapidjson::kArrayType);
-        for (int i = 0; i < actor->m_num_axle_diffs; i++)
+        for (int i = 0; i < static_cast<int>(actor->m_axle_diffs.size()); i++)
         {
             j_axle_diffs.PushBack(actor->m_axle_diffs[i]->GetActiveDiffType(), j_doc.GetAllocator());
         }
@@ -864,7 +864,7 @@ void ActorManager::RestoreSavedState(ActorPtr actor, rapidjson::Value const& j_e
         actor->ar_wheels[i].wh_is_detached = j_entry["wheels"][i].GetBool();
     }
 
-    for (int i = 0; i < actor->m_num_wheel_diffs; i++)
+    for (int i = 0; i < static_cast<int>(actor->m_wheel_diffs.size()); i++)
     {
         for (int k = 0; k < actor->m_wheel_diffs[i]->GetNumDiffTypes(); k++)
         {
@@ -873,7 +873,7 @@ void ActorManager::RestoreSavedState(ActorPtr actor, rapidjson::Value const& j_e
         }
     }
 
-    for (int i = 0; i < actor->m_num_axle_diffs; i++)
+    for (int i = 0; i < static_cast<int>(actor->m_axle_diffs.size()); i++)
     {
         for (int k = 0; k < actor->m_axle_diffs[i]->GetNumDiffTypes(); k++)
         {
@@ -22,7 +22,6 @@ static const int   MAX_ACTORS                 = 5000;            //!< maximum nu
 static const int   MAX_WHEELS                 = 64;              //!< maximum number of wheels per actor
 static const int   MAX_SUBMESHES              = 500;             //!< maximum number of submeshes per actor
 static const int   MAX_TEXCOORDS              = 3000;            //!< maximum number of texture coordinates per actor
-static const int   MAX_CABS                   = 3000;            //!< maximum number of cabs per actor
 static const int   MAX_COMMANDS               = 84;              //!< maximum number of commands per actor
 static const int   MAX_CAMERAS                = 10;              //!< maximum number of cameras per actor
 static const int   MAX_AEROENGINES            = 8;               //!< maximum number of aero engines per actor
@@ -29,10 +29,12 @@
 
 #pragma once
 
+#include "AnimationTable.h"
 #include "ForwardDeclarations.h"
 #include "SimConstants.h"
 #include "BitFlags.h"
 #include "CmdKeyInertia.h"
+#include "CollisionCells.h"
 #include "InputEngine.h"
 
 #include <memory>
@@ -42,17 +44,6 @@
 
 namespace RoR {
 
-enum CollisionEventFilter: short
-{
-    EVENT_NONE = 0,
-    EVENT_ALL,
-    EVENT_AVATAR,
-    EVENT_TRUCK,
-    EVENT_AIRPLANE,
-    EVENT_BOAT,
-    EVENT_DELETE
-};
-
 enum class ExtCameraMode
 {
     INVALID = -1,
@@ -149,42 +140,6 @@ enum HydroFlags
     HYDRO_FLAG_REV_ELEVATOR = BITMASK(8),
 };
 
-enum AnimFlags
-{
-    ANIM_FLAG_AIRSPEED      = BITMASK(1),
-    ANIM_FLAG_VVI           = BITMASK(2),
-    ANIM_FLAG_ALTIMETER     = BITMASK(3),
-    ANIM_FLAG_AOA           = BITMASK(4),
-    ANIM_FLAG_FLAP          = BITMASK(5),
-    ANIM_FLAG_AIRBRAKE      = BITMASK(6),
-    ANIM_FLAG_ROLL          = BITMASK(7),
-    ANIM_FLAG_PITCH         = BITMASK(8),
-    ANIM_FLAG_THROTTLE      = BITMASK(9),
-    ANIM_FLAG_RPM           = BITMASK(10),
-    ANIM_FLAG_ACCEL         = BITMASK(11),
-    ANIM_FLAG_BRAKE         = BITMASK(12),
-    ANIM_FLAG_CLUTCH        = BITMASK(13),
-    ANIM_FLAG_TACHO         = BITMASK(14),
-    ANIM_FLAG_SPEEDO        = BITMASK(15),
-    ANIM_FLAG_PBRAKE        = BITMASK(16),
-    ANIM_FLAG_TURBO         = BITMASK(17),
-    ANIM_FLAG_SHIFTER       = BITMASK(18),
-    ANIM_FLAG_AETORQUE      = BITMASK(19),
-    ANIM_FLAG_AEPITCH       = BITMASK(20),
-    ANIM_FLAG_AESTATUS      = BITMASK(21),
-    ANIM_FLAG_TORQUE        = BITMASK(22),
-    ANIM_FLAG_HEADING       = BITMASK(23),
-    ANIM_FLAG_DIFFLOCK      = BITMASK(24),
-    ANIM_FLAG_STEERING      = BITMASK(25),
-    ANIM_FLAG_EVENT         = BITMASK(26),
-    ANIM_FLAG_AILERONS      = BITMASK(27),
-    ANIM_FLAG_ARUDDER       = BITMASK(28),
-    ANIM_FLAG_BRUDDER       = BITMASK(29),
-    ANIM_FLAG_BTHROTTLE     = BITMASK(30),
-    ANIM_FLAG_PERMANENT     = BITMASK(31),
-    ANIM_FLAG_ELEVATORS     = BITMASK(32),
-};
-
 enum AnimModes
 {
     ANIM_MODE_ROTA_X        = BITMASK(1),
@@ -591,6 +546,7 @@ struct hydrobeam_t
     int      hb_flags;
     int      hb_anim_flags; //!< Animators (beams updating length based on simulation variables)
     float    hb_anim_param; //!< Animators (beams updating length based on simulation variables)
+    AnimProgram hb_anim_program; //!< Animators; compiled at spawn, see `ActorSpawner::CompileAnimations()`
     RoR::CmdKeyInertia  hb_inertia;
 };
 
@@ -698,31 +654,6 @@ private:
 /// @addtogroup Collisions
 /// @{
 
-
-struct collision_box_t
-{
-    bool virt;
-    bool refined;
-    bool selfrotated;
-    bool camforced;
-    bool enabled;
-    CollisionEventFilter event_filter;
-    short eventsourcenum;
-    Ogre::Vector3 lo;           //!< absolute collision box
-    Ogre::Vector3 hi;           //!< absolute collision box
-    Ogre::Vector3 center;       //!< center of rotation
-    Ogre::Quaternion rot;       //!< rotation
-    Ogre::Quaternion unrot;     //!< rotation
-    Ogre::Vector3 selfcenter;   //!< center of self rotation
-    Ogre::Quaternion selfrot;   //!< self rotation
-    Ogre::Quaternion selfunrot; //!< self rotation
-    Ogre::Vector3 relo;         //!< relative collision box
-    Ogre::Vector3 rehi;         //!< relative collision box
-    Ogre::Vector3 campos;       //!< camera position
-    Ogre::Vector3 debug_verts[8];//!< box corners in absolute world position
-};
-typedef std::vector<collision_box_t*> CollisionBoxPtrVec;
-
 /// Surface friction properties.
 struct ground_model_t
 {
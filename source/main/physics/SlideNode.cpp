@@ -30,6 +30,8 @@
 #include "Application.h"
 #include "SimData.h"
 
+#include <limits>
+
 using namespace RoR;
 
 /**
@@ -113,20 +115,47 @@ void SlideNode::UpdateForces(float dt)
 
 RailSegment* RailGroup::FindClosestSegment(const Ogre::Vector3& point)
 {
-    float closest_dist_sq = SlideNode::getLenTo(&this->rg_segments[0], point);
-    size_t closest_seg = 0;
+    ROR_ASSERT(!rg_bvh.IsEmpty());
+
+    // Ties resolve to the lowest segment index, same as a linear scan would.
+    float closest_dist = std::numeric_limits<float>::infinity();
+    int closest_seg = 0;
+    rg_bvh.FindNearest(closest_dist,
+        [&point](BvhNode const& bvh_node) { return Bvh::GetDistToBox(point, bvh_node.bvh_min, bvh_node.bvh_max); },
+        [&](int i)
+        {
+            const float dist = SlideNode::getLenTo(&this->rg_segments[i], point);
+            if (dist < closest_dist || (dist == closest_dist && i < closest_seg))
+            {
+                closest_dist = dist;
+                closest_seg = i;
+            }
+        });
 
-    for (size_t i = 1; i < this->rg_segments.size(); ++i)
+    return &this->rg_segments[closest_seg];
+}
+
+void RailGroup::BuildBvh()
+{
+    std::vector<Ogre::Vector3> centroids(rg_segments.size());
+    for (size_t i = 0; i < rg_segments.size(); i++)
     {
-        const float dist_sq = SlideNode::getLenTo(&this->rg_segments[i], point);
-        if (dist_sq < closest_dist_sq)
-        {
-            closest_dist_sq = dist_sq;
-            closest_seg = i;
-        }
+        centroids[i] = (rg_segments[i].rs_beam->p1->AbsPosition + rg_segments[i].rs_beam->p2->AbsPosition) * 0.5f;
     }
+    rg_bvh.Build(centroids);
+    this->RefitBvh();
+}
 
-    return &this->rg_segments[closest_seg];
+void RailGroup::RefitBvh()
+{
+    rg_bvh.Refit([this](int i, Ogre::Vector3& box_min, Ogre::Vector3& box_max)
+        {
+            const beam_t* beam = rg_segments[i].rs_beam;
+            box_min.makeFloor(beam->p1->AbsPosition);
+            box_min.makeFloor(beam->p2->AbsPosition);
+            box_max.makeCeil(beam->p1->AbsPosition);
+            box_max.makeCeil(beam->p2->AbsPosition);
+        });
 }
 
 RailSegment* RailSegment::CheckCurSlideSegment(const Ogre::Vector3& point)
@@ -201,6 +230,7 @@ void SlideNode::ResetPositions()
 {
     if (m_cur_railgroup != nullptr)
     {
+        m_cur_railgroup->RefitBvh(); // The actor was moved, the rail may be on another one
         m_cur_rail_seg = m_cur_railgroup->FindClosestSegment(m_sliding_node->AbsPosition);
         m_sliding_beam = (m_cur_rail_seg ? m_cur_rail_seg->rs_beam : nullptr);
         this->UpdatePosition();
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include "Bvh.h"
 #include "ForwardDeclarations.h"
 
 #include <OgreVector3.h>
@@ -54,11 +55,18 @@ struct RailGroup
 {
     RailGroup(): rg_id(-1) {}
 
-    /// Search for closest rail segment (the one with closest node in it) in the entire RailGroup
+    /// Search for closest rail segment (the one with closest node in it) in the entire RailGroup; refit the boxes first
     RailSegment* FindClosestSegment(Ogre::Vector3 const& point );
 
+    /// Builds the segment hierarchy; call once `rg_segments` is final.
+    void BuildBvh();
+    /// Recomputes all boxes bottom-up from current node positions. Not done every substep (networked and sleeping
+    /// actors aren't stepped anyway); call before searching, see `Actor::UpdateRailBvhs()`.
+    void RefitBvh();
+
     std::vector<RailSegment> rg_segments;
     int                      rg_id; //!< Spawn context - matching separately defined rails with slidenodes.
+    Bvh                      rg_bvh; //!< Over `rg_segments`
 };
 
 class SlideNode
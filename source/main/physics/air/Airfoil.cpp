@@ -24,12 +24,50 @@
 
 #include <Ogre.h>
 
+#include <map>
+#include <mutex>
+
 using namespace Ogre;
 using namespace RoR;
 
+namespace {
+
+// Interned polar tables, keyed by file name. Entries expire together with the last airfoil using them.
+std::mutex                                               g_polar_cache_mutex;
+std::map<std::string, std::weak_ptr<const AirfoilPolar>> g_polar_cache;
+
+} // anonymous namespace
+
 Airfoil::Airfoil(Ogre::String const& fname)
+    : m_polar(Airfoil::AcquirePolar(fname))
+{
+}
+
+Airfoil::~Airfoil()
 {
-    for (int i = 0; i < 3601; i++) //init in case of bad things
+}
+
+AirfoilPolarPtr Airfoil::AcquirePolar(Ogre::String const& fname)
+{
+    std::lock_guard<std::mutex> lock(g_polar_cache_mutex);
+
+    AirfoilPolarPtr polar = g_polar_cache[fname].lock();
+    if (!polar)
+    {
+        std::shared_ptr<AirfoilPolar> fresh = std::make_shared<AirfoilPolar>();
+        Airfoil::LoadPolar(fname, *fresh);
+        polar = fresh;
+        g_polar_cache[fname] = polar;
+    }
+    return polar;
+}
+
+void Airfoil::LoadPolar(Ogre::String const& fname, AirfoilPolar& polar)
+{
+    float* cl = polar.cl;
+    float* cd = polar.cd;
+    float* cm = polar.cm;
+    for (int i = 0; i < AirfoilPolar::NUM_SAMPLES; i++) //init in case of bad things
     {
         cl[i] = 0;
         cd[i] = 0;
@@ -98,12 +136,11 @@ Airfoil::Airfoil(Ogre::String const& fname)
     }
 }
 
-Airfoil::~Airfoil()
-{
-}
-
-void Airfoil::getparams(float a, float cratio, float cdef, float* ocl, float* ocd, float* ocm)
+void Airfoil::getparams(float a, float cratio, float cdef, float* ocl, float* ocd, float* ocm) const
 {
+    const float* cl = m_polar->cl;
+    const float* cd = m_polar->cd;
+    const float* cm = m_polar->cm;
     int ta = (int)(a / 360.0);
     //		float va=360.0f*fmod(a, 360.0f); FMOD IS TOTALLY UNRELIABLE HERE : fmod(-180.0f, 360.0f)=-180.0f!!!!!
     float va = a - (float)(ta * 360);
@@ -126,3 +163,56 @@ void Airfoil::getparams(float a, float cratio, float cdef, float* ocl, float* oc
     *ocd = cd[dia] + 0.00015 * (1.0 - cratio) * cdef * cdef;
     *ocm = cm[ia] + 0.20 * sign * (1.0 - cratio) * sqrt(fabs(cdef));
 }
+
+void AirfoilQueryBatch::resize(size_t count)
+{
+    polar.resize(count, nullptr);
+    aoa.resize(count, 0.f);
+    cratio.resize(count, 0.f);
+    cdef.resize(count, 0.f);
+    cl.resize(count, 0.f);
+    cd.resize(count, 0.f);
+    cm.resize(count, 0.f);
+    ia.resize(count, 0);
+    dia.resize(count, 0);
+}
+
+void Airfoil::getparamsBatch(AirfoilQueryBatch& batch)
+{
+    const size_t count = batch.size();
+
+    // Pass 1: table indices and control surface corrections; same math as `getparams()`, written without branches.
+    for (size_t i = 0; i < count; i++)
+    {
+        const float a = batch.aoa[i];
+        const float cratio = batch.cratio[i];
+        const float cdef = batch.cdef[i];
+
+        float va = a - (float)((int)(a / 360.0f) * 360);
+        va = (va > 180.0f) ? (va - 360.0f) : va;
+        va = (va < -180.0f) ? (va + 360.0f) : va;
+        batch.ia[i] = (int)((va + 180.0f) * 10.0f);
+
+        float dva = va + 1.15f * (1.0f - cratio) * cdef;
+        dva = (dva > 180.0f) ? (dva - 360.0f) : dva;
+        dva = (dva < -180.0f) ? (dva + 360.0f) : dva;
+        batch.dia[i] = (int)((dva + 180.0f) * 10.0f);
+
+        const float sign = (cdef < 0.0f) ? -1.0f : 1.0f;
+        const float flap = (1.0f - cratio) * sqrtf(fabsf(cdef));
+        batch.cl[i] = -0.66f * sign * flap;
+        batch.cd[i] = 0.00015f * (1.0f - cratio) * cdef * cdef;
+        batch.cm[i] = 0.20f * sign * flap;
+    }
+
+    // Pass 2: gather from the (shared) polar tables.
+    for (size_t i = 0; i < count; i++)
+    {
+        const AirfoilPolar* polar = batch.polar[i];
+        if (polar == nullptr)
+            continue;
+        batch.cl[i] += polar->cl[batch.ia[i]];
+        batch.cd[i] += polar->cd[batch.dia[i]];
+        batch.cm[i] += polar->cm[batch.ia[i]];
+    }
+}
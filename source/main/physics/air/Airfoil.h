@@ -22,28 +22,69 @@
 
 #include "Application.h"
 
+#include <memory>
+#include <vector>
+
 namespace RoR {
 
 /// @addtogroup Physics
 /// @{
 
+/// Lift/drag/moment coefficients sampled every 0.1 degree over [-180, 180]; immutable once loaded.
+/// Shared between all airfoils which use the same file, see `Airfoil::AcquirePolar()`.
+struct AirfoilPolar
+{
+    static const int NUM_SAMPLES = 3601;
+
+    float cl[NUM_SAMPLES];
+    float cd[NUM_SAMPLES];
+    float cm[NUM_SAMPLES];
+};
+
+typedef std::shared_ptr<const AirfoilPolar> AirfoilPolarPtr;
+
+/// Structure-of-arrays input/output for evaluating many wing segments in one pass, see `Airfoil::getparamsBatch()`
+struct AirfoilQueryBatch
+{
+    void resize(size_t count);
+    size_t size() const { return polar.size(); }
+
+    std::vector<const AirfoilPolar*> polar; //!< Input; nullptr = skip this slot
+    std::vector<float> aoa;                 //!< Input; angle of attack in degrees
+    std::vector<float> cratio;              //!< Input; control surface chord ratio
+    std::vector<float> cdef;                //!< Input; control surface deflection in degrees
+    std::vector<float> cl;                  //!< Output
+    std::vector<float> cd;                  //!< Output
+    std::vector<float> cm;                  //!< Output
+    std::vector<int>   ia;                  //!< Scratch; lift/moment table index
+    std::vector<int>   dia;                 //!< Scratch; drag table index
+};
+
 /// Represents an airfoil http://en.wikipedia.org/wiki/Airfoil
 class Airfoil
 {
 public:
 
-    /// Parses the airfoil from file.
+    /// Fetches the airfoil from the polar cache, parsing the file on first use.
     /// @param fname File name (X-Plane's .AFL file format)
     Airfoil(Ogre::String const& fname);
     ~Airfoil();
 
-    void getparams(float a, float cratio, float cdef, float* ocl, float* ocd, float* ocm);
+    void getparams(float a, float cratio, float cdef, float* ocl, float* ocd, float* ocm) const;
+
+    const AirfoilPolar* getPolar() const { return m_polar.get(); }
+
+    /// Evaluates all slots of the batch; the arithmetic is branch-free so that the compiler can vectorize it.
+    static void getparamsBatch(AirfoilQueryBatch& batch);
+
+    /// Returns the interned polar for given file; tables are parsed once and shared until the last user releases them.
+    static AirfoilPolarPtr AcquirePolar(Ogre::String const& fname);
 
 private:
 
-    float cl[3601];
-    float cd[3601];
-    float cm[3601];
+    static void LoadPolar(Ogre::String const& fname, AirfoilPolar& polar);
+
+    AirfoilPolarPtr m_polar;
 };
 
 /// @} // addtogroup Physics
@@ -0,0 +1,258 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ActorPlacement.h"
+
+#include <OgreMath.h>
+#include <OgreRay.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+using namespace Ogre;
+using namespace RoR;
+
+const float ActorPlacement::PRECISION = 0.05f;
+const float ActorPlacement::COARSE_STEP = 0.5f;
+
+/// Same test as `PointColDetector::query()`: is the point within the box of the triangle, enlarged by `margin`?
+static bool IsPointNearTriangle(Vector3 const& point, Vector3 const* tri, Vector3 const& tri_offset, float margin)
+{
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const float lo = std::min(tri[0][axis], std::min(tri[1][axis], tri[2][axis])) + tri_offset[axis] - margin;
+        const float hi = std::max(tri[0][axis], std::max(tri[1][axis], tri[2][axis])) + tri_offset[axis] + margin;
+        if (point[axis] < lo || point[axis] > hi)
+            return false;
+    }
+    return true;
+}
+
+/// Beam against cab; the beam hits if it crosses the triangle between its ends
+static bool IsSegmentHittingTriangle(Vector3 const& origin, Vector3 const& target, Vector3 const& a, Vector3 const& b, Vector3 const& c)
+{
+    auto result = Math::intersects(Ray(origin, target - origin), a, b, c);
+    return result.first && result.second < 1.0f;
+}
+
+ActorPlacement::ActorPlacement(Shape actor, float max_distance, BitMask_t flags)
+    : m_shape(std::move(actor))
+    , m_max_distance(max_distance)
+    , m_flags(flags)
+{
+    BuildShapeBvhs(m_shape);
+}
+
+bool ActorPlacement::CanReach(Vector3 const& box_min, Vector3 const& box_max) const
+{
+    const Vector3 reach(m_max_distance + COARSE_STEP);
+    return Bvh::AreBoxesTouching(m_shape.sh_box_min - reach, m_shape.sh_box_max + reach, box_min, box_max);
+}
+
+void ActorPlacement::AddObstacle(Shape obstacle)
+{
+    m_obstacles.push_back(std::move(obstacle));
+    BuildShapeBvhs(m_obstacles.back());
+}
+
+void ActorPlacement::BuildShapeBvhs(Shape& shape)
+{
+    BuildBvh(shape.sh_node_bvh, shape.sh_nodes, 1);
+    BuildBvh(shape.sh_cab_bvh, shape.sh_cabs, 3);
+    BuildBvh(shape.sh_beam_bvh, shape.sh_beams, 2);
+}
+
+void ActorPlacement::BuildBvh(Bvh& bvh, std::vector<Vector3> const& points, int points_per_item)
+{
+    // The snapshot doesn't move, so the boxes are final right away.
+    std::vector<Vector3> centroids(points.size() / points_per_item, Vector3::ZERO);
+    for (size_t i = 0; i < centroids.size(); i++)
+    {
+        for (int k = 0; k < points_per_item; k++)
+        {
+            centroids[i] += points[i * points_per_item + k] / static_cast<float>(points_per_item);
+        }
+    }
+    bvh.Build(centroids);
+    bvh.Refit([&points, points_per_item](int item, Vector3& box_min, Vector3& box_max)
+        {
+            for (int k = 0; k < points_per_item; k++)
+            {
+                box_min.makeFloor(points[item * points_per_item + k]);
+                box_max.makeCeil(points[item * points_per_item + k]);
+            }
+        });
+}
+
+bool ActorPlacement::IsColliding(Vector3 const& offset) const
+{
+    for (Shape const& obstacle : m_obstacles)
+    {
+        if (this->IsCollidingWith(obstacle, offset))
+            return true;
+    }
+    return false;
+}
+
+bool ActorPlacement::IsCollidingWith(Shape const& obstacle, Vector3 const& offset) const
+{
+    Shape const& self = m_shape;
+    if (!Bvh::AreBoxesTouching(self.sh_box_min + offset, self.sh_box_max + offset, obstacle.sh_box_min, obstacle.sh_box_max))
+        return false;
+
+    // Own contacters against others cabs
+    if (m_flags & TEST_NODES_VS_CABS)
+    {
+        const float margin = obstacle.sh_collision_range * 3.0f;
+        if (Bvh::AnyPairWithin(self.sh_node_bvh, offset, obstacle.sh_cab_bvh, margin, [&](int node, int cab)
+            { return IsPointNearTriangle(self.sh_nodes[node] + offset, &obstacle.sh_cabs[cab * 3], Vector3::ZERO, margin); }))
+        {
+            return true;
+        }
+    }
+
+    // Proximity of own nodes against others nodes
+    const float proximity = std::max(.05f, std::sqrt(std::max(self.sh_min_camera_radius, obstacle.sh_min_camera_radius)) / 50.f);
+    if (Bvh::AnyPairWithin(self.sh_node_bvh, offset, obstacle.sh_node_bvh, std::sqrt(proximity), [&](int node, int other_node)
+        { return (self.sh_nodes[node] + offset).squaredDistance(obstacle.sh_nodes[other_node]) < proximity; }))
+    {
+        return true;
+    }
+
+    // Own cabs against others contacters
+    if (m_flags & TEST_CABS_VS_NODES)
+    {
+        const float margin = self.sh_collision_range * 3.0f;
+        if (Bvh::AnyPairWithin(self.sh_cab_bvh, offset, obstacle.sh_node_bvh, margin, [&](int cab, int node)
+            {
+                return (!obstacle.sh_linked || obstacle.sh_node_contacter[node]) &&
+                    IsPointNearTriangle(obstacle.sh_nodes[node], &self.sh_cabs[cab * 3], offset, margin);
+            }))
+        {
+            return true;
+        }
+    }
+
+    // Own (contactable) beams against others cabs
+    if (Bvh::AnyPairWithin(self.sh_beam_bvh, offset, obstacle.sh_cab_bvh, 0.f, [&](int beam, int cab)
+        {
+            return IsSegmentHittingTriangle(self.sh_beams[beam * 2] + offset, self.sh_beams[beam * 2 + 1] + offset,
+                obstacle.sh_cabs[cab * 3], obstacle.sh_cabs[cab * 3 + 1], obstacle.sh_cabs[cab * 3 + 2]);
+        }))
+    {
+        return true;
+    }
+
+    // Own cabs against others (contactable) beams
+    if (Bvh::AnyPairWithin(self.sh_cab_bvh, offset, obstacle.sh_beam_bvh, 0.f, [&](int cab, int beam)
+        {
+            return IsSegmentHittingTriangle(obstacle.sh_beams[beam * 2], obstacle.sh_beams[beam * 2 + 1],
+                self.sh_cabs[cab * 3] + offset, self.sh_cabs[cab * 3 + 1] + offset, self.sh_cabs[cab * 3 + 2] + offset);
+        }))
+    {
+        return true;
+    }
+
+    return false;
+}
+
+float ActorPlacement::GetBoxClearance(Vector3 const& direction) const
+{
+    // Range of distances at which the moving box touches each obstacle's box
+    std::vector<std::pair<float, float>> spans;
+    for (Shape const& obstacle : m_obstacles)
+    {
+        float enter = 0.f;
+        float exit = std::numeric_limits<float>::max();
+        for (int axis = 0; axis < 3; axis++)
+        {
+            const float lo = obstacle.sh_box_min[axis] - m_shape.sh_box_max[axis];
+            const float hi = obstacle.sh_box_max[axis] - m_shape.sh_box_min[axis];
+            if (direction[axis] == 0.f)
+            {
+                if (lo > 0.f || hi < 0.f)
+                    enter = exit + 1.f; // Never touches
+                continue;
+            }
+            float t0 = lo / direction[axis];
+            float t1 = hi / direction[axis];
+            if (t0 > t1)
+                std::swap(t0, t1);
+            enter = std::max(enter, t0);
+            exit = std::min(exit, t1);
+        }
+        if (enter <= exit)
+            spans.push_back(std::make_pair(enter, exit));
+    }
+
+    // First distance not covered by any span
+    std::sort(spans.begin(), spans.end());
+    float clearance = 0.f;
+    for (auto const& span : spans)
+    {
+        if (span.first > clearance)
+            break;
+        clearance = std::max(clearance, span.second + PRECISION);
+    }
+    return clearance;
+}
+
+Vector3 ActorPlacement::FindFreeOffset(Vector3 direction) const
+{
+    if (direction == Vector3::ZERO)
+        return Vector3::ZERO;
+
+    const float max_distance = direction.normalise();
+    if (!this->IsColliding(Vector3::ZERO))
+        return Vector3::ZERO;
+
+    // Beyond the clearance, the boxes are apart and so is everything within them.
+    const float clearance = this->GetBoxClearance(direction);
+    const float reach = std::min(clearance, max_distance);
+
+    // March to the first free offset ...
+    float colliding = 0.f;
+    float free = -1.f;
+    while (colliding < reach)
+    {
+        const float distance = std::min(colliding + COARSE_STEP, reach);
+        if ((distance == clearance) || !this->IsColliding(direction * distance))
+        {
+            free = distance;
+            break;
+        }
+        colliding = distance;
+    }
+
+    if (free < 0.f)
+        return direction * max_distance; // Nothing free within reach
+
+    // ... and bisect back towards the last colliding one.
+    while (free - colliding > PRECISION)
+    {
+        const float distance = 0.5f * (colliding + free);
+        if (this->IsColliding(direction * distance))
+            colliding = distance;
+        else
+            free = distance;
+    }
+
+    return direction * free;
+}
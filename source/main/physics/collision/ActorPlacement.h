@@ -0,0 +1,101 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Collision-free placement of freshly spawned actors, see `Actor::resolveCollisions()`.
+
+#pragma once
+
+#include "BitFlags.h"
+#include "Bvh.h"
+
+#include <OgreVector3.h>
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Physics
+/// @{
+
+/// @addtogroup Collisions
+/// @{
+
+/// Snapshot of an actor and the actors around it, taken once per `Actor::resolveCollisions()`.
+/// It holds copies of the positions only, it doesn't depend on `Actor`.
+/// Every shape (contacter nodes, collcabs, contactable beams) gets a bounding volume hierarchy,
+/// so testing a candidate offset costs a few tree descents instead of scanning all node pairs.
+/// Along each direction, the bounding boxes give the distance at which the actor is clear of all
+/// obstacles; the first free offset before that is found by a coarse march refined by bisection.
+class ActorPlacement
+{
+public:
+    static const float PRECISION;    //!< The resulting offset is at most this far past the closest free spot (5 cm, like the former 5 cm stepping)
+    static const float COARSE_STEP;  //!< Stride of the march; free gaps narrower than this may be skipped
+
+    // Placement flags; mirror the collision detectors the actor has
+    static const BitMask_t TEST_NODES_VS_CABS = BITMASK(1); //!< Own contacters against other's collcabs (intra-point detector)
+    static const BitMask_t TEST_CABS_VS_NODES = BITMASK(2); //!< Own collcabs against other's contacters (inter-point detector)
+
+    /// Geometry of one actor, filled in by `Actor::resolveCollisions()`; the hierarchies are built by `ActorPlacement`.
+    struct Shape
+    {
+        Ogre::Vector3               sh_box_min;         //!< `Actor::ar_bounding_box`
+        Ogre::Vector3               sh_box_max;
+        float                       sh_collision_range = 0.f;
+        float                       sh_min_camera_radius = 0.f;
+        bool                        sh_linked = false;  //!< Obstacle is linked to the placed actor; only its contacters count
+        std::vector<Ogre::Vector3>  sh_nodes;           //!< Contacter and contactable nodes
+        std::vector<bool>           sh_node_contacter;
+        std::vector<Ogre::Vector3>  sh_cabs;            //!< 3 corners per collcab
+        std::vector<Ogre::Vector3>  sh_beams;           //!< 2 ends per beam between contacter/contactable nodes
+        Bvh                         sh_node_bvh;
+        Bvh                         sh_cab_bvh;
+        Bvh                         sh_beam_bvh;
+    };
+
+    ActorPlacement(Shape actor, float max_distance, BitMask_t flags);
+
+    /// Can the actor's box touch this box while moving by up to `max_distance`? Others needn't be added.
+    bool           CanReach(Ogre::Vector3 const& box_min, Ogre::Vector3 const& box_max) const;
+    void           AddObstacle(Shape obstacle);
+
+    /// Does the actor, moved by `offset`, touch any other?
+    bool           IsColliding(Ogre::Vector3 const& offset) const;
+    /// Minimal offset towards `direction`, at most its length, which resolves all collisions.
+    /// @return Zero if there's no collision; the full `direction` if nothing is free within reach.
+    Ogre::Vector3  FindFreeOffset(Ogre::Vector3 direction) const;
+    size_t         GetNumObstacles() const { return m_obstacles.size(); }
+
+private:
+    static void    BuildShapeBvhs(Shape& shape);
+    static void    BuildBvh(Bvh& bvh, std::vector<Ogre::Vector3> const& points, int points_per_item);
+    bool           IsCollidingWith(Shape const& obstacle, Ogre::Vector3 const& offset) const;
+    /// Smallest distance >= 0 along `direction` (normalised) at which the boxes of the actor and all obstacles are apart.
+    float          GetBoxClearance(Ogre::Vector3 const& direction) const;
+
+    Shape               m_shape;
+    std::vector<Shape>  m_obstacles;
+    float               m_max_distance = 0.f;
+    BitMask_t           m_flags = 0;
+};
+
+/// @} // addtogroup Collisions
+/// @} // addtogroup Physics
+
+} // namespace RoR
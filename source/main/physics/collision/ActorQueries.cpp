@@ -0,0 +1,398 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ActorQueries.h"
+
+#include "Actor.h"
+#include "GfxActor.h"
+#include "Utils.h"
+
+#include <OgreMath.h>
+#include <OgreSphere.h>
+#include <algorithm>
+#include <limits>
+
+using namespace Ogre;
+using namespace RoR;
+
+/// Slab test; the entry/exit parameters are clamped to [0, max_distance].
+static bool IntersectsBox(Ray const& ray, Vector3 const& box_min, Vector3 const& box_max, float max_distance, float& out_enter, float& out_exit)
+{
+    out_enter = 0.f;
+    out_exit = max_distance;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const float o = ray.getOrigin()[axis];
+        const float d = ray.getDirection()[axis];
+        if (d == 0.f)
+        {
+            if (o < box_min[axis] || o > box_max[axis])
+                return false;
+            continue;
+        }
+        float t0 = (box_min[axis] - o) / d;
+        float t1 = (box_max[axis] - o) / d;
+        if (t0 > t1)
+            std::swap(t0, t1);
+        out_enter = std::max(out_enter, t0);
+        out_exit = std::min(out_exit, t1);
+        if (out_enter > out_exit)
+            return false;
+    }
+    return true;
+}
+
+/// @author Christer Ericson, Real-Time Collision Detection, 5.1.5
+static Vector3 GetClosestPointOnTriangle(Vector3 const& p, Vector3 const& a, Vector3 const& b, Vector3 const& c)
+{
+    const Vector3 ab = b - a;
+    const Vector3 ac = c - a;
+    const Vector3 ap = p - a;
+    const float d1 = ab.dotProduct(ap);
+    const float d2 = ac.dotProduct(ap);
+    if (d1 <= 0.f && d2 <= 0.f)
+        return a;
+
+    const Vector3 bp = p - b;
+    const float d3 = ab.dotProduct(bp);
+    const float d4 = ac.dotProduct(bp);
+    if (d3 >= 0.f && d4 <= d3)
+        return b;
+
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+        return a + ab * (d1 / (d1 - d3));
+
+    const Vector3 cp = p - c;
+    const float d5 = ab.dotProduct(cp);
+    const float d6 = ac.dotProduct(cp);
+    if (d6 >= 0.f && d5 <= d6)
+        return c;
+
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+        return a + ac * (d2 / (d2 - d6));
+
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    const float denom = 1.f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+void ActorQueries::Refit(std::vector<ActorPtr> const& actors)
+{
+    EraseIf(m_entries, [&actors](ActorEntry& entry)
+        { return std::find(actors.begin(), actors.end(), entry.ae_actor) == actors.end(); });
+
+    for (ActorPtr const& actor : actors)
+    {
+        auto itor = std::find_if(m_entries.begin(), m_entries.end(),
+            [&actor](ActorEntry& entry) { return entry.ae_actor == actor; });
+
+        if (itor == m_entries.end())
+        {
+            m_entries.push_back(ActorEntry());
+            m_entries.back().ae_actor = actor;
+            this->BuildEntry(m_entries.back());
+        }
+        else if (actor->GetGfxActor()->IsActorLive() || itor->ae_state != actor->ar_state)
+        {
+            // Sleeping actors don't move; their simulation buffers aren't updated either.
+            this->RefitEntry(*itor);
+        }
+    }
+}
+
+void ActorQueries::RemoveActor(ActorPtr const& actor)
+{
+    EraseIf(m_entries, [&actor](ActorEntry& entry) { return entry.ae_actor == actor; });
+}
+
+void ActorQueries::BuildEntry(ActorEntry& entry)
+{
+    const ActorPtr& actor = entry.ae_actor;
+
+    entry.ae_node_pos.resize(actor->ar_num_nodes);
+    entry.ae_node_grabbable.resize(actor->ar_num_nodes);
+    for (int i = 0; i < actor->ar_num_nodes; i++)
+    {
+        entry.ae_node_grabbable[i] = !actor->ar_nodes[i].nd_no_mouse_grab;
+    }
+
+    entry.ae_cab_nodes.resize(actor->ar_num_collcabs * 3);
+    for (int i = 0; i < actor->ar_num_collcabs; i++)
+    {
+        const int tmpv = actor->ar_collcabs[i] * 3;
+        for (int k = 0; k < 3; k++)
+        {
+            entry.ae_cab_nodes[i * 3 + k] = static_cast<NodeNum_t>(actor->ar_cabs[tmpv + k]);
+        }
+    }
+
+    // The hierarchies are split by the spawn pose and only refitted afterwards;
+    // actors keep their shape well enough for the boxes to stay tight.
+    const NodeSB* simbuf_nodes = actor->GetGfxActor()->GetSimNodeBuffer();
+    std::vector<Vector3> centroids(actor->ar_num_nodes);
+    for (int i = 0; i < actor->ar_num_nodes; i++)
+    {
+        centroids[i] = simbuf_nodes[i].AbsPosition;
+    }
+    entry.ae_node_bvh.Build(centroids);
+
+    centroids.resize(actor->ar_num_collcabs);
+    for (int i = 0; i < actor->ar_num_collcabs; i++)
+    {
+        centroids[i] = (simbuf_nodes[entry.ae_cab_nodes[i * 3 + 0]].AbsPosition +
+                        simbuf_nodes[entry.ae_cab_nodes[i * 3 + 1]].AbsPosition +
+                        simbuf_nodes[entry.ae_cab_nodes[i * 3 + 2]].AbsPosition) / 3.f;
+    }
+    entry.ae_cab_bvh.Build(centroids);
+
+    this->RefitEntry(entry);
+}
+
+void ActorQueries::RefitEntry(ActorEntry& entry)
+{
+    entry.ae_state = entry.ae_actor->ar_state;
+
+    const NodeSB* simbuf_nodes = entry.ae_actor->GetGfxActor()->GetSimNodeBuffer();
+    for (size_t i = 0; i < entry.ae_node_pos.size(); i++)
+    {
+        entry.ae_node_pos[i] = simbuf_nodes[i].AbsPosition;
+    }
+
+    entry.ae_node_bvh.Refit([&entry](int node, Vector3& box_min, Vector3& box_max)
+        {
+            box_min.makeFloor(entry.ae_node_pos[node]);
+            box_max.makeCeil(entry.ae_node_pos[node]);
+        });
+
+    entry.ae_cab_bvh.Refit([&entry](int collcab, Vector3& box_min, Vector3& box_max)
+        {
+            for (int v = 0; v < 3; v++)
+            {
+                box_min.makeFloor(entry.ae_node_pos[entry.ae_cab_nodes[collcab * 3 + v]]);
+                box_max.makeCeil(entry.ae_node_pos[entry.ae_cab_nodes[collcab * 3 + v]]);
+            }
+        });
+}
+
+bool ActorQueries::IsEntryEligible(ActorEntry const& entry, BitMask_t flags, ActorPtr const& only_actor) const
+{
+    if (only_actor != nullptr && entry.ae_actor != only_actor)
+        return false;
+    if (entry.ae_state == ActorState::DISPOSED)
+        return false;
+    if (BITMASK_IS_1(flags, QUERY_SIMULATED_ONLY) && entry.ae_state != ActorState::LOCAL_SIMULATED)
+        return false;
+    return true;
+}
+
+bool ActorQueries::FindClosestNode(Vector3 const& point, float max_distance, ActorNodeQueryResult& out_result, BitMask_t flags, ActorPtr const& only_actor) const
+{
+    float closest_dist = max_distance;
+    bool found = false;
+
+    for (ActorEntry const& entry : m_entries)
+    {
+        if (!this->IsEntryEligible(entry, flags, only_actor))
+            continue;
+
+        entry.ae_node_bvh.FindNearest(closest_dist,
+            [&point](BvhNode const& bvh_node) { return Bvh::GetDistToBox(point, bvh_node.bvh_min, bvh_node.bvh_max); },
+            [&](int i)
+            {
+                if (BITMASK_IS_1(flags, QUERY_GRABBABLE_NODES) && !entry.ae_node_grabbable[i])
+                    return;
+
+                const float dist = entry.ae_node_pos[i].distance(point);
+                if (dist < closest_dist)
+                {
+                    closest_dist = dist;
+                    found = true;
+                    out_result.actor = entry.ae_actor;
+                    out_result.node = static_cast<NodeNum_t>(i);
+                    out_result.position = entry.ae_node_pos[i];
+                    out_result.distance = dist;
+                }
+            });
+    }
+
+    return found;
+}
+
+bool ActorQueries::FindClosestHullPoint(Vector3 const& point, float max_distance, ActorCabQueryResult& out_result, BitMask_t flags, ActorPtr const& only_actor) const
+{
+    float closest_dist = max_distance;
+    bool found = false;
+
+    for (ActorEntry const& entry : m_entries)
+    {
+        if (!this->IsEntryEligible(entry, flags, only_actor))
+            continue;
+
+        entry.ae_cab_bvh.FindNearest(closest_dist,
+            [&point](BvhNode const& bvh_node) { return Bvh::GetDistToBox(point, bvh_node.bvh_min, bvh_node.bvh_max); },
+            [&](int collcab)
+            {
+                const Vector3 closest = GetClosestPointOnTriangle(point,
+                    entry.ae_node_pos[entry.ae_cab_nodes[collcab * 3 + 0]],
+                    entry.ae_node_pos[entry.ae_cab_nodes[collcab * 3 + 1]],
+                    entry.ae_node_pos[entry.ae_cab_nodes[collcab * 3 + 2]]);
+                const float dist = closest.distance(point);
+                if (dist < closest_dist)
+                {
+                    closest_dist = dist;
+                    found = true;
+                    out_result.actor = entry.ae_actor;
+                    out_result.collcab = collcab;
+                    out_result.position = closest;
+                    out_result.distance = dist;
+                }
+            });
+    }
+
+    return found;
+}
+
+/// Where the ray enters the box; a lower bound for anything within
+static float GetRayDistToBox(Ray const& ray, Vector3 const& box_min, Vector3 const& box_max)
+{
+    float t_enter, t_exit;
+    return IntersectsBox(ray, box_min, box_max, std::numeric_limits<float>::max(), t_enter, t_exit)
+        ? t_enter : std::numeric_limits<float>::max();
+}
+
+bool ActorQueries::FindNodeOnRay(Ray const& ray, float node_radius, float max_distance, ActorNodeQueryResult& out_result, BitMask_t flags) const
+{
+    const Vector3 margin(node_radius);
+    float closest_dist = max_distance;
+    bool found = false;
+
+    for (ActorEntry const& entry : m_entries)
+    {
+        if (!this->IsEntryEligible(entry, flags, nullptr))
+            continue;
+
+        entry.ae_node_bvh.FindNearest(closest_dist,
+            [&ray, &margin](BvhNode const& bvh_node) { return GetRayDistToBox(ray, bvh_node.bvh_min - margin, bvh_node.bvh_max + margin); },
+            [&](int i)
+            {
+                if (BITMASK_IS_1(flags, QUERY_GRABBABLE_NODES) && !entry.ae_node_grabbable[i])
+                    return;
+
+                auto result = Math::intersects(ray, Sphere(entry.ae_node_pos[i], node_radius));
+                if (result.first && result.second < closest_dist)
+                {
+                    closest_dist = result.second;
+                    found = true;
+                    out_result.actor = entry.ae_actor;
+                    out_result.node = static_cast<NodeNum_t>(i);
+                    out_result.position = entry.ae_node_pos[i];
+                    out_result.distance = result.second;
+                }
+            });
+    }
+
+    return found;
+}
+
+bool ActorQueries::CastRayNearest(Ray const& ray, float max_distance, ActorCabQueryResult& out_result, BitMask_t flags) const
+{
+    float closest_dist = max_distance;
+    bool found = false;
+
+    for (ActorEntry const& entry : m_entries)
+    {
+        if (!this->IsEntryEligible(entry, flags, nullptr))
+            continue;
+
+        entry.ae_cab_bvh.FindNearest(closest_dist,
+            [&ray](BvhNode const& bvh_node) { return GetRayDistToBox(ray, bvh_node.bvh_min, bvh_node.bvh_max); },
+            [&](int collcab)
+            {
+                auto result = Math::intersects(ray,
+                    entry.ae_node_pos[entry.ae_cab_nodes[collcab * 3 + 0]],
+                    entry.ae_node_pos[entry.ae_cab_nodes[collcab * 3 + 1]],
+                    entry.ae_node_pos[entry.ae_cab_nodes[collcab * 3 + 2]]);
+                if (result.first && result.second < closest_dist)
+                {
+                    closest_dist = result.second;
+                    found = true;
+                    out_result.actor = entry.ae_actor;
+                    out_result.collcab = collcab;
+                    out_result.position = ray.getPoint(result.second);
+                    out_result.distance = result.second;
+                }
+            });
+    }
+
+    return found;
+}
+
+bool ActorQueries::CastRayFarthest(Ray const& ray, float max_distance, ActorCabQueryResult& out_result, BitMask_t flags) const
+{
+    float farthest_dist = -1.f;
+
+    for (ActorEntry const& entry : m_entries)
+    {
+        if (!this->IsEntryEligible(entry, flags, nullptr))
+            continue;
+
+        entry.ae_cab_bvh.Traverse(
+            [&](BvhNode const& bvh_node)
+            {
+                // Missed, or everything within lies before the farthest hit so far
+                float t_enter, t_exit;
+                return IntersectsBox(ray, bvh_node.bvh_min, bvh_node.bvh_max, max_distance, t_enter, t_exit) && t_exit > farthest_dist;
+            },
+            [&](int collcab)
+            {
+                auto result = Math::intersects(ray,
+                    entry.ae_node_pos[entry.ae_cab_nodes[collcab * 3 + 0]],
+                    entry.ae_node_pos[entry.ae_cab_nodes[collcab * 3 + 1]],
+                    entry.ae_node_pos[entry.ae_cab_nodes[collcab * 3 + 2]]);
+                if (result.first && result.second < max_distance && result.second > farthest_dist)
+                {
+                    farthest_dist = result.second;
+                    out_result.actor = entry.ae_actor;
+                    out_result.collcab = collcab;
+                    out_result.position = ray.getPoint(result.second);
+                    out_result.distance = result.second;
+                }
+            });
+    }
+
+    return farthest_dist >= 0.f;
+}
+
+bool ActorQueries::AreActorsWithin(ActorPtr const& a, ActorPtr const& b, float distance) const
+{
+    auto itor_a = std::find_if(m_entries.begin(), m_entries.end(), [&a](ActorEntry const& entry) { return entry.ae_actor == a; });
+    auto itor_b = std::find_if(m_entries.begin(), m_entries.end(), [&b](ActorEntry const& entry) { return entry.ae_actor == b; });
+    if (itor_a == m_entries.end() || itor_b == m_entries.end())
+        return false;
+
+    std::vector<Vector3> const& pos_a = itor_a->ae_node_pos;
+    std::vector<Vector3> const& pos_b = itor_b->ae_node_pos;
+    return Bvh::AnyPairWithin(itor_a->ae_node_bvh, Vector3::ZERO, itor_b->ae_node_bvh, distance,
+        [&pos_a, &pos_b, distance](int node_a, int node_b) { return pos_a[node_a].distance(pos_b[node_b]) < distance; });
+}
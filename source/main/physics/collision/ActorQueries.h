@@ -0,0 +1,114 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Proximity and ray queries against actor nodes and collcabs, for gameplay code.
+
+#pragma once
+
+#include "Application.h"
+#include "Bvh.h"
+#include "SimData.h"
+
+#include <OgreRay.h>
+#include <OgreVector3.h>
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Physics
+/// @{
+
+/// @addtogroup Collisions
+/// @{
+
+struct ActorNodeQueryResult
+{
+    ActorPtr         actor;
+    NodeNum_t        node = NODENUM_INVALID;
+    Ogre::Vector3    position = Ogre::Vector3::ZERO;
+    float            distance = 0.f;    //!< From the query point, or along the ray (in units of ray direction)
+};
+
+struct ActorCabQueryResult
+{
+    ActorPtr         actor;
+    int              collcab = -1;      //!< Index to `Actor::ar_collcabs`
+    Ogre::Vector3    position = Ogre::Vector3::ZERO; //!< Closest point on the hull, or where the ray hit it
+    float            distance = 0.f;    //!< From the query point, or along the ray (in units of ray direction)
+};
+
+/// Snapshot of actor nodes and collcabs with a bounding volume hierarchy per actor, owned by `ActorManager`.
+/// The hierarchies are built once per actor (at its spawn pose) and refitted each time the
+/// simulation buffers (`GfxActor::GetSimNodeBuffer()`) are refilled, so queries never touch live physics data
+/// and can run while the simulation thread steps. Positions are as of the last `Refit()`; while the
+/// simulation is paused the buffers aren't refilled, so the queries see the paused state, same as the visuals.
+class ActorQueries
+{
+public:
+    // Query flags
+    static const BitMask_t QUERY_SIMULATED_ONLY  = BITMASK(1); //!< Skip actors which are not `ActorState::LOCAL_SIMULATED`
+    static const BitMask_t QUERY_GRABBABLE_NODES = BITMASK(2); //!< Skip nodes with `node_t::nd_no_mouse_grab`
+
+    /// Adds new actors, drops deleted ones and refits the live ones; main thread only,
+    /// once the simulation buffers are filled (`GfxScene::BufferSimulationData()`).
+    void           Refit(std::vector<ActorPtr> const& actors);
+    void           RemoveActor(ActorPtr const& actor);
+    void           Clear() { m_entries.clear(); }
+
+    /// @name Queries
+    /// Read only the snapshot; must not run concurrently with `Refit()`/`RemoveActor()`.
+    /// @{
+    /// @param only_actor If set, other actors are skipped.
+    bool           FindClosestNode(Ogre::Vector3 const& point, float max_distance, ActorNodeQueryResult& out_result, BitMask_t flags = 0, ActorPtr const& only_actor = nullptr) const;
+    /// Closest point on any collcab triangle.
+    bool           FindClosestHullPoint(Ogre::Vector3 const& point, float max_distance, ActorCabQueryResult& out_result, BitMask_t flags = 0, ActorPtr const& only_actor = nullptr) const;
+    /// Nearest node whose sphere of `node_radius` the ray touches.
+    bool           FindNodeOnRay(Ogre::Ray const& ray, float node_radius, float max_distance, ActorNodeQueryResult& out_result, BitMask_t flags = 0) const;
+    /// Nearest collcab hit along the ray.
+    bool           CastRayNearest(Ogre::Ray const& ray, float max_distance, ActorCabQueryResult& out_result, BitMask_t flags = 0) const;
+    /// Farthest collcab hit along the ray (the highest surface above a point, for instance).
+    bool           CastRayFarthest(Ogre::Ray const& ray, float max_distance, ActorCabQueryResult& out_result, BitMask_t flags = 0) const;
+    /// Is any node of `a` within `distance` of any node of `b`?
+    bool           AreActorsWithin(ActorPtr const& a, ActorPtr const& b, float distance) const;
+    /// @}
+
+private:
+    struct ActorEntry
+    {
+        ActorPtr                    ae_actor;
+        ActorState                  ae_state = ActorState::LOCAL_SIMULATED; //!< As of the last refit
+        std::vector<Ogre::Vector3>  ae_node_pos;
+        std::vector<bool>           ae_node_grabbable;
+        std::vector<NodeNum_t>      ae_cab_nodes;   //!< 3 per collcab
+        Bvh                         ae_node_bvh;
+        Bvh                         ae_cab_bvh;
+    };
+
+    void           BuildEntry(ActorEntry& entry);
+    void           RefitEntry(ActorEntry& entry);
+    bool           IsEntryEligible(ActorEntry const& entry, BitMask_t flags, ActorPtr const& only_actor) const;
+
+    std::vector<ActorEntry>  m_entries;
+};
+
+/// @} // addtogroup Collisions
+/// @} // addtogroup Physics
+
+} // namespace RoR
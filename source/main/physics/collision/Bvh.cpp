@@ -0,0 +1,99 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Bvh.h"
+
+#include <algorithm>
+
+using namespace Ogre;
+using namespace RoR;
+
+void Bvh::Build(std::vector<Vector3> const& centroids)
+{
+    bvh_nodes.clear();
+    bvh_items.resize(centroids.size());
+    for (size_t i = 0; i < centroids.size(); i++)
+    {
+        bvh_items[i] = static_cast<int>(i);
+    }
+
+    if (centroids.empty())
+        return;
+    bvh_nodes.reserve(2 * (centroids.size() / LEAF_SIZE + 1));
+    bvh_nodes.push_back(BvhNode());
+    this->BuildRecursive(centroids, 0, 0, static_cast<int>(centroids.size()));
+}
+
+void Bvh::BuildRecursive(std::vector<Vector3> const& centroids, int self, int item_begin, int item_count)
+{
+    bvh_nodes[self].bvh_min = Vector3::ZERO;
+    bvh_nodes[self].bvh_max = Vector3::ZERO;
+    bvh_nodes[self].bvh_item_begin = item_begin;
+    bvh_nodes[self].bvh_item_count = item_count;
+    bvh_nodes[self].bvh_child = -1;
+
+    if (item_count > LEAF_SIZE)
+    {
+        // Median split along the longest axis of the centroids
+        auto begin = bvh_items.begin() + item_begin;
+        auto end = begin + item_count;
+        Vector3 lo = centroids[*begin];
+        Vector3 hi = centroids[*begin];
+        for (auto itor = begin; itor != end; ++itor)
+        {
+            lo.makeFloor(centroids[*itor]);
+            hi.makeCeil(centroids[*itor]);
+        }
+        const Vector3 extent = hi - lo;
+        const int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : ((extent.y > extent.z) ? 1 : 2);
+        const int left_count = item_count / 2;
+        std::nth_element(begin, begin + left_count, end,
+            [&centroids, axis](int a, int b) { return centroids[a][axis] < centroids[b][axis]; });
+
+        // Both children are allocated next to each other, after the parent.
+        const int child = static_cast<int>(bvh_nodes.size());
+        bvh_nodes.push_back(BvhNode());
+        bvh_nodes.push_back(BvhNode());
+        bvh_nodes[self].bvh_child = child;
+
+        this->BuildRecursive(centroids, child, item_begin, left_count);
+        this->BuildRecursive(centroids, child + 1, item_begin + left_count, item_count - left_count);
+    }
+}
+
+void Bvh::Clear()
+{
+    bvh_nodes.clear();
+    bvh_items.clear();
+}
+
+float Bvh::GetDistToBox(Vector3 const& point, Vector3 const& box_min, Vector3 const& box_max)
+{
+    Vector3 gap = box_min - point;
+    gap.makeCeil(point - box_max);
+    gap.makeCeil(Vector3::ZERO);
+    return gap.length();
+}
+
+bool Bvh::AreBoxesTouching(Vector3 const& a_min, Vector3 const& a_max, Vector3 const& b_min, Vector3 const& b_max)
+{
+    return a_min.x <= b_max.x && a_max.x >= b_min.x &&
+           a_min.y <= b_max.y && a_max.y >= b_min.y &&
+           a_min.z <= b_max.z && a_max.z >= b_min.z;
+}
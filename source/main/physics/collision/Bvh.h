@@ -0,0 +1,243 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Bounding volume hierarchy shared by `ActorQueries`, `ActorPlacement` and the slide node rails (`RailGroup`).
+
+#pragma once
+
+#include <OgreVector3.h>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Physics
+/// @{
+
+/// @addtogroup Collisions
+/// @{
+
+struct BvhNode
+{
+    Ogre::Vector3  bvh_min;
+    Ogre::Vector3  bvh_max;
+    int            bvh_item_begin;   //!< Range of `Bvh::bvh_items`
+    int            bvh_item_count;
+    int            bvh_child;        //!< Index of left child, right child is `bvh_child+1`; -1 for leaf
+};
+
+/// Binary tree of boxes over items known by index (nodes, collcabs, beams...).
+/// The tree is split once, by the item centroids; when the items move, `Refit()` recomputes the boxes
+/// and keeps the tree. Children always follow their parent, so a reverse sweep over the nodes is bottom-up.
+/// The traversals use a fixed stack and don't allocate.
+class Bvh
+{
+public:
+    static const int LEAF_SIZE = 4;
+    static const int STACK_SIZE = 64;
+
+    /// Median split along the longest axis of the centroids, down to `LEAF_SIZE` items; the boxes are left for `Refit()`.
+    void           Build(std::vector<Ogre::Vector3> const& centroids);
+    void           Clear();
+    bool           IsEmpty() const { return bvh_nodes.empty(); }
+
+    /// Recomputes all boxes bottom-up; `grow_box(item, box_min, box_max)` must extend the box by the item.
+    template <typename GROW_BOX>
+    void           Refit(GROW_BOX grow_box);
+
+    /// Depth-first descent into the boxes for which `enter_box(bvh_node)` is true; `visit_item(item)` for the items of the leaves reached.
+    template <typename ENTER_BOX, typename VISIT_ITEM>
+    void           Traverse(ENTER_BOX enter_box, VISIT_ITEM visit_item) const;
+
+    /// Branch and bound: `box_dist(bvh_node)` is a lower bound for the items within. Boxes farther than `bound`
+    /// are skipped, the nearer child goes first; `visit_item(item)` lowers `bound` whenever it finds a closer item.
+    template <typename BOX_DIST, typename VISIT_ITEM>
+    void           FindNearest(float& bound, BOX_DIST box_dist, VISIT_ITEM visit_item) const;
+
+    /// Simultaneous descent of both hierarchies, `a` moved by `offset_a`, over pairs of boxes closer than `margin`.
+    /// @return True as soon as `test(item_a, item_b)` does.
+    template <typename TEST>
+    static bool    AnyPairWithin(Bvh const& a, Ogre::Vector3 const& offset_a, Bvh const& b, float margin, TEST test);
+
+    /// Distance from point to the box, zero if inside; a lower bound for any item within.
+    static float   GetDistToBox(Ogre::Vector3 const& point, Ogre::Vector3 const& box_min, Ogre::Vector3 const& box_max);
+    /// Touching counts, like `AxisAlignedBox::intersects()`
+    static bool    AreBoxesTouching(Ogre::Vector3 const& a_min, Ogre::Vector3 const& a_max, Ogre::Vector3 const& b_min, Ogre::Vector3 const& b_max);
+
+    std::vector<BvhNode> bvh_nodes;  //!< Root at index 0; empty if there are no items.
+    std::vector<int>     bvh_items;  //!< Item indices, in leaf order.
+
+private:
+    void           BuildRecursive(std::vector<Ogre::Vector3> const& centroids, int self, int item_begin, int item_count);
+};
+
+template <typename GROW_BOX>
+void Bvh::Refit(GROW_BOX grow_box)
+{
+    for (int i = static_cast<int>(bvh_nodes.size()) - 1; i >= 0; --i)
+    {
+        BvhNode& bvh_node = bvh_nodes[i];
+        if (bvh_node.bvh_child < 0)
+        {
+            bvh_node.bvh_min = Ogre::Vector3(std::numeric_limits<float>::max());
+            bvh_node.bvh_max = Ogre::Vector3(-std::numeric_limits<float>::max());
+            for (int k = bvh_node.bvh_item_begin; k < bvh_node.bvh_item_begin + bvh_node.bvh_item_count; ++k)
+            {
+                grow_box(bvh_items[k], bvh_node.bvh_min, bvh_node.bvh_max);
+            }
+        }
+        else
+        {
+            const BvhNode& left = bvh_nodes[bvh_node.bvh_child];
+            const BvhNode& right = bvh_nodes[bvh_node.bvh_child + 1];
+            bvh_node.bvh_min = left.bvh_min;
+            bvh_node.bvh_min.makeFloor(right.bvh_min);
+            bvh_node.bvh_max = left.bvh_max;
+            bvh_node.bvh_max.makeCeil(right.bvh_max);
+        }
+    }
+}
+
+template <typename ENTER_BOX, typename VISIT_ITEM>
+void Bvh::Traverse(ENTER_BOX enter_box, VISIT_ITEM visit_item) const
+{
+    if (bvh_nodes.empty())
+        return;
+
+    int stack[STACK_SIZE];
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0)
+    {
+        const BvhNode& bvh_node = bvh_nodes[stack[--stack_size]];
+        if (!enter_box(bvh_node))
+            continue;
+
+        if (bvh_node.bvh_child < 0)
+        {
+            for (int k = bvh_node.bvh_item_begin; k < bvh_node.bvh_item_begin + bvh_node.bvh_item_count; ++k)
+            {
+                visit_item(bvh_items[k]);
+            }
+        }
+        else
+        {
+            stack[stack_size++] = bvh_node.bvh_child + 1;
+            stack[stack_size++] = bvh_node.bvh_child;
+        }
+    }
+}
+
+template <typename BOX_DIST, typename VISIT_ITEM>
+void Bvh::FindNearest(float& bound, BOX_DIST box_dist, VISIT_ITEM visit_item) const
+{
+    if (bvh_nodes.empty())
+        return;
+
+    // Each entry carries the distance of its box, so it's computed once
+    std::pair<int, float> stack[STACK_SIZE];
+    int stack_size = 0;
+    stack[stack_size++] = std::make_pair(0, box_dist(bvh_nodes[0]));
+    while (stack_size > 0)
+    {
+        const std::pair<int, float> entry = stack[--stack_size];
+        if (entry.second > bound)
+            continue;
+
+        const BvhNode& bvh_node = bvh_nodes[entry.first];
+        if (bvh_node.bvh_child < 0)
+        {
+            for (int k = bvh_node.bvh_item_begin; k < bvh_node.bvh_item_begin + bvh_node.bvh_item_count; ++k)
+            {
+                visit_item(bvh_items[k]);
+            }
+        }
+        else
+        {
+            const float left_dist = box_dist(bvh_nodes[bvh_node.bvh_child]);
+            const float right_dist = box_dist(bvh_nodes[bvh_node.bvh_child + 1]);
+            // Push the farther child first so the nearer one is popped next
+            if (left_dist < right_dist)
+            {
+                stack[stack_size++] = std::make_pair(bvh_node.bvh_child + 1, right_dist);
+                stack[stack_size++] = std::make_pair(bvh_node.bvh_child, left_dist);
+            }
+            else
+            {
+                stack[stack_size++] = std::make_pair(bvh_node.bvh_child, left_dist);
+                stack[stack_size++] = std::make_pair(bvh_node.bvh_child + 1, right_dist);
+            }
+        }
+    }
+}
+
+template <typename TEST>
+bool Bvh::AnyPairWithin(Bvh const& a, Ogre::Vector3 const& offset_a, Bvh const& b, float margin, TEST test)
+{
+    if (a.bvh_nodes.empty() || b.bvh_nodes.empty())
+        return false;
+
+    const Ogre::Vector3 grow_min = offset_a - Ogre::Vector3(margin);
+    const Ogre::Vector3 grow_max = offset_a + Ogre::Vector3(margin);
+
+    std::pair<int, int> stack[STACK_SIZE * 2];
+    int stack_size = 0;
+    stack[stack_size++] = std::make_pair(0, 0);
+    while (stack_size > 0)
+    {
+        const std::pair<int, int> pair = stack[--stack_size];
+        const BvhNode& node_a = a.bvh_nodes[pair.first];
+        const BvhNode& node_b = b.bvh_nodes[pair.second];
+
+        if (!AreBoxesTouching(node_a.bvh_min + grow_min, node_a.bvh_max + grow_max, node_b.bvh_min, node_b.bvh_max))
+            continue;
+
+        if (node_a.bvh_child < 0 && node_b.bvh_child < 0)
+        {
+            for (int i = node_a.bvh_item_begin; i < node_a.bvh_item_begin + node_a.bvh_item_count; ++i)
+            {
+                for (int k = node_b.bvh_item_begin; k < node_b.bvh_item_begin + node_b.bvh_item_count; ++k)
+                {
+                    if (test(a.bvh_items[i], b.bvh_items[k]))
+                        return true;
+                }
+            }
+        }
+        else if (node_b.bvh_child < 0 || (node_a.bvh_child >= 0 && node_a.bvh_item_count >= node_b.bvh_item_count))
+        {
+            // Descend the bigger one
+            stack[stack_size++] = std::make_pair(node_a.bvh_child, pair.second);
+            stack[stack_size++] = std::make_pair(node_a.bvh_child + 1, pair.second);
+        }
+        else
+        {
+            stack[stack_size++] = std::make_pair(pair.first, node_b.bvh_child);
+            stack[stack_size++] = std::make_pair(pair.first, node_b.bvh_child + 1);
+        }
+    }
+
+    return false;
+}
+
+/// @} // addtogroup Collisions
+/// @} // addtogroup Physics
+
+} // namespace RoR
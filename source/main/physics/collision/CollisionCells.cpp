@@ -0,0 +1,380 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2005-2012 Pierre-Michel Ricordel
+    Copyright 2007-2012 Thomas Fischer
+    Copyright 2013-2022 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CollisionCells.h"
+
+#include "Application.h"
+#include "GridRayWalk.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace Ogre;
+using namespace RoR;
+
+// some gcc fixes
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX
+#pragma GCC diagnostic ignored "-Wfloat-equal"
+#endif //OGRE_PLATFORM_LINUX
+
+
+//hash function SBOX
+//from http://home.comcast.net/~bretm/hash/10.html
+unsigned int sbox[] =
+{
+    0xF53E1837, 0x5F14C86B, 0x9EE3964C, 0xFA796D53,
+    0x32223FC3, 0x4D82BC98, 0xA0C7FA62, 0x63E2C982,
+    0x24994A5B, 0x1ECE7BEE, 0x292B38EF, 0xD5CD4E56,
+    0x514F4303, 0x7BE12B83, 0x7192F195, 0x82DC7300,
+    0x084380B4, 0x480B55D3, 0x5F430471, 0x13F75991,
+    0x3F9CF22C, 0x2FE0907A, 0xFD8E1E69, 0x7B1D5DE8,
+    0xD575A85C, 0xAD01C50A, 0x7EE00737, 0x3CE981E8,
+    0x0E447EFA, 0x23089DD6, 0xB59F149F, 0x13600EC7,
+    0xE802C8E6, 0x670921E4, 0x7207EFF0, 0xE74761B0,
+    0x69035234, 0xBFA40F19, 0xF63651A0, 0x29E64C26,
+    0x1F98CCA7, 0xD957007E, 0xE71DDC75, 0x3E729595,
+    0x7580B7CC, 0xD7FAF60B, 0x92484323, 0xA44113EB,
+    0xE4CBDE08, 0x346827C9, 0x3CF32AFA, 0x0B29BCF1,
+    0x6E29F7DF, 0xB01E71CB, 0x3BFBC0D1, 0x62EDC5B8,
+    0xB7DE789A, 0xA4748EC9, 0xE17A4C4F, 0x67E5BD03,
+    0xF3B33D1A, 0x97D8D3E9, 0x09121BC0, 0x347B2D2C,
+    0x79A1913C, 0x504172DE, 0x7F1F8483, 0x13AC3CF6,
+    0x7A2094DB, 0xC778FA12, 0xADF7469F, 0x21786B7B,
+    0x71A445D0, 0xA8896C1B, 0x656F62FB, 0x83A059B3,
+    0x972DFE6E, 0x4122000C, 0x97D9DA19, 0x17D5947B,
+    0xB1AFFD0C, 0x6EF83B97, 0xAF7F780B, 0x4613138A,
+    0x7C3E73A6, 0xCF15E03D, 0x41576322, 0x672DF292,
+    0xB658588D, 0x33EBEFA9, 0x938CBF06, 0x06B67381,
+    0x07F192C6, 0x2BDA5855, 0x348EE0E8, 0x19DBB6E3,
+    0x3222184B, 0xB69D5DBA, 0x7E760B88, 0xAF4D8154,
+    0x007A51AD, 0x35112500, 0xC9CD2D7D, 0x4F4FB761,
+    0x694772E3, 0x694C8351, 0x4A7E3AF5, 0x67D65CE1,
+    0x9287DE92, 0x2518DB3C, 0x8CB4EC06, 0xD154D38F,
+    0xE19A26BB, 0x295EE439, 0xC50A1104, 0x2153C6A7,
+    0x82366656, 0x0713BC2F, 0x6462215A, 0x21D9BFCE,
+    0xBA8EACE6, 0xAE2DF4C1, 0x2A8D5E80, 0x3F7E52D1,
+    0x29359399, 0xFEA1D19C, 0x18879313, 0x455AFA81,
+    0xFADFE838, 0x62609838, 0xD1028839, 0x0736E92F,
+    0x3BCA22A3, 0x1485B08A, 0x2DA7900B, 0x852C156D,
+    0xE8F24803, 0x00078472, 0x13F0D332, 0x2ACFD0CF,
+    0x5F747F5C, 0x87BB1E2F, 0xA7EFCB63, 0x23F432F0,
+    0xE6CE7C5C, 0x1F954EF6, 0xB609C91B, 0x3B4571BF,
+    0xEED17DC0, 0xE556CDA0, 0xA7846A8D, 0xFF105F94,
+    0x52B7CCDE, 0x0E33E801, 0x664455EA, 0xF2C70414,
+    0x73E7B486, 0x8F830661, 0x8B59E826, 0xBB8AEDCA,
+    0xF3D70AB9, 0xD739F2B9, 0x4A04C34A, 0x88D0F089,
+    0xE02191A2, 0xD89D9C78, 0x192C2749, 0xFC43A78F,
+    0x0AAC88CB, 0x9438D42D, 0x9E280F7A, 0x36063802,
+    0x38E8D018, 0x1C42A9CB, 0x92AAFF6C, 0xA24820C5,
+    0x007F077F, 0xCE5BC543, 0x69668D58, 0x10D6FF74,
+    0xBE00F621, 0x21300BBE, 0x2E9E8F46, 0x5ACEA629,
+    0xFA1F86C7, 0x52F206B8, 0x3EDF1A75, 0x6DA8D843,
+    0xCF719928, 0x73E3891F, 0xB4B95DD6, 0xB2A42D27,
+    0xEDA20BBF, 0x1A58DBDF, 0xA449AD03, 0x6DDEF22B,
+    0x900531E6, 0x3D3BFF35, 0x5B24ABA2, 0x472B3E4C,
+    0x387F2D75, 0x4D8DBA36, 0x71CB5641, 0xE3473F3F,
+    0xF6CD4B7F, 0xBF7D1428, 0x344B64D0, 0xC5CDFCB6,
+    0xFE2E0182, 0x2C37A673, 0xDE4EB7A3, 0x63FDC933,
+    0x01DC4063, 0x611F3571, 0xD167BFAF, 0x4496596F,
+    0x3DEE0689, 0xD8704910, 0x7052A114, 0x068C9EC5,
+    0x75D0E766, 0x4D54CC20, 0xB44ECDE2, 0x4ABC653E,
+    0x2C550A21, 0x1A52C0DB, 0xCFED03D0, 0x119BAFE2,
+    0x876A6133, 0xBC232088, 0x435BA1B2, 0xAE99BBFA,
+    0xBB4F08E4, 0xA62B5F49, 0x1DA4B695, 0x336B84DE,
+    0xDC813D31, 0x00C134FB, 0x397A98E6, 0x151F0E64,
+    0xD9EB3E69, 0xD3C7DF60, 0xD2F2C336, 0x2DDD067B,
+    0xBD122835, 0xB0B3BD3A, 0xB0D54E46, 0x8641F1E4,
+    0xA0B38F96, 0x51D39199, 0x37A6AD75, 0xDF84EE41,
+    0x3C034CBA, 0xACDA62FC, 0x11923B8B, 0x45EF170A,
+};
+
+CollisionCells::CollisionCells(CollisionTriVec const& tris, CollisionBoxVec const& boxes)
+    : m_collision_tris(tris)
+    , m_collision_boxes(boxes)
+    , hashmask(0)
+{
+    for (int i=0; i < HASH_POWER; i++)
+    {
+        hashmask = hashmask << 1;
+        hashmask++;
+    }
+
+    hashtable_height.fill(std::numeric_limits<float>::min());
+}
+
+unsigned int CollisionCells::hashfunc(unsigned int cellid) const
+{
+    unsigned int hash = 0;
+    for (int i=0; i < 4; i++)
+    {
+        hash ^= sbox[((unsigned char*)&cellid)[i]];
+        hash *= 3;
+    }
+    return hash&hashmask;
+}
+
+void CollisionCells::hash_add(int cell_x, int cell_z, int value, float h)
+{
+    unsigned int cell_id = (cell_x << 16) + cell_z;
+    unsigned int pos    = hashfunc(cell_id);
+
+    hashtable[pos].emplace_back(cell_id, value);
+    hashtable_height[pos] = std::max(hashtable_height[pos], h);
+}
+
+int CollisionCells::hash_find(int cell_x, int cell_z) const
+{
+    unsigned int cellid = (cell_x << 16) + cell_z;
+    unsigned int pos    = hashfunc(cellid);
+
+    return static_cast<int>(pos);
+}
+
+void CollisionCells::AddElement(int element_index, Vector3 const& lo, Vector3 const& hi)
+{
+    Vector3 ilo(lo / Ogre::Real(CELL_SIZE));
+    Vector3 ihi(hi / Ogre::Real(CELL_SIZE));
+
+    // clamp between 0 and MAXIMUM_CELL;
+    ilo.makeCeil(Ogre::Vector3(0.0f));
+    ilo.makeFloor(Ogre::Vector3(MAXIMUM_CELL));
+    ihi.makeCeil(Ogre::Vector3(0.0f));
+    ihi.makeFloor(Ogre::Vector3(MAXIMUM_CELL));
+
+    for (int i = ilo.x; i <= ihi.x; i++)
+    {
+        for (int j = ilo.z; j <= ihi.z; j++)
+        {
+            hash_add(i, j, element_index, hi.y);
+        }
+    }
+
+    m_bounds.merge(AxisAlignedBox(lo, hi));
+}
+
+void CollisionCells::CastRays(const Ogre::Ray* rays, collision_ray_hit_t* out_hits, size_t count, CastFirstFunc const& cast_first) const
+{
+    const size_t RAYS_PER_TASK = 32;
+
+    auto cast_range = [this, rays, out_hits, &cast_first](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            out_hits[i] = collision_ray_hit_t();
+            if (cast_first)
+                cast_first(rays[i], out_hits[i]);
+            this->CastRay(rays[i], out_hits[i]);
+        }
+    };
+
+    if (count <= RAYS_PER_TASK)
+    {
+        cast_range(0, count);
+        return;
+    }
+
+    std::vector<std::function<void()>> tasks;
+    for (size_t begin = 0; begin < count; begin += RAYS_PER_TASK)
+    {
+        const size_t end = std::min(begin + RAYS_PER_TASK, count);
+        tasks.push_back([&cast_range, begin, end]() { cast_range(begin, end); });
+    }
+    App::GetThreadPool()->Parallelize(tasks);
+}
+
+void CollisionCells::CastRay(const Ogre::Ray& ray, collision_ray_hit_t& inout_hit) const
+{
+    const Vector3 origin = ray.getOrigin();
+    const Vector3 dir = ray.getDirection();
+
+    if (!m_bounds.isFinite())
+        return; // No collision elements
+
+    // Clip the segment to the bounding box of all collision elements
+    float t_enter = 0.f;
+    float t_leave = inout_hit.distance;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const float lo = m_bounds.getMinimum()[axis];
+        const float hi = m_bounds.getMaximum()[axis];
+        if (dir[axis] == 0.f)
+        {
+            if (origin[axis] < lo || origin[axis] > hi)
+                return;
+            continue;
+        }
+        float t0 = (lo - origin[axis]) / dir[axis];
+        float t1 = (hi - origin[axis]) / dir[axis];
+        if (t0 > t1)
+            std::swap(t0, t1);
+        t_enter = std::max(t_enter, t0);
+        t_leave = std::min(t_leave, t1);
+    }
+    if (t_enter > t_leave)
+        return;
+
+    // 2D DDA through the cells (Amanatides & Woo). Elements span multiple cells, so a hit found in one cell
+    // may lie further along the ray - the traversal stops once the nearest hit lies within the current cell.
+    const float inv_cell_size = 1.f / (float)CELL_SIZE;
+    GridRayWalk walk(origin.x * inv_cell_size, origin.z * inv_cell_size, dir.x * inv_cell_size, dir.z * inv_cell_size, t_enter, t_leave);
+
+    // Elements are registered in cells clamped to [0, MAXIMUM_CELL], see `AddElement()`
+    int last_ref_x = -1;
+    int last_ref_z = -1;
+    while (true)
+    {
+        const float t_cell = walk.GetCellEnter();
+        const float t_exit = walk.GetCellExit();
+        const int ref_x = Math::Clamp((int)walk.GetCellU(), 0, (int)MAXIMUM_CELL);
+        const int ref_z = Math::Clamp((int)walk.GetCellV(), 0, (int)MAXIMUM_CELL);
+        const int hash = hash_find(ref_x, ref_z);
+
+        if ((ref_x != last_ref_x || ref_z != last_ref_z) &&
+            std::min(origin.y + dir.y * t_cell, origin.y + dir.y * t_exit) <= hashtable_height[hash])
+        {
+            last_ref_x = ref_x;
+            last_ref_z = ref_z;
+            const unsigned int cell_id = (ref_x << 16) + ref_z;
+
+            for (const hash_coll_element_t& element : hashtable[hash])
+            {
+                if (element.cell_id != cell_id)
+                {
+                    continue;
+                }
+                else if (element.IsCollisionTri())
+                {
+                    const int ctri_index = element.element_index - hash_coll_element_t::ELEMENT_TRI_BASE_INDEX;
+                    const collision_tri_t& ctri = m_collision_tris[ctri_index];
+
+                    if (!ctri.enabled)
+                        continue;
+
+                    auto result = Ogre::Math::intersects(ray, ctri.a, ctri.b, ctri.c);
+                    if (result.first && result.second < inout_hit.distance)
+                    {
+                        const Vector3 normal = ctri.reverse.GetColumn(2);
+                        inout_hit.hit = true;
+                        inout_hit.distance = result.second;
+                        inout_hit.normal = (normal.dotProduct(dir) > 0.f) ? -normal : normal;
+                        inout_hit.ctri_index = ctri_index;
+                        inout_hit.cbox_index = -1;
+                        inout_hit.gm = ctri.gm;
+                    }
+                }
+                else
+                {
+                    const collision_box_t& cbox = m_collision_boxes[element.element_index];
+
+                    if (!cbox.enabled || cbox.virt)
+                        continue;
+
+                    float distance;
+                    Vector3 normal;
+                    if (IntersectsBox(ray, cbox, distance, normal) && distance < inout_hit.distance)
+                    {
+                        inout_hit.hit = true;
+                        inout_hit.distance = distance;
+                        inout_hit.normal = normal;
+                        inout_hit.ctri_index = -1;
+                        inout_hit.cbox_index = element.element_index;
+                        inout_hit.gm = box_gm;
+                    }
+                }
+            }
+        }
+
+        if (inout_hit.hit && inout_hit.distance <= t_exit)
+            break; // Nothing in further cells can be closer
+        if (walk.IsLastCell())
+            break;
+
+        walk.Step();
+    }
+}
+
+bool CollisionCells::IntersectsBox(const Ogre::Ray& ray, const collision_box_t& cbox, float& out_distance, Ogre::Vector3& out_normal)
+{
+    // Transform the ray into box space, same as `getSurfaceHeightBelow()`
+    Vector3 pos = ray.getOrigin() - cbox.center;
+    Vector3 dir = ray.getDirection();
+    if (cbox.refined)
+    {
+        pos = cbox.unrot * pos;
+        dir = cbox.unrot * dir;
+    }
+    if (cbox.selfrotated)
+    {
+        pos = pos - cbox.selfcenter;
+        pos = cbox.selfunrot * pos;
+        pos = pos + cbox.selfcenter;
+        dir = cbox.selfunrot * dir;
+    }
+
+    // Slab test; remember the axis through which the ray enters
+    float t_enter = 0.f;
+    float t_leave = std::numeric_limits<float>::max();
+    int enter_axis = -1;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        if (dir[axis] == 0.f)
+        {
+            if (pos[axis] < cbox.relo[axis] || pos[axis] > cbox.rehi[axis])
+                return false;
+            continue;
+        }
+        float t0 = (cbox.relo[axis] - pos[axis]) / dir[axis];
+        float t1 = (cbox.rehi[axis] - pos[axis]) / dir[axis];
+        if (t0 > t1)
+            std::swap(t0, t1);
+        if (t0 > t_enter)
+        {
+            t_enter = t0;
+            enter_axis = axis;
+        }
+        t_leave = std::min(t_leave, t1);
+        if (t_enter > t_leave)
+            return false;
+    }
+
+    if (enter_axis == -1)
+    {
+        // The ray starts inside the box
+        out_distance = 0.f;
+        out_normal = -ray.getDirection().normalisedCopy();
+        return true;
+    }
+
+    Vector3 normal = Vector3::ZERO;
+    normal[enter_axis] = (dir[enter_axis] > 0.f) ? -1.f : 1.f;
+    if (cbox.selfrotated)
+    {
+        normal = cbox.selfrot * normal;
+    }
+    if (cbox.refined)
+    {
+        normal = cbox.rot * normal;
+    }
+    out_distance = t_enter;
+    out_normal = normal;
+    return true;
+}
@@ -0,0 +1,175 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2005-2012 Pierre-Michel Ricordel
+    Copyright 2007-2012 Thomas Fischer
+    Copyright 2013-2022 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Static collision elements (boxes and triangles) and the cell hash which `Collisions` looks them up in.
+/// Kept apart from `Collisions` so the lookup can be exercised without a terrain.
+
+#pragma once
+
+#include <Ogre.h>
+
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace RoR {
+
+struct ground_model_t;
+
+/// @addtogroup Physics
+/// @{
+
+/// @addtogroup Collisions
+/// @{
+
+enum CollisionEventFilter: short
+{
+    EVENT_NONE = 0,
+    EVENT_ALL,
+    EVENT_AVATAR,
+    EVENT_TRUCK,
+    EVENT_AIRPLANE,
+    EVENT_BOAT,
+    EVENT_DELETE
+};
+
+struct collision_box_t
+{
+    bool virt;
+    bool refined;
+    bool selfrotated;
+    bool camforced;
+    bool enabled;
+    CollisionEventFilter event_filter;
+    short eventsourcenum;
+    Ogre::Vector3 lo;           //!< absolute collision box
+    Ogre::Vector3 hi;           //!< absolute collision box
+    Ogre::Vector3 center;       //!< center of rotation
+    Ogre::Quaternion rot;       //!< rotation
+    Ogre::Quaternion unrot;     //!< rotation
+    Ogre::Vector3 selfcenter;   //!< center of self rotation
+    Ogre::Quaternion selfrot;   //!< self rotation
+    Ogre::Quaternion selfunrot; //!< self rotation
+    Ogre::Vector3 relo;         //!< relative collision box
+    Ogre::Vector3 rehi;         //!< relative collision box
+    Ogre::Vector3 campos;       //!< camera position
+    Ogre::Vector3 debug_verts[8];//!< box corners in absolute world position
+};
+typedef std::vector<collision_box_t*> CollisionBoxPtrVec;
+typedef std::vector<collision_box_t> CollisionBoxVec;
+
+struct collision_tri_t
+{
+    Ogre::Vector3 a;
+    Ogre::Vector3 b;
+    Ogre::Vector3 c;
+    Ogre::AxisAlignedBox aab;
+    Ogre::Matrix3 forward;
+    Ogre::Matrix3 reverse;
+    ground_model_t* gm;
+    bool enabled;
+};
+typedef std::vector<collision_tri_t> CollisionTriVec;
+
+/// Result of `Collisions::castRay()`
+struct collision_ray_hit_t
+{
+    bool             hit = false;
+    float            distance = 1.f;                //!< `Ogre::Ray::getPoint()` parameter; the ray direction spans the queried segment.
+    Ogre::Vector3    normal = Ogre::Vector3::ZERO;  //!< Unit length, facing the ray origin.
+    int              ctri_index = -1;               //!< Index to `Collisions::getCollisionTriangles()`, or -1
+    int              cbox_index = -1;               //!< Index to `Collisions::getCollisionBoxes()`, or -1; both -1 means terrain.
+    ground_model_t*  gm = nullptr;
+};
+
+/// Static collision object lookup system
+/// -------------------------------------
+/// Terrain is split into equal-size 'cells' of dimension CELL_SIZE, identified by CellID
+/// A hash table aggregates elements from multiple cells in one entry
+class CollisionCells
+{
+public:
+
+    struct hash_coll_element_t
+    {
+        static const int ELEMENT_TRI_BASE_INDEX = 1000000; // Effectively a maximum number of collision boxes
+
+        inline hash_coll_element_t(unsigned int cell_id_, int value): cell_id(cell_id_), element_index(value) {}
+
+        inline bool IsCollisionBox() const { return element_index < ELEMENT_TRI_BASE_INDEX; }
+        inline bool IsCollisionTri() const { return element_index >= ELEMENT_TRI_BASE_INDEX; }
+
+        unsigned int cell_id;
+
+        /// Values below ELEMENT_TRI_BASE_INDEX are collision box indices (Collisions::m_collision_boxes),
+        ///    values above are collision tri indices (Collisions::m_collision_tris).
+        int element_index;
+    };
+
+    /// Called for each ray of `CastRays()` before the cells, e.g. for the terrain; only elements in front of its hit are looked at.
+    typedef std::function<void(const Ogre::Ray&, collision_ray_hit_t&)> CastFirstFunc;
+
+    // this is a power of two, change with caution
+    static const int HASH_POWER = 20;
+    static const int HASH_SIZE = 1 << HASH_POWER;
+
+    // terrain size is limited to 327km x 327km:
+    static const int CELL_SIZE = 2.0; // we divide through this
+    static const int MAXIMUM_CELL = 0x7FFF;
+
+    /// @param tris Elements are looked up by index, the vectors may grow.
+    /// @param boxes Elements are looked up by index, the vectors may grow.
+    CollisionCells(CollisionTriVec const& tris, CollisionBoxVec const& boxes);
+
+    /// Registers the element in all cells its box overlaps, clamped to [0, MAXIMUM_CELL].
+    /// @param element_index See `hash_coll_element_t::element_index`
+    void AddElement(int element_index, Ogre::Vector3 const& lo, Ogre::Vector3 const& hi);
+    int hash_find(int cell_x, int cell_z) const; /// Returns index to 'hashtable'
+
+    /// Walks the cells along the ray (2D DDA) and keeps the nearest hit closer than `inout_hit.distance`.
+    void CastRay(const Ogre::Ray& ray, collision_ray_hit_t& inout_hit) const;
+    void CastRays(const Ogre::Ray* rays, collision_ray_hit_t* out_hits, size_t count, CastFirstFunc const& cast_first) const; //!< Large batches run on the thread pool.
+    static bool IntersectsBox(const Ogre::Ray& ray, const collision_box_t& cbox, float& out_distance, Ogre::Vector3& out_normal);
+
+    Ogre::AxisAlignedBox const& GetBounds() const { return m_bounds; }
+
+    ground_model_t* box_gm = nullptr; //!< Reported for hits on collision boxes
+
+    // collision hashtable
+    std::array<float, HASH_SIZE> hashtable_height;
+    std::vector<hash_coll_element_t> hashtable[HASH_SIZE];
+
+private:
+
+    void hash_add(int cell_x, int cell_z, int value, float h);
+    unsigned int hashfunc(unsigned int cellid) const;
+
+    CollisionTriVec const& m_collision_tris;
+    CollisionBoxVec const& m_collision_boxes;
+    Ogre::AxisAlignedBox m_bounds; // Tight bounding box around all collision elements
+    unsigned int hashmask;
+};
+
+/// @} // addtogroup Collisions
+/// @} // addtogroup Physics
+
+} // namespace RoR
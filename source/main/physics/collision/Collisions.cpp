@@ -35,106 +35,31 @@
 #include "ScriptEngine.h"
 #include "Terrain.h"
 
+#include <limits>
+
 using namespace RoR;
 
 // some gcc fixes
 #if OGRE_PLATFORM == OGRE_PLATFORM_LINUX
 #pragma GCC diagnostic ignored "-Wfloat-equal"
 #endif //OGRE_PLATFORM_LINUX
-
-//hash function SBOX
-//from http://home.comcast.net/~bretm/hash/10.html
-unsigned int sbox[] =
-{
-    0xF53E1837, 0x5F14C86B, 0x9EE3964C, 0xFA796D53,
-    0x32223FC3, 0x4D82BC98, 0xA0C7FA62, 0x63E2C982,
-    0x24994A5B, 0x1ECE7BEE, 0x292B38EF, 0xD5CD4E56,
-    0x514F4303, 0x7BE12B83, 0x7192F195, 0x82DC7300,
-    0x084380B4, 0x480B55D3, 0x5F430471, 0x13F75991,
-    0x3F9CF22C, 0x2FE0907A, 0xFD8E1E69, 0x7B1D5DE8,
-    0xD575A85C, 0xAD01C50A, 0x7EE00737, 0x3CE981E8,
-    0x0E447EFA, 0x23089DD6, 0xB59F149F, 0x13600EC7,
-    0xE802C8E6, 0x670921E4, 0x7207EFF0, 0xE74761B0,
-    0x69035234, 0xBFA40F19, 0xF63651A0, 0x29E64C26,
-    0x1F98CCA7, 0xD957007E, 0xE71DDC75, 0x3E729595,
-    0x7580B7CC, 0xD7FAF60B, 0x92484323, 0xA44113EB,
-    0xE4CBDE08, 0x346827C9, 0x3CF32AFA, 0x0B29BCF1,
-    0x6E29F7DF, 0xB01E71CB, 0x3BFBC0D1, 0x62EDC5B8,
-    0xB7DE789A, 0xA4748EC9, 0xE17A4C4F, 0x67E5BD03,
-    0xF3B33D1A, 0x97D8D3E9, 0x09121BC0, 0x347B2D2C,
-    0x79A1913C, 0x504172DE, 0x7F1F8483, 0x13AC3CF6,
-    0x7A2094DB, 0xC778FA12, 0xADF7469F, 0x21786B7B,
-    0x71A445D0, 0xA8896C1B, 0x656F62FB, 0x83A059B3,
-    0x972DFE6E, 0x4122000C, 0x97D9DA19, 0x17D5947B,
-    0xB1AFFD0C, 0x6EF83B97, 0xAF7F780B, 0x4613138A,
-    0x7C3E73A6, 0xCF15E03D, 0x41576322, 0x672DF292,
-    0xB658588D, 0x33EBEFA9, 0x938CBF06, 0x06B67381,
-    0x07F192C6, 0x2BDA5855, 0x348EE0E8, 0x19DBB6E3,
-    0x3222184B, 0xB69D5DBA, 0x7E760B88, 0xAF4D8154,
-    0x007A51AD, 0x35112500, 0xC9CD2D7D, 0x4F4FB761,
-    0x694772E3, 0x694C8351, 0x4A7E3AF5, 0x67D65CE1,
-    0x9287DE92, 0x2518DB3C, 0x8CB4EC06, 0xD154D38F,
-    0xE19A26BB, 0x295EE439, 0xC50A1104, 0x2153C6A7,
-    0x82366656, 0x0713BC2F, 0x6462215A, 0x21D9BFCE,
-    0xBA8EACE6, 0xAE2DF4C1, 0x2A8D5E80, 0x3F7E52D1,
-    0x29359399, 0xFEA1D19C, 0x18879313, 0x455AFA81,
-    0xFADFE838, 0x62609838, 0xD1028839, 0x0736E92F,
-    0x3BCA22A3, 0x1485B08A, 0x2DA7900B, 0x852C156D,
-    0xE8F24803, 0x00078472, 0x13F0D332, 0x2ACFD0CF,
-    0x5F747F5C, 0x87BB1E2F, 0xA7EFCB63, 0x23F432F0,
-    0xE6CE7C5C, 0x1F954EF6, 0xB609C91B, 0x3B4571BF,
-    0xEED17DC0, 0xE556CDA0, 0xA7846A8D, 0xFF105F94,
-    0x52B7CCDE, 0x0E33E801, 0x664455EA, 0xF2C70414,
-    0x73E7B486, 0x8F830661, 0x8B59E826, 0xBB8AEDCA,
-    0xF3D70AB9, 0xD739F2B9, 0x4A04C34A, 0x88D0F089,
-    0xE02191A2, 0xD89D9C78, 0x192C2749, 0xFC43A78F,
-    0x0AAC88CB, 0x9438D42D, 0x9E280F7A, 0x36063802,
-    0x38E8D018, 0x1C42A9CB, 0x92AAFF6C, 0xA24820C5,
-    0x007F077F, 0xCE5BC543, 0x69668D58, 0x10D6FF74,
-    0xBE00F621, 0x21300BBE, 0x2E9E8F46, 0x5ACEA629,
-    0xFA1F86C7, 0x52F206B8, 0x3EDF1A75, 0x6DA8D843,
-    0xCF719928, 0x73E3891F, 0xB4B95DD6, 0xB2A42D27,
-    0xEDA20BBF, 0x1A58DBDF, 0xA449AD03, 0x6DDEF22B,
-    0x900531E6, 0x3D3BFF35, 0x5B24ABA2, 0x472B3E4C,
-    0x387F2D75, 0x4D8DBA36, 0x71CB5641, 0xE3473F3F,
-    0xF6CD4B7F, 0xBF7D1428, 0x344B64D0, 0xC5CDFCB6,
-    0xFE2E0182, 0x2C37A673, 0xDE4EB7A3, 0x63FDC933,
-    0x01DC4063, 0x611F3571, 0xD167BFAF, 0x4496596F,
-    0x3DEE0689, 0xD8704910, 0x7052A114, 0x068C9EC5,
-    0x75D0E766, 0x4D54CC20, 0xB44ECDE2, 0x4ABC653E,
-    0x2C550A21, 0x1A52C0DB, 0xCFED03D0, 0x119BAFE2,
-    0x876A6133, 0xBC232088, 0x435BA1B2, 0xAE99BBFA,
-    0xBB4F08E4, 0xA62B5F49, 0x1DA4B695, 0x336B84DE,
-    0xDC813D31, 0x00C134FB, 0x397A98E6, 0x151F0E64,
-    0xD9EB3E69, 0xD3C7DF60, 0xD2F2C336, 0x2DDD067B,
-    0xBD122835, 0xB0B3BD3A, 0xB0D54E46, 0x8641F1E4,
-    0xA0B38F96, 0x51D39199, 0x37A6AD75, 0xDF84EE41,
-    0x3C034CBA, 0xACDA62FC, 0x11923B8B, 0x45EF170A,
-};
-
 using namespace Ogre;
 using namespace RoR;
 
 Collisions::Collisions(Ogre::Vector3 terrn_size):
       forcecam(false)
     , free_eventsource(0)
-    , hashmask(0)
+    , m_cells(m_collision_tris, m_collision_boxes)
     , landuse(0)
     , m_terrain_size(terrn_size)
     , collision_version(0)
     , forcecampos(Ogre::Vector3::ZERO)
 {
-    for (int i=0; i < HASH_POWER; i++)
-    {
-        hashmask = hashmask << 1;
-        hashmask++;
-    }
-
     loadDefaultModels();
     defaultgm = getGroundModelByString("concrete");
     defaultgroundgm = getGroundModelByString("gravel");
 
-    hashtable_height.fill(std::numeric_limits<float>::min());
+    m_cells.box_gm = defaultgm;
 }
 
 Collisions::~Collisions()
@@ -370,34 +295,6 @@ ground_model_t *Collisions::getGroundModelByString(const String name)
     return &ground_models[name];
 }
 
-unsigned int Collisions::hashfunc(unsigned int cellid)
-{
-    unsigned int hash = 0;
-    for (int i=0; i < 4; i++)
-    {
-        hash ^= sbox[((unsigned char*)&cellid)[i]];
-        hash *= 3;
-    }
-    return hash&hashmask;
-}
-
-void Collisions::hash_add(int cell_x, int cell_z, int value, float h)
-{
-    unsigned int cell_id = (cell_x << 16) + cell_z;
-    unsigned int pos    = hashfunc(cell_id);
-
-    hashtable[pos].emplace_back(cell_id, value);
-    hashtable_height[pos] = std::max(hashtable_height[pos], h);
-}
-
-int Collisions::hash_find(int cell_x, int cell_z)
-{
-    unsigned int cellid = (cell_x << 16) + cell_z;
-    unsigned int pos    = hashfunc(cellid);
-
-    return static_cast<int>(pos);
-}
-
 int Collisions::addCollisionBox(bool rotating, bool virt, Vector3 pos, Ogre::Vector3 rot, Ogre::Vector3 l, Ogre::Vector3 h, Ogre::Vector3 sr, const Ogre::String &eventname, const Ogre::String &instancename, bool forcecam, Ogre::Vector3 campos, Ogre::Vector3 sc /* = Vector3::UNIT_SCALE */, Ogre::Vector3 dr /* = Vector3::ZERO */, CollisionEventFilter event_filter /* = EVENT_ALL */, int scripthandler /* = -1 */)
 {
     Quaternion rotation  = Quaternion(Degree(rot.x), Vector3::UNIT_X) * Quaternion(Degree(rot.y), Vector3::UNIT_Y) * Quaternion(Degree(rot.z), Vector3::UNIT_Z);
@@ -526,24 +423,7 @@ int Collisions::addCollisionBox(bool rotating, bool virt, Vector3 pos, Ogre::Vec
     }
 
     // register this collision box in the index
-    Vector3 ilo = Ogre::Vector3(coll_box.lo / Ogre::Real(CELL_SIZE));
-    Vector3 ihi = Ogre::Vector3(coll_box.hi / Ogre::Real(CELL_SIZE));
-    
-    // clamp between 0 and MAXIMUM_CELL;
-    ilo.makeCeil(Ogre::Vector3(0.0f));
-    ilo.makeFloor(Ogre::Vector3(MAXIMUM_CELL));
-    ihi.makeCeil(Ogre::Vector3(0.0f));
-    ihi.makeFloor(Ogre::Vector3(MAXIMUM_CELL));
-
-    for (int i = ilo.x; i <= ihi.x; i++)
-    {
-        for (int j = ilo.z; j <= ihi.z; j++)
-        {
-            hash_add(i, j, coll_box_index,coll_box.hi.y);
-        }
-    }
-
-    m_collision_aab.merge(AxisAlignedBox(coll_box.lo, coll_box.hi));
+    m_cells.AddElement(coll_box_index, coll_box.lo, coll_box.hi);
     m_collision_boxes.push_back(coll_box);
     return coll_box_index;
 }
@@ -577,24 +457,7 @@ int Collisions::addCollisionTri(Vector3 p1, Vector3 p2, Vector3 p3, ground_model
     new_tri.aab.setMaximum(new_tri.aab.getMaximum() + 0.1f);
     
     // register this collision tri in the index
-    Ogre::Vector3 ilo(new_tri.aab.getMinimum() / Ogre::Real(CELL_SIZE));
-    Ogre::Vector3 ihi(new_tri.aab.getMaximum() / Ogre::Real(CELL_SIZE));
-    
-    // clamp between 0 and MAXIMUM_CELL;
-    ilo.makeCeil(Ogre::Vector3(0.0f));
-    ilo.makeFloor(Ogre::Vector3(MAXIMUM_CELL));
-    ihi.makeCeil(Ogre::Vector3(0.0f));
-    ihi.makeFloor(Ogre::Vector3(MAXIMUM_CELL));
-    
-    for (int i = ilo.x; i <= ihi.x; i++)
-    {
-        for (int j = ilo.z; j<=ihi.z; j++)
-        {
-            hash_add(i, j, new_tri_index + hash_coll_element_t::ELEMENT_TRI_BASE_INDEX, new_tri.aab.getMaximum().y);
-        }
-    }
-
-    m_collision_aab.merge(new_tri.aab);
+    m_cells.AddElement(new_tri_index + hash_coll_element_t::ELEMENT_TRI_BASE_INDEX, new_tri.aab.getMinimum(), new_tri.aab.getMaximum());
     m_collision_tris.push_back(new_tri);
     return new_tri_index;
 }
@@ -625,47 +488,38 @@ void Collisions::envokeScriptCallback(collision_box_t *cbox, node_t *node)
 #endif //USE_ANGELSCRIPT
 }
 
-std::pair<bool, Ogre::Real> Collisions::intersectsTris(Ogre::Ray ray)
+bool Collisions::castRay(const Ogre::Ray& ray, collision_ray_hit_t& out_hit, bool with_terrain)
 {
-    int steps = ray.getDirection().length() / (float)CELL_SIZE;
-
-    int lhash = -1;
+    out_hit = collision_ray_hit_t();
+    if (with_terrain)
+        this->castRayAtTerrain(ray, out_hit);
 
-    for (int i = 0; i <= steps; i++)
-    {
-        Vector3 pos = ray.getPoint((float)i / (float)steps);
-
-        // find the correct cell
-        int refx = (int)(pos.x / (float)CELL_SIZE);
-        int refz = (int)(pos.z / (float)CELL_SIZE);
-        int hash = hash_find(refx, refz);
-
-        if (hash == lhash)
-            continue;
-
-        lhash = hash;
-
-        size_t num_elements = hashtable[hash].size();
-        for (size_t k = 0; k < num_elements; k++)
-        {
-            if (hashtable[hash][k].IsCollisionTri())
-            {
-                const int ctri_index = hashtable[hash][k].element_index - hash_coll_element_t::ELEMENT_TRI_BASE_INDEX;
-                collision_tri_t *ctri = &m_collision_tris[ctri_index];
+    // Only elements in front of the terrain hit are of interest
+    m_cells.CastRay(ray, out_hit);
+    return out_hit.hit;
+}
 
-                if (!ctri->enabled)
-                    continue;
+void Collisions::castRays(const Ogre::Ray* rays, collision_ray_hit_t* out_hits, size_t count, bool with_terrain)
+{
+    if (with_terrain)
+        m_cells.CastRays(rays, out_hits, count, [this](const Ogre::Ray& ray, collision_ray_hit_t& hit) { this->castRayAtTerrain(ray, hit); });
+    else
+        m_cells.CastRays(rays, out_hits, count, nullptr);
+}
 
-                auto result = Ogre::Math::intersects(ray, ctri->a, ctri->b, ctri->c);
-                if (result.first && result.second < 1.0f)
-                {
-                    return result;
-                }
-            }
-        }
+void Collisions::castRayAtTerrain(const Ogre::Ray& ray, collision_ray_hit_t& inout_hit)
+{
+    auto result = App::GetGameContext()->GetTerrain()->IntersectsRay(ray);
+    if (result.first)
+    {
+        const Vector3 pos = ray.getPoint(result.second);
+        inout_hit.hit = true;
+        inout_hit.distance = result.second;
+        inout_hit.normal = App::GetGameContext()->GetTerrain()->GetNormalAt(pos.x, pos.y, pos.z);
+        inout_hit.gm = landuse ? landuse->getGroundModelAt(pos.x, pos.z) : nullptr;
+        if (!inout_hit.gm)
+            inout_hit.gm = defaultgroundgm;
     }
-
-    return std::make_pair(false, 0.0f);
 }
 
 float Collisions::getSurfaceHeight(float x, float z)
@@ -680,17 +534,17 @@ float Collisions::getSurfaceHeightBelow(float x, float z, float height)
     // find the correct cell
     int refx = (int)(x / (float)CELL_SIZE);
     int refz = (int)(z / (float)CELL_SIZE);
-    int hash = hash_find(refx, refz);
+    int hash = m_cells.hash_find(refx, refz);
 
-    Vector3 origin = Vector3(x, hashtable_height[hash], z);
+    Vector3 origin = Vector3(x, m_cells.hashtable_height[hash], z);
     Ray ray(origin, -Vector3::UNIT_Y);
 
-    size_t num_elements = hashtable[hash].size();
+    size_t num_elements = m_cells.hashtable[hash].size();
     for (size_t k = 0; k < num_elements; k++)
     {
-        if (hashtable[hash][k].IsCollisionBox())
+        if (m_cells.hashtable[hash][k].IsCollisionBox())
         {
-            collision_box_t* cbox = &m_collision_boxes[hashtable[hash][k].element_index];
+            collision_box_t* cbox = &m_collision_boxes[m_cells.hashtable[hash][k].element_index];
 
             if (!cbox->enabled)
                 continue;
@@ -736,7 +590,7 @@ float Collisions::getSurfaceHeightBelow(float x, float z, float height)
         }
         else // The element is a triangle
         {
-            const int ctri_index = hashtable[hash][k].element_index - hash_coll_element_t::ELEMENT_TRI_BASE_INDEX;
+            const int ctri_index = m_cells.hashtable[hash][k].element_index - hash_coll_element_t::ELEMENT_TRI_BASE_INDEX;
             collision_tri_t *ctri = &m_collision_tris[ctri_index];
 
             if (!ctri->enabled)
@@ -768,9 +622,9 @@ bool Collisions::collisionCorrect(Vector3 *refpos, bool envokeScriptCallbacks)
     // find the correct cell
     int refx = (int)(refpos->x / (float)CELL_SIZE);
     int refz = (int)(refpos->z / (float)CELL_SIZE);
-    int hash = hash_find(refx, refz);
+    int hash = m_cells.hash_find(refx, refz);
 
-    if (refpos->y > hashtable_height[hash])
+    if (refpos->y > m_cells.hashtable_height[hash])
         return false;
 
     collision_tri_t *minctri = 0;
@@ -780,12 +634,12 @@ bool Collisions::collisionCorrect(Vector3 *refpos, bool envokeScriptCallbacks)
     bool contacted = false;
     bool isScriptCallbackEnvoked = false;
 
-    size_t num_elements = hashtable[hash].size();
+    size_t num_elements = m_cells.hashtable[hash].size();
     for (size_t k = 0; k < num_elements; k++)
     {
-        if (hashtable[hash][k].IsCollisionBox())
+        if (m_cells.hashtable[hash][k].IsCollisionBox())
         {
-            collision_box_t* cbox = &m_collision_boxes[hashtable[hash][k].element_index];
+            collision_box_t* cbox = &m_collision_boxes[m_cells.hashtable[hash][k].element_index];
 
             if (!cbox->enabled)
                 continue;
@@ -865,7 +719,7 @@ bool Collisions::collisionCorrect(Vector3 *refpos, bool envokeScriptCallbacks)
         }
         else // The element is a triangle
         {
-            const int ctri_index = hashtable[hash][k].element_index - hash_coll_element_t::ELEMENT_TRI_BASE_INDEX;
+            const int ctri_index = m_cells.hashtable[hash][k].element_index - hash_coll_element_t::ELEMENT_TRI_BASE_INDEX;
             collision_tri_t *ctri = &m_collision_tris[ctri_index];
             if (!ctri->enabled)
                 continue;
@@ -929,10 +783,10 @@ bool Collisions::nodeCollision(node_t *node, float dt)
     // find the correct cell
     int refx = (int)(node->AbsPosition.x / CELL_SIZE);
     int refz = (int)(node->AbsPosition.z / CELL_SIZE);
-    int hash = hash_find(refx, refz);
+    int hash = m_cells.hash_find(refx, refz);
     unsigned int cell_id = (refx << 16) + refz;
 
-    if (node->AbsPosition.y > hashtable_height[hash])
+    if (node->AbsPosition.y > m_cells.hashtable_height[hash])
         return false;
 
     collision_tri_t *minctri = 0;
@@ -942,16 +796,16 @@ bool Collisions::nodeCollision(node_t *node, float dt)
     bool contacted = false;
     bool isScriptCallbackEnvoked = false;
 
-    size_t num_elements = hashtable[hash].size();
+    size_t num_elements = m_cells.hashtable[hash].size();
     for (size_t k=0; k < num_elements; k++)
     {
-        if (hashtable[hash][k].cell_id != cell_id)
+        if (m_cells.hashtable[hash][k].cell_id != cell_id)
         {
             continue;
         }
-        else if (hashtable[hash][k].IsCollisionBox())
+        else if (m_cells.hashtable[hash][k].IsCollisionBox())
         {
-            collision_box_t *cbox = &m_collision_boxes[hashtable[hash][k].element_index];
+            collision_box_t *cbox = &m_collision_boxes[m_cells.hashtable[hash][k].element_index];
 
             if (!cbox->enabled)
                 continue;
@@ -1047,7 +901,7 @@ bool Collisions::nodeCollision(node_t *node, float dt)
         else
         {
             // tri collision
-            const int ctri_index = hashtable[hash][k].element_index - hash_coll_element_t::ELEMENT_TRI_BASE_INDEX;
+            const int ctri_index = m_cells.hashtable[hash][k].element_index - hash_coll_element_t::ELEMENT_TRI_BASE_INDEX;
             collision_tri_t *ctri = &m_collision_tris[ctri_index];
             if (!ctri->enabled)
                 continue;
@@ -1104,19 +958,19 @@ void Collisions::findPotentialEventBoxes(Actor* actor, CollisionBoxPtrVec& out_b
         for (int refz = cell_lo_z; refz <= cell_hi_z; refz++)
         {
             // Find current cell
-            const int hash = this->hash_find(refx, refz);
+            const int hash = m_cells.hash_find(refx, refz);
             const unsigned int cell_id = (refx << 16) + refz;
 
             // Find eligible event boxes in the cell
-            for (size_t k = 0; k < hashtable[hash].size(); k++)
+            for (size_t k = 0; k < m_cells.hashtable[hash].size(); k++)
             {
-                if (hashtable[hash][k].cell_id != cell_id)
+                if (m_cells.hashtable[hash][k].cell_id != cell_id)
                 {
                     continue;
                 }
-                else if (hashtable[hash][k].IsCollisionBox())
+                else if (m_cells.hashtable[hash][k].IsCollisionBox())
                 {
-                    collision_box_t* cbox = &m_collision_boxes[hashtable[hash][k].element_index];
+                    collision_box_t* cbox = &m_collision_boxes[m_cells.hashtable[hash][k].element_index];
 
                     if (!cbox->enabled)
                         continue;
@@ -1328,11 +1182,11 @@ void Collisions::createCollisionDebugVisualization(Ogre::SceneNode* root_node, O
 
             int cellx = (int)(x/(float)CELL_SIZE);
             int cellz = (int)(z/(float)CELL_SIZE);
-            const int hash = hash_find(cellx, cellz);
+            const int hash = m_cells.hash_find(cellx, cellz);
 
-            bool used = std::find_if(hashtable[hash].begin(), hashtable[hash].end(), [&](hash_coll_element_t const &c) {
+            bool used = std::find_if(m_cells.hashtable[hash].begin(), m_cells.hashtable[hash].end(), [&](hash_coll_element_t const &c) {
                     return c.cell_id == (cellx << 16) + cellz;
-            }) != hashtable[hash].end();
+            }) != m_cells.hashtable[hash].end();
 
             if (used)
             {
@@ -1347,7 +1201,7 @@ void Collisions::createCollisionDebugVisualization(Ogre::SceneNode* root_node, O
                 groundheight = std::max(groundheight, App::GetGameContext()->GetTerrain()->GetHeightAt(x2, z2));
                 groundheight += 0.1; // 10 cm hover
 
-                float percentd = static_cast<float>(hashtable[hash].size()) / static_cast<float>(CELL_BLOCKSIZE);
+                float percentd = static_cast<float>(m_cells.hashtable[hash].size()) / static_cast<float>(CELL_BLOCKSIZE);
                 if (percentd > 1) percentd = 1;
 
                 // see `RoR::GUI::CollisionsDebug::GenerateCellDebugMaterials()`
@@ -23,7 +23,8 @@
 #pragma once
 
 #include "Application.h"
-#include "SimData.h" // for collision_box_t
+#include "CollisionCells.h"
+#include "SimData.h" // for ground_model_t
 
 #include <mutex>
 #include <Ogre.h>
@@ -47,19 +48,6 @@ struct eventsource_t //!< Scripting
     bool              es_enabled;
 };
 
-struct collision_tri_t
-{
-    Ogre::Vector3 a;
-    Ogre::Vector3 b;
-    Ogre::Vector3 c;
-    Ogre::AxisAlignedBox aab;
-    Ogre::Matrix3 forward;
-    Ogre::Matrix3 reverse;
-    ground_model_t* gm;
-    bool enabled;
-};
-typedef std::vector<collision_tri_t> CollisionTriVec;
-
 /// Records which collision triangles belong to which mesh.
 struct collision_mesh_t
 {
@@ -97,36 +85,11 @@ public:
 
 private:
 
-    /// Static collision object lookup system
-    /// -------------------------------------
-    /// Terrain is split into equal-size 'cells' of dimension CELL_SIZE, identified by CellID
-    /// A hash table aggregates elements from multiple cells in one entry
-    struct hash_coll_element_t
-    {
-        static const int ELEMENT_TRI_BASE_INDEX = 1000000; // Effectively a maximum number of collision boxes
-
-        inline hash_coll_element_t(unsigned int cell_id_, int value): cell_id(cell_id_), element_index(value) {}
-
-        inline bool IsCollisionBox() const { return element_index < ELEMENT_TRI_BASE_INDEX; }
-        inline bool IsCollisionTri() const { return element_index >= ELEMENT_TRI_BASE_INDEX; }
-
-        unsigned int cell_id;
-
-        /// Values below ELEMENT_TRI_BASE_INDEX are collision box indices (Collisions::m_collision_boxes),
-        ///    values above are collision tri indices (Collisions::m_collision_tris).
-        int element_index;
-    };
-
     static const int LATEST_GROUND_MODEL_VERSION = 3;
     static const int MAX_EVENT_SOURCE = 500;
 
-    // this is a power of two, change with caution
-    static const int HASH_POWER = 20;
-    static const int HASH_SIZE = 1 << HASH_POWER;
-
-    // terrain size is limited to 327km x 327km:
-    static const int CELL_SIZE = 2.0; // we divide through this
-    static const int MAXIMUM_CELL = 0x7FFF;
+    typedef CollisionCells::hash_coll_element_t hash_coll_element_t;
+    static const int CELL_SIZE = CollisionCells::CELL_SIZE;
 
     // collision boxes pool
     CollisionBoxVec m_collision_boxes; // Formerly MAX_COLLISION_BOXES = 5000
@@ -136,11 +99,7 @@ private:
     CollisionTriVec m_collision_tris; // Formerly MAX_COLLISION_TRIS = 100000
     CollisionMeshVec m_collision_meshes; // For diagnostics/editing only.
 
-    Ogre::AxisAlignedBox m_collision_aab; // Tight bounding box around all collision meshes
-
-    // collision hashtable
-    std::array<float, HASH_SIZE> hashtable_height;
-    std::vector<hash_coll_element_t> hashtable[HASH_SIZE];
+    CollisionCells m_cells; // Lookup of the above, by position
 
     // ground models
     std::map<Ogre::String, ground_model_t> ground_models;
@@ -153,16 +112,13 @@ private:
 
     Landusemap* landuse;
     int collision_version;
-    unsigned int hashmask;
 
     const Ogre::Vector3 m_terrain_size;
 
-    void hash_add(int cell_x, int cell_z, int value, float h);
-    int hash_find(int cell_x, int cell_z); /// Returns index to 'hashtable'
-    unsigned int hashfunc(unsigned int cellid);
     void parseGroundConfig(Ogre::ConfigFile* cfg, Ogre::String groundModel = "");
 
     Ogre::Vector3 calcCollidedSide(const Ogre::Vector3& pos, const Ogre::Vector3& lo, const Ogre::Vector3& hi);
+    void castRayAtTerrain(const Ogre::Ray& ray, collision_ray_hit_t& inout_hit); //!< Heightfield part of `castRay()`
 
 public:
 
@@ -177,7 +133,11 @@ public:
     Ogre::Quaternion getDirection(const Ogre::String& inst, const Ogre::String& box);
     collision_box_t* getBox(const Ogre::String& inst, const Ogre::String& box);
 
-    std::pair<bool, Ogre::Real> intersectsTris(Ogre::Ray ray);
+
+    /// Nearest hit along the segment `ray.getPoint([0-1])`: collision triangles, solid collision boxes and optionally the terrain heightfield.
+    /// Safe to call from multiple threads as long as no collision elements are added or removed.
+    bool castRay(const Ogre::Ray& ray, collision_ray_hit_t& out_hit, bool with_terrain = true);
+    void castRays(const Ogre::Ray* rays, collision_ray_hit_t* out_hits, size_t count, bool with_terrain = true); //!< Large batches run on the thread pool.
 
     float getSurfaceHeight(float x, float z);
     float getSurfaceHeightBelow(float x, float z, float height);
@@ -200,7 +160,7 @@ public:
     void removeCollisionTri(int number);
     void clearEventCache() { m_last_called_cboxes.clear(); }
 
-    Ogre::AxisAlignedBox getCollisionAAB() { return m_collision_aab; };
+    Ogre::AxisAlignedBox getCollisionAAB() { return m_cells.GetBounds(); };
 
     // ground models things
     int loadDefaultModels();
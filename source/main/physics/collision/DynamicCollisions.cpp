@@ -30,6 +30,9 @@
 #include "PointColDetector.h"
 #include "Triangle.h"
 
+#include <algorithm>
+#include <limits>
+
 using namespace Ogre;
 using namespace RoR;
 
@@ -207,88 +210,243 @@ void RoR::ResolveInterActorCollisions(const float dt, PointColDetector &interPoi
 }
 
 
-void RoR::ResolveIntraActorCollisions(const float dt, PointColDetector &intraPointCD,
-        const int free_collcab, int collcabs[], int cabs[],
-        collcab_rate_t intra_collcabrate[], node_t nodes[],
-        const float collrange,
-        ground_model_t &submesh_ground_model)
+namespace {
+
+/// Spreads the lower 10 bits of `v` so that there are two zero bits between each.
+uint32_t MortonSpread(uint32_t v)
 {
-    for (int i=0; i<free_collcab; i++)
+    v &= 0x3ff;
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v <<  8)) & 0x0300f00f;
+    v = (v | (v <<  4)) & 0x030c30c3;
+    v = (v | (v <<  2)) & 0x09249249;
+    return v;
+}
+
+} // namespace
+
+void IntraActorCollider::Build(Actor* actor, int exclusion_hops)
+{
+    const int num_collcabs = actor->ar_num_collcabs;
+    const node_t* nodes = actor->ar_nodes;
+
+    // Order triangles along a Morton curve over the actor's bounding box, then cut into clusters;
+    // neighbouring triangles of a mesh end up together and stay together while it deforms.
+    Vector3 bb_min(std::numeric_limits<float>::max());
+    Vector3 bb_max(-std::numeric_limits<float>::max());
+    std::vector<Vector3> centroids(num_collcabs);
+    for (int i = 0; i < num_collcabs; i++)
+    {
+        const int tmpv = actor->ar_collcabs[i] * 3;
+        centroids[i] = (nodes[actor->ar_cabs[tmpv]].AbsPosition + nodes[actor->ar_cabs[tmpv+1]].AbsPosition + nodes[actor->ar_cabs[tmpv+2]].AbsPosition) / 3.f;
+        bb_min.makeFloor(centroids[i]);
+        bb_max.makeCeil(centroids[i]);
+    }
+    const Vector3 extent = bb_max - bb_min;
+    const float scale = 1023.f / std::max(std::max(extent.x, extent.y), std::max(extent.z, 0.001f));
+    std::vector<std::pair<uint32_t, int>> codes(num_collcabs);
+    for (int i = 0; i < num_collcabs; i++)
+    {
+        const Vector3 cell = (centroids[i] - bb_min) * scale;
+        codes[i].first = MortonSpread((uint32_t)cell.x) | (MortonSpread((uint32_t)cell.y) << 1) | (MortonSpread((uint32_t)cell.z) << 2);
+        codes[i].second = i;
+    }
+    std::sort(codes.begin(), codes.end());
+
+    m_cluster_collcabs.resize(num_collcabs);
+    m_clusters.clear();
+    for (int i = 0; i < num_collcabs; i++)
     {
-        if (intra_collcabrate[i].rate > 0)
+        m_cluster_collcabs[i] = codes[i].second;
+        if (i % CLUSTER_SIZE == 0)
         {
-            intra_collcabrate[i].distance++;
-            intra_collcabrate[i].rate--;
-            continue;
+            m_clusters.push_back(Cluster{i, std::min(CLUSTER_SIZE, num_collcabs - i)});
         }
-        if (intra_collcabrate[i].distance > 0)
+    }
+
+    // Exclusion sets: breadth-first walk over beams from the triangle's vertices
+    m_exclusion_start.resize(num_collcabs + 1);
+    m_exclusion_nodes.clear();
+    std::vector<NodeNum_t> frontier, next_frontier;
+    for (int i = 0; i < num_collcabs; i++)
+    {
+        m_exclusion_start[i] = static_cast<int>(m_exclusion_nodes.size());
+        const int tmpv = actor->ar_collcabs[i] * 3;
+        frontier.assign({ (NodeNum_t)actor->ar_cabs[tmpv], (NodeNum_t)actor->ar_cabs[tmpv+1], (NodeNum_t)actor->ar_cabs[tmpv+2] });
+        m_exclusion_nodes.insert(m_exclusion_nodes.end(), frontier.begin(), frontier.end());
+        for (int hop = 0; hop < exclusion_hops && !frontier.empty(); hop++)
         {
-            intra_collcabrate[i].rate = std::min(intra_collcabrate[i].distance, 12);
-            intra_collcabrate[i].distance = 0;
+            next_frontier.clear();
+            for (NodeNum_t n: frontier)
+            {
+                for (int neighbour: actor->ar_node_to_node_connections[n])
+                {
+                    next_frontier.push_back((NodeNum_t)neighbour);
+                }
+            }
+            m_exclusion_nodes.insert(m_exclusion_nodes.end(), next_frontier.begin(), next_frontier.end());
+            frontier.swap(next_frontier);
         }
+        auto range_begin = m_exclusion_nodes.begin() + m_exclusion_start[i];
+        std::sort(range_begin, m_exclusion_nodes.end());
+        m_exclusion_nodes.erase(std::unique(range_begin, m_exclusion_nodes.end()), m_exclusion_nodes.end());
+    }
+    m_exclusion_start[num_collcabs] = static_cast<int>(m_exclusion_nodes.size());
 
-        int tmpv = collcabs[i]*3;
-        const auto no = &nodes[cabs[tmpv]];
-        const auto na = &nodes[cabs[tmpv+1]];
-        const auto nb = &nodes[cabs[tmpv+2]];
+    m_exclusion_hops = exclusion_hops;
+    m_built = true;
+}
 
-        intraPointCD.query(no->AbsPosition
-                , na->AbsPosition
-                , nb->AbsPosition, collrange);
+bool IntraActorCollider::IsExcluded(int collcab, NodeNum_t node) const
+{
+    return std::binary_search(m_exclusion_nodes.begin() + m_exclusion_start[collcab],
+                              m_exclusion_nodes.begin() + m_exclusion_start[collcab + 1], node);
+}
 
-        bool collision = false;
+void IntraActorCollider::Resolve(const float dt, PointColDetector &intraPointCD, Actor* actor)
+{
+    node_t* nodes = actor->ar_nodes;
+    const int* cabs = actor->ar_cabs;
+    const int* collcabs = actor->ar_collcabs;
+    collcab_rate_t* intra_collcabrate = actor->ar_intra_collcabrate;
+    const float collrange = actor->ar_collision_range;
 
-        if (!intraPointCD.hit_list.empty())
+    for (Cluster const& cluster: m_clusters)
+    {
+        // Back-off bookkeeping; triangles which didn't collide lately are only tested every few steps
+        int active[CLUSTER_SIZE];
+        int num_active = 0;
+        for (int c = cluster.begin; c < cluster.begin + cluster.count; c++)
         {
-            // setup transformation of points to triangle local coordinates
-            const Triangle triangle(na->AbsPosition, nb->AbsPosition, no->AbsPosition);
-            const CartesianToTriangleTransform transform(triangle);
+            const int i = m_cluster_collcabs[c];
+            if (intra_collcabrate[i].rate > 0)
+            {
+                intra_collcabrate[i].distance++;
+                intra_collcabrate[i].rate--;
+                continue;
+            }
+            if (intra_collcabrate[i].distance > 0)
+            {
+                intra_collcabrate[i].rate = std::min(intra_collcabrate[i].distance, 12);
+                intra_collcabrate[i].distance = 0;
+            }
+            active[num_active++] = i;
+        }
+        if (num_active == 0)
+            continue;
 
-            for (PointidID_t h : intraPointCD.hit_list)
+        // Refit the cluster box (active triangles only) and query once
+        Vector3 bb_min = nodes[cabs[collcabs[active[0]]*3]].AbsPosition;
+        Vector3 bb_max = bb_min;
+        for (int a = 0; a < num_active; a++)
+        {
+            const int tmpv = collcabs[active[a]]*3;
+            for (int v = 0; v < 3; v++)
             {
-                NodeNum_t hitnode_num = intraPointCD.hit_pointid_list[h].nodenum;
-                node_t& hitnode = nodes[hitnode_num];
+                bb_min.makeFloor(nodes[cabs[tmpv+v]].AbsPosition);
+                bb_max.makeCeil(nodes[cabs[tmpv+v]].AbsPosition);
+            }
+        }
+        intraPointCD.query(bb_min - collrange, bb_max + collrange);
 
-                //ignore wheel/chassis self contact
-                if (hitnode.nd_tyre_node) continue;
-                if (no == &hitnode || na == &hitnode || nb == &hitnode) continue;
+        // Gather candidates into SoA, padded with NaN which fails every test
+        m_cand_x.clear(); m_cand_y.clear(); m_cand_z.clear(); m_cand_node.clear();
+        for (PointidID_t h : intraPointCD.hit_list)
+        {
+            const NodeNum_t hitnode_num = intraPointCD.hit_pointid_list[h].nodenum;
+            //ignore wheel/chassis self contact
+            if (nodes[hitnode_num].nd_tyre_node)
+                continue;
+            m_cand_x.push_back(nodes[hitnode_num].AbsPosition.x);
+            m_cand_y.push_back(nodes[hitnode_num].AbsPosition.y);
+            m_cand_z.push_back(nodes[hitnode_num].AbsPosition.z);
+            m_cand_node.push_back(hitnode_num);
+        }
+        const size_t num_cand = m_cand_node.size();
+        const size_t num_padded = (num_cand + BATCH_SIZE - 1) / BATCH_SIZE * BATCH_SIZE;
+        m_cand_x.resize(num_padded, std::numeric_limits<float>::quiet_NaN());
+        m_cand_y.resize(num_padded, std::numeric_limits<float>::quiet_NaN());
+        m_cand_z.resize(num_padded, std::numeric_limits<float>::quiet_NaN());
+        m_alpha.resize(num_padded);
+        m_beta.resize(num_padded);
+        m_dist.resize(num_padded);
+        m_inside.resize(num_padded);
+
+        for (int a = 0; a < num_active; a++)
+        {
+            const int i = active[a];
+            const int tmpv = collcabs[i]*3;
+            const auto no = &nodes[cabs[tmpv]];
+            const auto na = &nodes[cabs[tmpv+1]];
+            const auto nb = &nodes[cabs[tmpv+2]];
 
-                // transform point to triangle local coordinates
-                const auto local_point = transform(hitnode.AbsPosition);
+            bool collision = false;
 
-                // collision test
-                const bool is_colliding = InsideTriangleTest(local_point, collrange);
-                if (is_colliding)
+            if (num_cand > 0)
+            {
+                // Same transformation as `CartesianToTriangleTransform`, applied to a whole batch at once
+                const Triangle triangle(na->AbsPosition, nb->AbsPosition, no->AbsPosition);
+                const Vector3 normal = triangle.normal();
+                const Matrix3 m = Matrix3{ triangle.u[0], triangle.v[0], normal[0],
+                                           triangle.u[1], triangle.v[1], normal[1],
+                                           triangle.u[2], triangle.v[2], normal[2] }.Inverse();
+                const float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+                const float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+                const float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+                const float cx = triangle.c.x, cy = triangle.c.y, cz = triangle.c.z;
+
+                const float* __restrict px = m_cand_x.data();
+                const float* __restrict py = m_cand_y.data();
+                const float* __restrict pz = m_cand_z.data();
+                float* __restrict alpha = m_alpha.data();
+                float* __restrict beta = m_beta.data();
+                float* __restrict dist = m_dist.data();
+                uint8_t* __restrict inside = m_inside.data();
+                for (size_t k = 0; k < num_padded; k++)
                 {
-                    collision = true;
+                    const float dx = px[k] - cx, dy = py[k] - cy, dz = pz[k] - cz;
+                    const float al = m00 * dx + m01 * dy + m02 * dz;
+                    const float be = m10 * dx + m11 * dy + m12 * dz;
+                    const float di = m20 * dx + m21 * dy + m22 * dz;
+                    alpha[k] = al;
+                    beta[k] = be;
+                    dist[k] = di;
+                    inside[k] = (al >= 0.f) & (be >= 0.f) & ((1.f - al - be) >= 0.f) & (std::abs(di) <= collrange);
+                }
+
+                for (size_t k = 0; k < num_cand; k++)
+                {
+                    if (!inside[k] || this->IsExcluded(i, m_cand_node[k]))
+                        continue;
 
-                    const auto coord = local_point.barycentric;
-                    auto distance = local_point.distance;
-                    auto normal   = triangle.normal();
+                    collision = true;
+                    node_t& hitnode = nodes[m_cand_node[k]];
 
+                    auto distance = dist[k];
+                    auto hit_normal = normal;
                     // adapt in case the collision is occuring on the backface of the triangle
-                    if (distance < 0) 
+                    if (distance < 0)
                     {
                         // flip surface normal and distance to triangle plane
-                        normal   = -normal;
-                        distance = -distance;
+                        hit_normal = -hit_normal;
+                        distance   = -distance;
                     }
 
                     const auto penetration_depth = collrange - distance;
 
-                    ResolveCollisionForces(penetration_depth, hitnode, *na, *nb, *no, coord.alpha,
-                            coord.beta, coord.gamma, normal, dt, false, submesh_ground_model);
+                    ResolveCollisionForces(penetration_depth, hitnode, *na, *nb, *no, alpha[k],
+                            beta[k], 1.f - alpha[k] - beta[k], hit_normal, dt, false, *actor->ar_submesh_ground_model);
                 }
             }
-        }
 
-        if (collision)
-        {
-            intra_collcabrate[i].rate = -20000;
-        }
-        else
-        {
-            intra_collcabrate[i].rate++;
+            if (collision)
+            {
+                intra_collcabrate[i].rate = -20000;
+            }
+            else
+            {
+                intra_collcabrate[i].rate++;
+            }
         }
     }
 }
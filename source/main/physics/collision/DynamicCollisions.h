@@ -24,6 +24,8 @@
 #include "ForwardDeclarations.h"
 #include "SimData.h"
 
+#include <vector>
+
 namespace RoR {
 
 /// @addtogroup Physics
@@ -38,11 +40,49 @@ void ResolveInterActorCollisions(const float dt, PointColDetector &interPointCD,
         const float collrange,
         ground_model_t &submesh_ground_model);
 
-void ResolveIntraActorCollisions(const float dt, PointColDetector &intraPointCD,
-        const int free_collcab, int collcabs[], int cabs[],
-        collcab_rate_t intra_collcabrate[], node_t nodes[],
-        const float collrange,
-        ground_model_t &submesh_ground_model);
+/// Self-collision of an actor's collision triangles (collcabs) with its own contacter nodes.
+///
+/// Triangles are grouped into spatially coherent clusters (ordered along a Morton curve at build time);
+/// cluster boxes are refit from current node positions every substep and one k-d tree query serves the
+/// whole cluster. The narrowphase transforms the cluster's candidate points into each triangle's local
+/// coordinates in structure-of-arrays batches of `BATCH_SIZE`, which the compiler vectorizes.
+/// Optionally, nodes within N beam hops of a triangle are excluded from colliding with it.
+class IntraActorCollider
+{
+public:
+    static const int CLUSTER_SIZE = 8;  //!< Triangles per cluster
+    static const int BATCH_SIZE = 8;    //!< Points per narrowphase iteration; candidate arrays are padded to a multiple of this
+
+    /// Computes clusters and exclusion sets; call again when the topology settings change.
+    /// @param exclusion_hops 0 = a triangle only ignores its own vertices.
+    void Build(Actor* actor, int exclusion_hops);
+    bool IsBuiltFor(int exclusion_hops) const { return m_built && m_exclusion_hops == exclusion_hops; }
+
+    /// The actor's intra PointColDetector must be updated before calling this.
+    void Resolve(const float dt, PointColDetector &intraPointCD, Actor* actor);
+
+private:
+    struct Cluster
+    {
+        int begin;   //!< Into `m_cluster_collcabs`
+        int count;
+    };
+
+    bool IsExcluded(int collcab, NodeNum_t node) const;
+
+    std::vector<Cluster>   m_clusters;
+    std::vector<int>       m_cluster_collcabs;  //!< Indices into `Actor::ar_collcabs`, grouped by cluster
+    std::vector<int>       m_exclusion_start;   //!< Per collcab, into `m_exclusion_nodes`; one extra entry at the end
+    std::vector<NodeNum_t> m_exclusion_nodes;   //!< Sorted within each collcab's range
+    int                    m_exclusion_hops = 0;
+    bool                   m_built = false;
+
+    // Narrowphase scratch (SoA)
+    std::vector<float>     m_cand_x, m_cand_y, m_cand_z;
+    std::vector<NodeNum_t> m_cand_node;
+    std::vector<float>     m_alpha, m_beta, m_dist;
+    std::vector<uint8_t>   m_inside;
+};
 
 /// @} // addtogroup Collisions
 /// @} // addtogroup Physics
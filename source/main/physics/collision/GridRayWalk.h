@@ -0,0 +1,98 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Cell-by-cell traversal of a 2D grid along a ray segment, shared by the collision and terrain raycasts.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace RoR {
+
+/// @addtogroup Physics
+/// @{
+
+/// @addtogroup Collisions
+/// @{
+
+/// Walks the unit cells of a 2D grid crossed by the segment `p(t) = origin + dir * t, t in [t_enter, t_leave]`,
+/// nearest first (Amanatides & Woo). Callers map world space to grid space, `t` is the same in both.
+class GridRayWalk
+{
+public:
+    /// Starts in the cell containing `p(t_enter)`.
+    GridRayWalk(float origin_u, float origin_v, float dir_u, float dir_v, float t_enter, float t_leave)
+        : GridRayWalk(origin_u, origin_v, dir_u, dir_v, t_enter, t_leave,
+                      static_cast<long>(std::floor(origin_u + dir_u * t_enter)),
+                      static_cast<long>(std::floor(origin_v + dir_v * t_enter)))
+    {}
+
+    /// Starts in the given cell, for callers which clamp it to their grid.
+    GridRayWalk(float origin_u, float origin_v, float dir_u, float dir_v, float t_enter, float t_leave,
+                long cell_u, long cell_v)
+        : m_cell_u(cell_u)
+        , m_cell_v(cell_v)
+        , m_step_u((dir_u > 0.f) ? 1 : -1)
+        , m_step_v((dir_v > 0.f) ? 1 : -1)
+        , m_t_delta_u((dir_u != 0.f) ? (1.f / std::abs(dir_u)) : std::numeric_limits<float>::infinity())
+        , m_t_delta_v((dir_v != 0.f) ? (1.f / std::abs(dir_v)) : std::numeric_limits<float>::infinity())
+        , m_t_next_u((dir_u != 0.f) ? (((cell_u + (dir_u > 0.f)) - origin_u) / dir_u) : std::numeric_limits<float>::infinity())
+        , m_t_next_v((dir_v != 0.f) ? (((cell_v + (dir_v > 0.f)) - origin_v) / dir_v) : std::numeric_limits<float>::infinity())
+        , m_t_cell(t_enter)
+        , m_t_leave(t_leave)
+    {}
+
+    long  GetCellU() const     { return m_cell_u; }
+    long  GetCellV() const     { return m_cell_v; }
+    float GetCellEnter() const { return m_t_cell; }                                           //!< Where the segment enters the current cell.
+    float GetCellExit() const  { return std::min(std::min(m_t_next_u, m_t_next_v), m_t_leave); } //!< Where the segment leaves the current cell.
+    bool  IsLastCell() const   { return this->GetCellExit() >= m_t_leave; }
+
+    /// Moves to the next cell along the segment.
+    void Step()
+    {
+        m_t_cell = this->GetCellExit();
+        if (m_t_next_u < m_t_next_v)
+        {
+            m_cell_u += m_step_u;
+            m_t_next_u += m_t_delta_u;
+        }
+        else
+        {
+            m_cell_v += m_step_v;
+            m_t_next_v += m_t_delta_v;
+        }
+    }
+
+private:
+    long  m_cell_u, m_cell_v;
+    long  m_step_u, m_step_v;
+    float m_t_delta_u, m_t_delta_v; //!< Segment parameter span of one cell
+    float m_t_next_u, m_t_next_v;   //!< Where the segment crosses the next cell border
+    float m_t_cell;
+    float m_t_leave;
+};
+
+/// @} // addtogroup Collisions
+/// @} // addtogroup Physics
+
+} // namespace RoR
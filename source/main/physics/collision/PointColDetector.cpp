@@ -27,16 +27,16 @@
 using namespace Ogre;
 using namespace RoR;
 
-void PointColDetector::UpdateIntraPoint(bool contactables)
+void PointColDetector::UpdateIntraPoint()
 {
-    int contacters_size = contactables ? m_actor->ar_num_contactable_nodes : m_actor->ar_num_contacters;
+    int contacters_size = m_actor->ar_num_contacters;
 
     if (contacters_size != m_object_list_size)
     {
         m_collision_partners.clear();
         m_collision_partners.push_back(m_actor->ar_instance_id);
         m_object_list_size = contacters_size;
-        update_structures_for_contacters(contactables);
+        update_structures_for_contacters();
     }
     else
     {
@@ -48,13 +48,13 @@ void PointColDetector::UpdateIntraPoint(bool contactables)
     m_kdtree[0].end = -m_object_list_size;
 }
 
-void PointColDetector::UpdateInterPoint(bool ignorestate)
+void PointColDetector::UpdateInterPoint()
 {
     int contacters_size = 0;
     std::vector<ActorInstanceID_t> collision_partners;
     for (ActorPtr& actor : App::GetGameContext()->GetActorManager()->GetActors())
     {
-        if (actor != m_actor && (ignorestate || actor->ar_update_physics) &&
+        if (actor != m_actor && actor->ar_update_physics &&
                 m_actor->ar_bounding_box.intersects(actor->ar_bounding_box))
         {
             collision_partners.push_back(actor->ar_instance_id);
@@ -82,7 +82,7 @@ void PointColDetector::UpdateInterPoint(bool ignorestate)
     {
         m_collision_partners = collision_partners;
         m_object_list_size = contacters_size;
-        update_structures_for_contacters(false);
+        update_structures_for_contacters();
     }
     else
     {
@@ -94,7 +94,7 @@ void PointColDetector::UpdateInterPoint(bool ignorestate)
     m_kdtree[0].end = -m_object_list_size;
 }
 
-void PointColDetector::update_structures_for_contacters(bool ignoreinternal)
+void PointColDetector::update_structures_for_contacters()
 {
     m_ref_list.resize(m_object_list_size);
     hit_pointid_list.resize(m_object_list_size);
@@ -106,7 +106,7 @@ void PointColDetector::update_structures_for_contacters(bool ignoreinternal)
         const ActorPtr& actor = App::GetGameContext()->GetActorManager()->GetActorById(actorid);
 
         bool is_linked = std::find(m_actor->ar_linked_actors.begin(), m_actor->ar_linked_actors.end(), actor) != m_actor->ar_linked_actors.end();
-        bool internal_collision = !ignoreinternal && ((actorid == m_actor->ar_instance_id) || is_linked);
+        bool internal_collision = (actorid == m_actor->ar_instance_id) || is_linked;
         for (int i = 0; i < actor->ar_num_nodes; i++)
         {
             if (actor->ar_nodes[i].nd_contacter || (!internal_collision && actor->ar_nodes[i].nd_contactable))
@@ -156,6 +156,16 @@ void PointColDetector::query(const Vector3 &vec1, const Vector3 &vec2, const Vec
     queryrec(0, 0);
 }
 
+void PointColDetector::query(const Vector3 &bbmin, const Vector3 &bbmax)
+{
+    m_bbmin = bbmin;
+    m_bbmax = bbmax;
+
+    hit_list.clear();
+    hit_list_actorset.clear();
+    queryrec(0, 0);
+}
+
 void PointColDetector::queryrec(int kdindex, int axis)
 {
     for (;;)
@@ -45,9 +45,10 @@ public:
 
     PointColDetector(ActorPtr actor): m_actor(actor), m_object_list_size(-1) {};
 
-    void UpdateIntraPoint(bool contactables = false);
-    void UpdateInterPoint(bool ignorestate = false);
+    void UpdateIntraPoint();
+    void UpdateInterPoint();
     void query(const Ogre::Vector3& vec1, const Ogre::Vector3& vec2, const Ogre::Vector3& vec3, const float enlargeBB);
+    void query(const Ogre::Vector3& bbmin, const Ogre::Vector3& bbmax); //!< All points within the box
 
 private:
 
@@ -80,7 +81,7 @@ private:
     void queryrec(int kdindex, int axis);
     void build_kdtree_incr(int axis, int index);
     void partintwo(const int start, const int median, const int end, const int axis, float& minex, float& maxex);
-    void update_structures_for_contacters(bool ignoreinternal);
+    void update_structures_for_contacters();
     void refresh_node_positions();
 };
 
@@ -587,10 +587,11 @@ void FlexAirfoil::addwash(int propid, float ratio)
     free_wash++;
 }
 
-void FlexAirfoil::updateForces()
+bool FlexAirfoil::prepareForces(AirfoilQueryBatch& batch, size_t slot)
 {
-    if (!airfoil) return;
-    if (broken) return;
+    batch.polar[slot] = nullptr;
+    if (!airfoil) return false;
+    if (broken) return false;
 
     //evaluate wind direction
     Vector3 wind=-(nodes[nfld].Velocity+nodes[nfrd].Velocity)/2.0;
@@ -619,16 +620,32 @@ void FlexAirfoil::updateForces()
     Degree daoa;
     chordv.getRotationTo(-pwind).ToAngleAxis(daoa, dumb);
     aoa=daoa.valueDegrees();
-    float raoa=daoa.valueRadians();
-    if (dumb.dotProduct(spanv)>0) {aoa=-aoa; raoa=-raoa;};
-
-    //get airfoil data
-    float cz, cx, cm;
-    if (isstabilator)
-        airfoil->getparams(aoa-deflection, chordratio, 0, &cz, &cx, &cm);
-    else
-        airfoil->getparams(aoa, chordratio, deflection, &cz, &cx, &cm);
+    if (dumb.dotProduct(spanv)>0) {aoa=-aoa;};
+
+    //queue airfoil data lookup
+    batch.polar[slot] = airfoil->getPolar();
+    batch.aoa[slot] = (isstabilator) ? (aoa-deflection) : aoa;
+    batch.cratio[slot] = chordratio;
+    batch.cdef[slot] = (isstabilator) ? 0.f : deflection;
+
+    m_force_wind = wind;
+    m_force_liftv = liftv;
+    m_force_normv = normv;
+    m_force_wspeed = wspeed;
+    m_force_chord = chord;
+    m_force_surface = s;
+    return true;
+}
 
+void FlexAirfoil::applyForces(AirfoilQueryBatch const& batch, size_t slot)
+{
+    const float cz = batch.cl[slot];
+    const float cx = batch.cd[slot];
+    const float cm = batch.cm[slot];
+    const Vector3& wind = m_force_wind;
+    const Vector3& normv = m_force_normv;
+    const float wspeed = m_force_wspeed;
+    const float s = m_force_surface;
 
     //tropospheric model valid up to 11.000m (33.000ft)
     float altitude=nodes[nfld].AbsPosition.y;
@@ -658,7 +675,7 @@ void FlexAirfoil::updateForces()
     }
 
     //lift
-    wforce+=(cz*0.5*airdensity*wspeed*chord)*liftv;
+    wforce+=(cz*0.5*airdensity*wspeed*m_force_chord)*m_force_liftv;
 
     //moment
     float moment=-cm*0.5*airdensity*wspeed*wspeed*s;//*chord;
@@ -23,6 +23,7 @@
 #include <Ogre.h>
 
 #include "Application.h"
+#include "Airfoil.h"
 #include "SimData.h" // For MAX_AEROENGINES
 
 namespace RoR {
@@ -52,7 +53,11 @@ public:
 
     void addwash(int propid, float ratio);
 
-    void updateForces();
+    /// Batched force evaluation, see `Actor::CalcAircraftForces()`:
+    /// gathers wing geometry and queues the polar lookup into `slot`; returns false if the wing produces no force.
+    bool prepareForces(AirfoilQueryBatch& batch, size_t slot);
+    /// Applies lift/drag/moment using the coefficients which `Airfoil::getparamsBatch()` wrote into `slot`.
+    void applyForces(AirfoilQueryBatch const& batch, size_t slot);
 
     float aoa;
     char type;
@@ -128,6 +133,13 @@ private:
     bool idLeft;
 
     Airfoil* airfoil;
+    // Intermediates carried from `prepareForces()` to `applyForces()`
+    Ogre::Vector3 m_force_wind = Ogre::Vector3::ZERO;
+    Ogre::Vector3 m_force_liftv = Ogre::Vector3::ZERO;
+    Ogre::Vector3 m_force_normv = Ogre::Vector3::ZERO;
+    float m_force_wspeed = 0.f;
+    float m_force_chord = 0.f;
+    float m_force_surface = 0.f;
     AeroEngine** aeroengines;
     int free_wash;
     int washpropnum[MAX_AEROENGINES];
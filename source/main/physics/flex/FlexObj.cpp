@@ -73,6 +73,8 @@ FlexObj::FlexObj(RoR::GfxActor* gfx_actor, node_t* all_nodes, std::vector<CabTex
         m_indices[i]=ComputeVertexPos(static_cast<int>(i/3), triangles[i], submesh_defs);
     }
 
+    this->BuildVertexAdjacency();
+
     m_s_ref=(float*)malloc(numtriangles*sizeof(float));
 
     for (size_t i=0; i<(unsigned int)numtriangles;i++)
@@ -83,7 +85,7 @@ FlexObj::FlexObj(RoR::GfxActor* gfx_actor, node_t* all_nodes, std::vector<CabTex
         m_s_ref[i]=v1.crossProduct(v2).length()*2.0;
     }
 
-    this->UpdateMesh(); // Initialize the dynamic mesh
+    this->UpdateMesh(m_vertices); // Initialize the dynamic mesh
 
     // Create vertex data structure for vertices shared between submeshes
     m_mesh->sharedVertexData = new VertexData();
@@ -183,55 +185,124 @@ int FlexObj::ComputeVertexPos(int tidx, int v, std::vector<CabSubmesh>& submeshe
     return 0;
 }
 
-Vector3 FlexObj::UpdateMesh()
+void FlexObj::BuildVertexAdjacency()
+{
+    // Count triangles per vertex, prefix-sum into offsets, then scatter triangle indices.
+    m_vert_tri_start.assign(m_vertex_count + 1, 0);
+    for (size_t i=0; i<m_index_count; i++)
+    {
+        m_vert_tri_start[m_indices[i] + 1]++;
+    }
+    for (size_t i=0; i<m_vertex_count; i++)
+    {
+        m_vert_tri_start[i + 1] += m_vert_tri_start[i];
+    }
+
+    m_vert_tri_list.resize(m_index_count);
+    std::vector<int> fill(m_vert_tri_start.begin(), m_vert_tri_start.end() - 1);
+    for (size_t i=0; i<m_index_count; i++)
+    {
+        m_vert_tri_list[fill[m_indices[i]]++] = static_cast<int>(i/3);
+    }
+
+    m_pos_x.resize(m_vertex_count);
+    m_pos_y.resize(m_vertex_count);
+    m_pos_z.resize(m_vertex_count);
+    m_tri_nx.resize(m_triangle_count);
+    m_tri_ny.resize(m_triangle_count);
+    m_tri_nz.resize(m_triangle_count);
+    m_large_tris.reserve(m_triangle_count);
+}
+
+Vector3 FlexObj::UpdateMesh(FlexObjVertex* dst)
 {
     RoR::NodeSB* all_nodes = m_gfx_actor->GetSimNodeBuffer();
     Ogre::Vector3 center=(all_nodes[m_vertex_nodes[0]].AbsPosition+all_nodes[m_vertex_nodes[1]].AbsPosition)/2.0;
+
+    float* px = m_pos_x.data();
+    float* py = m_pos_y.data();
+    float* pz = m_pos_z.data();
+    float* nx = m_tri_nx.data();
+    float* ny = m_tri_ny.data();
+    float* nz = m_tri_nz.data();
+    const unsigned short* idx = m_indices;
+
+    //set position
     for (size_t i=0; i<m_vertex_count; i++)
     {
-        //set position
-        m_vertices[i].position=all_nodes[m_vertex_nodes[i]].AbsPosition-center;
-        //reset normals
-        m_vertices[i].normal=Vector3::ZERO;
+        const Ogre::Vector3& pos = all_nodes[m_vertex_nodes[i]].AbsPosition;
+        px[i] = pos.x - center.x;
+        py[i] = pos.y - center.y;
+        pz[i] = pos.z - center.z;
     }
-    //accumulate normals per triangle
-    for (size_t i=0; i<m_index_count/3; i++)
+
+    //triangle normals - no scatter, so the loop is free of dependencies
+    m_large_tris.clear();
+    for (int i=0; i<m_triangle_count; i++)
     {
-        Vector3 v1, v2;
-        v1=all_nodes[m_vertex_nodes[m_indices[i*3+1]]].AbsPosition-all_nodes[m_vertex_nodes[m_indices[i*3]]].AbsPosition;
-        v2=all_nodes[m_vertex_nodes[m_indices[i*3+2]]].AbsPosition-all_nodes[m_vertex_nodes[m_indices[i*3]]].AbsPosition;
-        v1=v1.crossProduct(v2);
-        float s=v1.length();
+        const int a = idx[i*3], b = idx[i*3+1], c = idx[i*3+2];
+        const float e1x = px[b] - px[a], e1y = py[b] - py[a], e1z = pz[b] - pz[a];
+        const float e2x = px[c] - px[a], e2y = py[c] - py[a], e2z = pz[c] - pz[a];
+        const float cx = e1y * e2z - e1z * e2y;
+        const float cy = e1z * e2x - e1x * e2z;
+        const float cz = e1x * e2y - e1y * e2x;
+        const float s = sqrtf(cx * cx + cy * cy + cz * cz);
+        const float inv_s = (s == 0.f) ? 0.f : (1.f / s);
+        nx[i] = cx * inv_s;
+        ny[i] = cy * inv_s;
+        nz[i] = cz * inv_s;
 
         //avoid large tris
-        if (s>m_s_ref[i])
+        if (s > m_s_ref[i])
         {
-            m_vertices[m_indices[i*3+1]].position=m_vertices[m_indices[i*3]].position+Vector3(0.1,0,0);
-            m_vertices[m_indices[i*3+2]].position=m_vertices[m_indices[i*3]].position+Vector3(0,0,0.1);
+            m_large_tris.push_back(i);
         }
+    }
 
-        if (s == 0)
-            continue;
-
-        v1=v1/s;
-        m_vertices[m_indices[i*3]].normal+=v1;
-        m_vertices[m_indices[i*3+1]].normal+=v1;
-        m_vertices[m_indices[i*3+2]].normal+=v1;
+    //collapse large tris; sequential since tris share vertices
+    for (int i: m_large_tris)
+    {
+        const int a = idx[i*3], b = idx[i*3+1], c = idx[i*3+2];
+        px[b] = px[a] + 0.1f; py[b] = py[a];        pz[b] = pz[a];
+        px[c] = px[a];        py[c] = py[a];        pz[c] = pz[a] + 0.1f;
     }
-    //normalize
-    for (size_t i=0; i<m_vertex_count; i++)
+
+    //gather normals per vertex via adjacency, normalize and write out
+    for (size_t v=0; v<m_vertex_count; v++)
     {
-        m_vertices[i].normal = approx_normalise(m_vertices[i].normal);
+        Ogre::Vector3 normal = Ogre::Vector3::ZERO;
+        for (int k = m_vert_tri_start[v]; k < m_vert_tri_start[v + 1]; k++)
+        {
+            const int t = m_vert_tri_list[k];
+            normal.x += nx[t];
+            normal.y += ny[t];
+            normal.z += nz[t];
+        }
+
+        dst[v].position = Ogre::Vector3(px[v], py[v], pz[v]);
+        dst[v].normal = approx_normalise(normal);
+        dst[v].texcoord = m_vertices[v].texcoord;
     }
 
     return center;
 }
 
-Vector3 FlexObj::UpdateFlexObj()
+void FlexObj::MapFlexObjBuffer()
 {
-    Ogre::Vector3 center = this->UpdateMesh();
-    m_hw_vbuf->writeData(0, m_hw_vbuf->getSizeInBytes(), m_vertices_raw, true);
-    return center;
+    ROR_ASSERT(m_mapped_vertices == nullptr);
+    m_mapped_vertices = static_cast<FlexObjVertex*>(m_hw_vbuf->lock(HardwareBuffer::HBL_DISCARD));
+}
+
+void FlexObj::ComputeFlexObj()
+{
+    m_mapped_center = this->UpdateMesh(m_mapped_vertices);
+}
+
+Vector3 FlexObj::UnmapFlexObjBuffer()
+{
+    m_hw_vbuf->unlock();
+    m_mapped_vertices = nullptr;
+    return m_mapped_center;
 }
 
 FlexObj::~FlexObj()
@@ -74,9 +74,13 @@ public:
 
     ~FlexObj();
 
-    Ogre::Vector3   UpdateFlexObj();
     void            ScaleFlexObj(float factor);
 
+    // Threaded update, see `GfxActor::UpdateCabMesh()`
+    void            MapFlexObjBuffer();   //!< Main thread; locks the hardware vertex buffer for writing
+    void            ComputeFlexObj();     //!< Worker thread; writes vertices straight into the locked buffer
+    Ogre::Vector3   UnmapFlexObjBuffer(); //!< Main thread; unlocks the buffer, returns mesh center
+
 private:
 
     struct FlexObjVertex
@@ -88,7 +92,8 @@ private:
 
     /// Compute vertex position in the vertexbuffer (0-based offset) for node `v` of triangle `tidx`
     int             ComputeVertexPos(int tidx, int v, std::vector<CabSubmesh>& submeshes);
-    Ogre::Vector3   UpdateMesh();
+    void            BuildVertexAdjacency();
+    Ogre::Vector3   UpdateMesh(FlexObjVertex* dst);
 
     Ogre::MeshPtr               m_mesh;
     std::vector<Ogre::SubMesh*> m_submeshes;
@@ -107,7 +112,18 @@ private:
 
     size_t                      m_index_count;
     unsigned short*             m_indices;
-    int                         m_triangle_count;	
+    int                         m_triangle_count;
+
+    // Vertex -> triangle adjacency (CSR), lets normals be gathered per vertex without write conflicts.
+    std::vector<int>            m_vert_tri_start; //!< Offsets into `m_vert_tri_list`, `m_vertex_count+1` entries
+    std::vector<int>            m_vert_tri_list;  //!< Triangle indices, grouped by vertex
+
+    // Per-update scratch, structure-of-arrays so the triangle pass vectorizes
+    std::vector<float>          m_pos_x, m_pos_y, m_pos_z;
+    std::vector<float>          m_tri_nx, m_tri_ny, m_tri_nz;
+    std::vector<int>            m_large_tris;
+    FlexObjVertex*              m_mapped_vertices = nullptr; //!< Locked hardware buffer, valid between Map/Unmap
+    Ogre::Vector3               m_mapped_center = Ogre::Vector3::ZERO;
 };
 
 /// @} // addtogroup Flex
@@ -60,13 +60,17 @@ Vector3 Buoyance::computePressureForceSub(Vector3 a, Vector3 b, Vector3 c, Vecto
         return Vector3::ZERO;
     normal = normal / surf; //normalize
     surf = surf / 2.0; //surface
+    //wave heights at the corners, for the pressure prism and the splashes
+    const Vector3 corners[3] = { a, b, c };
+    float wh[3];
+    App::GetGameContext()->GetTerrain()->getWater()->CalcWavesHeights(corners, wh, 3);
     float vol = 0.0;
     if (type != BUOY_DRAGONLY)
     {
         //compute pression prism points
-        Vector3 ap = a + (App::GetGameContext()->GetTerrain()->getWater()->CalcWavesHeight(a) - a.y) * 9810 * normal;
-        Vector3 bp = b + (App::GetGameContext()->GetTerrain()->getWater()->CalcWavesHeight(b) - b.y) * 9810 * normal;
-        Vector3 cp = c + (App::GetGameContext()->GetTerrain()->getWater()->CalcWavesHeight(c) - c.y) * 9810 * normal;
+        Vector3 ap = a + (wh[0] - a.y) * 9810 * normal;
+        Vector3 bp = b + (wh[1] - b.y) * 9810 * normal;
+        Vector3 cp = c + (wh[2] - c.y) * 9810 * normal;
         //find centroid
         Vector3 ctd = (a + b + c + ap + bp + cp) / 6.0;
         //compute volume
@@ -104,13 +108,13 @@ Vector3 Buoyance::computePressureForceSub(Vector3 a, Vector3 b, Vector3 c, Vecto
                     if (fxdir.y < 0)
                         fxdir.y = -fxdir.y;
 
-                    if (App::GetGameContext()->GetTerrain()->getWater()->CalcWavesHeight(a) - a.y < 0.1)
+                    if (wh[0] - a.y < 0.1)
                         splashp->malloc(a, fxdir);
 
-                    else if (App::GetGameContext()->GetTerrain()->getWater()->CalcWavesHeight(b) - b.y < 0.1)
+                    else if (wh[1] - b.y < 0.1)
                         splashp->malloc(b, fxdir);
 
-                    else if (App::GetGameContext()->GetTerrain()->getWater()->CalcWavesHeight(c) - c.y < 0.1)
+                    else if (wh[2] - c.y < 0.1)
                         splashp->malloc(c, fxdir);
                 }
             }
@@ -122,10 +126,9 @@ Vector3 Buoyance::computePressureForceSub(Vector3 a, Vector3 b, Vector3 c, Vecto
     return vol * normal + drg;
 }
 
-//compute pressure and drag forces on a random triangle
-Vector3 Buoyance::computePressureForce(Vector3 a, Vector3 b, Vector3 c, Vector3 vel, int type)
+//compute pressure and drag forces on a random triangle, wha = wave height at its center
+Vector3 Buoyance::computePressureForce(Vector3 a, Vector3 b, Vector3 c, Vector3 vel, int type, float wha)
 {
-    float wha = App::GetGameContext()->GetTerrain()->getWater()->CalcWavesHeight((a + b + c) / 3.0);
     //check if fully emerged
     if (a.y > wha && b.y > wha && c.y > wha)
         return Vector3::ZERO;
@@ -179,9 +182,14 @@ Vector3 Buoyance::computePressureForce(Vector3 a, Vector3 b, Vector3 c, Vector3
 
 void Buoyance::computeNodeForce(node_t* a, node_t* b, node_t* c, bool doUpdate, int type)
 {
-    if (a->AbsPosition.y > App::GetGameContext()->GetTerrain()->getWater()->CalcWavesHeight(a->AbsPosition) &&
-        b->AbsPosition.y > App::GetGameContext()->GetTerrain()->getWater()->CalcWavesHeight(b->AbsPosition) &&
-        c->AbsPosition.y > App::GetGameContext()->GetTerrain()->getWater()->CalcWavesHeight(c->AbsPosition))
+    IWater* water = App::GetGameContext()->GetTerrain()->getWater();
+
+    const Vector3 nodes[3] = { a->AbsPosition, b->AbsPosition, c->AbsPosition };
+    float wh[6];
+    water->CalcWavesHeights(nodes, wh, 3);
+    if (a->AbsPosition.y > wh[0] &&
+        b->AbsPosition.y > wh[1] &&
+        c->AbsPosition.y > wh[2])
         return;
 
     update = doUpdate;
@@ -205,8 +213,15 @@ void Buoyance::computeNodeForce(node_t* a, node_t* b, node_t* c, bool doUpdate,
     Vector3 mca = (c->AbsPosition + a->AbsPosition) / 2.0;
     Vector3 vel = (a->Velocity + b->Velocity + c->Velocity) / 3.0;
 
+    //wave heights at the centers of the 6 sub-triangles
+    const Vector3 centers[6] = {
+        (a->AbsPosition + mab + m) / 3.0, (a->AbsPosition + m + mca) / 3.0,
+        (b->AbsPosition + mbc + m) / 3.0, (b->AbsPosition + m + mab) / 3.0,
+        (c->AbsPosition + mca + m) / 3.0, (c->AbsPosition + m + mbc) / 3.0 };
+    water->CalcWavesHeights(centers, wh, 6);
+
     //apply forces
-    a->Forces += computePressureForce(a->AbsPosition, mab, m, vel, type) + computePressureForce(a->AbsPosition, m, mca, vel, type);
-    b->Forces += computePressureForce(b->AbsPosition, mbc, m, vel, type) + computePressureForce(b->AbsPosition, m, mab, vel, type);
-    c->Forces += computePressureForce(c->AbsPosition, mca, m, vel, type) + computePressureForce(c->AbsPosition, m, mbc, vel, type);
+    a->Forces += computePressureForce(a->AbsPosition, mab, m, vel, type, wh[0]) + computePressureForce(a->AbsPosition, m, mca, vel, type, wh[1]);
+    b->Forces += computePressureForce(b->AbsPosition, mbc, m, vel, type, wh[2]) + computePressureForce(b->AbsPosition, m, mab, vel, type, wh[3]);
+    c->Forces += computePressureForce(c->AbsPosition, mca, m, vel, type, wh[4]) + computePressureForce(c->AbsPosition, m, mbc, vel, type, wh[5]);
 }
@@ -48,8 +48,8 @@ private:
     //compute pressure and drag force on a submerged triangle
     Ogre::Vector3 computePressureForceSub(Ogre::Vector3 a, Ogre::Vector3 b, Ogre::Vector3 c, Ogre::Vector3 vel, int type);
     
-    //compute pressure and drag forces on a random triangle
-    Ogre::Vector3 computePressureForce(Ogre::Vector3 a, Ogre::Vector3 b, Ogre::Vector3 c, Ogre::Vector3 vel, int type);
+    //compute pressure and drag forces on a random triangle, wha = wave height at its center
+    Ogre::Vector3 computePressureForce(Ogre::Vector3 a, Ogre::Vector3 b, Ogre::Vector3 c, Ogre::Vector3 vel, int type, float wha);
     
     DustPool *splashp, *ripplep;
     bool update;
@@ -37,6 +37,7 @@
 #include "GfxScene.h"
 #include "Language.h"
 #include "PlatformUtils.h"
+#include "RigDef_BinaryCache.h"
 #include "RigDef_Parser.h"
 
 #include "SkinFileFormat.h"
@@ -706,17 +707,23 @@ void CacheSystem::AddFile(String group, Ogre::FileInfo f, String ext)
 
 void CacheSystem::FillTruckDetailInfo(CacheEntry& entry, Ogre::DataStreamPtr stream, String file_name, String group)
 {
-    /* LOAD AND PARSE THE VEHICLE */
-    RigDef::Parser parser;
-    parser.Prepare();
-    parser.ProcessOgreStream(stream.getPointer(), group);
-    parser.GetSequentialImporter()->Disable();
-    parser.Finalize();
+    /* LOAD AND PARSE THE VEHICLE - unless it was already compiled; compile it for the spawn otherwise */
+    const std::string hash = Sha1Hash(stream->getAsString());
+    RigDef::DocumentPtr def = RigDef::BinaryCache::Load(hash);
+    if (!def)
+    {
+        stream->seek(0);
+        RigDef::Parser parser;
+        parser.Prepare();
+        parser.ProcessOgreStream(stream.getPointer(), group);
+        parser.Finalize(); // With the sequential importer, like `ActorManager::FetchActorDef()`
+        def = parser.GetFile();
+        def->hash = hash;
+        RigDef::BinaryCache::Save(def);
+    }
 
     /* RETRIEVE DATA */
 
-    RigDef::DocumentPtr def = parser.GetFile();
-
     /* Name */
     if (!def->name.empty())
     {
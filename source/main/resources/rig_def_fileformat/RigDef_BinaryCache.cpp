@@ -0,0 +1,850 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "RigDef_BinaryCache.h"
+
+#include "Application.h"
+#include "PlatformUtils.h"
+#include "RigDef_File.h"
+#include "Utils.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+
+using namespace RoR;
+
+namespace RigDef
+{
+
+const char* BinaryCache::SIGNATURE = "RoRTruckBin";
+
+namespace {
+
+// --------------------------------------------------------------------------
+//  Archives: the same `DocumentIo::Io()` code both writes and reads the data,
+//  so the two directions can't get out of sync.
+// --------------------------------------------------------------------------
+
+class BinaryWriter
+{
+public:
+    static const bool IS_READING = false;
+
+    template <typename T> void Raw(T& value)
+    {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        m_buffer.insert(m_buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    size_t Count(size_t count)
+    {
+        uint32_t value = static_cast<uint32_t>(count);
+        this->Raw(value);
+        return count;
+    }
+
+    void String(std::string& str)
+    {
+        this->Count(str.size());
+        m_buffer.insert(m_buffer.end(), str.begin(), str.end());
+    }
+
+    /// Writes the object ID; returns true on first occurrence, when the object data must follow.
+    template <typename T> bool SharedRef(std::shared_ptr<T>& ptr)
+    {
+        uint32_t id = 0;
+        if (!ptr)
+        {
+            this->Raw(id);
+            return false;
+        }
+        auto result = m_shared_ids.insert(std::make_pair(static_cast<const void*>(ptr.get()), static_cast<uint32_t>(m_shared_ids.size() + 1)));
+        id = result.first->second;
+        this->Raw(id);
+        return result.second;
+    }
+
+    std::vector<char> const& GetBuffer() const { return m_buffer; }
+
+private:
+    std::vector<char>               m_buffer;
+    std::map<const void*, uint32_t> m_shared_ids;
+};
+
+class BinaryReader
+{
+public:
+    static const bool IS_READING = true;
+
+    BinaryReader(const char* data, size_t size): m_data(data), m_size(size) {}
+
+    template <typename T> void Raw(T& value)
+    {
+        if (sizeof(T) > m_size - m_pos)
+        {
+            throw std::runtime_error("unexpected end of file");
+        }
+        std::memcpy(&value, m_data + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+    }
+
+    size_t Count(size_t /*unused*/)
+    {
+        uint32_t value = 0;
+        this->Raw(value);
+        if (value > m_size - m_pos) // Every element takes at least 1 byte
+        {
+            throw std::runtime_error("invalid element count");
+        }
+        return value;
+    }
+
+    void String(std::string& str)
+    {
+        const size_t length = this->Count(0);
+        str.assign(m_data + m_pos, length);
+        m_pos += length;
+    }
+
+    /// Reads the object ID; returns true on first occurrence, when the object data follows.
+    template <typename T> bool SharedRef(std::shared_ptr<T>& ptr)
+    {
+        uint32_t id = 0;
+        this->Raw(id);
+        if (id == 0)
+        {
+            ptr.reset();
+            return false;
+        }
+        if (id <= m_shared_objects.size())
+        {
+            ptr = std::static_pointer_cast<T>(m_shared_objects[id - 1]);
+            return false;
+        }
+        if (id != m_shared_objects.size() + 1)
+        {
+            throw std::runtime_error("invalid shared object ID");
+        }
+        ptr = std::make_shared<T>();
+        m_shared_objects.push_back(ptr);
+        return true;
+    }
+
+    bool IsAtEnd() const { return m_pos == m_size; }
+
+private:
+    const char*                        m_data;
+    size_t                             m_size;
+    size_t                             m_pos = 0;
+    std::vector<std::shared_ptr<void>> m_shared_objects;
+};
+
+// --------------------------------------------------------------------------
+//  Document layout; every field of every struct in RigDef_File.h, in declaration order.
+//  Any change to the `Io()` functions below must bump `BinaryCache::FORMAT_VERSION`:
+//  `CalcLayoutHash()` only sees struct sizes, not what is written or in which order.
+// --------------------------------------------------------------------------
+
+template <class Archive> class DocumentIo: public Archive
+{
+public:
+    template <typename... Args> DocumentIo(Args&&... args): Archive(std::forward<Args>(args)...) {}
+
+    // Generic
+
+    template <typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type
+    Io(T& value) { this->Raw(value); }
+
+    void Io(std::string& str) { this->String(str); }
+
+    template <typename T, size_t N> void Io(T (&array)[N])
+    {
+        for (size_t i = 0; i < N; ++i) { this->Io(array[i]); }
+    }
+
+    template <typename T> void Io(std::vector<T>& vec)
+    {
+        vec.resize(this->Count(vec.size()));
+        for (T& elem: vec) { this->Io(elem); }
+    }
+
+    template <typename T> void Io(std::list<T>& list)
+    {
+        list.resize(this->Count(list.size()));
+        for (T& elem: list) { this->Io(elem); }
+    }
+
+    template <typename T> void Io(std::shared_ptr<T>& ptr)
+    {
+        if (this->SharedRef(ptr)) { this->Io(*ptr); }
+    }
+
+    void Io(Ogre::Vector3& v)     { this->Io(v.x); this->Io(v.y); this->Io(v.z); }
+    void Io(Ogre::ColourValue& c) { this->Io(c.r); this->Io(c.g); this->Io(c.b); this->Io(c.a); }
+
+    // Nodes
+
+    void Io(Node::Id& id)
+    {
+        uint8_t type = id.IsTypeNamed() ? 2 : (id.IsTypeNumbered() ? 1 : 0);
+        unsigned int num = id.Num();
+        std::string str = id.Str();
+        this->Io(type); this->Io(num); this->Io(str);
+        if (Archive::IS_READING)
+        {
+            if      (type == 1) { id.SetNum(num); }
+            else if (type == 2) { id.setStr(str); }
+            else                { id.Invalidate(); }
+        }
+    }
+
+    void Io(Node::Ref& ref)
+    {
+        std::string str = ref.Str();
+        unsigned int num = ref.Num();
+        unsigned int flags = ref.GetFlags();
+        unsigned int line_number = ref.GetLineNumber();
+        this->Io(str); this->Io(num); this->Io(flags); this->Io(line_number);
+        if (Archive::IS_READING)
+        {
+            ref = Node::Ref(str, num, flags, line_number);
+        }
+    }
+
+    void Io(Node::Range& range) { this->Io(range.start); this->Io(range.end); }
+
+    void Io(std::vector<Node::Range>& vec) // `Node::Range` has no default constructor
+    {
+        vec.resize(this->Count(vec.size()), Node::Range(Node::Ref()));
+        for (Node::Range& elem: vec) { this->Io(elem); }
+    }
+
+    void Io(Node& d)
+    {
+        this->Io(d.id); this->Io(d.position); this->Io(d.options); this->Io(d.load_weight_override);
+        this->Io(d._has_load_weight_override); this->Io(d.node_defaults); this->Io(d.default_minimass);
+        this->Io(d.beam_defaults); this->Io(d.detacher_group);
+    }
+
+    // Shared/helper data
+
+    void Io(AeroAnimator& d) { this->Io(d.flags); this->Io(d.engine_idx); }
+
+    void Io(BaseWheel& d)
+    {
+        this->Io(d.width); this->Io(d.num_rays); this->Io(d.nodes); this->Io(d.rigidity_node);
+        this->Io(d.braking); this->Io(d.propulsion); this->Io(d.reference_arm_node); this->Io(d.mass);
+        this->Io(d.node_defaults); this->Io(d.beam_defaults);
+    }
+
+    void Io(BaseMeshWheel& d)
+    {
+        this->Io(static_cast<BaseWheel&>(d));
+        this->Io(d.side); this->Io(d.mesh_name); this->Io(d.material_name); this->Io(d.rim_radius);
+        this->Io(d.tyre_radius); this->Io(d.spring); this->Io(d.damping);
+    }
+
+    void Io(BaseWheel2& d)
+    {
+        this->Io(static_cast<BaseWheel&>(d));
+        this->Io(d.rim_radius); this->Io(d.tyre_radius); this->Io(d.tyre_springiness); this->Io(d.tyre_damping);
+    }
+
+    void Io(Inertia& d)
+    {
+        this->Io(d.start_delay_factor); this->Io(d.stop_delay_factor); this->Io(d.start_function); this->Io(d.stop_function);
+    }
+
+    void Io(BeamDefaultsScale& d)
+    {
+        this->Io(d.springiness); this->Io(d.damping_constant); this->Io(d.deformation_threshold_constant);
+        this->Io(d.breaking_threshold_constant);
+    }
+
+    void Io(BeamDefaults& d)
+    {
+        this->Io(d.springiness); this->Io(d.damping_constant); this->Io(d.deformation_threshold);
+        this->Io(d.breaking_threshold); this->Io(d.visual_beam_diameter); this->Io(d.beam_material_name);
+        this->Io(d.plastic_deform_coef); this->Io(d._enable_advanced_deformation);
+        this->Io(d._is_plastic_deform_coef_user_defined); this->Io(d._is_user_defined); this->Io(d.scale);
+    }
+
+    void Io(NodeDefaults& d)
+    {
+        this->Io(d.load_weight); this->Io(d.friction); this->Io(d.volume); this->Io(d.surface); this->Io(d.options);
+    }
+
+    void Io(DefaultMinimass& d) { this->Io(d.min_mass_Kg); }
+
+    void Io(CameraSettings& d) { this->Io(d.mode); }
+
+    void Io(Animation::MotorSource& d) { this->Io(d.source); this->Io(d.motor); }
+
+    void Io(Animation& d)
+    {
+        this->Io(d.ratio); this->Io(d.lower_limit); this->Io(d.upper_limit); this->Io(d.source);
+        this->Io(d.motor_sources); this->Io(d.mode); this->Io(d.event_name);
+    }
+
+    // Elements
+
+    void Io(Airbrake& d)
+    {
+        this->Io(d.reference_node); this->Io(d.x_axis_node); this->Io(d.y_axis_node); this->Io(d.aditional_node);
+        this->Io(d.offset); this->Io(d.width); this->Io(d.height); this->Io(d.max_inclination_angle);
+        this->Io(d.texcoord_x1); this->Io(d.texcoord_x2); this->Io(d.texcoord_y1); this->Io(d.texcoord_y2);
+        this->Io(d.lift_coefficient);
+    }
+
+    void Io(Animator& d)
+    {
+        this->Io(d.nodes); this->Io(d.lenghtening_factor); this->Io(d.flags); this->Io(d.short_limit);
+        this->Io(d.long_limit); this->Io(d.aero_animator); this->Io(d.inertia_defaults); this->Io(d.beam_defaults);
+        this->Io(d.detacher_group);
+    }
+
+    void Io(AntiLockBrakes& d)
+    {
+        this->Io(d.regulation_force); this->Io(d.min_speed); this->Io(d.pulse_per_sec); this->Io(d.attr_is_on);
+        this->Io(d.attr_no_dashboard); this->Io(d.attr_no_toggle);
+    }
+
+    void Io(Author& d)
+    {
+        this->Io(d.type); this->Io(d.forum_account_id); this->Io(d.name); this->Io(d.email); this->Io(d._has_forum_account);
+    }
+
+    void Io(Axle& d) { this->Io(d.wheels); this->Io(d.options); }
+
+    void Io(Beam& d)
+    {
+        this->Io(d.nodes); this->Io(d.options); this->Io(d.extension_break_limit); this->Io(d._has_extension_break_limit);
+        this->Io(d.detacher_group); this->Io(d.defaults);
+    }
+
+    void Io(Brakes& d) { this->Io(d.default_braking_force); this->Io(d.parking_brake_force); }
+
+    void Io(Cab& d) { this->Io(d.nodes); this->Io(d.options); }
+
+    void Io(Camera& d) { this->Io(d.center_node); this->Io(d.back_node); this->Io(d.left_node); }
+
+    void Io(CameraRail& d) { this->Io(d.nodes); }
+
+    void Io(Cinecam& d)
+    {
+        this->Io(d.position); this->Io(d.nodes); this->Io(d.spring); this->Io(d.damping); this->Io(d.node_mass);
+        this->Io(d.beam_defaults); this->Io(d.node_defaults);
+    }
+
+    void Io(CollisionBox& d) { this->Io(d.nodes); }
+
+    void Io(CollisionRange& d) { this->Io(d.node_collision_range); }
+
+    void Io(Command2& d)
+    {
+        this->Io(d.nodes); this->Io(d.shorten_rate); this->Io(d.lengthen_rate); this->Io(d.max_contraction);
+        this->Io(d.max_extension); this->Io(d.contract_key); this->Io(d.extend_key); this->Io(d.description);
+        this->Io(d.inertia); this->Io(d.affect_engine); this->Io(d.needs_engine); this->Io(d.plays_sound);
+        this->Io(d.beam_defaults); this->Io(d.inertia_defaults); this->Io(d.detacher_group);
+        this->Io(d.option_i_invisible); this->Io(d.option_r_rope); this->Io(d.option_c_auto_center);
+        this->Io(d.option_f_not_faster); this->Io(d.option_p_1press); this->Io(d.option_o_1press_center);
+    }
+
+    void Io(CruiseControl& d) { this->Io(d.min_speed); this->Io(d.autobrake); }
+
+    void Io(DefaultSkin& d) { this->Io(d.skin_name); }
+
+    void Io(Engine& d)
+    {
+        this->Io(d.shift_down_rpm); this->Io(d.shift_up_rpm); this->Io(d.torque); this->Io(d.global_gear_ratio);
+        this->Io(d.reverse_gear_ratio); this->Io(d.neutral_gear_ratio); this->Io(d.gear_ratios);
+    }
+
+    void Io(Engoption& d)
+    {
+        this->Io(d.inertia); this->Io(d.type); this->Io(d.clutch_force); this->Io(d.shift_time); this->Io(d.clutch_time);
+        this->Io(d.post_shift_time); this->Io(d.idle_rpm); this->Io(d.stall_rpm); this->Io(d.max_idle_mixture);
+        this->Io(d.min_idle_mixture); this->Io(d.braking_torque);
+    }
+
+    void Io(Engturbo& d)
+    {
+        this->Io(d.version); this->Io(d.tinertiaFactor); this->Io(d.nturbos);
+        this->Io(d.param1); this->Io(d.param2); this->Io(d.param3); this->Io(d.param4); this->Io(d.param5); this->Io(d.param6);
+        this->Io(d.param7); this->Io(d.param8); this->Io(d.param9); this->Io(d.param10); this->Io(d.param11);
+    }
+
+    void Io(Exhaust& d) { this->Io(d.reference_node); this->Io(d.direction_node); this->Io(d.particle_name); }
+
+    void Io(ExtCamera& d) { this->Io(d.mode); this->Io(d.node); }
+
+    void Io(FileFormatVersion& d) { this->Io(d.version); }
+
+    void Io(Fileinfo& d) { this->Io(d.unique_id); this->Io(d.category_id); this->Io(d.file_version); }
+
+    void Io(Flare2& d)
+    {
+        this->Io(d.reference_node); this->Io(d.node_axis_x); this->Io(d.node_axis_y); this->Io(d.offset); this->Io(d.type);
+        this->Io(d.control_number); this->Io(d.dashboard_link); this->Io(d.blink_delay_milis); this->Io(d.size);
+        this->Io(d.material_name);
+    }
+
+    void Io(Flare3& d) { this->Io(static_cast<Flare2&>(d)); this->Io(d.inertia_defaults); }
+
+    void Io(Flexbody& d)
+    {
+        this->Io(d.reference_node); this->Io(d.x_axis_node); this->Io(d.y_axis_node); this->Io(d.offset);
+        this->Io(d.rotation); this->Io(d.mesh_name); this->Io(d.animations); this->Io(d.node_list_to_import);
+        this->Io(d.node_list); this->Io(d.camera_settings);
+    }
+
+    void Io(FlexBodyWheel& d)
+    {
+        this->Io(static_cast<BaseWheel2&>(d));
+        this->Io(d.side); this->Io(d.rim_springiness); this->Io(d.rim_damping); this->Io(d.rim_mesh_name); this->Io(d.tyre_mesh_name);
+    }
+
+    void Io(Fusedrag& d)
+    {
+        this->Io(d.autocalc); this->Io(d.front_node); this->Io(d.rear_node); this->Io(d.approximate_width);
+        this->Io(d.airfoil_name); this->Io(d.area_coefficient);
+    }
+
+    void Io(Globals& d) { this->Io(d.dry_mass); this->Io(d.cargo_mass); this->Io(d.material_name); }
+
+    void Io(Guid& d) { this->Io(d.guid); }
+
+    void Io(GuiSettings& d) { this->Io(d.key); this->Io(d.value); }
+
+    void Io(Help& d) { this->Io(d.material); }
+
+    void Io(Hook& d)
+    {
+        this->Io(d.node); this->Io(d.option_hook_range); this->Io(d.option_speed_coef); this->Io(d.option_max_force);
+        this->Io(d.option_hookgroup); this->Io(d.option_lockgroup); this->Io(d.option_timer); this->Io(d.option_min_range_meters);
+        // Bit fields can't be bound to references
+        bool self_lock = d.flag_self_lock, auto_lock = d.flag_auto_lock, no_disable = d.flag_no_disable,
+             no_rope = d.flag_no_rope, visible = d.flag_visible;
+        this->Io(self_lock); this->Io(auto_lock); this->Io(no_disable); this->Io(no_rope); this->Io(visible);
+        d.flag_self_lock = self_lock; d.flag_auto_lock = auto_lock; d.flag_no_disable = no_disable;
+        d.flag_no_rope = no_rope; d.flag_visible = visible;
+    }
+
+    void Io(Hydro& d)
+    {
+        this->Io(d.nodes); this->Io(d.lenghtening_factor); this->Io(d.options); this->Io(d.inertia);
+        this->Io(d.inertia_defaults); this->Io(d.beam_defaults); this->Io(d.detacher_group);
+    }
+
+    void Io(InterAxle& d) { this->Io(d.a1); this->Io(d.a2); this->Io(d.options); }
+
+    void Io(Lockgroup& d) { this->Io(d.number); this->Io(d.nodes); }
+
+    void Io(ManagedMaterialsOptions& d) { this->Io(d.double_sided); }
+
+    void Io(ManagedMaterial& d)
+    {
+        this->Io(d.name); this->Io(d.type); this->Io(d.options); this->Io(d.diffuse_map);
+        this->Io(d.damaged_diffuse_map); this->Io(d.specular_map);
+    }
+
+    void Io(MaterialFlareBinding& d) { this->Io(d.flare_number); this->Io(d.material_name); }
+
+    void Io(Minimass& d) { this->Io(d.global_min_mass_Kg); this->Io(d.option); }
+
+    void Io(MeshWheel& d)  { this->Io(static_cast<BaseMeshWheel&>(d)); }
+
+    void Io(MeshWheel2& d) { this->Io(static_cast<BaseMeshWheel&>(d)); }
+
+    void Io(Particle& d) { this->Io(d.emitter_node); this->Io(d.reference_node); this->Io(d.particle_system_name); }
+
+    void Io(Pistonprop& d)
+    {
+        this->Io(d.reference_node); this->Io(d.axis_node); this->Io(d.blade_tip_nodes); this->Io(d.couple_node);
+        this->Io(d.turbine_power_kW); this->Io(d.pitch); this->Io(d.airfoil);
+    }
+
+    void Io(Prop::DashboardSpecial& d)
+    {
+        this->Io(d.offset); this->Io(d._offset_is_set); this->Io(d.rotation_angle); this->Io(d.mesh_name);
+    }
+
+    void Io(Prop::BeaconSpecial& d) { this->Io(d.flare_material_name); this->Io(d.color); }
+
+    void Io(Prop& d)
+    {
+        this->Io(d.reference_node); this->Io(d.x_axis_node); this->Io(d.y_axis_node); this->Io(d.offset);
+        this->Io(d.rotation); this->Io(d.mesh_name); this->Io(d.animations); this->Io(d.camera_settings);
+        this->Io(d.special); this->Io(d.special_prop_beacon); this->Io(d.special_prop_dashboard);
+    }
+
+    void Io(RailGroup& d) { this->Io(d.id); this->Io(d.node_list); }
+
+    void Io(Ropable& d) { this->Io(d.node); this->Io(d.group); this->Io(d.has_multilock); }
+
+    void Io(Rope& d)
+    {
+        this->Io(d.root_node); this->Io(d.end_node); this->Io(d.invisible); this->Io(d.beam_defaults); this->Io(d.detacher_group);
+    }
+
+    void Io(Rotator& d)
+    {
+        this->Io(d.axis_nodes); this->Io(d.base_plate_nodes); this->Io(d.rotating_plate_nodes); this->Io(d.rate);
+        this->Io(d.spin_left_key); this->Io(d.spin_right_key); this->Io(d.inertia); this->Io(d.inertia_defaults);
+        this->Io(d.engine_coupling); this->Io(d.needs_engine);
+    }
+
+    void Io(Rotator2& d)
+    {
+        this->Io(static_cast<Rotator&>(d));
+        this->Io(d.rotating_force); this->Io(d.tolerance); this->Io(d.description);
+    }
+
+    void Io(Screwprop& d) { this->Io(d.prop_node); this->Io(d.back_node); this->Io(d.top_node); this->Io(d.power); }
+
+    void Io(Script& d) { this->Io(d.filename); }
+
+    void Io(Shock& d)
+    {
+        this->Io(d.nodes); this->Io(d.spring_rate); this->Io(d.damping); this->Io(d.short_bound); this->Io(d.long_bound);
+        this->Io(d.precompression); this->Io(d.options); this->Io(d.beam_defaults); this->Io(d.detacher_group);
+    }
+
+    void Io(Shock2& d)
+    {
+        this->Io(d.nodes); this->Io(d.spring_in); this->Io(d.damp_in); this->Io(d.progress_factor_spring_in);
+        this->Io(d.progress_factor_damp_in); this->Io(d.spring_out); this->Io(d.damp_out);
+        this->Io(d.progress_factor_spring_out); this->Io(d.progress_factor_damp_out); this->Io(d.short_bound);
+        this->Io(d.long_bound); this->Io(d.precompression); this->Io(d.options); this->Io(d.beam_defaults);
+        this->Io(d.detacher_group);
+    }
+
+    void Io(Shock3& d)
+    {
+        this->Io(d.nodes); this->Io(d.spring_in); this->Io(d.damp_in); this->Io(d.spring_out); this->Io(d.damp_out);
+        this->Io(d.damp_in_slow); this->Io(d.split_vel_in); this->Io(d.damp_in_fast); this->Io(d.damp_out_slow);
+        this->Io(d.split_vel_out); this->Io(d.damp_out_fast); this->Io(d.short_bound); this->Io(d.long_bound);
+        this->Io(d.precompression); this->Io(d.options); this->Io(d.beam_defaults); this->Io(d.detacher_group);
+    }
+
+    void Io(SkeletonSettings& d) { this->Io(d.visibility_range_meters); this->Io(d.beam_thickness_meters); }
+
+    void Io(SlideNode& d)
+    {
+        this->Io(d.slide_node); this->Io(d.rail_node_ranges); this->Io(d.constraint_flags);
+        this->Io(d.spring_rate);     this->Io(d._spring_rate_set);
+        this->Io(d.break_force);     this->Io(d._break_force_set);
+        this->Io(d.tolerance);       this->Io(d._tolerance_set);
+        this->Io(d.attachment_rate); this->Io(d._attachment_rate_set);
+        this->Io(d.railgroup_id);    this->Io(d._railgroup_id_set);
+        this->Io(d.max_attach_dist); this->Io(d._max_attach_dist_set);
+    }
+
+    void Io(SoundSource& d) { this->Io(d.node); this->Io(d.sound_script_name); }
+
+    void Io(SoundSource2& d) { this->Io(static_cast<SoundSource&>(d)); this->Io(d.mode); }
+
+    void Io(SpeedLimiter& d) { this->Io(d.max_speed); this->Io(d.is_enabled); }
+
+    void Io(Submesh& d) { this->Io(d.backmesh); this->Io(d.texcoords); this->Io(d.cab_triangles); }
+
+    void Io(Texcoord& d) { this->Io(d.node); this->Io(d.u); this->Io(d.v); }
+
+    void Io(Tie& d)
+    {
+        this->Io(d.root_node); this->Io(d.max_reach_length); this->Io(d.auto_shorten_rate); this->Io(d.min_length);
+        this->Io(d.max_length); this->Io(d.options); this->Io(d.max_stress); this->Io(d.beam_defaults);
+        this->Io(d.detacher_group); this->Io(d.group);
+    }
+
+    void Io(TorqueCurve::Sample& d) { this->Io(d.power); this->Io(d.torque_percent); }
+
+    void Io(TorqueCurve& d) { this->Io(d.samples); this->Io(d.predefined_func_name); }
+
+    void Io(TractionControl& d)
+    {
+        this->Io(d.regulation_force); this->Io(d.wheel_slip); this->Io(d.fade_speed); this->Io(d.pulse_per_sec);
+        this->Io(d.attr_is_on); this->Io(d.attr_no_dashboard); this->Io(d.attr_no_toggle);
+    }
+
+    void Io(TransferCase& d)
+    {
+        this->Io(d.a1); this->Io(d.a2); this->Io(d.has_2wd); this->Io(d.has_2wd_lo); this->Io(d.gear_ratios);
+    }
+
+    void Io(Trigger& d)
+    {
+        this->Io(d.nodes); this->Io(d.contraction_trigger_limit); this->Io(d.expansion_trigger_limit);
+        this->Io(d.options); this->Io(d.boundary_timer); this->Io(d.beam_defaults); this->Io(d.detacher_group);
+        this->Io(d.shortbound_trigger_action); this->Io(d.longbound_trigger_action);
+    }
+
+    void Io(Turbojet& d)
+    {
+        this->Io(d.front_node); this->Io(d.back_node); this->Io(d.side_node); this->Io(d.is_reversable);
+        this->Io(d.dry_thrust); this->Io(d.wet_thrust); this->Io(d.front_diameter); this->Io(d.back_diameter);
+        this->Io(d.nozzle_length);
+    }
+
+    void Io(Turboprop2& d)
+    {
+        this->Io(d.reference_node); this->Io(d.axis_node); this->Io(d.blade_tip_nodes); this->Io(d.turbine_power_kW);
+        this->Io(d.airfoil); this->Io(d.couple_node);
+    }
+
+    void Io(VideoCamera& d)
+    {
+        this->Io(d.reference_node); this->Io(d.left_node); this->Io(d.bottom_node); this->Io(d.alt_reference_node);
+        this->Io(d.alt_orientation_node); this->Io(d.offset); this->Io(d.rotation); this->Io(d.field_of_view);
+        this->Io(d.texture_width); this->Io(d.texture_height); this->Io(d.min_clip_distance);
+        this->Io(d.max_clip_distance); this->Io(d.camera_role); this->Io(d.camera_mode); this->Io(d.material_name);
+        this->Io(d.camera_name);
+    }
+
+    void Io(Wheel& d)
+    {
+        this->Io(static_cast<BaseWheel&>(d));
+        this->Io(d.radius); this->Io(d.springiness); this->Io(d.damping); this->Io(d.face_material_name);
+        this->Io(d.band_material_name);
+    }
+
+    void Io(Wheel2& d)
+    {
+        this->Io(static_cast<BaseWheel2&>(d));
+        this->Io(d.rim_springiness); this->Io(d.rim_damping); this->Io(d.face_material_name); this->Io(d.band_material_name);
+    }
+
+    void Io(WheelDetacher& d) { this->Io(d.wheel_id); this->Io(d.detacher_group); }
+
+    void Io(Wing& d)
+    {
+        this->Io(d.nodes); this->Io(d.tex_coords); this->Io(d.control_surface); this->Io(d.chord_point);
+        this->Io(d.min_deflection); this->Io(d.max_deflection); this->Io(d.airfoil); this->Io(d.efficacy_coef);
+    }
+
+    // The document
+
+    void Io(Document::Module& m)
+    {
+        this->Io(m.airbrakes);             this->Io(m.animators);           this->Io(m.antilockbrakes);
+        this->Io(m.author);                this->Io(m.axles);               this->Io(m.beams);
+        this->Io(m.brakes);                this->Io(m.cameras);             this->Io(m.camerarail);
+        this->Io(m.collisionboxes);        this->Io(m.cinecam);             this->Io(m.commands2);
+        this->Io(m.cruisecontrol);         this->Io(m.contacters);          this->Io(m.default_skin);
+        this->Io(m.description);           this->Io(m.engine);              this->Io(m.engoption);
+        this->Io(m.engturbo);              this->Io(m.exhausts);            this->Io(m.extcamera);
+        this->Io(m.fileformatversion);     this->Io(m.fixes);               this->Io(m.fileinfo);
+        this->Io(m.flares2);               this->Io(m.flares3);             this->Io(m.flexbodies);
+        this->Io(m.flexbodywheels);        this->Io(m.fusedrag);            this->Io(m.globals);
+        this->Io(m.guid);                  this->Io(m.guisettings);         this->Io(m.help);
+        this->Io(m.hooks);                 this->Io(m.hydros);              this->Io(m.interaxles);
+        this->Io(m.lockgroups);            this->Io(m.managedmaterials);    this->Io(m.materialflarebindings);
+        this->Io(m.meshwheels);            this->Io(m.meshwheels2);         this->Io(m.minimass);
+        this->Io(m.nodes);                 this->Io(m.particles);           this->Io(m.pistonprops);
+        this->Io(m.props);                 this->Io(m.railgroups);          this->Io(m.ropables);
+        this->Io(m.ropes);                 this->Io(m.rotators);            this->Io(m.rotators2);
+        this->Io(m.screwprops);            this->Io(m.scripts);             this->Io(m.shocks);
+        this->Io(m.shocks2);               this->Io(m.shocks3);             this->Io(m.set_collision_range);
+        this->Io(m.set_skeleton_settings); this->Io(m.slidenodes);          this->Io(m.soundsources);
+        this->Io(m.soundsources2);         this->Io(m.speedlimiter);        this->Io(m.submesh_groundmodel);
+        this->Io(m.submeshes);             this->Io(m.ties);                this->Io(m.torquecurve);
+        this->Io(m.tractioncontrol);       this->Io(m.transfercase);        this->Io(m.triggers);
+        this->Io(m.turbojets);             this->Io(m.turboprops2);         this->Io(m.videocameras);
+        this->Io(m.wheeldetachers);        this->Io(m.wheels);              this->Io(m.wheels2);
+        this->Io(m.wings);
+    }
+
+    void Io(Document::Message& m) { this->Io(m.type); this->Io(m.text); }
+
+    void Io(Document& doc)
+    {
+        this->Io(doc.hide_in_chooser); this->Io(doc.enable_advanced_deformation); this->Io(doc.slide_nodes_connect_instantly);
+        this->Io(doc.rollon); this->Io(doc.forward_commands); this->Io(doc.import_commands);
+        this->Io(doc.lockgroup_default_nolock); this->Io(doc.rescuer); this->Io(doc.disable_default_sounds);
+        this->Io(doc.name); this->Io(doc.hash); this->Io(doc.messages);
+
+        this->Io(*doc.root_module);
+
+        // Modules are keyed by name and can't be default-constructed
+        const size_t num_modules = this->Count(doc.user_modules.size());
+        auto itor = doc.user_modules.begin();
+        for (size_t i = 0; i < num_modules; ++i)
+        {
+            if (Archive::IS_READING)
+            {
+                std::string name;
+                this->Io(name);
+                auto module = std::make_shared<Document::Module>(name);
+                this->Io(*module);
+                doc.user_modules.insert(std::make_pair(name, module));
+            }
+            else
+            {
+                std::string name = itor->first;
+                this->Io(name);
+                this->Io(*itor->second);
+                ++itor;
+            }
+        }
+    }
+};
+
+/// Hash of the sizes of all serialized structs, stored next to `FORMAT_VERSION`: adding or removing
+/// a member invalidates old cache files even if the version wasn't bumped. Members reordered or
+/// changed at equal size are not detected, those still need the bump.
+uint32_t CalcLayoutHash()
+{
+    const size_t sizes[] =
+    {
+        sizeof(Node::Id), sizeof(Node::Ref), sizeof(Node::Range), sizeof(Node), sizeof(AeroAnimator),
+        sizeof(BaseWheel), sizeof(BaseMeshWheel), sizeof(BaseWheel2), sizeof(Inertia),
+        sizeof(BeamDefaultsScale), sizeof(BeamDefaults), sizeof(NodeDefaults), sizeof(DefaultMinimass),
+        sizeof(CameraSettings), sizeof(Animation::MotorSource), sizeof(Animation), sizeof(Airbrake),
+        sizeof(Animator), sizeof(AntiLockBrakes), sizeof(Author), sizeof(Axle), sizeof(Beam), sizeof(Brakes),
+        sizeof(Cab), sizeof(Camera), sizeof(CameraRail), sizeof(Cinecam), sizeof(CollisionBox),
+        sizeof(CollisionRange), sizeof(Command2), sizeof(CruiseControl), sizeof(DefaultSkin), sizeof(Engine),
+        sizeof(Engoption), sizeof(Engturbo), sizeof(Exhaust), sizeof(ExtCamera), sizeof(FileFormatVersion),
+        sizeof(Fileinfo), sizeof(Flare2), sizeof(Flare3), sizeof(Flexbody), sizeof(FlexBodyWheel),
+        sizeof(Fusedrag), sizeof(Globals), sizeof(Guid), sizeof(GuiSettings), sizeof(Help), sizeof(Hook),
+        sizeof(Hydro), sizeof(InterAxle), sizeof(Lockgroup), sizeof(ManagedMaterialsOptions),
+        sizeof(ManagedMaterial), sizeof(MaterialFlareBinding), sizeof(Minimass), sizeof(MeshWheel),
+        sizeof(MeshWheel2), sizeof(Particle), sizeof(Pistonprop), sizeof(Prop::DashboardSpecial),
+        sizeof(Prop::BeaconSpecial), sizeof(Prop), sizeof(RailGroup), sizeof(Ropable), sizeof(Rope),
+        sizeof(Rotator), sizeof(Rotator2), sizeof(Screwprop), sizeof(Script), sizeof(Shock), sizeof(Shock2),
+        sizeof(Shock3), sizeof(SkeletonSettings), sizeof(SlideNode), sizeof(SoundSource),
+        sizeof(SoundSource2), sizeof(SpeedLimiter), sizeof(Submesh), sizeof(Texcoord), sizeof(Tie),
+        sizeof(TorqueCurve::Sample), sizeof(TorqueCurve), sizeof(TractionControl), sizeof(TransferCase),
+        sizeof(Trigger), sizeof(Turbojet), sizeof(Turboprop2), sizeof(VideoCamera), sizeof(Wheel),
+        sizeof(Wheel2), sizeof(WheelDetacher), sizeof(Wing), sizeof(Document::Module), sizeof(Document::Message),
+        sizeof(Document)
+    };
+
+    uint32_t hash = 2166136261u; // FNV-1a over the little-endian bytes of each size
+    for (size_t size: sizes)
+    {
+        for (int byte = 0; byte < 4; byte++)
+        {
+            hash ^= static_cast<uint32_t>((size >> (byte * 8)) & 0xFF);
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+} // namespace
+
+std::string BinaryCache::GetFilePath(std::string const& hash)
+{
+    return PathCombine(App::sys_cache_dir->getStr(), "truck_" + hash + ".rigbin");
+}
+
+bool BinaryCache::Save(DocumentPtr doc)
+{
+    if (doc->hash.empty())
+    {
+        return false;
+    }
+
+    DocumentIo<BinaryWriter> writer;
+    std::string signature = SIGNATURE;
+    uint32_t version = FORMAT_VERSION;
+    uint32_t layout = CalcLayoutHash();
+    writer.Io(signature);
+    writer.Io(version);
+    writer.Io(layout);
+    writer.Io(doc->hash);
+    writer.Io(*doc);
+
+    // Write to temporary file and rename, so that a crash never leaves a truncated cache file behind.
+    const std::string path = BinaryCache::GetFilePath(doc->hash);
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(writer.GetBuffer().data(), writer.GetBuffer().size());
+        if (!file.good())
+        {
+            RoR::LogFormat("[RoR|RigDef] Failed to write compiled truckfile '%s'", tmp_path.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+    {
+        RoR::LogFormat("[RoR|RigDef] Failed to rename compiled truckfile '%s'", tmp_path.c_str());
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+DocumentPtr BinaryCache::Load(std::string const& hash)
+{
+    const std::string path = BinaryCache::GetFilePath(hash);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return nullptr;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    try
+    {
+        DocumentIo<BinaryReader> reader(data.data(), data.size());
+        std::string signature;
+        uint32_t version = 0;
+        uint32_t layout = 0;
+        std::string stored_hash;
+        reader.Io(signature);
+        reader.Io(version);
+        if (signature != SIGNATURE || version != FORMAT_VERSION)
+        {
+            return nullptr; // Stale, will be overwritten
+        }
+        reader.Io(layout);
+        if (layout != CalcLayoutHash())
+        {
+            return nullptr; // Stale, will be overwritten
+        }
+        reader.Io(stored_hash);
+        if (stored_hash != hash)
+        {
+            throw std::runtime_error("hash mismatch");
+        }
+
+        DocumentPtr doc = std::make_shared<Document>();
+        reader.Io(*doc);
+        if (!reader.IsAtEnd())
+        {
+            throw std::runtime_error("trailing data");
+        }
+        return doc;
+    }
+    catch (std::exception& e)
+    {
+        RoR::LogFormat("[RoR|RigDef] Discarding compiled truckfile '%s': %s", path.c_str(), e.what());
+        return nullptr;
+    }
+}
+
+} // namespace RigDef
@@ -0,0 +1,60 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief Binary cache of parsed truckfiles (compiled `RigDef::Document`)
+
+#pragma once
+
+#include "RigDef_Prerequisites.h"
+
+#include <cstdint>
+#include <string>
+
+namespace RigDef
+{
+
+/// Stores a parsed `RigDef::Document` in compact binary form in the cache directory,
+/// so that spawning or re-building the mod cache doesn't need to parse the truckfile text again.
+///
+/// The document is stored as `Parser` leaves it, with the `SequentialImporter` enabled, before `Validator`
+/// edits it; the validator runs again after every load. The parser's messages are stored in
+/// `Document::messages` for the caller to replay.
+///
+/// Files are named after `Document::hash` (SHA1 of the truckfile); an edited truckfile simply gets
+/// a new cache file. Values are stored in native byte order - the cache is machine-local.
+/// Shared defaults (`BeamDefaults`, `NodeDefaults`, `Inertia`, `DefaultMinimass`) keep their sharing.
+/// Use `RigDef::Serializer` for text output.
+///
+/// File layout:
+///   "RoRTruckBin", u32 format version, u32 layout hash, u32 length + hash, document data
+class BinaryCache
+{
+public:
+    static const char*    SIGNATURE;
+    static const uint32_t FORMAT_VERSION = 3; //!< Bump whenever `RigDef_File.h` structs, `DocumentIo::Io()` or output of `Parser`/`SequentialImporter` change! Struct sizes are also checked automatically (layout hash).
+
+    static std::string    GetFilePath(std::string const& hash);
+    /// Writes `doc` under `doc->hash`; logs errors.
+    static bool           Save(DocumentPtr doc);
+    /// @return nullptr if the file is missing, was written by another version, or is corrupt.
+    static DocumentPtr    Load(std::string const& hash);
+};
+
+} // namespace RigDef
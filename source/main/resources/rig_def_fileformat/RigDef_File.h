@@ -41,6 +41,7 @@
 
 #include "Application.h"
 #include "BitFlags.h"
+#include "Console.h"
 #include "GfxData.h"
 #include "RigDef_Node.h"
 #include "SimConstants.h"
@@ -1568,6 +1569,15 @@ struct Document
     // File hash
     std::string hash;
 
+    struct Message
+    {
+        RoR::Console::MessageType type;
+        std::string               text;
+    };
+
+    /// Diagnostics of `Parser` and `SequentialImporter`, in order; replayed when loaded from `BinaryCache`.
+    std::vector<Message> messages;
+
     // Vehicle modules (caled 'sections' in truckfile doc)
     std::shared_ptr<Module> root_module; //!< Required to exist. `shared_ptr` is used for unified handling with other modules.
     std::map< Ogre::String, std::shared_ptr<Module> > user_modules;
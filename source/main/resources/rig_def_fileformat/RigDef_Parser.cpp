@@ -32,6 +32,7 @@
 #include "Console.h"
 #include "RigDef_File.h"
 #include "RigDef_Regexes.h"
+#include "ThreadPool.h"
 #include "Utils.h"
 
 #include <OgreException.h>
@@ -40,6 +41,7 @@
 #include <OgreStringConverter.h>
 
 #include <algorithm>
+#include <iterator>
 
 using namespace RoR;
 
@@ -73,7 +75,7 @@ Parser::Parser()
     m_ror_node_defaults = std::shared_ptr<NodeDefaults>(new NodeDefaults);
 }
 
-void Parser::ProcessCurrentLine()
+void Parser::ProcessCurrentLine(Keyword keyword)
 {
     // Ignore comment lines
     if ((m_current_line[0] == ';') || (m_current_line[0] == '/'))
@@ -95,8 +97,6 @@ void Parser::ProcessCurrentLine()
         this->TokenizeCurrentLine();
     }
 
-    // Detect keyword on current line 
-    Keyword keyword = IdentifyKeywordInCurrentLine();
     m_log_keyword = keyword;
     switch (keyword)
     {
@@ -2300,7 +2300,11 @@ void Parser::ParseNodesUnified()
     {
         std::string node_name = this->GetArgStr(0);
         node.id.setStr(node_name);
-        if (m_sequential_importer.IsEnabled())
+        if (m_parsed_chunk)
+        {
+            m_parsed_chunk->node_imports.push_back(m_parsed_chunk->messages.size()); // Imported during merge
+        }
+        else if (m_sequential_importer.IsEnabled())
         {
             m_sequential_importer.AddNamedNode(node_name);
         }
@@ -2310,7 +2314,11 @@ void Parser::ParseNodesUnified()
     {
         const unsigned int node_num = this->GetArgUint(0);
         node.id.SetNum(node_num);
-        if (m_sequential_importer.IsEnabled())
+        if (m_parsed_chunk)
+        {
+            m_parsed_chunk->node_imports.push_back(m_parsed_chunk->messages.size()); // Imported during merge
+        }
+        else if (m_sequential_importer.IsEnabled())
         {
             m_sequential_importer.AddNumberedNode(node_num);
         }
@@ -2636,17 +2644,37 @@ void Parser::ParseAuthor()
 
 void Parser::LogMessage(Console::MessageType type, std::string const& msg)
 {
-    App::GetConsole()->putMessage(
-        Console::CONSOLE_MSGTYPE_ACTOR,
-        type,
+    if (m_parsed_chunk)
+    {
+        // Worker thread - the console output must keep the order of a serial parse.
+        DeferredMessage dmsg;
+        dmsg.type = type;
+        dmsg.text = fmt::format("{}:{} ({}): {}",
+            m_filename, m_current_line_number, KeywordToString(m_log_keyword), msg);
+        m_parsed_chunk->messages.push_back(dmsg);
+        return;
+    }
+
+    this->PutMessage(type,
         fmt::format("{}:{} ({}): {}",
             m_filename, m_current_line_number, KeywordToString(m_log_keyword), msg));
 }
 
+void Parser::PutMessage(Console::MessageType type, std::string const& text)
+{
+    m_definition->messages.push_back(Document::Message{type, text});
+    App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_ACTOR, type, text);
+}
+
 Keyword Parser::IdentifyKeywordInCurrentLine()
+{
+    return Parser::IdentifyKeyword(m_current_line);
+}
+
+Keyword Parser::IdentifyKeyword(std::string const& line)
 {
     // Quick check - keyword always starts with ASCII letter
-    char c = tolower(m_current_line[0]); // Note: line comes in trimmed
+    char c = tolower(line[0]); // Note: line comes in trimmed
     if (c > 'z' || c < 'a')
     {
         return Keyword::INVALID;
@@ -2654,7 +2682,6 @@ Keyword Parser::IdentifyKeywordInCurrentLine()
 
     // Search with correct lettercase
     std::smatch results;
-    std::string line(m_current_line);
     std::regex_search(line, results, Regexes::IDENTIFY_KEYWORD_RESPECT_CASE); // Always returns true.
     Keyword keyword = FindKeywordMatch(results);
     if (keyword != Keyword::INVALID)
@@ -2708,7 +2735,7 @@ void Parser::Prepare()
     m_root_module = m_definition->root_module;
     m_current_module = m_definition->root_module;
 
-    m_sequential_importer.Init(true); // Enabled=true
+    m_sequential_importer.Init(true, m_definition); // Enabled=true
 }
 
 void Parser::BeginBlock(Keyword keyword)
@@ -3365,6 +3392,7 @@ void Parser::ProcessOgreStream(Ogre::DataStream* stream, Ogre::String resource_g
     m_resource_group = resource_group;
     m_filename = stream->getName();
 
+    std::vector<ScannedLine> lines;
     char raw_line_buf[LINE_BUFFER_LENGTH];
     while (!stream->eof())
     {
@@ -3374,12 +3402,25 @@ void Parser::ProcessOgreStream(Ogre::DataStream* stream, Ogre::String resource_g
         }
         catch (Ogre::Exception &ex)
         {
-            App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_ACTOR, Console::CONSOLE_SYSTEM_ERROR,
+            this->PutMessage(Console::CONSOLE_SYSTEM_ERROR,
                 fmt::format("Could not read truck file: {}", ex.getFullDescription()));
             break;
         }
 
-        this->ProcessRawLine(raw_line_buf);
+        lines.emplace_back();
+        lines.back().text = raw_line_buf; // Raw until scanned
+    }
+
+    if (lines.size() < PARALLEL_MIN_LINES || App::GetThreadPool() == nullptr)
+    {
+        for (ScannedLine& line: lines)
+        {
+            this->ProcessRawLine(line.text.c_str());
+        }
+    }
+    else
+    {
+        this->ProcessScannedLines(lines);
     }
 }
 
@@ -3407,8 +3448,262 @@ void Parser::ProcessRawLine(const char* raw_line_buf)
     utf8::replace_invalid(raw_start, raw_end, out_start, '?');
 
     // Process
-    this->ProcessCurrentLine();
+    this->ProcessCurrentLine(this->IdentifyKeywordInCurrentLine());
     ++m_current_line_number;
 }
 
+// --------------------------------------------------------------------------
+//  Chunked parallel parsing
+//
+//  Pass 1 trims, sanitizes and identifies keywords of all lines in parallel (the keyword regexes
+//  are the dominant cost of parsing). Pass 2 walks the lines serially, except long runs of lines
+//  of homogeneous blocks (nodes, beams, cab, texcoords, flexbodies + forset) which are split into
+//  chunks, parsed by private worker parsers and merged back in order. The resulting document and
+//  console output are identical to a serial parse.
+// --------------------------------------------------------------------------
+
+namespace {
+
+template <typename T> void AppendMoved(std::vector<T>& dst, std::vector<T>& src)
+{
+    dst.insert(dst.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end()));
+}
+
+} // namespace
+
+void Parser::SanitizeRawLine(const char* raw_line_buf, std::string& out_text)
+{
+    out_text.clear();
+    const char* raw_start = raw_line_buf;
+    const char* raw_end = raw_line_buf + strnlen(raw_line_buf, LINE_BUFFER_LENGTH);
+
+    // Trim leading whitespace
+    while (IsWhitespace(*raw_start) && (raw_start != raw_end))
+    {
+        ++raw_start;
+    }
+
+    // Empty/comment lines stay empty
+    if ((raw_start == raw_end) || (*raw_start == ';') || (*raw_start == '/'))
+    {
+        return;
+    }
+
+    utf8::replace_invalid(raw_start, raw_end, std::back_inserter(out_text), '?');
+}
+
+void Parser::SetCurrentLine(std::string const& text)
+{
+    memset(m_current_line, 0, LINE_BUFFER_LENGTH);
+    memcpy(m_current_line, text.c_str(), std::min(text.size(), size_t(LINE_BUFFER_LENGTH - 1)));
+}
+
+bool Parser::IsChunkableBlock(Keyword block)
+{
+    switch (block)
+    {
+    case Keyword::NODES:
+    case Keyword::NODES2:
+    case Keyword::BEAMS:
+    case Keyword::CAB:
+    case Keyword::TEXCOORDS:
+    case Keyword::FLEXBODIES:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void Parser::ProcessScannedLines(std::vector<ScannedLine>& lines)
+{
+    // Pass 1: sanitize and identify keywords
+    std::vector<std::function<void()>> tasks;
+    for (size_t begin = 0; begin < lines.size(); begin += PARALLEL_CHUNK_LINES)
+    {
+        const size_t end = std::min(begin + PARALLEL_CHUNK_LINES, lines.size());
+        tasks.push_back([&lines, begin, end]()
+        {
+            std::string text;
+            for (size_t i = begin; i < end; ++i)
+            {
+                Parser::SanitizeRawLine(lines[i].text.c_str(), text);
+                lines[i].text.swap(text);
+                if (!lines[i].text.empty())
+                {
+                    lines[i].keyword = Parser::IdentifyKeyword(lines[i].text);
+                }
+            }
+        });
+    }
+    App::GetThreadPool()->Parallelize(tasks);
+
+    // Pass 2: process in order
+    size_t i = 0;
+    while (i < lines.size())
+    {
+        if (lines[i].text.empty())
+        {
+            ++m_current_line_number;
+            ++i;
+            continue;
+        }
+
+        if (lines[i].keyword == Keyword::INVALID && Parser::IsChunkableBlock(m_current_block))
+        {
+            // Find the run of lines belonging to current block ('forset' directives belong to flexbodies)
+            size_t end = i + 1;
+            while (end < lines.size() &&
+                   (lines[end].keyword == Keyword::INVALID ||
+                    (lines[end].keyword == Keyword::FORSET && m_current_block == Keyword::FLEXBODIES)))
+            {
+                ++end;
+            }
+
+            if (end - i >= 2 * PARALLEL_CHUNK_LINES)
+            {
+                this->ProcessChunkedBlock(lines, i, end);
+                i = end;
+                continue;
+            }
+        }
+
+        this->SetCurrentLine(lines[i].text);
+        this->ProcessCurrentLine(lines[i].keyword);
+        ++m_current_line_number;
+        ++i;
+    }
+}
+
+void Parser::ProcessChunkedBlock(std::vector<ScannedLine>& lines, size_t begin, size_t end)
+{
+    std::vector<ParsedChunk> chunks;
+    size_t chunk_begin = begin;
+    while (chunk_begin < end)
+    {
+        // Don't separate a flexbody from its 'forset'
+        size_t chunk_end = std::min(chunk_begin + PARALLEL_CHUNK_LINES, end);
+        while (chunk_end < end && (lines[chunk_end].text.empty() || lines[chunk_end].keyword == Keyword::FORSET))
+        {
+            ++chunk_end;
+        }
+
+        ParsedChunk chunk;
+        chunk.begin = chunk_begin;
+        chunk.end = chunk_end;
+        chunk.first_line_number = m_current_line_number + static_cast<unsigned int>(chunk_begin - begin);
+        chunks.push_back(chunk);
+        chunk_begin = chunk_end;
+    }
+
+    std::vector<std::function<void()>> tasks;
+    for (ParsedChunk& chunk: chunks)
+    {
+        tasks.push_back([this, &lines, &chunk]() { this->ParseChunk(lines, chunk); });
+    }
+    App::GetThreadPool()->Parallelize(tasks);
+
+    for (ParsedChunk& chunk: chunks)
+    {
+        this->MergeChunk(lines, chunk);
+    }
+}
+
+void Parser::ParseChunk(std::vector<ScannedLine>& lines, ParsedChunk& chunk)
+{
+    // Worker parser with a snapshot of the state which the block parsers read; directives
+    // which modify it always end a chunked run, so it stays constant for the whole run.
+    Parser worker;
+    worker.m_parsed_chunk           = &chunk;
+    worker.m_definition             = m_definition; // Read-only: only block lines and 'forset' get here.
+    worker.m_filename               = m_filename;
+    worker.m_current_block          = m_current_block;
+    worker.m_user_node_defaults     = m_user_node_defaults;
+    worker.m_user_beam_defaults     = m_user_beam_defaults;
+    worker.m_set_default_minimass   = m_set_default_minimass;
+    worker.m_current_detacher_group = m_current_detacher_group;
+    worker.m_any_named_node_defined = m_any_named_node_defined;
+    worker.m_sequential_importer.Init(m_sequential_importer.IsEnabled()); // Only queried; nodes are imported during merge.
+
+    chunk.module = std::make_shared<Document::Module>(m_current_module->name);
+    worker.m_current_module = chunk.module;
+    if (m_current_submesh)
+    {
+        chunk.submesh = std::make_shared<Submesh>();
+        worker.m_current_submesh = chunk.submesh;
+    }
+
+    worker.m_current_line_number = chunk.first_line_number;
+    for (size_t i = chunk.begin; i < chunk.end; ++i, ++worker.m_current_line_number)
+    {
+        if (lines[i].text.empty())
+        {
+            continue;
+        }
+
+        if (lines[i].keyword == Keyword::FORSET && chunk.module->flexbodies.empty())
+        {
+            chunk.must_reparse = true; // The 'forset' belongs to a flexbody outside of this chunk
+            return;
+        }
+
+        worker.SetCurrentLine(lines[i].text);
+        worker.ProcessCurrentLine(lines[i].keyword);
+    }
+}
+
+void Parser::MergeChunk(std::vector<ScannedLine>& lines, ParsedChunk& chunk)
+{
+    if (chunk.must_reparse)
+    {
+        for (size_t i = chunk.begin; i < chunk.end; ++i, ++m_current_line_number)
+        {
+            if (!lines[i].text.empty())
+            {
+                this->SetCurrentLine(lines[i].text);
+                this->ProcessCurrentLine(lines[i].keyword);
+            }
+        }
+        return;
+    }
+
+    // Import nodes in order, interleaved with messages as the serial parse would
+    size_t num_logged = 0;
+    for (size_t k = 0; k < chunk.node_imports.size(); ++k)
+    {
+        for (; num_logged < chunk.node_imports[k]; ++num_logged)
+        {
+            this->PutMessage(chunk.messages[num_logged].type, chunk.messages[num_logged].text);
+        }
+
+        Node::Id const& id = chunk.module->nodes[k].id;
+        if (id.IsTypeNamed())
+        {
+            if (m_sequential_importer.IsEnabled())
+            {
+                m_sequential_importer.AddNamedNode(id.Str());
+            }
+            m_any_named_node_defined = true; // For import logic
+        }
+        else if (m_sequential_importer.IsEnabled())
+        {
+            m_sequential_importer.AddNumberedNode(id.Num());
+        }
+    }
+    for (; num_logged < chunk.messages.size(); ++num_logged)
+    {
+        this->PutMessage(chunk.messages[num_logged].type, chunk.messages[num_logged].text);
+    }
+
+    AppendMoved(m_current_module->nodes, chunk.module->nodes);
+    AppendMoved(m_current_module->beams, chunk.module->beams);
+    AppendMoved(m_current_module->flexbodies, chunk.module->flexbodies);
+    if (chunk.submesh)
+    {
+        AppendMoved(m_current_submesh->cab_triangles, chunk.submesh->cab_triangles);
+        AppendMoved(m_current_submesh->texcoords, chunk.submesh->texcoords);
+    }
+
+    m_current_line_number += static_cast<unsigned int>(chunk.end - chunk.begin);
+}
+
 } // namespace RigDef
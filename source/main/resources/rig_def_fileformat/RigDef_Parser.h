@@ -60,6 +60,8 @@ public:
 
     static const int LINE_BUFFER_LENGTH = 2000;
     static const int LINE_MAX_ARGS = 100;
+    static const size_t PARALLEL_MIN_LINES = 4000;  //!< Smaller files are parsed serially, threading isn't worth it.
+    static const size_t PARALLEL_CHUNK_LINES = 512; //!< Lines per task, both for the keyword scan and for block parsing.
 
     struct Token
     {
@@ -83,6 +85,44 @@ public:
 
 private:
 
+// --------------------------------------------------------------------------
+//  Chunked parallel parsing (large files)
+// --------------------------------------------------------------------------
+
+    struct ScannedLine
+    {
+        std::string text;                       //!< Trimmed and UTF-8 sanitized; empty for blank and comment lines.
+        Keyword     keyword = Keyword::INVALID; //!< Keyword identification is stateless, so it's done up front in parallel.
+    };
+
+    struct DeferredMessage
+    {
+        RoR::Console::MessageType type;
+        std::string               text; //!< Fully formatted, including file and line number.
+    };
+
+    /// Output of one chunk of a homogeneous block, parsed by a private `Parser` on a worker thread.
+    struct ParsedChunk
+    {
+        size_t                            begin = 0;        //!< Index of first line
+        size_t                            end = 0;          //!< Index past last line
+        unsigned int                      first_line_number = 0;
+        std::shared_ptr<Document::Module> module;           //!< Receives nodes, beams, flexbodies
+        std::shared_ptr<Submesh>          submesh;          //!< Receives cab, texcoords
+        std::vector<size_t>               node_imports;     //!< Per parsed node: number of `messages` logged before its sequential import (done during merge).
+        std::vector<DeferredMessage>      messages;         //!< Logged in order during merge.
+        bool                              must_reparse = false; //!< Chunk depends on data outside of it (orphan 'forset'), parse serially instead.
+    };
+
+    void             ProcessScannedLines(std::vector<ScannedLine>& lines);
+    void             SetCurrentLine(std::string const& text);
+    void             ProcessChunkedBlock(std::vector<ScannedLine>& lines, size_t begin, size_t end);
+    void             ParseChunk(std::vector<ScannedLine>& lines, ParsedChunk& chunk);
+    void             MergeChunk(std::vector<ScannedLine>& lines, ParsedChunk& chunk);
+    static bool      IsChunkableBlock(Keyword block);
+    static void      SanitizeRawLine(const char* raw_line_buf, std::string& out_text);
+    static Keyword   IdentifyKeyword(std::string const& line);
+
 // --------------------------------------------------------------------------
 //  Directive parsers
 // --------------------------------------------------------------------------
@@ -190,7 +230,7 @@ private:
 //  Utilities
 // --------------------------------------------------------------------------
 
-    void             ProcessCurrentLine();
+    void             ProcessCurrentLine(Keyword keyword); //!< `keyword` = result of `IdentifyKeywordInCurrentLine()`
     int              TokenizeCurrentLine();
     Keyword          IdentifyKeywordInCurrentLine();
     bool             CheckNumArguments(int num_required_args);
@@ -234,10 +274,12 @@ private:
     float              ParseArgFloat      (const std::string& s);
 
     /// Keyword scan utility function. 
-    Keyword FindKeywordMatch(std::smatch& search_results);
+    static Keyword FindKeywordMatch(std::smatch& search_results);
 
     /// Adds a message to console
     void LogMessage(RoR::Console::MessageType type, std::string const& msg);
+    /// Adds a formatted message to console and to `Document::messages`
+    void PutMessage(RoR::Console::MessageType type, std::string const& text);
 
     static void _TrimTrailingComments(std::string const & line_in, std::string & line_out);
 
@@ -278,6 +320,7 @@ private:
     std::shared_ptr<CameraRail>          m_current_camera_rail;    //!< Parser state.
 
     SequentialImporter                   m_sequential_importer;
+    ParsedChunk*                         m_parsed_chunk = nullptr; //!< Set if this is a worker parser of a chunked parse.
 
     Ogre::String                         m_filename; // Logging
     Ogre::String                         m_resource_group;
@@ -84,6 +84,7 @@ struct VideoCamera;
 
 // Parser classes
 
+class BinaryCache;
 class Parser;
 class Validator;
 class SequentialImporter;
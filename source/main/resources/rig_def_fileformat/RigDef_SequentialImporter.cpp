@@ -33,9 +33,10 @@
 
 using namespace RigDef;
 
-void SequentialImporter::Init(bool enabled)
+void SequentialImporter::Init(bool enabled, DocumentPtr def)
 {
     m_enabled = enabled;
+    m_definition = def;
     m_all_nodes.clear();
     m_all_nodes.reserve(1000);
     m_current_keyword = Keyword::INVALID;
@@ -130,6 +131,10 @@ void SequentialImporter::AddMessage(Message::Type msg_type, std::string text)
         break;
     }
 
+    if (m_definition)
+    {
+        m_definition->messages.push_back(Document::Message{cm_type, txt.ToCStr()});
+    }
     RoR::App::GetConsole()->putMessage(RoR::Console::CONSOLE_MSGTYPE_ACTOR, cm_type, txt.ToCStr());
 }
 
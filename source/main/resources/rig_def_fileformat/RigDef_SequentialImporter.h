@@ -115,7 +115,8 @@ public:
         };
     };
 
-    void Init(bool enabled);
+    /// @param def Receives the messages in `Document::messages`; may be null.
+    void Init(bool enabled, DocumentPtr def = nullptr);
 
     void Disable()
     {
@@ -168,6 +169,7 @@ private:
     int                                 m_num_resolved_to_self;
     Keyword                       m_current_keyword;
     std::shared_ptr<Document::Module>       m_current_module;
+    DocumentPtr                             m_definition;
 };
 
 } // namespace RigDef
@@ -229,6 +229,21 @@ float GameScript::getGroundHeight(Vector3& v)
     return result;
 }
 
+bool GameScript::castRay(Vector3& start, Vector3& end, Vector3& out_hit_pos)
+{
+    if (!this->HaveSimTerrain(__FUNCTION__))
+        return false;
+
+    const Ray ray(start, end - start);
+    collision_ray_hit_t hit;
+    if (App::GetGameContext()->GetTerrain()->GetCollisions()->castRay(ray, hit))
+    {
+        out_hit_pos = ray.getPoint(hit.distance);
+        return true;
+    }
+    return false;
+}
+
 float GameScript::getWaterHeight()
 {
     float result = 0.0f;
@@ -305,6 +305,13 @@ public:
     */
     float getGroundHeight(Ogre::Vector3& v);
 
+    /**
+    * Finds the nearest terrain, collision mesh or collision box surface on the line between two points.
+    * @param out_hit_pos Position of the hit, unchanged if nothing was hit.
+    * @return True if anything was hit.
+    */
+    bool castRay(Ogre::Vector3& start, Ogre::Vector3& end, Ogre::Vector3& out_hit_pos);
+
     /**
      * returns the current base water level (without waves)
      * @return water height in meters
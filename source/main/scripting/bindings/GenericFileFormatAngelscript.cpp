@@ -107,12 +107,15 @@ void RoR::RegisterGenericFileFormat(asIScriptEngine* engine)
 
     engine->RegisterObjectMethod("GenericDocReaderClass", "string getTokString(int offset = 0)", asFUNCTION(GenericDocReader_getTokString), asCALL_CDECL_OBJFIRST);
     engine->RegisterObjectMethod("GenericDocReaderClass", "float getTokFloat(int offset = 0)", asMETHOD(GenericDocReader, getTokFloat), asCALL_THISCALL);
+    engine->RegisterObjectMethod("GenericDocReaderClass", "double getTokDouble(int offset = 0)", asMETHOD(GenericDocReader, getTokDouble), asCALL_THISCALL);
+    engine->RegisterObjectMethod("GenericDocReaderClass", "int64 getTokInt(int offset = 0)", asMETHOD(GenericDocReader, getTokInt), asCALL_THISCALL);
     engine->RegisterObjectMethod("GenericDocReaderClass", "bool getTokBool(int offset = 0)", asMETHOD(GenericDocReader, getTokBool), asCALL_THISCALL);
     engine->RegisterObjectMethod("GenericDocReaderClass", "string getTokKeyword(int offset = 0)", asFUNCTION(GenericDocReader_getTokKeyword), asCALL_CDECL_OBJFIRST);
     engine->RegisterObjectMethod("GenericDocReaderClass", "string getTokComment(int offset = 0)", asFUNCTION(GenericDocReader_getTokComment), asCALL_CDECL_OBJFIRST);
     
     engine->RegisterObjectMethod("GenericDocReaderClass", "bool isTokString(int offset = 0)", asMETHOD(GenericDocReader, isTokString), asCALL_THISCALL);
     engine->RegisterObjectMethod("GenericDocReaderClass", "bool isTokFloat(int offset = 0)", asMETHOD(GenericDocReader, isTokFloat), asCALL_THISCALL);
+    engine->RegisterObjectMethod("GenericDocReaderClass", "bool isTokInt(int offset = 0)", asMETHOD(GenericDocReader, isTokInt), asCALL_THISCALL);
     engine->RegisterObjectMethod("GenericDocReaderClass", "bool isTokBool(int offset = 0)", asMETHOD(GenericDocReader, isTokBool), asCALL_THISCALL);
     engine->RegisterObjectMethod("GenericDocReaderClass", "bool isTokKeyword(int offset = 0)", asMETHOD(GenericDocReader, isTokKeyword), asCALL_THISCALL);
     engine->RegisterObjectMethod("GenericDocReaderClass", "bool isTokComment(int offset = 0)", asMETHOD(GenericDocReader, isTokComment), asCALL_THISCALL);
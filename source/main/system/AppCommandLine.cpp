@@ -46,7 +46,8 @@ enum {
     OPT_TRUCKCONFIG,
     OPT_RUNSCRIPT,
     OPT_ENTERTRUCK,
-    OPT_JOINMPSERVER
+    OPT_JOINMPSERVER,
+    OPT_INPUTPLAYBACK
 };
 
 // option array
@@ -65,6 +66,7 @@ CSimpleOpt::SOption cmdline_options[] = {
     { OPT_CHECKCACHE,     ("-checkcache"),  SO_NONE    },
     { OPT_VER,            ("-version"),     SO_NONE    },
     { OPT_JOINMPSERVER,   ("-joinserver"),  SO_REQ_CMB },
+    { OPT_INPUTPLAYBACK,  ("-inputplayback"), SO_REQ_SEP },
     SO_END_OF_OPTIONS
 };
 
@@ -134,6 +136,10 @@ void Console::processCommandLine(int argc, char *argv[])
         {
             App::cli_preset_veh_enter->setVal(true);
         }
+        else if (args.OptionId() == OPT_INPUTPLAYBACK)
+        {
+            App::cli_input_playback->setStr(args.OptionArg());
+        }
         else if (args.OptionId() == OPT_JOINMPSERVER)
         {
             std::string server_args = args.OptionArg();
@@ -175,6 +181,7 @@ void Console::showCommandLineUsage()
             "-version shows the version information"                "\n"
             "-joinserver=<server>:<port> (join multiplayer server)" "\n"
             "-runscript <filename> (load script, can be repeated)"  "\n"
+            "-inputplayback <file> (replays recorded input)"        "\n"
             "For example: RoR.exe -map simple2 -pos '518 0 518' -rot 45 -truck semi.truck -enter"));
 }
 
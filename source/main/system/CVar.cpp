@@ -26,6 +26,8 @@
 
 using namespace RoR;
 
+unsigned int CVar::s_revision = 0;
+
 void Console::cVarSetupBuiltins()
 {
     App::app_state               = this->cVarCreate("app_state",               "",                                          CVAR_TYPE_INT,     "0"/*(int)AppState::BOOTSTRAP*/);
@@ -55,6 +57,7 @@ void Console::cVarSetupBuiltins()
     App::sim_races_enabled       = this->cVarCreate("sim_races_enabled",       "Races",                      CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "true");
     App::sim_no_collisions       = this->cVarCreate("sim_no_collisions",       "DisableCollisions",          CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
     App::sim_no_self_collisions  = this->cVarCreate("sim_no_self_collisions",  "DisableSelfCollisions",      CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
+    App::sim_self_collision_hops = this->cVarCreate("sim_self_collision_hops", "SelfCollisionExclusionHops", CVAR_ARCHIVE | CVAR_TYPE_INT,     "0");
     App::sim_gearbox_mode        = this->cVarCreate("sim_gearbox_mode",        "GearboxMode",                CVAR_ARCHIVE | CVAR_TYPE_INT);
     App::sim_soft_reset_mode     = this->cVarCreate("sim_soft_reset_mode",     "",                                          CVAR_TYPE_BOOL,    "false");
     App::sim_quickload_dialog    = this->cVarCreate("sim_quickload_dialog",    "",                           CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "true");
@@ -126,6 +129,7 @@ void Console::cVarSetupBuiltins()
     App::cli_force_cache_update  = this->cVarCreate("cli_force_cache_update",  "",                                          CVAR_TYPE_BOOL,    "false");
     App::cli_resume_autosave     = this->cVarCreate("cli_resume_autosave",     "",                                          CVAR_TYPE_BOOL,    "false");
     App::cli_custom_scripts      = this->cVarCreate("cli_custom_scripts",      "",                           0,                                "");
+    App::cli_input_playback      = this->cVarCreate("cli_input_playback",      "",                           0,                                "");
 
     App::io_analog_smoothing     = this->cVarCreate("io_analog_smoothing",     "Analog Input Smoothing",     CVAR_ARCHIVE | CVAR_TYPE_FLOAT,   "1.0");
     App::io_analog_sensitivity   = this->cVarCreate("io_analog_sensitivity",   "Analog Input Sensitivity",   CVAR_ARCHIVE | CVAR_TYPE_FLOAT,   "1.0");
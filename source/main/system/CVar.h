@@ -77,6 +77,7 @@ public:
             this->logUpdate(str);
             m_value_num = (float)val;
             m_value_str = str;
+            s_revision++;
         }
     }
 
@@ -87,6 +88,7 @@ public:
             this->logUpdate(str);
             m_value_num = 0;
             m_value_str = str;
+            s_revision++;
         }
     }
 
@@ -104,6 +106,9 @@ public:
     std::string const&      getLongName() const   { return m_long_name; }
     bool                    hasFlag(int f) const  { return m_flags & f; }
 
+    /// Incremented whenever any CVar changes value; lets caches of CVar values (i.e. `SimSettings`) know when to rebuild.
+    static unsigned int     getRevision()         { return s_revision; }
+
 private:
     void                    logUpdate(std::string const& new_val);
     std::string             convertStr(float val);
@@ -116,6 +121,8 @@ private:
     std::string        m_value_str;
     float              m_value_num;
     int                m_flags;
+
+    static unsigned int s_revision;
 };
 
 /// @} // addtogroup Console
@@ -28,6 +28,7 @@
 #include "GameContext.h"
 #include "GfxScene.h"
 #include "GUIManager.h"
+#include "InputEngine.h"
 #include "IWater.h"
 #include "Language.h"
 #include "Network.h"
@@ -37,9 +38,12 @@
 #include "ScriptEngine.h"
 #include "Terrain.h"
 #include "TerrainObjectManager.h"
+#include "PlatformUtils.h"
 #include "Utils.h"
 
 #include <algorithm>
+#include <ctime>
+#include <iomanip>
 #include <Ogre.h>
 #include <fmt/core.h>
 
@@ -642,6 +646,165 @@ public:
     }
 };
 
+class TelemetryCmd: public ConsoleCmd
+{
+public:
+    TelemetryCmd(): ConsoleCmd("telemetry", "start [<channels>] [<every_nth_step>] [all] | stop | status",
+        _L("Stream physics channels to a file in the logs directory. Channels: nodes,contacts,beams,wheels,engine,all")) {}
+
+    void Run(Ogre::StringVector const& args) override
+    {
+        if (!this->CheckAppState(AppState::SIMULATION))
+            return;
+
+        ActorManager* actor_mgr = App::GetGameContext()->GetActorManager();
+        PhysicsRecorder& recorder = actor_mgr->GetPhysicsRecorder();
+        Str<400> reply;
+        reply << m_name << ": ";
+        Console::MessageType reply_type = Console::CONSOLE_SYSTEM_REPLY;
+
+        if (args.size() >= 2 && args[1] == "start")
+        {
+            const BitMask_t channels = (args.size() >= 3) ? PhysicsRecorder::ParseChannels(args[2]) : PhysicsRecorder::ParseChannels("wheels,engine");
+            const int every_nth_step = (args.size() >= 4) ? std::max(1, PARSEINT(args[3])) : 1;
+            std::vector<ActorPtr> actors;
+            if (args.size() >= 5 && args[4] == "all")
+            {
+                actors = actor_mgr->GetLocalActors();
+            }
+            else if (App::GetGameContext()->GetPlayerActor())
+            {
+                actors.push_back(App::GetGameContext()->GetPlayerActor());
+            }
+
+            const std::time_t time = std::time(nullptr);
+            std::stringstream stamp;
+            stamp << std::put_time(std::localtime(&time), "%Y-%m-%d_%H-%M-%S");
+            const std::string path = PathCombine(App::sys_logs_dir->getStr(), "telemetry_" + stamp.str() + ".rortlm");
+
+            actor_mgr->SyncWithSimThread();
+            recorder.Stop();
+            std::string error;
+            if (recorder.Start(path, actors, channels, every_nth_step, error))
+            {
+                reply << fmt::format(_L("Recording {} columns at {} Hz to '{}'; up to {} chunks ({} MB) queued for writing"),
+                    recorder.GetNumColumns(), 1.f / (PHYSICS_DT * every_nth_step), path,
+                    recorder.GetMaxQueuedChunks(), (recorder.GetMaxQueuedChunks() * recorder.GetChunkBytes()) >> 20);
+                if (!PhysicsRecorder::IsCompressionAvailable())
+                {
+                    reply << " " << _L("(uncompressed)");
+                }
+            }
+            else
+            {
+                reply_type = Console::CONSOLE_SYSTEM_ERROR;
+                reply << error;
+            }
+        }
+        else if (args.size() >= 2 && args[1] == "stop")
+        {
+            if (recorder.IsRecording())
+            {
+                actor_mgr->SyncWithSimThread();
+                const uint64_t num_samples = recorder.GetNumSamples();
+                const size_t num_dropped = recorder.GetNumDroppedChunks();
+                const std::string path = recorder.GetFilename();
+                recorder.Stop();
+                reply << fmt::format(_L("Stopped; {} samples written to '{}', {} chunks dropped"), num_samples, path, num_dropped);
+            }
+            else
+            {
+                reply_type = Console::CONSOLE_SYSTEM_ERROR;
+                reply << _L("Not recording");
+            }
+        }
+        else if (args.size() >= 2 && args[1] == "status")
+        {
+            if (recorder.IsRecording())
+                reply << fmt::format(_L("Recording to '{}'; {} samples, {} chunks dropped"), recorder.GetFilename(), recorder.GetNumSamples(), recorder.GetNumDroppedChunks());
+            else
+                reply << _L("Not recording");
+        }
+        else
+        {
+            reply_type = Console::CONSOLE_HELP;
+            reply << m_name << " " << m_usage;
+        }
+
+        App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, reply_type, reply.ToCStr());
+    }
+};
+
+class InputRecCmd: public ConsoleCmd
+{
+public:
+    InputRecCmd(): ConsoleCmd("inputrec", "record | play <file> | stop | status",
+        _L("Record resolved input events to a file in the logs directory, or play such file back instead of the input devices")) {}
+
+    void Run(Ogre::StringVector const& args) override
+    {
+        InputEngine* input = App::GetInputEngine();
+        Str<400> reply;
+        reply << m_name << ": ";
+        Console::MessageType reply_type = Console::CONSOLE_SYSTEM_REPLY;
+
+        if (args.size() >= 2 && args[1] == "record")
+        {
+            const std::time_t time = std::time(nullptr);
+            std::stringstream stamp;
+            stamp << std::put_time(std::localtime(&time), "%Y-%m-%d_%H-%M-%S");
+            const std::string path = PathCombine(App::sys_logs_dir->getStr(), "input_" + stamp.str() + ".rorinput");
+            if (input->StartRecording(path))
+                reply << fmt::format(_L("Recording to '{}'"), path);
+            else
+                return; // Error already reported
+        }
+        else if (args.size() >= 3 && args[1] == "play")
+        {
+            // Bare filenames are looked up in the logs directory, where recordings are made
+            const std::string path = FileExists(args[2]) ? args[2] : PathCombine(App::sys_logs_dir->getStr(), args[2]);
+            if (input->StartPlayback(path))
+                reply << fmt::format(_L("Playing back '{}'"), path);
+            else
+                return; // Error already reported
+        }
+        else if (args.size() >= 2 && args[1] == "stop")
+        {
+            if (input->IsRecording())
+            {
+                reply << fmt::format(_L("Stopped; {} frames written to '{}'"), input->GetNumRecordedFrames(), input->GetRecordingFilename());
+            }
+            else if (input->IsPlayingBack())
+            {
+                reply << _L("Playback stopped");
+            }
+            else
+            {
+                reply_type = Console::CONSOLE_SYSTEM_ERROR;
+                reply << _L("Not recording or playing back");
+            }
+            input->StopRecording();
+            input->StopPlayback();
+        }
+        else if (args.size() >= 2 && args[1] == "status")
+        {
+            if (input->IsRecording())
+                reply << fmt::format(_L("Recording to '{}'; {} frames"), input->GetRecordingFilename(), input->GetNumRecordedFrames());
+            else
+                reply << _L("Not recording");
+            if (input->IsPlayingBack())
+                reply << "; " << _L("playing back");
+        }
+        else
+        {
+            reply_type = Console::CONSOLE_HELP;
+            reply << m_name << " " << m_usage;
+        }
+
+        App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, reply_type, reply.ToCStr());
+    }
+};
+
 /// @} // addtogroup ConsoleCmd
 
 // -------------------------------------------------------------------------------------
@@ -666,6 +829,8 @@ void Console::regBuiltinCommands()
     // Additions
     cmd = new ClearCmd();                 m_commands.insert(std::make_pair(cmd->getName(), cmd));
     cmd = new LoadScriptCmd();            m_commands.insert(std::make_pair(cmd->getName(), cmd));
+    cmd = new TelemetryCmd();             m_commands.insert(std::make_pair(cmd->getName(), cmd));
+    cmd = new InputRecCmd();              m_commands.insert(std::make_pair(cmd->getName(), cmd));
     // CVars
     cmd = new SetCmd();                   m_commands.insert(std::make_pair(cmd->getName(), cmd));
     cmd = new SetstringCmd();             m_commands.insert(std::make_pair(cmd->getName(), cmd));
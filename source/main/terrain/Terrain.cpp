@@ -496,6 +496,11 @@ float RoR::Terrain::GetHeightAt(float x, float z)
     return m_geometry_manager->getHeightAt(x, z);
 }
 
+std::pair<bool, Ogre::Real> RoR::Terrain::IntersectsRay(const Ogre::Ray& ray)
+{
+    return m_geometry_manager->intersectsRay(ray);
+}
+
 Ogre::Vector3 RoR::Terrain::GetNormalAt(float x, float y, float z)
 {
     return m_geometry_manager->getNormalAt(x, y, z);
@@ -29,6 +29,7 @@
 #include "TerrainEditor.h"
 #include "Terrn2FileFormat.h"
 
+#include <OgreRay.h>
 #include <OgreVector3.h>
 #include <string>
 
@@ -95,6 +96,7 @@ public:
     void                    setGravity(float value);
     float                   getGravity() const            { return m_cur_gravity; }
     float                   GetHeightAt(float x, float z);
+    std::pair<bool, Ogre::Real> IntersectsRay(const Ogre::Ray& ray); //!< Heightfield only, see `Collisions::castRay()` for the full query.
     Ogre::Vector3           GetNormalAt(float x, float y, float z);
     Ogre::Vector3           getMaxTerrainSize();
     Ogre::AxisAlignedBox    getTerrainCollisionAAB();
@@ -23,6 +23,7 @@
 
 #include "Actor.h"
 #include "Application.h"
+#include "Console.h"
 #include "ContentManager.h"
 #include "Language.h"
 #include "GfxScene.h"
@@ -32,10 +33,19 @@
 #include "ShadowManager.h"
 #include "OgreTerrainPSSMMaterialGenerator.h"
 #include "OTCFileFormat.h"
+#include "ThreadPool.h"
 
 #include <OgreLight.h>
 #include <Terrain/OgreTerrainGroup.h>
 
+#include <atomic>
+#include <cstring>
+#include <functional>
+
+#ifdef USE_ZLIB
+#   include <zlib.h>
+#endif
+
 using namespace Ogre;
 using namespace RoR;
 
@@ -136,8 +146,7 @@ Ogre::MaterialPtr Terrn2CustomMaterial::Profile::generate(const Ogre::Terrain* t
 #define XZSTR(X,Z)   String("[") + TOSTRING(X) + String(",") + TOSTRING(Z) + String("]")
 
 TerrainGeometryManager::TerrainGeometryManager(Terrain* terrainManager)
-    : mHeightData(nullptr)
-    , mIsFlat(false)
+    : mIsFlat(false)
     , mMinHeight(0.0f)
     , mMaxHeight(std::numeric_limits<float>::min())
     , m_was_new_geometry_generated(false)
@@ -148,100 +157,78 @@ TerrainGeometryManager::TerrainGeometryManager(Terrain* terrainManager)
 
 TerrainGeometryManager::~TerrainGeometryManager()
 {
+    for (auto& task : m_cache_save_tasks)
+    {
+        task->join();
+    }
+
     if (m_ogre_terrain_group != nullptr)
     {
         m_ogre_terrain_group->removeAllTerrains();
     }
 }
 
-/// @author Ported from OGRE engine, www.ogre3d.org, file OgreTerrain.cpp
-float TerrainGeometryManager::getHeightAtTerrainPosition(Real x, Real y)
+float TerrainGeometryManager::getHeightAt(float x, float z)
 {
-    // get left / bottom points (rounded down)
-    Real factor = (Real)mSize - 1.0f;
-    Real invFactor = 1.0f / factor;
-
-    long startX = static_cast<long>(x * factor);
-    long startY = static_cast<long>(y * factor);
-    long endX = startX + 1;
-    long endY = startY + 1;
-
-    // now get points in terrain space (effectively rounding them to boundaries)
-    // note that we do not clamp! We need a valid plane
-    Real startXTS = startX * invFactor;
-    Real startYTS = startY * invFactor;
-    Real endXTS = endX * invFactor;
-    Real endYTS = endY * invFactor;
-
-    // get parametric from start coord to next point
-    Real xParam = (x * factor - startX);
-    Real yParam = (y * factor - startY);
-
-    /* For even / odd tri strip rows, triangles are this shape:
-    even     odd
-    3---2   3---2
-    | / |   | \ |
-    0---1   0---1
-    */
-
-    // Build all 4 positions in terrain space, using point-sampled height
-    Vector3 v0(startXTS, startYTS, mHeightData[startY * mSize + startX]);
-    Vector3 v1(endXTS  , startYTS, mHeightData[startY * mSize + endX]);
-    Vector3 v2(endXTS  , endYTS  , mHeightData[endY   * mSize + endX]);
-    Vector3 v3(startXTS, endYTS  , mHeightData[endY   * mSize + startX]);
-
-    // define this plane in terrain space
-    Vector3 normal;
-    Real d;
-    if (startY % 2)
-    {
-        // odd row
-        bool secondTri = ((1.0 - yParam) > xParam);
-        if (secondTri)
-        {
-            normal = (v1 - v0).crossProduct(v3 - v0);
-            d = -normal.dotProduct(v0);
-        }
-        else
-        {
-            normal = (v2 - v1).crossProduct(v3 - v1);
-            d = -normal.dotProduct(v1);
-        }
-    }
-    else
-    {
-        // even row
-        bool secondTri = (yParam > xParam);
-        if (secondTri)
-        {
-            normal = (v2 - v0).crossProduct(v3 - v0);
-            d = -normal.dotProduct(v0);
-        }
-        else
-        {
-            normal = (v1 - v0).crossProduct(v2 - v0);
-            d = -normal.dotProduct(v0);
-        }
-    }
+    if (m_spec->is_flat)
+        return 0.0f;
 
-    // Solve plane equation for z
-    return (-normal.x * x - normal.y * y - d) / normal.z;
+    // Beyond the pages, the water bottom
+    return m_height_pages.GetHeightAt(x, z, terrainManager->GetDef().water_bottom_height);
 }
 
-float TerrainGeometryManager::getHeightAt(float x, float z)
+std::pair<bool, Ogre::Real> TerrainGeometryManager::intersectsRay(const Ogre::Ray& ray)
 {
     if (m_spec->is_flat)
-        return 0.0f;
+        return TerrainHeightPages::IntersectsLevel(ray, 0.f);
 
-    float tx = (x - mBase - mPos.x) / ((mSize - 1) *  mScale);
-    float ty = (z + mBase - mPos.z) / ((mSize - 1) * -mScale);
+    return m_height_pages.IntersectsRay(ray, terrainManager->GetDef().water_bottom_height);
+}
 
-    if (tx <= 0.0f || ty <= 0.0f || tx >= 1.0f || ty >= 1.0f)
-        return terrainManager->GetDef().water_bottom_height;
-    else if (mIsFlat)
-        return mMinHeight;
+void TerrainGeometryManager::buildHeightPages()
+{
+    m_height_pages.Clear();
+
+    Ogre::Terrain* first_terrain = nullptr;
+    int min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+    for (OTCPage& page : m_spec->pages)
+    {
+        Ogre::Terrain* terrain = m_ogre_terrain_group->getTerrain(page.pos_x, page.pos_z);
+        if (terrain == nullptr)
+            continue;
+
+        if (first_terrain == nullptr)
+        {
+            first_terrain = terrain;
+            min_x = max_x = page.pos_x;
+            min_y = max_y = page.pos_z;
+        }
+        min_x = std::min(min_x, page.pos_x);
+        min_y = std::min(min_y, page.pos_z);
+        max_x = std::max(max_x, page.pos_x);
+        max_y = std::max(max_y, page.pos_z);
+    }
+
+    if (first_terrain == nullptr)
+        return;
+
+    // All pages of a terrain group share size and world size
+    Vector3 slot_origin;
+    m_ogre_terrain_group->convertTerrainSlotToWorldPosition(0, 0, &slot_origin);
+    m_height_pages.Setup(slot_origin, first_terrain->getWorldSize(), first_terrain->getSize(),
+        min_x, min_y, max_x - min_x + 1, max_y - min_y + 1);
 
-    return getHeightAtTerrainPosition(tx, ty);
+    for (OTCPage& page : m_spec->pages)
+    {
+        Ogre::Terrain* terrain = m_ogre_terrain_group->getTerrain(page.pos_x, page.pos_z);
+        if (terrain == nullptr)
+            continue;
+
+        const TerrainHeightPages::HeightPage& hpage = m_height_pages.SetPage(page.pos_x, page.pos_z, terrain->getHeightData());
+        mMinHeight = std::min(hpage.min_height, mMinHeight);
+        mMaxHeight = std::max(mMaxHeight, hpage.max_height);
+    }
+    mIsFlat = std::abs(mMaxHeight - mMinHeight) < std::numeric_limits<float>::epsilon();
 }
 
 Ogre::Vector3 TerrainGeometryManager::getNormalAt(float x, float y, float z)
@@ -319,61 +306,30 @@ bool TerrainGeometryManager::InitTerrain(std::string otc_filename)
 
     configureTerrainDefaults();
 
-    for (OTCPage& page : m_spec->pages)
-    {
-        this->SetupGeometry(page, m_spec->is_flat);
-    }
+    this->SetupGeometry();
 
     // sync load since we want everything in place when we start
     App::GetGuiManager()->LoadingWindow.SetProgress(44, _L("Loading terrain pages ..."));
     m_ogre_terrain_group->loadAllTerrains(true);
 
-    Ogre::Terrain* terrain = m_ogre_terrain_group->getTerrain(0, 0);
+    this->buildHeightPages();
 
-    if (terrain == nullptr)
+    if (m_height_pages.IsEmpty())
         return true;
 
-    mHeightData = terrain->getHeightData();
-    mSize = terrain->getSize();
-    const float world_size = terrain->getWorldSize();
-    mBase = -world_size * 0.5f;
-    mScale = world_size / (Real)(mSize - 1);
-    mPos = terrain->getPosition();
-
-    // terrain->getMinHeight() / terrain->getMaxHeight() seem to be unreliable ~ ulteq 12/18
-    for (int x = 0; x < mSize; x++)
-    {
-        for (int y = 0; y < mSize; y++)
-        {
-            float h = mHeightData[y * mSize + x];
-            mMinHeight = std::min(h, mMinHeight);
-            mMaxHeight = std::max(mMaxHeight, h);
-        }
-    }
-    mIsFlat = std::abs(mMaxHeight - mMinHeight) < std::numeric_limits<float>::epsilon();
-
     if (m_was_new_geometry_generated)
     {
         // update the blend maps
         if (terrainManager->GetDef().custom_material_name.empty())
         {
-            for (OTCPage& page : m_spec->pages)
-            {
-                Ogre::Terrain* terrain = m_ogre_terrain_group->getTerrain(page.pos_x, page.pos_z);
-
-                if (terrain != nullptr)
-                {
-                    this->SetupLayers(page, terrain);
-                    this->SetupBlendMaps(page, terrain);
-                }
-            }
+            App::GetGuiManager()->LoadingWindow.SetProgress(47, _L("Importing terrain blendmaps ..."));
+            this->SetupBlendMaps();
         }
 
         // always save the results when it was imported
         if (!m_spec->disable_cache)
         {
-            App::GetGuiManager()->LoadingWindow.SetProgress(50, _L("Saving all terrain pages ..."));
-            m_ogre_terrain_group->saveAllTerrains(false);
+            this->SaveCache();
         }
     }
     else
@@ -546,137 +502,360 @@ void TerrainGeometryManager::SetupLayers(RoR::OTCPage& page, Ogre::Terrain *terr
     LOG("done loading page: loaded " + TOSTRING(layer_idx) + " layers");
 }
 
-void TerrainGeometryManager::SetupBlendMaps(OTCPage& page, Ogre::Terrain* terrain )
-{
-    const int layerCount = terrain->getLayerCount();
-    auto layer_def_itor = page.layers.begin();
-    ++layer_def_itor;
-    for (int i = 1; i < layerCount; i++)
-    {
-        if (layer_def_itor->blendmap_filename.empty())
-            continue;
-
-        Ogre::Image img;
-        try
-        {
-            img.load(layer_def_itor->blendmap_filename, ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
-        }
-        catch (Exception& e)
-        {
-            LOG("Error loading blendmap: " + layer_def_itor->blendmap_filename + " : " + e.getFullDescription());
-            continue;
-        }
+// Internal helpers for importing pages
 
-        TerrainLayerBlendMap* blendmap = terrain->getLayerBlendMap(i);
+struct HeightmapImport
+{
+    OTCPage*               page = nullptr;
+    DataStreamPtr          stream;      //!< File contents; null if the page has no heightmap
+    Image                  image;
+    std::string            error;
+};
 
-        // resize that blending map so it will fit
-        const Ogre::uint32 blendmapSize = terrain->getLayerBlendMapSize();
-        if (img.getWidth() != blendmapSize)
-            img.resize(blendmapSize, blendmapSize);
+struct BlendmapImport
+{
+    const OTCLayer*        layer = nullptr;
+    TerrainLayerBlendMap*  blendmap = nullptr;
+    float*                 blend_data = nullptr;
+    Ogre::uint32           size = 0;
+    DataStreamPtr          stream;      //!< File contents
+    std::string            error;
+};
 
-        // now to the ugly part
-        float* ptr = blendmap->getBlendPointer();
-        for (Ogre::uint32 z = 0; z != blendmapSize; z++)
-        {
-            for (Ogre::uint32 x = 0; x != blendmapSize; x++)
-            {
-                Ogre::ColourValue c = img.getColourAt(x, z, 0);
-                const float alpha = layer_def_itor->alpha;
-                if (layer_def_itor->blend_mode == 'R')
-                    *ptr++ = c.r * alpha;
-                else if (layer_def_itor->blend_mode == 'G')
-                    *ptr++ = c.g * alpha;
-                else if (layer_def_itor->blend_mode == 'B')
-                    *ptr++ = c.b * alpha;
-                else if (layer_def_itor->blend_mode == 'A')
-                    *ptr++ = c.a * alpha;
-            }
-        }
-        blendmap->dirty();
-        blendmap->update();
-        ++layer_def_itor;
-    }
+/// Reads a whole resource, so that it can be decoded on any thread.
+static DataStreamPtr ReadResourceToMemory(std::string const& filename, std::string const& group)
+{
+    DataStreamPtr stream = ResourceGroupManager::getSingleton().openResource(filename, group);
+    return DataStreamPtr(OGRE_NEW MemoryDataStream(filename, stream));
+}
 
-    if (m_spec->blendmap_dbg_enabled)
-    {
-        for (int i = 1; i < layerCount; i++)
-        {
-            Ogre::TerrainLayerBlendMap* blendMap = terrain->getLayerBlendMap(i);
-            Ogre::uint32 blendmapSize = terrain->getLayerBlendMapSize();
-            Ogre::Image img;
-            unsigned short* idata = OGRE_ALLOC_T(unsigned short, blendmapSize * blendmapSize, Ogre::MEMCATEGORY_RESOURCE);
-            float scale = 65535.0f;
-            for (unsigned int x = 0; x < blendmapSize; x++)
-                for (unsigned int z = 0; z < blendmapSize; z++)
-                    idata[x + z * blendmapSize] = (unsigned short)(blendMap->getBlendValue(x, blendmapSize - z) * scale);
-            img.loadDynamicImage((Ogre::uchar*)(idata), blendmapSize, blendmapSize, Ogre::PF_L16);
-            std::string fileName = "blendmap_layer_" + Ogre::StringConverter::toString(i) + ".png";
-            img.save(fileName);
-            OGRE_FREE(idata, Ogre::MEMCATEGORY_RESOURCE);
-        }
-    }
+static std::string GetImageType(std::string const& filename)
+{
+    const size_t pos = filename.find_last_of('.');
+    return (pos != std::string::npos) ? filename.substr(pos + 1) : "";
 }
 
-// Internal helper
-bool LoadHeightmap(OTCPage& page, Image& img)
+static DataStreamPtr OpenHeightmap(OTCPage& page)
 {
     if (page.heightmap_filename.empty())
     {
         LOG("[RoR|Terrain] Empty Heightmap provided in OTC, please use 'Flat=1' instead");
-        return false;
+        return DataStreamPtr();
     }
 
+    DataStreamPtr stream = ReadResourceToMemory(page.heightmap_filename, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
     if (page.heightmap_filename.find(".raw") != String::npos)
     {
-        // load raw data
-        DataStreamPtr stream = ResourceGroupManager::getSingleton().openResource(page.heightmap_filename);
         LOG("[RoR|Terrain] loading RAW image: " + TOSTRING(stream->size()) + " / " + TOSTRING(page.raw_size*page.raw_size*page.raw_bpp));
+    }
+    return stream;
+}
+
+/// Runs on the thread pool.
+static void DecodeHeightmap(OTCPage const& page, DataStreamPtr stream, Image& img)
+{
+    if (page.heightmap_filename.find(".raw") != String::npos)
+    {
         PixelFormat pix_format = (page.raw_bpp == 2) ? PF_L16 : PF_L8;
         img.loadRawData(stream, page.raw_size, page.raw_size, 1, pix_format);
     }
     else
     {
-        img.load(page.heightmap_filename, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+        img.load(stream, GetImageType(page.heightmap_filename));
     }
 
     if (page.raw_flip_x)
         img.flipAroundX();
     if (page.raw_flip_y)
         img.flipAroundY();
+}
 
-    return true;
+/// Runs on the thread pool; each import has its own blend buffer.
+static void DecodeBlendmap(BlendmapImport& import)
+{
+    int channel = 0;
+    switch (import.layer->blend_mode)
+    {
+    case 'R': channel = 0; break;
+    case 'G': channel = 1; break;
+    case 'B': channel = 2; break;
+    case 'A': channel = 3; break;
+    default:  return;
+    }
+
+    Image img;
+    img.load(import.stream, GetImageType(import.layer->blendmap_filename));
+
+    // resize that blending map so it will fit
+    if (img.getWidth() != import.size || img.getHeight() != import.size)
+        img.resize(import.size, import.size);
+
+    // Convert row by row to float RGBA (same values as `Image::getColourAt()`), then pick the channel
+    const PixelBox src = img.getPixelBox();
+    std::vector<float> row(import.size * 4);
+    float* ptr = import.blend_data;
+    const float alpha = import.layer->alpha;
+    for (Ogre::uint32 z = 0; z != import.size; z++)
+    {
+        PixelBox dst_row(import.size, 1, 1, PF_FLOAT32_RGBA, row.data());
+        PixelUtil::bulkPixelConversion(src.getSubVolume(Box(0, z, import.size, z + 1)), dst_row);
+        for (Ogre::uint32 x = 0; x != import.size; x++)
+        {
+            *ptr++ = row[x * 4 + channel] * alpha;
+        }
+    }
 }
 
-void TerrainGeometryManager::SetupGeometry(RoR::OTCPage& page, bool flat)
+#ifdef USE_ZLIB
+/// Writable memory stream which grows as needed; for serializing pages before compressing them.
+class GrowingMemoryStream: public DataStream
 {
-    if (flat)
+public:
+    GrowingMemoryStream(std::vector<char>& buffer): DataStream(DataStream::WRITE), m_buffer(buffer) {}
+
+    size_t read(void* buf, size_t count) override
     {
-        // very simple, no height data to load at all
-        m_ogre_terrain_group->defineTerrain(page.pos_x, page.pos_z, 0.0f);
-        return;
+        count = std::min(count, m_buffer.size() - m_pos);
+        std::memcpy(buf, m_buffer.data() + m_pos, count);
+        m_pos += count;
+        return count;
+    }
+
+    size_t write(const void* buf, size_t count) override
+    {
+        if (m_pos + count > m_buffer.size())
+            m_buffer.resize(m_pos + count);
+        std::memcpy(m_buffer.data() + m_pos, buf, count);
+        m_pos += count;
+        return count;
+    }
+
+    void skip(long count) override { this->seek(static_cast<size_t>(static_cast<long>(m_pos) + count)); }
+    void seek(size_t pos) override { m_pos = std::min(pos, m_buffer.size()); }
+    size_t tell() const override { return m_pos; }
+    bool eof() const override { return m_pos >= m_buffer.size(); }
+    void close() override {}
+
+private:
+    std::vector<char>& m_buffer;
+    size_t             m_pos = 0;
+};
+#endif // USE_ZLIB
+
+void TerrainGeometryManager::SetupBlendMaps()
+{
+    // Read the files here, decode, resample and write them to the blend buffers in parallel
+    std::vector<BlendmapImport> imports;
+    for (OTCPage& page : m_spec->pages)
+    {
+        Ogre::Terrain* terrain = m_ogre_terrain_group->getTerrain(page.pos_x, page.pos_z);
+        if (terrain == nullptr)
+            continue;
+
+        this->SetupLayers(page, terrain);
+
+        // Layer 0 is the base layer, without blendmap
+        const int layerCount = terrain->getLayerCount();
+        auto layer_def_itor = page.layers.begin();
+        for (int i = 1; i < layerCount && ++layer_def_itor != page.layers.end(); i++)
+        {
+            if (layer_def_itor->blendmap_filename.empty())
+                continue;
+
+            BlendmapImport import;
+            import.layer = &*layer_def_itor;
+            import.blendmap = terrain->getLayerBlendMap(i);
+            import.blend_data = import.blendmap->getBlendPointer();
+            import.size = terrain->getLayerBlendMapSize();
+            try
+            {
+                import.stream = ReadResourceToMemory(layer_def_itor->blendmap_filename, ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+            }
+            catch (Exception& e)
+            {
+                LOG("Error loading blendmap: " + layer_def_itor->blendmap_filename + " : " + e.getFullDescription());
+                continue;
+            }
+            imports.push_back(import);
+        }
+    }
+
+    std::vector<std::function<void()>> tasks;
+    for (BlendmapImport& import : imports)
+    {
+        tasks.push_back([&import]
+        {
+            try
+            {
+                DecodeBlendmap(import);
+            }
+            catch (Exception& e)
+            {
+                import.error = e.getFullDescription();
+            }
+        });
+    }
+    App::GetThreadPool()->Parallelize(tasks);
+
+    for (BlendmapImport& import : imports)
+    {
+        if (!import.error.empty())
+        {
+            LOG("Error loading blendmap: " + import.layer->blendmap_filename + " : " + import.error);
+            continue;
+        }
+        import.blendmap->dirty();
+        import.blendmap->update();
+    }
+
+    if (m_spec->blendmap_dbg_enabled)
+    {
+        for (OTCPage& page : m_spec->pages)
+        {
+            Ogre::Terrain* terrain = m_ogre_terrain_group->getTerrain(page.pos_x, page.pos_z);
+            if (terrain == nullptr)
+                continue;
+
+            const int layerCount = terrain->getLayerCount();
+            for (int i = 1; i < layerCount; i++)
+            {
+                Ogre::TerrainLayerBlendMap* blendMap = terrain->getLayerBlendMap(i);
+                Ogre::uint32 blendmapSize = terrain->getLayerBlendMapSize();
+                Ogre::Image img;
+                unsigned short* idata = OGRE_ALLOC_T(unsigned short, blendmapSize * blendmapSize, Ogre::MEMCATEGORY_RESOURCE);
+                float scale = 65535.0f;
+                for (unsigned int x = 0; x < blendmapSize; x++)
+                    for (unsigned int z = 0; z < blendmapSize; z++)
+                        idata[x + z * blendmapSize] = (unsigned short)(blendMap->getBlendValue(x, blendmapSize - z) * scale);
+                img.loadDynamicImage((Ogre::uchar*)(idata), blendmapSize, blendmapSize, Ogre::PF_L16);
+                std::string fileName = "blendmap_layer_" + Ogre::StringConverter::toString(i) + ".png";
+                img.save(fileName);
+                OGRE_FREE(idata, Ogre::MEMCATEGORY_RESOURCE);
+            }
+        }
     }
+}
 
-    const std::string page_cache_filename = m_ogre_terrain_group->generateFilename(page.pos_x, page.pos_z);
+void TerrainGeometryManager::SetupGeometry()
+{
+    // Pages to import get their heightmap files read here, decoded in parallel and defined afterwards
+    std::vector<HeightmapImport> imports;
     const std::string res_group = m_ogre_terrain_group->getResourceGroup();
-    if (!m_spec->disable_cache && ResourceGroupManager::getSingleton().resourceExists(res_group, page_cache_filename))
+    for (OTCPage& page : m_spec->pages)
     {
-        // load from cache
-        m_ogre_terrain_group->defineTerrain(page.pos_x, page.pos_z);
+        if (m_spec->is_flat)
+        {
+            // very simple, no height data to load at all
+            m_ogre_terrain_group->defineTerrain(page.pos_x, page.pos_z, 0.0f);
+            continue;
+        }
+
+        const std::string page_cache_filename = m_ogre_terrain_group->generateFilename(page.pos_x, page.pos_z);
+        if (!m_spec->disable_cache && ResourceGroupManager::getSingleton().resourceExists(res_group, page_cache_filename))
+        {
+            // load from cache
+            m_ogre_terrain_group->defineTerrain(page.pos_x, page.pos_z);
+            continue;
+        }
+
+        HeightmapImport import;
+        import.page = &page;
+        import.stream = OpenHeightmap(page);
+        imports.push_back(import);
     }
-    else
+
+    if (imports.empty())
+        return;
+
+    App::GetGuiManager()->LoadingWindow.SetProgress(42, _L("Importing terrain heightmaps ..."));
+    std::vector<std::function<void()>> tasks;
+    for (HeightmapImport& import : imports)
+    {
+        if (import.stream.isNull())
+            continue;
+
+        tasks.push_back([&import]
+        {
+            try
+            {
+                DecodeHeightmap(*import.page, import.stream, import.image);
+            }
+            catch (Exception& e)
+            {
+                import.error = e.getFullDescription();
+            }
+        });
+    }
+    App::GetThreadPool()->Parallelize(tasks);
+
+    for (HeightmapImport& import : imports)
     {
-        Image img;
-        if (LoadHeightmap(page, img))
+        if (!import.stream.isNull() && import.error.empty())
         {
-            m_ogre_terrain_group->defineTerrain(page.pos_x, page.pos_z, &img);
+            m_ogre_terrain_group->defineTerrain(import.page->pos_x, import.page->pos_z, &import.image);
             m_was_new_geometry_generated = true;
         }
         else
         {
+            if (!import.error.empty())
+            {
+                LOG("[RoR|Terrain] Error loading heightmap: " + import.page->heightmap_filename + " : " + import.error);
+            }
             // fall back to no heightmap
-            m_ogre_terrain_group->defineTerrain(page.pos_x, page.pos_z, 0.0f);
+            m_ogre_terrain_group->defineTerrain(import.page->pos_x, import.page->pos_z, 0.0f);
+        }
+    }
+}
+
+void TerrainGeometryManager::SaveCache()
+{
+#ifdef USE_ZLIB
+    // `Ogre::Terrain::save()` may read data back from the GPU, so pages are serialized here;
+    // compressing (which is most of the work) and writing the files runs on the thread pool.
+    // The result is what `Ogre::TerrainGroup::saveAllTerrains()` writes: zlib-compressed `StreamSerialiser` data.
+    std::vector<std::pair<OTCPage*, Ogre::Terrain*>> pages;
+    for (OTCPage& page : m_spec->pages)
+    {
+        Ogre::Terrain* terrain = m_ogre_terrain_group->getTerrain(page.pos_x, page.pos_z);
+        if (terrain != nullptr)
+            pages.push_back(std::make_pair(&page, terrain));
+    }
+
+    auto pages_left = std::make_shared<std::atomic<int>>(static_cast<int>(pages.size()));
+    for (size_t i = 0; i < pages.size(); i++)
+    {
+        App::GetGuiManager()->LoadingWindow.SetProgress(50 + static_cast<int>((9 * i) / pages.size()),
+            fmt::format(_L("Saving terrain page {}/{} ..."), i + 1, pages.size()));
+
+        auto buffer = std::make_shared<std::vector<char>>();
+        {
+            DataStreamPtr memory_stream(OGRE_NEW GrowingMemoryStream(*buffer));
+            StreamSerialiser serialiser(memory_stream);
+            pages[i].second->save(serialiser);
         }
+
+        const std::string filename = m_ogre_terrain_group->generateFilename(pages[i].first->pos_x, pages[i].first->pos_z);
+        DataStreamPtr file = ResourceGroupManager::getSingleton().createResource(filename, m_ogre_terrain_group->getResourceGroup(), /*overwrite=*/true);
+        m_cache_save_tasks.push_back(App::GetThreadPool()->RunTask([buffer, file, pages_left]()
+        {
+            uLongf compressed_size = compressBound(static_cast<uLong>(buffer->size()));
+            std::vector<Bytef> compressed(compressed_size);
+            if (compress2(compressed.data(), &compressed_size, reinterpret_cast<const Bytef*>(buffer->data()), static_cast<uLong>(buffer->size()), Z_DEFAULT_COMPRESSION) == Z_OK)
+                file->write(compressed.data(), compressed_size);
+            else
+                file->write(buffer->data(), buffer->size()); // `Ogre::DeflateStream` reads uncompressed data as-is
+            file->close();
+
+            if (--(*pages_left) == 0)
+            {
+                App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, Console::CONSOLE_SYSTEM_NOTICE, _L("Terrain cache saved"));
+            }
+        }));
     }
+#else
+    App::GetGuiManager()->LoadingWindow.SetProgress(50, _L("Saving all terrain pages ..."));
+    m_ogre_terrain_group->saveAllTerrains(false);
+#endif // USE_ZLIB
 }
 
 Ogre::Vector3 TerrainGeometryManager::getMaxTerrainSize()
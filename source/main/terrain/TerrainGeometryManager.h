@@ -24,6 +24,7 @@
 #include "Application.h"
 #include "ConfigFile.h"
 #include "OTCFileFormat.h"
+#include "TerrainHeightPages.h"
 
 #include <OgreVector3.h>
 #include <Terrain/OgreTerrain.h>
@@ -47,6 +48,11 @@ public:
 
     float getHeightAt(float x, float z);
 
+    /// Finds where a segment first reaches the surface reported by `getHeightAt()`, stepping exactly through heightmap cells.
+    /// @param ray Segment from `ray.getOrigin()` to `ray.getPoint(1)`
+    /// @return Hit flag and distance as `Ogre::Ray::getPoint()` parameter [0-1]; 0 if the segment starts below the surface.
+    std::pair<bool, Ogre::Real> intersectsRay(const Ogre::Ray& ray);
+
     Ogre::Vector3 getNormalAt(float x, float y, float z);
 
     Ogre::Vector3 getMaxTerrainSize();
@@ -58,13 +64,14 @@ public:
 
 private:
 
-    float getHeightAtTerrainPosition(float x, float z);
+    void  buildHeightPages();
 
     bool getTerrainImage(int x, int y, Ogre::Image& img);
     bool loadTerrainConfig(Ogre::String filename);
     void configureTerrainDefaults();
-    void SetupGeometry(RoR::OTCPage& page, bool flat=false);
-    void SetupBlendMaps(RoR::OTCPage& page, Ogre::Terrain* t);
+    void SetupGeometry();               //!< Defines all pages; heightmaps to import are decoded in parallel.
+    void SetupBlendMaps();              //!< Fills blendmaps of all loaded pages; images are decoded and resampled in parallel.
+    void SaveCache();                   //!< Serializes pages to `.mapbin`; compression and writing run in the background.
     void initTerrain();
     void SetupLayers(RoR::OTCPage& page, Ogre::Terrain *terrain);
     Ogre::DataStreamPtr getPageConfig(int x, int z);
@@ -73,13 +80,9 @@ private:
     RoR::Terrain*      terrainManager;
     Ogre::TerrainGroup*  m_ogre_terrain_group;
     bool                 m_was_new_geometry_generated;
+    std::vector<std::shared_ptr<Task>> m_cache_save_tasks; //!< Joined before the pages go away
 
-    // Terrn position lookup - ported from OGRE engine.
-    Ogre::Vector3 mPos = Ogre::Vector3::ZERO;
-    Ogre::Real mBase = 0.f;
-    Ogre::Real mScale = 0.f;
-    Ogre::uint16 mSize = 0;
-    float* mHeightData = nullptr;
+    TerrainHeightPages   m_height_pages;      //!< Read by `getHeightAt()` and `intersectsRay()`
 
     bool  mIsFlat;
     float mMinHeight;
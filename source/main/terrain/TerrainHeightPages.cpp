@@ -0,0 +1,384 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2005-2012 Pierre-Michel Ricordel
+    Copyright 2007-2012 Thomas Fischer
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TerrainHeightPages.h"
+
+#include "GridRayWalk.h"
+
+#include <OgreMath.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Ogre;
+using namespace RoR;
+
+void TerrainHeightPages::Setup(Vector3 const& slot_origin, float world_size, uint16 size, int min_x, int min_y, int cols, int rows)
+{
+    mPos = slot_origin;
+    mSize = size;
+    mBase = -world_size * 0.5f;
+    mScale = world_size / (Real)(mSize - 1);
+
+    m_pages.clear();
+    m_pages.resize(cols * rows);
+    m_pages_min_x = min_x;
+    m_pages_min_y = min_y;
+    m_pages_cols = cols;
+    m_pages_rows = rows;
+    m_max_height = -std::numeric_limits<float>::max();
+}
+
+void TerrainHeightPages::Clear()
+{
+    m_pages.clear();
+    m_pages_cols = 0;
+    m_pages_rows = 0;
+}
+
+TerrainHeightPages::HeightPage const& TerrainHeightPages::SetPage(int slot_x, int slot_y, float* height_data)
+{
+    HeightPage& hpage = m_pages[(slot_y - m_pages_min_y) * m_pages_cols + (slot_x - m_pages_min_x)];
+    hpage.height_data = height_data;
+
+    // terrain->getMinHeight() / terrain->getMaxHeight() seem to be unreliable ~ ulteq 12/18
+    hpage.min_height = hpage.height_data[0];
+    hpage.max_height = hpage.height_data[0];
+    for (int i = 0; i < mSize * mSize; i++)
+    {
+        hpage.min_height = std::min(hpage.min_height, hpage.height_data[i]);
+        hpage.max_height = std::max(hpage.max_height, hpage.height_data[i]);
+    }
+    hpage.is_flat = std::abs(hpage.max_height - hpage.min_height) < std::numeric_limits<float>::epsilon();
+
+    m_max_height = std::max(m_max_height, hpage.max_height);
+    return hpage;
+}
+
+float TerrainHeightPages::GetHeightAt(float x, float z, float outside_height) const
+{
+    float tx, ty;
+    const HeightPage* page = this->findHeightPage(x, z, tx, ty);
+
+    if (page == nullptr)
+        return outside_height;
+    else if (page->is_flat)
+        return page->min_height;
+
+    return getHeightAtTerrainPosition(*page, tx, ty);
+}
+
+/// @author Ported from OGRE engine, www.ogre3d.org, file OgreTerrain.cpp
+float TerrainHeightPages::getHeightAtTerrainPosition(const HeightPage& page, Real x, Real y) const
+{
+    // get left / bottom points (rounded down)
+    Real factor = (Real)mSize - 1.0f;
+    Real invFactor = 1.0f / factor;
+
+    // The page edge (x or y == 1) is sampled from the last cell
+    long startX = std::min(static_cast<long>(x * factor), static_cast<long>(mSize) - 2);
+    long startY = std::min(static_cast<long>(y * factor), static_cast<long>(mSize) - 2);
+    long endX = startX + 1;
+    long endY = startY + 1;
+
+    // now get points in terrain space (effectively rounding them to boundaries)
+    // note that we do not clamp! We need a valid plane
+    Real startXTS = startX * invFactor;
+    Real startYTS = startY * invFactor;
+    Real endXTS = endX * invFactor;
+    Real endYTS = endY * invFactor;
+
+    // get parametric from start coord to next point
+    Real xParam = (x * factor - startX);
+    Real yParam = (y * factor - startY);
+
+    /* For even / odd tri strip rows, triangles are this shape:
+    even     odd
+    3---2   3---2
+    | / |   | \ |
+    0---1   0---1
+    */
+
+    // Build all 4 positions in terrain space, using point-sampled height
+    const float* heightData = page.height_data;
+    Vector3 v0(startXTS, startYTS, heightData[startY * mSize + startX]);
+    Vector3 v1(endXTS  , startYTS, heightData[startY * mSize + endX]);
+    Vector3 v2(endXTS  , endYTS  , heightData[endY   * mSize + endX]);
+    Vector3 v3(startXTS, endYTS  , heightData[endY   * mSize + startX]);
+
+    // define this plane in terrain space
+    Vector3 normal;
+    Real d;
+    if (startY % 2)
+    {
+        // odd row
+        bool secondTri = ((1.0 - yParam) > xParam);
+        if (secondTri)
+        {
+            normal = (v1 - v0).crossProduct(v3 - v0);
+            d = -normal.dotProduct(v0);
+        }
+        else
+        {
+            normal = (v2 - v1).crossProduct(v3 - v1);
+            d = -normal.dotProduct(v1);
+        }
+    }
+    else
+    {
+        // even row
+        bool secondTri = (yParam > xParam);
+        if (secondTri)
+        {
+            normal = (v2 - v0).crossProduct(v3 - v0);
+            d = -normal.dotProduct(v0);
+        }
+        else
+        {
+            normal = (v1 - v0).crossProduct(v2 - v0);
+            d = -normal.dotProduct(v0);
+        }
+    }
+
+    // Solve plane equation for z
+    return (-normal.x * x - normal.y * y - d) / normal.z;
+}
+
+const TerrainHeightPages::HeightPage* TerrainHeightPages::findHeightPage(float x, float z, float& out_x, float& out_y) const
+{
+    // Terrain space of the whole group, in page units; slot Y runs towards -Z (Ogre::Terrain::ALIGN_X_Z)
+    const float tx = (x - mBase - mPos.x) / ((mSize - 1) *  mScale);
+    const float ty = (z + mBase - mPos.z) / ((mSize - 1) * -mScale);
+
+    const float slot_x = std::floor(tx);
+    const float slot_y = std::floor(ty);
+
+    // Compare as floats first - huge or NaN coordinates must not reach the int conversion
+    if (!(slot_x >= m_pages_min_x && slot_x < m_pages_min_x + m_pages_cols &&
+          slot_y >= m_pages_min_y && slot_y < m_pages_min_y + m_pages_rows))
+    {
+        return nullptr;
+    }
+
+    const int col = static_cast<int>(slot_x) - m_pages_min_x;
+    const int row = static_cast<int>(slot_y) - m_pages_min_y;
+    const HeightPage& page = m_pages[row * m_pages_cols + col];
+    if (page.height_data == nullptr)
+    {
+        return nullptr;
+    }
+
+    out_x = tx - slot_x;
+    out_y = ty - slot_y;
+    return &page;
+}
+
+const TerrainHeightPages::HeightPage* TerrainHeightPages::findHeightPageCell(long cell_x, long cell_y, int& out_x, int& out_y) const
+{
+    const long cells_per_page = mSize - 1;
+    const long slot_x = (cell_x >= 0) ? (cell_x / cells_per_page) : -((cells_per_page - 1 - cell_x) / cells_per_page);
+    const long slot_y = (cell_y >= 0) ? (cell_y / cells_per_page) : -((cells_per_page - 1 - cell_y) / cells_per_page);
+
+    if (slot_x < m_pages_min_x || slot_x >= m_pages_min_x + m_pages_cols ||
+        slot_y < m_pages_min_y || slot_y >= m_pages_min_y + m_pages_rows)
+    {
+        return nullptr;
+    }
+
+    const HeightPage& page = m_pages[(slot_y - m_pages_min_y) * m_pages_cols + (slot_x - m_pages_min_x)];
+    if (page.height_data == nullptr)
+    {
+        return nullptr;
+    }
+
+    out_x = static_cast<int>(cell_x - slot_x * cells_per_page);
+    out_y = static_cast<int>(cell_y - slot_y * cells_per_page);
+    return &page;
+}
+
+/// First parameter within [t_begin, t_end] where `origin_y + dir_y * t` is at or below `height`.
+static std::pair<bool, Ogre::Real> IntersectsHeightLevel(float origin_y, float dir_y, float height, float t_begin, float t_end)
+{
+    if (origin_y + dir_y * t_begin <= height)
+        return std::make_pair(true, t_begin);
+    if (dir_y < 0.f)
+    {
+        const float t = (height - origin_y) / dir_y;
+        if (t <= t_end)
+            return std::make_pair(true, t);
+    }
+    return std::make_pair(false, 0.f);
+}
+
+std::pair<bool, Ogre::Real> TerrainHeightPages::IntersectsLevel(const Ogre::Ray& ray, float height)
+{
+    return IntersectsHeightLevel(ray.getOrigin().y, ray.getDirection().y, height, 0.f, 1.f);
+}
+
+std::pair<bool, Ogre::Real> TerrainHeightPages::IntersectsRay(const Ogre::Ray& ray, float outside_height) const
+{
+    const Vector3 origin = ray.getOrigin();
+    const Vector3 dir = ray.getDirection();
+
+    const float lowest_y = std::min(origin.y, origin.y + dir.y);
+    if (m_pages_cols == 0 || lowest_y > std::max(m_max_height, outside_height))
+    {
+        return IntersectsHeightLevel(origin.y, dir.y, outside_height, 0.f, 1.f);
+    }
+
+    // Heightmap cells are numbered across the whole page table; X grows towards +X, Y towards -Z (see `findHeightPage()`)
+    const long cells_per_page = mSize - 1;
+    const float grid_x = mPos.x + mBase; // World X of cell column 0
+    const float grid_z = mPos.z - mBase; // World Z of cell row 0
+    const float inv_scale = 1.f / mScale;
+
+    // Clip the segment to the area covered by the page table
+    const float area_x[2] = { grid_x + m_pages_min_x * cells_per_page * mScale,
+                              grid_x + (m_pages_min_x + m_pages_cols) * cells_per_page * mScale };
+    const float area_z[2] = { grid_z - (m_pages_min_y + m_pages_rows) * cells_per_page * mScale,
+                              grid_z - m_pages_min_y * cells_per_page * mScale };
+    float t_enter = 0.f;
+    float t_leave = 1.f;
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        const float o = (axis == 0) ? origin.x : origin.z;
+        const float d = (axis == 0) ? dir.x : dir.z;
+        const float* area = (axis == 0) ? area_x : area_z;
+        if (d == 0.f)
+        {
+            if (o < area[0] || o > area[1])
+                t_enter = 2.f; // Parallel and outside
+            continue;
+        }
+        float t0 = (area[0] - o) / d;
+        float t1 = (area[1] - o) / d;
+        if (t0 > t1)
+            std::swap(t0, t1);
+        t_enter = std::max(t_enter, t0);
+        t_leave = std::min(t_leave, t1);
+    }
+    if (t_enter > t_leave)
+    {
+        return IntersectsHeightLevel(origin.y, dir.y, outside_height, 0.f, 1.f);
+    }
+
+    if (t_enter > 0.f)
+    {
+        auto result = IntersectsHeightLevel(origin.y, dir.y, outside_height, 0.f, t_enter);
+        if (result.first)
+            return result;
+    }
+
+    // 2D DDA through heightmap cells, in cell units
+    const float grid_origin_u = (origin.x - grid_x) * inv_scale;
+    const float grid_origin_v = (grid_z - origin.z) * inv_scale;
+    long cell_x = static_cast<long>(std::floor(grid_origin_u + dir.x * inv_scale * t_enter));
+    long cell_y = static_cast<long>(std::floor(grid_origin_v - dir.z * inv_scale * t_enter));
+    cell_x = Math::Clamp(cell_x, m_pages_min_x * cells_per_page, (m_pages_min_x + m_pages_cols) * cells_per_page - 1);
+    cell_y = Math::Clamp(cell_y, m_pages_min_y * cells_per_page, (m_pages_min_y + m_pages_rows) * cells_per_page - 1);
+
+    GridRayWalk walk(grid_origin_u, grid_origin_v, dir.x * inv_scale, -dir.z * inv_scale, t_enter, t_leave, cell_x, cell_y);
+    while (true)
+    {
+        cell_x = walk.GetCellU();
+        cell_y = walk.GetCellV();
+        const float t_cell = walk.GetCellEnter();
+        const float t_exit = walk.GetCellExit();
+
+        int local_x, local_y;
+        const HeightPage* page = this->findHeightPageCell(cell_x, cell_y, local_x, local_y);
+        if (page == nullptr)
+        {
+            auto result = IntersectsHeightLevel(origin.y, dir.y, outside_height, t_cell, t_exit);
+            if (result.first)
+                return result;
+        }
+        else if (std::min(origin.y + dir.y * t_cell, origin.y + dir.y * t_exit) <= page->max_height)
+        {
+            // Cell corners, named as in `getHeightAtTerrainPosition()`
+            const float* h = page->height_data;
+            const float h0 = h[local_y * mSize + local_x];
+            const float h1 = h[local_y * mSize + local_x + 1];
+            const float h2 = h[(local_y + 1) * mSize + local_x + 1];
+            const float h3 = h[(local_y + 1) * mSize + local_x];
+
+            // Ray in cell space [0-1]: u = u0 + du * t, v = v0 + dv * t
+            const float du = dir.x * inv_scale;
+            const float dv = -dir.z * inv_scale;
+            const float u0 = (origin.x - (grid_x + cell_x * mScale)) * inv_scale;
+            const float v0 = ((grid_z - cell_y * mScale) - origin.z) * inv_scale;
+
+            // The diagonal splitting the cell into 2 triangles alternates by row, see `getHeightAtTerrainPosition()`
+            const bool odd_row = (local_y % 2) != 0;
+            auto diagonal = [&](float t) { const float u = u0 + du * t, v = v0 + dv * t; return odd_row ? (u + v - 1.f) : (v - u); };
+
+            float t_pieces[3] = { t_cell, t_exit, t_exit };
+            const float g0 = diagonal(t_cell);
+            const float g1 = diagonal(t_exit);
+            if ((g0 < 0.f) != (g1 < 0.f) && g0 != g1)
+            {
+                t_pieces[1] = Math::Clamp(t_cell + (t_exit - t_cell) * g0 / (g0 - g1), t_cell, t_exit);
+            }
+
+            for (int i = 0; i < 2; ++i)
+            {
+                const float ta = t_pieces[i];
+                const float tb = t_pieces[i + 1];
+                if (i == 1 && ta == tb)
+                    break;
+
+                // Height plane of the triangle under this piece: h = a * u + b * v + c
+                const float g = diagonal((ta + tb) * 0.5f);
+                const bool second_tri = odd_row ? (g < 0.f) : (g > 0.f);
+                float a, b, c;
+                if (odd_row)
+                {
+                    if (second_tri) { a = h1 - h0; b = h3 - h0; c = h0;         } // 0, 1, 3
+                    else            { a = h2 - h3; b = h2 - h1; c = h1 + h3 - h2; } // 1, 2, 3
+                }
+                else
+                {
+                    if (second_tri) { a = h2 - h3; b = h3 - h0; c = h0;         } // 0, 2, 3
+                    else            { a = h1 - h0; b = h2 - h1; c = h0;         } // 0, 1, 2
+                }
+
+                const float fa = origin.y + dir.y * ta - (a * (u0 + du * ta) + b * (v0 + dv * ta) + c);
+                if (fa <= 0.f)
+                    return std::make_pair(true, ta);
+                const float fb = origin.y + dir.y * tb - (a * (u0 + du * tb) + b * (v0 + dv * tb) + c);
+                if (fb <= 0.f)
+                    return std::make_pair(true, ta + (tb - ta) * fa / (fa - fb));
+            }
+        }
+
+        if (walk.IsLastCell())
+            break;
+
+        walk.Step();
+    }
+
+    if (t_leave < 1.f)
+    {
+        return IntersectsHeightLevel(origin.y, dir.y, outside_height, t_leave, 1.f);
+    }
+    return std::make_pair(false, 0.f);
+}
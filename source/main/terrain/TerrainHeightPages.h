@@ -0,0 +1,98 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Height lookups of `TerrainGeometryManager`, without the `Ogre::Terrain` pages they read from.
+
+#pragma once
+
+#include <OgreRay.h>
+#include <OgreVector3.h>
+
+#include <utility>
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Terrain
+/// @{
+
+/// Page table over the heightmaps of an `Ogre::TerrainGroup`, indexed directly from world X/Z.
+/// Page slot Y runs towards -Z (Ogre::Terrain::ALIGN_X_Z); so do the heightmap rows.
+class TerrainHeightPages
+{
+public:
+    struct HeightPage
+    {
+        float*        height_data = nullptr;   //!< Owned by the `Ogre::Terrain`; nullptr = no page in this slot.
+        float         min_height = 0.f;
+        float         max_height = 0.f;
+        bool          is_flat = false;
+    };
+
+    /// Creates empty page slots [min_x, min_x + cols) x [min_y, min_y + rows).
+    /// @param slot_origin World position of the center of slot (0, 0), see `Ogre::TerrainGroup::convertTerrainSlotToWorldPosition()`
+    /// @param world_size Page edge length, the same for all pages of a group
+    /// @param size Heightmap samples along the page edge
+    void Setup(Ogre::Vector3 const& slot_origin, float world_size, Ogre::uint16 size, int min_x, int min_y, int cols, int rows);
+    void Clear();
+    bool IsEmpty() const { return m_pages.empty(); }
+
+    /// Puts a heightmap of `size * size` samples (not copied) in a slot; computes its height range.
+    HeightPage const& SetPage(int slot_x, int slot_y, float* height_data);
+
+    /// @return The height at x/z, `outside_height` where there's no page.
+    float GetHeightAt(float x, float z, float outside_height) const;
+
+    /// Finds where a segment first reaches the surface reported by `GetHeightAt()`, stepping exactly through heightmap cells.
+    /// @param ray Segment from `ray.getOrigin()` to `ray.getPoint(1)`
+    /// @return Hit flag and distance as `Ogre::Ray::getPoint()` parameter [0-1]; 0 if the segment starts below the surface.
+    std::pair<bool, Ogre::Real> IntersectsRay(const Ogre::Ray& ray, float outside_height) const;
+    /// Same as `IntersectsRay()` against a level plane, for terrains without pages.
+    static std::pair<bool, Ogre::Real> IntersectsLevel(const Ogre::Ray& ray, float height);
+
+private:
+
+    /// @param out_x Position within the page, in terrain space [0-1]
+    /// @param out_y Position within the page, in terrain space [0-1]
+    /// @return nullptr if there's no page at x/z.
+    const HeightPage* findHeightPage(float x, float z, float& out_x, float& out_y) const;
+    /// @param cell_x Heightmap cell column, counted across all page slots
+    /// @param cell_y Heightmap cell row, counted across all page slots
+    /// @return nullptr if there's no page at the cell; `out_x/out_y` = cell within the page.
+    const HeightPage* findHeightPageCell(long cell_x, long cell_y, int& out_x, int& out_y) const;
+    float getHeightAtTerrainPosition(const HeightPage& page, float x, float y) const;
+
+    // Terrn position lookup - ported from OGRE engine.
+    Ogre::Vector3 mPos = Ogre::Vector3::ZERO; //!< Center of page slot (0, 0)
+    Ogre::Real mBase = 0.f;
+    Ogre::Real mScale = 0.f;
+    Ogre::uint16 mSize = 0;
+
+    std::vector<HeightPage> m_pages;  //!< Row-major, `m_pages_cols` slots per row.
+    int                     m_pages_min_x = 0; //!< Page slot of column 0
+    int                     m_pages_min_y = 0; //!< Page slot of row 0
+    int                     m_pages_cols = 0;
+    int                     m_pages_rows = 0;
+    float                   m_max_height = 0.f; //!< Over all pages set
+};
+
+/// @} // addtogroup Terrain
+
+} // namespace RoR
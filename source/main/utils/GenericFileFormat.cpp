@@ -23,6 +23,8 @@
 #include "Console.h"
 
 #include <algorithm>
+#include <cerrno>
+#include <cstdlib>
 
 using namespace RoR;
 using namespace Ogre;
@@ -49,6 +51,27 @@ enum class PartialToken
     GARBAGE,                       // Text not fitting any above category, will be discarded
 };
 
+static Token MakeToken(TokenType type, int64_t value = 0)
+{
+    Token tok;
+    tok.type = type;
+    tok.is_integer = (type == TokenType::NUMBER || type == TokenType::BOOL);
+    tok.data.integer = value;
+    return tok;
+}
+
+static bool IsPlainChar(const char c) // Not a separator, quote or bracket; ASCII only
+{
+    switch (c)
+    {
+    case ' ': case ',': case '\t': case '\r': case '\n':
+    case ':': case '=': case '"': case '(': case ')':
+        return false;
+    default:
+        return (c & 0x80) == 0;
+    }
+}
+
 struct DocumentParser
 {
     DocumentParser(GenericDocument& d, const BitMask_t opt, Ogre::DataStreamPtr ds)
@@ -66,6 +89,8 @@ struct DocumentParser
     PartialToken partial_tok_type = PartialToken::NONE;
     bool title_found = false; // Only for OPTION_FIRST_LINE_IS_TITLE
 
+    void ParseChar(const char c);
+    size_t ScanRun(const char* buf, const size_t len);
     void BeginToken(const char c);
     void UpdateComment(const char c);
     void UpdateString(const char c);
@@ -80,8 +105,76 @@ struct DocumentParser
     void DiscontinueKeyword();
     void FlushStringishToken(RoR::TokenType type);
     void FlushNumericToken();
+    void BreakLine();
 };
 
+/// Consumes the longest run of characters (never CR/LF) which the current partial token
+/// would process one by one without changing state, so the per-character handlers
+/// only see the characters which matter. Returns the number of characters consumed.
+size_t DocumentParser::ScanRun(const char* buf, const size_t len)
+{
+    size_t n = 0;
+    switch (partial_tok_type)
+    {
+    case PartialToken::NONE: // Skip separators
+        while (n < len && (buf[n] == ' ' || buf[n] == ',' || buf[n] == '\t'))
+            n++;
+        line_pos += n;
+        return n;
+
+    case PartialToken::COMMENT_SLASH:
+        if (tok.size() == 0)
+            return 0; // Leading '/' are skipped
+        // fall through
+    case PartialToken::COMMENT_SEMICOLON:
+    case PartialToken::COMMENT_HASH:
+    case PartialToken::TITLE_STRING:
+        while (n < len && buf[n] != '\r' && buf[n] != '\n')
+            n++;
+        break;
+
+    case PartialToken::STRING_QUOTED:
+        while (n < len && buf[n] != '"' && buf[n] != '\r' && buf[n] != '\n')
+            n++;
+        break;
+
+    case PartialToken::STRING_NAKED:
+        while (n < len && IsPlainChar(buf[n]))
+            n++;
+        break;
+
+    case PartialToken::STRING_NAKED_CAPTURING_SPACES:
+        while (n < len && (buf[n] == ' ' || IsPlainChar(buf[n])))
+            n++;
+        break;
+
+    case PartialToken::NUMBER_INTEGER:
+    case PartialToken::NUMBER_DECIMAL:
+    case PartialToken::NUMBER_SCIENTIFIC:
+        while (n < len && buf[n] >= '0' && buf[n] <= '9')
+            n++;
+        break;
+
+    case PartialToken::KEYWORD:
+    case PartialToken::KEYWORD_BRACED:
+        while (n < len && (buf[n] & 0x80) == 0 && (isalnum(buf[n]) || buf[n] == '_'))
+            n++;
+        break;
+
+    case PartialToken::GARBAGE:
+        while (n < len && buf[n] != ' ' && buf[n] != ',' && buf[n] != '\t' && buf[n] != '\r' && buf[n] != '\n')
+            n++;
+        break;
+
+    default:
+        return 0;
+    }
+
+    tok.insert(tok.end(), buf, buf + n);
+    line_pos += n;
+    return n;
+}
+
 void DocumentParser::BeginToken(const char c)
 {
     switch (c)
@@ -128,9 +221,7 @@ void DocumentParser::BeginToken(const char c)
         break;
 
     case '\n':
-        doc.tokens.push_back({ TokenType::LINEBREAK, 0.f });
-        line_num++;
-        line_pos = 0;
+        this->BreakLine();
         break;
 
     case ';':
@@ -273,10 +364,7 @@ void DocumentParser::UpdateComment(const char c)
 
     case '\n':
         this->FlushStringishToken(TokenType::COMMENT);
-        // Break line
-        doc.tokens.push_back({ TokenType::LINEBREAK, 0.f });
-        line_num++;
-        line_pos = 0;
+        this->BreakLine();
         break;
 
     case '/':
@@ -334,10 +422,7 @@ void DocumentParser::UpdateString(const char c)
                 fmt::format("{}, line {}, pos {}: quoted string interrupted by newline", datastream->getName(), line_num, line_pos));
         }
         this->FlushStringishToken(TokenType::STRING);
-        // Break line
-        doc.tokens.push_back({ TokenType::LINEBREAK, 0.f });
-        line_num++;
-        line_pos = 0;
+        this->BreakLine();
         break;
 
     case ':':
@@ -427,10 +512,7 @@ void DocumentParser::UpdateNumber(const char c)
 
     case '\n':
         this->FlushNumericToken();
-        // Break line
-        doc.tokens.push_back({ TokenType::LINEBREAK, 0.f });
-        line_num++;
-        line_pos = 0;
+        this->BreakLine();
         break;
 
     case ':':
@@ -560,10 +642,7 @@ void DocumentParser::UpdateBool(const char c)
             fmt::format("{}, line {}, pos {}: discarding incomplete boolean token '{}'", datastream->getName(), line_num, line_pos, tok.data()));
         tok.clear();
         partial_tok_type = PartialToken::NONE;
-        // Break line
-        doc.tokens.push_back({ TokenType::LINEBREAK, 0.f });
-        line_num++;
-        line_pos = 0;
+        this->BreakLine();
         break;
 
     case ':':
@@ -650,13 +729,13 @@ void DocumentParser::UpdateBool(const char c)
     case 'e':
         if (partial_tok_type == PartialToken::BOOL_TRUE && tok.size() == 3)
         {
-            doc.tokens.push_back({ TokenType::BOOL, 1.f });
+            doc.tokens.push_back(MakeToken(TokenType::BOOL, 1));
             tok.clear();
             partial_tok_type = PartialToken::NONE;
         }
         else if (partial_tok_type == PartialToken::BOOL_FALSE && tok.size() == 4)
         {
-            doc.tokens.push_back({ TokenType::BOOL, 0.f });
+            doc.tokens.push_back(MakeToken(TokenType::BOOL, 0));
             tok.clear();
             partial_tok_type = PartialToken::NONE;
         }
@@ -724,10 +803,7 @@ void DocumentParser::UpdateKeyword(const char c)
 
     case '\n':
         this->FlushStringishToken(TokenType::KEYWORD);
-        // Break line
-        doc.tokens.push_back({ TokenType::LINEBREAK, 0.f });
-        line_num++;
-        line_pos = 0;
+        this->BreakLine();
         break;
 
     case ':':
@@ -816,10 +892,7 @@ void DocumentParser::UpdateTitle(const char c)
 
     case '\n':
         this->FlushStringishToken(TokenType::STRING);
-        // Break line
-        doc.tokens.push_back({ TokenType::LINEBREAK, 0.f });
-        line_num++;
-        line_pos = 0;
+        this->BreakLine();
         break;
 
     default:
@@ -857,9 +930,11 @@ void DocumentParser::UpdateGarbage(const char c)
 
 void DocumentParser::FlushStringishToken(RoR::TokenType type)
 {
-    doc.tokens.push_back({ type, (float)doc.string_pool.size() });
-    tok.push_back('\0');
-    std::copy(tok.begin(), tok.end(), std::back_inserter(doc.string_pool));
+    Token t = MakeToken(type);
+    t.data.offset = doc.string_pool.size();
+    doc.tokens.push_back(t);
+    doc.string_pool.insert(doc.string_pool.end(), tok.begin(), tok.end());
+    doc.string_pool.push_back('\0');
     tok.clear();
     partial_tok_type = PartialToken::NONE;
 }
@@ -867,82 +942,131 @@ void DocumentParser::FlushStringishToken(RoR::TokenType type)
 void DocumentParser::FlushNumericToken()
 {
     tok.push_back('\0');
-    doc.tokens.push_back({ TokenType::NUMBER, (float)Ogre::StringConverter::parseReal(tok.data()) });
+    Token t = MakeToken(TokenType::NUMBER);
+    t.is_integer = false;
+    if (partial_tok_type == PartialToken::NUMBER_INTEGER)
+    {
+        // Keep integers exact, fall back to double if out of range
+        char* end = nullptr;
+        errno = 0;
+        const long long value = std::strtoll(tok.data(), &end, 10);
+        if (errno == 0 && end != tok.data() && *end == '\0')
+        {
+            t.is_integer = true;
+            t.data.integer = value;
+        }
+    }
+    if (!t.is_integer)
+    {
+        // Incomplete numbers like '1e' read as 0
+        char* end = nullptr;
+        t.data.number = std::strtod(tok.data(), &end);
+        if (*end != '\0')
+        {
+            t.data.number = 0.0;
+        }
+    }
+    doc.tokens.push_back(t);
     tok.clear();
     partial_tok_type = PartialToken::NONE;
 }
 
+void DocumentParser::BreakLine()
+{
+    doc.tokens.push_back(MakeToken(TokenType::LINEBREAK));
+    line_num++;
+    line_pos = 0;
+}
+
+void DocumentParser::ParseChar(const char c)
+{
+    switch (this->partial_tok_type)
+    {
+    case PartialToken::NONE:
+        this->BeginToken(c);
+        break;
+
+    case PartialToken::COMMENT_SEMICOLON:
+    case PartialToken::COMMENT_SLASH:
+    case PartialToken::COMMENT_HASH:
+        this->UpdateComment(c);
+        break;
+
+    case PartialToken::STRING_QUOTED:
+    case PartialToken::STRING_NAKED:
+    case PartialToken::STRING_NAKED_CAPTURING_SPACES:
+        this->UpdateString(c);
+        break;
+
+    case PartialToken::NUMBER_INTEGER:
+    case PartialToken::NUMBER_DECIMAL:
+    case PartialToken::NUMBER_SCIENTIFIC:
+    case PartialToken::NUMBER_SCIENTIFIC_STUB:
+    case PartialToken::NUMBER_SCIENTIFIC_STUB_MINUS:
+        this->UpdateNumber(c);
+        break;
+
+    case PartialToken::BOOL_TRUE:
+    case PartialToken::BOOL_FALSE:
+        this->UpdateBool(c);
+        break;
+
+    case PartialToken::KEYWORD:
+    case PartialToken::KEYWORD_BRACED:
+        this->UpdateKeyword(c);
+        break;
+
+    case PartialToken::TITLE_STRING:
+        this->UpdateTitle(c);
+        break;
+
+    case PartialToken::GARBAGE:
+        this->UpdateGarbage(c);
+        break;
+    }
+}
+
 void GenericDocument::loadFromDataStream(Ogre::DataStreamPtr datastream, const BitMask_t options)
 {
     // Reset the document
     tokens.clear();
     string_pool.clear();
+    line_starts.clear();
 
     // Prepare context
     DocumentParser parser(*this, options, datastream);
-    const size_t LINE_BUF_MAX = 10 * 1024; // 10Kb
-    char buf[LINE_BUF_MAX];
+    const size_t BUF_MAX = 64 * 1024; // 64Kb
+    std::vector<char> buf(BUF_MAX);
 
     // Parse the text
     while (!datastream->eof())
     {
-        size_t buf_len = datastream->read(buf, LINE_BUF_MAX);
-        for (size_t i = 0; i < buf_len; i++)
+        const size_t buf_len = datastream->read(buf.data(), BUF_MAX);
+        size_t i = 0;
+        while (i < buf_len)
         {
-            const char c = buf[i];
-
-            switch (parser.partial_tok_type)
-            {
-            case PartialToken::NONE:
-                parser.BeginToken(c);
-                break;
-
-            case PartialToken::COMMENT_SEMICOLON:
-            case PartialToken::COMMENT_SLASH:
-            case PartialToken::COMMENT_HASH:
-                parser.UpdateComment(c);
-                break;
-
-            case PartialToken::STRING_QUOTED:
-            case PartialToken::STRING_NAKED:
-            case PartialToken::STRING_NAKED_CAPTURING_SPACES:
-                parser.UpdateString(c);
-                break;
-
-            case PartialToken::NUMBER_INTEGER:
-            case PartialToken::NUMBER_DECIMAL:
-            case PartialToken::NUMBER_SCIENTIFIC:
-            case PartialToken::NUMBER_SCIENTIFIC_STUB:
-            case PartialToken::NUMBER_SCIENTIFIC_STUB_MINUS:
-                parser.UpdateNumber(c);
-                break;
-
-            case PartialToken::BOOL_TRUE:
-            case PartialToken::BOOL_FALSE:
-                parser.UpdateBool(c);
-                break;
-
-            case PartialToken::KEYWORD:
-            case PartialToken::KEYWORD_BRACED:
-                parser.UpdateKeyword(c);
-                break;
-
-            case PartialToken::TITLE_STRING:
-                parser.UpdateTitle(c);
+            i += parser.ScanRun(buf.data() + i, buf_len - i);
+            if (i == buf_len)
                 break;
 
-            case PartialToken::GARBAGE:
-                parser.UpdateGarbage(c);
-                break;
-            }
+            const char c = buf[i++];
+            parser.ParseChar(c);
         }
     }
 
+    // Flush the last token if the file doesn't end with a newline
+    if (parser.partial_tok_type != PartialToken::NONE)
+    {
+        parser.ParseChar('\n');
+    }
+
     // Ensure newline at end of file
     if (tokens.size() == 0 || tokens.back().type != TokenType::LINEBREAK)
     {
-        tokens.push_back({ TokenType::LINEBREAK, 0.f });
+        tokens.push_back(MakeToken(TokenType::LINEBREAK));
     }
+
+    this->rebuildLineIndex();
 }
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
@@ -951,6 +1075,28 @@ void GenericDocument::loadFromDataStream(Ogre::DataStreamPtr datastream, const B
     const char* EOL_STR = "\n"; // "LF"
 #endif
 
+/// Shortest text which parses back to the same value, and back to a decimal (not integer) number.
+static void FormatDecimal(char* buf, const size_t buf_max, const double value)
+{
+    snprintf(buf, buf_max, "%.15g", value);
+    if (std::strtod(buf, nullptr) != value)
+    {
+        snprintf(buf, buf_max, "%.17g", value);
+    }
+
+    // The parser doesn't accept '+' in exponent
+    char* plus = strchr(buf, '+');
+    if (plus)
+    {
+        memmove(plus, plus + 1, strlen(plus));
+    }
+
+    if (!strpbrk(buf, ".eEni")) // Keep 'nan'/'inf' as they are
+    {
+        strncat(buf, ".0", buf_max - strlen(buf) - 1);
+    }
+}
+
 void GenericDocument::saveToDataStream(Ogre::DataStreamPtr datastream)
 {
     std::string separator;
@@ -969,33 +1115,36 @@ void GenericDocument::saveToDataStream(Ogre::DataStreamPtr datastream)
 
         case TokenType::COMMENT:
             datastream->write(";", 1);
-            pool_str = string_pool.data() + (size_t)tok.data;
+            pool_str = string_pool.data() + tok.data.offset;
             datastream->write(pool_str, strlen(pool_str));
             break;
 
         case TokenType::STRING:
             datastream->write(separator.data(), separator.size());
-            pool_str = string_pool.data() + (size_t)tok.data;
+            pool_str = string_pool.data() + tok.data.offset;
             datastream->write(pool_str, strlen(pool_str));
             separator = ",";
             break;
 
         case TokenType::NUMBER:
             datastream->write(separator.data(), separator.size());
-            snprintf(buf, BUF_MAX, "%f", tok.data);
+            if (tok.is_integer)
+                snprintf(buf, BUF_MAX, "%lld", (long long)tok.data.integer);
+            else
+                FormatDecimal(buf, BUF_MAX, tok.data.number);
             datastream->write(buf, strlen(buf));
             separator = ",";
             break;
 
         case TokenType::BOOL:
             datastream->write(separator.data(), separator.size());
-            snprintf(buf, BUF_MAX, "%s", tok.data == 1.f ? "true" : "false");
+            snprintf(buf, BUF_MAX, "%s", tok.data.integer == 1 ? "true" : "false");
             datastream->write(buf, strlen(buf));
             separator = ",";
             break;
 
         case TokenType::KEYWORD:
-            pool_str = string_pool.data() + (size_t)tok.data;
+            pool_str = string_pool.data() + tok.data.offset;
             datastream->write(pool_str, strlen(pool_str));
             separator = " ";
             break;
@@ -1035,20 +1184,50 @@ bool GenericDocument::saveToResource(std::string resource_name, std::string reso
     }
 }
 
-bool GenericDocReader::seekNextLine()
+void GenericDocument::rebuildLineIndex()
 {
-    // Skip current line
-    while (!this->endOfFile() && this->tokenType() != TokenType::LINEBREAK)
+    line_starts.clear();
+    bool line_started = false;
+    for (size_t i = 0; i < tokens.size(); i++)
     {
-        this->moveNext();
+        switch (tokens[i].type)
+        {
+        case TokenType::LINEBREAK:
+            line_started = false;
+            break;
+
+        case TokenType::STRING:
+        case TokenType::NUMBER:
+        case TokenType::BOOL:
+        case TokenType::KEYWORD:
+            if (!line_started)
+            {
+                line_starts.push_back(i);
+                line_started = true;
+            }
+            break;
+
+        default:
+            break;
+        }
     }
+}
 
-    // Skip comments and empty lines
-    while (!this->endOfFile() && !this->isTokString() && !this->isTokFloat() && !this->isTokBool() && !this->isTokKeyword())
+bool GenericDocReader::seekNextLine()
+{
+    // Find the first line starting past the current token, skipping comments and empty lines.
+    // The reader only moves forward, so `line_num` does too.
+    const std::vector<size_t>& line_starts = doc->line_starts;
+    while (line_num < line_starts.size() && line_starts[line_num] <= token_pos)
     {
-        this->moveNext();
+        line_num++;
     }
 
+    if (line_num < line_starts.size())
+        token_pos = (uint32_t)line_starts[line_num];
+    else
+        token_pos = std::max(token_pos, (uint32_t)doc->tokens.size());
+
     return this->endOfFile();
 }
 
@@ -1059,3 +1238,12 @@ int GenericDocReader::countLineArgs()
         count++;
     return count;
 }
+
+int64_t GenericDocReader::getIntData(int offset) const
+{
+    if (endOfFile(offset))
+        return 0;
+
+    const Token& tok = doc->tokens[token_pos + offset];
+    return (tok.is_integer) ? tok.data.integer : (int64_t)tok.data.number;
+}
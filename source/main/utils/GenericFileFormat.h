@@ -49,15 +49,26 @@ enum class TokenType
     LINEBREAK,    // Input: LF (CR is ignored); Output: platform-specific.
     COMMENT,      // Line starting with ; (skipping whitespace). Data: offset in string pool.
     STRING,       // Quoted string. Data: offset in string pool.
-    NUMBER,       // Float.
-    BOOL,         // Lowercase 'true'/'false'. Data: 1.0 for true, 0.0 for false.
+    NUMBER,       // Data: int64 if written as integer (see `Token::is_integer`), double otherwise.
+    BOOL,         // Lowercase 'true'/'false'. Data: integer 1 for true, 0 for false.
     KEYWORD,      // Unquoted string at start of line (skipping whitespace). Data: offset in string pool.
 };
 
+/// Token payload; the valid member depends on `Token::type` (and `Token::is_integer` for NUMBER).
+union TokenData
+{
+    double    number;   //!< NUMBER written with '.' or exponent
+    int64_t   integer;  //!< NUMBER written as integer; BOOL
+    size_t    offset;   //!< COMMENT, STRING, KEYWORD - offset in `GenericDocument::string_pool`
+};
+
 struct Token
 {
     TokenType type;
-    float     data;
+    bool      is_integer; //!< The value is in `data.integer` (always for BOOL, NUMBER if written as integer).
+    TokenData data;
+
+    double    getNumber() const { return (is_integer) ? (double)data.integer : data.number; }
 };
 
 struct GenericDocument: public RefCountingObject<GenericDocument>
@@ -75,6 +86,10 @@ struct GenericDocument: public RefCountingObject<GenericDocument>
 
     std::vector<char> string_pool; // Data of COMMENT/KEYWORD/STRING tokens; NUL-terminated strings.
     std::vector<Token> tokens;
+    std::vector<size_t> line_starts; //!< Index of the first non-comment token of every line which has one, ascending; see `rebuildLineIndex()`.
+
+    /// Fills `line_starts` from `tokens`; done by `loadFromDataStream()`, call it yourself after editing `tokens`.
+    void rebuildLineIndex();
     
     virtual void loadFromDataStream(Ogre::DataStreamPtr datastream, BitMask_t options = 0);
     virtual void saveToDataStream(Ogre::DataStreamPtr datastream);
@@ -92,7 +107,7 @@ struct GenericDocReader: public RefCountingObject<GenericDocReader>
 
     GenericDocumentPtr doc;
     uint32_t token_pos = 0;
-    uint32_t line_num = 0;
+    uint32_t line_num = 0; //!< Position in `GenericDocument::line_starts`, advanced lazily by `seekNextLine()`.
 
     // PLEASE maintain the same order as in 'bindings/GenericFileFormatAngelscript.cpp'
 
@@ -105,19 +120,24 @@ struct GenericDocReader: public RefCountingObject<GenericDocReader>
 
     const char* getTokString(int offset = 0) const { ROR_ASSERT(isTokString(offset)); return getStringData(offset); }
     float getTokFloat(int offset = 0) const { ROR_ASSERT(isTokFloat(offset)); return getFloatData(offset); }
-    bool getTokBool(int offset = 0) const { ROR_ASSERT(isTokBool(offset)); return getFloatData(offset) == 1.f; }
+    double getTokDouble(int offset = 0) const { ROR_ASSERT(isTokFloat(offset)); return getDoubleData(offset); }
+    int64_t getTokInt(int offset = 0) const { ROR_ASSERT(isTokFloat(offset)); return getIntData(offset); }
+    bool getTokBool(int offset = 0) const { ROR_ASSERT(isTokBool(offset)); return getIntData(offset) == 1; }
     const char* getTokKeyword(int offset = 0) const { ROR_ASSERT(isTokKeyword(offset)); return getStringData(offset); }
     const char* getTokComment(int offset = 0) const { ROR_ASSERT(isTokComment(offset)); return getStringData(offset); }
 
     bool isTokString(int offset = 0) const { return tokenType(offset) == TokenType::STRING; }
     bool isTokFloat(int offset = 0) const { return tokenType(offset) == TokenType::NUMBER; }
+    bool isTokInt(int offset = 0) const { return isTokFloat(offset) && doc->tokens[token_pos + offset].is_integer; }
     bool isTokBool(int offset = 0) const { return tokenType(offset) == TokenType::BOOL; }
     bool isTokKeyword(int offset = 0) const { return tokenType(offset) == TokenType::KEYWORD; }
     bool isTokComment(int offset = 0) const { return tokenType(offset) == TokenType::COMMENT; }
 
     // Not exported to script:
-    const char* getStringData(int offset = 0) const { return !endOfFile(offset) ? (doc->string_pool.data() + (uint32_t)doc->tokens[token_pos + offset].data) : nullptr; }
-    float getFloatData(int offset = 0) const { return !endOfFile(offset) ? doc->tokens[token_pos + offset].data : 0.f; }
+    const char* getStringData(int offset = 0) const { return !endOfFile(offset) ? (doc->string_pool.data() + doc->tokens[token_pos + offset].data.offset) : nullptr; }
+    float getFloatData(int offset = 0) const { return (float)getDoubleData(offset); }
+    double getDoubleData(int offset = 0) const { return !endOfFile(offset) ? doc->tokens[token_pos + offset].getNumber() : 0.0; }
+    int64_t getIntData(int offset = 0) const;
 };
 
 typedef RefCountingObjectPtr<GenericDocReader> GenericDocReaderPtr;
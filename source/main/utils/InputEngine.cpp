@@ -28,6 +28,7 @@
 #include "GUIManager.h"
 #include "Language.h"
 
+#include <cstring>
 #include <regex>
 
 using namespace RoR;
@@ -617,7 +618,7 @@ String InputEngine::getKeyNameForKeyCode(OIS::KeyCode keycode)
     return "unknown";
 }
 
-void InputEngine::Capture()
+void InputEngine::Capture(float dt)
 {
     mKeyboard->capture();
     mMouse->capture();
@@ -629,6 +630,20 @@ void InputEngine::Capture()
             mJoy[i]->capture();
         }
     }
+
+    if (m_playback_file.is_open())
+    {
+        this->readPlaybackFrame();
+    }
+    else
+    {
+        this->resolveEventSnapshot();
+    }
+
+    if (m_record_file.is_open())
+    {
+        this->writeRecordingFrame(dt);
+    }
 }
 
 void InputEngine::windowResized(Ogre::RenderWindow* rw)
@@ -695,6 +710,13 @@ void InputEngine::resetKeys()
     {
         iter->second = false;
     }
+
+    // Release the events too, or they stay held until the next `Capture()`.
+    // A playback only stores changes, so it keeps its state until it ends.
+    if (!m_playback_file.is_open())
+    {
+        m_snapshot.Clear();
+    }
 }
 
 bool InputEngine::getEventBoolValue(int eventID)
@@ -873,7 +895,14 @@ int InputEngine::getKeboardKeyForCommand(int eventID)
 
 bool InputEngine::isEventAnalog(int eventID)
 {
-    std::vector<event_trigger_t> t_vec = events[eventID];
+    if (eventID < 0 || eventID >= EV_MODE_LAST)
+        return false;
+
+    return m_snapshot.GetValue(InputEventSnapshot::PLANE_ANALOG_ACTIVE, eventID) != 0.f;
+}
+
+bool InputEngine::resolveEventAnalog(TriggerVec const& t_vec)
+{
     if (t_vec.size() > 0)
     {
         //loop through all eventtypes, because we want to find a analog device wether it is the first device or not
@@ -889,7 +918,7 @@ bool InputEngine::isEventAnalog(int eventID)
                     || t_vec[i].eventtype == ET_JoystickSliderY)
                 //check if value comes from analog device
                 //this way, only valid events (e.g. joystick mapped, but unplugged) are recognized as analog events
-                && getEventValue(eventID, true, InputSourceType::IST_ANALOG) != 0.0)
+                && resolveEventValue(t_vec, true, InputSourceType::IST_ANALOG) != 0.0)
             {
                 return true;
             }
@@ -899,13 +928,49 @@ bool InputEngine::isEventAnalog(int eventID)
 }
 
 float InputEngine::getEventValue(int eventID, bool pure, InputSourceType valueSource /*= InputSourceType::IST_ANY*/)
+{
+    if (pure)
+    {
+        auto itor = events.find(eventID);
+        return (itor != events.end()) ? this->resolveEventValue(itor->second, pure, valueSource) : 0.f;
+    }
+
+    if (eventID < 0 || eventID >= EV_MODE_LAST)
+        return 0.f;
+
+    const float digital = m_snapshot.GetValue(InputEventSnapshot::PLANE_DIGITAL, eventID);
+    const float analog = m_snapshot.GetValue(InputEventSnapshot::PLANE_ANALOG, eventID);
+    switch (valueSource)
+    {
+    case InputSourceType::IST_DIGITAL: return digital;
+    case InputSourceType::IST_ANALOG:  return analog;
+    default:                           return std::max(digital, analog);
+    }
+}
+
+void InputEngine::resolveEventSnapshot()
+{
+    // Values never go below 0, so IST_ANY is simply the greater of the digital and analog value.
+    m_snapshot.Clear();
+
+    for (auto& entry: events)
+    {
+        if (entry.first < 0 || entry.first >= EV_MODE_LAST || entry.second.empty())
+            continue;
+
+        m_snapshot.SetValue(InputEventSnapshot::PLANE_DIGITAL, entry.first, this->resolveEventValue(entry.second, false, InputSourceType::IST_DIGITAL));
+        m_snapshot.SetValue(InputEventSnapshot::PLANE_ANALOG, entry.first, this->resolveEventValue(entry.second, false, InputSourceType::IST_ANALOG));
+        m_snapshot.SetValue(InputEventSnapshot::PLANE_ANALOG_ACTIVE, entry.first, this->resolveEventAnalog(entry.second) ? 1.f : 0.f);
+    }
+}
+
+float InputEngine::resolveEventValue(TriggerVec const& t_vec, bool pure, InputSourceType valueSource)
 {
     float returnValue = 0;
-    std::vector<event_trigger_t> t_vec = events[eventID];
     float value = 0;
-    for (std::vector<event_trigger_t>::iterator i = t_vec.begin(); i != t_vec.end(); i++)
+    for (TriggerVec::const_iterator i = t_vec.begin(); i != t_vec.end(); i++)
     {
-        event_trigger_t t = *i;
+        event_trigger_t const& t = *i;
 
         if (valueSource == InputSourceType::IST_DIGITAL || valueSource == InputSourceType::IST_ANY)
         {
@@ -2183,3 +2248,97 @@ Ogre::String InputEngine::getModifierKeyName(OIS::KeyCode key)
     default: return "";
     }
 }
+
+// --------------------------------
+// Record & playback
+
+bool InputEngine::StartRecording(std::string const& filename)
+{
+    this->StopRecording();
+
+    m_record_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_record_file.is_open())
+    {
+        App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, Console::CONSOLE_SYSTEM_ERROR,
+            fmt::format(_L("Cannot open '{}' for writing input recording"), filename));
+        return false;
+    }
+
+    std::vector<std::string> event_names;
+    for (int i = 0; i < EV_MODE_LAST; i++)
+    {
+        event_names.push_back(eventIDToName(i));
+    }
+    m_record_writer.Start(m_record_file, event_names);
+
+    m_record_filename = filename;
+    LOG(fmt::format("[RoR|Input] Recording input to '{}'", filename));
+    return true;
+}
+
+void InputEngine::StopRecording()
+{
+    if (m_record_file.is_open())
+    {
+        m_record_file.close();
+        LOG(fmt::format("[RoR|Input] Recorded {} frames of input to '{}'", m_record_writer.GetNumFrames(), m_record_filename));
+    }
+}
+
+void InputEngine::writeRecordingFrame(float dt)
+{
+    m_record_writer.WriteFrame(m_record_file, dt, m_snapshot);
+
+    if (!m_record_file)
+    {
+        App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, Console::CONSOLE_SYSTEM_ERROR,
+            fmt::format(_L("Failed to write input recording '{}', stopping"), m_record_filename));
+        this->StopRecording();
+    }
+}
+
+bool InputEngine::StartPlayback(std::string const& filename)
+{
+    this->StopPlayback();
+
+    m_playback_file.open(filename, std::ios::binary);
+    if (!m_playback_file.is_open())
+    {
+        App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, Console::CONSOLE_SYSTEM_ERROR,
+            fmt::format(_L("Cannot open input recording '{}'"), filename));
+        return false;
+    }
+
+    if (!m_playback_reader.Start(m_playback_file, [](std::string const& name) { return InputEngine::resolveEventName(name); }))
+    {
+        App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, Console::CONSOLE_SYSTEM_ERROR,
+            fmt::format(_L("'{}' is not an input recording, is empty or was made by another version"), filename));
+        m_playback_file.close();
+        return false;
+    }
+
+    m_snapshot.Clear();
+    LOG(fmt::format("[RoR|Input] Playing back input from '{}'", filename));
+    return true;
+}
+
+void InputEngine::StopPlayback()
+{
+    if (m_playback_file.is_open())
+    {
+        m_playback_file.close();
+        m_snapshot.Clear(); // Release everything
+        App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, Console::CONSOLE_SYSTEM_NOTICE,
+            _L("Input playback finished"));
+    }
+}
+
+void InputEngine::readPlaybackFrame()
+{
+    if (!m_playback_reader.ReadFrame(m_playback_file, m_snapshot))
+    {
+        // End of the recording (or truncated, if the game crashed while recording) - back to the devices
+        this->StopPlayback();
+        this->resolveEventSnapshot();
+    }
+}
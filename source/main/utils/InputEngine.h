@@ -28,8 +28,10 @@
 
 #include "Application.h"
 #include "ForceFeedback.h"
+#include "InputRecording.h"
 
 #include <OgreUTFString.h>
+#include <fstream>
 #include "OISEvents.h"
 #include "OISForceFeedback.h"
 #include "OISInputManager.h"
@@ -477,7 +479,7 @@ public:
 
         // Input processing
 
-    void                Capture();
+    void                Capture(float dt);                                  //!< Reads devices (or the playback file) and resolves all events into the snapshot; records the frame if recording.
     void                updateKeyBounces(float dt);
     void                ProcessMouseEvent(const OIS::MouseEvent& arg);
     void                ProcessKeyPress(const OIS::KeyEvent& arg);
@@ -520,9 +522,10 @@ public:
     void                clearEventsByDevice(int deviceID);                  //!< Clears all bindings with given deviceID (-1 is no exception).
     void                clearAllEvents();                                   //!< Purges all configured bindings.
 
-        // Event states
+        // Event states - read from the snapshot resolved by `Capture()`
 
                         ///valueSource: IST_ANY=digital and analog devices, IST_DIGITAL=only digital, IST_ANALOG=only analog
+                        ///pure: without deadzone and linearity; resolved from the devices on each call.
     float               getEventValue(int eventID, bool pure = false, InputSourceType valueSource = InputSourceType::IST_ANY);
     bool                getEventBoolValue(int eventID);
     bool                isEventAnalog(int eventID);
@@ -531,6 +534,19 @@ public:
     bool                isKeyDownEffective(OIS::KeyCode mod);               //!< Reads RoR internal buffer
     bool                isKeyDownValueBounce(OIS::KeyCode mod, float time = 0.2f);
 
+        // Record & playback of the snapshot stream (file layout: see `InputRecording.h`)
+
+    bool                StartRecording(std::string const& filename);
+    void                StopRecording();
+    bool                IsRecording() const { return m_record_file.is_open(); }
+    std::string const&  GetRecordingFilename() const { return m_record_filename; }
+    size_t              GetNumRecordedFrames() const { return m_record_writer.GetNumFrames(); }
+    /// Replaces device input with the file until it ends. Keys not bound to events (`isKeyDown()`) stay live.
+    bool                StartPlayback(std::string const& filename);
+    void                StopPlayback();
+    bool                IsPlayingBack() const { return m_playback_file.is_open(); }
+    float               GetPlaybackFrameTime() const { return m_playback_reader.GetNextFrameTime(); } //!< Recorded `dt` of the next frame; use in place of the measured one.
+
         // Direct input device states
 
     OIS::JoyStickState* getCurrentJoyState(int joystickNumber);
@@ -586,6 +602,20 @@ protected:
 
     float deadZone(float axis, float dz);
     float axisLinearity(float axisValue, float linearity);
+    float resolveEventValue(TriggerVec const& triggers, bool pure, InputSourceType valueSource);
+    bool  resolveEventAnalog(TriggerVec const& triggers);
+    void  resolveEventSnapshot();
+    void  writeRecordingFrame(float dt);
+    void  readPlaybackFrame();
+
+    // Resolved event states
+    InputEventSnapshot m_snapshot = InputEventSnapshot(EV_MODE_LAST);
+    // Record & playback
+    std::ofstream      m_record_file;
+    std::string        m_record_filename;
+    InputRecordingWriter m_record_writer;
+    std::ifstream      m_playback_file;
+    InputRecordingReader m_playback_reader;
 
     float logval(float val);
     std::string getEventGroup(Ogre::String eventName);
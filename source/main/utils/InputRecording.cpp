@@ -0,0 +1,158 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "InputRecording.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+using namespace RoR;
+
+static const char     INPUT_RECORDING_MAGIC[8] = {'R', 'o', 'R', 'I', 'n', 'p', 'u', 't'};
+static const uint32_t INPUT_RECORDING_VERSION = 1;
+
+template <typename T> static void WriteInputPod(std::ostream& stream, T value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T> static bool ReadInputPod(std::istream& stream, T& value)
+{
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void InputEventSnapshot::Clear()
+{
+    std::fill(m_values.begin(), m_values.end(), 0.f);
+}
+
+void InputRecordingWriter::Start(std::ostream& stream, std::vector<std::string> const& event_names)
+{
+    stream.write(INPUT_RECORDING_MAGIC, sizeof(INPUT_RECORDING_MAGIC));
+    WriteInputPod<uint32_t>(stream, INPUT_RECORDING_VERSION);
+    WriteInputPod<uint32_t>(stream, static_cast<uint32_t>(event_names.size()));
+    for (std::string const& name: event_names)
+    {
+        WriteInputPod<uint16_t>(stream, static_cast<uint16_t>(name.size()));
+        stream.write(name.data(), name.size());
+    }
+
+    m_last_snapshot = InputEventSnapshot(static_cast<int>(event_names.size()));
+    m_num_frames = 0;
+}
+
+void InputRecordingWriter::WriteFrame(std::ostream& stream, float dt, InputEventSnapshot const& snapshot)
+{
+    const int num_events = std::min(snapshot.GetNumEvents(), m_last_snapshot.GetNumEvents());
+
+    uint16_t num_changes = 0;
+    for (int plane = 0; plane < InputEventSnapshot::PLANE_COUNT; plane++)
+    {
+        for (int i = 0; i < num_events; i++)
+        {
+            const InputEventSnapshot::Plane p = static_cast<InputEventSnapshot::Plane>(plane);
+            if (snapshot.GetValue(p, i) != m_last_snapshot.GetValue(p, i))
+                num_changes++;
+        }
+    }
+
+    WriteInputPod<float>(stream, dt);
+    WriteInputPod<uint16_t>(stream, num_changes);
+    for (int plane = 0; plane < InputEventSnapshot::PLANE_COUNT; plane++)
+    {
+        for (int i = 0; i < num_events; i++)
+        {
+            const InputEventSnapshot::Plane p = static_cast<InputEventSnapshot::Plane>(plane);
+            if (snapshot.GetValue(p, i) != m_last_snapshot.GetValue(p, i))
+            {
+                WriteInputPod<uint16_t>(stream, static_cast<uint16_t>(i));
+                WriteInputPod<uint8_t>(stream, static_cast<uint8_t>(plane));
+                WriteInputPod<float>(stream, snapshot.GetValue(p, i));
+                m_last_snapshot.SetValue(p, i, snapshot.GetValue(p, i));
+            }
+        }
+    }
+
+    m_num_frames++;
+}
+
+bool InputRecordingReader::Start(std::istream& stream, std::function<int(std::string const&)> const& resolve_event_name)
+{
+    m_event_ids.clear();
+    m_next_dt = 0.f;
+
+    char magic[sizeof(INPUT_RECORDING_MAGIC)] = {};
+    uint32_t version = 0;
+    uint32_t num_events = 0;
+    bool valid = stream.read(magic, sizeof(magic))
+        && std::memcmp(magic, INPUT_RECORDING_MAGIC, sizeof(magic)) == 0
+        && ReadInputPod(stream, version) && version == INPUT_RECORDING_VERSION
+        && ReadInputPod(stream, num_events);
+    for (uint32_t i = 0; valid && i < num_events; i++)
+    {
+        uint16_t length = 0;
+        std::string name;
+        valid = ReadInputPod(stream, length);
+        if (valid)
+        {
+            name.resize(length);
+            valid = (length == 0) || static_cast<bool>(stream.read(&name[0], length));
+        }
+        m_event_ids.push_back(valid ? resolve_event_name(name) : -1);
+    }
+    valid = valid && ReadInputPod(stream, m_next_dt);
+
+    if (!valid)
+    {
+        m_event_ids.clear();
+    }
+    return valid;
+}
+
+bool InputRecordingReader::ReadFrame(std::istream& stream, InputEventSnapshot& snapshot)
+{
+    uint16_t num_changes = 0;
+    bool valid = ReadInputPod(stream, num_changes);
+    for (uint16_t i = 0; valid && i < num_changes; i++)
+    {
+        uint16_t index = 0;
+        uint8_t plane = 0;
+        float value = 0.f;
+        valid = ReadInputPod(stream, index) && ReadInputPod(stream, plane) && ReadInputPod(stream, value);
+        if (valid && index < m_event_ids.size() && m_event_ids[index] >= 0 && m_event_ids[index] < snapshot.GetNumEvents()
+            && plane < InputEventSnapshot::PLANE_COUNT)
+        {
+            snapshot.SetValue(static_cast<InputEventSnapshot::Plane>(plane), m_event_ids[index], value);
+        }
+    }
+
+    if (!valid)
+        return false;
+
+    // Frame time of the next frame; past the last frame this fails and the next call reports the end.
+    float next_dt = 0.f;
+    if (ReadInputPod(stream, next_dt))
+    {
+        m_next_dt = next_dt;
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief Per-frame snapshot of the input events, and its record & playback stream.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace RoR {
+
+/// @addtogroup Input
+/// @{
+
+/// Resolved state of all input events for one frame, see `InputEngine::Capture()`.
+class InputEventSnapshot
+{
+public:
+    enum Plane
+    {
+        PLANE_DIGITAL,          //!< Keyboard, mouse buttons, joystick buttons and POVs
+        PLANE_ANALOG,           //!< Mouse and joystick axes, sliders
+        PLANE_ANALOG_ACTIVE,    //!< 1 if an analog device is bound and deflected, see `InputEngine::isEventAnalog()`
+        PLANE_COUNT
+    };
+
+    explicit InputEventSnapshot(int num_events = 0): m_num_events(num_events), m_values(PLANE_COUNT * num_events, 0.f) {}
+
+    int          GetNumEvents() const { return m_num_events; }
+    float        GetValue(Plane plane, int event_id) const { return m_values[plane * m_num_events + event_id]; }
+    void         SetValue(Plane plane, int event_id, float value) { m_values[plane * m_num_events + event_id] = value; }
+    /// Releases all events.
+    void         Clear();
+    bool         operator==(InputEventSnapshot const& other) const { return m_values == other.m_values; }
+
+private:
+    int                m_num_events;
+    std::vector<float> m_values;   //!< Plane-major, `PLANE_COUNT` rows of `m_num_events`
+};
+
+// Stream layout (native byte order, every supported platform is little-endian):
+//   "RoRInput", u32 format version, u32 number of events, then per event: u16 length + name
+//   per frame: f32 dt, u16 number of changes, then per change: u16 event index, u8 plane, f32 value
+// Events are stored by name, so recordings survive additions to the `events` enum.
+// Only values which changed since the previous frame are written.
+
+/// Writes snapshots to a recording, see the stream layout above.
+class InputRecordingWriter
+{
+public:
+    void         Start(std::ostream& stream, std::vector<std::string> const& event_names);
+    void         WriteFrame(std::ostream& stream, float dt, InputEventSnapshot const& snapshot);
+    size_t       GetNumFrames() const { return m_num_frames; }
+
+private:
+    InputEventSnapshot m_last_snapshot;   //!< As of the last written frame; only changes are written
+    size_t             m_num_frames = 0;
+};
+
+/// Reads snapshots from a recording, see the stream layout above.
+class InputRecordingReader
+{
+public:
+    /// Reads the header; `resolve_event_name` maps recorded names to event IDs, -1 for events unknown to this version.
+    /// Returns false if the stream is not a recording, is empty or was made by another format version.
+    bool         Start(std::istream& stream, std::function<int(std::string const&)> const& resolve_event_name);
+    /// Applies the changes of the next frame to `snapshot`; returns false past the end, or if the recording is truncated.
+    bool         ReadFrame(std::istream& stream, InputEventSnapshot& snapshot);
+    /// Recorded `dt` of the frame `ReadFrame()` reads next.
+    float        GetNextFrameTime() const { return m_next_dt; }
+
+private:
+    std::vector<int>   m_event_ids;       //!< Event IDs by index in the recording; -1 if unknown to this version
+    float              m_next_dt = 0.f;
+};
+
+/// @} // addtogroup Input
+
+} // namespace RoR
@@ -0,0 +1,493 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Checks the prop animation and animator tables compiled by `ActorSpawner::CompileAnimations()` against
+/// the flag cascade they replaced, kept here as `OldCascade()`: random animations of random actors must give
+/// the same `cstate`, `div` and crank state, update after update.
+
+#include "AnimationTable.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace RoR;
+
+namespace {
+
+enum class Owner
+{
+    PROPS,      //!< `GfxActor`; the option (`animOpt3`) is the aeroengine number starting from 1
+    ANIMATORS,  //!< `Actor`; the option (`hb_anim_param`) is the aeroengine index
+};
+
+struct AeroengineState
+{
+    float ae_rpm      = 0.f;
+    float ae_throttle = 0.f;
+    float ae_torque   = 0.f;
+    float ae_pitch    = 0.f;
+    float ae_status   = 0.f;
+    bool  ae_turboprop = false;
+};
+
+/// Source values as the owners compute them, already scaled
+struct SourceState
+{
+    float brudder, bthrottle, difflock, heading, torque, pbrake, speedo, tacho, turbo, brake, accel, clutch;
+    float airspeed, vvi, alti_100k, alti_10k, alti_1k, aoa, roll, pitch, airbrake, flap;
+    float steering, ailerons, elevators, arudder;
+    float shifter_seq, shifter_man1, shifter_man2, shifter_lin; //!< What the owner adds for each shifter
+    std::vector<AeroengineState> aeroengines;
+    std::vector<float> keys;
+};
+
+struct TestAnimation
+{
+    BitMask_t   flags  = 0;
+    float       option = 0.f;
+    int         key    = -1;
+    AnimProgram program;
+};
+
+int GetAeroengine(Owner owner, float option, int num_aeroengines)
+{
+    if (owner == Owner::PROPS)
+        return (option > 0.f && option <= float(num_aeroengines)) ? int(option - 1.f) : -1;
+    return ((int)option >= 0 && (int)option < num_aeroengines) ? (int)option : -1;
+}
+
+/// The per-animation cascade of `GfxActor::CalcPropAnimation()`, `GfxActor::UpdatePropAnimations()`
+/// and `Actor::CalcAnimators()` before they were compiled; only the reading of the sources is left out.
+void OldCascade(Owner owner, SourceState const& s, TestAnimation const& anim, bool has_engine,
+                float& cstate, int& div, float& prev_crankfactor)
+{
+    const BitMask_t flags = anim.flags;
+
+    if (flags & ANIM_FLAG_BRUDDER)
+    {
+        cstate = s.brudder;
+        div++;
+    }
+    if (flags & ANIM_FLAG_BTHROTTLE)
+    {
+        cstate = s.bthrottle;
+        div++;
+    }
+    if (flags & ANIM_FLAG_DIFFLOCK)
+    {
+        if (s.difflock >= 0.f)
+            cstate = s.difflock;
+        div++;
+    }
+    if (flags & ANIM_FLAG_HEADING)
+    {
+        cstate = s.heading;
+        div++;
+    }
+    if (has_engine && (flags & ANIM_FLAG_TORQUE))
+    {
+        if (s.torque >= prev_crankfactor)
+            cstate -= s.torque / 10.0f;
+        else
+            cstate = 0.0f;
+        if (cstate <= -1.0f)
+            cstate = -1.0f;
+        prev_crankfactor = s.torque;
+        div++;
+    }
+    if (has_engine && (flags & ANIM_FLAG_SHIFTER) && anim.option == 3.0f)
+    {
+        cstate += s.shifter_seq;
+        div++;
+    }
+    if (has_engine && (flags & ANIM_FLAG_SHIFTER) && anim.option == 1.0f)
+    {
+        cstate += s.shifter_man1;
+        div++;
+    }
+    if (has_engine && (flags & ANIM_FLAG_SHIFTER) && anim.option == 2.0f)
+    {
+        cstate += s.shifter_man2;
+        div++;
+    }
+    if (has_engine && (flags & ANIM_FLAG_SHIFTER) && anim.option == 4.0f)
+    {
+        cstate += s.shifter_lin;
+        div++;
+    }
+    if (flags & ANIM_FLAG_PBRAKE)
+    {
+        cstate -= s.pbrake;
+        div++;
+    }
+    if (flags & ANIM_FLAG_SPEEDO)
+    {
+        cstate -= s.speedo;
+        div++;
+    }
+    if (has_engine && (flags & ANIM_FLAG_TACHO))
+    {
+        cstate -= s.tacho;
+        div++;
+    }
+    if (has_engine && (flags & ANIM_FLAG_TURBO))
+    {
+        cstate -= s.turbo;
+        div++;
+    }
+    if (flags & ANIM_FLAG_BRAKE)
+    {
+        cstate -= s.brake;
+        div++;
+    }
+    if (has_engine && (flags & ANIM_FLAG_ACCEL))
+    {
+        cstate -= s.accel;
+        div++;
+    }
+    if (has_engine && (flags & ANIM_FLAG_CLUTCH))
+    {
+        cstate -= s.clutch;
+        div++;
+    }
+
+    const int aenum = GetAeroengine(owner, anim.option, static_cast<int>(s.aeroengines.size()));
+    if (aenum != -1)
+    {
+        AeroengineState const& ae = s.aeroengines[aenum];
+        if (flags & ANIM_FLAG_RPM)
+        {
+            cstate -= ae.ae_rpm;
+            div++;
+        }
+        if (flags & ANIM_FLAG_THROTTLE)
+        {
+            cstate -= ae.ae_throttle;
+            div++;
+        }
+        if (ae.ae_turboprop)
+        {
+            if (flags & ANIM_FLAG_AETORQUE)
+            {
+                cstate = ae.ae_torque;
+                div++;
+            }
+            if (flags & ANIM_FLAG_AEPITCH)
+            {
+                cstate = ae.ae_pitch;
+                div++;
+            }
+        }
+        if (flags & ANIM_FLAG_AESTATUS)
+        {
+            cstate = ae.ae_status;
+            div++;
+        }
+    }
+
+    if (flags & ANIM_FLAG_AIRSPEED)
+    {
+        cstate -= s.airspeed;
+        div++;
+    }
+    if (flags & ANIM_FLAG_VVI)
+    {
+        cstate -= s.vvi;
+        if (cstate >= 1.0f)
+            cstate = 1.0f;
+        if (cstate <= -1.0f)
+            cstate = -1.0f;
+        div++;
+    }
+    if (flags & ANIM_FLAG_ALTIMETER)
+    {
+        if (anim.option == 3.0f)
+        {
+            cstate -= s.alti_1k;
+        }
+        if (anim.option == 2.0f)
+        {
+            cstate -= s.alti_10k;
+            if (cstate <= -1.0f)
+                cstate = -1.0f;
+        }
+        if (anim.option == 1.0f)
+        {
+            cstate -= s.alti_100k;
+            if (cstate <= -1.0f)
+                cstate = -1.0f;
+        }
+        div++;
+    }
+    if (flags & ANIM_FLAG_AOA)
+    {
+        cstate -= s.aoa;
+        if (cstate <= -1.0f)
+            cstate = -1.0f;
+        if (cstate >= 1.0f)
+            cstate = 1.0f;
+        div++;
+    }
+    if (flags & ANIM_FLAG_ROLL)
+    {
+        cstate = s.roll;
+        div++;
+    }
+    if (flags & ANIM_FLAG_PITCH)
+    {
+        cstate = s.pitch;
+        div++;
+    }
+    if (flags & ANIM_FLAG_AIRBRAKE)
+    {
+        cstate -= s.airbrake;
+        div++;
+    }
+    if (flags & ANIM_FLAG_FLAP)
+    {
+        cstate = s.flap;
+        div++;
+    }
+
+    // Props only, after the cascade; not counted
+    if (anim.key != -1)
+        cstate += s.keys[anim.key];
+    if (flags & ANIM_FLAG_STEERING)
+        cstate += s.steering;
+    if (flags & ANIM_FLAG_AILERONS)
+        cstate += s.ailerons;
+    if (flags & ANIM_FLAG_ELEVATORS)
+        cstate += s.elevators;
+    if (flags & ANIM_FLAG_ARUDDER)
+        cstate += s.arudder;
+    if (flags & ANIM_FLAG_PERMANENT)
+        cstate += 1.0f;
+}
+
+/// Like `GfxActor::UpdatePropAnimSources()` and `Actor::UpdateAnimatorSources()`
+void FillTable(AnimationTable& table, SourceState const& s)
+{
+    const float fixed[] = {
+        s.brudder, s.bthrottle, s.difflock, s.heading, s.torque, s.pbrake, s.speedo, s.tacho, s.turbo, s.brake,
+        s.accel, s.clutch, s.airspeed, s.vvi, s.alti_100k, s.alti_10k, s.alti_1k, s.aoa, s.roll, s.pitch,
+        s.airbrake, s.flap, s.steering, s.ailerons, s.elevators, s.arudder };
+    static_assert(sizeof(fixed) / sizeof(float) == ANIM_SOURCE_ONE, "One value per fixed source");
+
+    for (int i = 0; i < ANIM_SOURCE_ONE; i++)
+        table.SetValue(i, fixed[i]);
+    for (int i = 0; i < table.GetNumAeroengines(); i++)
+    {
+        table.SetValue(table.GetAeroengineSlot(i, ANIM_SOURCE_AE_RPM), s.aeroengines[i].ae_rpm);
+        table.SetValue(table.GetAeroengineSlot(i, ANIM_SOURCE_AE_THROTTLE), s.aeroengines[i].ae_throttle);
+        table.SetValue(table.GetAeroengineSlot(i, ANIM_SOURCE_AE_TORQUE), s.aeroengines[i].ae_torque);
+        table.SetValue(table.GetAeroengineSlot(i, ANIM_SOURCE_AE_PITCH), s.aeroengines[i].ae_pitch);
+        table.SetValue(table.GetAeroengineSlot(i, ANIM_SOURCE_AE_STATUS), s.aeroengines[i].ae_status);
+    }
+    for (int i = 0; i < table.GetNumKeys(); i++)
+        table.SetValue(table.GetKeySlot(i), s.keys[i]);
+}
+
+/// Like `GfxActor::CalcPropAnimation()`, with the shifters reduced to the value they add
+void RunProgram(AnimationTable const& table, SourceState const& s, AnimProgram const& program,
+                float& cstate, float& prev_crankfactor)
+{
+    for (int i = program.apr_op_begin; i < program.apr_op_begin + program.apr_op_count; i++)
+    {
+        AnimOp const& op = table.GetOp(i);
+        switch (op.aop_type)
+        {
+        case AnimOpType::SHIFTER_SEQ:  cstate += s.shifter_seq;  break;
+        case AnimOpType::SHIFTER_MAN1: cstate += s.shifter_man1; break;
+        case AnimOpType::SHIFTER_MAN2: cstate += s.shifter_man2; break;
+        case AnimOpType::SHIFTER_LIN:  cstate += s.shifter_lin;  break;
+        default: table.ApplyOp(op, cstate, prev_crankfactor);
+        }
+    }
+}
+
+/// Values around the clamping limits, with some exactly on them
+float RandomValue(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> dist(-1.5f, 1.5f);
+    switch (rng() % 8)
+    {
+    case 0:  return 0.f;
+    case 1:  return 1.f;
+    case 2:  return -1.f;
+    default: return dist(rng);
+    }
+}
+
+void RandomizeSources(std::mt19937& rng, SourceState& s)
+{
+    float* fixed[] = {
+        &s.brudder, &s.bthrottle, &s.heading, &s.pbrake, &s.speedo, &s.tacho, &s.turbo, &s.brake,
+        &s.accel, &s.clutch, &s.airspeed, &s.vvi, &s.alti_100k, &s.alti_10k, &s.alti_1k, &s.aoa, &s.roll, &s.pitch,
+        &s.airbrake, &s.flap, &s.steering, &s.ailerons, &s.elevators, &s.arudder,
+        &s.shifter_seq, &s.shifter_man1, &s.shifter_man2, &s.shifter_lin };
+    for (float* value: fixed)
+        *value = RandomValue(rng);
+
+    const float difflock[] = {-1.f, 0.f, 0.5f, 1.f};
+    s.difflock = difflock[rng() % 4];
+    s.torque = std::max(0.f, RandomValue(rng)); // The crank factor is clamped when read
+
+    for (AeroengineState& ae: s.aeroengines)
+    {
+        ae.ae_rpm = RandomValue(rng);
+        ae.ae_throttle = RandomValue(rng);
+        ae.ae_torque = RandomValue(rng);
+        ae.ae_pitch = RandomValue(rng);
+        ae.ae_status = RandomValue(rng);
+    }
+    for (float& key: s.keys)
+        key = static_cast<float>(rng() % 2);
+}
+
+void TestMatchesOldCascade(Owner owner)
+{
+    // Animators have no keys and no prop-only flags
+    const BitMask_t prop_only = ANIM_FLAG_EVENT | ANIM_FLAG_STEERING | ANIM_FLAG_AILERONS | ANIM_FLAG_ELEVATORS
+                              | ANIM_FLAG_ARUDDER | ANIM_FLAG_PERMANENT;
+    const float options[] = {-1.f, 0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 1.5f};
+
+    std::mt19937 rng(owner == Owner::PROPS ? 72 : 2072);
+    int num_animations = 0;
+    int num_mismatches = 0;
+    int num_div_mismatches = 0;
+    for (int actor = 0; actor < 500; actor++)
+    {
+        const bool has_engine = (rng() % 4) != 0;
+        SourceState s;
+        s.aeroengines.resize(rng() % 4);
+        for (AeroengineState& ae: s.aeroengines)
+            ae.ae_turboprop = (rng() % 2) != 0;
+
+        // A few flags per animation, like real ones; sometimes a lot to stress the composition
+        std::vector<TestAnimation> anims(1 + rng() % 30);
+        int num_keys = 0;
+        for (TestAnimation& anim: anims)
+        {
+            const int num_flags = (rng() % 10 == 0) ? 12 : 1 + rng() % 3;
+            for (int i = 0; i < num_flags; i++)
+                anim.flags |= BITMASK(1 + rng() % 32);
+            if (owner == Owner::ANIMATORS)
+                anim.flags &= ~prop_only;
+            anim.option = options[rng() % 8];
+            if (anim.flags & ANIM_FLAG_EVENT)
+                anim.key = num_keys++;
+        }
+        s.keys.resize(num_keys);
+
+        // Compiled like `ActorSpawner::CompileAnimations()`
+        const int num_aeroengines = static_cast<int>(s.aeroengines.size());
+        AnimationTable table;
+        table.Reset(num_aeroengines, num_keys);
+        for (TestAnimation& anim: anims)
+        {
+            const int aeroengine = GetAeroengine(owner, anim.option, num_aeroengines);
+            const bool turboprop = aeroengine != -1 && s.aeroengines[aeroengine].ae_turboprop;
+            anim.program = table.AddAnimation(anim.flags, anim.option, has_engine, aeroengine, turboprop, anim.key);
+        }
+
+        // The crank state is shared by all animations of the owner and carries over between updates
+        float old_crankfactor = 0.f;
+        float new_crankfactor = 0.f;
+        for (int update = 0; update < 20; update++)
+        {
+            RandomizeSources(rng, s);
+            FillTable(table, s);
+            for (TestAnimation const& anim: anims)
+            {
+                float old_cstate = 0.f;
+                int old_div = 0;
+                OldCascade(owner, s, anim, has_engine, old_cstate, old_div, old_crankfactor);
+
+                float new_cstate = 0.f;
+                RunProgram(table, s, anim.program, new_cstate, new_crankfactor);
+
+                num_animations++;
+                if (old_cstate != new_cstate || old_crankfactor != new_crankfactor)
+                    num_mismatches++;
+                if (owner == Owner::ANIMATORS && old_div != anim.program.apr_num_sources)
+                    num_div_mismatches++;
+            }
+        }
+
+        // Only sources some animation reads need to be filled in
+        for (int i = 0; i < ANIM_SOURCE_ONE; i++)
+        {
+            bool read = false;
+            for (int op = 0; op < anims.back().program.apr_op_begin + anims.back().program.apr_op_count; op++)
+                read = read || table.GetOp(op).aop_source == i;
+            ROR_CHECK(table.IsSourceUsed(static_cast<AnimSource>(i)) == read);
+        }
+    }
+
+    printf("%s: %d animation updates, %d cstate/crank mismatch(es), %d div mismatch(es)\n",
+        (owner == Owner::PROPS) ? "Props" : "Animators", num_animations, num_mismatches, num_div_mismatches);
+    ROR_CHECK(num_mismatches == 0);
+    ROR_CHECK(num_div_mismatches == 0);
+}
+
+/// The op list holds only the sources which apply, so most animations run one or two ops.
+void TestProgramSize()
+{
+    AnimationTable table;
+    table.Reset(1, 1);
+
+    // Without an engine, the engine sources are dropped
+    AnimProgram tacho = table.AddAnimation(ANIM_FLAG_TACHO | ANIM_FLAG_TORQUE, 0.f, false, -1, false, -1);
+    ROR_CHECK(tacho.apr_op_count == 0 && tacho.apr_num_sources == 0);
+
+    // An altimeter without a valid option is counted, but reads nothing
+    AnimProgram alti = table.AddAnimation(ANIM_FLAG_ALTIMETER, 7.f, true, -1, false, -1);
+    ROR_CHECK(alti.apr_op_count == 0 && alti.apr_num_sources == 1);
+
+    // Turboprop sources need a turboprop
+    AnimProgram aetorque = table.AddAnimation(ANIM_FLAG_AETORQUE | ANIM_FLAG_RPM, 1.f, true, 0, false, -1);
+    ROR_CHECK(aetorque.apr_op_count == 1);
+    ROR_CHECK(table.GetOp(aetorque.apr_op_begin).aop_source == table.GetAeroengineSlot(0, ANIM_SOURCE_AE_RPM));
+
+    // 'permanent' reads the constant slot
+    AnimProgram permanent = table.AddAnimation(ANIM_FLAG_PERMANENT | ANIM_FLAG_EVENT, 0.f, true, -1, false, 0);
+    ROR_CHECK(permanent.apr_op_count == 2);
+    ROR_CHECK(permanent.apr_op_begin == aetorque.apr_op_begin + aetorque.apr_op_count);
+    float cstate = 0.f;
+    float crankfactor = 0.f;
+    table.SetValue(table.GetKeySlot(0), 1.f);
+    for (int i = permanent.apr_op_begin; i < permanent.apr_op_begin + permanent.apr_op_count; i++)
+        table.ApplyOp(table.GetOp(i), cstate, crankfactor);
+    ROR_CHECK(cstate == 2.f);
+    ROR_CHECK(table.IsSourceUsed(ANIM_SOURCE_ONE) && !table.IsSourceUsed(ANIM_SOURCE_TACHO));
+}
+
+} // namespace
+
+int main()
+{
+    TestMatchesOldCascade(Owner::PROPS);
+    TestMatchesOldCascade(Owner::ANIMATORS);
+    TestProgramSize();
+
+    return RoR::Test::Finish("AnimationTableTest");
+}
@@ -0,0 +1,332 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Checks SkyX::VClouds::CloudCells, the bit-packed cloud automaton behind DataManager, against the previous
+/// cell-by-cell implementation (kept here as the reference): same ellipsoids and random seed, the cells and the
+/// packed texels must stay bit-identical over several transitions, with steps 1-3 split into slices the way
+/// the thread pool runs them.
+
+#include "TestUtils.h"
+#include "VClouds/CloudCells.h"
+#include "VClouds/Ellipsoid.h"
+#include "VClouds/FastFakeRandom.h"
+
+#include <Ogre.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace RoR;
+using namespace SkyX::VClouds;
+
+namespace {
+
+// --------------------------------
+// Reference: the cell calculation before the cells were bit-packed
+
+struct OldCell
+{
+    bool hum, act, cld;
+    float phum, pext, pact;
+    float dens;
+    float light;
+};
+
+class OldCells
+{
+public:
+    OldCells(int nx, int ny, int nz): m_nx(nx), m_ny(ny), m_nz(nz), m_cells(nx * ny * nz), m_tmp(nx * ny * nz) {}
+
+    OldCell& At(int x, int y, int z) { return m_cells[(x * m_ny + y) * m_nz + z]; }
+
+    /// Copies the state `Ellipsoid::updateProbabilities()` writes.
+    void CopyProbabilities(CloudCells::Cells const& c, bool copy_clouds)
+    {
+        for (int u = 0; u < m_nx; u++)
+            for (int v = 0; v < m_ny; v++)
+                for (int w = 0; w < m_nz; w++)
+                {
+                    const int i = c.index(u, v, w);
+                    OldCell& cell = this->At(u, v, w);
+                    cell.phum = c.phum[i];
+                    cell.pext = c.pext[i];
+                    cell.pact = c.pact[i];
+                    if (copy_clouds)
+                    {
+                        cell.hum = c.get(c.hum, u, v, w);
+                        cell.act = c.get(c.act, u, v, w);
+                        cell.cld = c.get(c.cld, u, v, w);
+                        cell.dens = c.dens[i];
+                        cell.light = c.light[i];
+                    }
+                }
+    }
+
+    void PerformCalculations(FastFakeRandom& rnd, int step, Ogre::Vector3 const& sun_dir)
+    {
+        for (int u = 0; u < m_nx; u++)
+            for (int v = 0; v < m_ny; v++)
+                for (int w = 0; w < m_nz; w++)
+                {
+                    OldCell& c = this->At(u, v, w);
+                    switch (step)
+                    {
+                    case 0:
+                        c.hum = c.hum || (rnd.get() < c.phum);
+                        c.cld = c.cld && (rnd.get() > c.pext);
+                        c.act = c.act || (rnd.get() < c.pact);
+                        m_tmp[(u * m_ny + v) * m_nz + w] = c.act;
+                        break;
+                    case 1:
+                        c.hum =  c.hum && !c.act;
+                        c.cld =  c.cld ||  c.act;
+                        c.act = !c.act &&  c.hum && this->Fact(u, v, w);
+                        break;
+                    case 2:
+                        c.dens = this->GetDensityAt(u, v, w, 1, 1.15f);
+                        break;
+                    case 3:
+                        c.light = this->GetLightAbsorcionAt(u, v, w, sun_dir, 0.15f);
+                        break;
+                    }
+                }
+    }
+
+    Ogre::uint32 GetTexel(int x, int y, int z)
+    {
+        Ogre::uint32 texel = 0;
+        Ogre::PixelUtil::packColour(this->At(x, y, z).dens, this->At(x, y, z).light, 0, 0, Ogre::PF_BYTE_RGBA, &texel);
+        return texel;
+    }
+
+private:
+    bool TmpAct(int x, int y, int z) const { return m_tmp[(x * m_ny + y) * m_nz + z]; }
+
+    bool Fact(int x, int y, int z) const
+    {
+        const int nx = m_nx, ny = m_ny, nz = m_nz;
+        const bool i1m = ((x+1)>=nx) ? TmpAct(0, y, z) : TmpAct(x+1, y, z);
+        const bool j1m = ((y+1)>=ny) ? TmpAct(x, 0, z) : TmpAct(x, y+1, z);
+        const bool k1m = ((z+1)>=nz) ? false : TmpAct(x, y, z+1);
+        const bool i1r = ((x-1)<0) ? TmpAct(nx-1, y, z) : TmpAct(x-1, y, z);
+        const bool j1r = ((y-1)<0) ? TmpAct(x, ny-1, z) : TmpAct(x, y-1, z);
+        const bool k1r = ((z-1)<0) ? false : TmpAct(x, y, z-1);
+        const bool i2r = ((x-2)<0) ? TmpAct(nx-2, y, z) : TmpAct(x-2, y, z);
+        const bool j2r = ((y-2)<0) ? TmpAct(x, ny-2, z) : TmpAct(x, y-2, z);
+        const bool k2r = ((z-2)<0) ? false : TmpAct(x, y, z-2);
+        const bool i2m = ((x+2)>=nx) ? TmpAct(1, y, z) : TmpAct(x+2, y, z);
+        const bool j2m = ((y+2)>=ny) ? TmpAct(x, 1, z) : TmpAct(x, y+2, z);
+        return i1m || j1m || k1m  || i1r || j1r || k1r || i2r || i2m || j2r || j2m || k2r;
+    }
+
+    float GetDensityAt(int x, int y, int z, int r, float strength)
+    {
+        int zr = ((z-r)<0) ? 0 : z-r,
+            zm = ((z+r)>=m_nz) ? m_nz : z+r,
+            clouds = 0, div = 0;
+        for (int u = x-r; u <= x+r; u++)
+            for (int v = y-r; v <= y+r; v++)
+                for (int w = zr; w < zm; w++)
+                {
+                    int uu = (u<0) ? (u + m_nx) : u; if (u>=m_nx) { uu-= m_nx; }
+                    int vv = (v<0) ? (v + m_ny) : v; if (v>=m_ny) { vv-= m_ny; }
+                    clouds += this->At(uu, vv, w).cld ? 1 : 0;
+                    div++;
+                }
+        return Ogre::Math::Clamp<float>(strength*((float)clouds)/div, 0, 1);
+    }
+
+    Ogre::Real GetLightAbsorcionAt(int x, int y, int z, Ogre::Vector3 const& d, float att)
+    {
+        Ogre::Real step = 1, factor = 1;
+        Ogre::Vector3 pos = Ogre::Vector3(x, y, z);
+        int current_iteration = 0, max_iterations = 8;
+        for (;;)
+        {
+            if ((int)pos.z >= m_nz || (int)pos.z < 0 || factor <= 0 || current_iteration >= max_iterations)
+                break;
+
+            const int u = (int)pos.x, v = (int)pos.y;
+            int uu = (u<0) ? (u + m_nx) : u; if (u>=m_nx) { uu-= m_nx; }
+            int vv = (v<0) ? (v + m_ny) : v; if (v>=m_ny) { vv-= m_ny; }
+            factor -= this->At(uu, vv, (int)pos.z).dens*att*(1-static_cast<float>(current_iteration)/max_iterations);
+            pos += step*(-d);
+            current_iteration++;
+        }
+        return Ogre::Math::Clamp<Ogre::Real>(factor,0,1);
+    }
+
+    int m_nx, m_ny, m_nz;
+    std::vector<OldCell> m_cells;
+    std::vector<bool> m_tmp;
+};
+
+// --------------------------------
+// Tests
+
+const unsigned int SEED = 12345;
+
+std::vector<std::unique_ptr<Ellipsoid>> CreateEllipsoids(int nx, int ny, int nz, int count)
+{
+    std::vector<std::unique_ptr<Ellipsoid>> ellipsoids;
+    for (int i = 0; i < count; i++)
+    {
+        const int a = 2 + rand() % (nx / 6), b = 2 + rand() % (ny / 6), c = 1 + rand() % (nz / 4);
+        const int z = c + rand() % (nz - 2 * c); // Inside in z, ellipsoids only wrap around in x/y
+        ellipsoids.emplace_back(new Ellipsoid(a, b, c, nx, ny, nz, rand() % nx, rand() % ny, z, 1.f + (rand() % 40) / 10.f));
+    }
+    return ellipsoids;
+}
+
+/// Steps 1-3 run in slices, in reverse order, like thread pool tasks finishing in any order.
+void PerformSliced(CloudCells& cells, int step, int slice)
+{
+    const int nx = cells.getCells().nx;
+    if (step == 0)
+    {
+        cells.performCalculations(0, 0, nx);
+        return;
+    }
+    for (int x = ((nx - 1) / slice) * slice; x >= 0; x -= slice)
+    {
+        cells.performCalculations(step, x, std::min(x + slice, nx));
+    }
+}
+
+void CompareCells(CloudCells const& cells, OldCells& reference, int nx, int ny, int nz)
+{
+    CloudCells::Cells const& c = cells.getCells();
+    int num_differences = 0;
+    for (int u = 0; u < nx; u++)
+        for (int v = 0; v < ny; v++)
+            for (int w = 0; w < nz; w++)
+            {
+                OldCell& old = reference.At(u, v, w);
+                const int i = c.index(u, v, w);
+                num_differences += (c.get(c.hum, u, v, w) != old.hum) || (c.get(c.act, u, v, w) != old.act) ||
+                    (c.get(c.cld, u, v, w) != old.cld) || (c.dens[i] != old.dens) || (c.light[i] != old.light) ||
+                    (cells.getVolTextureData()[(w*ny + v)*nx + u] != reference.GetTexel(u, v, w));
+            }
+    ROR_CHECK(num_differences == 0);
+
+    // Bits past nz must stay clear, the automaton works on whole words
+    const Ogre::uint32 tail = (nz % 32) ? ~((1u << (nz % 32)) - 1) : 0;
+    for (int col = 0; col < nx * ny; col++)
+    {
+        const int last = col * c.words + c.words - 1;
+        ROR_CHECK(((c.hum[last] | c.act[last] | c.cld[last]) & tail) == 0);
+    }
+}
+
+void TestMatchesReference(int nx, int ny, int nz, int slice)
+{
+    const int NUM_TRANSITIONS = 10;
+    const Ogre::Vector3 sun_dir = Ogre::Vector3(0.3f, -0.4f, 0.85f).normalisedCopy();
+
+    // Both random tables come from the same seed
+    srand(SEED);
+    CloudCells cells;
+    cells.create(nx, ny, nz);
+    srand(SEED);
+    FastFakeRandom reference_random(1024, 0, 1);
+
+    // Clouds right away, like setWheater(..., false)
+    std::vector<std::unique_ptr<Ellipsoid>> ellipsoids = CreateEllipsoids(nx, ny, nz, 20);
+    cells.clearProbabilities(true);
+    for (auto& e : ellipsoids)
+        e->updateProbabilities(cells.getCells(), false);
+
+    OldCells reference(nx, ny, nz);
+    reference.CopyProbabilities(cells.getCells(), true);
+    cells.setSunDirection(sun_dir);
+
+    for (int transition = 0; transition < NUM_TRANSITIONS; transition++)
+    {
+        if (transition == NUM_TRANSITIONS / 2) // Weather change, like setWheater(..., true)
+        {
+            ellipsoids = CreateEllipsoids(nx, ny, nz, 30);
+            cells.clearProbabilities(false);
+            for (auto& e : ellipsoids)
+                e->updateProbabilities(cells.getCells(), true);
+            reference.CopyProbabilities(cells.getCells(), false);
+        }
+
+        for (int step = 0; step < 4; step++)
+        {
+            PerformSliced(cells, step, slice);
+            reference.PerformCalculations(reference_random, step, sun_dir);
+        }
+        CompareCells(cells, reference, nx, ny, nz);
+    }
+
+    int num_clouds = 0;
+    for (Ogre::uint32 word : cells.getCells().cld)
+        for (; word; word &= word - 1)
+            num_clouds++;
+    ROR_CHECK(num_clouds > 0); // Compared something
+    printf("CloudCells %dx%dx%d, slices of %d: %d cloud cells after %d transitions\n", nx, ny, nz, slice, num_clouds, NUM_TRANSITIONS);
+}
+
+void BenchmarkStep()
+{
+    const int NX = 128, NY = 128, NZ = 20;
+    const Ogre::Vector3 sun_dir = Ogre::Vector3(0.3f, -0.4f, 0.85f).normalisedCopy();
+
+    srand(SEED);
+    CloudCells cells;
+    cells.create(NX, NY, NZ);
+    srand(SEED);
+    FastFakeRandom reference_random(1024, 0, 1);
+    std::vector<std::unique_ptr<Ellipsoid>> ellipsoids = CreateEllipsoids(NX, NY, NZ, 150);
+    cells.clearProbabilities(true);
+    for (auto& e : ellipsoids)
+        e->updateProbabilities(cells.getCells(), false);
+    OldCells reference(NX, NY, NZ);
+    reference.CopyProbabilities(cells.getCells(), true);
+    cells.setSunDirection(sun_dir);
+
+    Test::Stopwatch cells_watch;
+    for (int step = 0; step < 4; step++)
+        cells.performCalculations(step, 0, NX);
+    const double cells_ms = cells_watch.GetElapsedMs();
+
+    Test::Stopwatch reference_watch;
+    for (int step = 0; step < 4; step++)
+        reference.PerformCalculations(reference_random, step, sun_dir);
+    const double reference_ms = reference_watch.GetElapsedMs();
+
+    CompareCells(cells, reference, NX, NY, NZ);
+    printf("CloudCells %dx%dx%d: one full step %.1f ms on one core (reference %.1f ms)\n", NX, NY, NZ, cells_ms, reference_ms);
+}
+
+} // namespace
+
+int main()
+{
+    TestMatchesReference(32, 32, 20, 16);
+    TestMatchesReference(32, 24, 40, 5);   // Two words per column
+    TestMatchesReference(24, 32, 70, 7);   // Three words, last one partial
+    TestMatchesReference(40, 40, 64, 1);   // Exactly two words
+    BenchmarkStep();
+
+    return RoR::Test::Finish("CloudCellsTest");
+}
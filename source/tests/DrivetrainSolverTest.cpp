@@ -0,0 +1,500 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Checks the torque split of the differentials and DrivetrainSolver, the implicit solver of the drivetrain graph:
+/// the engine torque reaches the wheels split like the explicit diff cascade did, the clutch passes the torque
+/// `EngineSim` computed and slips at its limit, coupling torques stay internal to the drivetrain, coupled wheels
+/// converge, and low-inertia wheels stay stable at timesteps far above PHYSICS_DT, where the explicit springs blow up.
+
+#include "Differentials.h"
+#include "DrivetrainSolver.h"
+#include "SimConstants.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace RoR;
+
+namespace {
+
+const float WHEEL_RADIUS = 0.3f;
+
+DrivetrainWheel MakeWheel(float speed, float mass, float retorque = 0.f, int propulsed = 0)
+{
+    return {speed, 0.f, WHEEL_RADIUS * mass, mass, WHEEL_RADIUS, retorque, propulsed, false};
+}
+
+Differential MakeDiff(DiffType type)
+{
+    Differential diff;
+    diff.AddDifferentialType(type);
+    return diff;
+}
+
+/// Applies `drive_torque` to every wheel, solves the drivetrain and integrates the wheel speeds like `Actor::CalcWheels()`.
+void Step(DrivetrainSolver& solver, std::vector<DrivetrainWheel>& wheels, float drive_torque, float dt, DrivetrainEngine* engine = nullptr)
+{
+    for (DrivetrainWheel& wheel: wheels)
+        wheel.dw_torque = drive_torque;
+    solver.Solve(wheels.data(), static_cast<int>(wheels.size()), engine, dt);
+    for (DrivetrainWheel& wheel: wheels)
+    {
+        if (!wheel.dw_detached)
+            wheel.dw_speed += (wheel.dw_torque / wheel.dw_inertia + wheel.dw_retorque / wheel.dw_mass) * dt;
+    }
+}
+
+float SumTorque(const std::vector<DrivetrainWheel>& wheels)
+{
+    float sum = 0.f;
+    for (const DrivetrainWheel& wheel: wheels)
+        sum += wheel.dw_torque;
+    return sum;
+}
+
+/// Engine in gear with a slipping clutch; `EngineSim::GetClutchCoupling()` fills these in the game.
+DrivetrainEngine MakeEngine(float rpm, float gear_ratio, float clutch_damp, float clutch_limit)
+{
+    return {rpm, 10.f, gear_ratio, clutch_damp, clutch_limit, 1.f, 0.f};
+}
+
+/// Driveshaft RPM as `Actor::CalcWheels()` reports it to `EngineSim::SetWheelSpin()`.
+float DriveshaftRpm(const std::vector<DrivetrainWheel>& wheels)
+{
+    int num_propelled = 0;
+    float spin = 0.f;
+    for (const DrivetrainWheel& wheel: wheels)
+    {
+        if (wheel.dw_propulsed)
+            num_propelled++;
+        if (wheel.dw_propulsed == 1 && !wheel.dw_detached)
+            spin += wheel.dw_speed / wheel.dw_radius;
+    }
+    return spin * RAD_PER_SEC_TO_RPM / num_propelled;
+}
+
+void TestTorqueSplit()
+{
+    // Split: always halves
+    DifferentialData split = {{10.f, 2.f}, 0.f, {0.f, 0.f}, 800.f, 0.002f};
+    Differential::CalcSeparateDiff(split);
+    ROR_CHECK_NEAR(split.out_torque[0], 400.f, 1e-3f);
+    ROR_CHECK_NEAR(split.out_torque[1], 400.f, 1e-3f);
+
+    // Open: the faster wheel gets more, the total is kept
+    DifferentialData open = {{12.f, 4.f}, 0.f, {0.f, 0.f}, 800.f, 0.002f};
+    Differential::CalcOpenDiff(open);
+    ROR_CHECK(open.out_torque[0] > open.out_torque[1]);
+    ROR_CHECK_NEAR(open.out_torque[0] + open.out_torque[1], 800.f, 1e-2f);
+    ROR_CHECK_NEAR(open.out_torque[0], 600.f, 1e-2f);
+
+    // Open at standstill: even split
+    DifferentialData open_slow = {{0.5f, 0.f}, 0.f, {0.f, 0.f}, 800.f, 0.002f};
+    Differential::CalcOpenDiff(open_slow);
+    ROR_CHECK_NEAR(open_slow.out_torque[0], 400.f, 1e-3f);
+
+    // Viscous: the slower wheel gets more, the total is kept
+    DifferentialData viscous = {{10.f, 9.9f}, 0.f, {0.f, 0.f}, 800.f, 0.002f};
+    Differential::CalcViscousDiff(viscous);
+    ROR_CHECK(viscous.out_torque[1] > viscous.out_torque[0]);
+    ROR_CHECK_NEAR(viscous.out_torque[0] + viscous.out_torque[1], 800.f, 1e-2f);
+
+    // Coupling rates: only viscous and locked diffs go to the solver
+    const DiffType types[] = {SPLIT_DIFF, OPEN_DIFF, VISCOUS_DIFF, LOCKED_DIFF};
+    for (DiffType type: types)
+    {
+        Differential diff = MakeDiff(type);
+        float rate = -1.f, damp = -1.f;
+        diff.GetCouplingRates(rate, damp);
+        ROR_CHECK(diff.IsCoupling() == (rate > 0.f || damp > 0.f));
+        ROR_CHECK(diff.IsCoupling() == (type == VISCOUS_DIFF || type == LOCKED_DIFF));
+    }
+}
+
+/// The explicit cascade `Actor::CalcDifferentials()` used before the graph: the driveshaft torque evenly over the
+/// attached propelled wheels, then the axle diff re-splits the four wheels' torque between the axles, then each wheel diff its axle's.
+std::vector<float> SplitLikeCascade(const std::vector<DrivetrainWheel>& wheels, Differential& axle_diff, Differential& front_diff, Differential& rear_diff, float torque)
+{
+    std::vector<float> out(4, 0.f);
+    for (int i = 0; i < 4; i++)
+    {
+        if (wheels[i].dw_propulsed && !wheels[i].dw_detached)
+            out[i] = torque / 4.f;
+    }
+
+    DifferentialData axle = {{(wheels[0].dw_speed + wheels[1].dw_speed) * 0.5f, (wheels[2].dw_speed + wheels[3].dw_speed) * 0.5f},
+                             0.f, {0.f, 0.f}, out[0] + out[1] + out[2] + out[3], 0.f};
+    axle_diff.CalcAxleTorque(axle);
+    out[0] = out[1] = axle.out_torque[0] * 0.5f;
+    out[2] = out[3] = axle.out_torque[1] * 0.5f;
+
+    Differential* wheel_diffs[2] = {&front_diff, &rear_diff};
+    for (int a = 0; a < 2; a++)
+    {
+        DifferentialData wheel = {{wheels[2 * a].dw_speed, wheels[2 * a + 1].dw_speed}, 0.f, {0.f, 0.f}, out[2 * a] + out[2 * a + 1], 0.f};
+        wheel_diffs[a]->CalcAxleTorque(wheel);
+        out[2 * a] = wheel.out_torque[0];
+        out[2 * a + 1] = wheel.out_torque[1];
+    }
+    return out;
+}
+
+void TestEngineTorqueSplit()
+{
+    // 4WD: split center diff, open front and rear diffs; the wheels spin at different speeds
+    Differential center = MakeDiff(SPLIT_DIFF), front = MakeDiff(OPEN_DIFF), rear = MakeDiff(OPEN_DIFF);
+    DrivetrainSolver solver;
+    solver.AddDiff(&center, {0, 1}, {2, 3});
+    solver.AddDiff(&front, {0}, {1});
+    solver.AddDiff(&rear, {2}, {3});
+
+    std::vector<DrivetrainWheel> wheels = {MakeWheel(12.f, 20.f, 0.f, 1), MakeWheel(4.f, 20.f, 0.f, 1), MakeWheel(9.f, 20.f, 0.f, 1), MakeWheel(6.f, 20.f, 0.f, 1)};
+    DrivetrainEngine engine = MakeEngine(3000.f, 10.f, 50.f, 1e6f);
+    solver.Solve(wheels.data(), 4, &engine, 0.0005f);
+    ROR_CHECK(engine.de_clutch_torque > 0.f);
+
+    // Each wheel gets the share the old cascade gave it, and all of the clutch torque arrives
+    const std::vector<float> expected = SplitLikeCascade(wheels, center, front, rear, engine.de_clutch_torque);
+    for (int i = 0; i < 4; i++)
+        ROR_CHECK_NEAR(wheels[i].dw_torque, expected[i], 1e-3f * engine.de_clutch_torque);
+    ROR_CHECK(wheels[0].dw_torque > wheels[1].dw_torque); // Open: the faster wheel gets more
+    ROR_CHECK_NEAR(SumTorque(wheels), engine.de_clutch_torque, 1e-3f * engine.de_clutch_torque);
+
+    // The same with a detached wheel, whose share is lost before the diffs, and in 2WD
+    std::vector<DrivetrainWheel> detached = wheels;
+    for (DrivetrainWheel& wheel: detached)
+        wheel.dw_torque = 0.f;
+    detached[3].dw_detached = true;
+    solver.Solve(detached.data(), 4, &engine, 0.0005f);
+    const std::vector<float> expected_detached = SplitLikeCascade(detached, center, front, rear, engine.de_clutch_torque);
+    for (int i = 0; i < 4; i++)
+        ROR_CHECK_NEAR(detached[i].dw_torque, expected_detached[i], 1e-3f * engine.de_clutch_torque);
+
+    // The scale of the 'axles' section multiplies what the wheels get
+    std::vector<DrivetrainWheel> scaled = wheels;
+    for (DrivetrainWheel& wheel: scaled)
+        wheel.dw_torque = 0.f;
+    DrivetrainEngine scaled_engine = engine;
+    scaled_engine.de_rpm = 3000.f;
+    scaled_engine.de_torque_scale = 2.f;
+    solver.Solve(scaled.data(), 4, &scaled_engine, 0.0005f);
+    ROR_CHECK_NEAR(SumTorque(scaled), 2.f * scaled_engine.de_clutch_torque, 1e-3f * scaled_engine.de_clutch_torque);
+
+    // Neutral and a released clutch pass nothing
+    DrivetrainEngine neutral = MakeEngine(3000.f, 0.f, 50.f, 1e6f);
+    DrivetrainEngine released = MakeEngine(3000.f, 10.f, 0.f, 1e6f);
+    for (DrivetrainEngine* idle: {&neutral, &released})
+    {
+        std::vector<DrivetrainWheel> free_wheels = wheels;
+        for (DrivetrainWheel& wheel: free_wheels)
+            wheel.dw_torque = 0.f;
+        solver.Solve(free_wheels.data(), 4, idle, 0.0005f);
+        ROR_CHECK(idle->de_clutch_torque == 0.f);
+        ROR_CHECK(SumTorque(free_wheels) == 0.f);
+    }
+}
+
+void TestClutch()
+{
+    // Rear-wheel drive, no diffs; the front wheels roll freely
+    DrivetrainSolver solver;
+    std::vector<DrivetrainWheel> wheels = {MakeWheel(5.f, 20.f), MakeWheel(5.f, 20.f), MakeWheel(5.f, 20.f, 0.f, 1), MakeWheel(5.f, 20.f, 0.f, 1)};
+    const float gear_ratio = 12.f;
+
+    // A soft clutch at a tiny step passes what `EngineSim` computed explicitly: `damp * slip`
+    DrivetrainEngine soft = MakeEngine(2500.f, gear_ratio, 20.f, 1e6f);
+    const float slip = soft.de_rpm / gear_ratio - DriveshaftRpm(wheels);
+    solver.Solve(wheels.data(), 4, &soft, 1e-5f);
+    ROR_CHECK_NEAR(soft.de_clutch_torque, 20.f * slip, 1e-2f * 20.f * slip);
+    ROR_CHECK(wheels[0].dw_torque == 0.f && wheels[1].dw_torque == 0.f);
+    ROR_CHECK_NEAR(wheels[2].dw_torque, soft.de_clutch_torque * 0.5f, 1e-3f);
+
+    // The implicit clutch never passes more than it takes to equalize the speeds within the step
+    for (DrivetrainWheel& wheel: wheels)
+        wheel.dw_torque = 0.f;
+    DrivetrainEngine stiff = MakeEngine(2500.f, gear_ratio, 1e7f, 1e9f);
+    solver.Solve(wheels.data(), 4, &stiff, 0.002f);
+    const float rpm_after = stiff.de_rpm - 0.002f * stiff.de_clutch_torque / gear_ratio / stiff.de_inertia;
+    for (int i = 2; i < 4; i++)
+        wheels[i].dw_speed += wheels[i].dw_torque / wheels[i].dw_inertia * 0.002f;
+    ROR_CHECK_NEAR(rpm_after / gear_ratio, DriveshaftRpm(wheels), 0.01f * slip);
+
+    // Over its limit, the clutch slips at the limit
+    for (DrivetrainWheel& wheel: wheels)
+    {
+        wheel.dw_torque = 0.f;
+        wheel.dw_speed = 5.f;
+    }
+    DrivetrainEngine limited = MakeEngine(2500.f, gear_ratio, 1e7f, 800.f);
+    solver.Solve(wheels.data(), 4, &limited, 0.002f);
+    ROR_CHECK_NEAR(limited.de_clutch_torque, 800.f, 1e-2f);
+    ROR_CHECK_NEAR(wheels[2].dw_torque + wheels[3].dw_torque, 800.f, 1e-2f);
+
+    // Reverse gear: the wheels are driven backwards
+    for (DrivetrainWheel& wheel: wheels)
+    {
+        wheel.dw_torque = 0.f;
+        wheel.dw_speed = 0.f;
+    }
+    DrivetrainEngine reverse = MakeEngine(1500.f, -gear_ratio, 20.f, 1e6f);
+    solver.Solve(wheels.data(), 4, &reverse, 0.0005f);
+    ROR_CHECK(reverse.de_clutch_torque < 0.f);
+    ROR_CHECK(wheels[2].dw_torque < 0.f);
+}
+
+/// Engine at constant torque driving two light wheels through a stiff clutch, against drag; returns the largest
+/// change of the clutch torque between two steps over the last half of `duration` seconds. `explicit_clutch`
+/// integrates the clutch a step behind the wheels, the way `EngineSim::UpdateEngineSim()` does on its own
+/// (without its slip factor and torque limit, which only bound the ringing).
+float SimulateClutch(float clutch_damp, float wheel_mass, float dt, float duration, bool explicit_clutch)
+{
+    std::vector<DrivetrainWheel> wheels = {MakeWheel(0.f, wheel_mass, 0.f, 1), MakeWheel(0.f, wheel_mass, 0.f, 1)};
+    DrivetrainEngine engine = MakeEngine(1500.f, 10.f, clutch_damp, 1e6f);
+    const float ENGINE_TORQUE = 500.f, DRAG = 40.f;
+    DrivetrainSolver solver;
+    float clutch_torque = 0.f;
+
+    const int num_steps = static_cast<int>(duration / dt);
+    float max_change = 0.f;
+    for (int i = 0; i < num_steps; i++)
+    {
+        for (DrivetrainWheel& wheel: wheels)
+            wheel.dw_retorque = -DRAG * wheel.dw_speed;
+
+        float prev_clutch_torque = clutch_torque;
+        if (explicit_clutch)
+        {
+            for (DrivetrainWheel& wheel: wheels)
+                wheel.dw_speed += (clutch_torque * 0.5f / wheel.dw_inertia + wheel.dw_retorque / wheel.dw_mass) * dt;
+            engine.de_rpm += dt * (ENGINE_TORQUE - clutch_torque / engine.de_gear_ratio) / engine.de_inertia;
+            clutch_torque = (engine.de_rpm / engine.de_gear_ratio - DriveshaftRpm(wheels)) * clutch_damp;
+        }
+        else
+        {
+            engine.de_rpm += dt * ENGINE_TORQUE / engine.de_inertia;
+            Step(solver, wheels, 0.f, dt, &engine);
+            engine.de_rpm -= dt * engine.de_clutch_torque / engine.de_gear_ratio / engine.de_inertia;
+            clutch_torque = engine.de_clutch_torque;
+        }
+
+        if (!std::isfinite(clutch_torque))
+            return std::fabs(clutch_torque);
+        if (i >= num_steps / 2)
+            max_change = std::max(max_change, std::fabs(clutch_torque - prev_clutch_torque));
+    }
+    return max_change;
+}
+
+void TestClutchStability()
+{
+    // 5 kg wheels on a 10000 clutch force, the default; the steady state passes 5000 (engine torque * gear ratio)
+    const float timesteps[] = {0.0005f, 0.002f, 0.01f, 0.02f};
+
+    printf("  dt [ms]   implicit   explicit   [max clutch torque change per step]\n");
+    for (float dt: timesteps)
+    {
+        const float implicit_clutch = SimulateClutch(10000.f, 5.f, dt, 4.f, false);
+        const float explicit_clutch = SimulateClutch(10000.f, 5.f, dt, 4.f, true);
+        printf("  %7.1f %10.4f %10g\n", dt * 1000.f, implicit_clutch, explicit_clutch);
+
+        ROR_CHECK(implicit_clutch < 1.f);       // Settled
+        ROR_CHECK(!(explicit_clutch < 1000.f)); // The explicit clutch rings (or diverges) at all these steps
+    }
+}
+
+void TestCouplingTorqueIsInternal()
+{
+    // Axle diff between two axles plus a wheel diff on each; the drive torque must come out unchanged
+    std::vector<DrivetrainWheel> wheels = {MakeWheel(10.f, 20.f), MakeWheel(12.f, 20.f), MakeWheel(7.f, 30.f), MakeWheel(9.f, 30.f)};
+    Differential center = MakeDiff(LOCKED_DIFF), front = MakeDiff(LOCKED_DIFF), rear = MakeDiff(VISCOUS_DIFF);
+    center.di_delta_rotation = 0.01f;
+    front.di_delta_rotation = -0.02f;
+
+    DrivetrainSolver solver;
+    solver.AddDiff(&center, {0, 1}, {2, 3});
+    solver.AddDiff(&front, {0}, {1});
+    solver.AddDiff(&rear, {2}, {3});
+    ROR_CHECK(solver.GetNumDiffs() == 3);
+
+    Step(solver, wheels, 250.f, 0.002f);
+    ROR_CHECK_NEAR(SumTorque(wheels), 1000.f, 1e-1f);
+    ROR_CHECK(wheels[0].dw_torque > wheels[1].dw_torque); // The faster wheel is held back
+    ROR_CHECK(wheels[2].dw_torque > wheels[3].dw_torque);
+    ROR_CHECK(rear.di_delta_rotation == 0.f);              // Viscous only, no spring to advance
+
+    // Split and open diffs add no coupling
+    Differential split = MakeDiff(SPLIT_DIFF);
+    DrivetrainSolver none;
+    none.AddDiff(&split, {0, 1}, {2, 3});
+    for (DrivetrainWheel& wheel: wheels)
+        wheel.dw_torque = 250.f;
+    none.Solve(wheels.data(), 4, nullptr, 0.002f);
+    ROR_CHECK(wheels[0].dw_torque == 250.f && wheels[3].dw_torque == 250.f);
+}
+
+void TestDetachedSide()
+{
+    // Wheel diff with one wheel detached: skipped, and the wheel follows the other one.
+    // Axle diff with one wheel of an axle detached: the other one is the side.
+    std::vector<DrivetrainWheel> wheels = {MakeWheel(10.f, 20.f), MakeWheel(5.f, 20.f), MakeWheel(8.f, 20.f), MakeWheel(8.f, 20.f)};
+    wheels[1].dw_detached = true;
+    Differential wheel_diff = MakeDiff(LOCKED_DIFF), axle_diff = MakeDiff(LOCKED_DIFF);
+
+    DrivetrainSolver solver;
+    solver.AddDiff(&axle_diff, {0, 1}, {2, 3});
+    solver.AddDiff(&wheel_diff, {0}, {1});
+    for (DrivetrainWheel& wheel: wheels)
+        wheel.dw_torque = 100.f;
+    solver.Solve(wheels.data(), 4, nullptr, 0.002f);
+
+    ROR_CHECK(wheel_diff.di_delta_rotation == 0.f);
+    ROR_CHECK(axle_diff.di_delta_rotation != 0.f);
+    ROR_CHECK(wheels[1].dw_torque == 100.f);
+    ROR_CHECK(wheels[1].dw_speed == 10.f);
+    ROR_CHECK(wheels[0].dw_torque < 100.f);
+    ROR_CHECK_NEAR(wheels[2].dw_torque, wheels[3].dw_torque, 1e-3f);
+    ROR_CHECK_NEAR(wheels[0].dw_torque + wheels[2].dw_torque + wheels[3].dw_torque, 300.f, 1e-1f);
+}
+
+void TestTransferCase()
+{
+    // The transfer case only locks the axles together in 4WD
+    std::vector<DrivetrainWheel> wheels = {MakeWheel(10.f, 20.f, 0.f, 1), MakeWheel(10.f, 20.f, 0.f, 1), MakeWheel(6.f, 20.f), MakeWheel(6.f, 20.f)};
+    Differential transfer_case = MakeDiff(LOCKED_DIFF);
+    DrivetrainSolver solver;
+    const int node = solver.AddDiff(&transfer_case, {0, 1}, {2, 3});
+
+    solver.SetDiffEnabled(node, false);
+    Step(solver, wheels, 0.f, 0.002f);
+    ROR_CHECK(transfer_case.di_delta_rotation == 0.f);
+    ROR_CHECK(SumTorque(wheels) == 0.f);
+
+    solver.SetDiffEnabled(node, true);
+    for (int i = 0; i < 2000; i++)
+        Step(solver, wheels, 0.f, 0.002f);
+    ROR_CHECK_NEAR(wheels[0].dw_speed, wheels[2].dw_speed, 1e-2f);
+}
+
+/// Two wheels on a locked (or viscous) diff, one of them on ice; returns the largest speed difference over the
+/// last half of `duration` seconds. `explicit_springs` runs `Differential::CalcLockedDiff()` instead, the per-diff
+/// scheme the solver replaced.
+float SimulateSlip(DiffType type, float wheel_mass, float dt, float duration, bool explicit_springs)
+{
+    // Wheel 1 has grip (ground reaction), wheel 0 spins freely and starts 5 m/s faster
+    std::vector<DrivetrainWheel> wheels = {MakeWheel(15.f, wheel_mass), MakeWheel(10.f, wheel_mass, -300.f)};
+    Differential diff = MakeDiff(type);
+    DrivetrainSolver solver;
+    solver.AddDiff(&diff, {0}, {1});
+
+    const int num_steps = static_cast<int>(duration / dt);
+    float max_delta_speed = 0.f;
+    for (int i = 0; i < num_steps; i++)
+    {
+        if (explicit_springs)
+        {
+            DifferentialData diff_data = {{wheels[0].dw_speed, wheels[1].dw_speed}, diff.di_delta_rotation, {0.f, 0.f}, 200.f, dt};
+            Differential::CalcLockedDiff(diff_data);
+            diff.di_delta_rotation = diff_data.delta_rotation;
+            wheels[0].dw_torque = diff_data.out_torque[0];
+            wheels[1].dw_torque = diff_data.out_torque[1];
+            for (DrivetrainWheel& wheel: wheels)
+                wheel.dw_speed += (wheel.dw_torque / wheel.dw_inertia + wheel.dw_retorque / wheel.dw_mass) * dt;
+        }
+        else
+        {
+            Step(solver, wheels, 100.f, dt);
+        }
+
+        const float delta_speed = std::fabs(wheels[0].dw_speed - wheels[1].dw_speed);
+        if (!std::isfinite(delta_speed))
+            return delta_speed;
+        if (i >= num_steps / 2)
+            max_delta_speed = std::max(max_delta_speed, delta_speed);
+    }
+    return max_delta_speed;
+}
+
+void TestLargeTimestepStability()
+{
+    // Rates of `Differential::GetCouplingRates()`; 5 kg wheels are far lighter than what the explicit springs handled
+    const float WHEEL_MASS = 5.f;
+    const float timesteps[] = {0.0005f, 0.002f, 0.01f, 0.02f};
+
+    printf("  dt [ms]   locked   viscous   locked (explicit)   [max speed difference, m/s]\n");
+    for (float dt: timesteps)
+    {
+        const float locked = SimulateSlip(LOCKED_DIFF, WHEEL_MASS, dt, 4.f, false);
+        const float viscous = SimulateSlip(VISCOUS_DIFF, WHEEL_MASS, dt, 4.f, false);
+        const float locked_explicit = SimulateSlip(LOCKED_DIFF, WHEEL_MASS, dt, 4.f, true);
+        printf("  %7.1f %8.4f %9.4f %19g\n", dt * 1000.f, locked, viscous, locked_explicit);
+
+        ROR_CHECK(locked < 0.01f);   // Held together
+        ROR_CHECK(viscous < 0.1f);   // Slips by `retorque * radius / damp`, no oscillation
+        if (dt >= 0.002f)
+        {
+            ROR_CHECK(!(locked_explicit < 1.f)); // What the solver replaces diverges (or goes NaN) at these steps
+        }
+    }
+}
+
+void TestChainedLockedDiffsConverge()
+{
+    // 4WD with locked center and rear diffs, open front; each wheel with a different grip, driven through the clutch
+    std::vector<DrivetrainWheel> wheels = {MakeWheel(20.f, 15.f, 0.f, 1), MakeWheel(12.f, 15.f, -200.f, 1), MakeWheel(10.f, 25.f, -400.f, 1), MakeWheel(5.f, 25.f, -100.f, 1)};
+    Differential center = MakeDiff(LOCKED_DIFF), front = MakeDiff(OPEN_DIFF), rear = MakeDiff(LOCKED_DIFF);
+    DrivetrainSolver solver;
+    solver.AddDiff(&center, {0, 1}, {2, 3});
+    solver.AddDiff(&front, {0}, {1});
+    solver.AddDiff(&rear, {2}, {3});
+
+    DrivetrainEngine engine = MakeEngine(2000.f, 8.f, 10000.f, 1e6f);
+    for (int i = 0; i < 5000; i++)
+    {
+        engine.de_rpm += 0.002f * 100.f / engine.de_inertia;
+        Step(solver, wheels, 0.f, 0.002f, &engine);
+        engine.de_rpm -= 0.002f * engine.de_clutch_torque / engine.de_gear_ratio / engine.de_inertia;
+    }
+
+    const float front_speed = (wheels[0].dw_speed + wheels[1].dw_speed) * 0.5f;
+    const float rear_speed = (wheels[2].dw_speed + wheels[3].dw_speed) * 0.5f;
+    ROR_CHECK_NEAR(front_speed, rear_speed, 1e-2f);
+    ROR_CHECK_NEAR(wheels[2].dw_speed, wheels[3].dw_speed, 1e-2f);
+    ROR_CHECK_NEAR(engine.de_rpm / engine.de_gear_ratio, DriveshaftRpm(wheels), 1.f);
+    ROR_CHECK(std::isfinite(center.di_delta_rotation) && std::isfinite(rear.di_delta_rotation));
+}
+
+} // namespace
+
+int main()
+{
+    TestTorqueSplit();
+    TestEngineTorqueSplit();
+    TestClutch();
+    TestClutchStability();
+    TestCouplingTorqueIsInternal();
+    TestDetachedSide();
+    TestTransferCase();
+    TestLargeTimestepStability();
+    TestChainedLockedDiffsConverge();
+
+    return RoR::Test::Finish("DrivetrainSolverTest");
+}
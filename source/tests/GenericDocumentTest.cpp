@@ -0,0 +1,236 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Checks GenericDocument (the tokenizer and writer behind .tobj, .terrn2, .skin and other text formats) on
+/// documents whose string pool is past 16 MiB and numbers past float precision: everything must survive
+/// a load -> save -> load round trip exactly. Tokens straddling the 64 KiB read blocks and documents
+/// without a final newline are covered too.
+
+#include "Console.h"
+#include "GenericFileFormat.h"
+#include "TestUtils.h"
+
+#include <Ogre.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace RoR;
+
+// The parser reports malformed input to the console; the test keeps the messages instead of linking the game's console.
+namespace {
+std::vector<std::string> g_console_messages;
+}
+
+void Console::putMessage(MessageArea area, MessageType type, std::string const& msg, std::string icon)
+{
+    g_console_messages.push_back(msg);
+}
+
+void Console::messageLogged(const Ogre::String& message, Ogre::LogMessageLevel lml, bool maskDebug, const Ogre::String& logName, bool& skipThisMessage)
+{
+}
+
+Console* App::GetConsole()
+{
+    static Console console;
+    return &console;
+}
+
+namespace {
+
+GenericDocumentPtr Load(std::string text, BitMask_t options = 0)
+{
+    Ogre::DataStreamPtr stream(OGRE_NEW Ogre::MemoryDataStream(&text[0], text.size(), /*freeOnClose:*/false, /*readOnly:*/true));
+    GenericDocumentPtr doc = new GenericDocument();
+    doc->loadFromDataStream(stream, options);
+    return doc;
+}
+
+std::string Save(GenericDocumentPtr doc)
+{
+    // Generous upper bound: every token is written as its text plus a separator
+    const size_t capacity = doc->string_pool.size() * 2 + doc->tokens.size() * 32 + 1024;
+    Ogre::MemoryDataStream* memory = OGRE_NEW Ogre::MemoryDataStream(capacity);
+    Ogre::DataStreamPtr stream(memory);
+    doc->saveToDataStream(stream);
+    return std::string(static_cast<const char*>(static_cast<void*>(memory->getPtr())), memory->tell());
+}
+
+/// Saves and loads again. The writer doesn't quote strings, so they come back as naked strings.
+GenericDocumentPtr Reload(GenericDocumentPtr doc)
+{
+    return Load(Save(doc), GenericDocument::OPTION_ALLOW_NAKED_STRINGS);
+}
+
+bool SameTokens(GenericDocumentPtr a, GenericDocumentPtr b)
+{
+    if (a->tokens.size() != b->tokens.size())
+        return false;
+
+    for (size_t i = 0; i < a->tokens.size(); i++)
+    {
+        const Token& ta = a->tokens[i];
+        const Token& tb = b->tokens[i];
+        if (ta.type != tb.type)
+            return false;
+
+        switch (ta.type)
+        {
+        case TokenType::COMMENT:
+        case TokenType::STRING:
+        case TokenType::KEYWORD:
+            if (std::strcmp(a->string_pool.data() + ta.data.offset, b->string_pool.data() + tb.data.offset) != 0)
+                return false;
+            break;
+
+        case TokenType::NUMBER:
+        case TokenType::BOOL:
+            if (ta.is_integer != tb.is_integer)
+                return false;
+            if (ta.is_integer ? (ta.data.integer != tb.data.integer) : (std::memcmp(&ta.data.number, &tb.data.number, sizeof(double)) != 0))
+                return false;
+            break;
+
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+void TestLargeStringPool()
+{
+    // ~18 MiB of string data; offsets and integers both go past what a float holds exactly (2^24)
+    const int NUM_LINES = 500000;
+    const int64_t FIRST_ID = 16777217; // 2^24 + 1
+    std::string text;
+    text.reserve(NUM_LINES * 80);
+    for (int i = 0; i < NUM_LINES; i++)
+    {
+        text += "node \"abcdefghijklmnopqrstuvwxyz0123\", ";
+        text += std::to_string(FIRST_ID + i);
+        text += ", 0.1, 123456789012345678\n";
+        if (i % 1000 == 0)
+            text += "; checkpoint " + std::to_string(i) + "\n";
+    }
+
+    Test::Stopwatch stopwatch;
+    GenericDocumentPtr doc = Load(text);
+    printf("  parsed %zu bytes in %.1f ms, string pool %zu bytes\n", text.size(), stopwatch.GetElapsedMs(), doc->string_pool.size());
+    ROR_CHECK(doc->string_pool.size() > (size_t(1) << 24));
+    ROR_CHECK(doc->line_starts.size() == NUM_LINES);
+
+    // Read it like the game does
+    GenericDocReaderPtr reader = new GenericDocReader(doc);
+    int num_lines = 0;
+    int num_bad_lines = 0;
+    while (!reader->endOfFile())
+    {
+        const bool ok = reader->isTokKeyword() && std::strcmp(reader->getTokKeyword(), "node") == 0
+            && reader->isTokString(1) && std::strcmp(reader->getTokString(1), "abcdefghijklmnopqrstuvwxyz0123") == 0
+            && reader->isTokInt(2) && reader->getTokInt(2) == FIRST_ID + num_lines
+            && !reader->isTokInt(3) && reader->getTokDouble(3) == 0.1
+            && reader->isTokInt(4) && reader->getTokInt(4) == 123456789012345678LL
+            && reader->countLineArgs() == 5;
+        if (!ok)
+            num_bad_lines++;
+        num_lines++;
+        reader->seekNextLine();
+    }
+    ROR_CHECK(num_lines == NUM_LINES);
+    ROR_CHECK(num_bad_lines == 0);
+
+    // The last string lives past 16 MiB; it must read back exactly after saving and loading again
+    const Token& last_string = doc->tokens[doc->line_starts.back() + 1];
+    ROR_CHECK(last_string.type == TokenType::STRING);
+    ROR_CHECK(last_string.data.offset > (size_t(1) << 24));
+
+    GenericDocumentPtr reloaded = Reload(doc);
+    ROR_CHECK(reloaded->string_pool.size() == doc->string_pool.size());
+    ROR_CHECK(reloaded->line_starts == doc->line_starts);
+    ROR_CHECK(SameTokens(doc, reloaded));
+    ROR_CHECK(g_console_messages.empty());
+}
+
+void TestNumbersRoundTrip()
+{
+    GenericDocumentPtr doc = Load("a 1.0000000000000002 -3 1e300 2.5e-8 0.1 5.0 true false 9007199254740993 16777217 -9223372036854775807\nb x");
+    GenericDocReaderPtr reader = new GenericDocReader(doc);
+    ROR_CHECK(reader->getTokDouble(1) == 1.0000000000000002);
+    ROR_CHECK(reader->isTokInt(2) && reader->getTokInt(2) == -3);
+    ROR_CHECK(reader->getTokDouble(3) == 1e300);
+    ROR_CHECK(!reader->isTokInt(6) && reader->getTokDouble(6) == 5.0);
+    ROR_CHECK(reader->getTokBool(7) && !reader->getTokBool(8));
+    ROR_CHECK(reader->getTokInt(9) == 9007199254740993LL); // 2^53 + 1, not representable as double
+    ROR_CHECK(reader->getTokInt(10) == 16777217);          // 2^24 + 1, not representable as float
+    ROR_CHECK(reader->getTokInt(11) == -9223372036854775807LL);
+
+    GenericDocumentPtr reloaded = Reload(doc);
+    ROR_CHECK(SameTokens(doc, reloaded));
+}
+
+void TestTokensAcrossReadBlocks()
+{
+    // `loadFromDataStream()` reads 64 KiB at a time; put a long string, a number and a keyword across the boundary
+    const size_t BLOCK = 64 * 1024;
+    std::string text = "; padding\n";
+    text += "keyword1 \"" + std::string(BLOCK - text.size() - 20, 's') + "\", 12345678";
+    while (text.size() < BLOCK - 3)
+        text += ' ';
+    text += "\nlongkeyword 1.5\nlast \"" + std::string(BLOCK, 't') + "\"\n";
+
+    GenericDocumentPtr doc = Load(text);
+    GenericDocReaderPtr reader = new GenericDocReader(doc);
+    reader->seekNextLine(); // Skip the comment
+    ROR_CHECK(reader->isTokKeyword() && std::strcmp(reader->getTokKeyword(), "keyword1") == 0);
+    ROR_CHECK(std::strlen(reader->getTokString(1)) == BLOCK - 30);
+    ROR_CHECK(reader->getTokInt(2) == 12345678);
+    reader->seekNextLine();
+    ROR_CHECK(reader->isTokKeyword() && std::strcmp(reader->getTokKeyword(), "longkeyword") == 0);
+    ROR_CHECK(reader->getTokDouble(1) == 1.5);
+    reader->seekNextLine();
+    ROR_CHECK(std::strlen(reader->getTokString(1)) == BLOCK);
+
+    ROR_CHECK(SameTokens(doc, Reload(doc)));
+}
+
+void TestNoFinalNewline()
+{
+    GenericDocumentPtr doc = Load("first 1\nsecond 2");
+    GenericDocReaderPtr reader = new GenericDocReader(doc);
+    reader->seekNextLine();
+    ROR_CHECK(reader->isTokKeyword() && std::strcmp(reader->getTokKeyword(), "second") == 0);
+    ROR_CHECK(reader->getTokInt(1) == 2);
+    ROR_CHECK(doc->tokens.back().type == TokenType::LINEBREAK);
+}
+
+} // namespace
+
+int main()
+{
+    TestLargeStringPool();
+    TestNumbersRoundTrip();
+    TestTokensAcrossReadBlocks();
+    TestNoFinalNewline();
+
+    return RoR::Test::Finish("GenericDocumentTest");
+}
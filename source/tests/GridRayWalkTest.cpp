@@ -0,0 +1,521 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Checks the ray casts built on GridRayWalk against brute force:
+/// - GridRayWalk itself: the visited cells against dense sampling of the segment.
+/// - CollisionCells, the lookup behind Collisions::castRay() and castRays(): the nearest hit against testing every
+///   collision triangle and box, with elements in the cells clamped to 0 and MAXIMUM_CELL.
+/// - TerrainHeightPages, the heightfield behind TerrainGeometryManager::intersectsRay(): the hit against dense
+///   sampling of the height along the segment.
+
+#include "CollisionCells.h"
+#include "GridRayWalk.h"
+#include "TerrainHeightPages.h"
+#include "TestUtils.h"
+
+#include <Ogre.h>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace RoR;
+
+namespace {
+
+typedef std::pair<long, long> Cell;
+
+void TestWalkMatchesSampling()
+{
+    const int NUM_SEGMENTS = 20000;
+    const int NUM_SAMPLES = 500;
+    const float BORDER_EPSILON = 1e-3f;
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> pos(-50.f, 50.f);
+    std::uniform_real_distribution<float> len(-20.f, 20.f);
+
+    for (int i = 0; i < NUM_SEGMENTS; i++)
+    {
+        const float u0 = pos(rng), v0 = pos(rng);
+        float du = len(rng), dv = len(rng);
+        if (i % 7 == 0)
+            du = 0.f; // Along the grid lines
+        if (i % 11 == 0)
+            dv = 0.f;
+        const float t_enter = (i % 3 == 0) ? 0.25f : 0.f;
+        const float t_leave = 1.f;
+
+        std::vector<Cell> visited;
+        float t_prev = t_enter;
+        bool ordered = true;
+        GridRayWalk walk(u0, v0, du, dv, t_enter, t_leave);
+        while (true)
+        {
+            visited.push_back(Cell(walk.GetCellU(), walk.GetCellV()));
+            ordered = ordered && walk.GetCellEnter() == t_prev && walk.GetCellExit() >= walk.GetCellEnter();
+            t_prev = walk.GetCellExit();
+            if (walk.IsLastCell())
+                break;
+            walk.Step();
+        }
+        ROR_CHECK(ordered);
+        ROR_CHECK(t_prev == t_leave);
+
+        // Each step moves to a neighbour cell, no cell is visited twice
+        bool connected = true;
+        for (size_t c = 1; c < visited.size(); c++)
+        {
+            const long dist = std::abs(visited[c].first - visited[c - 1].first) + std::abs(visited[c].second - visited[c - 1].second);
+            connected = connected && dist == 1;
+        }
+        ROR_CHECK(connected);
+        ROR_CHECK(std::set<Cell>(visited.begin(), visited.end()).size() == visited.size());
+
+        // Every sampled point lies in a visited cell (points on a cell border may be in either cell)
+        const std::set<Cell> visited_set(visited.begin(), visited.end());
+        bool covered = true;
+        for (int s = 0; s <= NUM_SAMPLES; s++)
+        {
+            const float t = t_enter + (t_leave - t_enter) * s / NUM_SAMPLES;
+            const float u = u0 + du * t, v = v0 + dv * t;
+            if (std::abs(u - std::round(u)) < BORDER_EPSILON || std::abs(v - std::round(v)) < BORDER_EPSILON)
+                continue;
+            covered = covered && visited_set.count(Cell((long)std::floor(u), (long)std::floor(v))) == 1;
+        }
+        ROR_CHECK(covered);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// CollisionCells
+
+struct CollisionScene
+{
+    CollisionScene(): cells(new CollisionCells(tris, boxes)) {}
+
+    /// Same setup as `Collisions::addCollisionTri()`
+    void AddTri(Ogre::Vector3 const& a, Ogre::Vector3 const& b, Ogre::Vector3 const& c, bool enabled)
+    {
+        collision_tri_t tri;
+        tri.a = a;
+        tri.b = b;
+        tri.c = c;
+        tri.gm = nullptr;
+        tri.enabled = enabled;
+        const Ogre::Vector3 normal = (b - a).crossProduct(c - a).normalisedCopy();
+        tri.reverse.SetColumn(0, b - a);
+        tri.reverse.SetColumn(1, c - a);
+        tri.reverse.SetColumn(2, normal);
+        tri.forward = tri.reverse.Inverse();
+        tri.aab.merge(a);
+        tri.aab.merge(b);
+        tri.aab.merge(c);
+        tri.aab.setMinimum(tri.aab.getMinimum() - 0.1f);
+        tri.aab.setMaximum(tri.aab.getMaximum() + 0.1f);
+
+        cells->AddElement(static_cast<int>(tris.size()) + CollisionCells::hash_coll_element_t::ELEMENT_TRI_BASE_INDEX,
+            tri.aab.getMinimum(), tri.aab.getMaximum());
+        tris.push_back(tri);
+    }
+
+    /// Same setup as `Collisions::addCollisionBox()`: box space is turned by `selfrot` about `selfcenter`, then by `rot`, then moved to `center`.
+    void AddBox(Ogre::Vector3 const& center, Ogre::Vector3 const& half_size, Ogre::Quaternion const& rot,
+        Ogre::Quaternion const& selfrot, Ogre::Vector3 const& selfcenter, bool virt, bool enabled)
+    {
+        collision_box_t box;
+        box.virt = virt;
+        box.enabled = enabled;
+        box.camforced = false;
+        box.event_filter = EVENT_ALL;
+        box.eventsourcenum = -1;
+        box.refined = (rot != Ogre::Quaternion::IDENTITY);
+        box.rot = rot;
+        box.unrot = rot.Inverse();
+        box.selfrotated = (selfrot != Ogre::Quaternion::IDENTITY);
+        box.selfcenter = selfcenter;
+        box.selfrot = selfrot;
+        box.selfunrot = selfrot.Inverse();
+        box.center = center;
+        box.relo = -half_size;
+        box.rehi = half_size;
+        box.campos = Ogre::Vector3::ZERO;
+        for (int i = 0; i < 8; i++)
+        {
+            box.debug_verts[i] = ToWorld(box, GetCorner(box, i));
+        }
+        box.lo = box.debug_verts[0];
+        box.hi = box.debug_verts[0];
+        for (int i = 1; i < 8; i++)
+        {
+            box.lo.makeFloor(box.debug_verts[i]);
+            box.hi.makeCeil(box.debug_verts[i]);
+        }
+
+        cells->AddElement(static_cast<int>(boxes.size()), box.lo, box.hi);
+        boxes.push_back(box);
+    }
+
+    static Ogre::Vector3 GetCorner(collision_box_t const& box, int i)
+    {
+        return Ogre::Vector3((i & 1) ? box.rehi.x : box.relo.x, (i & 2) ? box.rehi.y : box.relo.y, (i & 4) ? box.rehi.z : box.relo.z);
+    }
+
+    static Ogre::Vector3 ToWorld(collision_box_t const& box, Ogre::Vector3 pos)
+    {
+        if (box.selfrotated)
+            pos = box.selfrot * (pos - box.selfcenter) + box.selfcenter;
+        if (box.refined)
+            pos = box.rot * pos;
+        return pos + box.center;
+    }
+
+    static bool IsInside(collision_box_t const& box, Ogre::Vector3 pos)
+    {
+        pos = box.unrot * (pos - box.center);
+        pos = box.selfunrot * (pos - box.selfcenter) + box.selfcenter;
+        return pos.x >= box.relo.x && pos.y >= box.relo.y && pos.z >= box.relo.z &&
+               pos.x <= box.rehi.x && pos.y <= box.rehi.y && pos.z <= box.rehi.z;
+    }
+
+    /// Tests every element; a box is tested as its 12 faces.
+    collision_ray_hit_t CastRayBruteForce(const Ogre::Ray& ray) const
+    {
+        // The corners of each face, in box space
+        static const int FACES[6][4] = { {0, 2, 6, 4}, {1, 3, 7, 5}, {0, 1, 5, 4}, {2, 3, 7, 6}, {0, 1, 3, 2}, {4, 5, 7, 6} };
+
+        collision_ray_hit_t hit;
+        for (size_t i = 0; i < tris.size(); i++)
+        {
+            if (!tris[i].enabled)
+                continue;
+            auto result = Ogre::Math::intersects(ray, tris[i].a, tris[i].b, tris[i].c);
+            if (result.first && result.second < hit.distance)
+            {
+                hit.hit = true;
+                hit.distance = result.second;
+                hit.ctri_index = static_cast<int>(i);
+                hit.cbox_index = -1;
+            }
+        }
+        for (size_t i = 0; i < boxes.size(); i++)
+        {
+            if (!boxes[i].enabled || boxes[i].virt)
+                continue;
+            for (int f = 0; f < 6; f++)
+            {
+                Ogre::Vector3 quad[4];
+                for (int k = 0; k < 4; k++)
+                {
+                    quad[k] = ToWorld(boxes[i], GetCorner(boxes[i], FACES[f][k]));
+                }
+                for (int half = 0; half < 2; half++)
+                {
+                    auto result = Ogre::Math::intersects(ray, quad[0], quad[1 + half], quad[2 + half]);
+                    if (result.first && result.second < hit.distance)
+                    {
+                        hit.hit = true;
+                        hit.distance = result.second;
+                        hit.ctri_index = -1;
+                        hit.cbox_index = static_cast<int>(i);
+                    }
+                }
+            }
+        }
+        return hit;
+    }
+
+    bool IsInsideAnyBox(Ogre::Vector3 const& pos) const
+    {
+        for (collision_box_t const& box : boxes)
+        {
+            if (box.enabled && !box.virt && IsInside(box, pos))
+                return true;
+        }
+        return false;
+    }
+
+    CollisionTriVec tris;
+    CollisionBoxVec boxes;
+    std::unique_ptr<CollisionCells> cells; //!< Over 20MB of hash table, kept off the stack
+};
+
+void TestCollisionCellsMatchBruteForce()
+{
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    auto random_vector = [&](float size) { return Ogre::Vector3(unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f) * size; };
+    auto random_rotation = [&]()
+    {
+        Ogre::Quaternion q(unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f);
+        q.normalise();
+        return q;
+    };
+
+    // Areas of the scene: the bounds (x from, x to, z from, z to) and the elements in them
+    struct Area { float x0, x1, z0, z1; int num_tris; int num_boxes; };
+    const float MAX_CELL_X = CollisionCells::MAXIMUM_CELL * CollisionCells::CELL_SIZE;
+    const Area AREAS[] =
+    {
+        { 0.f, 200.f, 0.f, 200.f, 2000, 300 },                           // Ordinary
+        { -60.f, 0.f, -60.f, 20.f, 200, 30 },                            // Clamped to cell 0
+        { MAX_CELL_X - 30.f, MAX_CELL_X + 60.f, 0.f, 100.f, 200, 30 },   // Clamped to MAXIMUM_CELL
+        { 0.f, 4000.f, 0.f, 4000.f, 3000, 0 },                           // Sparse, many hash entries
+    };
+
+    CollisionScene scene;
+    for (const Area& area : AREAS)
+    {
+        auto random_pos = [&]() { return Ogre::Vector3(area.x0 + unit(rng) * (area.x1 - area.x0), unit(rng) * 20, area.z0 + unit(rng) * (area.z1 - area.z0)); };
+        for (int i = 0; i < area.num_tris; i++)
+        {
+            const Ogre::Vector3 p = random_pos();
+            const float size = (i % 10 == 0) ? 30.f : 3.f; // Some triangles span many cells
+            scene.AddTri(p, p + random_vector(size), p + random_vector(size), /*enabled=*/(i % 20 != 0));
+        }
+        for (int i = 0; i < area.num_boxes; i++)
+        {
+            const Ogre::Vector3 half_size(0.5f + unit(rng) * 4, 0.5f + unit(rng) * 4, 0.5f + unit(rng) * 4);
+            const Ogre::Quaternion rot = (i % 3 == 0) ? random_rotation() : Ogre::Quaternion::IDENTITY;
+            const Ogre::Quaternion selfrot = (i % 6 == 1) ? random_rotation() : Ogre::Quaternion::IDENTITY;
+            scene.AddBox(random_pos(), half_size, rot, selfrot, random_vector(2.f), /*virt=*/(i % 10 == 5), /*enabled=*/(i % 20 != 7));
+        }
+    }
+
+    // Rays within and around each area: short ones, vertical ones, ones along the grid axes and long ones from far away
+    std::vector<Ogre::Ray> rays;
+    for (const Area& area : AREAS)
+    {
+        const float margin = 20.f;
+        for (int i = 0; i < 8000; i++)
+        {
+            const Ogre::Vector3 start(area.x0 - margin + unit(rng) * (area.x1 - area.x0 + 2 * margin), unit(rng) * 30 - 5,
+                                      area.z0 - margin + unit(rng) * (area.z1 - area.z0 + 2 * margin));
+            Ogre::Vector3 dir(unit(rng) * 80 - 40, unit(rng) * 40 - 20, unit(rng) * 80 - 40);
+            if (i % 9 == 0)
+                dir = Ogre::Vector3(0.f, dir.y, 0.f);
+            else if (i % 9 == 1)
+                dir.z = 0.f;
+            else if (i % 9 == 2)
+                dir *= 50.f;
+            else if (i % 9 == 3)
+                dir = Ogre::Vector3(dir.x * 5.f, -300.f, dir.z * 5.f); // Into the bounds from far above
+            const Ogre::Vector3 origin = (i % 9 == 3) ? start + Ogre::Vector3(0.f, 250.f, 0.f) : start;
+            if (!scene.IsInsideAnyBox(origin))
+                rays.push_back(Ogre::Ray(origin, dir));
+        }
+    }
+
+    // Box hits are computed by slabs rather than faces; they agree within float precision of the coordinates
+    auto get_tolerance = [](const Ogre::Ray& ray)
+    {
+        const Ogre::Vector3 origin = ray.getOrigin();
+        const float magnitude = std::max(std::abs(origin.x), std::max(std::abs(origin.y), std::abs(origin.z)));
+        return (1e-3f + 4e-7f * magnitude) / ray.getDirection().length();
+    };
+
+    int num_hits = 0, num_box_hits = 0;
+    std::vector<collision_ray_hit_t> expected(rays.size());
+    for (size_t i = 0; i < rays.size(); i++)
+    {
+        expected[i] = scene.CastRayBruteForce(rays[i]);
+        const float tolerance = get_tolerance(rays[i]);
+
+        collision_ray_hit_t actual;
+        scene.cells->CastRay(rays[i], actual);
+        ROR_CHECK(actual.hit == expected[i].hit);
+        if (actual.hit && expected[i].hit)
+        {
+            // Triangles are tested the same way
+            ROR_CHECK_NEAR(actual.distance, expected[i].distance, tolerance);
+            if (actual.cbox_index < 0 && expected[i].cbox_index < 0)
+                ROR_CHECK(actual.distance == expected[i].distance && actual.ctri_index == expected[i].ctri_index);
+            ROR_CHECK_NEAR(actual.normal.length(), 1.f, 1e-3f);
+            ROR_CHECK(actual.normal.dotProduct(rays[i].getDirection()) <= 0.f);
+            ROR_CHECK((actual.ctri_index >= 0) != (actual.cbox_index >= 0));
+        }
+        num_hits += expected[i].hit;
+        num_box_hits += expected[i].cbox_index >= 0;
+    }
+
+    // The batch, on the thread pool, and with a level plane standing in for the terrain
+    std::vector<collision_ray_hit_t> batch(rays.size());
+    scene.cells->CastRays(rays.data(), batch.data(), rays.size(), nullptr);
+    bool batch_matches = true;
+    for (size_t i = 0; i < rays.size(); i++)
+    {
+        collision_ray_hit_t single;
+        scene.cells->CastRay(rays[i], single);
+        batch_matches = batch_matches && batch[i].hit == single.hit && batch[i].distance == single.distance &&
+            batch[i].ctri_index == single.ctri_index && batch[i].cbox_index == single.cbox_index;
+    }
+    ROR_CHECK(batch_matches);
+
+    const float PLANE_Y = 2.f;
+    auto cast_plane = [PLANE_Y](const Ogre::Ray& ray, collision_ray_hit_t& hit)
+    {
+        if (ray.getDirection().y == 0.f)
+            return;
+        const float t = (PLANE_Y - ray.getOrigin().y) / ray.getDirection().y;
+        if (t >= 0.f && t <= 1.f)
+        {
+            hit.hit = true;
+            hit.distance = t;
+            hit.normal = Ogre::Vector3::UNIT_Y;
+        }
+    };
+    scene.cells->CastRays(rays.data(), batch.data(), rays.size(), cast_plane);
+    for (size_t i = 0; i < rays.size(); i++)
+    {
+        collision_ray_hit_t plane;
+        cast_plane(rays[i], plane);
+        const float tolerance = get_tolerance(rays[i]);
+        const bool element_first = expected[i].hit && (!plane.hit || expected[i].distance < plane.distance - tolerance);
+        const bool plane_first = plane.hit && (!expected[i].hit || plane.distance < expected[i].distance - tolerance);
+        ROR_CHECK(batch[i].hit == (expected[i].hit || plane.hit));
+        if (element_first)
+            ROR_CHECK_NEAR(batch[i].distance, expected[i].distance, tolerance);
+        if (plane_first)
+            ROR_CHECK(batch[i].distance == plane.distance && batch[i].ctri_index == -1 && batch[i].cbox_index == -1);
+    }
+
+    printf("CollisionCells: %d of %d rays hit, %d of them a box\n", num_hits, (int)rays.size(), num_box_hits);
+}
+
+// ------------------------------------------------------------------------------------------------
+// TerrainHeightPages
+
+void TestHeightPagesMatchSampling()
+{
+    const int PAGE_SIZE = 17; // Heightmap samples along the page edge
+    const float WORLD_SIZE = 64.f;
+    const float OUTSIDE_HEIGHT = -3.f;
+    const int NUM_RAYS = 20000;
+    const int NUM_SAMPLES = 4000;
+
+    // Slots [-1, 1] x [-1, 0], as an `Ogre::TerrainGroup` with its origin off center; slot (1, -1) is empty
+    const Ogre::Vector3 slot_origin(10.f, 0.f, -20.f);
+    TerrainHeightPages pages;
+    pages.Setup(slot_origin, WORLD_SIZE, PAGE_SIZE, -1, -1, 3, 2);
+
+    // Heights from one function of the world position, so neighbour pages share their edges
+    auto height_fn = [](float x, float z) { return 6.f * std::sin(x * 0.11f) * std::cos(z * 0.07f) + 2.f * std::sin((x + z) * 0.5f); };
+    const float scale = WORLD_SIZE / (PAGE_SIZE - 1);
+    std::vector<std::vector<float>> height_data;
+    for (int slot_y = -1; slot_y <= 0; slot_y++)
+    {
+        for (int slot_x = -1; slot_x <= 1; slot_x++)
+        {
+            if (slot_x == 1 && slot_y == -1)
+                continue;
+            height_data.emplace_back(PAGE_SIZE * PAGE_SIZE);
+            std::vector<float>& data = height_data.back();
+            for (int row = 0; row < PAGE_SIZE; row++)
+            {
+                for (int col = 0; col < PAGE_SIZE; col++)
+                {
+                    // Columns run towards +X, rows towards -Z
+                    const float x = slot_origin.x + (slot_x - 0.5f) * WORLD_SIZE + col * scale;
+                    const float z = slot_origin.z - (slot_y - 0.5f) * WORLD_SIZE - row * scale;
+                    data[row * PAGE_SIZE + col] = (slot_x == 0 && slot_y == 0) ? 1.5f : height_fn(x, z); // One flat page
+                }
+            }
+            pages.SetPage(slot_x, slot_y, data.data());
+        }
+    }
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    const float area_x0 = slot_origin.x - 1.5f * WORLD_SIZE - 20.f;
+    const float area_z0 = slot_origin.z - 1.5f * WORLD_SIZE - 20.f;
+    const float area_size = 3.f * WORLD_SIZE + 40.f;
+
+    int num_hits = 0, num_inconsistent = 0;
+    for (int i = 0; i < NUM_RAYS; i++)
+    {
+        const Ogre::Vector3 start(area_x0 + unit(rng) * area_size, unit(rng) * 20 - 6, area_z0 + unit(rng) * area_size);
+        Ogre::Vector3 dir(unit(rng) * 100 - 50, unit(rng) * 30 - 20, unit(rng) * 100 - 50);
+        if (i % 9 == 0)
+            dir = Ogre::Vector3(0.f, dir.y, 0.f);
+        else if (i % 9 == 1)
+            dir.x = 0.f;
+        else if (i % 9 == 2)
+            dir.z = 0.f;
+        const Ogre::Ray ray(start, dir);
+        auto height_at = [&](float t) { const Ogre::Vector3 p = ray.getPoint(t); return pages.GetHeightAt(p.x, p.z, OUTSIDE_HEIGHT); };
+        auto gap_at = [&](float t) { return ray.getPoint(t).y - height_at(t); };
+
+        // First sample at or below the surface
+        float t_sampled = -1.f;
+        for (int s = 0; s <= NUM_SAMPLES; s++)
+        {
+            const float t = static_cast<float>(s) / NUM_SAMPLES;
+            if (gap_at(t) <= 0.f)
+            {
+                t_sampled = t;
+                break;
+            }
+        }
+
+        const auto result = pages.IntersectsRay(ray, OUTSIDE_HEIGHT);
+        if (!result.first)
+        {
+            ROR_CHECK(t_sampled < 0.f);
+            continue;
+        }
+        num_hits++;
+
+        // Not after the sampled hit, and on the surface: at or below it, just above it a little before.
+        // Within a cell the surface is exact; across page edges and the water bottom it steps, so the hit is checked on both sides.
+        const float STEP = 1.f / NUM_SAMPLES;
+        const float EPSILON = 2e-3f;
+        const float t = result.second;
+        ROR_CHECK(t >= 0.f && t <= 1.f);
+        ROR_CHECK(t_sampled < 0.f || t <= t_sampled + STEP);
+        const float gap_below = std::min(gap_at(t), gap_at(std::min(t + 1e-4f, 1.f)));
+        const float gap_above = (t > 1e-4f) ? std::max(gap_at(t - 1e-4f), gap_at(t)) : 0.f;
+        const bool consistent = gap_below <= EPSILON * (1.f + dir.length()) && gap_above >= -EPSILON * (1.f + dir.length());
+        ROR_CHECK(consistent);
+        num_inconsistent += !consistent;
+    }
+
+    // Heightless and flat terrains hit a level plane
+    TerrainHeightPages empty;
+    const auto level = TerrainHeightPages::IntersectsLevel(Ogre::Ray(Ogre::Vector3(0.f, 4.f, 0.f), Ogre::Vector3(1.f, -8.f, 0.f)), 0.f);
+    ROR_CHECK(level.first && level.second == 0.5f);
+    ROR_CHECK(empty.IntersectsRay(Ogre::Ray(Ogre::Vector3(0.f, 4.f, 0.f), Ogre::Vector3(1.f, -8.f, 0.f)), 0.f) == level);
+
+    printf("TerrainHeightPages: %d of %d rays hit\n", num_hits, NUM_RAYS);
+}
+
+} // namespace
+
+int main()
+{
+    TestWalkMatchesSampling();
+    TestCollisionCellsMatchBruteForce();
+    TestHeightPagesMatchSampling();
+
+    return RoR::Test::Finish("GridRayWalkTest");
+}
@@ -0,0 +1,502 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Compares Hydrax::Noise::FFT against the previous, single threaded implementation
+/// (per-bin sin/cos, bit reversal by counting, twiddles by square roots), kept below as a reference.
+/// Both are seeded the same, stepped with the same irregular frame times and sampled on the same grid.
+
+#include "FFT.h"
+#include "TestUtils.h"
+
+#include <Ogre.h>
+
+#include <complex>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+using namespace Hydrax::Noise;
+
+/// The previous implementation, trimmed to the noise computation.
+class ReferenceFFT
+{
+public:
+    ReferenceFFT(const FFT::Options& options)
+        : mOptions(options)
+        , resolution(options.Resolution)
+        , maximalValue(2)
+        , time(10)
+    {
+        initialWaves.resize(resolution*resolution);
+        currentWaves.resize(resolution*resolution);
+        angularFrequencies.resize(resolution*resolution);
+        re.resize(resolution*resolution);
+        img.resize(resolution*resolution);
+
+        Ogre::Vector2 wave = Ogre::Vector2(0,0);
+
+        std::complex<float>* pInitialWavesData = &initialWaves[0];
+        float* pAngularFrequenciesData = &angularFrequencies[0];
+
+        float u, v,
+              temp;
+
+        for (u = 0; u < resolution; u++)
+        {
+            wave.x = (-0.5f * resolution + u) * (2.0f* Ogre::Math::PI / mOptions.PhysicalResolution);
+
+            for (v = 0; v < resolution; v++)
+            {
+                wave.y = (-0.5f * resolution + v) * (2.0f* Ogre::Math::PI / mOptions.PhysicalResolution);
+
+                temp = Ogre::Math::Sqrt(0.5f * getPhillipsSpectrum(wave, mOptions.WindDirection, mOptions.KwPower));
+                *pInitialWavesData++ = std::complex<float>(getGaussianRandomFloat() * temp, getGaussianRandomFloat() * temp);
+
+                temp=9.81f * wave.length();
+                *pAngularFrequenciesData++ = Ogre::Math::Sqrt(temp);
+            }
+        }
+
+        calculeNoise(0);
+    }
+
+    void update(float delta)
+    {
+        calculeNoise(delta);
+    }
+
+    float getValue(const float &x, const float &y) const
+    {
+        // Scale world coords
+        float xScale = x*mOptions.Scale,
+              yScale = y*mOptions.Scale;
+
+        // Convert coords from world-space to data-space
+        int xs = static_cast<int>(xScale)%resolution,
+            ys = static_cast<int>(yScale)%resolution;
+
+        // If data-space coords are negative, transform it to positive
+        if (x<0) xs += resolution-1;
+        if (y<0) ys += resolution-1;
+
+        // Determine x and y diff for linear interpolation
+        int xINT = (x>0) ? static_cast<int>(xScale) : static_cast<int>(xScale-1),
+            yINT = (y>0) ? static_cast<int>(yScale) : static_cast<int>(yScale-1);
+
+        // Calculate interpolation coeficients
+        float xDIFF  = xScale-xINT,
+              yDIFF  = yScale-yINT,
+              _xDIFF = 1-xDIFF,
+              _yDIFF = 1-yDIFF;
+
+        // To adjust the index if coords are out of range
+        int xxs = (xs==resolution-1) ? -1 : xs,
+            yys = (ys==resolution-1) ? -1 : ys;
+
+        float A = re[(ys*resolution+xs)],
+              B = re[(ys*resolution+xxs+1)],
+              C = re[((yys+1)*resolution+xs)],
+              D = re[((yys+1)*resolution+xxs+1)];
+
+        return (A*_xDIFF*_yDIFF +
+                B* xDIFF*_yDIFF +
+                C*_xDIFF* yDIFF +
+                D* xDIFF* yDIFF)
+                                 *0.6f-0.3f;
+    }
+
+private:
+    static float uniformDeviate()
+    {
+        return rand() * ( 1.0f / ( RAND_MAX + 1.0f ) );
+    }
+
+    float getGaussianRandomFloat() const
+    {
+        float x1, x2, w, y1;
+
+        do
+        {
+            x1 = 2.0f * uniformDeviate() - 1.0f;
+            x2 = 2.0f * uniformDeviate() - 1.0f;
+
+            w = x1 * x1 + x2 * x2;
+
+        } while ( w >= 1.0f );
+
+        w = Ogre::Math::Sqrt( (-2.0f * Ogre::Math::Log( w ) ) / w );
+        y1 = x1 * w;
+
+        return y1;
+    }
+
+    float getPhillipsSpectrum(const Ogre::Vector2& waveVector, const Ogre::Vector2& wind, const float& kwPower_) const
+    {
+        float k = waveVector.length();
+
+        if (k < 0.0000001f)
+        {
+            return 0;
+        }
+        else
+        {
+            float windVelocity = wind.length(),
+                  l = pow(windVelocity,2.0f)/9.81f,
+                  dot=waveVector.dotProduct(wind);
+
+            return mOptions.Amplitude*
+                (Ogre::Math::Exp(-1 / pow(k * l,2)) / (Ogre::Math::Pow(k,2) *
+                 Ogre::Math::Pow(k,2))) * Ogre::Math::Pow(-dot/ (k * windVelocity), kwPower_);
+        }
+    }
+
+    void calculeNoise(const float &delta)
+    {
+        time += delta*mOptions.AnimationSpeed;
+
+        std::complex<float>* pData = &currentWaves[0];
+
+        int u, v;
+
+        float wt,
+              coswt, sinwt,
+              realVal, imagVal;
+
+        for (u = 0; u < resolution; u++)
+        {
+            for (v = 0; v< resolution ; v++)
+            {
+                const std::complex<float>& positive_h0 = initialWaves[u * (resolution)+v];
+                const std::complex<float>& negative_h0 = initialWaves[(resolution-1 - u) * (resolution) + (resolution-1- v)];
+
+                wt = angularFrequencies[u * (resolution) + v] * time;
+
+                coswt = Ogre::Math::Cos(wt);
+                sinwt = Ogre::Math::Sin(wt);
+
+                realVal =
+                    positive_h0.real() * coswt - positive_h0.imag() * sinwt + negative_h0.real() * coswt - (-negative_h0.imag()) * (-sinwt),
+                imagVal =
+                    positive_h0.real() * sinwt + positive_h0.imag() * coswt + negative_h0.real() * (-sinwt) + (-negative_h0.imag()) * coswt;
+
+                *pData++ = std::complex<float>(realVal, imagVal);
+            }
+        }
+
+        executeInverseFFT();
+        normalizeFFTData();
+    }
+
+    void executeInverseFFT()
+    {
+        int l2n = 0, p = 1;
+        while (p < resolution)
+        {
+            p *= 2; l2n++;
+        }
+        int l2m = l2n;
+
+        int x, y, i;
+
+        for(x = 0; x <resolution; x++)
+        {
+            for(y = 0; y <resolution; y++)
+            {
+                re[resolution * x + y] = currentWaves[resolution * x + y].real();
+                img[resolution * x + y] = currentWaves[resolution * x + y].imag();
+            }
+        }
+
+        //Bit reversal of each row
+        int j, k;
+        for(y = 0; y < resolution; y++) //for each row
+        {
+            j = 0;
+            for(i = 0; i < resolution - 1; i++)
+            {
+                re[resolution * i + y] = currentWaves[resolution * j + y].real();
+                img[resolution * i + y] = currentWaves[resolution * j + y].imag();
+
+                k = resolution / 2;
+                while (k <= j)
+                {
+                    j -= k;
+                    k/= 2;
+                }
+
+                j += k;
+            }
+        }
+
+        //Bit reversal of each column
+        float tx = 0, ty = 0;
+        for(x = 0; x < resolution; x++) //for each column
+        {
+            j = 0;
+            for(i = 0; i < resolution - 1; i++)
+            {
+                if(i < j)
+                {
+                    tx = re[resolution * x + i];
+                    ty = img[resolution * x + i];
+                    re[resolution * x + i] = re[resolution * x + j];
+                    img[resolution * x + i] = img[resolution * x + j];
+                    re[resolution * x + j] = tx;
+                    img[resolution * x + j] = ty;
+                }
+                k = resolution / 2;
+                while (k <= j)
+                {
+                    j -= k;
+                    k/= 2;
+                }
+                j += k;
+            }
+        }
+
+        //Calculate the FFT of the columns
+        float ca, sa,
+              u1, u2,
+              t1, t2,
+              z;
+
+        int l1, l2,
+            l,  i1;
+
+        for(x = 0; x < resolution; x++) //for each column
+        {
+            ca = -1.0;
+            sa = 0.0;
+            l1 = 1, l2 = 1;
+
+            for(l=0;l<l2n;l++)
+            {
+                l1 = l2;
+                l2 *= 2;
+                u1 = 1.0;
+                u2 = 0.0;
+                for(j = 0; j < l1; j++)
+                {
+                    for(i = j; i < resolution; i += l2)
+                    {
+                        i1 = i + l1;
+                        t1 = u1 * re[resolution * x + i1] - u2 * img[resolution * x + i1];
+                        t2 = u1 * img[resolution * x + i1] + u2 * re[resolution * x + i1];
+                        re[resolution * x + i1] = re[resolution * x + i] - t1;
+                        img[resolution * x + i1] = img[resolution * x + i] - t2;
+                        re[resolution * x + i] += t1;
+                        img[resolution * x + i] += t2;
+                    }
+                    z =  u1 * ca - u2 * sa;
+                    u2 = u1 * sa + u2 * ca;
+                    u1 = z;
+                }
+                sa = Ogre::Math::Sqrt((1.0f - ca) / 2.0f);
+                ca = Ogre::Math::Sqrt((1.0f+ca) / 2.0f);
+            }
+        }
+        //Calculate the FFT of the rows
+        for(y = 0; y < resolution; y++) //for each row
+        {
+            ca = -1.0;
+            sa = 0.0;
+            l1= 1, l2 = 1;
+
+            for(l = 0; l < l2m; l++)
+            {
+                l1 = l2;
+                l2 *= 2;
+                u1 = 1.0;
+                u2 = 0.0;
+                for(j = 0; j < l1; j++)
+                {
+                    for(i = j; i < resolution; i += l2)
+                    {
+                        i1 = i + l1;
+                        t1 = u1 * re[resolution * i1 + y] - u2 * img[resolution * i1 + y];
+                        t2 = u1 * img[resolution * i1 + y] + u2 * re[resolution* i1 + y];
+                        re[resolution * i1 + y] = re[resolution * i + y] - t1;
+                        img[resolution * i1 + y] = img[resolution * i + y] - t2;
+                        re[resolution * i + y] += t1;
+                        img[resolution * i + y] += t2;
+                    }
+                    z =  u1 * ca - u2 * sa;
+                    u2 = u1 * sa + u2 * ca;
+                    u1 = z;
+                }
+                sa = Ogre::Math::Sqrt((1.0f - ca) / 2.0f);
+                ca = Ogre::Math::Sqrt((1.0f+ca) / 2.0f);
+            }
+        }
+
+        for(x=0;x<resolution;x++)
+        {
+            for(y=0;y<resolution;y++)
+            {
+                if (((x+y) & 0x1)==0)
+                {
+                    re[x*resolution+y]*=-1;
+                }
+            }
+        }
+    }
+
+    void normalizeFFTData()
+    {
+        float scaleCoef = 0.000001f;
+        int i;
+
+        float min=re[0], max=re[0],
+              currentMax=maximalValue;
+
+        for(i=1;i<resolution*resolution;i++)
+        {
+            if (min>re[i]) min=re[i];
+            if (max<re[i]) max=re[i];
+        }
+
+        min=Ogre::Math::Abs(min);
+        max=Ogre::Math::Abs(max);
+
+        currentMax = (min>max) ? min : max;
+
+        if (currentMax>maximalValue) maximalValue=currentMax;
+
+        scaleCoef += maximalValue;
+
+        for(i=0;i<resolution*resolution;i++)
+        {
+            re[i]=(re[i]+scaleCoef)/(scaleCoef*2);
+        }
+    }
+
+    FFT::Options mOptions;
+    int resolution;
+    std::vector<float> re, img;
+    float maximalValue;
+    std::vector<std::complex<float>> initialWaves, currentWaves;
+    std::vector<float> angularFrequencies;
+    float time;
+};
+
+/// Irregular frame times, with a long hitch which makes FFT re-evaluate its phases.
+float GetFrameTime(int frame)
+{
+    if (frame == 300)
+    {
+        return 2.f;
+    }
+    const float frame_times[] = { 1.f/60, 1.f/30, 1.f/120 };
+    return frame_times[frame % 3];
+}
+
+void TestMatchesReference(int resolution)
+{
+    const int NUM_FRAMES = 600;
+    const unsigned int SEED = 1;
+
+    FFT::Options options;
+    options.Resolution = resolution;
+
+    // Both consume rand() in the same order when generating the initial waves
+    srand(SEED);
+    FFT fft;
+    fft.setOptions(options);
+    fft.create();
+
+    srand(SEED);
+    ReferenceFFT reference(options);
+
+    // Sample positions, across several tiles and on both sides of the origin
+    std::vector<Ogre::Vector2> positions;
+    for (float x = -3.f * resolution; x <= 3.f * resolution; x += 7.3f)
+    {
+        for (float y = -3.f * resolution; y <= 3.f * resolution; y += 11.9f)
+        {
+            positions.push_back(Ogre::Vector2(x, y));
+        }
+    }
+    std::vector<float> snapshot_values(positions.size());
+
+    float max_diff = 0.f;
+    double fft_ms = 0.0, reference_ms = 0.0;
+    for (int frame = 0; frame < NUM_FRAMES; frame++)
+    {
+        const float dt = GetFrameTime(frame);
+
+        RoR::Test::Stopwatch fft_watch;
+        fft.update(dt);
+        fft_ms += fft_watch.GetElapsedMs();
+
+        RoR::Test::Stopwatch reference_watch;
+        reference.update(dt);
+        reference_ms += reference_watch.GetElapsedMs();
+
+        fft.getValues(&positions[0], &snapshot_values[0], static_cast<int>(positions.size()));
+
+        for (size_t i = 0; i < positions.size(); i++)
+        {
+            const float value = fft.getValue(positions[i].x, positions[i].y);
+            max_diff = std::max(max_diff, std::fabs(value - reference.getValue(positions[i].x, positions[i].y)));
+
+            // The snapshot is published by update(), it must be the same data
+            ROR_CHECK(snapshot_values[i] == value);
+        }
+    }
+
+    // Float rounding differs (rotated phases, table twiddles), the waves must not
+    ROR_CHECK(max_diff < 1e-3f);
+
+    printf("FFT resolution %d: max |diff| %g, %.2f ms/frame (reference %.2f ms/frame)\n",
+        resolution, max_diff, fft_ms / NUM_FRAMES, reference_ms / NUM_FRAMES);
+}
+
+void TestNonPowerOfTwoResolution()
+{
+    // Rounded up to the next power of two, the old code silently wrote past its buffers
+    FFT::Options options;
+    options.Resolution = 100;
+
+    srand(1);
+    FFT fft;
+    fft.setOptions(options);
+    fft.create();
+    fft.update(1.f/60);
+
+    const float value = fft.getValue(12.3f, -45.6f);
+    ROR_CHECK(value >= -0.3f && value <= 0.3f);
+}
+
+} // namespace
+
+int main()
+{
+    Ogre::LogManager log_manager;
+    log_manager.createLog("HydraxFFTTest.log", true, false, true);
+
+    for (int resolution : { 64, 128, 256, 512 })
+    {
+        TestMatchesReference(resolution);
+    }
+    TestNonPowerOfTwoResolution();
+
+    return RoR::Test::Finish("HydraxFFTTest");
+}
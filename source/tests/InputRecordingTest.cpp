@@ -0,0 +1,261 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Checks the input snapshot and its record & playback stream (see `InputEngine::Capture()`): recordings play
+/// back frame by frame, releasing the events (as `InputEngine::resetKeys()` does) is recorded and played back,
+/// recorded events are matched by name, and broken or truncated recordings are rejected or ended cleanly.
+
+#include "InputRecording.h"
+#include "TestUtils.h"
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace RoR;
+
+namespace {
+
+const InputEventSnapshot::Plane PLANES[] = {InputEventSnapshot::PLANE_DIGITAL, InputEventSnapshot::PLANE_ANALOG, InputEventSnapshot::PLANE_ANALOG_ACTIVE};
+
+std::vector<std::string> MakeEventNames(int count)
+{
+    std::vector<std::string> names;
+    for (int i = 0; i < count; i++)
+        names.push_back("EVENT_" + std::to_string(i));
+    return names;
+}
+
+int ResolveByIndex(std::string const& name)
+{
+    return std::stoi(name.substr(6)); // "EVENT_<n>"
+}
+
+bool IsReleased(InputEventSnapshot const& snapshot)
+{
+    for (InputEventSnapshot::Plane plane: PLANES)
+    {
+        for (int i = 0; i < snapshot.GetNumEvents(); i++)
+        {
+            if (snapshot.GetValue(plane, i) != 0.f)
+                return false;
+        }
+    }
+    return true;
+}
+
+void TestClearReleasesEverything()
+{
+    InputEventSnapshot snapshot(50);
+    ROR_CHECK(IsReleased(snapshot));
+    for (InputEventSnapshot::Plane plane: PLANES)
+    {
+        snapshot.SetValue(plane, 0, 1.f);
+        snapshot.SetValue(plane, 49, 0.5f);
+    }
+    ROR_CHECK(snapshot.GetValue(InputEventSnapshot::PLANE_ANALOG, 49) == 0.5f);
+    snapshot.Clear();
+    ROR_CHECK(IsReleased(snapshot));
+    ROR_CHECK(snapshot.GetNumEvents() == 50);
+}
+
+void TestRoundTrip()
+{
+    const int NUM_EVENTS = 300;
+    const int NUM_FRAMES = 2000;
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> pick_event(0, NUM_EVENTS - 1);
+    std::uniform_int_distribution<int> pick_plane(0, InputEventSnapshot::PLANE_COUNT - 1);
+    std::uniform_real_distribution<float> pick_value(0.f, 1.f);
+    std::uniform_real_distribution<float> pick_dt(0.005f, 0.05f);
+
+    // Few changes per frame, held in between - like real input; every 100th frame is released (focus lost)
+    std::vector<InputEventSnapshot> frames;
+    std::vector<float> frame_times;
+    InputEventSnapshot snapshot(NUM_EVENTS);
+    for (int f = 0; f < NUM_FRAMES; f++)
+    {
+        if (f % 100 == 99)
+            snapshot.Clear();
+        else
+        {
+            for (int c = f % 4; c > 0; c--)
+                snapshot.SetValue(PLANES[pick_plane(rng)], pick_event(rng), (c == 1) ? 1.f : pick_value(rng));
+        }
+        frames.push_back(snapshot);
+        frame_times.push_back(pick_dt(rng));
+    }
+
+    std::stringstream stream;
+    InputRecordingWriter writer;
+    writer.Start(stream, MakeEventNames(NUM_EVENTS));
+    for (int f = 0; f < NUM_FRAMES; f++)
+        writer.WriteFrame(stream, frame_times[f], frames[f]);
+    ROR_CHECK(writer.GetNumFrames() == NUM_FRAMES);
+
+    InputRecordingReader reader;
+    ROR_CHECK(reader.Start(stream, ResolveByIndex));
+    InputEventSnapshot played(NUM_EVENTS);
+    int num_mismatches = 0;
+    for (int f = 0; f < NUM_FRAMES; f++)
+    {
+        if (reader.GetNextFrameTime() != frame_times[f])
+            num_mismatches++;
+        if (!reader.ReadFrame(stream, played) || !(played == frames[f]))
+            num_mismatches++;
+        if (f % 100 == 99 && !IsReleased(played))
+            num_mismatches++;
+    }
+    ROR_CHECK(num_mismatches == 0);
+    ROR_CHECK(!reader.ReadFrame(stream, played)); // End of the recording
+}
+
+void TestReleaseDuringRecording()
+{
+    // An event held across `InputEngine::resetKeys()`: the release must be recorded, not the stale held value
+    const int NUM_EVENTS = 10;
+    std::stringstream stream;
+    InputRecordingWriter writer;
+    writer.Start(stream, MakeEventNames(NUM_EVENTS));
+
+    InputEventSnapshot snapshot(NUM_EVENTS);
+    snapshot.SetValue(InputEventSnapshot::PLANE_DIGITAL, 3, 1.f);
+    writer.WriteFrame(stream, 0.016f, snapshot);
+    writer.WriteFrame(stream, 0.016f, snapshot);
+    snapshot.Clear();
+    writer.WriteFrame(stream, 0.016f, snapshot);
+
+    InputRecordingReader reader;
+    InputEventSnapshot played(NUM_EVENTS);
+    ROR_CHECK(reader.Start(stream, ResolveByIndex));
+    ROR_CHECK(reader.ReadFrame(stream, played));
+    ROR_CHECK(played.GetValue(InputEventSnapshot::PLANE_DIGITAL, 3) == 1.f);
+    ROR_CHECK(reader.ReadFrame(stream, played));
+    ROR_CHECK(played.GetValue(InputEventSnapshot::PLANE_DIGITAL, 3) == 1.f);
+    ROR_CHECK(reader.ReadFrame(stream, played));
+    ROR_CHECK(IsReleased(played));
+}
+
+void TestEventsMatchedByName()
+{
+    // Recorded by an older version: events 0..4. This version dropped EVENT_2 and moved the others.
+    std::stringstream stream;
+    InputRecordingWriter writer;
+    writer.Start(stream, MakeEventNames(5));
+    InputEventSnapshot snapshot(5);
+    for (int i = 0; i < 5; i++)
+        snapshot.SetValue(InputEventSnapshot::PLANE_ANALOG, i, 0.1f * (i + 1));
+    writer.WriteFrame(stream, 0.02f, snapshot);
+
+    InputRecordingReader reader;
+    ROR_CHECK(reader.Start(stream, [](std::string const& name) { return (name == "EVENT_2") ? -1 : 10 - ResolveByIndex(name); }));
+    InputEventSnapshot played(11);
+    ROR_CHECK(reader.ReadFrame(stream, played));
+    ROR_CHECK(played.GetValue(InputEventSnapshot::PLANE_ANALOG, 10) == 0.1f);
+    ROR_CHECK(played.GetValue(InputEventSnapshot::PLANE_ANALOG, 9) == 0.2f);
+    ROR_CHECK(played.GetValue(InputEventSnapshot::PLANE_ANALOG, 8) == 0.f);
+    ROR_CHECK(played.GetValue(InputEventSnapshot::PLANE_ANALOG, 6) == 0.5f);
+
+    // IDs past this version's snapshot are ignored
+    std::stringstream stream2;
+    InputRecordingWriter writer2;
+    writer2.Start(stream2, MakeEventNames(5));
+    writer2.WriteFrame(stream2, 0.02f, snapshot);
+    InputRecordingReader reader2;
+    InputEventSnapshot small(3);
+    ROR_CHECK(reader2.Start(stream2, ResolveByIndex));
+    ROR_CHECK(reader2.ReadFrame(stream2, small));
+    ROR_CHECK(small.GetValue(InputEventSnapshot::PLANE_ANALOG, 2) == 0.3f);
+}
+
+void TestBrokenRecordings()
+{
+    InputRecordingReader reader;
+
+    std::stringstream empty;
+    ROR_CHECK(!reader.Start(empty, ResolveByIndex));
+
+    std::stringstream not_a_recording("RoRInpu! this is not a recording at all");
+    ROR_CHECK(!reader.Start(not_a_recording, ResolveByIndex));
+
+    // Another format version
+    std::stringstream good;
+    InputRecordingWriter writer;
+    writer.Start(good, MakeEventNames(4));
+    InputEventSnapshot snapshot(4);
+    for (int f = 0; f < 10; f++)
+    {
+        snapshot.SetValue(InputEventSnapshot::PLANE_DIGITAL, f % 4, static_cast<float>(f % 2));
+        writer.WriteFrame(good, 0.01f, snapshot);
+    }
+    std::string bytes = good.str();
+    std::string other_version = bytes;
+    other_version[8] = 2;
+    std::stringstream other_version_stream(other_version);
+    ROR_CHECK(!reader.Start(other_version_stream, ResolveByIndex));
+
+    // Header only, no frames
+    std::stringstream header_only;
+    InputRecordingWriter header_writer;
+    header_writer.Start(header_only, MakeEventNames(4));
+    ROR_CHECK(!reader.Start(header_only, ResolveByIndex));
+
+    // Truncated in the middle of the last frame (the game crashed while recording): the frames before play back
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 3));
+    InputEventSnapshot played(4);
+    ROR_CHECK(reader.Start(truncated, ResolveByIndex));
+    int num_frames = 0;
+    while (reader.ReadFrame(truncated, played))
+        num_frames++;
+    ROR_CHECK(num_frames == 9);
+}
+
+void TestOnlyChangesAreWritten()
+{
+    const int NUM_EVENTS = 300;
+    std::stringstream stream;
+    InputRecordingWriter writer;
+    writer.Start(stream, MakeEventNames(NUM_EVENTS));
+    const size_t header_size = stream.str().size();
+
+    InputEventSnapshot snapshot(NUM_EVENTS);
+    snapshot.SetValue(InputEventSnapshot::PLANE_DIGITAL, 7, 1.f);
+    for (int f = 0; f < 1000; f++)
+        writer.WriteFrame(stream, 0.016f, snapshot);
+
+    // One change (dt + count + index + plane + value), then dt + count per idle frame
+    ROR_CHECK(stream.str().size() - header_size == (4 + 2 + 2 + 1 + 4) + 999 * (4 + 2));
+}
+
+} // namespace
+
+int main()
+{
+    TestClearReleasesEverything();
+    TestRoundTrip();
+    TestReleaseDuringRecording();
+    TestEventsMatchedByName();
+    TestBrokenRecordings();
+    TestOnlyChangesAreWritten();
+
+    return RoR::Test::Finish("InputRecordingTest");
+}
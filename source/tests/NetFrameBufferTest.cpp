@@ -0,0 +1,370 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Drives NetFrameBuffer, the jitter buffer of remote actors, with synthetic streams laid out like
+/// `Actor::sendStreamData()`: packet loss, reordering, duplicates, bursts after a stall and a stream which stops.
+/// The playout mirrors `Actor::calcNetwork()` with a fixed delay.
+
+#include "NetFrameBuffer.h"
+#include "TestUtils.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Ogre;
+using namespace RoR;
+
+namespace {
+
+const int   NUM_NODES = 8;          //!< Corners of a 4 m box
+const int   NUM_WHEELS = 2;
+const float NODE_COMPRESSION = 32767.f / 6.f; // Like `ActorManager`, for a 4 m actor
+const int   SEND_INTERVAL_MS = 100;
+const int   PLAYOUT_DELAY_MS = 250;
+const int   FRAME_MS = 16;
+
+/// A remote actor going around a circle, or along a straight line when `turn_radius` is 0
+struct RemoteActor
+{
+    float speed = 20.f;
+    float turn_radius = 50.f;
+
+    Vector3 GetNodePosition(int node, int time) const
+    {
+        const float t = time / 1000.f;
+        Vector3 center;
+        float heading = 0.f;
+        if (turn_radius > 0.f)
+        {
+            heading = speed * t / turn_radius;
+            center = Vector3(turn_radius * std::sin(heading), 0.f, turn_radius * (1.f - std::cos(heading)));
+        }
+        else
+        {
+            center = Vector3(speed * t, 0.f, 0.f);
+        }
+        const Vector3 corner((node & 1) ? 2.f : -2.f, (node & 2) ? 1.f : 0.f, (node & 4) ? 1.f : -1.f);
+        const Vector3 forward(std::cos(heading), 0.f, std::sin(heading));
+        const Vector3 side(-std::sin(heading), 0.f, std::cos(heading));
+        return center + forward * corner.x + Vector3::UNIT_Y * corner.y + side * corner.z;
+    }
+
+    float GetWheelRotation(int wheel, int time) const
+    {
+        return (wheel + 1) * speed * time / 1000.f / 0.4f;
+    }
+};
+
+/// One packet as `Actor::sendStreamData()` lays it out: the first node in full, others as shorts relative to it, then wheels
+struct Packet
+{
+    RoRnet::VehicleState  state;
+    std::vector<char>     node_data;
+    std::vector<char>     wheel_data;
+};
+
+Packet MakePacket(RemoteActor const& actor, int time)
+{
+    Packet packet;
+    memset(&packet.state, 0, sizeof(packet.state));
+    packet.state.time = time;
+    packet.state.engine_gear = time / 1000;
+
+    const Vector3 refpos = actor.GetNodePosition(0, time);
+    const float ref[3] = {refpos.x, refpos.y, refpos.z};
+    packet.node_data.resize(sizeof(ref) + (NUM_NODES - 1) * 3 * sizeof(short int));
+    memcpy(packet.node_data.data(), ref, sizeof(ref));
+    for (int i = 1; i < NUM_NODES; i++)
+    {
+        const Vector3 relpos = actor.GetNodePosition(i, time) - refpos;
+        const short int rel[3] = {
+            (short int)(relpos.x * NODE_COMPRESSION), (short int)(relpos.y * NODE_COMPRESSION), (short int)(relpos.z * NODE_COMPRESSION) };
+        memcpy(packet.node_data.data() + sizeof(ref) + (i - 1) * sizeof(rel), rel, sizeof(rel));
+    }
+
+    float wheels[NUM_WHEELS];
+    for (int i = 0; i < NUM_WHEELS; i++)
+        wheels[i] = actor.GetWheelRotation(i, time);
+    packet.wheel_data.assign((const char*)wheels, (const char*)wheels + sizeof(wheels));
+    return packet;
+}
+
+bool Push(NetFrameBuffer& buffer, Packet const& packet)
+{
+    return buffer.Push(packet.state, packet.node_data.data(), packet.wheel_data.data());
+}
+
+/// Playout like `Actor::calcNetwork()`, with a fixed delay instead of the adaptive clock offset
+struct Playout
+{
+    Vector3    node_pos[NUM_NODES];
+    Vector3    node_vel[NUM_NODES];
+    float      wheel_rp[NUM_WHEELS];
+    NetSample  sample;
+
+    void Update(NetFrameBuffer& buffer, int remote_time)
+    {
+        sample = buffer.Sample(remote_time, node_pos, node_vel, wheel_rp);
+        buffer.PopFront(sample.ns_frames_before);
+    }
+
+    float GetMaxError(RemoteActor const& actor, int remote_time) const
+    {
+        float error = 0.f;
+        for (int i = 0; i < NUM_NODES; i++)
+            error = std::max(error, node_pos[i].distance(actor.GetNodePosition(i, remote_time)));
+        return error;
+    }
+
+    /// What the former linear interpolation gave for the same window
+    float GetMaxLinearError(NetFrameBuffer const& buffer, RemoteActor const& actor, int remote_time) const
+    {
+        NetFrame const& f1 = buffer.GetFrame(0);
+        NetFrame const& f2 = buffer.GetFrame(1);
+        float error = 0.f;
+        for (int i = 0; i < NUM_NODES; i++)
+        {
+            const Vector3 linear = f1.nf_node_pos[i] + (f2.nf_node_pos[i] - f1.nf_node_pos[i]) * sample.ns_tratio;
+            error = std::max(error, linear.distance(actor.GetNodePosition(i, remote_time)));
+        }
+        return error;
+    }
+};
+
+NetFrameBuffer MakeBuffer()
+{
+    NetFrameBuffer buffer;
+    buffer.Init(NUM_NODES, NUM_WHEELS, NODE_COMPRESSION);
+    return buffer;
+}
+
+void TestDecode()
+{
+    RemoteActor actor;
+    NetFrameBuffer buffer = MakeBuffer();
+    Playout playout;
+
+    ROR_CHECK(Push(buffer, MakePacket(actor, 1000)));
+    playout.Update(buffer, 1000);
+    ROR_CHECK(playout.sample.ns_mode == NetSample::NO_DATA);
+
+    ROR_CHECK(Push(buffer, MakePacket(actor, 1100)));
+    for (int time : {1000, 1100})
+    {
+        playout.Update(buffer, time);
+        ROR_CHECK(playout.sample.ns_mode == NetSample::INTERPOLATED);
+        ROR_CHECK(playout.GetMaxError(actor, time) < 1e-3f);
+        ROR_CHECK_NEAR(playout.wheel_rp[1], actor.GetWheelRotation(1, time), 1e-3f);
+    }
+    ROR_CHECK(playout.sample.ns_state2->engine_gear == 1);
+    ROR_CHECK_NEAR(playout.sample.ns_tratio, 1.f, 1e-6f);
+}
+
+void TestDuplicatesAndReordering()
+{
+    RemoteActor actor;
+    NetFrameBuffer buffer = MakeBuffer();
+
+    ROR_CHECK(Push(buffer, MakePacket(actor, 0)));
+    ROR_CHECK(Push(buffer, MakePacket(actor, 100)));
+    ROR_CHECK(Push(buffer, MakePacket(actor, 200)));
+    ROR_CHECK(!Push(buffer, MakePacket(actor, 200))); // Duplicate
+    ROR_CHECK(!Push(buffer, MakePacket(actor, 150))); // Late
+    ROR_CHECK(buffer.GetNumFrames() == 3);
+
+    // A stream where every 5th packet overtakes its predecessor: the overtaken ones are dropped, nothing jumps
+    buffer = MakeBuffer();
+    Playout playout;
+    std::mt19937 rng(74);
+    int next_send = 0;
+    int num_dropped = 0;
+    float max_error = 0.f;
+    for (int now = 0; now < 20000; now += FRAME_MS)
+    {
+        while (next_send + PLAYOUT_DELAY_MS / 2 <= now)
+        {
+            if (rng() % 5 == 0)
+            {
+                ROR_CHECK(Push(buffer, MakePacket(actor, next_send + SEND_INTERVAL_MS)));
+                num_dropped += !Push(buffer, MakePacket(actor, next_send));
+                next_send += SEND_INTERVAL_MS;
+            }
+            else
+            {
+                ROR_CHECK(Push(buffer, MakePacket(actor, next_send)));
+            }
+            next_send += SEND_INTERVAL_MS;
+        }
+
+        for (int i = 1; i < buffer.GetNumFrames(); i++)
+            ROR_CHECK(buffer.GetFrame(i - 1).nf_state.time < buffer.GetFrame(i).nf_state.time);
+
+        playout.Update(buffer, now - PLAYOUT_DELAY_MS);
+        if (now >= PLAYOUT_DELAY_MS + SEND_INTERVAL_MS)
+        {
+            ROR_CHECK(playout.sample.ns_mode == NetSample::INTERPOLATED);
+            max_error = std::max(max_error, playout.GetMaxError(actor, now - PLAYOUT_DELAY_MS));
+        }
+    }
+
+    printf("Reordering: %d late packets dropped, max error %.1f mm\n", num_dropped, max_error * 1000.f);
+    ROR_CHECK(num_dropped > 20);
+    ROR_CHECK(max_error < 0.05f);
+}
+
+void TestLoss()
+{
+    RemoteActor actor;
+    NetFrameBuffer buffer = MakeBuffer();
+    Playout playout;
+    std::mt19937 rng(174);
+
+    // 30% loss, and 5 packets in a row lost every 5 s
+    float max_error = 0.f;
+    float max_linear_error = 0.f;
+    float max_vel_error = 0.f;
+    int next_send = 0;
+    for (int now = 0; now < 30000; now += FRAME_MS)
+    {
+        while (next_send + PLAYOUT_DELAY_MS / 2 <= now)
+        {
+            const bool lost = (next_send % 5000 >= 2000 && next_send % 5000 < 2500) || (rng() % 10 < 3);
+            if (!lost || next_send == 0)
+                Push(buffer, MakePacket(actor, next_send));
+            next_send += SEND_INTERVAL_MS;
+        }
+
+        const int remote_time = now - PLAYOUT_DELAY_MS;
+        playout.Update(buffer, remote_time);
+        if (remote_time < 1000 || playout.sample.ns_mode != NetSample::INTERPOLATED)
+            continue;
+
+        max_error = std::max(max_error, playout.GetMaxError(actor, remote_time));
+        max_linear_error = std::max(max_linear_error, playout.GetMaxLinearError(buffer, actor, remote_time));
+        const Vector3 true_vel = (actor.GetNodePosition(0, remote_time + 1) - actor.GetNodePosition(0, remote_time - 1)) * 500.f;
+        max_vel_error = std::max(max_vel_error, playout.node_vel[0].distance(true_vel));
+    }
+
+    // A 600 ms gap on a 50 m turn: the chord is off by 36 cm, the spline by a few
+    printf("Loss: max error %.1f mm, linear interpolation %.1f mm, max velocity error %.2f m/s\n",
+        max_error * 1000.f, max_linear_error * 1000.f, max_vel_error);
+    ROR_CHECK(max_linear_error > 0.2f);
+    ROR_CHECK(max_error < max_linear_error * 0.25f);
+    ROR_CHECK(max_vel_error < 0.2f * actor.speed);
+}
+
+void TestBurstAfterStall()
+{
+    RemoteActor actor;
+    NetFrameBuffer buffer = MakeBuffer();
+    Playout playout;
+
+    // Packets stall for 400 ms, then all arrive at once
+    int next_send = 0;
+    float max_step = 0.f;
+    Vector3 prev_pos = Vector3::ZERO;
+    bool extrapolated = false;
+    for (int now = 0; now < 10000; now += FRAME_MS)
+    {
+        const bool stalled = (now >= 4000 && now < 4400);
+        while (!stalled && next_send + PLAYOUT_DELAY_MS / 2 <= now)
+        {
+            Push(buffer, MakePacket(actor, next_send));
+            next_send += SEND_INTERVAL_MS;
+        }
+
+        playout.Update(buffer, now - PLAYOUT_DELAY_MS);
+        extrapolated = extrapolated || (playout.sample.ns_mode == NetSample::EXTRAPOLATED);
+        if (now >= 1000)
+            max_step = std::max(max_step, playout.node_pos[0].distance(prev_pos));
+        prev_pos = playout.node_pos[0];
+    }
+
+    // The actor is dead-reckoned through the stall and merges back without snapping
+    const float frame_travel = actor.speed * FRAME_MS / 1000.f;
+    printf("Burst: max travel per frame %.2f m, %.2f m without the stall\n", max_step, frame_travel);
+    ROR_CHECK(extrapolated);
+    ROR_CHECK(max_step < frame_travel * 2.f);
+
+    // A burst larger than the ring keeps the newest frames
+    buffer = MakeBuffer();
+    for (int i = 0; i < NetFrameBuffer::CAPACITY + 8; i++)
+        ROR_CHECK(Push(buffer, MakePacket(actor, i * SEND_INTERVAL_MS)));
+    ROR_CHECK(buffer.GetNumFrames() == NetFrameBuffer::CAPACITY);
+    ROR_CHECK(buffer.GetFrame(0).nf_state.time == 8 * SEND_INTERVAL_MS);
+    ROR_CHECK(buffer.GetFrame(NetFrameBuffer::CAPACITY - 1).nf_state.time == (NetFrameBuffer::CAPACITY + 7) * SEND_INTERVAL_MS);
+}
+
+void TestExtrapolation()
+{
+    RemoteActor actor;
+    actor.turn_radius = 0.f; // Straight, so dead reckoning is exact
+    NetFrameBuffer buffer = MakeBuffer();
+    Playout playout;
+
+    const int last = 2000;
+    for (int time = 0; time <= last; time += SEND_INTERVAL_MS)
+        Push(buffer, MakePacket(actor, time));
+
+    for (int past = FRAME_MS; past <= NetFrameBuffer::MAX_EXTRAPOLATION_MS; past += FRAME_MS)
+    {
+        playout.Update(buffer, last + past);
+        ROR_CHECK(playout.sample.ns_mode == NetSample::EXTRAPOLATED);
+        ROR_CHECK(playout.GetMaxError(actor, last + past) < 1e-2f);
+        ROR_CHECK(playout.node_vel[0].distance(Vector3(actor.speed, 0.f, 0.f)) < 1e-2f);
+        ROR_CHECK_NEAR(playout.wheel_rp[0], actor.GetWheelRotation(0, last + past), 1e-2f);
+    }
+
+    // Then held where the extrapolation ended, at rest
+    const int limit = last + NetFrameBuffer::MAX_EXTRAPOLATION_MS;
+    for (int time : {limit + 1, limit + 1000, limit + 5000})
+    {
+        playout.Update(buffer, time);
+        ROR_CHECK(playout.sample.ns_mode == NetSample::HELD);
+        ROR_CHECK(playout.GetMaxError(actor, limit) < 1e-2f);
+        ROR_CHECK(playout.node_vel[0] == Vector3::ZERO);
+    }
+
+    // A gap over `MAX_FRAME_GAP_MS` restarts the stream
+    const int resume = last + NetFrameBuffer::MAX_FRAME_GAP_MS + 500;
+    ROR_CHECK(Push(buffer, MakePacket(actor, resume)));
+    ROR_CHECK(buffer.GetNumFrames() == 1);
+    ROR_CHECK(buffer.GetFrame(0).nf_vel_dt == 0.f);
+    playout.Update(buffer, resume);
+    ROR_CHECK(playout.sample.ns_mode == NetSample::NO_DATA);
+    ROR_CHECK(Push(buffer, MakePacket(actor, resume + SEND_INTERVAL_MS)));
+    playout.Update(buffer, resume + SEND_INTERVAL_MS / 2);
+    ROR_CHECK(playout.sample.ns_mode == NetSample::INTERPOLATED);
+    ROR_CHECK(playout.GetMaxError(actor, resume + SEND_INTERVAL_MS / 2) < 1e-2f);
+}
+
+} // namespace
+
+int main()
+{
+    TestDecode();
+    TestDuplicatesAndReordering();
+    TestLoss();
+    TestBurstAfterStall();
+    TestExtrapolation();
+
+    return RoR::Test::Finish("NetFrameBufferTest");
+}
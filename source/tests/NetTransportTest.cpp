@@ -0,0 +1,533 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Headless multiplayer over LoopbackTransport and NetLinkSimulator: message framing, timeouts and shutdown,
+/// simulated latency, jitter, bandwidth and reordering, and a relay server with 24 peers exchanging stream data.
+/// Messages go through the transports the way `Network::SendNetMessage()` and `Network::ReceiveMessage()` do.
+
+#include "NetLinkSimulator.h"
+#include "NetTransport.h"
+#include "RoRnet.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace RoR;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const Clock::time_point EPOCH = Clock::now();
+
+/// Payload of the test messages; filler bytes follow, derived from the source and sequence number
+struct Stamp
+{
+    int32_t   st_seq;
+    int64_t   st_send_us;  //!< Since `EPOCH`
+};
+
+int64_t GetTimeUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - EPOCH).count();
+}
+
+char GetFiller(int source, int seq, size_t pos)
+{
+    return char(source * 31 + seq * 7 + pos);
+}
+
+/// One `Send()` per message, like `Network::SendNetMessage()`
+bool SendTestMessage(NetTransport& transport, int command, int source, int seq, size_t payload_size)
+{
+    RoRnet::Header head;
+    std::memset(&head, 0, sizeof(head));
+    head.command = command;
+    head.source = source;
+    head.streamid = 10;
+    head.size = (uint32_t)payload_size;
+
+    Stamp stamp;
+    stamp.st_seq = seq;
+    stamp.st_send_us = GetTimeUs();
+
+    std::vector<char> buffer(sizeof(head) + payload_size);
+    std::memcpy(buffer.data(), &head, sizeof(head));
+    std::memcpy(buffer.data() + sizeof(head), &stamp, sizeof(stamp));
+    for (size_t i = sizeof(stamp); i < payload_size; i++)
+        buffer[sizeof(head) + i] = GetFiller(source, seq, i);
+
+    std::string error;
+    return transport.Send(buffer.data(), (int)buffer.size(), error);
+}
+
+struct ReceivedMessage
+{
+    RoRnet::Header     head;
+    Stamp              stamp;
+    int64_t            recv_us = 0;
+    bool               intact = false;  //!< Filler matches the header
+};
+
+/// Header first, then the payload, like `Network::ReceiveMessage()`
+bool ReceiveTestMessage(NetTransport& transport, ReceivedMessage& out_msg)
+{
+    std::string error;
+    if (!transport.Receive((char*)&out_msg.head, sizeof(RoRnet::Header), error))
+        return false;
+    if (out_msg.head.size < sizeof(Stamp) || out_msg.head.size > RORNET_MAX_MESSAGE_LENGTH)
+        return false;
+
+    std::vector<char> payload(out_msg.head.size);
+    if (!transport.Receive(payload.data(), (int)payload.size(), error))
+        return false;
+
+    out_msg.recv_us = GetTimeUs();
+    std::memcpy(&out_msg.stamp, payload.data(), sizeof(Stamp));
+    out_msg.intact = true;
+    for (size_t i = sizeof(Stamp); i < payload.size(); i++)
+        out_msg.intact = out_msg.intact && (payload[i] == GetFiller(out_msg.head.source, out_msg.stamp.st_seq, i));
+    return true;
+}
+
+/// Receives on another thread until the transport fails
+struct Receiver
+{
+    explicit Receiver(NetTransport& transport)
+        : thread([this, &transport]()
+        {
+            ReceivedMessage msg;
+            while (ReceiveTestMessage(transport, msg))
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                messages.push_back(msg);
+            }
+        })
+    {}
+
+    ~Receiver() { if (thread.joinable()) thread.join(); }
+
+    size_t GetNumReceived()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return messages.size();
+    }
+
+    bool WaitFor(size_t num_messages, int timeout_ms)
+    {
+        const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (this->GetNumReceived() < num_messages && Clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return this->GetNumReceived() >= num_messages;
+    }
+
+    std::mutex                    mutex;
+    std::vector<ReceivedMessage>  messages;
+    std::thread                   thread;
+};
+
+std::unique_ptr<NetLinkSimulator> MakeLink(std::unique_ptr<LoopbackTransport> inner, NetLinkParams const& params)
+{
+    std::unique_ptr<NetLinkSimulator> link(new NetLinkSimulator(std::move(inner), params));
+    std::string error;
+    ROR_CHECK(link->Connect("localhost", 12000, error));
+    return link;
+}
+
+double GetPercentile(std::vector<double> values, double fraction)
+{
+    std::sort(values.begin(), values.end());
+    return values.empty() ? 0.0 : values[std::min(values.size() - 1, size_t(fraction * values.size()))];
+}
+
+void TestLoopbackFraming()
+{
+    std::unique_ptr<LoopbackTransport> a, b;
+    LoopbackTransport::CreatePair(a, b);
+    std::string error;
+    ROR_CHECK(a->Connect("localhost", 12000, error));
+
+    // Enough traffic to compact the pipe many times over
+    const int NUM_MESSAGES = 20000;
+    Test::Stopwatch stopwatch;
+    size_t num_bytes = 0;
+    std::thread sender([&a]()
+    {
+        for (int i = 0; i < NUM_MESSAGES; i++)
+            SendTestMessage(*a, RoRnet::MSG2_STREAM_DATA, 1, i, sizeof(Stamp) + (i * 37) % 1000);
+    });
+
+    int num_bad = 0;
+    ReceivedMessage msg;
+    for (int i = 0; i < NUM_MESSAGES; i++)
+    {
+        if (!ROR_CHECK(ReceiveTestMessage(*b, msg)))
+            break;
+        num_bad += !msg.intact || msg.stamp.st_seq != i || msg.head.size != sizeof(Stamp) + (i * 37) % 1000;
+        num_bytes += sizeof(RoRnet::Header) + msg.head.size;
+    }
+    sender.join();
+
+    printf("Loopback: %d messages, %.1f MB in %.1f ms\n", NUM_MESSAGES, num_bytes / 1e6, stopwatch.GetElapsedMs());
+    ROR_CHECK(num_bad == 0);
+}
+
+void TestLoopbackTimeoutAndClose()
+{
+    std::unique_ptr<LoopbackTransport> a, b;
+    LoopbackTransport::CreatePair(a, b);
+    std::string error;
+    char byte = 0;
+
+    b->SetTimeout(0, 100000);
+    Test::Stopwatch stopwatch;
+    ROR_CHECK(!b->Receive(&byte, 1, error));
+    ROR_CHECK(stopwatch.GetElapsedMs() >= 90.0);
+
+    // A timeout set while waiting forever wakes the waiter up, like `Network::Disconnect()` needs
+    b->SetTimeout(0, 0);
+    Test::Stopwatch wait_stopwatch;
+    bool received = true;
+    std::thread waiter([&]() { std::string e; received = b->Receive(&byte, 1, e); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    b->SetTimeout(0, 50000);
+    waiter.join();
+    ROR_CHECK(!received);
+    ROR_CHECK(wait_stopwatch.GetElapsedMs() < 1000.0);
+
+    // Data sent before the disconnect is still received, then the pipe reports closed
+    ROR_CHECK(SendTestMessage(*a, RoRnet::MSG2_STREAM_DATA, 1, 0, 100));
+    a->Disconnect();
+    ReceivedMessage msg;
+    ROR_CHECK(ReceiveTestMessage(*b, msg) && msg.intact);
+    b->SetTimeout(0, 0);
+    ROR_CHECK(!ReceiveTestMessage(*b, msg));
+    ROR_CHECK(!a->Send(&byte, 1, error));
+    ROR_CHECK(!b->Connect("localhost", 12000, error));
+}
+
+void TestLinkLatency()
+{
+    std::unique_ptr<LoopbackTransport> a, b;
+    LoopbackTransport::CreatePair(a, b);
+    NetLinkParams params;
+    params.nlp_latency_ms = 40;
+    params.nlp_jitter_ms = 20;
+    params.nlp_seed = 1;
+    std::unique_ptr<NetLinkSimulator> link = MakeLink(std::move(a), params);
+
+    const int NUM_MESSAGES = 100;
+    Receiver receiver(*b);
+    for (int i = 0; i < NUM_MESSAGES; i++)
+    {
+        ROR_CHECK(SendTestMessage(*link, RoRnet::MSG2_STREAM_DATA, 1, i, 200));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ROR_CHECK(receiver.WaitFor(NUM_MESSAGES, 2000));
+    link->Close();
+    b->Close();
+    receiver.thread.join();
+
+    std::vector<double> delays;
+    int num_overtaken = 0;
+    for (size_t i = 0; i < receiver.messages.size(); i++)
+    {
+        ReceivedMessage const& msg = receiver.messages[i];
+        ROR_CHECK(msg.intact);
+        delays.push_back((msg.recv_us - msg.stamp.st_send_us) / 1000.0);
+        num_overtaken += (i > 0 && msg.stamp.st_seq < receiver.messages[i - 1].stamp.st_seq);
+    }
+
+    // Jitter of 20 ms on messages 5 ms apart lets some overtake others; the framing survives that
+    printf("Latency 40 ms + jitter 20 ms: delay min %.1f / median %.1f / max %.1f ms, %d overtaken\n",
+        GetPercentile(delays, 0.0), GetPercentile(delays, 0.5), GetPercentile(delays, 1.0), num_overtaken);
+    ROR_CHECK(GetPercentile(delays, 0.0) >= 39.0);
+    ROR_CHECK(GetPercentile(delays, 0.5) < 70.0);
+    ROR_CHECK(num_overtaken > 0);
+}
+
+void TestLinkBandwidth()
+{
+    std::unique_ptr<LoopbackTransport> a, b;
+    LoopbackTransport::CreatePair(a, b);
+    NetLinkParams params;
+    params.nlp_bandwidth = 100000;
+    std::unique_ptr<NetLinkSimulator> link = MakeLink(std::move(a), params);
+
+    // 20 KB at 100 KB/s take 200 ms; they arrive one after another, in order
+    const int NUM_MESSAGES = 20;
+    const int MESSAGE_SIZE = 1000;
+    Receiver receiver(*b);
+    const int64_t start_us = GetTimeUs();
+    for (int i = 0; i < NUM_MESSAGES; i++)
+        ROR_CHECK(SendTestMessage(*link, RoRnet::MSG2_STREAM_DATA, 1, i, MESSAGE_SIZE - sizeof(RoRnet::Header)));
+    ROR_CHECK(receiver.WaitFor(NUM_MESSAGES, 2000));
+    link->Close();
+    b->Close();
+    receiver.thread.join();
+
+    bool in_order = true;
+    for (int i = 0; i < (int)receiver.messages.size(); i++)
+        in_order = in_order && receiver.messages[i].stamp.st_seq == i;
+    const double first_ms = (receiver.messages.front().recv_us - start_us) / 1000.0;
+    const double last_ms = (receiver.messages.back().recv_us - start_us) / 1000.0;
+
+    printf("Bandwidth 100 KB/s: 20 KB burst, first message after %.1f ms, last after %.1f ms\n", first_ms, last_ms);
+    ROR_CHECK(in_order);
+    ROR_CHECK(first_ms >= 9.0);
+    ROR_CHECK(last_ms >= 199.0 && last_ms < 400.0);
+}
+
+std::vector<int> GetReorderedSequence(uint32_t seed, int& out_num_held)
+{
+    std::unique_ptr<LoopbackTransport> a, b;
+    LoopbackTransport::CreatePair(a, b);
+    NetLinkParams params;
+    params.nlp_reorder_chance = 0.25f;
+    params.nlp_reorder_delay_ms = 100;
+    params.nlp_seed = seed;
+    std::unique_ptr<NetLinkSimulator> link = MakeLink(std::move(a), params);
+
+    // Sent as one burst, so the held back messages always arrive after all others, whatever the scheduling
+    const int NUM_MESSAGES = 200;
+    Receiver receiver(*b);
+    for (int i = 0; i < NUM_MESSAGES; i++)
+        SendTestMessage(*link, RoRnet::MSG2_STREAM_DATA, 1, i, 100);
+    ROR_CHECK(receiver.WaitFor(NUM_MESSAGES, 2000));
+    link->Close();
+    b->Close();
+    receiver.thread.join();
+
+    std::vector<int> sequence;
+    out_num_held = 0;
+    for (ReceivedMessage const& msg: receiver.messages)
+    {
+        sequence.push_back(msg.stamp.st_seq);
+        out_num_held += (msg.recv_us - msg.stamp.st_send_us >= 99000);
+    }
+    return sequence;
+}
+
+void TestLinkReorderIsSeeded()
+{
+    int num_held_a = 0, num_held_b = 0, num_held_c = 0;
+    const std::vector<int> sequence_a = GetReorderedSequence(7, num_held_a);
+    const std::vector<int> sequence_b = GetReorderedSequence(7, num_held_b);
+    const std::vector<int> sequence_c = GetReorderedSequence(8, num_held_c);
+
+    printf("Reordering 25%%: %d / %d / %d of 200 messages held back\n", num_held_a, num_held_b, num_held_c);
+    ROR_CHECK(sequence_a.size() == 200);
+    ROR_CHECK(sequence_a == sequence_b);
+    ROR_CHECK(sequence_a != sequence_c);
+    ROR_CHECK(num_held_a == num_held_b);
+    ROR_CHECK(num_held_a > 25 && num_held_a < 75);
+}
+
+void TestLinkShutdown()
+{
+    NetLinkParams params;
+    params.nlp_latency_ms = 200;
+    const int NUM_MESSAGES = 10;
+
+    // `Disconnect()` delivers what's pending
+    {
+        std::unique_ptr<LoopbackTransport> a, b;
+        LoopbackTransport::CreatePair(a, b);
+        std::unique_ptr<NetLinkSimulator> link = MakeLink(std::move(a), params);
+        Receiver receiver(*b);
+        for (int i = 0; i < NUM_MESSAGES; i++)
+            SendTestMessage(*link, RoRnet::MSG2_STREAM_DATA, 1, i, 100);
+        ROR_CHECK(link->GetNumPending() == NUM_MESSAGES);
+        link->Disconnect();
+        receiver.thread.join();
+        ROR_CHECK(receiver.messages.size() == NUM_MESSAGES);
+    }
+
+    // `Close()` drops it
+    {
+        std::unique_ptr<LoopbackTransport> a, b;
+        LoopbackTransport::CreatePair(a, b);
+        std::unique_ptr<NetLinkSimulator> link = MakeLink(std::move(a), params);
+        Receiver receiver(*b);
+        for (int i = 0; i < NUM_MESSAGES; i++)
+            SendTestMessage(*link, RoRnet::MSG2_STREAM_DATA, 1, i, 100);
+        link->Close();
+        receiver.thread.join();
+        ROR_CHECK(link->GetNumPending() == 0);
+        ROR_CHECK(receiver.messages.empty());
+
+        std::string error;
+        ROR_CHECK(!link->Send("x", 1, error));
+    }
+}
+
+/// A RoRnet server in miniature: each peer's messages are relayed to all other peers
+struct RelayServer
+{
+    void Start()
+    {
+        for (size_t i = 0; i < peers.size(); i++)
+        {
+            threads.emplace_back([this, i]()
+            {
+                ReceivedMessage msg;
+                std::string error;
+                std::vector<char> buffer;
+                while (ReceiveTestMessage(*peers[i], msg))
+                {
+                    // Re-serialize with the original stamp, so the receiving peer measures the end to end delay
+                    buffer.resize(sizeof(RoRnet::Header) + msg.head.size);
+                    std::memcpy(buffer.data(), &msg.head, sizeof(RoRnet::Header));
+                    std::memcpy(buffer.data() + sizeof(RoRnet::Header), &msg.stamp, sizeof(Stamp));
+                    for (size_t k = sizeof(Stamp); k < msg.head.size; k++)
+                        buffer[sizeof(RoRnet::Header) + k] = GetFiller(msg.head.source, msg.stamp.st_seq, k);
+
+                    for (size_t j = 0; j < peers.size(); j++)
+                    {
+                        if (j != i)
+                            peers[j]->Send(buffer.data(), (int)buffer.size(), error);
+                    }
+                }
+            });
+        }
+    }
+
+    void Stop()
+    {
+        for (auto& peer: peers)
+            peer->Close();
+        for (std::thread& thread: threads)
+            thread.join();
+    }
+
+    std::vector<std::unique_ptr<NetLinkSimulator>> peers;
+    std::vector<std::thread>                       threads;
+};
+
+void TestRelayServer()
+{
+    // 24 peers on a mediocre connection each send 10 stream updates per second, like `Actor::sendStreamData()`;
+    // the server relays them, so each peer receives 23 streams over a link limited to 1 Mbit/s
+    const int NUM_PEERS = 24;
+    const int NUM_ROUNDS = 10;
+    const int SEND_INTERVAL_MS = 100;
+    const int PAYLOAD_SIZE = 400;
+
+    NetLinkParams params;
+    params.nlp_latency_ms = 30;
+    params.nlp_jitter_ms = 10;
+    params.nlp_bandwidth = 128000;
+    params.nlp_reorder_chance = 0.05f;
+    params.nlp_reorder_delay_ms = 150;
+
+    RelayServer server;
+    std::vector<std::unique_ptr<NetLinkSimulator>> clients;
+    for (int i = 0; i < NUM_PEERS; i++)
+    {
+        std::unique_ptr<LoopbackTransport> client_end, server_end;
+        LoopbackTransport::CreatePair(client_end, server_end);
+        params.nlp_seed = i;
+        clients.push_back(MakeLink(std::move(client_end), params));
+        params.nlp_seed = 1000 + i;
+        server.peers.push_back(MakeLink(std::move(server_end), params));
+    }
+
+    std::vector<std::unique_ptr<Receiver>> receivers;
+    for (auto& client: clients)
+        receivers.emplace_back(new Receiver(*client));
+    server.Start();
+
+    // Peers send at different phases of the interval, like real clients do
+    Test::Stopwatch stopwatch;
+    const Clock::time_point start = Clock::now();
+    for (int round = 0; round < NUM_ROUNDS; round++)
+    {
+        for (int i = 0; i < NUM_PEERS; i++)
+        {
+            std::this_thread::sleep_until(start + std::chrono::microseconds((round * NUM_PEERS + i) * SEND_INTERVAL_MS * 1000 / NUM_PEERS));
+            ROR_CHECK(SendTestMessage(*clients[i], RoRnet::MSG2_STREAM_DATA, i + 1, round, PAYLOAD_SIZE));
+        }
+    }
+
+    const size_t num_expected = (NUM_PEERS - 1) * NUM_ROUNDS;
+    bool all_received = true;
+    for (auto& receiver: receivers)
+        all_received = receiver->WaitFor(num_expected, 3000) && all_received;
+    const double elapsed_ms = stopwatch.GetElapsedMs();
+
+    for (auto& client: clients)
+        client->Close();
+    server.Stop();
+
+    std::vector<double> delays;
+    int num_bad = 0;
+    int num_overtaken = 0;
+    for (int i = 0; i < NUM_PEERS; i++)
+    {
+        receivers[i]->thread.join();
+        std::vector<int> num_per_source(NUM_PEERS + 1, 0);
+        std::vector<int> last_seq(NUM_PEERS + 1, -1);
+        for (ReceivedMessage const& msg: receivers[i]->messages)
+        {
+            const int source = msg.head.source;
+            if (source < 1 || source > NUM_PEERS || source == i + 1 || !msg.intact)
+            {
+                num_bad++;
+                continue;
+            }
+            num_per_source[source]++;
+            num_overtaken += (msg.stamp.st_seq < last_seq[source]);
+            last_seq[source] = std::max(last_seq[source], (int)msg.stamp.st_seq);
+            delays.push_back((msg.recv_us - msg.stamp.st_send_us) / 1000.0);
+        }
+        for (int source = 1; source <= NUM_PEERS; source++)
+            num_bad += (source != i + 1 && num_per_source[source] != NUM_ROUNDS);
+    }
+
+    printf("Relay: %d peers, %d messages delivered in %.1f ms, delay min %.1f / median %.1f / p99 %.1f / max %.1f ms, %d overtaken\n",
+        NUM_PEERS, (int)delays.size(), elapsed_ms, GetPercentile(delays, 0.0), GetPercentile(delays, 0.5),
+        GetPercentile(delays, 0.99), GetPercentile(delays, 1.0), num_overtaken);
+    ROR_CHECK(all_received);
+    ROR_CHECK(num_bad == 0);
+    ROR_CHECK(delays.size() == NUM_PEERS * num_expected);
+    // Two hops of 30 ms, plus up to 2x 10 ms jitter, the time on the wire and sometimes 150 ms held back,
+    // which is longer than the send interval, so the stream of a peer arrives out of order now and then
+    ROR_CHECK(GetPercentile(delays, 0.0) >= 59.0);
+    ROR_CHECK(GetPercentile(delays, 0.5) < 120.0);
+    ROR_CHECK(num_overtaken > 0);
+}
+
+} // namespace
+
+int main()
+{
+    TestLoopbackFraming();
+    TestLoopbackTimeoutAndClose();
+    TestLinkLatency();
+    TestLinkBandwidth();
+    TestLinkReorderIsSeeded();
+    TestLinkShutdown();
+    TestRelayServer();
+
+    return RoR::Test::Finish("NetTransportTest");
+}
@@ -0,0 +1,41 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Stand-ins for the application globals used by the sources the tests compile.
+
+#include "Application.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace RoR {
+namespace App {
+
+ThreadPool* GetThreadPool()
+{
+    // Same worker count as the game picks by default, without reading the config
+    static ThreadPool* thread_pool = new ThreadPool(
+        std::max(1, std::min(static_cast<int>(std::thread::hardware_concurrency()) - 1, 8)));
+    return thread_pool;
+}
+
+} // namespace App
+} // namespace RoR
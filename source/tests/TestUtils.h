@@ -0,0 +1,82 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Minimal checks for the headless tests; a failed check is reported and makes the test return non-zero.
+
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace RoR {
+namespace Test {
+
+/// @addtogroup Tests
+/// @{
+
+inline int& NumFailures()
+{
+    static int num_failures = 0;
+    return num_failures;
+}
+
+inline bool Check(bool ok, const char* expr, const char* file, int line)
+{
+    if (!ok)
+    {
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+        NumFailures()++;
+    }
+    return ok;
+}
+
+/// Prints the summary line and returns the process exit code.
+inline int Finish(const char* test_name)
+{
+    printf("%s: %d failed check(s)\n", test_name, NumFailures());
+    return (NumFailures() == 0) ? 0 : 1;
+}
+
+/// Wall clock time since construction, for the benchmark printouts.
+class Stopwatch
+{
+public:
+    Stopwatch(): m_start(std::chrono::steady_clock::now()) {}
+
+    double GetElapsedMs() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/// @} // addtogroup Tests
+
+} // namespace Test
+} // namespace RoR
+
+#define ROR_CHECK(EXPR) \
+    RoR::Test::Check((EXPR), #EXPR, __FILE__, __LINE__)
+
+#define ROR_CHECK_NEAR(A, B, TOLERANCE) \
+    RoR::Test::Check(std::fabs((A) - (B)) <= (TOLERANCE), #A " ~= " #B, __FILE__, __LINE__)
@@ -0,0 +1,318 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Checks the spatial structures of TrafficManager against brute force: nearest lanes, routes and neighbour
+/// queries. The agents driving on them are tested in TrafficManagerTest.
+
+#include "TrafficLaneGraph.h"
+#include "TestUtils.h"
+
+#include <Ogre.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace Ogre;
+using namespace RoR;
+
+namespace {
+
+float GetSegmentDistance(Vector3 pos, Vector3 a, Vector3 b)
+{
+    pos.y = a.y = b.y = 0.f;
+    const Vector3 ab = b - a;
+    const float len_sq = ab.squaredLength();
+    const float t = (len_sq > 0.f) ? std::min(std::max((pos - a).dotProduct(ab) / len_sq, 0.f), 1.f) : 0.f;
+    return pos.distance(a + ab * t);
+}
+
+void TestSharedRoutes()
+{
+    TrafficLaneGraph graph;
+    const Vector3 points[] = { Vector3(0, 0, 0), Vector3(100, 0, 0), Vector3(100, 0, 100) };
+
+    // Two agents on the same preset; the second one is a few cm off
+    std::vector<int> route_a, route_b, lanes_a, lanes_b;
+    for (Vector3 const& point : points)
+    {
+        route_a.push_back(graph.AddWaypoint(point));
+        route_b.push_back(graph.AddWaypoint(point + Vector3(0.05f, 0.f, 0.f)));
+    }
+    for (size_t i = 1; i < route_a.size(); i++)
+    {
+        lanes_a.push_back(graph.AddLane(route_a[i - 1], route_a[i]));
+        lanes_b.push_back(graph.AddLane(route_b[i - 1], route_b[i]));
+    }
+
+    ROR_CHECK(route_a == route_b);
+    ROR_CHECK(lanes_a == lanes_b);
+    ROR_CHECK(graph.GetNumWaypoints() == 3);
+    ROR_CHECK(graph.GetNumLanes() == 2);
+    ROR_CHECK(graph.AddLane(route_a[0], route_a[0]) == -1);
+    ROR_CHECK(graph.FindLane(route_a[0], route_a[1]) == lanes_a[0]);
+    ROR_CHECK(graph.FindLane(route_a[1], route_a[0]) == -1); // Lanes are directed
+    ROR_CHECK_NEAR(graph.GetLane(lanes_a[1]).tl_length, 100.f, 1e-3f);
+
+    float along = -1.f;
+    ROR_CHECK(graph.FindNearestLane(Vector3(30, 0, 2), 5.f, &along) == lanes_a[0]);
+    ROR_CHECK_NEAR(along, 0.3f, 1e-4f);
+    ROR_CHECK(graph.FindNearestLane(Vector3(50, 0, 50), 5.f) == -1);
+
+    std::vector<int> route;
+    ROR_CHECK(graph.FindRoute(route_a[0], route_a[2], route));
+    ROR_CHECK(route == route_a);
+    route.clear();
+    ROR_CHECK(!graph.FindRoute(route_a[2], route_a[0], route));
+    ROR_CHECK(route.empty());
+
+    // The first agent goes away, the second one still has its route
+    for (int lane : lanes_a)
+        graph.ReleaseLane(lane);
+    for (int waypoint : route_a)
+        graph.ReleaseWaypoint(waypoint);
+    ROR_CHECK(graph.GetNumWaypoints() == 3);
+    ROR_CHECK(graph.GetNumLanes() == 2);
+    ROR_CHECK(graph.GetWaypoint(route_b[2]) == points[2]);
+
+    // The second one goes away too: nothing is left, not even empty cells
+    for (int lane : lanes_b)
+        graph.ReleaseLane(lane);
+    for (int waypoint : route_b)
+        graph.ReleaseWaypoint(waypoint);
+    ROR_CHECK(graph.GetNumWaypoints() == 0);
+    ROR_CHECK(graph.GetNumLanes() == 0);
+    ROR_CHECK(graph.GetNumCells() == 0);
+    ROR_CHECK(graph.FindNearestWaypoint(points[0], 1000.f) == -1);
+
+    // Freed IDs are reused
+    const int reused = graph.AddWaypoint(Vector3(-500, 0, -500));
+    ROR_CHECK(std::find(route_a.begin(), route_a.end(), reused) != route_a.end());
+}
+
+void TestNearestLaneMatchesBruteForce()
+{
+    const int NUM_WAYPOINTS = 200;
+    const int NUM_LANES = 400;
+    const int NUM_QUERIES = 5000;
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> pos(-500.f, 500.f);
+    std::uniform_real_distribution<float> height(0.f, 30.f);
+    std::uniform_int_distribution<int> pick(0, NUM_WAYPOINTS - 1);
+    std::uniform_real_distribution<float> max_distance(1.f, 80.f);
+
+    TrafficLaneGraph graph;
+    std::vector<int> waypoints;
+    for (int i = 0; i < NUM_WAYPOINTS; i++)
+    {
+        waypoints.push_back(graph.AddWaypoint(Vector3(pos(rng), height(rng), pos(rng))));
+    }
+    std::vector<int> lanes;
+    for (int i = 0; i < NUM_LANES; i++)
+    {
+        const int lane = graph.AddLane(waypoints[pick(rng)], waypoints[pick(rng)]);
+        if (lane != -1)
+            lanes.push_back(lane);
+    }
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        std::set<int> live_lanes(lanes.begin(), lanes.end());
+        int num_found = 0;
+        for (int i = 0; i < NUM_QUERIES; i++)
+        {
+            const Vector3 query(pos(rng), height(rng), pos(rng));
+            const float max_dist = max_distance(rng);
+
+            float expected = std::numeric_limits<float>::max();
+            for (int lane : live_lanes)
+            {
+                TrafficLaneGraph::Lane const& l = graph.GetLane(lane);
+                expected = std::min(expected, GetSegmentDistance(query, graph.GetWaypoint(l.tl_from), graph.GetWaypoint(l.tl_to)));
+            }
+
+            float along = 0.f;
+            const int found = graph.FindNearestLane(query, max_dist, &along);
+            if (expected > max_dist + 1e-3f)
+            {
+                ROR_CHECK(found == -1);
+            }
+            else if (expected < max_dist - 1e-3f && ROR_CHECK(found != -1))
+            {
+                TrafficLaneGraph::Lane const& l = graph.GetLane(found);
+                const Vector3 from = graph.GetWaypoint(l.tl_from), to = graph.GetWaypoint(l.tl_to);
+                ROR_CHECK_NEAR(GetSegmentDistance(query, from, to), expected, 1e-3f);
+                Vector3 nearest = from + (to - from) * along;
+                nearest.y = query.y;
+                ROR_CHECK_NEAR(nearest.distance(query), expected, 1e-2f);
+                num_found++;
+            }
+        }
+        printf("TrafficLaneGraph: %zu lanes, %d of %d queries found a lane\n", live_lanes.size(), num_found, NUM_QUERIES);
+
+        // Second pass without half of the lanes; their cells must be gone from the index
+        for (size_t i = 0; i < lanes.size(); i += 2)
+        {
+            graph.ReleaseLane(lanes[i]);
+        }
+        std::vector<int> kept;
+        for (size_t i = 1; i < lanes.size(); i += 2)
+        {
+            kept.push_back(lanes[i]);
+        }
+        lanes.swap(kept);
+    }
+
+    for (int lane : lanes)
+        graph.ReleaseLane(lane);
+    for (int waypoint : waypoints)
+        graph.ReleaseWaypoint(waypoint);
+    ROR_CHECK(graph.GetNumCells() == 0);
+}
+
+void TestRouteMatchesBruteForce()
+{
+    const int NUM_WAYPOINTS = 60;
+    const int NUM_LANES = 150;
+    const float INF = std::numeric_limits<float>::infinity();
+
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> pos(-300.f, 300.f);
+    std::uniform_int_distribution<int> pick(0, NUM_WAYPOINTS - 1);
+
+    TrafficLaneGraph graph;
+    std::vector<int> waypoints;
+    for (int i = 0; i < NUM_WAYPOINTS; i++)
+    {
+        waypoints.push_back(graph.AddWaypoint(Vector3(pos(rng), 0.f, pos(rng))));
+    }
+
+    // Floyd-Warshall over the same lanes
+    std::vector<std::vector<float>> dist(NUM_WAYPOINTS, std::vector<float>(NUM_WAYPOINTS, INF));
+    for (int i = 0; i < NUM_WAYPOINTS; i++)
+    {
+        dist[i][i] = 0.f;
+    }
+    for (int i = 0; i < NUM_LANES; i++)
+    {
+        const int from = pick(rng), to = pick(rng);
+        const int lane = graph.AddLane(waypoints[from], waypoints[to]);
+        if (lane != -1)
+            dist[from][to] = graph.GetLane(lane).tl_length;
+    }
+    for (int k = 0; k < NUM_WAYPOINTS; k++)
+        for (int i = 0; i < NUM_WAYPOINTS; i++)
+            for (int j = 0; j < NUM_WAYPOINTS; j++)
+                dist[i][j] = std::min(dist[i][j], dist[i][k] + dist[k][j]);
+
+    int num_reachable = 0;
+    for (int from = 0; from < NUM_WAYPOINTS; from++)
+    {
+        for (int to = 0; to < NUM_WAYPOINTS; to++)
+        {
+            std::vector<int> route;
+            const bool found = graph.FindRoute(waypoints[from], waypoints[to], route);
+            if (!ROR_CHECK(found == (dist[from][to] != INF)) || !found)
+                continue;
+
+            ROR_CHECK(route.front() == waypoints[from] && route.back() == waypoints[to]);
+            float length = 0.f;
+            for (size_t i = 1; i < route.size(); i++)
+            {
+                const int lane = graph.FindLane(route[i - 1], route[i]);
+                if (ROR_CHECK(lane != -1))
+                    length += graph.GetLane(lane).tl_length;
+            }
+            ROR_CHECK_NEAR(length, dist[from][to], 1e-2f);
+            num_reachable++;
+        }
+    }
+    printf("TrafficLaneGraph: %d of %d routes reachable\n", num_reachable, NUM_WAYPOINTS * NUM_WAYPOINTS);
+}
+
+void TestActorGridMatchesBruteForce()
+{
+    const int NUM_ACTORS = 300;
+    const int NUM_FRAMES = 200;
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> pos(-400.f, 400.f);
+    std::uniform_real_distribution<float> step(-8.f, 8.f);
+    std::uniform_real_distribution<float> radius(1.f, 60.f);
+
+    std::vector<Vector3> actors;
+    for (int i = 0; i < NUM_ACTORS; i++)
+    {
+        actors.push_back(Vector3(pos(rng), 0.f, pos(rng)));
+    }
+
+    TrafficActorGrid grid;
+    std::set<std::pair<int, int>> prev_cells;
+    for (int frame = 0; frame < NUM_FRAMES; frame++)
+    {
+        // Everyone drifts away, to the positive corner; the cells left behind must not pile up
+        std::set<std::pair<int, int>> cells;
+        grid.Clear();
+        for (int i = 0; i < NUM_ACTORS; i++)
+        {
+            actors[i] += Vector3(step(rng) + 6.f, 0.f, step(rng) + 6.f);
+            grid.Insert(i, actors[i], 2.f);
+            cells.insert(std::make_pair(static_cast<int>(std::floor(actors[i].x / TrafficActorGrid::CELL_SIZE)),
+                                        static_cast<int>(std::floor(actors[i].z / TrafficActorGrid::CELL_SIZE))));
+        }
+        std::set<std::pair<int, int>> recent_cells(cells);
+        recent_cells.insert(prev_cells.begin(), prev_cells.end());
+        ROR_CHECK(grid.GetNumCells() <= recent_cells.size());
+        prev_cells.swap(cells);
+
+        for (int q = 0; q < 20; q++)
+        {
+            const Vector3 center = actors[q * 7];
+            const float r = radius(rng);
+            std::vector<int> found;
+            grid.Query(center, r, found);
+            std::sort(found.begin(), found.end());
+
+            std::vector<int> expected;
+            for (int i = 0; i < NUM_ACTORS; i++)
+            {
+                const float dx = actors[i].x - center.x, dz = actors[i].z - center.z;
+                if (dx * dx + dz * dz <= r * r)
+                    expected.push_back(i);
+            }
+            ROR_CHECK(found == expected);
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    TestSharedRoutes();
+    TestNearestLaneMatchesBruteForce();
+    TestRouteMatchesBruteForce();
+    TestActorGridMatchesBruteForce();
+
+    return RoR::Test::Finish("TrafficLaneGraphTest");
+}
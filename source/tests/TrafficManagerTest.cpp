@@ -0,0 +1,342 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2024 Rigs of Rods contributors
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// Drives real `VehicleAI` agents through `TrafficManager::Update()`. The test stands in for `ActorManager`:
+/// it snapshots the vehicles into `TrafficActorState`, answers the node queries and moves the vehicles by the
+/// AI's commands. A vehicle is a point mass with a round footprint, steered like a car; a platoon must queue up
+/// without bumping, 200 agents must keep driving their routes over a street grid.
+
+#include "TrafficManager.h"
+#include "VehicleAI.h"
+#include "TestUtils.h"
+
+#include <Ogre.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Ogre;
+using namespace RoR;
+
+namespace {
+
+const float RADIUS = 2.5f;          //!< All nodes are within this of the position
+const float ACCELERATION = 3.f;     //!< At full throttle
+const float DECELERATION = 8.f;     //!< At full brake
+const float TURN_RADIUS = 6.f;      //!< At full steering lock
+const float DT = 1.f / 60.f;
+
+struct Vehicle
+{
+    std::unique_ptr<VehicleAI> ai;  //!< Null once parked at the end of the route
+    Vector3  pos = Vector3::ZERO;
+    float    heading = 0.f;         //!< `TrafficActorState::tas_rotation`
+    float    speed = 0.f;
+    // Controls, kept until the AI sets them again, like the actor's
+    float    wheels = 0.f;
+    float    acc = 0.f;
+    float    brake = 0.f;
+    bool     parking_brake = false;
+    int      num_waypoints = 0;     //!< Reached so far
+};
+
+Vector3 GetDirection(float heading)
+{
+    return Vector3(std::sin(heading), 0.f, -std::cos(heading));
+}
+
+float GetHeading(Vector3 const& dir)
+{
+    return std::atan2(dir.x, -dir.z);
+}
+
+/// The nodes are anywhere within `RADIUS` of the position; answer with the worst case
+class CircleQueries: public TrafficQueries
+{
+public:
+    CircleQueries(std::vector<TrafficActorState> const& actors): m_actors(actors) {}
+
+    bool AreActorsWithin(int a, int b, float distance) const override
+    {
+        return m_actors[a].tas_position.distance(m_actors[b].tas_position) < distance + 2.f * RADIUS;
+    }
+
+    bool IsActorNodeWithin(int actor, Ogre::Vector3 const& point, float distance) const override
+    {
+        return m_actors[actor].tas_position.distance(point) < distance + RADIUS;
+    }
+
+private:
+    std::vector<TrafficActorState> const& m_actors;
+};
+
+/// The gather step of `ActorManager::UpdateTraffic()`
+void GatherState(std::vector<Vehicle> const& vehicles, std::vector<TrafficActorState>& out_states)
+{
+    out_states.resize(vehicles.size());
+    for (size_t i = 0; i < vehicles.size(); i++)
+    {
+        Vehicle const& v = vehicles[i];
+        TrafficActorState& state = out_states[i];
+        state.tas_agent = v.ai.get();
+        state.tas_position = v.pos;
+        state.tas_direction = GetDirection(v.heading);
+        state.tas_camera_dir = state.tas_direction;
+        state.tas_camera_velocity = state.tas_direction * v.speed;
+        state.tas_box_min = v.pos - Vector3(RADIUS);
+        state.tas_box_max = v.pos + Vector3(RADIUS);
+        state.tas_rotation = v.heading;
+        state.tas_radius = RADIUS;
+        state.tas_wheel_speed = v.speed;
+        state.tas_driveable = true;
+        state.tas_has_engine = true;
+    }
+}
+
+/// The apply step of `ActorManager::UpdateTraffic()`, then one step of the vehicle
+void ApplyAndMove(Vehicle& v)
+{
+    if (v.ai)
+    {
+        VehicleAI::Command const& cmd = v.ai->getCommand();
+        if (cmd.reached_waypoint)
+        {
+            v.num_waypoints++;
+            if (v.ai->advanceWaypoint()) // Last one, the AI stops the truck and lets go
+            {
+                v.parking_brake = true;
+                v.ai->releaseRoute();
+                v.ai.reset();
+            }
+        }
+        else
+        {
+            if (cmd.steer_wheels)
+                v.wheels = cmd.wheels;
+            if (cmd.drive)
+            {
+                v.acc = cmd.acc;
+                v.brake = cmd.brake;
+                v.parking_brake = cmd.parking_brake;
+            }
+        }
+    }
+
+    if (v.parking_brake)
+        v.speed = 0.f;
+    else
+        v.speed = std::max(v.speed + (ACCELERATION * v.acc - DECELERATION * v.brake) * DT, 0.f);
+    v.heading += v.wheels * v.speed / TURN_RADIUS * DT;
+    v.pos += GetDirection(v.heading) * v.speed * DT;
+}
+
+VehicleAI* AddAgent(std::vector<Vehicle>& vehicles, TrafficManager& traffic, Vector3 const& pos, Vector3 const& dir)
+{
+    Vehicle v;
+    v.ai.reset(new VehicleAI(static_cast<ActorInstanceID_t>(vehicles.size()), traffic.GetLaneGraph()));
+    v.pos = pos;
+    v.heading = GetHeading(dir);
+    vehicles.push_back(std::move(v));
+    return vehicles.back().ai.get();
+}
+
+void TestPlatoonKeepsDistance()
+{
+    const int NUM_AGENTS = 20;
+    const float SPACING = 20.f;
+
+    // Spread out behind each other at full speed; the leader stops at the waypoint, the rest must queue up behind it
+    TrafficManager traffic;
+    std::vector<Vehicle> vehicles;
+    for (int i = 0; i < NUM_AGENTS; i++)
+    {
+        VehicleAI* ai = AddAgent(vehicles, traffic, Vector3(0.f, 0.f, 400.f - SPACING * i), Vector3::UNIT_Z);
+        ai->addWaypoint("end", Vector3(0.f, 0.f, 1000.f));
+        vehicles.back().speed = 50.f / 3.6f;
+    }
+    ROR_CHECK(traffic.GetLaneGraph().GetNumWaypoints() == 1);
+
+    const TrafficWorldState world;
+    std::vector<TrafficActorState> states;
+    CircleQueries queries(states);
+    float min_gap = std::numeric_limits<float>::max();
+    for (int frame = 0; frame < 60 * 120; frame++)
+    {
+        GatherState(vehicles, states);
+        traffic.Update(states, world, queries, DT);
+        for (Vehicle& v : vehicles)
+            ApplyAndMove(v);
+        for (int i = 1; i < NUM_AGENTS; i++)
+            min_gap = std::min(min_gap, vehicles[i - 1].pos.z - vehicles[i].pos.z);
+    }
+
+    float max_drift = 0.f;
+    for (Vehicle const& v : vehicles)
+        max_drift = std::max(max_drift, std::fabs(v.pos.x));
+
+    ROR_CHECK(vehicles[0].ai == nullptr);                  // Reached the end and parked
+    ROR_CHECK(vehicles[0].pos.z > 1000.f - 2.f * RADIUS - 5.f);
+    ROR_CHECK(min_gap > 2.f * RADIUS);                     // Never bumped into the one ahead
+    ROR_CHECK(vehicles[NUM_AGENTS - 1].pos.z > 1000.f - SPACING * NUM_AGENTS); // Everyone queued up closely
+    ROR_CHECK(max_drift < 0.1f);
+    ROR_CHECK(traffic.GetLaneGraph().GetNumWaypoints() == 1); // The followers still hold the route
+    printf("TrafficManager: platoon of %d, smallest gap %.1f m, last one at %.1f m\n",
+        NUM_AGENTS, min_gap, vehicles[NUM_AGENTS - 1].pos.z);
+}
+
+void TestManyAgents()
+{
+    const int GRID_SIZE = 8;          // Intersections per side
+    const float BLOCK_SIZE = 100.f;
+    const int NUM_AGENTS = 200;
+    const int NUM_DESTINATIONS = 8;   // Per agent; more than it can drive in the time
+    const int NUM_FRAMES = 60 * 180;  // 3 minutes at 60 FPS
+    const float OFF_LANE = 5.f;
+
+    // One-way streets on flat ground, alternating; VehicleAI drives on the line between the waypoints,
+    // two-way traffic would meet head-on. Away from the origin, which VehicleAI takes for "no waypoint".
+    // The test holds the references a terrain's presets would.
+    TrafficManager traffic;
+    TrafficLaneGraph& graph = traffic.GetLaneGraph();
+    std::vector<int> intersections;
+    for (int x = 0; x < GRID_SIZE; x++)
+    {
+        for (int z = 0; z < GRID_SIZE; z++)
+        {
+            intersections.push_back(graph.AddWaypoint(Vector3((x + 1) * BLOCK_SIZE, 0.f, (z + 1) * BLOCK_SIZE)));
+        }
+    }
+    std::vector<int> lanes;
+    for (int x = 0; x < GRID_SIZE; x++)
+    {
+        for (int z = 0; z < GRID_SIZE; z++)
+        {
+            const int here = intersections[x * GRID_SIZE + z];
+            if (x + 1 < GRID_SIZE)
+            {
+                const int east = intersections[(x + 1) * GRID_SIZE + z];
+                lanes.push_back((z % 2) ? graph.AddLane(here, east) : graph.AddLane(east, here));
+            }
+            if (z + 1 < GRID_SIZE)
+            {
+                const int north = intersections[x * GRID_SIZE + z + 1];
+                lanes.push_back((x % 2) ? graph.AddLane(north, here) : graph.AddLane(here, north));
+            }
+        }
+    }
+
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> pick(0, GRID_SIZE * GRID_SIZE - 1);
+
+    // Two agents per lane, a third and two thirds along it, on a long route of random destinations;
+    // slowing down for turns like the waypoints placed by 'AI.as'
+    std::vector<Vehicle> vehicles;
+    for (int i = 0; i < NUM_AGENTS; i++)
+    {
+        TrafficLaneGraph::Lane const& lane = graph.GetLane(lanes[(i / 2) % lanes.size()]);
+        const Vector3 from = graph.GetWaypoint(lane.tl_from), to = graph.GetWaypoint(lane.tl_to);
+        VehicleAI* ai = AddAgent(vehicles, traffic, from + (to - from) * ((i % 2) ? 2.f / 3.f : 1.f / 3.f), to - from);
+
+        std::vector<int> route = { lane.tl_to };
+        for (int d = 0; d < NUM_DESTINATIONS; d++)
+        {
+            int destination;
+            do
+            {
+                destination = intersections[pick(rng)];
+            } while (destination == route.back());
+            const int here = route.back();
+            route.pop_back();
+            ROR_CHECK(graph.FindRoute(here, destination, route));
+        }
+        for (size_t w = 0; w < route.size(); w++)
+        {
+            const std::string id = "way" + std::to_string(w);
+            ai->addWaypoint(id, graph.GetWaypoint(route[w]));
+            ai->setValueAtWaypoint(id, AI_SPEED, -1.f);
+        }
+    }
+
+    const TrafficWorldState world;
+    std::vector<TrafficActorState> states;
+    CircleQueries queries(states);
+    double traffic_ms = 0.0, worst_frame_ms = 0.0;
+    int num_off_lane = 0;
+    for (int frame = 0; frame < NUM_FRAMES; frame++)
+    {
+        GatherState(vehicles, states);
+
+        Test::Stopwatch watch;
+        traffic.Update(states, world, queries, DT);
+        const double frame_ms = watch.GetElapsedMs();
+        traffic_ms += frame_ms;
+        worst_frame_ms = std::max(worst_frame_ms, frame_ms);
+
+        for (Vehicle& v : vehicles)
+        {
+            ApplyAndMove(v);
+            num_off_lane += (graph.FindNearestLane(v.pos, OFF_LANE) == -1); // Corners are cut a bit
+        }
+    }
+
+    int min_waypoints = std::numeric_limits<int>::max(), num_agents = 0;
+    for (Vehicle const& v : vehicles)
+    {
+        min_waypoints = std::min(min_waypoints, v.num_waypoints);
+        num_agents += (v.ai != nullptr);
+    }
+
+    ROR_CHECK(num_off_lane == 0);
+    ROR_CHECK(num_agents == NUM_AGENTS);          // Nobody ran out of route
+    ROR_CHECK(traffic.GetNumActiveAgents() == NUM_AGENTS);
+    ROR_CHECK(min_waypoints >= 4);                // Nobody got stuck; a block at 50 km/h takes 7 seconds
+    ROR_CHECK(traffic_ms / NUM_FRAMES < 4.0);     // A quarter of a 60 FPS frame, with a wide margin
+    printf("TrafficManager: %d agents, %zu lanes: %.3f ms/frame (worst %.3f), least waypoints reached %d\n",
+        NUM_AGENTS, graph.GetNumLanes(), traffic_ms / NUM_FRAMES, worst_frame_ms, min_waypoints);
+
+    // The agents go away, then the terrain; nothing is left
+    for (Vehicle& v : vehicles)
+    {
+        if (v.ai)
+            v.ai->releaseRoute();
+    }
+    ROR_CHECK(graph.GetNumLanes() == lanes.size());
+    for (int lane : lanes)
+        graph.ReleaseLane(lane);
+    for (int waypoint : intersections)
+        graph.ReleaseWaypoint(waypoint);
+    ROR_CHECK(graph.GetNumWaypoints() == 0);
+    ROR_CHECK(graph.GetNumLanes() == 0);
+}
+
+} // namespace
+
+int main()
+{
+    TestPlatoonKeepsDistance();
+    TestManyAgents();
+
+    return RoR::Test::Finish("TrafficManagerTest");
+}
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+# This source file is part of Rigs of Rods
+# Copyright 2024 Rigs of Rods contributors
+#
+# Rigs of Rods is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 3, as
+# published by the Free Software Foundation.
+
+"""Reader for Rigs of Rods telemetry recordings (.rortlm).
+
+Recordings are made in-game with the console command `telemetry start ...`,
+see `PhysicsRecorder.h` for the file layout.
+
+Usage:
+    import ror_telemetry
+    rec = ror_telemetry.load("telemetry_2024-01-01_12-00-00.rortlm")
+    rec.time                          # numpy float64 array, seconds
+    rec["actor0.wheel0.speed"]        # numpy float32 array
+    df = rec.to_dataframe()           # requires pandas
+
+Run as a script to print a summary: `python3 ror_telemetry.py <file>`
+"""
+
+import struct
+import sys
+import zlib
+
+import numpy as np
+
+MAGIC = b"RORTELEM"
+CHUNK_MAGIC = b"CHNK"
+FORMAT_VERSION = 1
+CODEC_RAW = 0
+CODEC_DEFLATE = 1
+
+
+class Recording:
+    """Decoded recording; columns are stored as a (num_columns, num_samples) float32 matrix."""
+
+    def __init__(self, sample_interval, column_names, notes, sample_index, data):
+        self.sample_interval = sample_interval
+        self.column_names = column_names
+        self.notes = notes
+        self.sample_index = sample_index  # uint64; gaps mean the recorder dropped chunks
+        self.data = data
+        self._column_lookup = {name: i for i, name in enumerate(column_names)}
+
+    @property
+    def time(self):
+        return self.sample_index.astype(np.float64) * self.sample_interval
+
+    def __getitem__(self, name):
+        return self.data[self._column_lookup[name]]
+
+    def __contains__(self, name):
+        return name in self._column_lookup
+
+    def columns(self, prefix):
+        """Names of all columns starting with `prefix`, e.g. 'actor0.beam'."""
+        return [name for name in self.column_names if name.startswith(prefix)]
+
+    def to_dataframe(self):
+        import pandas as pd
+        return pd.DataFrame(self.data.T, index=pd.Index(self.time, name="time"), columns=self.column_names)
+
+
+def _read_string(buf, pos):
+    (length,) = struct.unpack_from("<H", buf, pos)
+    pos += 2
+    return buf[pos:pos + length].decode("utf-8", errors="replace"), pos + length
+
+
+def _decode_chunk(payload, codec, num_columns, num_samples):
+    if codec == CODEC_DEFLATE:
+        payload = zlib.decompress(payload)
+    elif codec != CODEC_RAW:
+        raise ValueError("unknown codec {}".format(codec))
+
+    num_values = num_columns * num_samples
+    planes = np.frombuffer(payload, dtype=np.uint8, count=4 * num_values).reshape(4, num_values)
+    # Re-interleave the byte planes into little-endian uint32, then undo the per-column XOR delta
+    words = np.ascontiguousarray(planes.T).view("<u4").reshape(num_columns, num_samples)
+    words = np.bitwise_xor.accumulate(words, axis=1)
+    return words.view(np.float32)
+
+
+def load(path):
+    with open(path, "rb") as f:
+        buf = f.read()
+
+    if buf[:8] != MAGIC:
+        raise ValueError("{}: not a telemetry recording".format(path))
+    version, sample_interval, _chunk_capacity, num_columns = struct.unpack_from("<IfII", buf, 8)
+    if version > FORMAT_VERSION:
+        raise ValueError("{}: unsupported format version {}".format(path, version))
+    pos = 24
+    column_names = []
+    for _ in range(num_columns):
+        name, pos = _read_string(buf, pos)
+        column_names.append(name)
+    notes, pos = _read_string(buf, pos)
+
+    chunk_header = struct.Struct("<4sQIBI")
+    blocks = []
+    indices = []
+    while pos + chunk_header.size <= len(buf):
+        magic, first_sample, num_samples, codec, payload_size = chunk_header.unpack_from(buf, pos)
+        pos += chunk_header.size
+        if magic != CHUNK_MAGIC or pos + payload_size > len(buf):
+            break  # truncated recording (game crashed or still writing); keep what we have
+        blocks.append(_decode_chunk(buf[pos:pos + payload_size], codec, num_columns, num_samples))
+        indices.append(np.arange(first_sample, first_sample + num_samples, dtype=np.uint64))
+        pos += payload_size
+
+    if blocks:
+        data = np.concatenate(blocks, axis=1)
+        sample_index = np.concatenate(indices)
+    else:
+        data = np.zeros((num_columns, 0), dtype=np.float32)
+        sample_index = np.zeros(0, dtype=np.uint64)
+    return Recording(sample_interval, column_names, notes, sample_index, data)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        print("usage: {} <recording.rortlm>".format(sys.argv[0]))
+        sys.exit(1)
+    rec = load(sys.argv[1])
+    print(rec.notes.strip())
+    print("{} columns, {} samples @ {:g} Hz ({:.3f} s)".format(
+        len(rec.column_names), rec.data.shape[1], 1.0 / rec.sample_interval,
+        rec.data.shape[1] * rec.sample_interval))
+    dropped = int(rec.sample_index[-1] + 1 - len(rec.sample_index)) if len(rec.sample_index) else 0
+    if dropped:
+        print("{} samples dropped by the recorder".format(dropped))